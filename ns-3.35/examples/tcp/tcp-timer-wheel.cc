@@ -0,0 +1,199 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Network topology
+//
+//       n0 ----------- n1
+//            1 Gbps
+//            10 ms
+//
+// - numFlows bulk TCP flows from n0 to n1.
+// - The size of the simulator event queue is sampled every millisecond,
+//   with the TCP timers kept in the TcpTimerWheel of each node
+//   (--timerWheel=1, the default) or scheduled as simulator events
+//   (--timerWheel=0), e.g.:
+//
+//   ./waf --run "tcp-timer-wheel --numFlows=1000 --timerWheel=0"
+//   ./waf --run "tcp-timer-wheel --numFlows=1000 --timerWheel=1"
+//
+// - With --pacing=1, the flows are paced and the delays between the
+//   earliest departure time of the paced segments and their actual
+//   departure (the PacingDeviation trace of TcpSocketBase) are reported.
+//   With the timer wheel, the pacing timers of all the flows share the
+//   single simulator event of the wheel of n0.
+
+#include <iostream>
+#include <map>
+#include "ns3/core-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/network-module.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("TcpTimerWheelExample");
+
+uint64_t g_maxPending = 0;  //!< Maximum size of the event queue
+uint64_t g_sumPending = 0;  //!< Sum of the sampled sizes of the event queue
+uint64_t g_nSamples = 0;    //!< Number of samples
+
+/**
+ * Pacing deviations of a flow
+ */
+struct PacingDeviationStats
+{
+  uint64_t count {0};     //!< Number of paced segments
+  Time sum {Seconds (0)}; //!< Sum of the deviations
+  Time max {Seconds (0)}; //!< Maximum deviation
+};
+
+std::map<std::string, PacingDeviationStats> g_pacingStats; //!< Pacing deviations, per socket
+
+/**
+ * Record the pacing deviation of a segment
+ * \param context the trace context, which identifies the socket
+ * \param deviation the pacing deviation
+ */
+void
+PacingDeviationTrace (std::string context, Time deviation)
+{
+  PacingDeviationStats &stats = g_pacingStats[context];
+  stats.count++;
+  stats.sum += deviation;
+  stats.max = std::max (stats.max, deviation);
+}
+
+/**
+ * Connect the PacingDeviation trace of the sockets of the first node
+ */
+void
+ConnectPacingDeviationTrace (void)
+{
+  Config::Connect ("/NodeList/0/$ns3::TcpL4Protocol/SocketList/*/PacingDeviation",
+                   MakeCallback (&PacingDeviationTrace));
+}
+
+/**
+ * Sample the size of the event queue
+ * \param interval the sampling interval
+ */
+void
+SampleEventQueue (Time interval)
+{
+  uint64_t pending = Simulator::GetPendingEventCount ();
+  g_maxPending = std::max (g_maxPending, pending);
+  g_sumPending += pending;
+  g_nSamples++;
+  Simulator::Schedule (interval, &SampleEventQueue, interval);
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t numFlows = 100;
+  double simTime = 5.0;
+  bool timerWheel = true;
+  bool pacing = false;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("numFlows", "Number of TCP flows", numFlows);
+  cmd.AddValue ("simTime", "Duration of the simulation (in seconds)", simTime);
+  cmd.AddValue ("timerWheel", "Keep the TCP timers in a timer wheel", timerWheel);
+  cmd.AddValue ("pacing", "Enable TCP pacing", pacing);
+  cmd.Parse (argc, argv);
+
+  Config::SetDefault ("ns3::TcpL4Protocol::TimerWheel", BooleanValue (timerWheel));
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (1448));
+  Config::SetDefault ("ns3::TcpSocketState::EnablePacing", BooleanValue (pacing));
+
+  NodeContainer nodes;
+  nodes.Create (2);
+
+  PointToPointHelper pointToPoint;
+  pointToPoint.SetDeviceAttribute ("DataRate", StringValue ("1Gbps"));
+  pointToPoint.SetChannelAttribute ("Delay", StringValue ("10ms"));
+  NetDeviceContainer devices = pointToPoint.Install (nodes);
+
+  InternetStackHelper internet;
+  internet.Install (nodes);
+
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = ipv4.Assign (devices);
+
+  uint16_t port = 9;
+  PacketSinkHelper sink ("ns3::TcpSocketFactory",
+                         InetSocketAddress (Ipv4Address::GetAny (), port));
+  ApplicationContainer sinkApps = sink.Install (nodes.Get (1));
+  sinkApps.Start (Seconds (0.0));
+
+  BulkSendHelper source ("ns3::TcpSocketFactory",
+                         InetSocketAddress (interfaces.GetAddress (1), port));
+  source.SetAttribute ("MaxBytes", UintegerValue (0));
+  for (uint32_t i = 0; i < numFlows; ++i)
+    {
+      ApplicationContainer sourceApps = source.Install (nodes.Get (0));
+      // spread the connection setups over 100 ms
+      sourceApps.Start (Seconds (0.1 * i / numFlows));
+    }
+
+  Simulator::Schedule (MilliSeconds (1), &SampleEventQueue, MilliSeconds (1));
+  if (pacing)
+    {
+      // after all the sockets have been created
+      Simulator::Schedule (Seconds (0.1), &ConnectPacingDeviationTrace);
+    }
+  Simulator::Stop (Seconds (simTime));
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Run ();
+  int64_t elapsed = clock.End ();
+
+  Ptr<PacketSink> packetSink = DynamicCast<PacketSink> (sinkApps.Get (0));
+  std::cout << "flows: " << numFlows << ", timer wheel: " << (timerWheel ? "yes" : "no")
+            << ", pacing: " << (pacing ? "yes" : "no") << std::endl;
+  std::cout << "received (bytes): " << packetSink->GetTotalRx () << std::endl;
+  std::cout << "events executed: " << Simulator::GetEventCount () << std::endl;
+  std::cout << "event queue size: max " << g_maxPending
+            << ", mean " << (g_nSamples > 0 ? g_sumPending / g_nSamples : 0) << std::endl;
+  if (pacing)
+    {
+      // the deviations include the time spent limited by the congestion
+      // window or by the application, not only the delay of the timers
+      uint64_t count = 0;
+      Time sum = Seconds (0);
+      Time max = Seconds (0);
+      Time worstMean = Seconds (0);
+      for (std::map<std::string, PacingDeviationStats>::const_iterator it = g_pacingStats.begin ();
+           it != g_pacingStats.end (); ++it)
+        {
+          count += it->second.count;
+          sum += it->second.sum;
+          max = std::max (max, it->second.max);
+          worstMean = std::max (worstMean, it->second.sum / static_cast<int64_t> (it->second.count));
+        }
+      std::cout << "paced segments: " << count << std::endl;
+      std::cout << "pacing deviation: mean "
+                << (count > 0 ? sum / static_cast<int64_t> (count) : Seconds (0)).As (Time::US)
+                << ", max " << max.As (Time::US)
+                << ", worst flow mean " << worstMean.As (Time::US) << std::endl;
+    }
+  std::cout << "run time (ms): " << elapsed << std::endl;
+
+  Simulator::Destroy ();
+  return 0;
+}
@@ -27,7 +27,7 @@
 // n1 ------------------------------------ n2 ----------------------------------- n3
 //   point-to-point (access link)                point-to-point (bottleneck link)
 //   100 Mbps, 0.1 ms                            bandwidth [10 Mbps], delay [5 ms]
-//   qdiscs PfifoFast with capacity              qdiscs queueDiscType in {PfifoFast, ARED, CoDel, FqCoDel, PIE} [PfifoFast]
+//   qdiscs PfifoFast with capacity              qdiscs queueDiscType in {PfifoFast, ARED, CoDel, FqCoDel, PIE, ShQ} [PfifoFast]
 //   of 1000 packets                             with capacity of queueDiscSize packets [1000]
 //   netdevices queues with size of 100 packets  netdevices queues with size of netdevicesQueueSize packets [100]
 //   without BQL                                 bql BQL [false]
@@ -52,6 +52,14 @@
 //
 // If you use an AQM as queue disc on the bottleneck netdevices, you can observe that the ping Rtt
 // decrease. A further decrease can be observed when you enable BQL.
+//
+// At the end, the number of executed events, the run time and the goodput of the flows are printed.
+// With numIdleLinks > 0, n2 has as many additional links without traffic, each with the bottleneck
+// queue disc. With PIE and ShQ, the periodic probability updates of these idle queue discs then make
+// most of the events, unless lazyUpdate is enabled, e.g.:
+//
+//   ./waf --run "queue-discs-benchmark --queueDiscType=PIE --numIdleLinks=1000 --lazyUpdate=0"
+//   ./waf --run "queue-discs-benchmark --queueDiscType=PIE --numIdleLinks=1000 --lazyUpdate=1"
 
 #include "ns3/core-module.h"
 #include "ns3/network-module.h"
@@ -101,6 +109,8 @@ int main (int argc, char *argv[])
   uint32_t queueDiscSize = 1000;
   uint32_t netdevicesQueueSize = 50;
   bool bql = false;
+  uint32_t numIdleLinks = 0;
+  bool lazyUpdate = false;
 
   std::string flowsDatarate = "20Mbps";
   uint32_t flowsPacketsSize = 1000;
@@ -112,10 +122,12 @@ int main (int argc, char *argv[])
   CommandLine cmd (__FILE__);
   cmd.AddValue ("bandwidth", "Bottleneck bandwidth", bandwidth);
   cmd.AddValue ("delay", "Bottleneck delay", delay);
-  cmd.AddValue ("queueDiscType", "Bottleneck queue disc type in {PfifoFast, ARED, CoDel, FqCoDel, PIE, prio}", queueDiscType);
+  cmd.AddValue ("queueDiscType", "Bottleneck queue disc type in {PfifoFast, ARED, CoDel, FqCoDel, PIE, ShQ, prio}", queueDiscType);
   cmd.AddValue ("queueDiscSize", "Bottleneck queue disc size in packets", queueDiscSize);
   cmd.AddValue ("netdevicesQueueSize", "Bottleneck netdevices queue size in packets", netdevicesQueueSize);
   cmd.AddValue ("bql", "Enable byte queue limits on bottleneck netdevices", bql);
+  cmd.AddValue ("numIdleLinks", "Number of additional links without traffic on n2, with the bottleneck queue disc", numIdleLinks);
+  cmd.AddValue ("lazyUpdate", "Update the probability of PIE and ShQ lazily instead of with periodic events", lazyUpdate);
   cmd.AddValue ("flowsDatarate", "Upload and download flows datarate", flowsDatarate);
   cmd.AddValue ("flowsPacketsSize", "Upload and download flows packets sizes", flowsPacketsSize);
   cmd.AddValue ("startTime", "Simulation start time", startTime);
@@ -125,6 +137,9 @@ int main (int argc, char *argv[])
 
   float stopTime = startTime + simDuration;
 
+  Config::SetDefault ("ns3::PieQueueDisc::UseLazyUpdate", BooleanValue (lazyUpdate));
+  Config::SetDefault ("ns3::ShqQueueDisc::UseLazyUpdate", BooleanValue (lazyUpdate));
+
   // Create nodes
   NodeContainer n1, n2, n3;
   n1.Create (1);
@@ -182,6 +197,12 @@ int main (int argc, char *argv[])
       Config::SetDefault ("ns3::PieQueueDisc::MaxSize",
                           QueueSizeValue (QueueSize (QueueSizeUnit::PACKETS, queueDiscSize)));
     }
+  else if (queueDiscType.compare ("ShQ") == 0)
+    {
+      tchBottleneck.SetRootQueueDisc ("ns3::ShqQueueDisc");
+      Config::SetDefault ("ns3::ShqQueueDisc::MaxSize",
+                          QueueSizeValue (QueueSize (QueueSizeUnit::PACKETS, queueDiscSize)));
+    }
   else if (queueDiscType.compare ("prio") == 0)
     {
       uint16_t handle = tchBottleneck.SetRootQueueDisc ("ns3::PrioQueueDisc", "Priomap",
@@ -214,6 +235,15 @@ int main (int argc, char *argv[])
   address.NewNetwork ();
   Ipv4InterfaceContainer interfacesBottleneck = address.Assign (devicesBottleneckLink);
 
+  // Idle links, with the bottleneck queue disc on both ends
+  NodeContainer idleNodes;
+  idleNodes.Create (numIdleLinks);
+  stack.Install (idleNodes);
+  for (uint32_t i = 0; i < numIdleLinks; ++i)
+    {
+      tchBottleneck.Install (bottleneckLink.Install (n2.Get (0), idleNodes.Get (i)));
+    }
+
   Ptr<NetDeviceQueueInterface> interface = devicesBottleneckLink.Get (0)->GetObject<NetDeviceQueueInterface> ();
   Ptr<NetDeviceQueue> queueInterface = interface->GetTxQueue (0);
   Ptr<DynamicQueueLimits> queueLimits = StaticCast<DynamicQueueLimits> (queueInterface->GetQueueLimits ());
@@ -301,7 +331,17 @@ int main (int argc, char *argv[])
   flowMonitor = flowHelper.InstallAll();
 
   Simulator::Stop (Seconds (stopTime));
+  SystemWallClockMs clock;
+  clock.Start ();
   Simulator::Run ();
+  int64_t elapsed = clock.End ();
+
+  std::cout << "events executed: " << Simulator::GetEventCount () << std::endl;
+  std::cout << "run time (ms): " << elapsed << std::endl;
+  std::cout << "upload goodput (Mbps): "
+            << DynamicCast<PacketSink> (uploadApp.Get (0))->GetTotalRx () * 8 / (simDuration * 1e6) << std::endl;
+  std::cout << "download goodput (Mbps): "
+            << DynamicCast<PacketSink> (downloadApp.Get (0))->GetTotalRx () * 8 / (simDuration * 1e6) << std::endl;
 
   flowMonitor->SerializeToXmlFile(queueDiscType + "-flowMonitor.xml", true, true);
 
@@ -0,0 +1,135 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/config-store-module.h"
+
+#include <iomanip>
+#include <iostream>
+
+using namespace ns3;
+
+/**
+ * \ingroup configstore-examples
+ * \ingroup examples
+ *
+ * This example measures the time needed to save and load the attribute
+ * values of every object of a topology with the RawText and Binary
+ * ConfigStore formats.  Each node has a SimpleNetDevice, whose data rate is
+ * set to a node-specific value.  The configuration is saved, the topology
+ * is rebuilt with the default values, and the configuration is loaded back;
+ * the data rates are then checked.
+ *
+ * ./waf --run "config-store-snapshot --nNodes=10000"
+ */
+
+/**
+ * Build the topology
+ * \param nNodes the number of nodes
+ * \param configure true to set the node-specific data rates
+ * \return the devices
+ */
+static NetDeviceContainer
+BuildTopology (uint32_t nNodes, bool configure)
+{
+  NodeContainer nodes;
+  nodes.Create (nNodes);
+  SimpleNetDeviceHelper simple;
+  NetDeviceContainer devices = simple.Install (nodes);
+  if (configure)
+    {
+      for (uint32_t i = 0; i < devices.GetN (); i++)
+        {
+          devices.Get (i)->SetAttribute ("DataRate", DataRateValue (DataRate (1000000 * (1 + i % 500))));
+        }
+    }
+  return devices;
+}
+
+/**
+ * Save or load the attribute values
+ * \param format the ConfigStore file format
+ * \param filename the file name
+ * \param mode the ConfigStore mode
+ * \return the wall clock time, in ms
+ */
+static int64_t
+RunConfigStore (std::string format, std::string filename, std::string mode)
+{
+  SystemWallClockMs clock;
+  clock.Start ();
+  Config::SetDefault ("ns3::ConfigStore::Filename", StringValue (filename));
+  Config::SetDefault ("ns3::ConfigStore::FileFormat", StringValue (format));
+  Config::SetDefault ("ns3::ConfigStore::Mode", StringValue (mode));
+  ConfigStore config;
+  config.ConfigureAttributes ();
+  return clock.End ();
+}
+
+/**
+ * Save and load the configuration of the topology in a given format
+ * \param format the ConfigStore file format
+ * \param filename the file name
+ * \param nNodes the number of nodes
+ * \return the number of devices whose data rate was not loaded
+ */
+static uint32_t
+RunFormat (std::string format, std::string filename, uint32_t nNodes)
+{
+  BuildTopology (nNodes, true);
+  int64_t saveTime = RunConfigStore (format, filename, "Save");
+  Simulator::Destroy ();
+
+  NetDeviceContainer devices = BuildTopology (nNodes, false);
+  int64_t loadTime = RunConfigStore (format, filename, "Load");
+  uint32_t errors = 0;
+  for (uint32_t i = 0; i < devices.GetN (); i++)
+    {
+      DataRateValue rate;
+      devices.Get (i)->GetAttribute ("DataRate", rate);
+      if (rate.Get () != DataRate (1000000 * (1 + i % 500)))
+        {
+          errors++;
+        }
+    }
+  Simulator::Destroy ();
+
+  std::cout << std::setw (10) << format << std::setw (12) << saveTime
+            << std::setw (12) << loadTime << std::endl;
+  if (errors > 0)
+    {
+      std::cout << "ERROR: " << errors << " devices not configured" << std::endl;
+    }
+  return errors;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t nNodes = 100;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("nNodes", "Number of nodes", nNodes);
+  cmd.Parse (argc, argv);
+
+  std::cout << "nodes: " << nNodes << std::endl;
+  std::cout << std::setw (10) << "format" << std::setw (12) << "save (ms)"
+            << std::setw (12) << "load (ms)" << std::endl;
+  uint32_t errors = RunFormat ("RawText", "config-store-snapshot.txt", nNodes);
+  errors += RunFormat ("Binary", "config-store-snapshot.bin", nNodes);
+
+  return errors > 0 ? 1 : 0;
+}
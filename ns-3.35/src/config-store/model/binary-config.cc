@@ -0,0 +1,647 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "binary-config.h"
+#include "attribute-iterator.h"
+#include "attribute-default-iterator.h"
+#include "ns3/global-value.h"
+#include "ns3/string.h"
+#include "ns3/abort.h"
+#include "ns3/log.h"
+
+#include <fstream>
+#include <cstring>
+#include <deque>
+#include <iterator>
+#include <utility>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("BinaryConfig");
+
+/// Magic string at the beginning of a binary configuration file
+static const char BINARY_CONFIG_MAGIC[8] = { 'n', 's', '3', 'C', 'F', 'G', 'B', '\0' };
+/// Version of the binary configuration file format
+static const uint32_t BINARY_CONFIG_VERSION = 1;
+
+/**
+ * Write a 32-bit integer to a stream
+ * \param os the output stream
+ * \param v the integer
+ */
+static void
+WriteU32 (std::ostream &os, uint32_t v)
+{
+  os.write (reinterpret_cast<const char *> (&v), sizeof (v));
+}
+
+/**
+ * Read a 32-bit integer from a buffer
+ * \param buffer the buffer
+ * \param pos the read position, moved past the integer
+ * \param v the integer
+ * \returns false if the buffer is too short
+ */
+static bool
+ReadU32 (const std::string &buffer, std::size_t &pos, uint32_t &v)
+{
+  if (pos + sizeof (v) > buffer.size ())
+    {
+      return false;
+    }
+  std::memcpy (&v, buffer.data () + pos, sizeof (v));
+  pos += sizeof (v);
+  return true;
+}
+
+BinaryConfig::BinaryConfig ()
+{
+}
+
+uint32_t
+BinaryConfig::GetStringId (const std::string &str)
+{
+  std::unordered_map<std::string, uint32_t>::const_iterator it = m_stringIds.find (str);
+  if (it != m_stringIds.end ())
+    {
+      return it->second;
+    }
+  uint32_t id = m_strings.size ();
+  m_strings.push_back (str);
+  m_stringIds.emplace (str, id);
+  return id;
+}
+
+uint32_t
+BinaryConfig::GetAttributeId (TypeId tid, uint32_t index, const std::string &name)
+{
+  uint64_t key = (uint64_t (tid.GetHash ()) << 32) | index;
+  std::unordered_map<uint64_t, uint32_t>::const_iterator it = m_attributeIds.find (key);
+  if (it != m_attributeIds.end ())
+    {
+      return it->second;
+    }
+  AttributeRecord record;
+  record.tid = tid.GetHash ();
+  record.index = index;
+  record.name = GetStringId (name);
+  uint32_t id = m_attributes.size ();
+  m_attributes.push_back (record);
+  m_attributeIds.emplace (key, id);
+  return id;
+}
+
+bool
+BinaryConfig::Write (std::string filename) const
+{
+  NS_LOG_FUNCTION (this << filename);
+  std::ofstream os (filename.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!os.is_open ())
+    {
+      NS_LOG_WARN ("Couldn't open the file " << filename);
+      return false;
+    }
+
+  os.write (BINARY_CONFIG_MAGIC, sizeof (BINARY_CONFIG_MAGIC));
+  WriteU32 (os, BINARY_CONFIG_VERSION);
+  WriteU32 (os, m_strings.size ());
+  for (std::vector<std::string>::const_iterator i = m_strings.begin (); i != m_strings.end (); ++i)
+    {
+      WriteU32 (os, i->size ());
+      os.write (i->data (), i->size ());
+    }
+  WriteU32 (os, m_attributes.size ());
+  for (std::vector<AttributeRecord>::const_iterator i = m_attributes.begin (); i != m_attributes.end (); ++i)
+    {
+      WriteU32 (os, i->tid);
+      WriteU32 (os, i->index);
+      WriteU32 (os, i->name);
+    }
+  const std::vector<ValueRecord> *pairs[2] = { &m_defaults, &m_globals };
+  for (uint32_t k = 0; k < 2; k++)
+    {
+      WriteU32 (os, pairs[k]->size ());
+      for (std::vector<ValueRecord>::const_iterator i = pairs[k]->begin (); i != pairs[k]->end (); ++i)
+        {
+          WriteU32 (os, i->attribute);
+          WriteU32 (os, i->value);
+        }
+    }
+  WriteU32 (os, m_objects.size ());
+  for (std::vector<ObjectRecord>::const_iterator i = m_objects.begin (); i != m_objects.end (); ++i)
+    {
+      WriteU32 (os, i->path);
+      WriteU32 (os, i->tid);
+      WriteU32 (os, i->values.size ());
+      for (std::vector<ValueRecord>::const_iterator j = i->values.begin (); j != i->values.end (); ++j)
+        {
+          WriteU32 (os, j->attribute);
+          WriteU32 (os, j->value);
+        }
+    }
+  os.close ();
+  return !os.fail ();
+}
+
+bool
+BinaryConfig::Read (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  std::ifstream is (filename.c_str (), std::ios::in | std::ios::binary);
+  if (!is.is_open ())
+    {
+      NS_LOG_WARN ("Couldn't open the file " << filename);
+      return false;
+    }
+  std::string buffer ((std::istreambuf_iterator<char> (is)), std::istreambuf_iterator<char> ());
+
+  std::size_t pos = sizeof (BINARY_CONFIG_MAGIC);
+  uint32_t version = 0;
+  if (buffer.size () < pos || std::memcmp (buffer.data (), BINARY_CONFIG_MAGIC, pos) != 0
+      || !ReadU32 (buffer, pos, version) || version != BINARY_CONFIG_VERSION)
+    {
+      NS_LOG_WARN ("Not a binary configuration file: " << filename);
+      return false;
+    }
+
+  uint32_t n = 0;
+  bool ok = ReadU32 (buffer, pos, n);
+  m_strings.resize (ok ? n : 0);
+  for (uint32_t i = 0; ok && i < n; i++)
+    {
+      uint32_t size = 0;
+      ok = ReadU32 (buffer, pos, size) && pos + size <= buffer.size ();
+      if (ok)
+        {
+          m_strings[i].assign (buffer, pos, size);
+          pos += size;
+        }
+    }
+  ok = ok && ReadU32 (buffer, pos, n);
+  m_attributes.resize (ok ? n : 0);
+  for (uint32_t i = 0; ok && i < n; i++)
+    {
+      ok = ReadU32 (buffer, pos, m_attributes[i].tid) && ReadU32 (buffer, pos, m_attributes[i].index)
+        && ReadU32 (buffer, pos, m_attributes[i].name) && m_attributes[i].name < m_strings.size ();
+    }
+  std::vector<ValueRecord> *pairs[2] = { &m_defaults, &m_globals };
+  for (uint32_t k = 0; k < 2; k++)
+    {
+      ok = ok && ReadU32 (buffer, pos, n);
+      pairs[k]->resize (ok ? n : 0);
+      for (uint32_t i = 0; ok && i < n; i++)
+        {
+          // the "attribute" of a global value is its name
+          ok = ReadU32 (buffer, pos, (*pairs[k])[i].attribute) && ReadU32 (buffer, pos, (*pairs[k])[i].value)
+            && (*pairs[k])[i].attribute < (k == 0 ? m_attributes.size () : m_strings.size ())
+            && (*pairs[k])[i].value < m_strings.size ();
+        }
+    }
+  ok = ok && ReadU32 (buffer, pos, n);
+  m_objects.resize (ok ? n : 0);
+  for (uint32_t i = 0; ok && i < n; i++)
+    {
+      uint32_t nValues = 0;
+      ok = ReadU32 (buffer, pos, m_objects[i].path) && ReadU32 (buffer, pos, m_objects[i].tid)
+        && ReadU32 (buffer, pos, nValues) && m_objects[i].path < m_strings.size ();
+      m_objects[i].values.resize (ok ? nValues : 0);
+      for (uint32_t j = 0; ok && j < nValues; j++)
+        {
+          ValueRecord &value = m_objects[i].values[j];
+          ok = ReadU32 (buffer, pos, value.attribute) && ReadU32 (buffer, pos, value.value)
+            && value.attribute < m_attributes.size () && value.value < m_strings.size ();
+        }
+    }
+
+  // trailing bytes mean that a count or a size was corrupted
+  ok = ok && pos == buffer.size ();
+  if (!ok)
+    {
+      NS_LOG_WARN ("Truncated or corrupt binary configuration file: " << filename);
+      m_strings.clear ();
+      m_attributes.clear ();
+      m_defaults.clear ();
+      m_globals.clear ();
+      m_objects.clear ();
+      return false;
+    }
+  return true;
+}
+
+BinaryConfigSave::BinaryConfigSave ()
+{
+  NS_LOG_FUNCTION (this);
+}
+BinaryConfigSave::~BinaryConfigSave ()
+{
+  NS_LOG_FUNCTION (this);
+}
+void
+BinaryConfigSave::SetFilename (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  m_filename = filename;
+}
+void
+BinaryConfigSave::Default (void)
+{
+  NS_LOG_FUNCTION (this);
+  class BinaryDefaultIterator : public AttributeDefaultIterator
+  {
+public:
+    BinaryDefaultIterator (BinaryConfigSave *config, bool saveDeprecated)
+      : m_config (config),
+        m_saveDeprecated (saveDeprecated) {}
+private:
+    virtual void VisitAttribute (TypeId tid, std::string name, std::string defaultValue, uint32_t index) {
+      TypeId::SupportLevel supportLevel = tid.GetAttribute (index).supportLevel;
+      if (supportLevel == TypeId::SupportLevel::OBSOLETE)
+        {
+          NS_LOG_WARN ("Global attribute " << tid.GetName () << "::" << name
+                                           << " was not saved because it is OBSOLETE");
+        }
+      else if ((supportLevel == TypeId::SupportLevel::DEPRECATED) && (m_saveDeprecated == false))
+        {
+          NS_LOG_WARN ("Global attribute " << tid.GetName () << "::" << name
+                                           << " was not saved because it is DEPRECATED");
+        }
+      else
+        {
+          ValueRecord record;
+          record.attribute = m_config->GetAttributeId (tid, index, name);
+          record.value = m_config->GetStringId (defaultValue);
+          m_config->m_defaults.push_back (record);
+        }
+    }
+    BinaryConfigSave *m_config;
+    bool m_saveDeprecated;
+  };
+
+  m_defaults.clear ();
+  BinaryDefaultIterator iterator (this, m_saveDeprecated);
+  iterator.Iterate ();
+  Write (m_filename);
+}
+void
+BinaryConfigSave::Global (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_globals.clear ();
+  for (GlobalValue::Iterator i = GlobalValue::Begin (); i != GlobalValue::End (); ++i)
+    {
+      StringValue value;
+      (*i)->GetValue (value);
+      NS_LOG_LOGIC ("Saving " << (*i)->GetName ());
+      ValueRecord record;
+      record.attribute = GetStringId ((*i)->GetName ());
+      record.value = GetStringId (value.Get ());
+      m_globals.push_back (record);
+    }
+  Write (m_filename);
+}
+void
+BinaryConfigSave::Attributes (void)
+{
+  NS_LOG_FUNCTION (this);
+  class BinaryAttributeIterator : public AttributeIterator
+  {
+public:
+    BinaryAttributeIterator (BinaryConfigSave *config, bool saveDeprecated)
+      : m_config (config),
+        m_saveDeprecated (saveDeprecated) {}
+private:
+    /// An attribute of an instance TypeId
+    struct Attribute
+    {
+      uint32_t id;                            //!< attribute id in the snapshot
+      Ptr<const AttributeAccessor> accessor;  //!< attribute accessor
+      Ptr<const AttributeChecker> checker;    //!< attribute checker
+      TypeId::SupportLevel supportLevel;      //!< attribute support level
+    };
+    /// Attributes of an instance TypeId, by name
+    typedef std::unordered_map<std::string, Attribute> Attributes;
+
+    void StartObject (Ptr<Object> object) {
+      // an object reachable through several paths is only saved once
+      uint32_t record = m_objectIds.size ();
+      if (!m_objectIds.emplace (PeekPointer (object), record).second)
+        {
+          m_stack.push_back (std::make_pair (PeekPointer (object), static_cast<ObjectRecord *> (0)));
+          return;
+        }
+      m_objects.resize (record + 1);
+      m_objects[record].path = m_config->GetStringId (GetCurrentPath ());
+      m_objects[record].tid = object->GetInstanceTypeId ().GetHash ();
+      m_stack.push_back (std::make_pair (PeekPointer (object), &m_objects[record]));
+    }
+    void EndObject (void) {
+      m_stack.pop_back ();
+    }
+    const Attributes &GetAttributes (TypeId instance) {
+      std::unordered_map<uint16_t, Attributes>::iterator it = m_tidAttributes.find (instance.GetUid ());
+      if (it != m_tidAttributes.end ())
+        {
+          return it->second;
+        }
+      Attributes &attributes = m_tidAttributes[instance.GetUid ()];
+      for (TypeId tid = instance; tid.HasParent (); tid = tid.GetParent ())
+        {
+          for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
+            {
+              struct TypeId::AttributeInformation info = tid.GetAttribute (i);
+              if (attributes.find (info.name) == attributes.end ())
+                {
+                  Attribute attribute;
+                  attribute.id = m_config->GetAttributeId (tid, i, info.name);
+                  attribute.accessor = info.accessor;
+                  attribute.checker = info.checker;
+                  attribute.supportLevel = info.supportLevel;
+                  attributes.emplace (info.name, attribute);
+                }
+            }
+        }
+      return attributes;
+    }
+    virtual void DoStartVisitObject (Ptr<Object> object) {
+      StartObject (object);
+    }
+    virtual void DoEndVisitObject (void) {
+      EndObject ();
+    }
+    virtual void DoStartVisitPointerAttribute (Ptr<Object> object, std::string name, Ptr<Object> value) {
+      StartObject (value);
+    }
+    virtual void DoEndVisitPointerAttribute (void) {
+      EndObject ();
+    }
+    virtual void DoStartVisitArrayItem (const ObjectPtrContainerValue &vector, uint32_t index, Ptr<Object> item) {
+      StartObject (item);
+    }
+    virtual void DoEndVisitArrayItem (void) {
+      EndObject ();
+    }
+    virtual void DoVisitAttribute (Ptr<Object> object, std::string name) {
+      ObjectRecord *record = 0;
+      for (std::vector<std::pair<Object *, ObjectRecord *> >::reverse_iterator i = m_stack.rbegin ();
+           i != m_stack.rend (); ++i)
+        {
+          if (i->first == PeekPointer (object))
+            {
+              record = i->second;
+              break;
+            }
+        }
+      if (record == 0)
+        {
+          return;
+        }
+
+      const Attribute &attribute = GetAttributes (object->GetInstanceTypeId ()).at (name);
+      if (attribute.supportLevel == TypeId::SupportLevel::OBSOLETE)
+        {
+          NS_LOG_WARN ("Attribute " << GetCurrentPath ()
+                                    << " was not saved because it is OBSOLETE");
+        }
+      else if ((attribute.supportLevel == TypeId::SupportLevel::DEPRECATED) && (m_saveDeprecated == false))
+        {
+          NS_LOG_WARN ("Attribute " << GetCurrentPath ()
+                                    << " was not saved because it is DEPRECATED");
+        }
+      else
+        {
+          Ptr<AttributeValue> value = attribute.checker->Create ();
+          if (attribute.accessor->Get (PeekPointer (object), *value))
+            {
+              ValueRecord valueRecord;
+              valueRecord.attribute = attribute.id;
+              valueRecord.value = m_config->GetStringId (value->SerializeToString (attribute.checker));
+              record->values.push_back (valueRecord);
+            }
+        }
+    }
+
+    BinaryConfigSave *m_config;
+    bool m_saveDeprecated;
+    /// records of the objects, in order of first visit
+    std::deque<ObjectRecord> m_objects;
+    /// record of each object visited
+    std::unordered_map<Object *, uint32_t> m_objectIds;
+    /// objects being visited, with their record (null if already saved)
+    std::vector<std::pair<Object *, ObjectRecord *> > m_stack;
+    /// attributes of each instance TypeId, by TypeId uid
+    std::unordered_map<uint16_t, Attributes> m_tidAttributes;
+
+public:
+    /**
+     * Move the records of the objects with at least one value
+     * \param objects the object records
+     */
+    void GetObjects (std::vector<ObjectRecord> &objects) {
+      for (std::deque<ObjectRecord>::iterator i = m_objects.begin (); i != m_objects.end (); ++i)
+        {
+          if (!i->values.empty ())
+            {
+              objects.push_back (std::move (*i));
+            }
+        }
+    }
+  };
+
+  m_objects.clear ();
+  BinaryAttributeIterator iterator (this, m_saveDeprecated);
+  iterator.Iterate ();
+  iterator.GetObjects (m_objects);
+  Write (m_filename);
+}
+
+BinaryConfigLoad::BinaryConfigLoad ()
+  : m_loaded (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+BinaryConfigLoad::~BinaryConfigLoad ()
+{
+  NS_LOG_FUNCTION (this);
+}
+void
+BinaryConfigLoad::SetFilename (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  m_loaded = Read (filename);
+  if (m_loaded)
+    {
+      Resolve ();
+      for (uint32_t i = 0; i < m_objects.size (); i++)
+        {
+          m_objectIds.emplace (m_strings[m_objects[i].path], i);
+        }
+    }
+}
+
+void
+BinaryConfigLoad::Resolve (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_resolved.resize (m_attributes.size ());
+  for (uint32_t i = 0; i < m_attributes.size (); i++)
+    {
+      const AttributeRecord &record = m_attributes[i];
+      ResolvedAttribute &resolved = m_resolved[i];
+      resolved.valid = false;
+      if (!TypeId::LookupByHashFailSafe (record.tid, &resolved.tid))
+        {
+          NS_LOG_WARN ("Unknown TypeId for attribute " << m_strings[record.name]);
+          continue;
+        }
+      // the index is checked against the name, in case the attributes of
+      // the TypeId changed since the file was saved
+      const std::string &name = m_strings[record.name];
+      resolved.index = record.index;
+      if (record.index >= resolved.tid.GetAttributeN ()
+          || resolved.tid.GetAttribute (record.index).name != name)
+        {
+          resolved.index = resolved.tid.GetAttributeN ();
+          for (uint32_t j = 0; j < resolved.tid.GetAttributeN (); j++)
+            {
+              if (resolved.tid.GetAttribute (j).name == name)
+                {
+                  resolved.index = j;
+                  break;
+                }
+            }
+          if (resolved.index == resolved.tid.GetAttributeN ())
+            {
+              NS_LOG_WARN ("Unknown attribute " << resolved.tid.GetName () << "::" << name);
+              continue;
+            }
+        }
+      struct TypeId::AttributeInformation info = resolved.tid.GetAttribute (resolved.index);
+      resolved.accessor = info.accessor;
+      resolved.checker = info.checker;
+      resolved.valid = true;
+    }
+}
+
+Ptr<const AttributeValue>
+BinaryConfigLoad::GetValue (const ValueRecord &record)
+{
+  const ResolvedAttribute &attribute = m_resolved[record.attribute];
+  if (!attribute.valid)
+    {
+      return 0;
+    }
+  uint64_t key = (uint64_t (record.attribute) << 32) | record.value;
+  std::unordered_map<uint64_t, Ptr<const AttributeValue> >::const_iterator it = m_values.find (key);
+  if (it != m_values.end ())
+    {
+      return it->second;
+    }
+  Ptr<AttributeValue> value = attribute.checker->Create ();
+  bool ok = value->DeserializeFromString (m_strings[record.value], attribute.checker);
+  NS_ABORT_MSG_UNLESS (ok && attribute.checker->Check (*value),
+                       "Invalid value \"" << m_strings[record.value] << "\" for attribute "
+                                          << attribute.tid.GetName () << "::"
+                                          << m_strings[m_attributes[record.attribute].name]);
+  m_values.emplace (key, value);
+  return value;
+}
+
+void
+BinaryConfigLoad::Default (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::vector<ValueRecord>::const_iterator i = m_defaults.begin (); i != m_defaults.end (); ++i)
+    {
+      Ptr<const AttributeValue> value = GetValue (*i);
+      if (value != 0)
+        {
+          ResolvedAttribute &attribute = m_resolved[i->attribute];
+          attribute.tid.SetAttributeInitialValue (attribute.index, value);
+        }
+    }
+}
+void
+BinaryConfigLoad::Global (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::vector<ValueRecord>::const_iterator i = m_globals.begin (); i != m_globals.end (); ++i)
+    {
+      const std::string &name = m_strings[i->attribute];
+      if (!GlobalValue::BindFailSafe (name, StringValue (m_strings[i->value])))
+        {
+          NS_LOG_WARN ("Unknown global value " << name);
+        }
+    }
+}
+
+void
+BinaryConfigLoad::ApplyObject (const std::string &path, Ptr<Object> object)
+{
+  std::unordered_map<std::string, uint32_t>::const_iterator it = m_objectIds.find (path);
+  if (it == m_objectIds.end ())
+    {
+      return;
+    }
+  const ObjectRecord &record = m_objects[it->second];
+  if (record.tid != object->GetInstanceTypeId ().GetHash ())
+    {
+      NS_LOG_WARN ("Object " << path << " has another type than in the configuration file");
+      return;
+    }
+  for (std::vector<ValueRecord>::const_iterator i = record.values.begin (); i != record.values.end (); ++i)
+    {
+      Ptr<const AttributeValue> value = GetValue (*i);
+      if (value != 0 && !m_resolved[i->attribute].accessor->Set (PeekPointer (object), *value))
+        {
+          NS_FATAL_ERROR ("Attribute " << path << "/" << m_strings[m_attributes[i->attribute].name]
+                                       << " could not be set");
+        }
+    }
+}
+
+void
+BinaryConfigLoad::Attributes (void)
+{
+  NS_LOG_FUNCTION (this);
+  class BinaryAttributeIterator : public AttributeIterator
+  {
+public:
+    BinaryAttributeIterator (BinaryConfigLoad *config)
+      : m_config (config) {}
+private:
+    virtual void DoStartVisitObject (Ptr<Object> object) {
+      m_config->ApplyObject (GetCurrentPath (), object);
+    }
+    virtual void DoStartVisitPointerAttribute (Ptr<Object> object, std::string name, Ptr<Object> value) {
+      m_config->ApplyObject (GetCurrentPath (), value);
+    }
+    virtual void DoStartVisitArrayItem (const ObjectPtrContainerValue &vector, uint32_t index, Ptr<Object> item) {
+      m_config->ApplyObject (GetCurrentPath (), item);
+    }
+    virtual void DoVisitAttribute (Ptr<Object> object, std::string name) {
+    }
+    BinaryConfigLoad *m_config;
+  };
+
+  if (m_objects.empty ())
+    {
+      return;
+    }
+  BinaryAttributeIterator iterator (this);
+  iterator.Iterate ();
+}
+
+} // namespace ns3
@@ -0,0 +1,191 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BINARY_CONFIG_H
+#define BINARY_CONFIG_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <stdint.h>
+#include "ns3/type-id.h"
+#include "ns3/attribute.h"
+#include "file-config.h"
+
+namespace ns3 {
+
+class Object;
+
+/**
+ * \ingroup configstore
+ * \brief A binary attribute snapshot, shared by BinaryConfigSave and
+ * BinaryConfigLoad.
+ *
+ * The snapshot holds:
+ * - a table of strings (attribute values, names and object paths), each
+ *   stored once;
+ * - a table of attributes, identified by the hash of the TypeId which
+ *   declares them, their index in this TypeId and their name;
+ * - the default values, as (attribute, value) pairs;
+ * - the global values, as (name, value) pairs;
+ * - one record per object, with its path in the configuration namespace,
+ *   the hash of its TypeId and its (attribute, value) pairs.
+ *
+ * The values are strings, but the loader converts each distinct
+ * (attribute, value) pair only once, and sets the values of an object
+ * directly through the attribute accessors, without resolving a
+ * configuration path per value.
+ */
+class BinaryConfig
+{
+public:
+  BinaryConfig (); //!< default constructor
+
+  /**
+   * Write the snapshot to a file
+   * \param filename the file name
+   * \returns true if the file was written
+   */
+  bool Write (std::string filename) const;
+  /**
+   * Read the snapshot from a file; nothing is read from a file which
+   * is truncated or corrupt
+   * \param filename the file name
+   * \returns true if the file was read
+   */
+  bool Read (std::string filename);
+
+protected:
+  /// An attribute, identified by its TypeId and its index
+  struct AttributeRecord
+  {
+    TypeId::hash_t tid; //!< hash of the TypeId declaring the attribute
+    uint32_t index;     //!< index of the attribute in its TypeId
+    uint32_t name;      //!< name of the attribute (string id)
+  };
+  /// An (attribute, value) pair
+  struct ValueRecord
+  {
+    uint32_t attribute; //!< attribute id
+    uint32_t value;     //!< value (string id)
+  };
+  /// The attribute values of an object
+  struct ObjectRecord
+  {
+    uint32_t path;      //!< path of the object (string id)
+    TypeId::hash_t tid; //!< hash of the instance TypeId of the object
+    std::vector<ValueRecord> values; //!< attribute values of the object
+  };
+
+  /**
+   * Get the id of a string, adding it to the table if needed
+   * \param str the string
+   * \returns the string id
+   */
+  uint32_t GetStringId (const std::string &str);
+  /**
+   * Get the id of an attribute, adding it to the table if needed
+   * \param tid the TypeId declaring the attribute
+   * \param index the index of the attribute in the TypeId
+   * \param name the name of the attribute
+   * \returns the attribute id
+   */
+  uint32_t GetAttributeId (TypeId tid, uint32_t index, const std::string &name);
+
+  std::vector<std::string> m_strings;                   //!< string table
+  std::unordered_map<std::string, uint32_t> m_stringIds; //!< string ids, by string
+  std::vector<AttributeRecord> m_attributes;            //!< attribute table
+  std::unordered_map<uint64_t, uint32_t> m_attributeIds; //!< attribute ids, by (TypeId hash, index)
+  std::vector<ValueRecord> m_defaults;                  //!< default values
+  std::vector<ValueRecord> m_globals;                   //!< global values (name, value)
+  std::vector<ObjectRecord> m_objects;                  //!< object attribute values
+};
+
+/**
+ * \ingroup configstore
+ * \brief A class to enable saving of configuration store in a binary file
+ */
+class BinaryConfigSave : public FileConfig, private BinaryConfig
+{
+public:
+  BinaryConfigSave (); //!< default constructor
+  virtual ~BinaryConfigSave (); //!< destructor
+  // Inherited
+  virtual void SetFilename (std::string filename);
+  virtual void Default (void);
+  virtual void Global (void);
+  virtual void Attributes (void);
+private:
+  std::string m_filename; //!< file name
+};
+
+/**
+ * \ingroup configstore
+ * \brief A class to enable loading of configuration store from a binary file
+ *
+ * Unlike the other formats, the object attribute values are matched to the
+ * objects by walking the configuration namespace once, and are set with
+ * the attribute accessors.
+ */
+class BinaryConfigLoad : public FileConfig, private BinaryConfig
+{
+public:
+  BinaryConfigLoad (); //!< default constructor
+  virtual ~BinaryConfigLoad (); //!< destructor
+  // Inherited
+  virtual void SetFilename (std::string filename);
+  virtual void Default (void);
+  virtual void Global (void);
+  virtual void Attributes (void);
+
+  /**
+   * Set the values of an object from its record, if any
+   * \param path the path of the object
+   * \param object the object
+   */
+  void ApplyObject (const std::string &path, Ptr<Object> object);
+
+private:
+  /// An attribute of the snapshot, resolved in the running program
+  struct ResolvedAttribute
+  {
+    bool valid;                                //!< true if the attribute exists
+    Ptr<const AttributeAccessor> accessor;     //!< attribute accessor
+    Ptr<const AttributeChecker> checker;       //!< attribute checker
+    TypeId tid;                                //!< TypeId declaring the attribute
+    uint32_t index;                            //!< index of the attribute in the TypeId
+  };
+
+  /**
+   * Resolve the attributes of the snapshot
+   */
+  void Resolve (void);
+  /**
+   * Get the value of an (attribute, value) pair, converting it on first use
+   * \param record the (attribute, value) pair
+   * \returns the value, or null if the attribute is unknown
+   */
+  Ptr<const AttributeValue> GetValue (const ValueRecord &record);
+
+  bool m_loaded;                                            //!< true if the file was read
+  std::vector<ResolvedAttribute> m_resolved;                //!< resolved attributes
+  std::unordered_map<uint64_t, Ptr<const AttributeValue> > m_values; //!< converted values, by (attribute, value)
+  std::unordered_map<std::string, uint32_t> m_objectIds;    //!< object records, by path
+};
+
+} // namespace ns3
+
+#endif /* BINARY_CONFIG_H */
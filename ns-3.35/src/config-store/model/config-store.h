@@ -75,7 +75,8 @@ public:
   /// store format
   enum FileFormat {
     XML,
-    RAW_TEXT
+    RAW_TEXT,
+    BINARY
   };
 
   /**
@@ -0,0 +1,267 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+
+#include "ns3/test.h"
+#include "ns3/config.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/string.h"
+#include "ns3/global-value.h"
+#include "ns3/simulator.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/data-rate.h"
+#include "ns3/config-store.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup tests
+ *
+ * \brief Binary ConfigStore test: the default, global and instance values
+ * saved in a binary file are loaded back, whereas nothing is loaded from
+ * a truncated or corrupt file.
+ */
+class BinaryConfigTestCase : public TestCase
+{
+public:
+  BinaryConfigTestCase ();
+  virtual ~BinaryConfigTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Build the topology, with the default values
+   * \returns the devices
+   */
+  NetDeviceContainer BuildTopology (void);
+
+  /**
+   * Save or load the configuration
+   * \param filename the file name
+   * \param mode the ConfigStore mode
+   */
+  void RunConfigStore (std::string filename, std::string mode);
+
+  /**
+   * Load a file in a new topology, and check whether the saved values
+   * were set
+   * \param filename the file name
+   * \param loaded true if the file is valid
+   */
+  void CheckLoad (std::string filename, bool loaded);
+
+  /**
+   * Write a file
+   * \param filename the file name
+   * \param contents the contents of the file
+   */
+  void WriteFile (std::string filename, const std::string &contents);
+
+  /**
+   * Build a file holding the value of the RngRun global value, and
+   * possibly an out of range string index
+   * \param run the value of RngRun
+   * \param corrupt true to refer to a missing string
+   * \returns the contents of the file
+   */
+  std::string BuildRngRunFile (uint32_t run, bool corrupt);
+
+  /**
+   * \returns the value of the RngRun global value
+   */
+  uint64_t GetRngRun (void);
+};
+
+BinaryConfigTestCase::BinaryConfigTestCase ()
+  : TestCase ("Save and load a binary configuration file")
+{
+}
+
+BinaryConfigTestCase::~BinaryConfigTestCase ()
+{
+}
+
+NetDeviceContainer
+BinaryConfigTestCase::BuildTopology (void)
+{
+  NodeContainer nodes;
+  nodes.Create (10);
+  SimpleNetDeviceHelper simple;
+  return simple.Install (nodes);
+}
+
+void
+BinaryConfigTestCase::RunConfigStore (std::string filename, std::string mode)
+{
+  Config::SetDefault ("ns3::ConfigStore::Filename", StringValue (filename));
+  Config::SetDefault ("ns3::ConfigStore::FileFormat", StringValue ("Binary"));
+  Config::SetDefault ("ns3::ConfigStore::Mode", StringValue (mode));
+  ConfigStore config;
+  config.ConfigureDefaults ();
+  config.ConfigureAttributes ();
+  // the defaults saved include the ones of the ConfigStore
+  Config::SetDefault ("ns3::ConfigStore::Mode", StringValue ("None"));
+}
+
+void
+BinaryConfigTestCase::CheckLoad (std::string filename, bool loaded)
+{
+  NetDeviceContainer devices = BuildTopology ();
+  RunConfigStore (filename, "Load");
+  for (uint32_t i = 0; i < devices.GetN (); i++)
+    {
+      DataRateValue rate;
+      devices.Get (i)->GetAttribute ("DataRate", rate);
+      DataRate expected = loaded ? DataRate (1000000 * (1 + i)) : DataRate ("0b/s");
+      NS_TEST_EXPECT_MSG_EQ (rate.Get (), expected, "Wrong data rate of device " << i << " with " << filename);
+    }
+  // the default values apply to the objects created after the load
+  BooleanValue pointToPoint;
+  BuildTopology ().Get (0)->GetAttribute ("PointToPointMode", pointToPoint);
+  NS_TEST_EXPECT_MSG_EQ (pointToPoint.Get (), loaded, "Wrong default value with " << filename);
+  Config::SetDefault ("ns3::SimpleNetDevice::PointToPointMode", BooleanValue (false));
+  Simulator::Destroy ();
+}
+
+void
+BinaryConfigTestCase::WriteFile (std::string filename, const std::string &contents)
+{
+  std::ofstream os (filename.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+  os.write (contents.data (), contents.size ());
+}
+
+std::string
+BinaryConfigTestCase::BuildRngRunFile (uint32_t run, bool corrupt)
+{
+  std::ostringstream os;
+  auto writeU32 = [&os] (uint32_t v) { os.write (reinterpret_cast<const char *> (&v), sizeof (v)); };
+  os.write ("ns3CFGB", 8); // magic, with its null character
+  writeU32 (1); // version
+  std::string strings[2] = { "RngRun", std::to_string (run) };
+  writeU32 (2);
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      writeU32 (strings[i].size ());
+      os.write (strings[i].data (), strings[i].size ());
+    }
+  writeU32 (0); // attributes
+  writeU32 (0); // default values
+  writeU32 (1); // global values
+  writeU32 (0);
+  writeU32 (1);
+  writeU32 (corrupt ? 1 : 0); // objects
+  if (corrupt)
+    {
+      writeU32 (2); // path, which is not in the string table
+      writeU32 (0);
+      writeU32 (0);
+    }
+  return os.str ();
+}
+
+uint64_t
+BinaryConfigTestCase::GetRngRun (void)
+{
+  UintegerValue run;
+  GlobalValue::GetValueByName ("RngRun", run);
+  return run.Get ();
+}
+
+void
+BinaryConfigTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("binary-config.bin");
+
+  // a default value and instance values which differ from the defaults
+  Config::SetDefault ("ns3::SimpleNetDevice::PointToPointMode", BooleanValue (true));
+  NetDeviceContainer devices = BuildTopology ();
+  for (uint32_t i = 0; i < devices.GetN (); i++)
+    {
+      devices.Get (i)->SetAttribute ("DataRate", DataRateValue (DataRate (1000000 * (1 + i))));
+    }
+  RunConfigStore (filename, "Save");
+  Config::SetDefault ("ns3::SimpleNetDevice::PointToPointMode", BooleanValue (false));
+  Simulator::Destroy ();
+
+  CheckLoad (filename, true);
+
+  std::ifstream is (filename.c_str (), std::ios::in | std::ios::binary);
+  std::string contents ((std::istreambuf_iterator<char> (is)), std::istreambuf_iterator<char> ());
+  is.close ();
+  NS_TEST_ASSERT_MSG_GT (contents.size (), 100, "The file is too small");
+
+  std::string truncated = CreateTempDirFilename ("binary-config-truncated.bin");
+  std::size_t sizes[] = { 0, 4, 8, 12, 16, contents.size () / 2, contents.size () - 4, contents.size () - 1 };
+  for (std::size_t size : sizes)
+    {
+      WriteFile (truncated, contents.substr (0, size));
+      CheckLoad (truncated, false);
+    }
+
+  std::string corrupt = CreateTempDirFilename ("binary-config-corrupt.bin");
+  WriteFile (corrupt, contents + std::string (4, '\0'));
+  CheckLoad (corrupt, false);
+  std::string badMagic = contents;
+  badMagic[0] = 'N';
+  WriteFile (corrupt, badMagic);
+  CheckLoad (corrupt, false);
+  std::string badVersion = contents;
+  badVersion[8] = 2;
+  WriteFile (corrupt, badVersion);
+  CheckLoad (corrupt, false);
+  CheckLoad (CreateTempDirFilename ("binary-config-missing.bin"), false);
+
+  // an out of range index prevents the loading of the valid records too
+  uint64_t run = GetRngRun ();
+  WriteFile (corrupt, BuildRngRunFile (run + 7, true));
+  RunConfigStore (corrupt, "Load");
+  NS_TEST_EXPECT_MSG_EQ (GetRngRun (), run, "A value of a corrupt file was loaded");
+  WriteFile (corrupt, BuildRngRunFile (run + 7, false));
+  RunConfigStore (corrupt, "Load");
+  NS_TEST_EXPECT_MSG_EQ (GetRngRun (), run + 7, "A value of a valid file was not loaded");
+  Config::SetGlobal ("RngRun", UintegerValue (run));
+
+  Config::SetDefault ("ns3::ConfigStore::Filename", StringValue (""));
+  Config::SetDefault ("ns3::ConfigStore::FileFormat", StringValue ("RawText"));
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup tests
+ *
+ * \brief Binary ConfigStore TestSuite
+ */
+class BinaryConfigTestSuite : public TestSuite
+{
+public:
+  BinaryConfigTestSuite ();
+};
+
+BinaryConfigTestSuite::BinaryConfigTestSuite ()
+  : TestSuite ("config-store-binary", UNIT)
+{
+  AddTestCase (new BinaryConfigTestCase, TestCase::QUICK);
+}
+
+static BinaryConfigTestSuite g_binaryConfigTestSuite; //!< Static variable for test initialization
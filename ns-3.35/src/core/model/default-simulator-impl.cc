@@ -418,4 +418,10 @@ DefaultSimulatorImpl::GetEventCount (void) const
   return m_eventCount;
 }
 
+uint64_t
+DefaultSimulatorImpl::GetPendingEventCount (void) const
+{
+  return m_unscheduledEvents;
+}
+
 } // namespace ns3
@@ -112,16 +112,10 @@ LogComponent::LogComponent (const std::string & name,
   EnvVarCheck ();
 
   LogComponent::ComponentList *components = GetComponentList ();
-  for (LogComponent::ComponentList::const_iterator i = components->begin ();
-       i != components->end ();
-       i++)
+  if (!components->insert (std::make_pair (name, this)).second)
     {
-      if (i->first == name)
-        {
-          NS_FATAL_ERROR ("Log component \"" << name << "\" has already been registered once.");
-        }
+      NS_FATAL_ERROR ("Log component \"" << name << "\" has already been registered once.");
     }
-  components->insert (std::make_pair (name, this));
 }
 
 LogComponent &
@@ -41,14 +41,17 @@
  *
  * If the class is in a namespace, then the macro call should also be
  * in the namespace.
+ *
+ * The TypeId of the class is only created when it is needed,
+ * see TypeId::DeferRegistration().
  */
 #define NS_OBJECT_ENSURE_REGISTERED(type)               \
   static struct Object ## type ## RegistrationClass     \
   {                                                     \
     Object ## type ## RegistrationClass () {            \
-      ns3::TypeId tid = type::GetTypeId ();             \
-      tid.SetSize (sizeof (type));                      \
-      tid.GetParent ();                                 \
+      ns3::TypeId::DeferRegistration (#type,            \
+                                      &type::GetTypeId, \
+                                      sizeof (type));   \
     }                                                   \
   } Object ## type ## RegistrationVariable
 
@@ -73,9 +76,9 @@
   static struct Object ## type ## param ## RegistrationClass           \
   {                                                                    \
     Object ## type ## param ## RegistrationClass () {                  \
-      ns3::TypeId tid = type<param>::GetTypeId ();                     \
-      tid.SetSize (sizeof (type<param>));                              \
-      tid.GetParent ();                                                \
+      ns3::TypeId::DeferRegistration (#type,                           \
+                                      &type<param>::GetTypeId,         \
+                                      sizeof (type<param>));           \
     }                                                                  \
   } Object ## type ## param ## RegistrationVariable
 
@@ -825,6 +825,12 @@ RealtimeSimulatorImpl::GetEventCount (void) const
   return m_eventCount;
 }
 
+uint64_t
+RealtimeSimulatorImpl::GetPendingEventCount (void) const
+{
+  return m_unscheduledEvents;
+}
+
 void
 RealtimeSimulatorImpl::SetSynchronizationMode (enum SynchronizationMode mode)
 {
@@ -205,6 +205,16 @@ public:
    */
   static uint64_t GetEventCount (void);
 
+  /**
+   * Get the number of events in the event queue.
+   *
+   * Cancelled events stay in the event queue until their expiration
+   * time is reached, so they are included in this count, while removed
+   * events are not.
+   * \returns The number of events currently in the event queue.
+   */
+  static uint64_t GetPendingEventCount (void);
+
 
   /**
    * @name Schedule events (in the same context) to run at a future time.
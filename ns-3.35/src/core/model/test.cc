@@ -23,12 +23,25 @@
 #include "system-path.h"
 #include "log.h"
 #include "des-metrics.h"
+#include "ns3/core-config.h"
+#include <algorithm>
 #include <cmath>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <vector>
 #include <list>
 #include <map>
 
+#if defined (HAVE_UNISTD_H) && defined (HAVE_SYS_WAIT_H)
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#endif
+#ifdef HAVE_SYS_RESOURCE_H
+#include <sys/resource.h>
+#endif
+
 
 /**
  * \file
@@ -68,6 +81,30 @@ TestDoubleIsEqual (const double x1, const double x2, const double epsilon)
   return true;
 }
 
+/**
+ * \ingroup testingimpl
+ * Get the peak resident set size of this process.
+ *
+ * \returns The peak resident set size, in KiB, or 0 if not available.
+ */
+static int64_t
+GetPeakMemory (void)
+{
+#ifdef HAVE_SYS_RESOURCE_H
+  struct rusage usage;
+  if (getrusage (RUSAGE_SELF, &usage) == 0)
+    {
+#ifdef __APPLE__
+      // ru_maxrss is in bytes on macOS
+      return usage.ru_maxrss / 1024;
+#else
+      return usage.ru_maxrss;
+#endif
+    }
+#endif
+  return 0;
+}
+
 /**
  * \ingroup testingimpl
  * Container for details of a test failure.
@@ -124,6 +161,14 @@ struct TestCase::Result
 
   /** Test running time. */
   SystemWallClockMs clock;
+  /** Elapsed real time, in ms. */
+  int64_t elapsedReal;
+  /** Elapsed user time, in ms. */
+  int64_t elapsedUser;
+  /** Elapsed system time, in ms. */
+  int64_t elapsedSystem;
+  /** Peak resident set size of the process which ran the test, in KiB. */
+  int64_t peakMemory;
   /** TestCaseFailure records for each child. */
   std::vector<TestCaseFailure> failure;
   /** \c true if any child TestCases failed. */
@@ -240,6 +285,77 @@ private:
   std::list<TestCase *> FilterTests (std::string testName,
                                      enum TestSuite::Type testType,
                                      enum TestCase::TestDuration maximumTestDuration);
+  /**
+   * Read the timings of a previous run, as written by PrintTimings.
+   *
+   * \param [in] filename The timings file.
+   * \returns \c true if the file could be read.
+   */
+  bool ReadTimingHistory (std::string filename);
+  /**
+   * Get the historical running time of a TestCase.
+   *
+   * For a TestSuite, this is the sum of the times of its test cases.
+   *
+   * \param [in] test The TestCase.
+   * \returns The running time in seconds, or a negative value if unknown.
+   */
+  double GetHistoricalTime (TestCase *test) const;
+  /**
+   * Split the tests in balanced shards and select one of them.
+   *
+   * The tests are assigned, from the longest to the shortest according
+   * to the timing history, to the shard with the smallest total time.
+   * Tests without history are assumed to take the average time.
+   *
+   * \param [in] tests The list of tests to split.
+   * \param [in] shard The index of the shard to select, from 0.
+   * \param [in] shardCount The number of shards.
+   * \returns The tests in the selected shard, in their original order.
+   */
+  std::list<TestCase *> SelectShard (const std::list<TestCase *> &tests,
+                                     uint32_t shard, uint32_t shardCount) const;
+  /**
+   * Run a TestSuite, possibly running its test cases in parallel
+   * worker processes.
+   *
+   * \param [in] suite The TestSuite to run.
+   */
+  void RunTestSuite (TestSuite *suite);
+  /**
+   * Run the test cases of a TestSuite in up to m_jobs worker processes.
+   *
+   * As in the serial case, no new test case is started once a test case
+   * failed.  The results of each test case are sent back to this
+   * process through a file in the temporary directory.
+   *
+   * \param [in] suite The TestSuite to run.
+   */
+  void RunTestCasesInParallel (TestCase *suite);
+  /**
+   * Write the results of a TestCase and of its children.
+   *
+   * \param [in] test The TestCase.
+   * \param [in,out] os The output stream.
+   */
+  void WriteResults (TestCase *test, std::ostream &os) const;
+  /**
+   * Read the results of a TestCase and of its children, as written
+   * by WriteResults.
+   *
+   * \param [in] test The TestCase.
+   * \param [in,out] is The input stream.
+   * \returns \c true if the results could be read.
+   */
+  bool ReadResults (TestCase *test, std::istream &is) const;
+  /**
+   * Print the wall-clock time and the peak memory of the test cases
+   * of a TestSuite, one test case per line.
+   *
+   * \param [in] suite The TestSuite.
+   * \param [in,out] os The output stream.
+   */
+  void PrintTimings (TestSuite *suite, std::ostream &os) const;
 
 
   /** Container type for the test. */
@@ -251,6 +367,9 @@ private:
   bool m_assertOnFailure;    //!< \c true if we should assert on failure.
   bool m_continueOnFailure;  //!< \c true if we should continue on failure.
   bool m_updateData;         //!< \c true if we should update reference data.
+  uint32_t m_jobs;           //!< Maximum number of worker processes per suite.
+  /** Running time in seconds of each (suite, test case) in a previous run. */
+  std::map<std::pair<std::string, std::string>, double> m_timingHistory;
 };
 
 
@@ -264,7 +383,11 @@ TestCaseFailure::TestCaseFailure (std::string _cond, std::string _actual,
   NS_LOG_FUNCTION (this << _cond << _actual << _limit << _message << _file << _line);
 }
 TestCase::Result::Result ()
-  : childrenFailed (false)
+  : elapsedReal (0),
+    elapsedUser (0),
+    elapsedSystem (0),
+    peakMemory (0),
+    childrenFailed (false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -362,7 +485,10 @@ TestCase::Run (TestRunnerImpl *runner)
     }
   DoRun ();
 out:
-  m_result->clock.End ();
+  m_result->elapsedReal = m_result->clock.End ();
+  m_result->elapsedUser = m_result->clock.GetElapsedUser ();
+  m_result->elapsedSystem = m_result->clock.GetElapsedSystem ();
+  m_result->peakMemory = GetPeakMemory ();
   DoTeardown ();
   m_runner = 0;
 }
@@ -505,7 +631,8 @@ TestRunnerImpl::TestRunnerImpl ()
   : m_tempDir (""),
     m_assertOnFailure (false),
     m_continueOnFailure (true),
-    m_updateData (false)
+    m_updateData (false),
+    m_jobs (1)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -669,9 +796,9 @@ TestRunnerImpl::PrintReport (TestCase *test, std::ostream *os, bool xml, int lev
     }
   // Report times in seconds, from ms timer
   const double MS_PER_SEC = 1000.;
-  double real = test->m_result->clock.GetElapsedReal () / MS_PER_SEC;
-  double user = test->m_result->clock.GetElapsedUser () / MS_PER_SEC;
-  double system = test->m_result->clock.GetElapsedSystem () / MS_PER_SEC;
+  double real = test->m_result->elapsedReal / MS_PER_SEC;
+  double user = test->m_result->elapsedUser / MS_PER_SEC;
+  double system = test->m_result->elapsedSystem / MS_PER_SEC;
 
   std::streamsize oldPrecision = (*os).precision (3);
   *os << std::fixed;
@@ -765,6 +892,14 @@ TestRunnerImpl::PrintHelp (const char *program_name) const
             << "output" << std::endl
             << "  --append=FILE          : append test result to FILE instead of standard "
             << "output" << std::endl
+            << "  --jobs=N               : run the test cases of each suite in up to N " << std::endl
+            << "                           worker processes" << std::endl
+            << "  --timings=FILE         : write the wall-clock time and the peak memory " << std::endl
+            << "                           of each test case to FILE" << std::endl
+            << "  --timing-history=FILE  : use the timings written by a previous run to " << std::endl
+            << "                           balance shards and worker processes" << std::endl
+            << "  --shard=I/N            : process only the I-th (from 0) of N shards of " << std::endl
+            << "                           the selected tests, with similar running times" << std::endl
   ;
 }
 
@@ -858,6 +993,359 @@ TestRunnerImpl::FilterTests (std::string testName,
 }
 
 
+bool
+TestRunnerImpl::ReadTimingHistory (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  std::ifstream ifs (filename.c_str ());
+  if (!ifs.is_open ())
+    {
+      return false;
+    }
+  std::string line;
+  while (std::getline (ifs, line))
+    {
+      // suite <TAB> test case <TAB> real time <TAB> peak memory
+      std::string::size_type first = line.find ('\t');
+      std::string::size_type second = line.find ('\t', first + 1);
+      if (first == std::string::npos || second == std::string::npos)
+        {
+          continue;
+        }
+      double real = std::atof (line.c_str () + second + 1);
+      m_timingHistory[std::make_pair (line.substr (0, first),
+                                      line.substr (first + 1, second - first - 1))] += real;
+    }
+  return true;
+}
+
+double
+TestRunnerImpl::GetHistoricalTime (TestCase *test) const
+{
+  NS_LOG_FUNCTION (this << test);
+  if (test->m_parent != 0)
+    {
+      auto it = m_timingHistory.find (std::make_pair (test->m_parent->GetName (),
+                                                      test->GetName ()));
+      return (it != m_timingHistory.end ()) ? it->second : -1;
+    }
+  double time = -1;
+  for (auto it = m_timingHistory.lower_bound (std::make_pair (test->GetName (), std::string ()));
+       it != m_timingHistory.end () && it->first.first == test->GetName (); ++it)
+    {
+      time = std::max (time, 0.0) + it->second;
+    }
+  return time;
+}
+
+std::list<TestCase *>
+TestRunnerImpl::SelectShard (const std::list<TestCase *> &tests,
+                             uint32_t shard, uint32_t shardCount) const
+{
+  NS_LOG_FUNCTION (this << shard << shardCount);
+  std::vector<std::pair<double, uint32_t> > times;
+  double known = 0;
+  uint32_t nKnown = 0;
+  for (std::list<TestCase *>::const_iterator i = tests.begin (); i != tests.end (); ++i)
+    {
+      double time = GetHistoricalTime (*i);
+      if (time >= 0)
+        {
+          known += time;
+          nKnown++;
+        }
+      times.push_back (std::make_pair (time, static_cast<uint32_t> (times.size ())));
+    }
+  double average = (nKnown > 0) ? known / nKnown : 1.0;
+  for (uint32_t i = 0; i < times.size (); ++i)
+    {
+      if (times[i].first < 0)
+        {
+          times[i].first = average;
+        }
+    }
+  // longest processing time first, ties broken by the original order
+  std::stable_sort (times.begin (), times.end (),
+                    [] (const std::pair<double, uint32_t> &a, const std::pair<double, uint32_t> &b)
+                    { return a.first > b.first; });
+
+  std::vector<double> load (shardCount, 0);
+  std::vector<bool> selected (times.size (), false);
+  for (uint32_t i = 0; i < times.size (); ++i)
+    {
+      uint32_t target = std::min_element (load.begin (), load.end ()) - load.begin ();
+      load[target] += times[i].first;
+      selected[times[i].second] = (target == shard);
+    }
+
+  std::list<TestCase *> result;
+  uint32_t index = 0;
+  for (std::list<TestCase *>::const_iterator i = tests.begin (); i != tests.end (); ++i, ++index)
+    {
+      if (selected[index])
+        {
+          result.push_back (*i);
+        }
+    }
+  return result;
+}
+
+void
+TestRunnerImpl::RunTestSuite (TestSuite *suite)
+{
+  NS_LOG_FUNCTION (this << suite);
+#if defined (HAVE_UNISTD_H) && defined (HAVE_SYS_WAIT_H)
+  if (m_jobs > 1 && suite->m_children.size () > 1)
+    {
+      RunTestCasesInParallel (suite);
+      return;
+    }
+#endif
+  suite->Run (this);
+}
+
+void
+TestRunnerImpl::RunTestCasesInParallel (TestCase *suite)
+{
+  NS_LOG_FUNCTION (this << suite);
+#if defined (HAVE_UNISTD_H) && defined (HAVE_SYS_WAIT_H)
+  suite->m_result = new TestCase::Result ();
+  suite->m_runner = this;
+  suite->DoSetup ();
+  suite->m_result->clock.Start ();
+  SystemPath::MakeDirectories (m_tempDir);
+
+  // start the longest test cases first
+  std::vector<std::pair<double, uint32_t> > order;
+  for (uint32_t i = 0; i < suite->m_children.size (); ++i)
+    {
+      order.push_back (std::make_pair (GetHistoricalTime (suite->m_children[i]), i));
+    }
+  std::stable_sort (order.begin (), order.end (),
+                    [] (const std::pair<double, uint32_t> &a, const std::pair<double, uint32_t> &b)
+                    { return a.first > b.first; });
+
+  std::map<pid_t, uint32_t> workers;
+  uint32_t next = 0;
+  while (true)
+    {
+      while (next < order.size () && workers.size () < m_jobs && !suite->IsFailed ())
+        {
+          TestCase *test = suite->m_children[order[next++].second];
+          // do not let the worker inherit buffered output
+          std::cout.flush ();
+          std::cerr.flush ();
+          fflush (0);
+          pid_t pid = fork ();
+          if (pid == 0)
+            {
+              test->Run (this);
+              std::string filename = SystemPath::Append (m_tempDir, "test-runner-worker-"
+                                                         + std::to_string (getpid ()));
+              std::ofstream ofs (filename.c_str ());
+              WriteResults (test, ofs);
+              ofs.close ();
+              std::cout.flush ();
+              std::cerr.flush ();
+              fflush (0);
+              _exit (ofs.fail () ? 1 : 0);
+            }
+          else if (pid > 0)
+            {
+              workers[pid] = order[next - 1].second;
+            }
+          else
+            {
+              NS_LOG_WARN ("Could not start a worker process, running " << test->GetName ());
+              test->Run (this);
+            }
+        }
+      if (workers.empty ())
+        {
+          break;
+        }
+
+      int status;
+      pid_t pid = waitpid (-1, &status, 0);
+      std::map<pid_t, uint32_t>::iterator it = workers.find (pid);
+      if (it == workers.end ())
+        {
+          continue;
+        }
+      TestCase *test = suite->m_children[it->second];
+      workers.erase (it);
+
+      std::string filename = SystemPath::Append (m_tempDir, "test-runner-worker-"
+                                                 + std::to_string (pid));
+      std::ifstream ifs (filename.c_str ());
+      bool valid = WIFEXITED (status) && WEXITSTATUS (status) == 0 && ReadResults (test, ifs);
+      ifs.close ();
+      std::remove (filename.c_str ());
+      if (!valid)
+        {
+          std::ostringstream actual;
+          if (WIFSIGNALED (status))
+            {
+              actual << "signal " << WTERMSIG (status);
+            }
+          else
+            {
+              actual << "exit " << WEXITSTATUS (status);
+            }
+          delete test->m_result;
+          test->m_result = new TestCase::Result ();
+          test->m_result->failure.push_back (TestCaseFailure ("worker process", actual.str (), "exit 0",
+                                                              "test case worker process terminated abnormally",
+                                                              __FILE__, __LINE__));
+        }
+      if (test->IsFailed ())
+        {
+          suite->m_result->childrenFailed = true;
+        }
+    }
+
+  if (!suite->IsFailed ())
+    {
+      suite->DoRun ();
+    }
+  suite->m_result->elapsedReal = suite->m_result->clock.End ();
+  suite->m_result->elapsedUser = suite->m_result->clock.GetElapsedUser ();
+  suite->m_result->elapsedSystem = suite->m_result->clock.GetElapsedSystem ();
+  suite->m_result->peakMemory = GetPeakMemory ();
+  suite->DoTeardown ();
+  suite->m_runner = 0;
+#else
+  suite->Run (this);
+#endif
+}
+
+/**
+ * \ingroup testingimpl
+ * Write a string, preceded by its length.
+ *
+ * \param [in,out] os The output stream.
+ * \param [in] str The string.
+ */
+static void
+WriteResultString (std::ostream &os, const std::string &str)
+{
+  os << str.size () << ' ' << str << '\n';
+}
+
+/**
+ * \ingroup testingimpl
+ * Read a string written by WriteResultString.
+ *
+ * \param [in,out] is The input stream.
+ * \param [out] str The string.
+ * \returns \c true if the string could be read.
+ */
+static bool
+ReadResultString (std::istream &is, std::string &str)
+{
+  std::string::size_type size;
+  if (!(is >> size) || is.get () != ' ')
+    {
+      return false;
+    }
+  str.resize (size);
+  return size == 0 || is.read (&str[0], size);
+}
+
+void
+TestRunnerImpl::WriteResults (TestCase *test, std::ostream &os) const
+{
+  NS_LOG_FUNCTION (this << test << &os);
+  if (test->m_result == 0)
+    {
+      os << 0 << '\n';
+      return;
+    }
+  TestCase::Result *result = test->m_result;
+  os << 1 << ' ' << result->childrenFailed
+     << ' ' << result->elapsedReal << ' ' << result->elapsedUser
+     << ' ' << result->elapsedSystem << ' ' << result->peakMemory
+     << ' ' << result->failure.size () << '\n';
+  for (uint32_t i = 0; i < result->failure.size (); i++)
+    {
+      const TestCaseFailure &failure = result->failure[i];
+      WriteResultString (os, failure.cond);
+      WriteResultString (os, failure.actual);
+      WriteResultString (os, failure.limit);
+      WriteResultString (os, failure.message);
+      WriteResultString (os, failure.file);
+      os << failure.line << '\n';
+    }
+  for (uint32_t i = 0; i < test->m_children.size (); i++)
+    {
+      WriteResults (test->m_children[i], os);
+    }
+}
+
+bool
+TestRunnerImpl::ReadResults (TestCase *test, std::istream &is) const
+{
+  NS_LOG_FUNCTION (this << test << &is);
+  int hasResult;
+  if (!(is >> hasResult))
+    {
+      return false;
+    }
+  delete test->m_result;
+  test->m_result = 0;
+  if (hasResult == 0)
+    {
+      return true;
+    }
+  TestCase::Result *result = new TestCase::Result ();
+  test->m_result = result;
+  std::size_t nFailures;
+  if (!(is >> result->childrenFailed >> result->elapsedReal >> result->elapsedUser
+        >> result->elapsedSystem >> result->peakMemory >> nFailures))
+    {
+      return false;
+    }
+  for (std::size_t i = 0; i < nFailures; i++)
+    {
+      std::string cond, actual, limit, message, file;
+      int32_t line;
+      if (!ReadResultString (is, cond) || !ReadResultString (is, actual)
+          || !ReadResultString (is, limit) || !ReadResultString (is, message)
+          || !ReadResultString (is, file) || !(is >> line))
+        {
+          return false;
+        }
+      result->failure.push_back (TestCaseFailure (cond, actual, limit, message, file, line));
+    }
+  for (uint32_t i = 0; i < test->m_children.size (); i++)
+    {
+      if (!ReadResults (test->m_children[i], is))
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+void
+TestRunnerImpl::PrintTimings (TestSuite *suite, std::ostream &os) const
+{
+  NS_LOG_FUNCTION (this << suite << &os);
+  const double MS_PER_SEC = 1000.;
+  for (uint32_t i = 0; i < suite->m_children.size (); i++)
+    {
+      TestCase *test = suite->m_children[i];
+      if (test->m_result == 0)
+        {
+          continue;
+        }
+      os << suite->GetName () << '\t' << test->GetName ()
+         << '\t' << test->m_result->elapsedReal / MS_PER_SEC
+         << '\t' << test->m_result->peakMemory << std::endl;
+    }
+}
+
+
 int
 TestRunnerImpl::Run (int argc, char *argv[])
 {
@@ -866,6 +1354,10 @@ TestRunnerImpl::Run (int argc, char *argv[])
   std::string testTypeString = "";
   std::string out = "";
   std::string fullness = "";
+  std::string timings = "";
+  std::string timingHistory = "";
+  uint32_t shard = 0;
+  uint32_t shardCount = 0;
   bool xml = false;
   bool append = false;
   bool printTempDir = false;
@@ -948,6 +1440,33 @@ TestRunnerImpl::Run (int argc, char *argv[])
         {
           out = arg + strlen ("--out=");
         }
+      else if (strncmp (arg, "--jobs=", strlen ("--jobs=")) == 0)
+        {
+          int jobs = std::atoi (arg + strlen ("--jobs="));
+          if (jobs < 1)
+            {
+              PrintHelp (progname);
+              return 3;
+            }
+          m_jobs = jobs;
+        }
+      else if (strncmp (arg, "--timings=", strlen ("--timings=")) == 0)
+        {
+          timings = arg + strlen ("--timings=");
+        }
+      else if (strncmp (arg, "--timing-history=", strlen ("--timing-history=")) == 0)
+        {
+          timingHistory = arg + strlen ("--timing-history=");
+        }
+      else if (strncmp (arg, "--shard=", strlen ("--shard=")) == 0)
+        {
+          if (sscanf (arg + strlen ("--shard="), "%u/%u", &shard, &shardCount) != 2
+              || shard >= shardCount)
+            {
+              PrintHelp (progname);
+              return 3;
+            }
+        }
       else if (strncmp (arg, "--fullness=", strlen ("--fullness=")) == 0)
         {
           fullness = arg + strlen ("--fullness=");
@@ -1014,6 +1533,16 @@ TestRunnerImpl::Run (int argc, char *argv[])
 
   std::list<TestCase *> tests = FilterTests (testName, testType, maximumTestDuration);
 
+  if (timingHistory != "" && !ReadTimingHistory (timingHistory))
+    {
+      std::cerr << "Error:  cannot read the timing history " << timingHistory << std::endl;
+      return 1;
+    }
+  if (shardCount > 0)
+    {
+      tests = SelectShard (tests, shard, shardCount);
+    }
+
   if (m_tempDir == "")
     {
       m_tempDir = SystemPath::MakeTemporaryDirectoryName ();
@@ -1056,9 +1585,15 @@ TestRunnerImpl::Run (int argc, char *argv[])
       os = &std::cout;
     }
 
+  std::ofstream timingsStream;
+  if (timings != "")
+    {
+      timingsStream.open (timings.c_str (), std::ios_base::out | std::ios_base::trunc);
+    }
+
   // let's run our tests now.
   bool failed = false;
-  if (tests.size () == 0)
+  if (tests.size () == 0 && shardCount == 0)
     {
       std::cerr << "Error:  no tests match the requested string" << std::endl;
       return 1;
@@ -1091,8 +1626,14 @@ TestRunnerImpl::Run (int argc, char *argv[])
       }
 #endif
 
-      test->Run (this);
+      TestSuite *suite = dynamic_cast<TestSuite *> (test);
+      NS_ASSERT (suite != 0);
+      RunTestSuite (suite);
       PrintReport (test, os, xml, 0);
+      if (timingsStream.is_open ())
+        {
+          PrintTimings (suite, timingsStream);
+        }
       if (test->IsFailed ())
         {
           failed = true;
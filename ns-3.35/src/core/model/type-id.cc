@@ -23,10 +23,12 @@
 #include "singleton.h"
 #include "trace-source-accessor.h"
 
-#include <map>
 #include <vector>
+#include <unordered_map>
 #include <sstream>
 #include <iomanip>
+#include <mutex>
+#include <thread>
 
 /**
  * \file
@@ -53,6 +55,10 @@ NS_LOG_COMPONENT_DEFINE ("TypeId");
  * Information records are stored in a vector.  Name and hash lookup
  * are performed by maps to the vector index.
  *
+ * Since the type ids are created when first used, which may happen in
+ * several threads at once, the records are accessed under a lock.  The
+ * lock is recursive because some methods call other ones.
+ *
  * \internal
  * <b>Hash Chaining</b>
  *
@@ -78,6 +84,7 @@ NS_LOG_COMPONENT_DEFINE ("TypeId");
 class IidManager : public Singleton<IidManager>
 {
 public:
+  IidManager (); //!< Constructor
   /**
    * Create a new unique type id.
    * \param [in] name The name of this type id.
@@ -270,6 +277,23 @@ public:
    * \returns \c true if this TypeId should be hidden from the user.
    */
   bool MustHideFromDocumentation (uint16_t uid) const;
+  /**
+   * Record a type whose type id should only be created when needed.
+   * \param [in] name The class name.
+   * \param [in] getTypeId The function creating the type id.
+   * \param [in] size The object size.
+   */
+  void DeferRegistration (std::string name,
+                          TypeId::GetTypeIdFunction getTypeId,
+                          std::size_t size);
+  /**
+   * Create the deferred type ids which may be named \pname{name},
+   * i.e. those whose class name is the last component of \pname{name}.
+   * \param [in] name The type id name.
+   */
+  void RegisterDeferred (std::string name);
+  /** Create all the deferred type ids. */
+  void RegisterAllDeferred (void);
 
 private:
   /**
@@ -292,6 +316,43 @@ private:
    * \returns The hashed value of \pname{name}.
    */
   static TypeId::hash_t Hasher (const std::string name);
+  /**
+   * Get the class name of a type id name, without namespaces and
+   * template parameters.
+   * \param [in] name The type id name.
+   * \returns The class name.
+   */
+  static std::string GetClassName (std::string name);
+
+  /** The creation state of a deferred type id. */
+  enum DeferredState
+  {
+    PENDING,   //!< Not created through the deferred registration yet.
+    CREATING,  //!< Being created by the thread recorded.
+    CREATED    //!< Created.
+  };
+  /** A type whose type id has not been created yet. */
+  struct DeferredRegistration
+  {
+    /** The function creating the type id. */
+    TypeId::GetTypeIdFunction getTypeId;
+    /** The size of the object represented by this type. */
+    std::size_t size;
+    /** The creation state of the type id. */
+    enum DeferredState state;
+    /** The thread creating the type id. */
+    std::thread::id creator;
+  };
+  /**
+   * Create a deferred type id.
+   *
+   * The type id is created, or its creation by another thread is
+   * awaited, without holding the lock, since the GetTypeId method may
+   * already be running in another thread, which will need the lock to
+   * complete it.
+   * \param [in] i The index of the deferred type.
+   */
+  void RegisterDeferred (std::size_t i);
 
   /** The information record about a single type id. */
   struct IidInformation
@@ -335,15 +396,26 @@ private:
   std::vector<struct IidInformation> m_information;
 
   /** Type of the by-name index. */
-  typedef std::map<std::string, uint16_t> namemap_t;
+  typedef std::unordered_map<std::string, uint16_t> namemap_t;
   /** The by-name index. */
   namemap_t m_namemap;
 
   /** Type of the by-hash index. */
-  typedef std::map<TypeId::hash_t, uint16_t> hashmap_t;
+  typedef std::unordered_map<TypeId::hash_t, uint16_t> hashmap_t;
   /** The by-hash index. */
   hashmap_t m_hashmap;
 
+  /** The types whose type id has not been created yet. */
+  std::vector<struct DeferredRegistration> m_deferred;
+  /** Type of the by-class-name index of the deferred types. */
+  typedef std::unordered_multimap<std::string, std::size_t> deferredmap_t;
+  /** The by-class-name index of the deferred types. */
+  deferredmap_t m_deferredNames;
+  /** The number of deferred types whose type id has not been created. */
+  std::size_t m_deferredN;
+  /** The lock protecting all the above. */
+  mutable std::recursive_mutex m_mutex;
+
 
   /** IidManager constants. */
   enum
@@ -380,10 +452,124 @@ IidManager::Hasher (const std::string name)
  */
 #define IIDL IID << ": "
 
+IidManager::IidManager ()
+  : m_deferredN (0)
+{}
+
+//static
+std::string
+IidManager::GetClassName (std::string name)
+{
+  name = name.substr (0, name.find ('<'));
+  std::string::size_type colon = name.rfind ("::");
+  if (colon != std::string::npos)
+    {
+      name = name.substr (colon + 2);
+    }
+  return name;
+}
+
+void
+IidManager::DeferRegistration (std::string name,
+                               TypeId::GetTypeIdFunction getTypeId,
+                               std::size_t size)
+{
+  NS_LOG_FUNCTION (IID << name << size);
+  std::lock_guard<std::recursive_mutex> lock (m_mutex);
+  struct DeferredRegistration deferred;
+  deferred.getTypeId = getTypeId;
+  deferred.size = size;
+  deferred.state = PENDING;
+  m_deferredNames.insert (std::make_pair (GetClassName (name), m_deferred.size ()));
+  m_deferred.push_back (deferred);
+  m_deferredN++;
+}
+
+void
+IidManager::RegisterDeferred (std::size_t i)
+{
+  NS_LOG_FUNCTION (IID << i);
+  TypeId::GetTypeIdFunction getTypeId;
+  std::size_t size;
+  {
+    std::lock_guard<std::recursive_mutex> lock (m_mutex);
+    struct DeferredRegistration &deferred = m_deferred[i];
+    if (deferred.state == CREATED)
+      {
+        return;
+      }
+    if (deferred.state == CREATING && deferred.creator == std::this_thread::get_id ())
+      {
+        // the creation of this type id needs other ones
+        return;
+      }
+    if (deferred.state == PENDING)
+      {
+        deferred.state = CREATING;
+        deferred.creator = std::this_thread::get_id ();
+      }
+    getTypeId = deferred.getTypeId;
+    size = deferred.size;
+  }
+  // the type id is held by a static variable of GetTypeId, whose
+  // initialization by another thread is awaited
+  TypeId tid = getTypeId ();
+  tid.SetSize (size);
+  tid.GetParent ();
+  std::lock_guard<std::recursive_mutex> lock (m_mutex);
+  if (m_deferred[i].state != CREATED)
+    {
+      m_deferred[i].state = CREATED;
+      m_deferredN--;
+    }
+}
+
+void
+IidManager::RegisterDeferred (std::string name)
+{
+  NS_LOG_FUNCTION (IID << name);
+  std::vector<std::size_t> candidates;
+  {
+    std::lock_guard<std::recursive_mutex> lock (m_mutex);
+    if (m_deferredN == 0)
+      {
+        return;
+      }
+    std::pair<deferredmap_t::const_iterator, deferredmap_t::const_iterator> range =
+      m_deferredNames.equal_range (GetClassName (name));
+    for (deferredmap_t::const_iterator it = range.first; it != range.second; ++it)
+      {
+        candidates.push_back (it->second);
+      }
+  }
+  for (std::size_t i = 0; i < candidates.size (); i++)
+    {
+      RegisterDeferred (candidates[i]);
+    }
+}
+
+void
+IidManager::RegisterAllDeferred (void)
+{
+  NS_LOG_FUNCTION (IID);
+  for (std::size_t i = 0;; i++)
+    {
+      {
+        std::lock_guard<std::recursive_mutex> lock (m_mutex);
+        if (i >= m_deferred.size () || m_deferredN == 0)
+          {
+            return;
+          }
+      }
+      RegisterDeferred (i);
+    }
+}
+
 uint16_t
 IidManager::AllocateUid (std::string name)
 {
   NS_LOG_FUNCTION (IID << name);
+  std::lock_guard<std::recursive_mutex> lock (m_mutex);
   // Type names are definitive: equal names are equal types
   NS_ASSERT_MSG (m_namemap.count (name) == 0,
                  "Trying to allocate twice the same uid: " << name);
@@ -468,6 +654,7 @@ void
 IidManager::SetParent (uint16_t uid, uint16_t parent)
 {
   NS_LOG_FUNCTION (IID << uid << parent);
+  std::lock_guard<std::recursive_mutex> lock (m_mutex);
   NS_ASSERT (parent <= m_information.size ());
   struct IidInformation *information = LookupInformation (uid);
   information->parent = parent;
@@ -476,6 +663,7 @@ void
 IidManager::SetGroupName (uint16_t uid, std::string groupName)
 {
   NS_LOG_FUNCTION (IID << uid << groupName);
+  std::lock_guard<std::recursive_mutex> lock (m_mutex);
   struct IidInformation *information = LookupInformation (uid);
   information->groupName = groupName;
 }
@@ -483,6 +671,7 @@ void
 IidManager::SetSize (uint16_t uid, std::size_t size)
 {
   NS_LOG_FUNCTION (IID << uid << size);
+  std::lock_guard<std::recursive_mutex> lock (m_mutex);
   struct IidInformation *information = LookupInformation (uid);
   information->size = size;
 }
@@ -490,6 +679,7 @@ void
 IidManager::HideFromDocumentation (uint16_t uid)
 {
   NS_LOG_FUNCTION (IID << uid);
+  std::lock_guard<std::recursive_mutex> lock (m_mutex);
   struct IidInformation *information = LookupInformation (uid);
   information->mustHideFromDocumentation = true;
 }
@@ -498,6 +688,7 @@ void
 IidManager::AddConstructor (uint16_t uid, Callback<ObjectBase *> callback)
 {
   NS_LOG_FUNCTION (IID << uid << &callback);
+  std::lock_guard<std::recursive_mutex> lock (m_mutex);
   struct IidInformation *information = LookupInformation (uid);
   if (information->hasConstructor)
     {
@@ -511,6 +702,7 @@ uint16_t
 IidManager::GetUid (std::string name) const
 {
   NS_LOG_FUNCTION (IID << name);
+  std::lock_guard<std::recursive_mutex> lock (m_mutex);
   uint16_t uid = 0;
   namemap_t::const_iterator it = m_namemap.find (name);
   if (it != m_namemap.end ())
@@ -524,6 +716,7 @@ uint16_t
 IidManager::GetUid (TypeId::hash_t hash) const
 {
   NS_LOG_FUNCTION (IID << hash);
+  std::lock_guard<std::recursive_mutex> lock (m_mutex);
   hashmap_t::const_iterator it = m_hashmap.find (hash);
   uint16_t uid = 0;
   if (it != m_hashmap.end ())
@@ -537,6 +730,7 @@ std::string
 IidManager::GetName (uint16_t uid) const
 {
   NS_LOG_FUNCTION (IID << uid);
+  std::lock_guard<std::recursive_mutex> lock (m_mutex);
   struct IidInformation *information = LookupInformation (uid);
   NS_LOG_LOGIC (IIDL << information->name);
   return information->name;
@@ -545,6 +739,7 @@ TypeId::hash_t
 IidManager::GetHash (uint16_t uid) const
 {
   NS_LOG_FUNCTION (IID << uid);
+  std::lock_guard<std::recursive_mutex> lock (m_mutex);
   struct IidInformation *information = LookupInformation (uid);
   TypeId::hash_t hash = information->hash;
   NS_LOG_LOGIC (IIDL << hash);
@@ -554,6 +749,7 @@ uint16_t
 IidManager::GetParent (uint16_t uid) const
 {
   NS_LOG_FUNCTION (IID << uid);
+  std::lock_guard<std::recursive_mutex> lock (m_mutex);
   struct IidInformation *information = LookupInformation (uid);
   uint16_t pid = information->parent;
   NS_LOG_LOGIC (IIDL << pid);
@@ -563,6 +759,7 @@ std::string
 IidManager::GetGroupName (uint16_t uid) const
 {
   NS_LOG_FUNCTION (IID << uid);
+  std::lock_guard<std::recursive_mutex> lock (m_mutex);
   struct IidInformation *information = LookupInformation (uid);
   NS_LOG_LOGIC (IIDL << information->groupName);
   return information->groupName;
@@ -571,6 +768,7 @@ std::size_t
 IidManager::GetSize (uint16_t uid) const
 {
   NS_LOG_FUNCTION (IID << uid);
+  std::lock_guard<std::recursive_mutex> lock (m_mutex);
   struct IidInformation *information = LookupInformation (uid);
   std::size_t size = information->size;
   NS_LOG_LOGIC (IIDL << size);
@@ -581,6 +779,7 @@ Callback<ObjectBase *>
 IidManager::GetConstructor (uint16_t uid) const
 {
   NS_LOG_FUNCTION (IID << uid);
+  std::lock_guard<std::recursive_mutex> lock (m_mutex);
   struct IidInformation *information = LookupInformation (uid);
   if (!information->hasConstructor)
     {
@@ -593,6 +792,7 @@ bool
 IidManager::HasConstructor (uint16_t uid) const
 {
   NS_LOG_FUNCTION (IID << uid);
+  std::lock_guard<std::recursive_mutex> lock (m_mutex);
   struct IidInformation *information = LookupInformation (uid);
   bool hasC = information->hasConstructor;
   NS_LOG_LOGIC (IIDL << hasC);
@@ -603,6 +803,7 @@ uint16_t
 IidManager::GetRegisteredN (void) const
 {
   NS_LOG_FUNCTION (IID << m_information.size ());
+  std::lock_guard<std::recursive_mutex> lock (m_mutex);
   return static_cast<uint16_t> (m_information.size ());
 }
 uint16_t
@@ -617,6 +818,7 @@ IidManager::HasAttribute (uint16_t uid,
                           std::string name)
 {
   NS_LOG_FUNCTION (IID << uid << name);
+  std::lock_guard<std::recursive_mutex> lock (m_mutex);
   struct IidInformation *information  = LookupInformation (uid);
   while (true)
     {
@@ -657,6 +859,7 @@ IidManager::AddAttribute (uint16_t uid,
   NS_LOG_FUNCTION (IID << uid << name << help << flags <<
                    initialValue << accessor << checker <<
                    supportLevel << supportMsg);
+  std::lock_guard<std::recursive_mutex> lock (m_mutex);
   struct IidInformation *information = LookupInformation (uid);
   if (name.find (' ') != std::string::npos)
     {
@@ -689,6 +892,7 @@ IidManager::SetAttributeInitialValue (uint16_t uid,
                                       Ptr<const AttributeValue> initialValue)
 {
   NS_LOG_FUNCTION (IID << uid << i << initialValue);
+  std::lock_guard<std::recursive_mutex> lock (m_mutex);
   struct IidInformation *information = LookupInformation (uid);
   NS_ASSERT (i < information->attributes.size ());
   information->attributes[i].initialValue = initialValue;
@@ -700,6 +904,7 @@ std::size_t
 IidManager::GetAttributeN (uint16_t uid) const
 {
   NS_LOG_FUNCTION (IID << uid);
+  std::lock_guard<std::recursive_mutex> lock (m_mutex);
   struct IidInformation *information = LookupInformation (uid);
   std::size_t size = information->attributes.size ();
   NS_LOG_LOGIC (IIDL << size);
@@ -709,6 +914,7 @@ struct TypeId::AttributeInformation
 IidManager::GetAttribute (uint16_t uid, std::size_t i) const
 {
   NS_LOG_FUNCTION (IID << uid << i);
+  std::lock_guard<std::recursive_mutex> lock (m_mutex);
   struct IidInformation *information = LookupInformation (uid);
   NS_ASSERT (i < information->attributes.size ());
   NS_LOG_LOGIC (IIDL << information->name);
@@ -720,6 +926,7 @@ IidManager::HasTraceSource (uint16_t uid,
                             std::string name)
 {
   NS_LOG_FUNCTION (IID << uid << name);
+  std::lock_guard<std::recursive_mutex> lock (m_mutex);
   struct IidInformation *information  = LookupInformation (uid);
   while (true)
     {
@@ -758,6 +965,7 @@ IidManager::AddTraceSource (uint16_t uid,
   NS_LOG_FUNCTION (IID << uid << name << help <<
                    accessor << callback <<
                    supportLevel << supportMsg);
+  std::lock_guard<std::recursive_mutex> lock (m_mutex);
   struct IidInformation *information  = LookupInformation (uid);
   if (HasTraceSource (uid, name))
     {
@@ -779,6 +987,7 @@ std::size_t
 IidManager::GetTraceSourceN (uint16_t uid) const
 {
   NS_LOG_FUNCTION (IID << uid);
+  std::lock_guard<std::recursive_mutex> lock (m_mutex);
   struct IidInformation *information = LookupInformation (uid);
   std::size_t size = information->traceSources.size ();
   NS_LOG_LOGIC (IIDL << size);
@@ -788,6 +997,7 @@ struct TypeId::TraceSourceInformation
 IidManager::GetTraceSource (uint16_t uid, std::size_t i) const
 {
   NS_LOG_FUNCTION (IID << uid << i);
+  std::lock_guard<std::recursive_mutex> lock (m_mutex);
   struct IidInformation *information = LookupInformation (uid);
   NS_ASSERT (i < information->traceSources.size ());
   NS_LOG_LOGIC (IIDL << information->name);
@@ -797,6 +1007,7 @@ bool
 IidManager::MustHideFromDocumentation (uint16_t uid) const
 {
   NS_LOG_FUNCTION (IID << uid);
+  std::lock_guard<std::recursive_mutex> lock (m_mutex);
   struct IidInformation *information = LookupInformation (uid);
   bool hide = information->mustHideFromDocumentation;
   NS_LOG_LOGIC (IIDL << hide);
@@ -826,11 +1037,53 @@ TypeId::TypeId (uint16_t tid)
 {
   NS_LOG_FUNCTION (this << tid);
 }
+uint16_t
+TypeId::LookupUid (std::string name)
+{
+  NS_LOG_FUNCTION (name);
+  IidManager *manager = IidManager::Get ();
+  // try first the classes named as the type, since a type id is
+  // usually named after its class, then all of them.  This is done
+  // even if the type id is found, since another thread may still be
+  // adding its attributes.
+  manager->RegisterDeferred (name);
+  uint16_t uid = manager->GetUid (name);
+  if (uid == 0)
+    {
+      manager->RegisterAllDeferred ();
+      uid = manager->GetUid (name);
+    }
+  return uid;
+}
+uint16_t
+TypeId::LookupUid (hash_t hash)
+{
+  NS_LOG_FUNCTION (hash);
+  IidManager *manager = IidManager::Get ();
+  uint16_t uid = manager->GetUid (hash);
+  if (uid == 0)
+    {
+      manager->RegisterAllDeferred ();
+      uid = manager->GetUid (hash);
+    }
+  else
+    {
+      // wait for the creation of the type id by another thread
+      manager->RegisterDeferred (manager->GetName (uid));
+    }
+  return uid;
+}
+void
+TypeId::DeferRegistration (std::string name, GetTypeIdFunction getTypeId, std::size_t size)
+{
+  IidManager::Get ()->DeferRegistration (name, getTypeId, size);
+}
+
 TypeId
 TypeId::LookupByName (std::string name)
 {
   NS_LOG_FUNCTION (name);
-  uint16_t uid = IidManager::Get ()->GetUid (name);
+  uint16_t uid = LookupUid (name);
   NS_ASSERT_MSG (uid != 0, "Assert in TypeId::LookupByName: " << name << " not found");
   return TypeId (uid);
 }
@@ -838,7 +1091,7 @@ bool
 TypeId::LookupByNameFailSafe (std::string name, TypeId *tid)
 {
   NS_LOG_FUNCTION (name << tid->GetUid ());
-  uint16_t uid = IidManager::Get ()->GetUid (name);
+  uint16_t uid = LookupUid (name);
   if (uid == 0)
     {
       return false;
@@ -849,7 +1102,7 @@ TypeId::LookupByNameFailSafe (std::string name, TypeId *tid)
 TypeId
 TypeId::LookupByHash (hash_t hash)
 {
-  uint16_t uid = IidManager::Get ()->GetUid (hash);
+  uint16_t uid = LookupUid (hash);
   NS_ASSERT_MSG (uid != 0, "Assert in TypeId::LookupByHash: 0x"
                  << std::hex << hash << std::dec << " not found");
   return TypeId (uid);
@@ -857,7 +1110,7 @@ TypeId::LookupByHash (hash_t hash)
 bool
 TypeId::LookupByHashFailSafe (hash_t hash, TypeId *tid)
 {
-  uint16_t uid = IidManager::Get ()->GetUid (hash);
+  uint16_t uid = LookupUid (hash);
   if (uid == 0)
     {
       return false;
@@ -870,6 +1123,7 @@ uint16_t
 TypeId::GetRegisteredN (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
+  IidManager::Get ()->RegisterAllDeferred ();
   return IidManager::Get ()->GetRegisteredN ();
 }
 TypeId
@@ -992,6 +1246,12 @@ TypeId::GetSize (void) const
 {
   NS_LOG_FUNCTION (this);
   std::size_t size = IidManager::Get ()->GetSize (m_tid);
+  if (size == (std::size_t)(-1))
+    {
+      // the type may have been used before its deferred registration
+      IidManager::Get ()->RegisterAllDeferred ();
+      size = IidManager::Get ()->GetSize (m_tid);
+    }
   return size;
 }
 
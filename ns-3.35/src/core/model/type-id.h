@@ -168,6 +168,29 @@ public:
    */
   static TypeId GetRegistered (uint16_t i);
 
+  /** Type of the static GetTypeId method of a class. */
+  typedef TypeId (*GetTypeIdFunction)(void);
+  /**
+   * Register a class whose TypeId should only be created when needed.
+   *
+   * This is done automatically by NS_OBJECT_ENSURE_REGISTERED().
+   * The TypeId, with its attributes and trace sources, is created the
+   * first time the class calls its GetTypeId method, or when a lookup
+   * by name or by hash doesn't match any created TypeId, or when all
+   * the registered TypeIds are requested with GetRegisteredN().
+   *
+   * The TypeIds may thus be created by several threads, for instance
+   * the first use of the same TypeId by two threads at once: the
+   * TypeId is then created once, and a lookup returns it only once
+   * all its attributes and trace sources have been added.
+   *
+   * \param [in] name The class name, used to find the deferred TypeIds
+   *             which may match a lookup by name.
+   * \param [in] getTypeId The GetTypeId method of the class.
+   * \param [in] size The size of the object, in bytes.
+   */
+  static void DeferRegistration (std::string name, GetTypeIdFunction getTypeId, std::size_t size);
+
   /**
    * Constructor.
    *
@@ -546,6 +569,21 @@ private:
   friend  bool operator <  (TypeId a, TypeId b);
   /**@}*/
 
+  /**
+   * Get the id of a TypeId by name, creating the deferred TypeIds
+   * if needed.
+   * \param [in] name The TypeId name.
+   * \returns The id, or 0 if \pname{name} wasn't found.
+   */
+  static uint16_t LookupUid (std::string name);
+  /**
+   * Get the id of a TypeId by hash, creating the deferred TypeIds
+   * if needed.
+   * \param [in] hash The TypeId hash.
+   * \returns The id, or 0 if \pname{hash} wasn't found.
+   */
+  static uint16_t LookupUid (hash_t hash);
+
   /**
    * Construct from an integer value.
    * \param [in] tid The TypeId value as an integer.
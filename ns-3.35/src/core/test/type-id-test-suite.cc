@@ -30,6 +30,12 @@
 #include "ns3/test.h"
 #include "ns3/log.h"
 #include "ns3/unused.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-thread.h"
+#include <chrono>
+#include <thread>
+#endif
 
 using namespace std;
 
@@ -334,6 +340,197 @@ DeprecatedAttributeTestCase::DoRun (void)
 }
 
 
+//----------------------------
+//
+// Deferred registration test
+
+/// Object registered under the name of its class
+class DeferredRegistrationObject : public Object
+{
+public:
+  /**
+   * Register this type.
+   * \return The TypeId.
+   */
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("ns3::DeferredRegistrationObject")
+      .SetParent<Object> ();
+    return tid;
+  }
+private:
+  double m_data[4]; //!< Data, to make the size distinct from Object
+};
+NS_OBJECT_ENSURE_REGISTERED (DeferredRegistrationObject);
+
+/// Object registered under a name unrelated to its class
+class DeferredRegistrationRenamed : public Object
+{
+public:
+  /**
+   * Register this type.
+   * \return The TypeId.
+   */
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("DeferredRegistrationOtherName")
+      .SetParent<Object> ();
+    return tid;
+  }
+};
+NS_OBJECT_ENSURE_REGISTERED (DeferredRegistrationRenamed);
+
+
+class DeferredRegistrationTestCase : public TestCase
+{
+public:
+  DeferredRegistrationTestCase ();
+  virtual ~DeferredRegistrationTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+};
+
+DeferredRegistrationTestCase::DeferredRegistrationTestCase ()
+  : TestCase ("Check deferred TypeId registration")
+{}
+
+DeferredRegistrationTestCase::~DeferredRegistrationTestCase ()
+{}
+
+void
+DeferredRegistrationTestCase::DoRun (void)
+{
+  TypeId tid;
+  NS_TEST_ASSERT_MSG_EQ (TypeId::LookupByNameFailSafe ("ns3::DeferredRegistrationObject", &tid), true,
+                         "lookup of a type named after its class");
+  NS_TEST_ASSERT_MSG_EQ (tid, DeferredRegistrationObject::GetTypeId (),
+                         "lookup of a type named after its class");
+  NS_TEST_ASSERT_MSG_EQ (tid.GetSize (), sizeof (DeferredRegistrationObject),
+                         "size of a type named after its class");
+  NS_TEST_ASSERT_MSG_EQ (tid.GetParent (), Object::GetTypeId (),
+                         "parent of a type named after its class");
+
+  NS_TEST_ASSERT_MSG_EQ (TypeId::LookupByNameFailSafe ("DeferredRegistrationOtherName", &tid), true,
+                         "lookup of a type with another name");
+  NS_TEST_ASSERT_MSG_EQ (tid, DeferredRegistrationRenamed::GetTypeId (),
+                         "lookup of a type with another name");
+  NS_TEST_ASSERT_MSG_EQ (tid.GetSize (), sizeof (DeferredRegistrationRenamed),
+                         "size of a type with another name");
+
+  NS_TEST_ASSERT_MSG_EQ (TypeId::LookupByHash (tid.GetHash ()), tid,
+                         "lookup by hash");
+  NS_TEST_ASSERT_MSG_EQ (TypeId::LookupByNameFailSafe ("ns3::DeferredRegistrationMissing", &tid), false,
+                         "lookup of a missing type");
+}
+
+
+#ifdef HAVE_PTHREAD_H
+//----------------------------
+//
+// Deferred registration in several threads test
+
+/// Object whose TypeId takes some time to create
+class DeferredThreadsObject : public Object
+{
+public:
+  /**
+   * Register this type.
+   * \return The TypeId.
+   */
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = CreateTypeId ();
+    return tid;
+  }
+
+private:
+  /**
+   * Create the TypeId, leaving time to another thread to look it up
+   * before its attribute is added.
+   * \return The TypeId.
+   */
+  static TypeId CreateTypeId (void)
+  {
+    TypeId tid = TypeId ("ns3::DeferredThreadsObject")
+      .SetParent<Object> ();
+    std::this_thread::sleep_for (std::chrono::milliseconds (50));
+    tid.AddAttribute ("Value", "A value.",
+                      IntegerValue (3),
+                      MakeIntegerAccessor (&DeferredThreadsObject::m_value),
+                      MakeIntegerChecker<int32_t> ());
+    return tid;
+  }
+
+  int32_t m_value; //!< Value
+};
+NS_OBJECT_ENSURE_REGISTERED (DeferredThreadsObject);
+
+
+class DeferredThreadsTestCase : public TestCase
+{
+public:
+  DeferredThreadsTestCase ();
+  virtual ~DeferredThreadsTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /// Get the TypeId from its class, i.e. create it.
+  void GetFromClass (void);
+  /// Get the TypeId by name, after the other thread has started.
+  void GetByName (void);
+
+  TypeId m_fromClass;           //!< TypeId got from the class.
+  TypeId m_byName;              //!< TypeId got by name.
+  std::size_t m_attributesN;    //!< Number of attributes of m_byName.
+};
+
+DeferredThreadsTestCase::DeferredThreadsTestCase ()
+  : TestCase ("Check the first use of a deferred TypeId by two threads"),
+    m_attributesN (0)
+{}
+
+DeferredThreadsTestCase::~DeferredThreadsTestCase ()
+{}
+
+void
+DeferredThreadsTestCase::GetFromClass (void)
+{
+  m_fromClass = DeferredThreadsObject::GetTypeId ();
+}
+
+void
+DeferredThreadsTestCase::GetByName (void)
+{
+  std::this_thread::sleep_for (std::chrono::milliseconds (10));
+  m_byName = TypeId::LookupByName ("ns3::DeferredThreadsObject");
+  m_attributesN = m_byName.GetAttributeN ();
+}
+
+void
+DeferredThreadsTestCase::DoRun (void)
+{
+  Ptr<SystemThread> fromClass =
+    Create<SystemThread> (MakeCallback (&DeferredThreadsTestCase::GetFromClass, this));
+  Ptr<SystemThread> byName =
+    Create<SystemThread> (MakeCallback (&DeferredThreadsTestCase::GetByName, this));
+  fromClass->Start ();
+  byName->Start ();
+  fromClass->Join ();
+  byName->Join ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_byName, m_fromClass,
+                         "both threads got the same TypeId");
+  NS_TEST_ASSERT_MSG_EQ (m_attributesN, 1,
+                         "the TypeId was found once complete");
+  NS_TEST_ASSERT_MSG_EQ (m_fromClass.GetSize (), sizeof (DeferredThreadsObject),
+                         "size of the TypeId");
+}
+#endif /* HAVE_PTHREAD_H */
+
+
 //----------------------------
 //
 // Performance test
@@ -447,6 +644,10 @@ TypeIdTestSuite::TypeIdTestSuite ()
   AddTestCase (new UniqueTypeIdTestCase, QUICK);
   AddTestCase (new CollisionTestCase, QUICK);
   AddTestCase (new DeprecatedAttributeTestCase, QUICK);
+  AddTestCase (new DeferredRegistrationTestCase, QUICK);
+#ifdef HAVE_PTHREAD_H
+  AddTestCase (new DeferredThreadsTestCase, QUICK);
+#endif
 }
 
 static TypeIdTestSuite g_TypeIdTestSuite;
@@ -240,7 +240,15 @@ TcpBbr::InFlight (Ptr<TcpSocketState> tcb, double gain)
       return tcb->m_initialCWnd * tcb->m_segmentSize;
     }
   double quanta = 3 * m_sendQuantum;
-  double estimatedBdp = m_maxBwFilter.GetBest () * m_rtProp / 8.0;
+  // the estimate only changes with the bandwidth or the RTprop, while this
+  // is called on almost every ACK
+  if (m_maxBwFilter.GetBest () != m_bdpBandwidth || m_rtProp != m_bdpRtProp)
+    {
+      m_bdpBandwidth = m_maxBwFilter.GetBest ();
+      m_bdpRtProp = m_rtProp;
+      m_estimatedBdp = m_bdpBandwidth * m_bdpRtProp / 8.0;
+    }
+  double estimatedBdp = m_estimatedBdp;
 
   if (m_state == BbrMode_t::BBR_PROBE_BW && m_cycleIndex == 0)
     {
@@ -352,11 +360,12 @@ void
 TcpBbr::UpdateRTprop (Ptr<TcpSocketState> tcb)
 {
   NS_LOG_FUNCTION (this << tcb);
-  m_rtPropExpired = Simulator::Now () > (m_rtPropStamp + m_rtPropFilterLen);
-  if (tcb->m_lastRtt >= Seconds (0) && (tcb->m_lastRtt <= m_rtProp || m_rtPropExpired))
+  Time now = Simulator::Now ();
+  m_rtPropExpired = now > (m_rtPropStamp + m_rtPropFilterLen);
+  if (!tcb->m_lastRtt.Get ().IsStrictlyNegative () && (tcb->m_lastRtt <= m_rtProp || m_rtPropExpired))
     {
       m_rtProp = tcb->m_lastRtt;
-      m_rtPropStamp = Simulator::Now ();
+      m_rtPropStamp = now;
     }
 }
 
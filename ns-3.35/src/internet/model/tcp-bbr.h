@@ -382,6 +382,9 @@ private:
   Time        m_ackEpochTime                {Seconds(0)};        //!< Starting of ACK sampling epoch time
   uint32_t    m_ackEpochAcked               {0};                 //!< Bytes ACked in sampling epoch
   bool        m_hasSeenRtt                  {false};             //!< Have we seen RTT sample yet?
+  DataRate    m_bdpBandwidth                {0};                 //!< Bandwidth of the last BDP estimate
+  Time        m_bdpRtProp                   {Time::Max ()};      //!< RTprop of the last BDP estimate
+  double      m_estimatedBdp                {0};                 //!< Last BDP estimate (in bytes)
 };
 
 } // namespace ns3
@@ -215,9 +215,8 @@ uint32_t
 TcpCubic::Update (Ptr<TcpSocketState> tcb)
 {
   NS_LOG_FUNCTION (this);
-  Time t;
   uint32_t delta, bicTarget, cnt = 0;
-  double offs;
+  double t, offs;
   uint32_t segCwnd = tcb->GetCwndInSegments ();
 
   if (m_epochStart == Time::Min ())
@@ -239,27 +238,29 @@ TcpCubic::Update (Ptr<TcpSocketState> tcb)
         }
     }
 
-  t = Simulator::Now () + m_delayMin - m_epochStart;
+  // elapsed time since the start of the epoch, plus the minimum delay (in
+  // seconds); computed once per ACK, as the conversion is not free
+  t = (Simulator::Now () + m_delayMin - m_epochStart).GetSeconds ();
 
-  if (t.GetSeconds () < m_bicK)       /* t - K */
+  if (t < m_bicK)       /* t - K */
     {
-      offs = m_bicK - t.GetSeconds ();
-      NS_LOG_DEBUG ("t=" << t.GetSeconds () << " <k: offs=" << offs);
+      offs = m_bicK - t;
+      NS_LOG_DEBUG ("t=" << t << " <k: offs=" << offs);
     }
   else
     {
-      offs = t.GetSeconds () - m_bicK;
-      NS_LOG_DEBUG ("t=" << t.GetSeconds () << " >= k: offs=" << offs);
+      offs = t - m_bicK;
+      NS_LOG_DEBUG ("t=" << t << " >= k: offs=" << offs);
     }
 
 
   /* Constant value taken from Experimental Evaluation of Cubic Tcp, available at
    * eprints.nuim.ie/1716/1/Hamiltonpfldnet2007_cubic_final.pdf */
-  delta = m_c * std::pow (offs, 3);
+  delta = m_c * (offs * offs * offs);
 
   NS_LOG_DEBUG ("delta: " << delta);
 
-  if (t.GetSeconds () < m_bicK)
+  if (t < m_bicK)
     {
       // below origin
       bicTarget = m_bicOriginPoint - delta;
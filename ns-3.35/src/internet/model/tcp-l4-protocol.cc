@@ -41,6 +41,7 @@
 #include "ipv6-routing-protocol.h"
 #include "tcp-socket-factory-impl.h"
 #include "tcp-socket-base.h"
+#include "tcp-timer-wheel.h"
 #include "tcp-congestion-ops.h"
 #include "tcp-cubic.h"
 #include "tcp-recovery-ops.h"
@@ -92,12 +93,20 @@ TcpL4Protocol::GetTypeId (void)
                    ObjectVectorValue (),
                    MakeObjectVectorAccessor (&TcpL4Protocol::m_sockets),
                    MakeObjectVectorChecker<TcpSocketBase> ())
+    .AddAttribute ("TimerWheel",
+                   "If true, the timers of the sockets are kept in a TcpTimerWheel, "
+                   "with a single simulator event per node; otherwise, each timer "
+                   "is scheduled as a simulator event.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&TcpL4Protocol::m_useTimerWheel),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
 
 TcpL4Protocol::TcpL4Protocol ()
-  : m_endPoints (new Ipv4EndPointDemux ()), m_endPoints6 (new Ipv6EndPointDemux ())
+  : m_endPoints (new Ipv4EndPointDemux ()), m_endPoints6 (new Ipv6EndPointDemux ()),
+    m_useTimerWheel (true)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -163,6 +172,12 @@ TcpL4Protocol::DoDispose (void)
   NS_LOG_FUNCTION (this);
   m_sockets.clear ();
 
+  if (m_timerWheel != 0)
+    {
+      m_timerWheel->Dispose ();
+      m_timerWheel = 0;
+    }
+
   if (m_endPoints != 0)
     {
       delete m_endPoints;
@@ -742,6 +757,16 @@ TcpL4Protocol::RemoveSocket (Ptr<TcpSocketBase> socket)
   return false;
 }
 
+Ptr<TcpTimerWheel>
+TcpL4Protocol::GetTimerWheel (void)
+{
+  if (m_useTimerWheel && m_timerWheel == 0)
+    {
+      m_timerWheel = CreateObject<TcpTimerWheel> ();
+    }
+  return m_timerWheel;
+}
+
 void
 TcpL4Protocol::SetDownTarget (IpL4Protocol::DownTargetCallback callback)
 {
@@ -41,6 +41,7 @@ class TcpSocketBase;
 class Ipv4EndPoint;
 class Ipv6EndPoint;
 class NetDevice;
+class TcpTimerWheel;
 
 
 /**
@@ -235,6 +236,15 @@ public:
    */
   bool RemoveSocket (Ptr<TcpSocketBase> socket);
 
+  /**
+   * \brief Get the timer wheel keeping the timers of the sockets
+   *
+   * The wheel is created on the first call.
+   *
+   * \return the timer wheel, or 0 if the TimerWheel attribute is false
+   */
+  Ptr<TcpTimerWheel> GetTimerWheel (void);
+
   /**
    * \brief Remove an IPv4 Endpoint.
    * \param endPoint the end point to remove
@@ -320,6 +330,8 @@ private:
   TypeId m_rttTypeId;              //!< The RTT Estimator TypeId
   TypeId m_congestionTypeId;       //!< The socket TypeId
   TypeId m_recoveryTypeId;         //!< The recovery TypeId
+  bool m_useTimerWheel;            //!< True if the sockets keep their timers in the timer wheel
+  Ptr<TcpTimerWheel> m_timerWheel; //!< The timer wheel of the sockets
   std::vector<Ptr<TcpSocketBase> > m_sockets;      //!< list of sockets
   IpL4Protocol::DownTargetCallback m_downTarget;   //!< Callback to send packets over IPv4
   IpL4Protocol::DownTargetCallback6 m_downTarget6; //!< Callback to send packets over IPv6
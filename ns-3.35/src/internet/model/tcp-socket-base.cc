@@ -205,6 +205,11 @@ TcpSocketBase::GetTypeId (void)
                      "The current TCP pacing rate",
                      MakeTraceSourceAccessor (&TcpSocketBase::m_pacingRateTrace),
                      "ns3::TracedValueCallback::DataRate")
+    .AddTraceSource ("PacingDeviation",
+                     "Delay between the earliest departure time allowed by "
+                     "pacing and the actual departure of each paced segment",
+                     MakeTraceSourceAccessor (&TcpSocketBase::m_pacingDeviationTrace),
+                     "ns3::Time::TracedCallback")
     .AddTraceSource ("CongestionWindow",
                      "The TCP connection's congestion window",
                      MakeTraceSourceAccessor (&TcpSocketBase::m_cWndTrace),
@@ -259,7 +264,6 @@ TcpSocketBase::TcpSocketBase (void)
   m_tcb->m_rxBuffer = CreateObject<TcpRxBuffer> ();
 
   m_tcb->m_pacingRate = m_tcb->m_maxPacingRate;
-  m_pacingTimer.SetFunction (&TcpSocketBase::NotifyPacingPerformed, this);
 
   m_tcb->m_sendEmptyPacketCallback = MakeCallback (&TcpSocketBase::SendEmptyPacket, this);
 
@@ -353,7 +357,6 @@ TcpSocketBase::TcpSocketBase (const TcpSocketBase& sock)
     m_isFirstPartialAck (sock.m_isFirstPartialAck),
     m_txTrace (sock.m_txTrace),
     m_rxTrace (sock.m_rxTrace),
-    m_pacingTimer (Timer::CANCEL_ON_DESTROY),
     m_ecnEchoSeq (sock.m_ecnEchoSeq),
     m_ecnCESeq (sock.m_ecnCESeq),
     m_ecnCWRSeq (sock.m_ecnCWRSeq)
@@ -379,7 +382,7 @@ TcpSocketBase::TcpSocketBase (const TcpSocketBase& sock)
   m_tcb->m_rxBuffer = CopyObject (sock.m_tcb->m_rxBuffer);
 
   m_tcb->m_pacingRate = m_tcb->m_maxPacingRate;
-  m_pacingTimer.SetFunction (&TcpSocketBase::NotifyPacingPerformed, this);
+  SetTimerWheel (sock.m_retxEvent.GetWheel ());
 
   if (sock.m_congestionControl)
     {
@@ -481,6 +484,7 @@ void
 TcpSocketBase::SetTcp (Ptr<TcpL4Protocol> tcp)
 {
   m_tcp = tcp;
+  SetTimerWheel (tcp != nullptr ? tcp->GetTimerWheel () : nullptr);
 }
 
 /* Set an RTT estimator with this socket */
@@ -1375,13 +1379,13 @@ TcpSocketBase::DoForwardUp (Ptr<Packet> packet, const Address &fromAddress,
     { // Zero window: Enter persist state to send 1 byte to probe
       NS_LOG_LOGIC (this << " Enter zerowindow persist state");
       NS_LOG_LOGIC (this << " Cancelled ReTxTimeout event which was set to expire at " <<
-                    (Simulator::Now () + Simulator::GetDelayLeft (m_retxEvent)).GetSeconds ());
+                    (Simulator::Now () + m_retxEvent.GetDelayLeft ()).GetSeconds ());
       m_retxEvent.Cancel ();
       NS_LOG_LOGIC ("Schedule persist timeout at time " <<
                     Simulator::Now ().GetSeconds () << " to expire at time " <<
                     (Simulator::Now () + m_persistTimeout).GetSeconds ());
-      m_persistEvent = Simulator::Schedule (m_persistTimeout, &TcpSocketBase::PersistTimeout, this);
-      NS_ASSERT (m_persistTimeout == Simulator::GetDelayLeft (m_persistEvent));
+      m_persistEvent.Schedule (m_persistTimeout, MakeCallback (&TcpSocketBase::PersistTimeout, this));
+      NS_ASSERT (m_persistTimeout == m_persistEvent.GetDelayLeft ());
     }
 
   // TCP state machine code in different process functions
@@ -2625,7 +2629,7 @@ TcpSocketBase::DoPeerClose (void)
       m_dataRetrCount = m_dataRetries; // prevent endless FINs
       NS_LOG_LOGIC ("TcpSocketBase " << this << " scheduling LATO1");
       Time lastRto = m_rtt->GetEstimate () + Max (m_clockGranularity, m_rtt->GetVariation () * 4);
-      m_lastAckEvent = Simulator::Schedule (lastRto, &TcpSocketBase::LastAckTimeout, this);
+      m_lastAckEvent.Schedule (lastRto, MakeCallback (&TcpSocketBase::LastAckTimeout, this));
     }
 }
 
@@ -2641,7 +2645,7 @@ TcpSocketBase::Destroy (void)
       m_tcp->RemoveSocket (this);
     }
   NS_LOG_LOGIC (this << " Cancelled ReTxTimeout event which was set to expire at " <<
-                (Simulator::Now () + Simulator::GetDelayLeft (m_retxEvent)).GetSeconds ());
+                (Simulator::Now () + m_retxEvent.GetDelayLeft ()).GetSeconds ());
   CancelAllTimers ();
 }
 
@@ -2657,7 +2661,7 @@ TcpSocketBase::Destroy6 (void)
       m_tcp->RemoveSocket (this);
     }
   NS_LOG_LOGIC (this << " Cancelled ReTxTimeout event which was set to expire at " <<
-                (Simulator::Now () + Simulator::GetDelayLeft (m_retxEvent)).GetSeconds ());
+                (Simulator::Now () + m_retxEvent.GetDelayLeft ()).GetSeconds ());
   CancelAllTimers ();
 }
 
@@ -2785,7 +2789,7 @@ TcpSocketBase::SendEmptyPacket (uint8_t flags)
       NS_LOG_LOGIC ("Schedule retransmission timeout at time "
                     << Simulator::Now ().GetSeconds () << " to expire at time "
                     << (Simulator::Now () + m_rto.Get ()).GetSeconds ());
-      m_retxEvent = Simulator::Schedule (m_rto, &TcpSocketBase::SendEmptyPacket, this, flags);
+      m_retxEvent.Schedule (m_rto, MakeCallback (&TcpSocketBase::SendEmptyPacket, this).Bind (flags));
     }
 }
 
@@ -3059,9 +3063,11 @@ TcpSocketBase::SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool with
       NS_LOG_INFO ("Pacing is enabled");
       if (m_pacingTimer.IsExpired ())
         {
-          NS_LOG_DEBUG ("Current Pacing Rate " << m_tcb->m_pacingRate);
-          NS_LOG_DEBUG ("Timer is in expired state, activate it " << m_tcb->m_pacingRate.Get ().CalculateBytesTxTime (sz));
-          m_pacingTimer.Schedule (m_tcb->m_pacingRate.Get ().CalculateBytesTxTime (sz));
+          if (m_pacingNextSend != Time::Min ())
+            {
+              m_pacingDeviationTrace (Simulator::Now () - m_pacingNextSend);
+            }
+          SchedulePacing (sz);
         }
       else
         {
@@ -3128,7 +3134,7 @@ TcpSocketBase::SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool with
       NS_LOG_LOGIC (this << " SendDataPacket Schedule ReTxTimeout at time " <<
                     Simulator::Now ().GetSeconds () << " to expire at time " <<
                     (Simulator::Now () + m_rto.Get ()).GetSeconds () );
-      m_retxEvent = Simulator::Schedule (m_rto, &TcpSocketBase::ReTxTimeout, this);
+      m_retxEvent.Schedule (m_rto, MakeCallback (&TcpSocketBase::ReTxTimeout, this));
     }
 
   m_txTrace (p, header, this);
@@ -3319,9 +3325,7 @@ TcpSocketBase::SendPendingData (bool withAck)
               NS_LOG_INFO ("Pacing is enabled");
               if (m_pacingTimer.IsExpired ())
                 {
-                  NS_LOG_DEBUG ("Current Pacing Rate " << m_tcb->m_pacingRate);
-                  NS_LOG_DEBUG ("Timer is in expired state, activate it " << m_tcb->m_pacingRate.Get ().CalculateBytesTxTime (sz));
-                  m_pacingTimer.Schedule (m_tcb->m_pacingRate.Get ().CalculateBytesTxTime (sz));
+                  SchedulePacing (sz);
                   break;
                 }
             }
@@ -3513,10 +3517,10 @@ TcpSocketBase::ReceivedData (Ptr<Packet> p, const TcpHeader& tcpHeader)
       else if (m_delAckEvent.IsExpired ())
         {
           m_congestionControl->CwndEvent (m_tcb, TcpSocketState::CA_EVENT_DELAYED_ACK);
-          m_delAckEvent = Simulator::Schedule (m_delAckTimeout,
-                                               &TcpSocketBase::DelAckTimeout, this);
+          m_delAckEvent.Schedule (m_delAckTimeout,
+                                  MakeCallback (&TcpSocketBase::DelAckTimeout, this));
           NS_LOG_LOGIC (this << " scheduled delayed ACK at " <<
-                        (Simulator::Now () + Simulator::GetDelayLeft (m_delAckEvent)).GetSeconds ());
+                        (Simulator::Now () + m_delAckEvent.GetDelayLeft ()).GetSeconds ());
         }
     }
 }
@@ -3589,7 +3593,7 @@ TcpSocketBase::NewAck (SequenceNumber32 const& ack, bool resetRTO)
   if (m_state != SYN_RCVD && resetRTO)
     { // Set RTO unless the ACK is received in SYN_RCVD state
       NS_LOG_LOGIC (this << " Cancelled ReTxTimeout event which was set to expire at " <<
-                    (Simulator::Now () + Simulator::GetDelayLeft (m_retxEvent)).GetSeconds ());
+                    (Simulator::Now () + m_retxEvent.GetDelayLeft ()).GetSeconds ());
       m_retxEvent.Cancel ();
       // On receiving a "New" ack we restart retransmission timer .. RFC 6298
       // RFC 6298, clause 2.4
@@ -3598,7 +3602,7 @@ TcpSocketBase::NewAck (SequenceNumber32 const& ack, bool resetRTO)
       NS_LOG_LOGIC (this << " Schedule ReTxTimeout at time " <<
                     Simulator::Now ().GetSeconds () << " to expire at time " <<
                     (Simulator::Now () + m_rto.Get ()).GetSeconds ());
-      m_retxEvent = Simulator::Schedule (m_rto, &TcpSocketBase::ReTxTimeout, this);
+      m_retxEvent.Schedule (m_rto, MakeCallback (&TcpSocketBase::ReTxTimeout, this));
     }
 
   // Note the highest ACK and tell app to send more
@@ -3616,7 +3620,7 @@ TcpSocketBase::NewAck (SequenceNumber32 const& ack, bool resetRTO)
   if (m_txBuffer->Size () == 0 && m_state != FIN_WAIT_1 && m_state != CLOSING)
     { // No retransmit timer if no data to retransmit
       NS_LOG_LOGIC (this << " Cancelled ReTxTimeout event which was set to expire at " <<
-                    (Simulator::Now () + Simulator::GetDelayLeft (m_retxEvent)).GetSeconds ());
+                    (Simulator::Now () + m_retxEvent.GetDelayLeft ()).GetSeconds ());
       m_retxEvent.Cancel ();
     }
 }
@@ -3735,6 +3739,7 @@ TcpSocketBase::ReTxTimeout ()
   m_tcb->m_cWndInfl = m_tcb->m_cWnd;
 
   m_pacingTimer.Cancel ();
+  m_pacingNextSend = Time::Min ();
 
   NS_LOG_DEBUG ("RTO. Reset cwnd to " <<  m_tcb->m_cWnd << ", ssthresh to " <<
                 m_tcb->m_ssThresh << ", restart from seqnum " <<
@@ -3786,7 +3791,7 @@ TcpSocketBase::LastAckTimeout (void)
       SendEmptyPacket (TcpHeader::FIN | TcpHeader::ACK);
       NS_LOG_LOGIC ("TcpSocketBase " << this << " rescheduling LATO1");
       Time lastRto = m_rtt->GetEstimate () + Max (m_clockGranularity, m_rtt->GetVariation () * 4);
-      m_lastAckEvent = Simulator::Schedule (lastRto, &TcpSocketBase::LastAckTimeout, this);
+      m_lastAckEvent.Schedule (lastRto, MakeCallback (&TcpSocketBase::LastAckTimeout, this));
     }
 }
 
@@ -3842,7 +3847,7 @@ TcpSocketBase::PersistTimeout ()
   NS_LOG_LOGIC ("Schedule persist timeout at time "
                 << Simulator::Now ().GetSeconds () << " to expire at time "
                 << (Simulator::Now () + m_persistTimeout).GetSeconds ());
-  m_persistEvent = Simulator::Schedule (m_persistTimeout, &TcpSocketBase::PersistTimeout, this);
+  m_persistEvent.Schedule (m_persistTimeout, MakeCallback (&TcpSocketBase::PersistTimeout, this));
 }
 
 void
@@ -3880,6 +3885,17 @@ TcpSocketBase::DoRetransmit ()
   NS_ASSERT (sz > 0);
 }
 
+void
+TcpSocketBase::SetTimerWheel (Ptr<TcpTimerWheel> wheel)
+{
+  m_retxEvent.SetWheel (wheel);
+  m_lastAckEvent.SetWheel (wheel);
+  m_delAckEvent.SetWheel (wheel);
+  m_persistEvent.SetWheel (wheel);
+  m_timewaitEvent.SetWheel (wheel);
+  m_pacingTimer.SetWheel (wheel);
+}
+
 void
 TcpSocketBase::CancelAllTimers ()
 {
@@ -3890,6 +3906,7 @@ TcpSocketBase::CancelAllTimers ()
   m_timewaitEvent.Cancel ();
   m_sendPendingDataEvent.Cancel ();
   m_pacingTimer.Cancel ();
+  m_pacingNextSend = Time::Min ();
 }
 
 /* Move TCP to Time_Wait state and schedule a transition to Closed state */
@@ -3909,8 +3926,8 @@ TcpSocketBase::TimeWait ()
     }
   // Move from TIME_WAIT to CLOSED after 2*MSL. Max segment lifetime is 2 min
   // according to RFC793, p.28
-  m_timewaitEvent = Simulator::Schedule (Seconds (2 * m_msl),
-                                         &TcpSocketBase::CloseAndNotify, this);
+  m_timewaitEvent.Schedule (Seconds (2 * m_msl),
+                            MakeCallback (&TcpSocketBase::CloseAndNotify, this));
 }
 
 /* Below are the attribute get/set functions */
@@ -4453,6 +4470,17 @@ TcpSocketBase::NotifyPacingPerformed (void)
   SendPendingData (m_connected);
 }
 
+void
+TcpSocketBase::SchedulePacing (uint32_t size)
+{
+  NS_LOG_FUNCTION (this << size);
+  Time txTime = m_tcb->m_pacingRate.Get ().CalculateBytesTxTime (size);
+  NS_LOG_DEBUG ("Current Pacing Rate " << m_tcb->m_pacingRate);
+  NS_LOG_DEBUG ("Timer is in expired state, activate it " << txTime);
+  m_pacingNextSend = Simulator::Now () + txTime;
+  m_pacingTimer.Schedule (txTime, MakeCallback (&TcpSocketBase::NotifyPacingPerformed, this));
+}
+
 bool
 TcpSocketBase::IsPacingEnabled (void) const
 {
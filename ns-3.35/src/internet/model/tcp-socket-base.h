@@ -32,6 +32,7 @@
 #include "ns3/data-rate.h"
 #include "ns3/node.h"
 #include "ns3/tcp-socket-state.h"
+#include "ns3/tcp-timer-wheel.h"
 
 namespace ns3 {
 
@@ -850,6 +851,13 @@ protected:
    */
   void DoPeerClose (void);
 
+  /**
+   * \brief Set the timer wheel keeping the TCP timers
+   * \param wheel the timer wheel of the node, or 0 to schedule the timers
+   * in the simulator
+   */
+  void SetTimerWheel (Ptr<TcpTimerWheel> wheel);
+
   /**
    * \brief Cancel all timer when endpoint is deleted
    */
@@ -1210,6 +1218,12 @@ protected:
    */
   void NotifyPacingPerformed (void);
 
+  /**
+   * \brief Arm the pacing timer for the transmission time of a segment
+   * \param size the size of the segment
+   */
+  void SchedulePacing (uint32_t size);
+
   /**
    * \brief Return true if packets in the current window should be paced
    * \return true if pacing is currently enabled
@@ -1243,11 +1257,11 @@ protected:
 
 protected:
   // Counters and events
-  EventId           m_retxEvent     {}; //!< Retransmission event
-  EventId           m_lastAckEvent  {}; //!< Last ACK timeout event
-  EventId           m_delAckEvent   {}; //!< Delayed ACK timeout event
-  EventId           m_persistEvent  {}; //!< Persist event: Send 1 byte to probe for a non-zero Rx window
-  EventId           m_timewaitEvent {}; //!< TIME_WAIT expiration event: Move this socket to CLOSED state
+  TcpTimer          m_retxEvent;        //!< Retransmission event
+  TcpTimer          m_lastAckEvent;     //!< Last ACK timeout event
+  TcpTimer          m_delAckEvent;      //!< Delayed ACK timeout event
+  TcpTimer          m_persistEvent;     //!< Persist event: Send 1 byte to probe for a non-zero Rx window
+  TcpTimer          m_timewaitEvent;    //!< TIME_WAIT expiration event: Move this socket to CLOSED state
 
   // ACK management
   uint32_t          m_dupAckCount {0};     //!< Dupack counter
@@ -1341,7 +1355,9 @@ protected:
                  Ptr<const TcpSocketBase> > m_rxTrace; //!< Trace of received packets
 
   // Pacing related variable
-  Timer m_pacingTimer {Timer::CANCEL_ON_DESTROY}; //!< Pacing Event
+  TcpTimer m_pacingTimer;                 //!< Pacing Event
+  Time m_pacingNextSend {Time::Min ()};   //!< Earliest departure time of the next paced segment
+  TracedCallback<Time> m_pacingDeviationTrace; //!< Trace of the delay of the paced segments
 
   // Parameters related to Explicit Congestion Notification
   TracedValue<SequenceNumber32> m_ecnEchoSeq {0};      //!< Sequence number of the last received ECN Echo
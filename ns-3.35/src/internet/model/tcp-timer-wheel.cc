@@ -0,0 +1,381 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "tcp-timer-wheel.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpTimerWheel");
+
+NS_OBJECT_ENSURE_REGISTERED (TcpTimerWheel);
+
+TcpTimer::TcpTimer ()
+  : m_wheel (0),
+    m_expiry (0),
+    m_seq (0),
+    m_slot (0),
+    m_linked (false),
+    m_prev (0),
+    m_next (0)
+{
+}
+
+TcpTimer::~TcpTimer ()
+{
+  Cancel ();
+}
+
+void
+TcpTimer::SetWheel (Ptr<TcpTimerWheel> wheel)
+{
+  Cancel ();
+  m_wheel = wheel;
+}
+
+Ptr<TcpTimerWheel>
+TcpTimer::GetWheel (void) const
+{
+  return m_wheel;
+}
+
+void
+TcpTimer::Schedule (const Time &delay, const Callback<void> &callback)
+{
+  NS_ASSERT (!delay.IsStrictlyNegative ());
+  Cancel ();
+  m_callback = callback;
+  if (m_wheel == 0)
+    {
+      m_event = Simulator::Schedule (delay, &TcpTimer::Expire, this);
+      return;
+    }
+  m_expiry = (Simulator::Now () + delay).GetTimeStep ();
+  m_wheel->Add (this);
+}
+
+void
+TcpTimer::Cancel (void)
+{
+  if (m_linked)
+    {
+      m_wheel->Remove (this);
+    }
+  else if (m_wheel == 0)
+    {
+      m_event.Cancel ();
+    }
+}
+
+bool
+TcpTimer::IsRunning (void) const
+{
+  if (m_wheel != 0)
+    {
+      return m_linked;
+    }
+  return m_event.IsRunning ();
+}
+
+bool
+TcpTimer::IsExpired (void) const
+{
+  return !IsRunning ();
+}
+
+Time
+TcpTimer::GetDelayLeft (void) const
+{
+  if (m_linked)
+    {
+      return TimeStep (m_expiry) - Simulator::Now ();
+    }
+  return Simulator::GetDelayLeft (m_event);
+}
+
+void
+TcpTimer::Expire (void)
+{
+  m_callback ();
+}
+
+TypeId
+TcpTimerWheel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TcpTimerWheel")
+    .SetParent<Object> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<TcpTimerWheel> ()
+    .AddAttribute ("Resolution",
+                   "Duration of a tick of the first level of the wheel. The timers "
+                   "still expire at their exact time: the resolution only sets how "
+                   "the timers are spread over the slots. It must not be changed "
+                   "while the wheel has timers.",
+                   TimeValue (MilliSeconds (1)),
+                   MakeTimeAccessor (&TcpTimerWheel::m_resolution),
+                   MakeTimeChecker (TimeStep (1)))
+  ;
+  return tid;
+}
+
+TcpTimerWheel::TcpTimerWheel ()
+  : m_current (0),
+    m_eventTs (0),
+    m_expiring (false),
+    m_seq (0),
+    m_nTimers (0),
+    m_nEvents (0)
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t i = 0; i <= OVERFLOW_SLOT; ++i)
+    {
+      m_slots[i] = 0;
+    }
+  for (uint32_t level = 0; level < LEVELS; ++level)
+    {
+      m_occupied[level] = 0;
+    }
+}
+
+TcpTimerWheel::~TcpTimerWheel ()
+{
+  NS_LOG_FUNCTION (this);
+  m_event.Cancel ();
+}
+
+void
+TcpTimerWheel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_event.Cancel ();
+  for (uint32_t i = 0; i <= OVERFLOW_SLOT; ++i)
+    {
+      while (m_slots[i] != 0)
+        {
+          Unlink (m_slots[i]);
+        }
+    }
+  Object::DoDispose ();
+}
+
+uint32_t
+TcpTimerWheel::GetNTimers (void) const
+{
+  return m_nTimers;
+}
+
+uint64_t
+TcpTimerWheel::GetNEvents (void) const
+{
+  return m_nEvents;
+}
+
+void
+TcpTimerWheel::Add (TcpTimer *timer)
+{
+  NS_LOG_FUNCTION (this << timer << timer->m_expiry);
+  Advance (Simulator::Now ().GetTimeStep () / m_resolution.GetTimeStep ());
+  timer->m_seq = m_seq++;
+  Insert (timer);
+  // while the wheel has timers, its event is scheduled at or before the
+  // earliest expiration time
+  if (!m_expiring && (!m_event.IsRunning () || timer->m_expiry < m_eventTs))
+    {
+      ScheduleEvent (timer->m_expiry);
+    }
+}
+
+void
+TcpTimerWheel::Remove (TcpTimer *timer)
+{
+  NS_LOG_FUNCTION (this << timer);
+  // the simulator event is left in place: if the timer was the first one,
+  // the next timer is scheduled when the event runs
+  Unlink (timer);
+}
+
+void
+TcpTimerWheel::Insert (TcpTimer *timer)
+{
+  int64_t tick = timer->m_expiry / m_resolution.GetTimeStep ();
+  NS_ASSERT (tick >= m_current);
+  // the timer goes in the lowest level whose upper digits are the ones of
+  // the current tick, so that the slots of a level are entered in order
+  uint32_t index = OVERFLOW_SLOT;
+  for (uint32_t level = 0; level < LEVELS; ++level)
+    {
+      uint32_t shift = SLOT_BITS * (level + 1);
+      if ((tick >> shift) == (m_current >> shift))
+        {
+          uint32_t slot = (tick >> (SLOT_BITS * level)) & (SLOTS - 1);
+          m_occupied[level] |= (uint64_t (1) << slot);
+          index = level * SLOTS + slot;
+          break;
+        }
+    }
+  timer->m_slot = index;
+  timer->m_prev = 0;
+  timer->m_next = m_slots[index];
+  if (m_slots[index] != 0)
+    {
+      m_slots[index]->m_prev = timer;
+    }
+  m_slots[index] = timer;
+  timer->m_linked = true;
+  m_nTimers++;
+}
+
+void
+TcpTimerWheel::Unlink (TcpTimer *timer)
+{
+  NS_ASSERT (timer->m_linked);
+  if (timer->m_prev != 0)
+    {
+      timer->m_prev->m_next = timer->m_next;
+    }
+  else
+    {
+      m_slots[timer->m_slot] = timer->m_next;
+      if (timer->m_next == 0 && timer->m_slot != OVERFLOW_SLOT)
+        {
+          m_occupied[timer->m_slot / SLOTS] &= ~(uint64_t (1) << (timer->m_slot % SLOTS));
+        }
+    }
+  if (timer->m_next != 0)
+    {
+      timer->m_next->m_prev = timer->m_prev;
+    }
+  timer->m_prev = 0;
+  timer->m_next = 0;
+  timer->m_linked = false;
+  m_nTimers--;
+}
+
+void
+TcpTimerWheel::Advance (int64_t tick)
+{
+  if (tick <= m_current)
+    {
+      return;
+    }
+  int64_t previous = m_current;
+  m_current = tick;
+  // all the timers expire at or after the current tick: when a slot of an
+  // upper level is entered, its timers go to the lower levels
+  if ((tick >> (SLOT_BITS * LEVELS)) != (previous >> (SLOT_BITS * LEVELS)))
+    {
+      TcpTimer *timer = m_slots[OVERFLOW_SLOT];
+      while (timer != 0)
+        {
+          TcpTimer *next = timer->m_next;
+          Unlink (timer);
+          Insert (timer);
+          timer = next;
+        }
+    }
+  for (uint32_t level = LEVELS - 1; level > 0; --level)
+    {
+      uint32_t shift = SLOT_BITS * level;
+      if ((tick >> shift) == (previous >> shift))
+        {
+          continue;
+        }
+      uint32_t index = level * SLOTS + ((tick >> shift) & (SLOTS - 1));
+      TcpTimer *timer = m_slots[index];
+      while (timer != 0)
+        {
+          TcpTimer *next = timer->m_next;
+          Unlink (timer);
+          Insert (timer);
+          timer = next;
+        }
+    }
+}
+
+TcpTimer *
+TcpTimerWheel::FindEarliest (void) const
+{
+  // the first non-empty slot of the lowest non-empty level holds the timers
+  // of the earliest tick; the overflow list is only used if the levels are
+  // empty
+  TcpTimer *timer = m_slots[OVERFLOW_SLOT];
+  for (uint32_t level = 0; level < LEVELS; ++level)
+    {
+      uint64_t occupied = m_occupied[level];
+      if (occupied != 0)
+        {
+          uint32_t slot = 0;
+          while ((occupied & 1) == 0)
+            {
+              occupied >>= 1;
+              slot++;
+            }
+          timer = m_slots[level * SLOTS + slot];
+          break;
+        }
+    }
+  TcpTimer *earliest = timer;
+  for (; timer != 0; timer = timer->m_next)
+    {
+      if (timer->m_expiry < earliest->m_expiry
+          || (timer->m_expiry == earliest->m_expiry && timer->m_seq < earliest->m_seq))
+        {
+          earliest = timer;
+        }
+    }
+  return earliest;
+}
+
+void
+TcpTimerWheel::ScheduleEvent (int64_t ts)
+{
+  if (m_event.IsRunning ())
+    {
+      Simulator::Remove (m_event);
+    }
+  NS_LOG_LOGIC ("wake up at " << TimeStep (ts).As (Time::S));
+  m_eventTs = ts;
+  m_event = Simulator::Schedule (TimeStep (m_eventTs) - Simulator::Now (), &TcpTimerWheel::Expire, this);
+  m_nEvents++;
+}
+
+void
+TcpTimerWheel::Expire (void)
+{
+  NS_LOG_FUNCTION (this);
+  int64_t now = Simulator::Now ().GetTimeStep ();
+  Advance (now / m_resolution.GetTimeStep ());
+  // the callbacks may arm or cancel any timer, including the expired ones
+  m_expiring = true;
+  TcpTimer *timer = FindEarliest ();
+  while (timer != 0 && timer->m_expiry <= now)
+    {
+      NS_ASSERT (timer->m_expiry == now);
+      Unlink (timer);
+      Callback<void> callback = timer->m_callback;
+      callback ();
+      timer = FindEarliest ();
+    }
+  m_expiring = false;
+  if (timer != 0)
+    {
+      ScheduleEvent (timer->m_expiry);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,244 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#ifndef TCP_TIMER_WHEEL_H
+#define TCP_TIMER_WHEEL_H
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/callback.h"
+
+namespace ns3 {
+
+class TcpTimerWheel;
+
+/**
+ * \ingroup tcp
+ *
+ * \brief A TCP timer (retransmission, delayed ACK, persist, ...)
+ *
+ * The timer has the same semantics as an EventId returned by
+ * Simulator::Schedule: it expires exactly after the requested delay,
+ * and it can be cancelled or re-armed at any time. When a TcpTimerWheel
+ * is set, the timer is kept in the wheel and re-arming it does not touch
+ * the simulator event queue; otherwise, each Schedule () schedules an
+ * event in the simulator.
+ */
+class TcpTimer
+{
+public:
+  TcpTimer ();
+  ~TcpTimer ();
+
+  /**
+   * \brief Set the timer wheel keeping this timer
+   *
+   * The timer is cancelled if it is running.
+   *
+   * \param wheel the timer wheel, or 0 to schedule the timer in the simulator
+   */
+  void SetWheel (Ptr<TcpTimerWheel> wheel);
+
+  /**
+   * \brief Get the timer wheel keeping this timer
+   * \return the timer wheel, or 0 if there is none
+   */
+  Ptr<TcpTimerWheel> GetWheel (void) const;
+
+  /**
+   * \brief Arm the timer, cancelling it first if it is running
+   * \param delay the delay after which the timer expires
+   * \param callback the function called when the timer expires
+   */
+  void Schedule (const Time &delay, const Callback<void> &callback);
+
+  /**
+   * \brief Cancel the timer, if it is running
+   */
+  void Cancel (void);
+
+  /**
+   * \brief Check if the timer is running
+   * \return true if the timer is armed and has not expired yet
+   */
+  bool IsRunning (void) const;
+
+  /**
+   * \brief Check if the timer has expired (or was never armed, or was cancelled)
+   * \return true if the timer is not running
+   */
+  bool IsExpired (void) const;
+
+  /**
+   * \brief Get the time left before the timer expires
+   * \return the time left, or zero if the timer is not running
+   */
+  Time GetDelayLeft (void) const;
+
+private:
+  friend class TcpTimerWheel;
+
+  /**
+   * \brief Copy constructor (disabled)
+   * \param other the timer
+   */
+  TcpTimer (const TcpTimer &other);
+  /**
+   * \brief Copy assignment (disabled)
+   * \param other the timer
+   * \return this timer
+   */
+  TcpTimer & operator = (const TcpTimer &other);
+
+  /**
+   * \brief Call the callback, when the timer is scheduled in the simulator
+   */
+  void Expire (void);
+
+  Ptr<TcpTimerWheel> m_wheel;  //!< The timer wheel, if any
+  Callback<void> m_callback;   //!< The function called at the expiration
+  EventId m_event;             //!< The simulator event, when there is no wheel
+  int64_t m_expiry;            //!< Expiration time (in time steps), when in the wheel
+  uint64_t m_seq;              //!< Order of the Schedule () calls, when in the wheel
+  uint32_t m_slot;             //!< Slot of the wheel keeping the timer
+  bool m_linked;               //!< True if the timer is in the wheel
+  TcpTimer *m_prev;            //!< Previous timer of the slot
+  TcpTimer *m_next;            //!< Next timer of the slot
+};
+
+/**
+ * \ingroup tcp
+ *
+ * \brief Hierarchical timer wheel keeping the TCP timers of a node
+ *
+ * TcpSocketBase re-arms its retransmission timer on almost every ACK, and
+ * its delayed ACK timer on every other segment. With a simulator event per
+ * timer, every re-arm leaves a cancelled event in the event queue until
+ * its (former) expiration time, so that with many connections the event
+ * queue is mostly made of cancelled events.
+ *
+ * The wheel has 4 levels of 64 slots: level 0 covers 64 ticks of the
+ * Resolution attribute, level 1 64 times more, and so on; the timers
+ * expiring beyond the last level are kept in an overflow list. Adding,
+ * re-arming or cancelling a timer is O(1), and the timers of a slot are
+ * moved to the lower levels as the time passes. The expiration times are
+ * not rounded to the resolution: the wheel has a single simulator event,
+ * scheduled at the exact expiration time of its earliest timer, and the
+ * timers expiring at the same time are called in the order they were
+ * armed. The simulator event is only moved when a timer is armed before
+ * the earliest expiration time; when the earliest timer is re-armed later
+ * or cancelled, the event is left in place and the wheel just schedules
+ * the next one when it runs.
+ */
+class TcpTimerWheel : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  TcpTimerWheel ();
+  virtual ~TcpTimerWheel ();
+
+  /**
+   * \brief Get the number of running timers
+   * \return the number of timers in the wheel
+   */
+  uint32_t GetNTimers (void) const;
+
+  /**
+   * \brief Get the number of events scheduled in the simulator by the wheel
+   * \return the number of simulator events scheduled so far
+   */
+  uint64_t GetNEvents (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  friend class TcpTimer;
+
+  static const uint32_t SLOT_BITS = 6;                   //!< Number of bits of the slot index
+  static const uint32_t SLOTS = 1 << SLOT_BITS;          //!< Number of slots per level
+  static const uint32_t LEVELS = 4;                      //!< Number of levels
+  static const uint32_t OVERFLOW_SLOT = LEVELS * SLOTS;  //!< Index of the overflow list
+
+  /**
+   * \brief Add a timer to the wheel
+   * \param timer the timer, with its expiration time set
+   */
+  void Add (TcpTimer *timer);
+
+  /**
+   * \brief Remove a timer from the wheel
+   * \param timer the timer
+   */
+  void Remove (TcpTimer *timer);
+
+  /**
+   * \brief Link a timer in the slot corresponding to its expiration time
+   * \param timer the timer
+   */
+  void Insert (TcpTimer *timer);
+
+  /**
+   * \brief Unlink a timer from its slot
+   * \param timer the timer
+   */
+  void Unlink (TcpTimer *timer);
+
+  /**
+   * \brief Move the wheel to the given tick, cascading the timers of the
+   * slots entered in the upper levels
+   * \param tick the current tick
+   */
+  void Advance (int64_t tick);
+
+  /**
+   * \brief Find the timer expiring first
+   * \return the timer, or 0 if the wheel is empty
+   */
+  TcpTimer * FindEarliest (void) const;
+
+  /**
+   * \brief Move the simulator event to the given time
+   * \param ts the expiration time of the earliest timer (in time steps)
+   */
+  void ScheduleEvent (int64_t ts);
+
+  /**
+   * \brief Call the expired timers
+   */
+  void Expire (void);
+
+  Time m_resolution;                   //!< Duration of a tick
+  int64_t m_current;                   //!< Current tick
+  TcpTimer *m_slots[OVERFLOW_SLOT + 1]; //!< First timer of each slot, and of the overflow list
+  uint64_t m_occupied[LEVELS];         //!< Bitmap of the non-empty slots of each level
+  EventId m_event;                     //!< The simulator event
+  int64_t m_eventTs;                   //!< Time of the simulator event (in time steps)
+  bool m_expiring;                     //!< True while calling the expired timers
+  uint64_t m_seq;                      //!< Sequence number of the next armed timer
+  uint32_t m_nTimers;                  //!< Number of timers in the wheel
+  uint64_t m_nEvents;                  //!< Number of simulator events scheduled
+};
+
+} // namespace ns3
+
+#endif /* TCP_TIMER_WHEEL_H */
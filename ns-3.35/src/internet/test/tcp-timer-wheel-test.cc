@@ -0,0 +1,306 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/tcp-timer-wheel.h"
+
+#include <vector>
+#include <utility>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("TcpTimerWheelTestSuite");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check that the timers of a TcpTimerWheel expire exactly when,
+ * and in the same order as, timers scheduled in the simulator
+ *
+ * Two sets of timers, one kept in a wheel and one scheduled in the
+ * simulator, are randomly armed, re-armed and cancelled in the same way,
+ * with delays spanning all the levels of the wheel and its overflow list;
+ * some timers are also re-armed when they expire. The expirations of the
+ * two sets must be identical.
+ */
+class TcpTimerWheelExpirationTestCase : public TestCase
+{
+public:
+  TcpTimerWheelExpirationTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  static const uint32_t N_TIMERS = 256; //!< Number of timers per set
+
+  /**
+   * \brief Arm, re-arm or cancel a random timer in both sets
+   */
+  void Operate (void);
+
+  /**
+   * \brief Get a random delay
+   * \return the delay
+   */
+  Time GetRandomDelay (void);
+
+  /**
+   * \brief Log the expiration of a timer, and re-arm it a few times
+   * \param wheel true for the timers kept in the wheel
+   * \param i the index of the timer
+   */
+  void Expire (bool wheel, uint32_t i);
+
+  TcpTimer m_wheelTimers[N_TIMERS];  //!< Timers kept in the wheel
+  TcpTimer m_timers[N_TIMERS];       //!< Timers scheduled in the simulator
+  std::vector<std::pair<int64_t, uint32_t> > m_wheelLog; //!< Expirations of the timers kept in the wheel
+  std::vector<std::pair<int64_t, uint32_t> > m_log;      //!< Expirations of the timers scheduled in the simulator
+  uint32_t m_wheelExpired[N_TIMERS]; //!< Number of expirations of each timer kept in the wheel
+  uint32_t m_expired[N_TIMERS];      //!< Number of expirations of each timer scheduled in the simulator
+  Ptr<UniformRandomVariable> m_rng;  //!< Random variable
+};
+
+TcpTimerWheelExpirationTestCase::TcpTimerWheelExpirationTestCase ()
+  : TestCase ("Check the expiration of the timers of a TcpTimerWheel")
+{
+}
+
+Time
+TcpTimerWheelExpirationTestCase::GetRandomDelay (void)
+{
+  // Operate () runs 1 ns after multiples of 10 us, and most timers expire
+  // at multiples of 10 us: many timers expire at the same time, but not
+  // at the same time as Operate (), whose order with respect to the
+  // timers would depend on the way they are scheduled. With a resolution
+  // of 1 us, the 4 levels of the wheel cover about 16.8 s.
+  double p = m_rng->GetValue ();
+  if (p < 0.05)
+    {
+      return Seconds (0);
+    }
+  if (p < 0.55)
+    {
+      return MicroSeconds (10 * m_rng->GetInteger (1, 200)) - NanoSeconds (1);
+    }
+  if (p < 0.8)
+    {
+      return NanoSeconds (m_rng->GetInteger (1, 300000000));
+    }
+  return MicroSeconds (10 * m_rng->GetInteger (100000, 4000000)) - NanoSeconds (1);
+}
+
+void
+TcpTimerWheelExpirationTestCase::Operate (void)
+{
+  uint32_t i = m_rng->GetInteger (0, N_TIMERS - 1);
+  NS_TEST_ASSERT_MSG_EQ (m_wheelTimers[i].IsRunning (), m_timers[i].IsRunning (), "Timer " << i << " in a different state");
+  NS_TEST_ASSERT_MSG_EQ (m_wheelTimers[i].GetDelayLeft (), m_timers[i].GetDelayLeft (), "Timer " << i << " with a different delay");
+  if (m_rng->GetValue () < 0.2)
+    {
+      m_wheelTimers[i].Cancel ();
+      m_timers[i].Cancel ();
+    }
+  else
+    {
+      Time delay = GetRandomDelay ();
+      m_wheelTimers[i].Schedule (delay, MakeCallback (&TcpTimerWheelExpirationTestCase::Expire, this).TwoBind (true, i));
+      m_timers[i].Schedule (delay, MakeCallback (&TcpTimerWheelExpirationTestCase::Expire, this).TwoBind (false, i));
+    }
+  if (Simulator::Now () < Seconds (50))
+    {
+      Simulator::Schedule (MicroSeconds (10 * m_rng->GetInteger (0, 500)),
+                           &TcpTimerWheelExpirationTestCase::Operate, this);
+    }
+}
+
+void
+TcpTimerWheelExpirationTestCase::Expire (bool wheel, uint32_t i)
+{
+  TcpTimer &timer = wheel ? m_wheelTimers[i] : m_timers[i];
+  uint32_t &expired = wheel ? m_wheelExpired[i] : m_expired[i];
+  (wheel ? m_wheelLog : m_log).push_back (std::make_pair (Simulator::Now ().GetTimeStep (), i));
+  NS_TEST_ASSERT_MSG_EQ (timer.IsExpired (), true, "Timer " << i << " still running");
+  if (++expired % 4 != 0)
+    {
+      // a deterministic delay, to re-arm both sets in the same way
+      Time delay = MicroSeconds (10 * ((i * 7919 + expired * 104729) % 300));
+      timer.Schedule (delay, MakeCallback (&TcpTimerWheelExpirationTestCase::Expire, this).TwoBind (wheel, i));
+    }
+}
+
+void
+TcpTimerWheelExpirationTestCase::DoRun (void)
+{
+  m_rng = CreateObject<UniformRandomVariable> ();
+  m_rng->SetStream (1);
+  Ptr<TcpTimerWheel> wheel = CreateObject<TcpTimerWheel> ();
+  wheel->SetAttribute ("Resolution", TimeValue (MicroSeconds (1)));
+  for (uint32_t i = 0; i < N_TIMERS; ++i)
+    {
+      m_wheelTimers[i].SetWheel (wheel);
+      m_wheelExpired[i] = 0;
+      m_expired[i] = 0;
+    }
+
+  Simulator::Schedule (MilliSeconds (1) + NanoSeconds (1), &TcpTimerWheelExpirationTestCase::Operate, this);
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_GT (m_log.size (), 1000, "Too few expirations");
+  NS_TEST_ASSERT_MSG_EQ (m_wheelLog.size (), m_log.size (), "Different number of expirations");
+  for (uint32_t k = 0; k < m_log.size () && k < m_wheelLog.size (); ++k)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_wheelLog[k].first, m_log[k].first, "Different expiration time at " << k);
+      NS_TEST_ASSERT_MSG_EQ (m_wheelLog[k].second, m_log[k].second, "Different timer expired at " << k);
+    }
+  NS_TEST_ASSERT_MSG_EQ (wheel->GetNTimers (), 0, "Timers left in the wheel");
+
+  for (uint32_t i = 0; i < N_TIMERS; ++i)
+    {
+      m_wheelTimers[i].SetWheel (0);
+    }
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check that re-arming the timers of a TcpTimerWheel does not fill
+ * the event queue
+ *
+ * Many timers are re-armed every millisecond with a 200 ms delay, like
+ * the retransmission timers of TCP connections receiving ACKs: with the
+ * wheel, the event queue holds a single event, instead of the cancelled
+ * events of every re-arm.
+ */
+class TcpTimerWheelEventQueueTestCase : public TestCase
+{
+public:
+  /**
+   * \brief Constructor
+   * \param useWheel true to keep the timers in a wheel
+   */
+  TcpTimerWheelEventQueueTestCase (bool useWheel);
+
+private:
+  virtual void DoRun (void);
+
+  static const uint32_t N_TIMERS = 100; //!< Number of timers
+
+  /**
+   * \brief Re-arm all the timers and sample the size of the event queue
+   */
+  void Rearm (void);
+
+  /**
+   * \brief Called if a timer expires
+   */
+  void Expire (void);
+
+  bool m_useWheel;              //!< True if the timers are kept in a wheel
+  TcpTimer m_timers[N_TIMERS];  //!< The timers
+  uint64_t m_maxPending;        //!< Maximum number of events in the event queue
+  uint32_t m_nExpired;          //!< Number of expirations
+};
+
+TcpTimerWheelEventQueueTestCase::TcpTimerWheelEventQueueTestCase (bool useWheel)
+  : TestCase (std::string ("Check the size of the event queue ") + (useWheel ? "with" : "without") + " a TcpTimerWheel"),
+    m_useWheel (useWheel),
+    m_maxPending (0),
+    m_nExpired (0)
+{
+}
+
+void
+TcpTimerWheelEventQueueTestCase::Rearm (void)
+{
+  m_maxPending = std::max (m_maxPending, Simulator::GetPendingEventCount ());
+  for (uint32_t i = 0; i < N_TIMERS; ++i)
+    {
+      m_timers[i].Schedule (MilliSeconds (200), MakeCallback (&TcpTimerWheelEventQueueTestCase::Expire, this));
+    }
+  if (Simulator::Now () < Seconds (1))
+    {
+      Simulator::Schedule (MilliSeconds (1), &TcpTimerWheelEventQueueTestCase::Rearm, this);
+    }
+}
+
+void
+TcpTimerWheelEventQueueTestCase::Expire (void)
+{
+  m_nExpired++;
+}
+
+void
+TcpTimerWheelEventQueueTestCase::DoRun (void)
+{
+  Ptr<TcpTimerWheel> wheel;
+  if (m_useWheel)
+    {
+      wheel = CreateObject<TcpTimerWheel> ();
+      for (uint32_t i = 0; i < N_TIMERS; ++i)
+        {
+          m_timers[i].SetWheel (wheel);
+        }
+    }
+  Simulator::Schedule (MilliSeconds (1), &TcpTimerWheelEventQueueTestCase::Rearm, this);
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_nExpired, N_TIMERS, "Each timer should expire once");
+  if (m_useWheel)
+    {
+      // the wheel event, plus the next Rearm
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (m_maxPending, 2, "Cancelled events in the event queue");
+      // the wheel event runs once per 200 ms, when the earliest timer
+      // would have expired before being re-armed
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (wheel->GetNEvents (), 8, "Too many events scheduled by the wheel");
+    }
+  else
+    {
+      NS_TEST_ASSERT_MSG_GT (m_maxPending, 150 * N_TIMERS, "Expected the cancelled events in the event queue");
+    }
+
+  for (uint32_t i = 0; i < N_TIMERS; ++i)
+    {
+      m_timers[i].SetWheel (0);
+    }
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TcpTimerWheel TestSuite
+ */
+class TcpTimerWheelTestSuite : public TestSuite
+{
+public:
+  TcpTimerWheelTestSuite ()
+    : TestSuite ("tcp-timer-wheel", UNIT)
+  {
+    AddTestCase (new TcpTimerWheelExpirationTestCase, TestCase::QUICK);
+    AddTestCase (new TcpTimerWheelEventQueueTestCase (true), TestCase::QUICK);
+    AddTestCase (new TcpTimerWheelEventQueueTestCase (false), TestCase::QUICK);
+  }
+};
+
+static TcpTimerWheelTestSuite g_tcpTimerWheelTestSuite; //!< Static variable for test initialization
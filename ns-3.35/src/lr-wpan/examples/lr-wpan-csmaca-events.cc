@@ -0,0 +1,191 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ *            End devices
+ *     N1  N2  ...  Nn
+ *       \  |      /
+ *        \ |     /
+ *          N0  Coordinator
+ *
+ * This example measures the number of simulator events spent per data frame
+ * delivered to a coordinator by a star of end devices.  Every end device
+ * sends acknowledged frames to the coordinator at random times, either in a
+ * nonbeacon-enabled PAN (unslotted CSMA-CA) or in a beacon-enabled PAN
+ * (slotted CSMA-CA).  The same scenario is simulated twice:
+ *
+ * - with the default CSMA-CA and superframe handling, where each step of the
+ *   CSMA-CA (backoff boundary, random backoff, CCA request) and each portion
+ *   of a superframe is a separate event;
+ * - with the LrWpanCsmaCa::AnalyticBackoff and
+ *   LrWpanMac::CoalesceSuperframeTimers attributes enabled.
+ *
+ * ./waf --run "lr-wpan-csmaca-events --nDevices=100 --beacon=1"
+ *
+ */
+
+#include <ns3/core-module.h>
+#include <ns3/lr-wpan-module.h>
+#include <ns3/mobility-module.h>
+#include <ns3/single-model-spectrum-channel.h>
+#include <ns3/packet.h>
+#include <iomanip>
+#include <iostream>
+#include <cmath>
+
+using namespace ns3;
+
+/// Number of data frames received by the coordinator in the current run
+static uint32_t g_rxFrames = 0;
+
+/**
+ * Count a data frame received by the coordinator
+ * \param params the MCPS-DATA.indication parameters
+ * \param p the received packet
+ */
+static void
+DataIndication (McpsDataIndicationParams params, Ptr<Packet> p)
+{
+  g_rxFrames++;
+}
+
+/**
+ * Simulate the star and count the events
+ * \param nDevices the number of end devices
+ * \param nPackets the number of frames sent by each end device
+ * \param duration the interval over which the frames are sent
+ * \param beacon true for a beacon-enabled PAN
+ * \param bcnOrd the beacon order of the coordinator
+ * \param sfrmOrd the superframe order of the coordinator
+ * \param eventEfficient true to enable the analytic backoff and the coalesced superframe timers
+ * \return the number of events processed by the simulator
+ */
+static uint64_t
+RunStar (uint32_t nDevices, uint32_t nPackets, Time duration, bool beacon,
+         uint8_t bcnOrd, uint8_t sfrmOrd, bool eventEfficient)
+{
+  g_rxFrames = 0;
+  Config::SetDefault ("ns3::LrWpanCsmaCa::AnalyticBackoff", BooleanValue (eventEfficient));
+  Config::SetDefault ("ns3::LrWpanMac::CoalesceSuperframeTimers", BooleanValue (eventEfficient));
+
+  NodeContainer nodes;
+  nodes.Create (nDevices + 1);
+  Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator> ();
+  positions->Add (Vector (0, 0, 0));
+  for (uint32_t i = 0; i < nDevices; i++)
+    {
+      double angle = 2 * M_PI * i / nDevices;
+      positions->Add (Vector (10 * std::cos (angle), 10 * std::sin (angle), 0));
+    }
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator (positions);
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+
+  LrWpanHelper lrWpanHelper;
+  NetDeviceContainer devices = lrWpanHelper.Install (nodes);
+  lrWpanHelper.AssociateToPan (devices, 5);
+  lrWpanHelper.AssignStreams (devices, 1);
+
+  Ptr<LrWpanNetDevice> coordinator = DynamicCast<LrWpanNetDevice> (devices.Get (0));
+  coordinator->GetMac ()->SetMcpsDataIndicationCallback (MakeCallback (&DataIndication));
+  Mac16Address coordinatorAddress = coordinator->GetMac ()->GetShortAddress ();
+
+  if (beacon)
+    {
+      MlmeStartRequestParams params;
+      params.m_panCoor = true;
+      params.m_PanId = 5;
+      params.m_bcnOrd = bcnOrd;
+      params.m_sfrmOrd = sfrmOrd;
+      Simulator::ScheduleWithContext (0, Seconds (0.5), &LrWpanMac::MlmeStartRequest,
+                                      coordinator->GetMac (), params);
+    }
+
+  Ptr<UniformRandomVariable> txTime = CreateObject<UniformRandomVariable> ();
+  txTime->SetStream (0);
+  for (uint32_t i = 1; i < devices.GetN (); i++)
+    {
+      Ptr<LrWpanMac> mac = DynamicCast<LrWpanNetDevice> (devices.Get (i))->GetMac ();
+      mac->SetAssociatedCoor (coordinatorAddress);
+
+      McpsDataRequestParams params;
+      params.m_dstPanId = 5;
+      params.m_srcAddrMode = SHORT_ADDR;
+      params.m_dstAddrMode = SHORT_ADDR;
+      params.m_dstAddr = coordinatorAddress;
+      params.m_txOptions = TX_OPTION_ACK;
+      for (uint32_t p = 0; p < nPackets; p++)
+        {
+          params.m_msduHandle = p;
+          Simulator::ScheduleWithContext (i, Seconds (1 + txTime->GetValue (0, duration.GetSeconds ())),
+                                          &LrWpanMac::McpsDataRequest, mac, params,
+                                          Create<Packet> (20));
+        }
+    }
+
+  Simulator::Stop (duration + Seconds (20));
+  Simulator::Run ();
+  uint64_t events = Simulator::GetEventCount ();
+  Simulator::Destroy ();
+  return events;
+}
+
+/**
+ * Print the events per delivered frame of a run
+ * \param name the name of the run
+ * \param events the number of events of the run
+ */
+static void
+PrintEvents (std::string name, uint64_t events)
+{
+  std::cout << std::setw (16) << name << std::setw (12) << events
+            << std::setw (12) << g_rxFrames
+            << std::setw (16) << std::fixed << std::setprecision (1)
+            << (double) events / std::max<uint32_t> (g_rxFrames, 1) << std::endl;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t nDevices = 50;
+  uint32_t nPackets = 10;
+  double duration = 60;
+  bool beacon = false;
+  uint32_t bcnOrd = 6;
+  uint32_t sfrmOrd = 6;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("nDevices", "Number of end devices", nDevices);
+  cmd.AddValue ("nPackets", "Number of frames sent by each end device", nPackets);
+  cmd.AddValue ("duration", "Interval over which the frames are sent, in s", duration);
+  cmd.AddValue ("beacon", "Use a beacon-enabled PAN (slotted CSMA-CA)", beacon);
+  cmd.AddValue ("bcnOrd", "Beacon order of the coordinator", bcnOrd);
+  cmd.AddValue ("sfrmOrd", "Superframe order of the coordinator", sfrmOrd);
+  cmd.Parse (argc, argv);
+
+  std::cout << "end devices: " << nDevices << ", frames per device: " << nPackets
+            << ", " << (beacon ? "beacon-enabled" : "nonbeacon-enabled") << " PAN" << std::endl;
+  std::cout << std::setw (16) << "configuration" << std::setw (12) << "events"
+            << std::setw (12) << "rx frames" << std::setw (16) << "events/frame" << std::endl;
+
+  uint64_t events = RunStar (nDevices, nPackets, Seconds (duration), beacon, bcnOrd, sfrmOrd, false);
+  PrintEvents ("default", events);
+  events = RunStar (nDevices, nPackets, Seconds (duration), beacon, bcnOrd, sfrmOrd, true);
+  PrintEvents ("event-efficient", events);
+
+  return 0;
+}
@@ -25,6 +25,7 @@
 #include <ns3/random-variable-stream.h>
 #include <ns3/simulator.h>
 #include <ns3/log.h>
+#include <ns3/boolean.h>
 #include <algorithm>
 
 #undef NS_LOG_APPEND_CONTEXT
@@ -44,6 +45,13 @@ LrWpanCsmaCa::GetTypeId (void)
     .SetParent<Object> ()
     .SetGroupName ("LrWpan")
     .AddConstructor<LrWpanCsmaCa> ()
+    .AddAttribute ("AnalyticBackoff",
+                   "If true, the backoff period boundary, the random backoff "
+                   "and the CCA request are computed in a single step, and one "
+                   "event is scheduled per backoff instead of one per step.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LrWpanCsmaCa::m_analyticBackoff),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
@@ -65,6 +73,7 @@ LrWpanCsmaCa::LrWpanCsmaCa ()
   m_ccaRequestRunning = false;
   m_randomBackoffPeriodsLeft = 0;
   m_coorDest = false;
+  m_analyticBackoff = false;
 }
 
 LrWpanCsmaCa::~LrWpanCsmaCa ()
@@ -270,13 +279,27 @@ LrWpanCsmaCa::Start ()
 
       // Locate backoff period boundary. (i.e. a time delay to align with the next backoff period boundary)
       Time backoffBoundary = GetTimeToNextSlot ();
-      m_randomBackoffEvent = Simulator::Schedule (backoffBoundary, &LrWpanCsmaCa::RandomBackoffDelay, this);
+      if (m_analyticBackoff)
+        {
+          ScheduleBackoff (backoffBoundary);
+        }
+      else
+        {
+          m_randomBackoffEvent = Simulator::Schedule (backoffBoundary, &LrWpanCsmaCa::RandomBackoffDelay, this);
+        }
 
     }
   else
     {
       m_BE = m_macMinBE;
-      m_randomBackoffEvent = Simulator::ScheduleNow (&LrWpanCsmaCa::RandomBackoffDelay, this);
+      if (m_analyticBackoff)
+        {
+          RandomBackoffDelay ();
+        }
+      else
+        {
+          m_randomBackoffEvent = Simulator::ScheduleNow (&LrWpanCsmaCa::RandomBackoffDelay, this);
+        }
     }
 }
 
@@ -294,6 +317,14 @@ void
 LrWpanCsmaCa::RandomBackoffDelay ()
 {
   NS_LOG_FUNCTION (this);
+  ScheduleBackoff (Seconds (0));
+}
+
+
+void
+LrWpanCsmaCa::ScheduleBackoff (Time backoffBoundary)
+{
+  NS_LOG_FUNCTION (this << backoffBoundary);
 
   uint64_t upperBound = (uint64_t) pow (2, m_BE) - 1;
   Time randomBackoff;
@@ -315,13 +346,13 @@ LrWpanCsmaCa::RandomBackoffDelay ()
     {
       NS_LOG_DEBUG ("Unslotted CSMA-CA: requesting CCA after backoff of " << m_randomBackoffPeriodsLeft <<
                     " periods (" << randomBackoff.As (Time::S) << ")");
-      m_requestCcaEvent = Simulator::Schedule (randomBackoff, &LrWpanCsmaCa::RequestCCA, this);
+      m_requestCcaEvent = Simulator::Schedule (backoffBoundary + randomBackoff, &LrWpanCsmaCa::RequestCCA, this);
     }
   else
     {
       // We must make sure there is enough time left in the CAP, otherwise we continue in
       // the CAP of the next superframe after the transmission/reception of the beacon (and the IFS)
-      timeLeftInCap = GetTimeLeftInCap ();
+      timeLeftInCap = GetTimeLeftInCap () - backoffBoundary;
 
       NS_LOG_DEBUG ("Slotted CSMA-CA: proceeding after random backoff of " << m_randomBackoffPeriodsLeft <<
                     " periods ("  << (randomBackoff.GetSeconds () * symbolRate) << " symbols or " << randomBackoff.As (Time::S) << ")");
@@ -339,11 +370,11 @@ LrWpanCsmaCa::RandomBackoffDelay ()
           uint64_t usedBackoffs = (double)(timeLeftInCap.GetSeconds () *  symbolRate) / m_aUnitBackoffPeriod;
           m_randomBackoffPeriodsLeft -= usedBackoffs;
           NS_LOG_DEBUG ("No time in CAP to complete backoff delay, deferring to the next CAP");
-          m_endCapEvent = Simulator::Schedule (timeLeftInCap, &LrWpanCsmaCa::DeferCsmaTimeout, this);
+          m_endCapEvent = Simulator::Schedule (backoffBoundary + timeLeftInCap, &LrWpanCsmaCa::DeferCsmaTimeout, this);
         }
       else
         {
-          m_canProceedEvent = Simulator::Schedule (randomBackoff, &LrWpanCsmaCa::CanProceed, this);
+          m_canProceedEvent = Simulator::Schedule (backoffBoundary + randomBackoff, &LrWpanCsmaCa::CanProceed, this);
         }
 
     }
@@ -454,6 +485,10 @@ LrWpanCsmaCa::CanProceed ()
 
       m_endCapEvent = Simulator::Schedule (timeLeftInCap, &LrWpanCsmaCa::DeferCsmaTimeout, this);
     }
+  else if (m_analyticBackoff)
+    {
+      RequestCCA ();
+    }
   else
     {
       m_requestCcaEvent = Simulator::ScheduleNow (&LrWpanCsmaCa::RequestCCA,this);
@@ -504,7 +539,14 @@ LrWpanCsmaCa::PlmeCcaConfirm (LrWpanPhyEnumeration status)
               else
                 {
                   NS_LOG_LOGIC ("Perform CCA again, m_CW = " << m_CW);
-                  m_requestCcaEvent = Simulator::ScheduleNow (&LrWpanCsmaCa::RequestCCA, this); // Perform CCA again
+                  if (m_analyticBackoff)
+                    {
+                      RequestCCA ();
+                    }
+                  else
+                    {
+                      m_requestCcaEvent = Simulator::ScheduleNow (&LrWpanCsmaCa::RequestCCA, this); // Perform CCA again
+                    }
                 }
             }
           else
@@ -539,7 +581,14 @@ LrWpanCsmaCa::PlmeCcaConfirm (LrWpanPhyEnumeration status)
           else
             {
               NS_LOG_DEBUG ("Perform another backoff; m_NB = " << static_cast<uint16_t> (m_NB));
-              m_randomBackoffEvent = Simulator::ScheduleNow (&LrWpanCsmaCa::RandomBackoffDelay, this); //Perform another backoff (step 2)
+              if (m_analyticBackoff)
+                {
+                  RandomBackoffDelay ();
+                }
+              else
+                {
+                  m_randomBackoffEvent = Simulator::ScheduleNow (&LrWpanCsmaCa::RandomBackoffDelay, this); //Perform another backoff (step 2)
+                }
             }
         }
     }
@@ -265,6 +265,14 @@ private:
   LrWpanCsmaCa& operator= (LrWpanCsmaCa const &);
 
   virtual void DoDispose (void);
+  /**
+   * Draw the random backoff of step 2 and schedule its outcome (CCA request,
+   * CAP check or deferral) with a single event, as if the backoff started
+   * at the next backoff period boundary.
+   *
+   * \param backoffBoundary the time to the backoff period boundary where the backoff starts
+   */
+  void ScheduleBackoff (Time backoffBoundary);
   /**
    *  \brief Get the time left in the CAP portion of the Outgoing or Incoming superframe.
    *  \return the time left in the CAP
@@ -354,6 +362,11 @@ private:
    * according to the target.
    */
   bool m_coorDest;
+  /**
+   * Compute the backoff boundary, random backoff and CCA request in a single
+   * step instead of scheduling a separate event for each of them.
+   */
+  bool m_analyticBackoff;
 
 };
 
@@ -35,6 +35,7 @@
 #include <ns3/packet.h>
 #include <ns3/random-variable-stream.h>
 #include <ns3/double.h>
+#include <ns3/boolean.h>
 
 #undef NS_LOG_APPEND_CONTEXT
 #define NS_LOG_APPEND_CONTEXT                                   \
@@ -65,6 +66,13 @@ LrWpanMac::GetTypeId (void)
                    UintegerValue (),
                    MakeUintegerAccessor (&LrWpanMac::m_macPanId),
                    MakeUintegerChecker<uint16_t> ())
+    .AddAttribute ("CoalesceSuperframeTimers",
+                   "If true, empty CFP and inactive portions of a superframe "
+                   "are entered directly at the end of the previous portion "
+                   "instead of through a zero-delay event.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LrWpanMac::m_coalesceSuperframeTimers),
+                   MakeBooleanChecker ())
     .AddTraceSource ("MacTxEnqueue",
                      "Trace source indicating a packet has been "
                      "enqueued in the transaction queue",
@@ -184,6 +192,7 @@ LrWpanMac::LrWpanMac ()
   m_incomingSuperframeOrder = 15;
   m_beaconTrackingOn = false;
   m_numLostBeacons = 0;
+  m_coalesceSuperframeTimers = false;
 
 
   Ptr<UniformRandomVariable> uniformVar = CreateObject<UniformRandomVariable> ();
@@ -789,8 +798,15 @@ LrWpanMac::StartCFP (SuperframeType superframeType)
 
       NS_LOG_DEBUG ("Incoming superframe CFP duration " << cfpDuration << " symbols (" << endCfpTime.As (Time::S) << ")");
 
-      m_incCfpEvent =  Simulator::Schedule (endCfpTime,
-                                            &LrWpanMac::StartInactivePeriod, this, SuperframeType::INCOMING);
+      if (m_coalesceSuperframeTimers && cfpDuration == 0)
+        {
+          StartInactivePeriod (SuperframeType::INCOMING);
+        }
+      else
+        {
+          m_incCfpEvent =  Simulator::Schedule (endCfpTime,
+                                                &LrWpanMac::StartInactivePeriod, this, SuperframeType::INCOMING);
+        }
     }
   else
     {
@@ -805,9 +821,15 @@ LrWpanMac::StartCFP (SuperframeType superframeType)
 
       NS_LOG_DEBUG ("Outgoing superframe CFP duration " << cfpDuration << " symbols (" << endCfpTime.As (Time::S) << ")");
 
-      m_cfpEvent =  Simulator::Schedule (endCfpTime,
-                                         &LrWpanMac::StartInactivePeriod, this, SuperframeType::OUTGOING);
-
+      if (m_coalesceSuperframeTimers && cfpDuration == 0)
+        {
+          StartInactivePeriod (SuperframeType::OUTGOING);
+        }
+      else
+        {
+          m_cfpEvent =  Simulator::Schedule (endCfpTime,
+                                             &LrWpanMac::StartInactivePeriod, this, SuperframeType::OUTGOING);
+        }
     }
   //TODO: Start transmit or receive  GTS here.
 }
@@ -833,7 +855,14 @@ LrWpanMac::StartInactivePeriod (SuperframeType superframeType)
         }
 
       NS_LOG_DEBUG ("Incoming superframe Inactive Portion duration " << inactiveDuration << " symbols (" << endInactiveTime.As (Time::S) << ")");
-      m_beaconEvent = Simulator::Schedule (endInactiveTime, &LrWpanMac::AwaitBeacon, this);
+      if (m_coalesceSuperframeTimers && inactiveDuration == 0)
+        {
+          AwaitBeacon ();
+        }
+      else
+        {
+          m_beaconEvent = Simulator::Schedule (endInactiveTime, &LrWpanMac::AwaitBeacon, this);
+        }
     }
   else
     {
@@ -896,6 +896,11 @@ public:
    * The number of consecutive loss beacons in a beacon tracking operation.
    */
   uint8_t  m_numLostBeacons;
+  /**
+   * Indication of whether empty superframe portions are entered without
+   * scheduling a separate event for them.
+   */
+  bool m_coalesceSuperframeTimers;
   /**
    * Get the macAckWaitDuration attribute value.
    *
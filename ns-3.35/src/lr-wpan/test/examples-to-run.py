@@ -13,6 +13,8 @@ cpp_examples = [
     ("lr-wpan-error-model-plot", "True", "True"),
 	("lr-wpan-packet-print", "True", "True"),
 	("lr-wpan-phy-test", "True", "True"),
+    ("lr-wpan-csmaca-events --nDevices=10 --nPackets=2 --duration=5", "True", "True"),
+    ("lr-wpan-csmaca-events --nDevices=10 --nPackets=2 --duration=5 --beacon=1", "True", "True"),
 ]
 
 # A list of Python examples to run in order to ensure that they remain
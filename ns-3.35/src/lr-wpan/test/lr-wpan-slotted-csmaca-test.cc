@@ -45,7 +45,12 @@ NS_LOG_COMPONENT_DEFINE ("lr-wpan-slotted-csma-test");
 class LrWpanSlottedCsmacaTestCase : public TestCase
 {
 public:
-  LrWpanSlottedCsmacaTestCase ();
+  /**
+   * Constructor
+   * \param analyticBackoff true to enable the analytic backoff of the CSMA-CA
+   *        and the coalesced superframe timers of the MAC
+   */
+  LrWpanSlottedCsmacaTestCase (bool analyticBackoff);
   virtual ~LrWpanSlottedCsmacaTestCase ();
 
 
@@ -109,13 +114,16 @@ private:
   Time m_apBoundary;    //!< Indicates the time after the calculation of the transaction cost (A boundary of an Active Period in the CAP)
   Time m_sentTime;      //!< Indicates the time after a successful transmission.
   uint32_t m_transCost; //!< The current transaction cost in symbols.
+  bool m_analyticBackoff; //!< Whether the analytic backoff and coalesced superframe timers are used.
 };
 
 
-LrWpanSlottedCsmacaTestCase::LrWpanSlottedCsmacaTestCase ()
-  : TestCase ("Lrwpan: Slotted CSMA-CA test")
+LrWpanSlottedCsmacaTestCase::LrWpanSlottedCsmacaTestCase (bool analyticBackoff)
+  : TestCase (analyticBackoff ? "Lrwpan: Slotted CSMA-CA test with analytic backoff"
+                              : "Lrwpan: Slotted CSMA-CA test")
 {
   m_transCost = 0;
+  m_analyticBackoff = analyticBackoff;
 }
 
 LrWpanSlottedCsmacaTestCase::~LrWpanSlottedCsmacaTestCase ()
@@ -208,6 +216,10 @@ LrWpanSlottedCsmacaTestCase::DoRun ()
   dev1->GetPhy ()->SetMobility (sender1Mobility);
 
 
+  dev1->GetCsmaCa ()->SetAttribute ("AnalyticBackoff", BooleanValue (m_analyticBackoff));
+  dev0->GetMac ()->SetAttribute ("CoalesceSuperframeTimers", BooleanValue (m_analyticBackoff));
+  dev1->GetMac ()->SetAttribute ("CoalesceSuperframeTimers", BooleanValue (m_analyticBackoff));
+
   // MAC layer and CSMA-CA callback hooks
 
   MlmeStartConfirmCallback cb0;
@@ -347,7 +359,8 @@ public:
 LrWpanSlottedCsmacaTestSuite::LrWpanSlottedCsmacaTestSuite ()
   : TestSuite ("lr-wpan-slotted-csmaca", UNIT)
 {
-  AddTestCase (new LrWpanSlottedCsmacaTestCase, TestCase::QUICK);
+  AddTestCase (new LrWpanSlottedCsmacaTestCase (false), TestCase::QUICK);
+  AddTestCase (new LrWpanSlottedCsmacaTestCase (true), TestCase::QUICK);
 }
 
 static LrWpanSlottedCsmacaTestSuite lrWpanSlottedCsmacaTestSuite; //!< Static variable for test initialization
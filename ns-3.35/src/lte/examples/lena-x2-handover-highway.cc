@@ -0,0 +1,194 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * This program measures the run time of a highway scenario with frequent
+ * X2 handovers: the eNBs are placed along a highway, on alternate sides,
+ * each one having an X2 interface with its neighbours, and the UEs drive
+ * in both directions while receiving a low rate DL UDP flow, so that the
+ * packets are forwarded over X2-U during the handovers. It reports the
+ * wall clock time of the simulation and the number of handovers, e.g.:
+ *
+ * ./waf --run "lena-x2-handover-highway --numEnbs=200 --numUes=5000 --simTime=5"
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/lte-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/point-to-point-module.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LenaX2HandoverHighway");
+
+/**
+ * Count a successful handover
+ * \param handovers the number of handovers
+ * \param imsi the IMSI
+ * \param cellId the target cell ID
+ * \param rnti the RNTI in the target cell
+ */
+void
+NotifyHandoverEndOk (uint32_t *handovers, uint64_t imsi, uint16_t cellId, uint16_t rnti)
+{
+  (*handovers)++;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint16_t numEnbs = 20;
+  uint32_t numUes = 500;
+  double simTime = 2.0;
+  double distance = 300.0;
+  double speed = 33.0;
+  double interval = 0.05;
+  std::string algorithm = "a2a4";
+  bool serializeRrc = true;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("numEnbs", "Number of eNBs along the highway", numEnbs);
+  cmd.AddValue ("numUes", "Number of UEs", numUes);
+  cmd.AddValue ("simTime", "Total duration of the simulation (in seconds)", simTime);
+  cmd.AddValue ("distance", "Distance between two eNBs (in meters)", distance);
+  cmd.AddValue ("speed", "Speed of the UEs (in m/s)", speed);
+  cmd.AddValue ("interval", "Interval between two DL packets of a UE (in seconds)", interval);
+  cmd.AddValue ("algorithm", "Handover algorithm [a2a4|a3]", algorithm);
+  cmd.AddValue ("serializeRrc", "Encode the RRC messages in ASN.1", serializeRrc);
+  cmd.Parse (argc, argv);
+
+  Config::SetDefault ("ns3::LteHelper::UseIdealRrc", BooleanValue (false));
+  Config::SetDefault ("ns3::LteUeRrcProtocolReal::SerializeMessages", BooleanValue (serializeRrc));
+  Config::SetDefault ("ns3::LteEnbRrcProtocolReal::SerializeMessages", BooleanValue (serializeRrc));
+  // allow more UEs per cell
+  Config::SetDefault ("ns3::LteEnbRrc::SrsPeriodicity", UintegerValue (320));
+
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  Ptr<PointToPointEpcHelper> epcHelper = CreateObject<PointToPointEpcHelper> ();
+  lteHelper->SetEpcHelper (epcHelper);
+  if (algorithm == "a3")
+    {
+      lteHelper->SetHandoverAlgorithmType ("ns3::A3RsrpHandoverAlgorithm");
+    }
+  else if (algorithm == "a2a4")
+    {
+      lteHelper->SetHandoverAlgorithmType ("ns3::A2A4RsrqHandoverAlgorithm");
+    }
+  else
+    {
+      NS_FATAL_ERROR ("Unknown handover algorithm " << algorithm);
+    }
+
+  // Create a single RemoteHost
+  Ptr<Node> pgw = epcHelper->GetPgwNode ();
+  NodeContainer remoteHostContainer;
+  remoteHostContainer.Create (1);
+  Ptr<Node> remoteHost = remoteHostContainer.Get (0);
+  InternetStackHelper internet;
+  internet.Install (remoteHostContainer);
+  PointToPointHelper p2ph;
+  p2ph.SetDeviceAttribute ("DataRate", DataRateValue (DataRate ("100Gb/s")));
+  p2ph.SetChannelAttribute ("Delay", TimeValue (Seconds (0.010)));
+  NetDeviceContainer internetDevices = p2ph.Install (pgw, remoteHost);
+  Ipv4AddressHelper ipv4h;
+  ipv4h.SetBase ("1.0.0.0", "255.0.0.0");
+  ipv4h.Assign (internetDevices);
+  Ipv4StaticRoutingHelper ipv4RoutingHelper;
+  Ptr<Ipv4StaticRouting> remoteHostStaticRouting = ipv4RoutingHelper.GetStaticRouting (remoteHost->GetObject<Ipv4> ());
+  remoteHostStaticRouting->AddNetworkRouteTo (Ipv4Address ("7.0.0.0"), Ipv4Mask ("255.0.0.0"), 1);
+
+  NodeContainer enbNodes;
+  enbNodes.Create (numEnbs);
+  NodeContainer ueNodes;
+  ueNodes.Create (numUes);
+
+  // the eNBs are on alternate sides of the highway
+  Ptr<ListPositionAllocator> enbPositionAlloc = CreateObject<ListPositionAllocator> ();
+  for (uint16_t i = 0; i < numEnbs; i++)
+    {
+      enbPositionAlloc->Add (Vector (distance * i, (i % 2) ? 30.0 : -30.0, 25.0));
+    }
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator (enbPositionAlloc);
+  mobility.Install (enbNodes);
+
+  // the UEs are spread along the highway, driving east on one lane and
+  // west on the other one
+  mobility.SetMobilityModel ("ns3::ConstantVelocityMobilityModel");
+  mobility.Install (ueNodes);
+  Ptr<UniformRandomVariable> position = CreateObject<UniformRandomVariable> ();
+  position->SetAttribute ("Max", DoubleValue (distance * (numEnbs - 1)));
+  for (uint32_t u = 0; u < numUes; u++)
+    {
+      bool east = (u % 2 == 0);
+      Ptr<Node> ue = ueNodes.Get (u);
+      ue->GetObject<MobilityModel> ()->SetPosition (Vector (position->GetValue (), east ? 5.0 : -5.0, 1.5));
+      ue->GetObject<ConstantVelocityMobilityModel> ()->SetVelocity (Vector (east ? speed : -speed, 0.0, 0.0));
+    }
+
+  NetDeviceContainer enbLteDevs = lteHelper->InstallEnbDevice (enbNodes);
+  NetDeviceContainer ueLteDevs = lteHelper->InstallUeDevice (ueNodes);
+
+  internet.Install (ueNodes);
+  Ipv4InterfaceContainer ueIpIfaces = epcHelper->AssignUeIpv4Address (ueLteDevs);
+
+  // X2 interfaces between neighbouring eNBs only
+  for (uint16_t i = 0; i + 1 < numEnbs; i++)
+    {
+      epcHelper->AddX2Interface (enbNodes.Get (i), enbNodes.Get (i + 1));
+    }
+
+  lteHelper->Attach (ueLteDevs);
+
+  uint16_t dlPort = 10000;
+  for (uint32_t u = 0; u < numUes; u++)
+    {
+      Ptr<Node> ue = ueNodes.Get (u);
+      Ptr<Ipv4StaticRouting> ueStaticRouting = ipv4RoutingHelper.GetStaticRouting (ue->GetObject<Ipv4> ());
+      ueStaticRouting->SetDefaultRoute (epcHelper->GetUeDefaultGatewayAddress (), 1);
+
+      UdpClientHelper dlClientHelper (ueIpIfaces.GetAddress (u), dlPort);
+      dlClientHelper.SetAttribute ("Interval", TimeValue (Seconds (interval)));
+      dlClientHelper.SetAttribute ("MaxPackets", UintegerValue (1000000));
+      dlClientHelper.SetAttribute ("PacketSize", UintegerValue (200));
+      ApplicationContainer clientApps = dlClientHelper.Install (remoteHost);
+      // spread the first packets over 10 ms
+      clientApps.Start (Seconds (0.1 + 0.0001 * (u % 100)));
+      PacketSinkHelper dlPacketSinkHelper ("ns3::UdpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), dlPort));
+      dlPacketSinkHelper.Install (ue);
+    }
+
+  uint32_t handovers = 0;
+  Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/LteUeRrc/HandoverEndOk",
+                                 MakeBoundCallback (&NotifyHandoverEndOk, &handovers));
+
+  Simulator::Stop (Seconds (simTime));
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Run ();
+  int64_t elapsed = clock.End ();
+
+  std::cout << "eNBs: " << numEnbs << ", UEs: " << numUes << ", simulated time: " << simTime << " s" << std::endl;
+  std::cout << "handovers: " << handovers << std::endl;
+  std::cout << "run time (ms): " << elapsed << std::endl;
+
+  Simulator::Destroy ();
+  return 0;
+}
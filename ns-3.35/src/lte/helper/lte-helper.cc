@@ -62,6 +62,7 @@
 #include <iostream>
 #include <ns3/buildings-propagation-loss-model.h>
 #include <ns3/lte-spectrum-value-helper.h>
+#include <ns3/lte-pathloss-matrix.h>
 #include <ns3/epc-x2.h>
 #include <ns3/object-map.h>
 #include <ns3/object-factory.h>
@@ -194,6 +195,14 @@ TypeId LteHelper::GetTypeId (void)
                    UintegerValue (1),
                    MakeUintegerAccessor (&LteHelper::m_noOfCcs),
                    MakeUintegerChecker<uint16_t> (MIN_NO_CC, MAX_NO_CC))
+    .AddAttribute ("UsePathlossMatrix",
+                   "If true, the gains computed by the pathloss model between the eNBs "
+                   "and the UEs are stored in a LtePathlossMatrix, which is filled when "
+                   "the simulation starts and updated when a node changes course. "
+                   "Only used if the pathloss model is a PropagationLossModel.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LteHelper::m_usePathlossMatrix),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
@@ -204,6 +213,8 @@ LteHelper::DoDispose ()
   NS_LOG_FUNCTION (this);
   m_downlinkChannel = 0;
   m_uplinkChannel = 0;
+  m_downlinkPathlossMatrix = 0;
+  m_uplinkPathlossMatrix = 0;
   m_componentCarrierPhyParams.clear();
   Object::DoDispose ();
 }
@@ -242,7 +253,17 @@ LteHelper::ChannelModelInitialization (void)
       NS_LOG_LOGIC (this << " using a PropagationLossModel in DL");
       Ptr<PropagationLossModel> dlPlm = m_downlinkPathlossModel->GetObject<PropagationLossModel> ();
       NS_ASSERT_MSG (dlPlm != 0, " " << m_downlinkPathlossModel << " is neither PropagationLossModel nor SpectrumPropagationLossModel");
-      m_downlinkChannel->AddPropagationLossModel (dlPlm);
+      if (m_usePathlossMatrix)
+        {
+          m_downlinkPathlossMatrix = CreateObject<LtePathlossMatrix> ();
+          m_downlinkPathlossMatrix->SetPropagationLossModel (dlPlm);
+          m_downlinkChannel->AddPropagationLossModel (m_downlinkPathlossMatrix);
+          Simulator::ScheduleNow (&LtePathlossMatrix::Precompute, m_downlinkPathlossMatrix);
+        }
+      else
+        {
+          m_downlinkChannel->AddPropagationLossModel (dlPlm);
+        }
     }
 
   m_uplinkPathlossModel = m_pathlossModelFactory.Create ();
@@ -257,7 +278,17 @@ LteHelper::ChannelModelInitialization (void)
       NS_LOG_LOGIC (this << " using a PropagationLossModel in UL");
       Ptr<PropagationLossModel> ulPlm = m_uplinkPathlossModel->GetObject<PropagationLossModel> ();
       NS_ASSERT_MSG (ulPlm != 0, " " << m_uplinkPathlossModel << " is neither PropagationLossModel nor SpectrumPropagationLossModel");
-      m_uplinkChannel->AddPropagationLossModel (ulPlm);
+      if (m_usePathlossMatrix)
+        {
+          m_uplinkPathlossMatrix = CreateObject<LtePathlossMatrix> ();
+          m_uplinkPathlossMatrix->SetPropagationLossModel (ulPlm);
+          m_uplinkChannel->AddPropagationLossModel (m_uplinkPathlossMatrix);
+          Simulator::ScheduleNow (&LtePathlossMatrix::Precompute, m_uplinkPathlossMatrix);
+        }
+      else
+        {
+          m_uplinkChannel->AddPropagationLossModel (ulPlm);
+        }
     }
   if (!m_fadingModelType.empty ())
     {
@@ -571,6 +602,14 @@ LteHelper::InstallSingleEnbDevice (Ptr<Node> n)
       NS_ASSERT_MSG (mm, "MobilityModel needs to be set on node before calling LteHelper::InstallEnbDevice ()");
       dlPhy->SetMobility (mm);
       ulPhy->SetMobility (mm);
+      if (m_downlinkPathlossMatrix != 0)
+        {
+          m_downlinkPathlossMatrix->AddTransmitter (mm);
+        }
+      if (m_uplinkPathlossMatrix != 0)
+        {
+          m_uplinkPathlossMatrix->AddReceiver (mm);
+        }
 
       Ptr<AntennaModel> antenna = (m_enbAntennaModelFactory.Create ())->GetObject<AntennaModel> ();
       NS_ASSERT_MSG (antenna, "error in creating the AntennaModel object");
@@ -846,6 +885,14 @@ LteHelper::InstallSingleUeDevice (Ptr<Node> n)
       NS_ASSERT_MSG (mm, "MobilityModel needs to be set on node before calling LteHelper::InstallUeDevice ()");
       dlPhy->SetMobility (mm);
       ulPhy->SetMobility (mm);
+      if (m_downlinkPathlossMatrix != 0)
+        {
+          m_downlinkPathlossMatrix->AddReceiver (mm);
+        }
+      if (m_uplinkPathlossMatrix != 0)
+        {
+          m_uplinkPathlossMatrix->AddTransmitter (mm);
+        }
 
       Ptr<AntennaModel> antenna = (m_ueAntennaModelFactory.Create ())->GetObject<AntennaModel> ();
       NS_ASSERT_MSG (antenna, "error in creating the AntennaModel object");
@@ -52,6 +52,7 @@ class SpectrumChannel;
 class EpcHelper;
 class PropagationLossModel;
 class SpectrumPropagationLossModel;
+class LtePathlossMatrix;
 
 /**
  * \ingroup lte
@@ -741,6 +742,10 @@ private:
   Ptr<Object>  m_downlinkPathlossModel;
   /// The path loss model used in the uplink channel.
   Ptr<Object> m_uplinkPathlossModel;
+  /// The matrix of the downlink path losses, if the `UsePathlossMatrix` attribute is true.
+  Ptr<LtePathlossMatrix> m_downlinkPathlossMatrix;
+  /// The matrix of the uplink path losses, if the `UsePathlossMatrix` attribute is true.
+  Ptr<LtePathlossMatrix> m_uplinkPathlossMatrix;
 
   /// Factory of MAC scheduler object.
   ObjectFactory m_schedulerFactory;
@@ -837,6 +842,12 @@ private:
    */
   bool m_useCa;
 
+  /**
+   * The `UsePathlossMatrix` attribute. If true, the gains of the pathloss
+   * model between the eNBs and the UEs are stored in a LtePathlossMatrix.
+   */
+  bool m_usePathlossMatrix;
+
   /**
    * This contains all the information about each component carrier
    */
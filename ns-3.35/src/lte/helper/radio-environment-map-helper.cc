@@ -24,6 +24,7 @@
 #include <ns3/abort.h>
 #include <ns3/log.h>
 #include <ns3/double.h>
+#include <ns3/enum.h>
 #include <ns3/integer.h>
 #include <ns3/uinteger.h>
 #include <ns3/string.h>
@@ -38,6 +39,19 @@
 #include <ns3/node.h>
 #include <ns3/buildings-helper.h>
 #include <ns3/lte-spectrum-value-helper.h>
+#include <ns3/node-list.h>
+#include <ns3/lte-enb-net-device.h>
+#include <ns3/lte-enb-phy.h>
+#include <ns3/lte-spectrum-phy.h>
+#include <ns3/component-carrier-enb.h>
+#include <ns3/antenna-model.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/spectrum-propagation-loss-model.h>
+#include <ns3/spectrum-converter.h>
+#include <ns3/core-config.h>
+#ifdef HAVE_PTHREAD_H
+#include <ns3/system-thread.h>
+#endif
 
 #include <fstream>
 #include <limits>
@@ -49,6 +63,9 @@ NS_LOG_COMPONENT_DEFINE ("RadioEnvironmentMapHelper");
 NS_OBJECT_ENSURE_REGISTERED (RadioEnvironmentMapHelper);
 
 RadioEnvironmentMapHelper::RadioEnvironmentMapHelper ()
+  : m_analytical (false),
+    m_numThreads (1),
+    m_outputFormat (TEXT)
 {
 }
 
@@ -154,6 +171,28 @@ RadioEnvironmentMapHelper::GetTypeId (void)
                    IntegerValue (-1),
                    MakeIntegerAccessor (&RadioEnvironmentMapHelper::m_rbId),
                    MakeIntegerChecker<int32_t> ())
+    .AddAttribute ("Analytical",
+                   "If true, the REM is computed from the transmit power of the eNBs "
+                   "and the propagation loss models of the channel, without simulating "
+                   "any transmission. The eNBs are assumed to transmit over their whole "
+                   "bandwidth, also when UseDataChannel is true.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RadioEnvironmentMapHelper::m_analytical),
+                   MakeBooleanChecker ())
+    .AddAttribute ("NumThreads",
+                   "Number of threads computing an analytical REM. More than one thread "
+                   "requires propagation loss models which can be called concurrently, "
+                   "i.e., without random variables or cached state (e.g., no shadowing "
+                   "or fading, no buildings-aware models).",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&RadioEnvironmentMapHelper::m_numThreads),
+                   MakeUintegerChecker<uint32_t> (1, 1024))
+    .AddAttribute ("OutputFormat",
+                   "The format of the output file",
+                   EnumValue (RadioEnvironmentMapHelper::TEXT),
+                   MakeEnumAccessor (&RadioEnvironmentMapHelper::m_outputFormat),
+                   MakeEnumChecker (RadioEnvironmentMapHelper::TEXT, "Text",
+                                    RadioEnvironmentMapHelper::BINARY, "Binary"))
   ;
   return tid;
 }
@@ -207,13 +246,38 @@ RadioEnvironmentMapHelper::Install ()
       NS_ABORT_MSG_IF (m_channel == 0, "object at " << m_channelPath << " is not of type SpectrumChannel");
     }
 
-  m_outFile.open (m_outputFile.c_str ());
+  if (m_outputFormat == BINARY)
+    {
+      m_outFile.open (m_outputFile.c_str (), std::ios::out | std::ios::binary);
+    }
+  else
+    {
+      m_outFile.open (m_outputFile.c_str ());
+    }
   if (!m_outFile.is_open ())
     {
       NS_FATAL_ERROR ("Can't open file " << (m_outputFile));
       return;
     }
-  
+
+  if (m_outputFormat == BINARY)
+    {
+      // header: magic, resolution and bounds of the map, in host byte order
+      uint32_t res[2] = { m_xRes, m_yRes };
+      double bounds[5] = { m_xMin, m_xMax, m_yMin, m_yMax, m_z };
+      m_outFile.write ("NS3REM01", 8);
+      m_outFile.write (reinterpret_cast<const char *> (res), sizeof (res));
+      m_outFile.write (reinterpret_cast<const char *> (bounds), sizeof (bounds));
+    }
+
+  if (m_analytical)
+    {
+      // neither the transmit PSDs nor the propagation loss models depend on
+      // the transmissions, so there is no need to wait for them
+      Simulator::ScheduleNow (&RadioEnvironmentMapHelper::RunAnalytical, this);
+      return;
+    }
+
   double startDelay = 0.0026;
 
   if (m_useDataChannel)
@@ -341,20 +405,241 @@ RadioEnvironmentMapHelper::PrintAndReset ()
           // at the end of the list can be unused
           break;
         }
-      Vector pos = it->bmm->GetPosition ();
-      NS_LOG_LOGIC ("output: " << pos.x << "\t" 
-                    << pos.y << "\t" 
-                    << pos.z << "\t" 
-                    << it->phy->GetSinr (m_noisePower));
-      m_outFile << pos.x << "\t" 
-                << pos.y << "\t" 
-                << pos.z << "\t" 
-                << it->phy->GetSinr (m_noisePower)
-                << std::endl;
+      WritePoint (it->bmm->GetPosition (), it->phy->GetSinr (m_noisePower));
       it->phy->Reset ();
     }
 }
 
+void
+RadioEnvironmentMapHelper::WritePoint (const Vector &pos, double sinr)
+{
+  NS_LOG_LOGIC ("output: " << pos.x << "\t"
+                << pos.y << "\t"
+                << pos.z << "\t"
+                << sinr);
+  if (m_outputFormat == BINARY)
+    {
+      m_outFile.write (reinterpret_cast<const char *> (&sinr), sizeof (sinr));
+    }
+  else
+    {
+      m_outFile << pos.x << "\t"
+                << pos.y << "\t"
+                << pos.z << "\t"
+                << sinr
+                << std::endl;
+    }
+}
+
+void
+RadioEnvironmentMapHelper::RunAnalytical ()
+{
+  NS_LOG_FUNCTION (this);
+  m_xStep = (m_xMax - m_xMin)/(m_xRes-1);
+  m_yStep = (m_yMax - m_yMin)/(m_yRes-1);
+  Ptr<const SpectrumModel> rxSpectrumModel = LteSpectrumValueHelper::GetSpectrumModel (m_earfcn, m_bandwidth);
+
+  // the transmit PSD of every eNB carrier on the channel, computed once for
+  // the whole bandwidth, as for the control frames
+  std::vector<RemTransmitter> transmitters;
+  for (NodeList::Iterator nit = NodeList::Begin (); nit != NodeList::End (); ++nit)
+    {
+      for (uint32_t i = 0; i < (*nit)->GetNDevices (); ++i)
+        {
+          Ptr<LteEnbNetDevice> enbDev = DynamicCast<LteEnbNetDevice> ((*nit)->GetDevice (i));
+          if (enbDev == 0)
+            {
+              continue;
+            }
+          std::map<uint8_t, Ptr<ComponentCarrierBaseStation> > ccMap = enbDev->GetCcMap ();
+          for (std::map<uint8_t, Ptr<ComponentCarrierBaseStation> >::iterator ccIt = ccMap.begin ();
+               ccIt != ccMap.end ();
+               ++ccIt)
+            {
+              Ptr<ComponentCarrierEnb> cc = DynamicCast<ComponentCarrierEnb> (ccIt->second);
+              Ptr<LteEnbPhy> phy = cc->GetPhy ();
+              Ptr<LteSpectrumPhy> dlPhy = phy->GetDownlinkSpectrumPhy ();
+              if (dlPhy->GetChannel () != m_channel)
+                {
+                  continue;
+                }
+              std::vector<int> rbs;
+              for (int rb = 0; rb < cc->GetDlBandwidth (); ++rb)
+                {
+                  rbs.push_back (rb);
+                }
+              Ptr<SpectrumValue> txPsd = LteSpectrumValueHelper::CreateTxPowerSpectralDensity (cc->GetDlEarfcn (),
+                                                                                              cc->GetDlBandwidth (),
+                                                                                              phy->GetTxPower (),
+                                                                                              rbs);
+              RemTransmitter tx;
+              if (txPsd->GetSpectrumModelUid () == rxSpectrumModel->GetUid ())
+                {
+                  tx.psd = txPsd;
+                }
+              else if (!txPsd->GetSpectrumModel ()->IsOrthogonal (*rxSpectrumModel))
+                {
+                  SpectrumConverter converter (txPsd->GetSpectrumModel (), rxSpectrumModel);
+                  tx.psd = converter.Convert (txPsd);
+                }
+              else
+                {
+                  continue;
+                }
+              tx.mobility = dlPhy->GetMobility ();
+              tx.antenna = dlPhy->GetRxAntenna ();
+              tx.power = (m_rbId >= 0) ? (*tx.psd)[m_rbId] * 180000 : Integral (*tx.psd);
+              NS_LOG_LOGIC ("cell " << cc->GetCellId () << " transmits " << tx.power << " W");
+              transmitters.push_back (tx);
+            }
+        }
+    }
+
+  uint32_t nThreads = m_numThreads;
+  if (nThreads > 1 && m_channel->GetSpectrumPropagationLossModel () != 0)
+    {
+      NS_LOG_WARN ("a spectrum propagation loss model is used, the REM is computed by a single thread");
+      nThreads = 1;
+    }
+  DoubleValue maxLossDb;
+  m_channel->GetAttribute ("MaxLossDb", maxLossDb);
+
+  uint32_t nPoints = static_cast<uint32_t> (m_xRes) * m_yRes;
+  uint32_t blockSize = std::min (m_maxPointsPerIteration, nPoints);
+  std::vector<Ptr<MobilityModel> > points (blockSize);
+  for (uint32_t i = 0; i < blockSize; ++i)
+    {
+      points[i] = CreateObject<ConstantPositionMobilityModel> ();
+      Ptr<MobilityBuildingInfo> buildingInfo = CreateObject<MobilityBuildingInfo> ();
+      points[i]->AggregateObject (buildingInfo); // operation usually done by BuildingsHelper::Install
+    }
+  std::vector<double> sinr (blockSize);
+
+  // the reference counts of the objects are not thread-safe: when several
+  // threads are used, each of them gets its own copy of the transmitter
+  // mobility models, and each point is only used by one thread
+  std::vector<RemJob> jobs (nThreads);
+  for (uint32_t t = 0; t < nThreads; ++t)
+    {
+      RemJob &job = jobs[t];
+      job.transmitters = &transmitters;
+      for (std::size_t j = 0; j < transmitters.size (); ++j)
+        {
+          Ptr<MobilityModel> mobility = transmitters[j].mobility;
+          if (nThreads > 1 && mobility != 0)
+            {
+              mobility = CreateObject<ConstantPositionMobilityModel> ();
+              mobility->SetPosition (transmitters[j].mobility->GetPosition ());
+            }
+          job.txMobility.push_back (mobility);
+        }
+      job.points = &points;
+      job.sinr = &sinr;
+      job.first = t;
+      job.step = nThreads;
+      job.propagationLoss = m_channel->GetPropagationLossModel ();
+      job.spectrumPropagationLoss = m_channel->GetSpectrumPropagationLossModel ();
+      job.maxLossDb = maxLossDb.Get ();
+      job.noisePower = m_noisePower;
+      job.rbId = m_rbId;
+    }
+
+  for (uint32_t start = 0; start < nPoints; start += blockSize)
+    {
+      uint32_t n = std::min (blockSize, nPoints - start);
+      NS_LOG_LOGIC ("computing points " << start << " to " << start + n - 1);
+      for (uint32_t i = 0; i < n; ++i)
+        {
+          uint32_t xIndex = (start + i) / m_yRes;
+          uint32_t yIndex = (start + i) % m_yRes;
+          points[i]->SetPosition (Vector (m_xMin + xIndex * m_xStep, m_yMin + yIndex * m_yStep, m_z));
+          points[i]->GetObject<MobilityBuildingInfo> ()->MakeConsistent (points[i]);
+        }
+      for (uint32_t t = 0; t < nThreads; ++t)
+        {
+          jobs[t].nPoints = n;
+        }
+#ifdef HAVE_PTHREAD_H
+      std::vector<Ptr<SystemThread> > threads;
+      for (uint32_t t = 1; t < nThreads; ++t)
+        {
+          threads.push_back (Create<SystemThread> (MakeBoundCallback (&RadioEnvironmentMapHelper::ComputeSinr, &jobs[t])));
+          threads.back ()->Start ();
+        }
+      ComputeSinr (&jobs[0]);
+      for (std::size_t t = 0; t < threads.size (); ++t)
+        {
+          threads[t]->Join ();
+        }
+#else
+      for (uint32_t t = 0; t < nThreads; ++t)
+        {
+          ComputeSinr (&jobs[t]);
+        }
+#endif
+      for (uint32_t i = 0; i < n; ++i)
+        {
+          WritePoint (points[i]->GetPosition (), sinr[i]);
+        }
+    }
+
+  Finalize ();
+}
+
+void
+RadioEnvironmentMapHelper::ComputeSinr (RemJob *job)
+{
+  const std::vector<RemTransmitter> &transmitters = *job->transmitters;
+  for (uint32_t i = job->first; i < job->nPoints; i += job->step)
+    {
+      const Ptr<MobilityModel> &rxMobility = (*job->points)[i];
+      double referenceSignalPower = 0;
+      double sumPower = 0;
+      for (std::size_t j = 0; j < transmitters.size (); ++j)
+        {
+          const RemTransmitter &tx = transmitters[j];
+          const Ptr<MobilityModel> &txMobility = job->txMobility[j];
+          double power = tx.power;
+          if (txMobility != 0)
+            {
+              // same gains as applied by the spectrum channels
+              double pathLossDb = 0;
+              if (tx.antenna != 0)
+                {
+                  Angles txAngles (rxMobility->GetPosition (), txMobility->GetPosition ());
+                  pathLossDb -= tx.antenna->GetGainDb (txAngles);
+                }
+              if (job->propagationLoss != 0)
+                {
+                  pathLossDb -= job->propagationLoss->CalcRxPower (0, txMobility, rxMobility);
+                }
+              if (pathLossDb > job->maxLossDb)
+                {
+                  continue;
+                }
+              double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
+              if (job->spectrumPropagationLoss != 0)
+                {
+                  Ptr<SpectrumValue> rxPsd = Copy<SpectrumValue> (tx.psd);
+                  *rxPsd *= pathGainLinear;
+                  rxPsd = job->spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxPsd, txMobility, rxMobility);
+                  power = (job->rbId >= 0) ? (*rxPsd)[job->rbId] * 180000 : Integral (*rxPsd);
+                }
+              else
+                {
+                  power *= pathGainLinear;
+                }
+            }
+          sumPower += power;
+          if (power > referenceSignalPower)
+            {
+              referenceSignalPower = power;
+            }
+        }
+      (*job->sinr)[i] = referenceSignalPower / (sumPower - referenceSignalPower + job->noisePower);
+    }
+}
+
 void 
 RadioEnvironmentMapHelper::Finalize ()
 {
@@ -24,7 +24,9 @@
 
 
 #include <ns3/object.h>
+#include <ns3/vector.h>
 #include <fstream>
+#include <vector>
 
 
 namespace ns3 {
@@ -35,6 +37,10 @@ class NetDevice;
 class SpectrumChannel;
 //class BuildingsMobilityModel;
 class MobilityModel;
+class AntennaModel;
+class SpectrumValue;
+class PropagationLossModel;
+class SpectrumPropagationLossModel;
 
 /** 
  * \ingroup lte
@@ -42,6 +48,12 @@ class MobilityModel;
  * Generates a 2D map of the SINR from the strongest transmitter in the
  * downlink of an LTE FDD system. For instructions on usage, please refer to
  * the User Documentation.
+ *
+ * The map is either measured by RemSpectrumPhy listeners attached to the
+ * channel while the simulation runs (the default), or computed analytically
+ * from the transmit power spectral density of each eNB and the propagation
+ * loss models of the channel, without simulating any transmission (see the
+ * `Analytical` attribute).
  */
 class RadioEnvironmentMapHelper : public Object
 {
@@ -58,6 +70,13 @@ public:
    */
   static TypeId GetTypeId (void);
 
+  /// Format of the output file
+  enum OutputFormat
+  {
+    TEXT,   //!< one line per point, with the x, y, z coordinates and the SINR
+    BINARY  //!< a header followed by the SINR of every point, as doubles
+  };
+
   /** 
    * \return the bandwidth (in num of RBs) over which SINR is calculated
    */
@@ -108,6 +127,56 @@ private:
   /// Called when the map generation procedure has been completed.
   void Finalize ();
 
+  /**
+   * Write the SINR of a point to the output file.
+   *
+   * \param pos position of the point
+   * \param sinr SINR at the point, in linear units
+   */
+  void WritePoint (const Vector &pos, double sinr);
+
+  /**
+   * Compute the whole map from the propagation loss models of the channel,
+   * without simulating any transmission.
+   *
+   * The map is computed in blocks of at most MaxPointsPerIteration points;
+   * the points of a block are shared among NumThreads threads.
+   */
+  void RunAnalytical ();
+
+  /// A transmitter of the analytical map, i.e., the DL PHY of an eNB carrier.
+  struct RemTransmitter
+  {
+    Ptr<MobilityModel> mobility;   ///< Mobility model of the transmitter.
+    Ptr<AntennaModel> antenna;     ///< Antenna of the transmitter, if any.
+    Ptr<SpectrumValue> psd;        ///< Transmit PSD, in the spectrum model of the map.
+    double power;                  ///< Transmit power over the measured bandwidth, in W.
+  };
+
+  /// Work assigned to a thread by RunAnalytical().
+  struct RemJob
+  {
+    const std::vector<RemTransmitter> *transmitters;   ///< All the transmitters.
+    std::vector<Ptr<MobilityModel> > txMobility;       ///< Mobility models of the transmitters used by the thread.
+    const std::vector<Ptr<MobilityModel> > *points;    ///< Listening points of the block.
+    std::vector<double> *sinr;                         ///< SINR of the points of the block.
+    uint32_t nPoints;                                  ///< Number of points of the block.
+    uint32_t first;                                    ///< First point computed by the thread.
+    uint32_t step;                                     ///< Distance between two points computed by the thread.
+    Ptr<PropagationLossModel> propagationLoss;         ///< Propagation loss model of the channel.
+    Ptr<SpectrumPropagationLossModel> spectrumPropagationLoss; ///< Spectrum propagation loss model of the channel.
+    double maxLossDb;                                  ///< Loss above which a signal is not received.
+    double noisePower;                                 ///< Noise power, in W.
+    int32_t rbId;                                      ///< Measured RB, or -1 for the whole bandwidth.
+  };
+
+  /**
+   * Compute the SINR of the points assigned to a thread.
+   *
+   * \param job the work assigned to the thread
+   */
+  static void ComputeSinr (RemJob *job);
+
   /// A complete Radio Environment Map is composed of many of this structure.
   struct RemPoint 
   {
@@ -163,6 +232,10 @@ private:
   bool m_useDataChannel;  ///< The `UseDataChannel` attribute.
   int32_t m_rbId;         ///< The `RbId` attribute.
 
+  bool m_analytical;            ///< The `Analytical` attribute.
+  uint32_t m_numThreads;        ///< The `NumThreads` attribute.
+  OutputFormat m_outputFormat;  ///< The `OutputFormat` attribute.
+
 }; // end of `class RadioEnvironmentMapHelper`
 
 
@@ -193,20 +193,10 @@ A2A4RsrqHandoverAlgorithm::EvaluateHandover (uint16_t rnti,
     }
   else
     {
-      // Find the best neighbour cell (eNB)
-      NS_LOG_LOGIC ("Number of neighbour cells = " << it1->second.size ());
-      uint16_t bestNeighbourCellId = 0;
-      uint8_t bestNeighbourRsrq = 0;
-      MeasurementRow_t::iterator it2;
-      for (it2 = it1->second.begin (); it2 != it1->second.end (); ++it2)
-        {
-          if ((it2->second->m_rsrq > bestNeighbourRsrq)
-              && IsValidNeighbour (it2->first))
-            {
-              bestNeighbourCellId = it2->first;
-              bestNeighbourRsrq = it2->second->m_rsrq;
-            }
-        }
+      // The best neighbour cell (eNB) is kept up to date by UpdateNeighbourMeasurements
+      NS_LOG_LOGIC ("Number of neighbour cells = " << it1->second.m_cells.size ());
+      uint16_t bestNeighbourCellId = it1->second.m_bestCellId;
+      uint8_t bestNeighbourRsrq = it1->second.m_bestRsrq;
 
       // Trigger Handover, if needed
       if (bestNeighbourCellId > 0)
@@ -257,9 +247,11 @@ A2A4RsrqHandoverAlgorithm::UpdateNeighbourMeasurements (uint16_t rnti,
   if (it1 == m_neighbourCellMeasures.end ())
     {
       // insert a new UE entry
-      MeasurementRow_t row;
+      UeMeasurements ueMeasurements;
+      ueMeasurements.m_bestCellId = 0;
+      ueMeasurements.m_bestRsrq = 0;
       std::pair<MeasurementTable_t::iterator, bool> ret;
-      ret = m_neighbourCellMeasures.insert (std::pair<uint16_t, MeasurementRow_t> (rnti, row));
+      ret = m_neighbourCellMeasures.insert (std::pair<uint16_t, UeMeasurements> (rnti, ueMeasurements));
       NS_ASSERT (ret.second);
       it1 = ret.first;
     }
@@ -267,9 +259,9 @@ A2A4RsrqHandoverAlgorithm::UpdateNeighbourMeasurements (uint16_t rnti,
   NS_ASSERT (it1 != m_neighbourCellMeasures.end ());
   Ptr<UeMeasure> neighbourCellMeasures;
   std::map<uint16_t, Ptr<UeMeasure> >::iterator it2;
-  it2 = it1->second.find (cellId);
+  it2 = it1->second.m_cells.find (cellId);
 
-  if (it2 != it1->second.end ())
+  if (it2 != it1->second.m_cells.end ())
     {
       neighbourCellMeasures = it2->second;
       neighbourCellMeasures->m_cellId = cellId;
@@ -283,10 +275,51 @@ A2A4RsrqHandoverAlgorithm::UpdateNeighbourMeasurements (uint16_t rnti,
       neighbourCellMeasures->m_cellId = cellId;
       neighbourCellMeasures->m_rsrp = 0;
       neighbourCellMeasures->m_rsrq = rsrq;
-      it1->second[cellId] = neighbourCellMeasures;
+      it1->second.m_cells[cellId] = neighbourCellMeasures;
+    }
+
+  UeMeasurements &ueMeasurements = it1->second;
+  if (ueMeasurements.m_bestCellId != 0 && cellId == ueMeasurements.m_bestCellId)
+    {
+      if (rsrq >= ueMeasurements.m_bestRsrq)
+        {
+          ueMeasurements.m_bestRsrq = rsrq;
+        }
+      else
+        {
+          // another cell may be better now
+          FindBestNeighbour (ueMeasurements);
+        }
+    }
+  else if ((rsrq > ueMeasurements.m_bestRsrq
+            || (rsrq == ueMeasurements.m_bestRsrq && cellId < ueMeasurements.m_bestCellId))
+           && IsValidNeighbour (cellId))
+    {
+      ueMeasurements.m_bestCellId = cellId;
+      ueMeasurements.m_bestRsrq = rsrq;
     }
 
 } // end of UpdateNeighbourMeasurements
 
 
+void
+A2A4RsrqHandoverAlgorithm::FindBestNeighbour (UeMeasurements &ueMeasurements)
+{
+  NS_LOG_FUNCTION (this);
+  ueMeasurements.m_bestCellId = 0;
+  ueMeasurements.m_bestRsrq = 0;
+  for (MeasurementRow_t::iterator it = ueMeasurements.m_cells.begin ();
+       it != ueMeasurements.m_cells.end (); ++it)
+    {
+      if ((it->second->m_rsrq > ueMeasurements.m_bestRsrq)
+          && IsValidNeighbour (it->first))
+        {
+          ueMeasurements.m_bestCellId = it->first;
+          ueMeasurements.m_bestRsrq = it->second->m_rsrq;
+        }
+    }
+
+} // end of FindBestNeighbour
+
+
 } // end of namespace ns3
@@ -125,10 +125,10 @@ private:
   bool IsValidNeighbour (uint16_t cellId);
 
   /**
-   * Called when Event A4 is reported, then update the measurements table.
-   * If the RNTI and/or cell ID is not found in the table, a corresponding
-   * entry will be created. Only the latest measurements are stored in the
-   * table.
+   * Called when Event A4 is reported, then update the measurements table
+   * and the best neighbour cell of the UE. If the RNTI and/or cell ID is
+   * not found in the table, a corresponding entry will be created. Only the
+   * latest measurements are stored in the table.
    *
    * \param rnti The RNTI of the UE who reported the event.
    * \param cellId The cell ID of the measured cell.
@@ -160,15 +160,35 @@ private:
    */
   typedef std::map<uint16_t, Ptr<UeMeasure> > MeasurementRow_t;
 
+  /**
+   * Measurements reported by a UE, with the valid neighbour cell having the
+   * best RSRQ, which is updated with each measurement so that a handover is
+   * evaluated without going through all the cells.
+   */
+  struct UeMeasurements
+  {
+    MeasurementRow_t m_cells;  ///< Measurements of the cells, by cell ID.
+    uint16_t m_bestCellId;     ///< Best neighbour cell, or 0 if none.
+    uint8_t m_bestRsrq;        ///< RSRQ of the best neighbour cell.
+  };
+
   /**
    * Measurements reported by several UEs. The structure is a map indexed by
    * the RNTI of the UE.
    */
-  typedef std::map<uint16_t, MeasurementRow_t> MeasurementTable_t;
+  typedef std::map<uint16_t, UeMeasurements> MeasurementTable_t;
 
   /// Table of measurement reports from all UEs.
   MeasurementTable_t m_neighbourCellMeasures;
 
+  /**
+   * Find the valid neighbour cell with the best RSRQ among all the cells
+   * measured by a UE. With the same RSRQ, the lowest cell ID is preferred.
+   *
+   * \param ueMeasurements The measurements of the UE.
+   */
+  void FindBestNeighbour (UeMeasurements &ueMeasurements);
+
   /**
    * The `ServingCellThreshold` attribute. If the RSRQ of the serving cell is
    * worse than this threshold, neighbour cells are consider for handover.
@@ -175,9 +175,10 @@ EpcX2::RecvFromX2cSocket (Ptr<Socket> socket)
   Ptr<Packet> packet = socket->Recv ();
   NS_LOG_LOGIC ("packetLen = " << packet->GetSize ());
 
-  NS_ASSERT_MSG (m_x2InterfaceCellIds.find (socket) != m_x2InterfaceCellIds.end (),
+  std::map<Ptr<Socket>, Ptr<X2CellInfo> >::const_iterator cellsIt = m_x2InterfaceCellIds.find (socket);
+  NS_ASSERT_MSG (cellsIt != m_x2InterfaceCellIds.end (),
                  "Missing infos of local and remote CellId");
-  Ptr<X2CellInfo> cellsInfo = m_x2InterfaceCellIds [socket];
+  Ptr<X2CellInfo> cellsInfo = cellsIt->second;
 
   EpcX2Header x2Header;
   packet->RemoveHeader (x2Header);
@@ -376,9 +377,10 @@ EpcX2::RecvFromX2uSocket (Ptr<Socket> socket)
   Ptr<Packet> packet = socket->Recv ();
   NS_LOG_LOGIC ("packetLen = " << packet->GetSize ());
 
-  NS_ASSERT_MSG (m_x2InterfaceCellIds.find (socket) != m_x2InterfaceCellIds.end (),
+  std::map<Ptr<Socket>, Ptr<X2CellInfo> >::const_iterator cellsIt = m_x2InterfaceCellIds.find (socket);
+  NS_ASSERT_MSG (cellsIt != m_x2InterfaceCellIds.end (),
                  "Missing infos of local and remote CellId");
-  Ptr<X2CellInfo> cellsInfo = m_x2InterfaceCellIds [socket];
+  Ptr<X2CellInfo> cellsInfo = cellsIt->second;
 
   GtpuHeader gtpu;
   packet->RemoveHeader (gtpu);
@@ -408,9 +410,10 @@ EpcX2::DoSendHandoverRequest (EpcX2SapProvider::HandoverRequestParams params)
   NS_LOG_LOGIC ("targetCellId = " << params.targetCellId);
   NS_LOG_LOGIC ("mmeUeS1apId  = " << params.mmeUeS1apId);
 
-  NS_ASSERT_MSG (m_x2InterfaceSockets.find (params.targetCellId) != m_x2InterfaceSockets.end (),
+  std::map<uint16_t, Ptr<X2IfaceInfo> >::const_iterator ifaceIt = m_x2InterfaceSockets.find (params.targetCellId);
+  NS_ASSERT_MSG (ifaceIt != m_x2InterfaceSockets.end (),
                  "Missing infos for targetCellId = " << params.targetCellId);
-  Ptr<X2IfaceInfo> socketInfo = m_x2InterfaceSockets [params.targetCellId];
+  Ptr<X2IfaceInfo> socketInfo = ifaceIt->second;
   Ptr<Socket> sourceSocket = socketInfo->m_localCtrlPlaneSocket;
   Ipv4Address targetIpAddr = socketInfo->m_remoteIpAddr;
 
@@ -459,11 +462,12 @@ EpcX2::DoSendHandoverRequestAck (EpcX2SapProvider::HandoverRequestAckParams para
   NS_LOG_LOGIC ("sourceCellId = " << params.sourceCellId);
   NS_LOG_LOGIC ("targetCellId = " << params.targetCellId);
 
-  NS_ASSERT_MSG (m_x2InterfaceSockets.find (params.sourceCellId) != m_x2InterfaceSockets.end (),
+  std::map<uint16_t, Ptr<X2IfaceInfo> >::const_iterator ifaceIt = m_x2InterfaceSockets.find (params.sourceCellId);
+  NS_ASSERT_MSG (ifaceIt != m_x2InterfaceSockets.end (),
                  "Socket infos not defined for sourceCellId = " << params.sourceCellId);
 
-  Ptr<Socket> localSocket = m_x2InterfaceSockets [params.sourceCellId]->m_localCtrlPlaneSocket;
-  Ipv4Address remoteIpAddr = m_x2InterfaceSockets [params.sourceCellId]->m_remoteIpAddr;
+  Ptr<Socket> localSocket = ifaceIt->second->m_localCtrlPlaneSocket;
+  Ipv4Address remoteIpAddr = ifaceIt->second->m_remoteIpAddr;
 
   NS_LOG_LOGIC ("localSocket = " << localSocket);
   NS_LOG_LOGIC ("remoteIpAddr = " << remoteIpAddr);
@@ -509,11 +513,12 @@ EpcX2::DoSendHandoverPreparationFailure (EpcX2SapProvider::HandoverPreparationFa
   NS_LOG_LOGIC ("cause = " << params.cause);
   NS_LOG_LOGIC ("criticalityDiagnostics = " << params.criticalityDiagnostics);
 
-  NS_ASSERT_MSG (m_x2InterfaceSockets.find (params.sourceCellId) != m_x2InterfaceSockets.end (),
+  std::map<uint16_t, Ptr<X2IfaceInfo> >::const_iterator ifaceIt = m_x2InterfaceSockets.find (params.sourceCellId);
+  NS_ASSERT_MSG (ifaceIt != m_x2InterfaceSockets.end (),
                  "Socket infos not defined for sourceCellId = " << params.sourceCellId);
 
-  Ptr<Socket> localSocket = m_x2InterfaceSockets [params.sourceCellId]->m_localCtrlPlaneSocket;
-  Ipv4Address remoteIpAddr = m_x2InterfaceSockets [params.sourceCellId]->m_remoteIpAddr;
+  Ptr<Socket> localSocket = ifaceIt->second->m_localCtrlPlaneSocket;
+  Ipv4Address remoteIpAddr = ifaceIt->second->m_remoteIpAddr;
 
   NS_LOG_LOGIC ("localSocket = " << localSocket);
   NS_LOG_LOGIC ("remoteIpAddr = " << remoteIpAddr);
@@ -557,11 +562,12 @@ EpcX2::DoSendSnStatusTransfer (EpcX2SapProvider::SnStatusTransferParams params)
   NS_LOG_LOGIC ("targetCellId = " << params.targetCellId);
   NS_LOG_LOGIC ("erabsList size = " << params.erabsSubjectToStatusTransferList.size ());
 
-  NS_ASSERT_MSG (m_x2InterfaceSockets.find (params.targetCellId) != m_x2InterfaceSockets.end (),
+  std::map<uint16_t, Ptr<X2IfaceInfo> >::const_iterator ifaceIt = m_x2InterfaceSockets.find (params.targetCellId);
+  NS_ASSERT_MSG (ifaceIt != m_x2InterfaceSockets.end (),
                  "Socket infos not defined for targetCellId = " << params.targetCellId);
 
-  Ptr<Socket> localSocket = m_x2InterfaceSockets [params.targetCellId]->m_localCtrlPlaneSocket;
-  Ipv4Address remoteIpAddr = m_x2InterfaceSockets [params.targetCellId]->m_remoteIpAddr;
+  Ptr<Socket> localSocket = ifaceIt->second->m_localCtrlPlaneSocket;
+  Ipv4Address remoteIpAddr = ifaceIt->second->m_remoteIpAddr;
 
   NS_LOG_LOGIC ("localSocket = " << localSocket);
   NS_LOG_LOGIC ("remoteIpAddr = " << remoteIpAddr);
@@ -603,11 +609,12 @@ EpcX2::DoSendUeContextRelease (EpcX2SapProvider::UeContextReleaseParams params)
   NS_LOG_LOGIC ("newEnbUeX2apId = " << params.newEnbUeX2apId);
   NS_LOG_LOGIC ("sourceCellId = " << params.sourceCellId);
 
-  NS_ASSERT_MSG (m_x2InterfaceSockets.find (params.sourceCellId) != m_x2InterfaceSockets.end (),
+  std::map<uint16_t, Ptr<X2IfaceInfo> >::const_iterator ifaceIt = m_x2InterfaceSockets.find (params.sourceCellId);
+  NS_ASSERT_MSG (ifaceIt != m_x2InterfaceSockets.end (),
                  "Socket infos not defined for sourceCellId = " << params.sourceCellId);
 
-  Ptr<Socket> localSocket = m_x2InterfaceSockets [params.sourceCellId]->m_localCtrlPlaneSocket;
-  Ipv4Address remoteIpAddr = m_x2InterfaceSockets [params.sourceCellId]->m_remoteIpAddr;
+  Ptr<Socket> localSocket = ifaceIt->second->m_localCtrlPlaneSocket;
+  Ipv4Address remoteIpAddr = ifaceIt->second->m_remoteIpAddr;
 
   NS_LOG_LOGIC ("localSocket = " << localSocket);
   NS_LOG_LOGIC ("remoteIpAddr = " << remoteIpAddr);
@@ -647,9 +654,10 @@ EpcX2::DoSendLoadInformation (EpcX2SapProvider::LoadInformationParams params)
   NS_LOG_LOGIC ("targetCellId = " << params.targetCellId);
   NS_LOG_LOGIC ("cellInformationList size = " << params.cellInformationList.size ());
 
-  NS_ASSERT_MSG (m_x2InterfaceSockets.find (params.targetCellId) != m_x2InterfaceSockets.end (),
+  std::map<uint16_t, Ptr<X2IfaceInfo> >::const_iterator ifaceIt = m_x2InterfaceSockets.find (params.targetCellId);
+  NS_ASSERT_MSG (ifaceIt != m_x2InterfaceSockets.end (),
                  "Missing infos for targetCellId = " << params.targetCellId);
-  Ptr<X2IfaceInfo> socketInfo = m_x2InterfaceSockets [params.targetCellId];
+  Ptr<X2IfaceInfo> socketInfo = ifaceIt->second;
   Ptr<Socket> sourceSocket = socketInfo->m_localCtrlPlaneSocket;
   Ipv4Address targetIpAddr = socketInfo->m_remoteIpAddr;
 
@@ -693,9 +701,10 @@ EpcX2::DoSendResourceStatusUpdate (EpcX2SapProvider::ResourceStatusUpdateParams
   NS_LOG_LOGIC ("enb2MeasurementId = " << params.enb2MeasurementId);
   NS_LOG_LOGIC ("cellMeasurementResultList size = " << params.cellMeasurementResultList.size ());
 
-  NS_ASSERT_MSG (m_x2InterfaceSockets.find (params.targetCellId) != m_x2InterfaceSockets.end (),
+  std::map<uint16_t, Ptr<X2IfaceInfo> >::const_iterator ifaceIt = m_x2InterfaceSockets.find (params.targetCellId);
+  NS_ASSERT_MSG (ifaceIt != m_x2InterfaceSockets.end (),
                  "Missing infos for targetCellId = " << params.targetCellId);
-  Ptr<X2IfaceInfo> socketInfo = m_x2InterfaceSockets [params.targetCellId];
+  Ptr<X2IfaceInfo> socketInfo = ifaceIt->second;
   Ptr<Socket> sourceSocket = socketInfo->m_localCtrlPlaneSocket;
   Ipv4Address targetIpAddr = socketInfo->m_remoteIpAddr;
 
@@ -740,9 +749,10 @@ EpcX2::DoSendUeData (EpcX2SapProvider::UeDataParams params)
   NS_LOG_LOGIC ("targetCellId = " << params.targetCellId);
   NS_LOG_LOGIC ("gtpTeid = " << params.gtpTeid);
 
-  NS_ASSERT_MSG (m_x2InterfaceSockets.find (params.targetCellId) != m_x2InterfaceSockets.end (),
+  std::map<uint16_t, Ptr<X2IfaceInfo> >::const_iterator ifaceIt = m_x2InterfaceSockets.find (params.targetCellId);
+  NS_ASSERT_MSG (ifaceIt != m_x2InterfaceSockets.end (),
                  "Missing infos for targetCellId = " << params.targetCellId);
-  Ptr<X2IfaceInfo> socketInfo = m_x2InterfaceSockets [params.targetCellId];
+  Ptr<X2IfaceInfo> socketInfo = ifaceIt->second;
   Ptr<Socket> sourceSocket = socketInfo->m_localUserPlaneSocket;
   Ipv4Address targetIpAddr = socketInfo->m_remoteIpAddr;
 
@@ -76,6 +76,13 @@ protected:
    */
   void WriteOctet (uint8_t octet) const;
 
+  /**
+   * Append bits to the serialization result, most significant bit first
+   * \param value the bits to write, in its numBits least significant bits
+   * \param numBits the number of bits to write, at most 64
+   */
+  void WriteBits (uint64_t value, int numBits) const;
+
   // Serialization functions
 
   /**
@@ -261,6 +268,14 @@ protected:
    */
   void SerializeBitstring (std::bitset<32> bitstring) const;
 
+  /**
+   * Read bits from the pending bits and the buffer, most significant bit first
+   * \param numBits the number of bits to read, at most 64
+   * \param bIterator buffer iterator, advanced by the octets read
+   * \returns the bits read, in the numBits least significant bits
+   */
+  uint64_t ReadBits (int numBits, Buffer::Iterator *bIterator);
+
   // Deserialization functions
 
   /**
@@ -777,7 +777,7 @@ UeManager::SendPacket (uint8_t bid, Ptr<Packet> p)
   std::map<uint8_t, Ptr<LteDataRadioBearerInfo> >::iterator it = m_drbMap.find (drbid);
   if (it != m_drbMap.end ())
     {
-      Ptr<LteDataRadioBearerInfo> bearerInfo = GetDataRadioBearerInfo (drbid);
+      Ptr<LteDataRadioBearerInfo> bearerInfo = it->second;
       if (bearerInfo != NULL)
         {
           LtePdcpSapProvider* pdcpSapProvider = bearerInfo->m_pdcp->GetLtePdcpSapProvider ();
@@ -1063,12 +1063,10 @@ UeManager::RecvRrcConnectionReconfigurationCompleted (LteRrcSap::RrcConnectionRe
         while (!m_packetBuffer.empty ())
           {
             NS_LOG_LOGIC ("dequeueing data from buffer");
-            std::pair <uint8_t, Ptr<Packet> > bidPacket = m_packetBuffer.front ();
-            uint8_t bid = bidPacket.first;
-            Ptr<Packet> p = bidPacket.second;
+            const std::pair <uint8_t, Ptr<Packet> > &bidPacket = m_packetBuffer.front ();
 
             NS_LOG_LOGIC ("queueing data on PDCP for transmission over the air");
-            SendPacket (bid, p);
+            SendPacket (bidPacket.first, bidPacket.second);
 
             m_packetBuffer.pop_front ();
           }
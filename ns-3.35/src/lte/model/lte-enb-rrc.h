@@ -50,6 +50,7 @@
 
 #include <map>
 #include <set>
+#include <deque>
 #include <ns3/component-carrier-enb.h>
 #include <vector>
 
@@ -618,9 +619,11 @@ private:
    * Source eNB starts forwarding data to target eNB through the X2 interface
    * when it sends RRC Connection Reconfiguration to the UE.
    * Target eNB buffers data until it receives RRC Connection Reconfiguration
-   * Complete from the UE.
+   * Complete from the UE. The buffer is a double-ended queue, which holds
+   * the packets in contiguous blocks instead of allocating a node for each
+   * of them.
    */
-  std::list<std::pair<uint8_t, Ptr<Packet> > > m_packetBuffer;
+  std::deque<std::pair<uint8_t, Ptr<Packet> > > m_packetBuffer;
 
 }; // end of `class UeManager`
 
@@ -0,0 +1,283 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "lte-pathloss-matrix.h"
+
+#include <ns3/log.h>
+#include <ns3/uinteger.h>
+#include <ns3/mobility-model.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/core-config.h>
+#ifdef HAVE_PTHREAD_H
+#include <ns3/system-thread.h>
+#endif
+
+#include <cmath>
+#include <limits>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LtePathlossMatrix");
+
+NS_OBJECT_ENSURE_REGISTERED (LtePathlossMatrix);
+
+TypeId
+LtePathlossMatrix::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LtePathlossMatrix")
+    .SetParent<PropagationLossModel> ()
+    .SetGroupName ("Lte")
+    .AddConstructor<LtePathlossMatrix> ()
+    .AddAttribute ("NumThreads",
+                   "Number of threads computing the matrix in Precompute (). More than one "
+                   "thread requires a model which can be called concurrently, i.e., "
+                   "without random variables or cached state (e.g., no shadowing, no "
+                   "buildings-aware models).",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&LtePathlossMatrix::m_numThreads),
+                   MakeUintegerChecker<uint32_t> (1, 1024))
+  ;
+  return tid;
+}
+
+LtePathlossMatrix::LtePathlossMatrix ()
+  : m_nComputed (0),
+    m_numThreads (1)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LtePathlossMatrix::~LtePathlossMatrix ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+LtePathlossMatrix::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_model = 0;
+  m_transmitters.clear ();
+  m_receivers.clear ();
+  m_transmitterIndex.clear ();
+  m_receiverIndex.clear ();
+  m_gain.clear ();
+  PropagationLossModel::DoDispose ();
+}
+
+void
+LtePathlossMatrix::SetPropagationLossModel (Ptr<PropagationLossModel> model)
+{
+  NS_LOG_FUNCTION (this << model);
+  m_model = model;
+  for (std::size_t i = 0; i < m_gain.size (); ++i)
+    {
+      m_gain[i].assign (m_gain[i].size (), std::numeric_limits<double>::quiet_NaN ());
+    }
+}
+
+Ptr<PropagationLossModel>
+LtePathlossMatrix::GetPropagationLossModel (void) const
+{
+  return m_model;
+}
+
+void
+LtePathlossMatrix::AddTransmitter (Ptr<MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (this << mobility);
+  if (m_transmitterIndex.find (PeekPointer (mobility)) != m_transmitterIndex.end ())
+    {
+      return;
+    }
+  m_transmitterIndex[PeekPointer (mobility)] = m_transmitters.size ();
+  m_transmitters.push_back (mobility);
+  m_gain.push_back (std::vector<double> (m_receivers.size (), std::numeric_limits<double>::quiet_NaN ()));
+  mobility->TraceConnectWithoutContext ("CourseChange", MakeCallback (&LtePathlossMatrix::TransmitterCourseChange, this));
+}
+
+void
+LtePathlossMatrix::AddReceiver (Ptr<MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (this << mobility);
+  if (m_receiverIndex.find (PeekPointer (mobility)) != m_receiverIndex.end ())
+    {
+      return;
+    }
+  m_receiverIndex[PeekPointer (mobility)] = m_receivers.size ();
+  m_receivers.push_back (mobility);
+  for (std::size_t i = 0; i < m_gain.size (); ++i)
+    {
+      m_gain[i].push_back (std::numeric_limits<double>::quiet_NaN ());
+    }
+  mobility->TraceConnectWithoutContext ("CourseChange", MakeCallback (&LtePathlossMatrix::ReceiverCourseChange, this));
+}
+
+void
+LtePathlossMatrix::TransmitterCourseChange (Ptr<const MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (this << mobility);
+  std::unordered_map<const MobilityModel *, uint32_t>::const_iterator it = m_transmitterIndex.find (PeekPointer (mobility));
+  NS_ASSERT (it != m_transmitterIndex.end ());
+  std::vector<double> &row = m_gain[it->second];
+  row.assign (row.size (), std::numeric_limits<double>::quiet_NaN ());
+}
+
+void
+LtePathlossMatrix::ReceiverCourseChange (Ptr<const MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (this << mobility);
+  std::unordered_map<const MobilityModel *, uint32_t>::const_iterator it = m_receiverIndex.find (PeekPointer (mobility));
+  NS_ASSERT (it != m_receiverIndex.end ());
+  for (std::size_t i = 0; i < m_gain.size (); ++i)
+    {
+      m_gain[i][it->second] = std::numeric_limits<double>::quiet_NaN ();
+    }
+}
+
+bool
+LtePathlossMatrix::IsMoving (Ptr<const MobilityModel> mobility)
+{
+  Vector velocity = mobility->GetVelocity ();
+  return velocity.x != 0 || velocity.y != 0 || velocity.z != 0;
+}
+
+uint64_t
+LtePathlossMatrix::GetNComputed (void) const
+{
+  return m_nComputed;
+}
+
+void
+LtePathlossMatrix::Precompute (void)
+{
+  NS_LOG_FUNCTION (this << m_transmitters.size () << m_receivers.size ());
+  NS_ASSERT_MSG (m_model != 0, "no propagation loss model");
+  uint32_t nThreads = std::max<uint32_t> (1, std::min<uint32_t> (m_numThreads, m_transmitters.size ()));
+
+  std::vector<bool> receiverMoving (m_receivers.size ());
+  for (std::size_t j = 0; j < m_receivers.size (); ++j)
+    {
+      receiverMoving[j] = IsMoving (m_receivers[j]);
+    }
+
+  // the reference counts of the objects are not thread-safe: each row is
+  // computed by a single thread and, when several threads are used, each
+  // of them gets its own copy of the receiver mobility models
+  std::vector<PrecomputeJob> jobs (nThreads);
+  for (uint32_t t = 0; t < nThreads; ++t)
+    {
+      jobs[t].matrix = this;
+      jobs[t].receiverMoving = &receiverMoving;
+      jobs[t].first = t;
+      jobs[t].step = nThreads;
+      jobs[t].computed = 0;
+      if (nThreads == 1)
+        {
+          jobs[t].receivers = m_receivers;
+          continue;
+        }
+      for (std::size_t j = 0; j < m_receivers.size (); ++j)
+        {
+          Ptr<MobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+          mobility->SetPosition (m_receivers[j]->GetPosition ());
+          jobs[t].receivers.push_back (mobility);
+        }
+    }
+
+#ifdef HAVE_PTHREAD_H
+  std::vector<Ptr<SystemThread> > threads;
+  for (uint32_t t = 1; t < nThreads; ++t)
+    {
+      threads.push_back (Create<SystemThread> (MakeBoundCallback (&LtePathlossMatrix::PrecomputeRows, &jobs[t])));
+      threads.back ()->Start ();
+    }
+  PrecomputeRows (&jobs[0]);
+  for (std::size_t t = 0; t < threads.size (); ++t)
+    {
+      threads[t]->Join ();
+    }
+#else
+  for (uint32_t t = 0; t < nThreads; ++t)
+    {
+      PrecomputeRows (&jobs[t]);
+    }
+#endif
+
+  for (uint32_t t = 0; t < nThreads; ++t)
+    {
+      m_nComputed += jobs[t].computed;
+    }
+}
+
+void
+LtePathlossMatrix::PrecomputeRows (PrecomputeJob *job)
+{
+  LtePathlossMatrix *matrix = job->matrix;
+  const std::vector<bool> &receiverMoving = *job->receiverMoving;
+  for (uint32_t i = job->first; i < matrix->m_transmitters.size (); i += job->step)
+    {
+      const Ptr<MobilityModel> &transmitter = matrix->m_transmitters[i];
+      if (IsMoving (transmitter))
+        {
+          continue;
+        }
+      std::vector<double> &row = matrix->m_gain[i];
+      for (std::size_t j = 0; j < job->receivers.size (); ++j)
+        {
+          if (!receiverMoving[j] && std::isnan (row[j]))
+            {
+              row[j] = matrix->m_model->CalcRxPower (0, transmitter, job->receivers[j]);
+              job->computed++;
+            }
+        }
+    }
+}
+
+double
+LtePathlossMatrix::DoCalcRxPower (double txPowerDbm,
+                                  Ptr<MobilityModel> a,
+                                  Ptr<MobilityModel> b) const
+{
+  std::unordered_map<const MobilityModel *, uint32_t>::const_iterator txIt = m_transmitterIndex.find (PeekPointer (a));
+  std::unordered_map<const MobilityModel *, uint32_t>::const_iterator rxIt = m_receiverIndex.find (PeekPointer (b));
+  if (txIt == m_transmitterIndex.end () || rxIt == m_receiverIndex.end ())
+    {
+      m_nComputed++;
+      return m_model->CalcRxPower (txPowerDbm, a, b);
+    }
+  double &gain = m_gain[txIt->second][rxIt->second];
+  if (std::isnan (gain))
+    {
+      m_nComputed++;
+      double g = m_model->CalcRxPower (0, a, b);
+      if (IsMoving (a) || IsMoving (b))
+        {
+          return txPowerDbm + g;
+        }
+      gain = g;
+    }
+  return txPowerDbm + gain;
+}
+
+int64_t
+LtePathlossMatrix::DoAssignStreams (int64_t stream)
+{
+  // the streams of the underlying model are assigned by its owner
+  return 0;
+}
+
+} // namespace ns3
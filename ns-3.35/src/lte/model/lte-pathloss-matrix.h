@@ -0,0 +1,153 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LTE_PATHLOSS_MATRIX_H
+#define LTE_PATHLOSS_MATRIX_H
+
+#include <ns3/propagation-loss-model.h>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3 {
+
+class MobilityModel;
+
+/**
+ * \ingroup lte
+ *
+ * \brief A matrix of the gains between the transmitters and the receivers
+ * of an LTE channel, computed by another PropagationLossModel.
+ *
+ * The gain of each (transmitter, receiver) pair is computed by the
+ * underlying model the first time it is needed, or for all the pairs at
+ * once by Precompute(), and then read from the matrix by index. The
+ * entries of a node are invalidated when its mobility model notifies a
+ * course change, and the pairs involving a node which is moving are never
+ * stored, so that their gain is computed by the underlying model for each
+ * signal. The pairs involving an unregistered node are always computed by
+ * the underlying model.
+ *
+ * The matrix is exact for the models whose loss only depends on the
+ * positions of the nodes (and possibly on per-pair values drawn once, such
+ * as the shadowing of the buildings-aware models), and whose received power
+ * is the transmitted power plus a gain. It is not suited to the models
+ * which draw a new value for each signal (e.g., NakagamiPropagationLossModel).
+ */
+class LtePathlossMatrix : public PropagationLossModel
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  LtePathlossMatrix ();
+  virtual ~LtePathlossMatrix ();
+
+  /**
+   * \param model the model computing the gains stored in the matrix
+   */
+  void SetPropagationLossModel (Ptr<PropagationLossModel> model);
+  /**
+   * \return the model computing the gains stored in the matrix
+   */
+  Ptr<PropagationLossModel> GetPropagationLossModel (void) const;
+
+  /**
+   * Add a transmitter, i.e., a row of the matrix. Adding a transmitter
+   * twice has no effect.
+   *
+   * \param mobility the mobility model of the transmitter
+   */
+  void AddTransmitter (Ptr<MobilityModel> mobility);
+  /**
+   * Add a receiver, i.e., a column of the matrix. Adding a receiver
+   * twice has no effect.
+   *
+   * \param mobility the mobility model of the receiver
+   */
+  void AddReceiver (Ptr<MobilityModel> mobility);
+
+  /**
+   * Compute the gains of all the pairs of static nodes which are not in
+   * the matrix yet, with NumThreads threads.
+   */
+  void Precompute (void);
+
+  /**
+   * \return the number of gains computed by the underlying model so far
+   */
+  uint64_t GetNComputed (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  virtual double DoCalcRxPower (double txPowerDbm,
+                                Ptr<MobilityModel> a,
+                                Ptr<MobilityModel> b) const;
+
+  virtual int64_t DoAssignStreams (int64_t stream);
+
+  /**
+   * Invalidate the gains of a transmitter
+   * \param mobility the mobility model of the transmitter
+   */
+  void TransmitterCourseChange (Ptr<const MobilityModel> mobility);
+  /**
+   * Invalidate the gains of a receiver
+   * \param mobility the mobility model of the receiver
+   */
+  void ReceiverCourseChange (Ptr<const MobilityModel> mobility);
+
+  /**
+   * \param mobility a mobility model
+   * \return true if the node is moving
+   */
+  static bool IsMoving (Ptr<const MobilityModel> mobility);
+
+  /// Work assigned to a thread by Precompute()
+  struct PrecomputeJob
+  {
+    LtePathlossMatrix *matrix;                     //!< the matrix
+    std::vector<Ptr<MobilityModel> > receivers;    //!< the receivers used by the thread
+    const std::vector<bool> *receiverMoving;       //!< true for the receivers which are moving
+    uint32_t first;                                //!< first row computed by the thread
+    uint32_t step;                                 //!< distance between two rows computed by the thread
+    uint64_t computed;                             //!< number of gains computed by the thread
+  };
+
+  /**
+   * Compute the rows of the matrix assigned to a thread
+   * \param job the work assigned to the thread
+   */
+  static void PrecomputeRows (PrecomputeJob *job);
+
+  Ptr<PropagationLossModel> m_model;                         //!< the model computing the gains
+  std::vector<Ptr<MobilityModel> > m_transmitters;           //!< the transmitters, by row
+  std::vector<Ptr<MobilityModel> > m_receivers;              //!< the receivers, by column
+  std::unordered_map<const MobilityModel *, uint32_t> m_transmitterIndex; //!< the rows, by transmitter
+  std::unordered_map<const MobilityModel *, uint32_t> m_receiverIndex;    //!< the columns, by receiver
+  /// the gains in dB, by transmitter and receiver; NaN if not computed
+  mutable std::vector<std::vector<double> > m_gain;
+  mutable uint64_t m_nComputed;                              //!< number of gains computed by m_model
+  uint32_t m_numThreads;                                     //!< the `NumThreads` attribute
+};
+
+} // namespace ns3
+
+#endif /* LTE_PATHLOSS_MATRIX_H */
@@ -0,0 +1,80 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "lte-rrc-message-tag.h"
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (LteRrcMessageTag);
+
+LteRrcMessageTag::LteRrcMessageTag ()
+  : m_id (0)
+{
+}
+
+LteRrcMessageTag::LteRrcMessageTag (uint64_t id)
+  : m_id (id)
+{
+}
+
+TypeId
+LteRrcMessageTag::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LteRrcMessageTag")
+    .SetParent<Tag> ()
+    .SetGroupName ("Lte")
+    .AddConstructor<LteRrcMessageTag> ()
+  ;
+  return tid;
+}
+
+TypeId
+LteRrcMessageTag::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+uint32_t
+LteRrcMessageTag::GetSerializedSize (void) const
+{
+  return 8;
+}
+
+void
+LteRrcMessageTag::Serialize (TagBuffer i) const
+{
+  i.WriteU64 (m_id);
+}
+
+void
+LteRrcMessageTag::Deserialize (TagBuffer i)
+{
+  m_id = i.ReadU64 ();
+}
+
+void
+LteRrcMessageTag::Print (std::ostream &os) const
+{
+  os << "id=" << m_id;
+}
+
+uint64_t
+LteRrcMessageTag::GetId (void) const
+{
+  return m_id;
+}
+
+} // namespace ns3
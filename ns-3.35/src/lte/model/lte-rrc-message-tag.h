@@ -0,0 +1,70 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LTE_RRC_MESSAGE_TAG_H
+#define LTE_RRC_MESSAGE_TAG_H
+
+#include "ns3/tag.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup lte
+ *
+ * Byte tag identifying the RRC message carried by a packet whose payload
+ * is not a serialized RRC PDU, when the LteRrcProtocolReal classes do not
+ * serialize the messages (see their `SerializeMessages` attribute). Being
+ * a byte tag, it follows the payload through the segmentation and the
+ * reassembly of the RLC.
+ */
+class LteRrcMessageTag : public Tag
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+
+  /**
+   * Create an empty RRC message tag
+   */
+  LteRrcMessageTag ();
+  /**
+   * Create an RRC message tag with the given message ID
+   * \param id the message ID
+   */
+  LteRrcMessageTag (uint64_t id);
+
+  virtual void Serialize (TagBuffer i) const;
+  virtual void Deserialize (TagBuffer i);
+  virtual uint32_t GetSerializedSize () const;
+  virtual void Print (std::ostream &os) const;
+
+  /**
+   * Get the message ID
+   * \return the message ID
+   */
+  uint64_t GetId (void) const;
+
+private:
+  uint64_t m_id; ///< message ID
+};
+
+} // namespace ns3
+
+#endif /* LTE_RRC_MESSAGE_TAG_H */
@@ -20,13 +20,17 @@
  */
 
 #include <ns3/fatal-error.h>
+#include <ns3/abort.h>
 #include <ns3/log.h>
 #include <ns3/nstime.h>
 #include <ns3/node-list.h>
 #include <ns3/node.h>
 #include <ns3/simulator.h>
+#include <ns3/boolean.h>
+#include <deque>
 
 #include "lte-rrc-protocol-real.h"
+#include "lte-rrc-message-tag.h"
 #include "lte-ue-rrc.h"
 #include "lte-enb-rrc.h"
 #include "lte-enb-net-device.h"
@@ -39,11 +43,361 @@ NS_LOG_COMPONENT_DEFINE ("LteRrcProtocolReal");
 /// RRC real message delay
 const Time RRC_REAL_MSG_DELAY = MilliSeconds (0); 
 
+/**
+ * Time after which an RRC message sent over X2 without being serialized is
+ * dropped if not received. The handover preparation information is never
+ * decoded by the target eNB, and the X2 messages are delivered within the
+ * X2 link delay. The messages sent over the radio are only dropped when the
+ * simulator is destroyed, as they may be delayed for an unbounded time.
+ */
+const Time RRC_X2_STORED_MSG_LIFETIME = Seconds (10);
+
+/// An RRC message carried by a packet without being serialized
+class StoredRrcMessageBase : public SimpleRefCount<StoredRrcMessageBase>
+{
+public:
+  virtual ~StoredRrcMessageBase ()
+  {
+  }
+};
+
+/// An RRC message of type M carried by a packet without being serialized
+template <class M>
+class StoredRrcMessage : public StoredRrcMessageBase
+{
+public:
+  /**
+   * Constructor
+   * \param m the message
+   */
+  StoredRrcMessage (const M &m)
+    : msg (m)
+  {
+  }
+  M msg; ///< the message
+};
+
+/// The RRC messages in flight, by ID
+static std::map<uint64_t, Ptr<StoredRrcMessageBase> > g_storedRrcMessages;
+/// The expiry time and the ID of the RRC messages sent over X2, by increasing expiry
+static std::deque<std::pair<Time, uint64_t> > g_expiringRrcMessages;
+/// The ID of the next RRC message
+static uint64_t g_nextStoredRrcMessageId = 1;
+/// True if the messages in flight are dropped when the simulator is destroyed
+static bool g_storedRrcMessagesCleanup = false;
+
+/// Drop all the RRC messages in flight
+static void
+ClearStoredRrcMessages (void)
+{
+  g_storedRrcMessages.clear ();
+  g_expiringRrcMessages.clear ();
+  g_storedRrcMessagesCleanup = false;
+}
+
+/**
+ * Compute the size of the ASN.1 encoding of an RRC message
+ * \param msg the message
+ * \return the size in bytes
+ */
+template <class H, class M>
+static uint32_t
+GetEncodedRrcMessageSize (const M &msg)
+{
+  H header;
+  header.SetMessage (msg);
+  return header.GetSerializedSize ();
+}
+
+/**
+ * Get the size of the ASN.1 encoding of a message whose encoding has
+ * always the same size, computing it only once
+ * \param msg the message
+ * \return the size in bytes
+ */
+template <class H, class M>
+static uint32_t
+GetFixedRrcMessageSize (const M &msg)
+{
+  static const uint32_t size = GetEncodedRrcMessageSize<H> (msg);
+  return size;
+}
+
+/**
+ * \param msg an RRC message
+ * \return the size of its ASN.1 encoding
+ */
+static uint32_t
+GetRrcMessageSize (const LteRrcSap::RrcConnectionRequest &msg)
+{
+  return GetFixedRrcMessageSize<RrcConnectionRequestHeader> (msg);
+}
+
+/**
+ * \param msg an RRC message
+ * \return the size of its ASN.1 encoding
+ */
+static uint32_t
+GetRrcMessageSize (const LteRrcSap::RrcConnectionSetupCompleted &msg)
+{
+  return GetFixedRrcMessageSize<RrcConnectionSetupCompleteHeader> (msg);
+}
+
+/**
+ * \param msg an RRC message
+ * \return the size of its ASN.1 encoding
+ */
+static uint32_t
+GetRrcMessageSize (const LteRrcSap::RrcConnectionReconfigurationCompleted &msg)
+{
+  return GetFixedRrcMessageSize<RrcConnectionReconfigurationCompleteHeader> (msg);
+}
+
+/**
+ * \param msg an RRC message
+ * \return the size of its ASN.1 encoding
+ */
+static uint32_t
+GetRrcMessageSize (const LteRrcSap::RrcConnectionReestablishmentRequest &msg)
+{
+  return GetFixedRrcMessageSize<RrcConnectionReestablishmentRequestHeader> (msg);
+}
+
+/**
+ * \param msg an RRC message
+ * \return the size of its ASN.1 encoding
+ */
+static uint32_t
+GetRrcMessageSize (const LteRrcSap::RrcConnectionReestablishmentComplete &msg)
+{
+  return GetFixedRrcMessageSize<RrcConnectionReestablishmentCompleteHeader> (msg);
+}
+
+/**
+ * \param msg an RRC message
+ * \return the size of its ASN.1 encoding
+ */
+static uint32_t
+GetRrcMessageSize (const LteRrcSap::RrcConnectionReestablishmentReject &msg)
+{
+  return GetFixedRrcMessageSize<RrcConnectionReestablishmentRejectHeader> (msg);
+}
+
+/**
+ * \param msg an RRC message
+ * \return the size of its ASN.1 encoding
+ */
+static uint32_t
+GetRrcMessageSize (const LteRrcSap::RrcConnectionRelease &msg)
+{
+  return GetFixedRrcMessageSize<RrcConnectionReleaseHeader> (msg);
+}
+
+/**
+ * \param msg an RRC message
+ * \return the size of its ASN.1 encoding
+ */
+static uint32_t
+GetRrcMessageSize (const LteRrcSap::RrcConnectionReject &msg)
+{
+  return GetFixedRrcMessageSize<RrcConnectionRejectHeader> (msg);
+}
+
+/**
+ * The size of the encoding of the following messages depends on the
+ * values of their fields (radio resource configuration, measurement
+ * configuration, etc.) and not only on which ones are present, so these
+ * messages are still encoded, and the encoding is discarded.
+ *
+ * \param msg an RRC message
+ * \return the size of its ASN.1 encoding
+ */
+static uint32_t
+GetRrcMessageSize (const LteRrcSap::RrcConnectionSetup &msg)
+{
+  return GetEncodedRrcMessageSize<RrcConnectionSetupHeader> (msg);
+}
+
+/**
+ * \param msg an RRC message
+ * \return the size of its ASN.1 encoding
+ */
+static uint32_t
+GetRrcMessageSize (const LteRrcSap::RrcConnectionReconfiguration &msg)
+{
+  return GetEncodedRrcMessageSize<RrcConnectionReconfigurationHeader> (msg);
+}
+
+/**
+ * \param msg an RRC message
+ * \return the size of its ASN.1 encoding
+ */
+static uint32_t
+GetRrcMessageSize (const LteRrcSap::RrcConnectionReestablishment &msg)
+{
+  return GetEncodedRrcMessageSize<RrcConnectionReestablishmentHeader> (msg);
+}
+
+/**
+ * \param msg an RRC message
+ * \return the size of its ASN.1 encoding
+ */
+static uint32_t
+GetRrcMessageSize (const LteRrcSap::HandoverPreparationInfo &msg)
+{
+  return GetEncodedRrcMessageSize<HandoverPreparationInfoHeader> (msg);
+}
+
+/**
+ * The size of the encoding of a measurement report only depends on which
+ * optional fields are present and on the number of entries of its lists,
+ * so it is computed once for each combination.
+ *
+ * \param msg an RRC message
+ * \return the size of its ASN.1 encoding
+ */
+static uint32_t
+GetRrcMessageSize (const LteRrcSap::MeasurementReport &msg)
+{
+  static std::map<std::vector<uint8_t>, uint32_t> sizes;
+
+  const LteRrcSap::MeasResults &measResults = msg.measResults;
+  std::vector<uint8_t> key;
+  bool haveNeighCells = measResults.haveMeasResultNeighCells && !measResults.measResultListEutra.empty ();
+  key.push_back (haveNeighCells);
+  if (haveNeighCells)
+    {
+      for (std::list<LteRrcSap::MeasResultEutra>::const_iterator it = measResults.measResultListEutra.begin ();
+           it != measResults.measResultListEutra.end (); ++it)
+        {
+          if (it->haveCgiInfo)
+            {
+              // the size depends on the values of the PLMN identities
+              return GetEncodedRrcMessageSize<MeasurementReportHeader> (msg);
+            }
+          key.push_back ((it->haveRsrpResult << 1) | it->haveRsrqResult);
+        }
+    }
+  key.push_back (measResults.haveScellsMeas);
+  if (measResults.haveScellsMeas)
+    {
+      for (std::list<LteRrcSap::MeasResultScell>::const_iterator it = measResults.measScellResultList.measResultScell.begin ();
+           it != measResults.measScellResultList.measResultScell.end (); ++it)
+        {
+          key.push_back ((it->haveRsrpResult << 1) | it->haveRsrqResult);
+        }
+    }
+
+  std::map<std::vector<uint8_t>, uint32_t>::const_iterator it = sizes.find (key);
+  if (it != sizes.end ())
+    {
+      return it->second;
+    }
+  uint32_t size = GetEncodedRrcMessageSize<MeasurementReportHeader> (msg);
+  sizes[key] = size;
+  return size;
+}
+
+/**
+ * Create the packet carrying an RRC message
+ * \param msg the message
+ * \param serialize if true, the payload is the ASN.1 encoding of the
+ *        message, otherwise it only has its size and the message is
+ *        carried as a structure
+ * \param x2 true if the message is sent over X2, in which case it is
+ *        dropped if not received within RRC_X2_STORED_MSG_LIFETIME
+ * \return the packet
+ */
+template <class H, class M>
+static Ptr<Packet>
+EncodeRrcMessage (const M &msg, bool serialize, bool x2 = false)
+{
+  if (serialize)
+    {
+      H header;
+      header.SetMessage (msg);
+      Ptr<Packet> packet = Create<Packet> ();
+      packet->AddHeader (header);
+      return packet;
+    }
+
+  Time now = Simulator::Now ();
+  while (!g_expiringRrcMessages.empty () && g_expiringRrcMessages.front ().first < now)
+    {
+      if (g_storedRrcMessages.erase (g_expiringRrcMessages.front ().second) > 0)
+        {
+          NS_LOG_LOGIC ("drop RRC message " << g_expiringRrcMessages.front ().second << " not received");
+        }
+      g_expiringRrcMessages.pop_front ();
+    }
+  if (!g_storedRrcMessagesCleanup)
+    {
+      Simulator::ScheduleDestroy (&ClearStoredRrcMessages);
+      g_storedRrcMessagesCleanup = true;
+    }
+
+  uint64_t id = g_nextStoredRrcMessageId++;
+  g_storedRrcMessages[id] = Create<StoredRrcMessage<M> > (msg);
+  if (x2)
+    {
+      g_expiringRrcMessages.push_back (std::make_pair (now + RRC_X2_STORED_MSG_LIFETIME, id));
+    }
+
+  Ptr<Packet> packet = Create<Packet> (GetRrcMessageSize (msg));
+  packet->AddByteTag (LteRrcMessageTag (id));
+  return packet;
+}
+
+/**
+ * Take the RRC message carried by a packet as a structure
+ * \param p the packet
+ * \param [out] message the message, or 0 if no longer available
+ * \return false if the payload of the packet is a serialized message
+ */
+static bool
+TakeStoredRrcMessage (Ptr<const Packet> p, Ptr<StoredRrcMessageBase> *message)
+{
+  LteRrcMessageTag tag;
+  if (!p->FindFirstMatchingByteTag (tag))
+    {
+      return false;
+    }
+  *message = 0;
+  std::map<uint64_t, Ptr<StoredRrcMessageBase> >::iterator it = g_storedRrcMessages.find (tag.GetId ());
+  if (it == g_storedRrcMessages.end ())
+    {
+      NS_LOG_WARN ("RRC message " << tag.GetId () << " no longer available, dropped");
+      return true;
+    }
+  *message = it->second;
+  g_storedRrcMessages.erase (it);
+  return true;
+}
+
+/**
+ * \param message an RRC message carried as a structure
+ * \param [out] msg the message, if it has type M
+ * \return true if the message has type M
+ */
+template <class M>
+static bool
+GetStoredRrcMessage (Ptr<StoredRrcMessageBase> message, M *msg)
+{
+  StoredRrcMessage<M> *m = dynamic_cast<StoredRrcMessage<M> *> (PeekPointer (message));
+  if (m == 0)
+    {
+      return false;
+    }
+  *msg = m->msg;
+  return true;
+}
+
 NS_OBJECT_ENSURE_REGISTERED (LteUeRrcProtocolReal);
 
 LteUeRrcProtocolReal::LteUeRrcProtocolReal ()
   :  m_ueRrcSapProvider (0),
-    m_enbRrcSapProvider (0)
+    m_enbRrcSapProvider (0),
+    m_serializeMessages (true)
 {
   m_ueRrcSapUser = new MemberLteUeRrcSapUser<LteUeRrcProtocolReal> (this);
   m_completeSetupParameters.srb0SapUser = new LteRlcSpecificLteRlcSapUser<LteUeRrcProtocolReal> (this);
@@ -71,6 +425,13 @@ LteUeRrcProtocolReal::GetTypeId (void)
     .SetParent<Object> ()
     .SetGroupName("Lte")
     .AddConstructor<LteUeRrcProtocolReal> ()
+    .AddAttribute ("SerializeMessages",
+                   "If true, the RRC messages are encoded in ASN.1. If false, "
+                   "the packets only have the size of the encoded messages, which "
+                   "are carried as structures; the receiver handles both forms.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&LteUeRrcProtocolReal::m_serializeMessages),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
@@ -111,12 +472,7 @@ LteUeRrcProtocolReal::DoSendRrcConnectionRequest (LteRrcSap::RrcConnectionReques
   m_rnti = m_rrc->GetRnti ();
   SetEnbRrcSapProvider ();
 
-  Ptr<Packet> packet = Create<Packet> ();
-
-  RrcConnectionRequestHeader rrcConnectionRequestHeader;
-  rrcConnectionRequestHeader.SetMessage (msg);
-
-  packet->AddHeader (rrcConnectionRequestHeader);
+  Ptr<Packet> packet = EncodeRrcMessage<RrcConnectionRequestHeader> (msg, m_serializeMessages);
 
   LteRlcSapProvider::TransmitPdcpPduParameters transmitPdcpPduParameters;
   transmitPdcpPduParameters.pdcpPdu = packet;
@@ -129,12 +485,7 @@ LteUeRrcProtocolReal::DoSendRrcConnectionRequest (LteRrcSap::RrcConnectionReques
 void 
 LteUeRrcProtocolReal::DoSendRrcConnectionSetupCompleted (LteRrcSap::RrcConnectionSetupCompleted msg)
 {
-  Ptr<Packet> packet = Create<Packet> ();
-
-  RrcConnectionSetupCompleteHeader rrcConnectionSetupCompleteHeader;
-  rrcConnectionSetupCompleteHeader.SetMessage (msg);
-
-  packet->AddHeader (rrcConnectionSetupCompleteHeader);
+  Ptr<Packet> packet = EncodeRrcMessage<RrcConnectionSetupCompleteHeader> (msg, m_serializeMessages);
 
   LtePdcpSapProvider::TransmitPdcpSduParameters transmitPdcpSduParameters;
   transmitPdcpSduParameters.pdcpSdu = packet;
@@ -155,12 +506,7 @@ LteUeRrcProtocolReal::DoSendRrcConnectionReconfigurationCompleted (LteRrcSap::Rr
   m_rnti = m_rrc->GetRnti ();
   SetEnbRrcSapProvider ();
 
-  Ptr<Packet> packet = Create<Packet> ();
-
-  RrcConnectionReconfigurationCompleteHeader rrcConnectionReconfigurationCompleteHeader;
-  rrcConnectionReconfigurationCompleteHeader.SetMessage (msg);
-
-  packet->AddHeader (rrcConnectionReconfigurationCompleteHeader);
+  Ptr<Packet> packet = EncodeRrcMessage<RrcConnectionReconfigurationCompleteHeader> (msg, m_serializeMessages);
 
   LtePdcpSapProvider::TransmitPdcpSduParameters transmitPdcpSduParameters;
   transmitPdcpSduParameters.pdcpSdu = packet;
@@ -178,12 +524,7 @@ LteUeRrcProtocolReal::DoSendMeasurementReport (LteRrcSap::MeasurementReport msg)
   m_rnti = m_rrc->GetRnti ();
   SetEnbRrcSapProvider ();
 
-  Ptr<Packet> packet = Create<Packet> ();
-
-  MeasurementReportHeader measurementReportHeader;
-  measurementReportHeader.SetMessage (msg);
-
-  packet->AddHeader (measurementReportHeader);
+  Ptr<Packet> packet = EncodeRrcMessage<MeasurementReportHeader> (msg, m_serializeMessages);
 
   LtePdcpSapProvider::TransmitPdcpSduParameters transmitPdcpSduParameters;
   transmitPdcpSduParameters.pdcpSdu = packet;
@@ -217,12 +558,7 @@ LteUeRrcProtocolReal::DoSendIdealUeContextRemoveRequest (uint16_t rnti)
 void 
 LteUeRrcProtocolReal::DoSendRrcConnectionReestablishmentRequest (LteRrcSap::RrcConnectionReestablishmentRequest msg)
 {
-  Ptr<Packet> packet = Create<Packet> ();
-
-  RrcConnectionReestablishmentRequestHeader rrcConnectionReestablishmentRequestHeader;
-  rrcConnectionReestablishmentRequestHeader.SetMessage (msg);
-
-  packet->AddHeader (rrcConnectionReestablishmentRequestHeader);
+  Ptr<Packet> packet = EncodeRrcMessage<RrcConnectionReestablishmentRequestHeader> (msg, m_serializeMessages);
 
   LteRlcSapProvider::TransmitPdcpPduParameters transmitPdcpPduParameters;
   transmitPdcpPduParameters.pdcpPdu = packet;
@@ -235,12 +571,7 @@ LteUeRrcProtocolReal::DoSendRrcConnectionReestablishmentRequest (LteRrcSap::RrcC
 void 
 LteUeRrcProtocolReal::DoSendRrcConnectionReestablishmentComplete (LteRrcSap::RrcConnectionReestablishmentComplete msg)
 {
-  Ptr<Packet> packet = Create<Packet> ();
-
-  RrcConnectionReestablishmentCompleteHeader rrcConnectionReestablishmentCompleteHeader;
-  rrcConnectionReestablishmentCompleteHeader.SetMessage (msg);
-
-  packet->AddHeader (rrcConnectionReestablishmentCompleteHeader);
+  Ptr<Packet> packet = EncodeRrcMessage<RrcConnectionReestablishmentCompleteHeader> (msg, m_serializeMessages);
 
   LtePdcpSapProvider::TransmitPdcpSduParameters transmitPdcpSduParameters;
   transmitPdcpSduParameters.pdcpSdu = packet;
@@ -298,6 +629,31 @@ LteUeRrcProtocolReal::SetEnbRrcSapProvider ()
 void
 LteUeRrcProtocolReal::DoReceivePdcpPdu (Ptr<Packet> p)
 {
+  Ptr<StoredRrcMessageBase> message;
+  if (TakeStoredRrcMessage (p, &message))
+    {
+      LteRrcSap::RrcConnectionReestablishment rrcConnectionReestablishmentMsg;
+      LteRrcSap::RrcConnectionReject rrcConnectionRejectMsg;
+      LteRrcSap::RrcConnectionSetup rrcConnectionSetupMsg;
+      if (message == 0)
+        {
+          return;
+        }
+      else if (GetStoredRrcMessage (message, &rrcConnectionReestablishmentMsg))
+        {
+          m_ueRrcSapProvider->RecvRrcConnectionReestablishment (rrcConnectionReestablishmentMsg);
+        }
+      else if (GetStoredRrcMessage (message, &rrcConnectionRejectMsg))
+        {
+          m_ueRrcSapProvider->RecvRrcConnectionReject (rrcConnectionRejectMsg);
+        }
+      else if (GetStoredRrcMessage (message, &rrcConnectionSetupMsg))
+        {
+          m_ueRrcSapProvider->RecvRrcConnectionSetup (rrcConnectionSetupMsg);
+        }
+      return;
+    }
+
   // Get type of message received
   RrcDlCcchMessage rrcDlCcchMessage;
   p->PeekHeader (rrcDlCcchMessage);
@@ -347,6 +703,17 @@ LteUeRrcProtocolReal::DoReceivePdcpPdu (Ptr<Packet> p)
 void
 LteUeRrcProtocolReal::DoReceivePdcpSdu (LtePdcpSapUser::ReceivePdcpSduParameters params)
 {
+  Ptr<StoredRrcMessageBase> message;
+  if (TakeStoredRrcMessage (params.pdcpSdu, &message))
+    {
+      LteRrcSap::RrcConnectionReconfiguration rrcConnectionReconfigurationMsg;
+      if (message != 0 && GetStoredRrcMessage (message, &rrcConnectionReconfigurationMsg))
+        {
+          m_ueRrcSapProvider->RecvRrcConnectionReconfiguration (rrcConnectionReconfigurationMsg);
+        }
+      return;
+    }
+
   // Get type of message received
   RrcDlDcchMessage rrcDlDcchMessage;
   params.pdcpSdu->PeekHeader (rrcDlDcchMessage);
@@ -378,7 +745,8 @@ LteUeRrcProtocolReal::DoReceivePdcpSdu (LtePdcpSapUser::ReceivePdcpSduParameters
 NS_OBJECT_ENSURE_REGISTERED (LteEnbRrcProtocolReal);
 
 LteEnbRrcProtocolReal::LteEnbRrcProtocolReal ()
-  :  m_enbRrcSapProvider (0)
+  :  m_enbRrcSapProvider (0),
+    m_serializeMessages (true)
 {
   NS_LOG_FUNCTION (this);
   m_enbRrcSapUser = new MemberLteEnbRrcSapUser<LteEnbRrcProtocolReal> (this);
@@ -412,6 +780,13 @@ LteEnbRrcProtocolReal::GetTypeId (void)
     .SetParent<Object> ()
     .SetGroupName("Lte")
     .AddConstructor<LteEnbRrcProtocolReal> ()
+    .AddAttribute ("SerializeMessages",
+                   "If true, the RRC messages are encoded in ASN.1. If false, "
+                   "the packets only have the size of the encoded messages, which "
+                   "are carried as structures; the receiver handles both forms.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&LteEnbRrcProtocolReal::m_serializeMessages),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
@@ -567,12 +942,7 @@ LteEnbRrcProtocolReal::DoSendSystemInformation (uint16_t cellId, LteRrcSap::Syst
 void 
 LteEnbRrcProtocolReal::DoSendRrcConnectionSetup (uint16_t rnti, LteRrcSap::RrcConnectionSetup msg)
 {
-  Ptr<Packet> packet = Create<Packet> ();
-
-  RrcConnectionSetupHeader rrcConnectionSetupHeader;
-  rrcConnectionSetupHeader.SetMessage (msg);
-
-  packet->AddHeader (rrcConnectionSetupHeader);
+  Ptr<Packet> packet = EncodeRrcMessage<RrcConnectionSetupHeader> (msg, m_serializeMessages);
 
   LteRlcSapProvider::TransmitPdcpPduParameters transmitPdcpPduParameters;
   transmitPdcpPduParameters.pdcpPdu = packet;
@@ -585,12 +955,7 @@ LteEnbRrcProtocolReal::DoSendRrcConnectionSetup (uint16_t rnti, LteRrcSap::RrcCo
 void 
 LteEnbRrcProtocolReal::DoSendRrcConnectionReject (uint16_t rnti, LteRrcSap::RrcConnectionReject msg)
 {
-  Ptr<Packet> packet = Create<Packet> ();
-
-  RrcConnectionRejectHeader rrcConnectionRejectHeader;
-  rrcConnectionRejectHeader.SetMessage (msg);
-
-  packet->AddHeader (rrcConnectionRejectHeader);
+  Ptr<Packet> packet = EncodeRrcMessage<RrcConnectionRejectHeader> (msg, m_serializeMessages);
 
   LteRlcSapProvider::TransmitPdcpPduParameters transmitPdcpPduParameters;
   transmitPdcpPduParameters.pdcpPdu = packet;
@@ -603,12 +968,7 @@ LteEnbRrcProtocolReal::DoSendRrcConnectionReject (uint16_t rnti, LteRrcSap::RrcC
 void 
 LteEnbRrcProtocolReal::DoSendRrcConnectionReconfiguration (uint16_t rnti, LteRrcSap::RrcConnectionReconfiguration msg)
 {
-  Ptr<Packet> packet = Create<Packet> ();
-
-  RrcConnectionReconfigurationHeader rrcConnectionReconfigurationHeader;
-  rrcConnectionReconfigurationHeader.SetMessage (msg);
-
-  packet->AddHeader (rrcConnectionReconfigurationHeader);
+  Ptr<Packet> packet = EncodeRrcMessage<RrcConnectionReconfigurationHeader> (msg, m_serializeMessages);
 
   LtePdcpSapProvider::TransmitPdcpSduParameters transmitPdcpSduParameters;
   transmitPdcpSduParameters.pdcpSdu = packet;
@@ -621,12 +981,7 @@ LteEnbRrcProtocolReal::DoSendRrcConnectionReconfiguration (uint16_t rnti, LteRrc
 void 
 LteEnbRrcProtocolReal::DoSendRrcConnectionReestablishment (uint16_t rnti, LteRrcSap::RrcConnectionReestablishment msg)
 {
-  Ptr<Packet> packet = Create<Packet> ();
-
-  RrcConnectionReestablishmentHeader rrcConnectionReestablishmentHeader;
-  rrcConnectionReestablishmentHeader.SetMessage (msg);
-
-  packet->AddHeader (rrcConnectionReestablishmentHeader);
+  Ptr<Packet> packet = EncodeRrcMessage<RrcConnectionReestablishmentHeader> (msg, m_serializeMessages);
 
   LteRlcSapProvider::TransmitPdcpPduParameters transmitPdcpPduParameters;
   transmitPdcpPduParameters.pdcpPdu = packet;
@@ -639,12 +994,7 @@ LteEnbRrcProtocolReal::DoSendRrcConnectionReestablishment (uint16_t rnti, LteRrc
 void 
 LteEnbRrcProtocolReal::DoSendRrcConnectionReestablishmentReject (uint16_t rnti, LteRrcSap::RrcConnectionReestablishmentReject msg)
 {
-  Ptr<Packet> packet = Create<Packet> ();
-
-  RrcConnectionReestablishmentRejectHeader rrcConnectionReestablishmentRejectHeader;
-  rrcConnectionReestablishmentRejectHeader.SetMessage (msg);
-
-  packet->AddHeader (rrcConnectionReestablishmentRejectHeader);
+  Ptr<Packet> packet = EncodeRrcMessage<RrcConnectionReestablishmentRejectHeader> (msg, m_serializeMessages);
 
   LteRlcSapProvider::TransmitPdcpPduParameters transmitPdcpPduParameters;
   transmitPdcpPduParameters.pdcpPdu = packet;
@@ -657,12 +1007,7 @@ LteEnbRrcProtocolReal::DoSendRrcConnectionReestablishmentReject (uint16_t rnti,
 void 
 LteEnbRrcProtocolReal::DoSendRrcConnectionRelease (uint16_t rnti, LteRrcSap::RrcConnectionRelease msg)
 {
-  Ptr<Packet> packet = Create<Packet> ();
-
-  RrcConnectionReleaseHeader rrcConnectionReleaseHeader;
-  rrcConnectionReleaseHeader.SetMessage (msg);
-
-  packet->AddHeader (rrcConnectionReleaseHeader);
+  Ptr<Packet> packet = EncodeRrcMessage<RrcConnectionReleaseHeader> (msg, m_serializeMessages);
 
   LtePdcpSapProvider::TransmitPdcpSduParameters transmitPdcpSduParameters;
   transmitPdcpSduParameters.pdcpSdu = packet;
@@ -675,6 +1020,26 @@ LteEnbRrcProtocolReal::DoSendRrcConnectionRelease (uint16_t rnti, LteRrcSap::Rrc
 void
 LteEnbRrcProtocolReal::DoReceivePdcpPdu (uint16_t rnti, Ptr<Packet> p)
 {
+  Ptr<StoredRrcMessageBase> message;
+  if (TakeStoredRrcMessage (p, &message))
+    {
+      LteRrcSap::RrcConnectionReestablishmentRequest rrcConnectionReestablishmentRequestMsg;
+      LteRrcSap::RrcConnectionRequest rrcConnectionRequestMsg;
+      if (message == 0)
+        {
+          return;
+        }
+      else if (GetStoredRrcMessage (message, &rrcConnectionReestablishmentRequestMsg))
+        {
+          m_enbRrcSapProvider->RecvRrcConnectionReestablishmentRequest (rnti, rrcConnectionReestablishmentRequestMsg);
+        }
+      else if (GetStoredRrcMessage (message, &rrcConnectionRequestMsg))
+        {
+          m_enbRrcSapProvider->RecvRrcConnectionRequest (rnti, rrcConnectionRequestMsg);
+        }
+      return;
+    }
+
   // Get type of message received
   RrcUlCcchMessage rrcUlCcchMessage;
   p->PeekHeader (rrcUlCcchMessage);
@@ -704,6 +1069,36 @@ LteEnbRrcProtocolReal::DoReceivePdcpPdu (uint16_t rnti, Ptr<Packet> p)
 void
 LteEnbRrcProtocolReal::DoReceivePdcpSdu (LtePdcpSapUser::ReceivePdcpSduParameters params)
 {
+  Ptr<StoredRrcMessageBase> message;
+  if (TakeStoredRrcMessage (params.pdcpSdu, &message))
+    {
+      LteRrcSap::MeasurementReport measurementReportMsg;
+      LteRrcSap::RrcConnectionReconfigurationCompleted rrcConnectionReconfigurationCompleteMsg;
+      LteRrcSap::RrcConnectionReestablishmentComplete rrcConnectionReestablishmentCompleteMsg;
+      LteRrcSap::RrcConnectionSetupCompleted rrcConnectionSetupCompletedMsg;
+      if (message == 0)
+        {
+          return;
+        }
+      else if (GetStoredRrcMessage (message, &measurementReportMsg))
+        {
+          m_enbRrcSapProvider->RecvMeasurementReport (params.rnti, measurementReportMsg);
+        }
+      else if (GetStoredRrcMessage (message, &rrcConnectionReconfigurationCompleteMsg))
+        {
+          m_enbRrcSapProvider->RecvRrcConnectionReconfigurationCompleted (params.rnti, rrcConnectionReconfigurationCompleteMsg);
+        }
+      else if (GetStoredRrcMessage (message, &rrcConnectionReestablishmentCompleteMsg))
+        {
+          m_enbRrcSapProvider->RecvRrcConnectionReestablishmentComplete (params.rnti, rrcConnectionReestablishmentCompleteMsg);
+        }
+      else if (GetStoredRrcMessage (message, &rrcConnectionSetupCompletedMsg))
+        {
+          m_enbRrcSapProvider->RecvRrcConnectionSetupCompleted (params.rnti, rrcConnectionSetupCompletedMsg);
+        }
+      return;
+    }
+
   // Get type of message received
   RrcUlDcchMessage rrcUlDcchMessage;
   params.pdcpSdu->PeekHeader (rrcUlDcchMessage);
@@ -749,17 +1144,21 @@ LteEnbRrcProtocolReal::DoReceivePdcpSdu (LtePdcpSapUser::ReceivePdcpSduParameter
 Ptr<Packet> 
 LteEnbRrcProtocolReal::DoEncodeHandoverPreparationInformation (LteRrcSap::HandoverPreparationInfo msg)
 {
-  HandoverPreparationInfoHeader h;
-  h.SetMessage (msg);
-
-  Ptr<Packet> p = Create<Packet> ();
-  p->AddHeader (h);
-  return p;
+  return EncodeRrcMessage<HandoverPreparationInfoHeader> (msg, m_serializeMessages, true);
 }
 
 LteRrcSap::HandoverPreparationInfo 
 LteEnbRrcProtocolReal::DoDecodeHandoverPreparationInformation (Ptr<Packet> p)
 {
+  Ptr<StoredRrcMessageBase> message;
+  if (TakeStoredRrcMessage (p, &message))
+    {
+      LteRrcSap::HandoverPreparationInfo msg;
+      bool found = (message != 0 && GetStoredRrcMessage (message, &msg));
+      NS_ABORT_MSG_IF (!found, "handover preparation information not available");
+      return msg;
+    }
+
   HandoverPreparationInfoHeader h;
   p->RemoveHeader (h);
   LteRrcSap::HandoverPreparationInfo msg = h.GetMessage ();
@@ -769,16 +1168,21 @@ LteEnbRrcProtocolReal::DoDecodeHandoverPreparationInformation (Ptr<Packet> p)
 Ptr<Packet> 
 LteEnbRrcProtocolReal::DoEncodeHandoverCommand (LteRrcSap::RrcConnectionReconfiguration msg)
 {
-  RrcConnectionReconfigurationHeader h;
-  h.SetMessage (msg);
-  Ptr<Packet> p = Create<Packet> ();
-  p->AddHeader (h);
-  return p;
+  return EncodeRrcMessage<RrcConnectionReconfigurationHeader> (msg, m_serializeMessages, true);
 }
 
 LteRrcSap::RrcConnectionReconfiguration
 LteEnbRrcProtocolReal::DoDecodeHandoverCommand (Ptr<Packet> p)
 {
+  Ptr<StoredRrcMessageBase> message;
+  if (TakeStoredRrcMessage (p, &message))
+    {
+      LteRrcSap::RrcConnectionReconfiguration msg;
+      bool found = (message != 0 && GetStoredRrcMessage (message, &msg));
+      NS_ABORT_MSG_IF (!found, "handover command not available");
+      return msg;
+    }
+
   RrcConnectionReconfigurationHeader h;
   p->RemoveHeader (h);
   LteRrcSap::RrcConnectionReconfiguration msg = h.GetMessage ();
@@ -48,6 +48,10 @@ class LteUeRrc;
  * a real fashion, by creating real RRC PDUs and transmitting them
  * over Signaling Radio Bearers using radio resources allocated by the
  * LTE MAC scheduler.
+ *
+ * When the `SerializeMessages` attribute is false, the messages are not
+ * encoded: each PDU only has the size of the ASN.1 encoding of its message,
+ * which is carried as a structure and identified by an LteRrcMessageTag.
  * 
  */
 class LteUeRrcProtocolReal : public Object
@@ -170,6 +174,7 @@ private:
 
   LteUeRrcSapUser::SetupParameters m_setupParameters; ///< setup parameters
   LteUeRrcSapProvider::CompleteSetupParameters m_completeSetupParameters; ///< complete setup parameters
+  bool m_serializeMessages; ///< the `SerializeMessages` attribute
 
 };
 
@@ -180,6 +185,10 @@ private:
  * over Signaling Radio Bearers using radio resources allocated by the
  * LTE MAC scheduler.
  *
+ * When the `SerializeMessages` attribute is false, the messages are not
+ * encoded: each PDU only has the size of the ASN.1 encoding of its message,
+ * which is carried as a structure and identified by an LteRrcMessageTag.
+ *
  */
 class LteEnbRrcProtocolReal : public Object
 {
@@ -360,6 +369,7 @@ private:
   std::map<uint16_t, LteUeRrcSapProvider*> m_enbRrcSapProviderMap; ///< ENB RRC SAP provider map
   std::map<uint16_t, LteEnbRrcSapUser::SetupUeParameters> m_setupUeParametersMap; ///< setup UE parameters map
   std::map<uint16_t, LteEnbRrcSapProvider::CompleteSetupUeParameters> m_completeSetupUeParametersMap; ///< complete setup UE parameters map
+  bool m_serializeMessages; ///< the `SerializeMessages` attribute
 
 };
 
@@ -271,7 +271,7 @@ LteSpectrumValueHelper::GetSpectrumModel (uint32_t earfcn, uint16_t txBandwidthC
 }
 
 Ptr<SpectrumValue> 
-LteSpectrumValueHelper::CreateTxPowerSpectralDensity (uint32_t earfcn, uint16_t txBandwidthConfiguration, double powerTx, std::vector <int> activeRbs)
+LteSpectrumValueHelper::CreateTxPowerSpectralDensity (uint32_t earfcn, uint16_t txBandwidthConfiguration, double powerTx, const std::vector <int> &activeRbs)
 {
   NS_LOG_FUNCTION (earfcn << txBandwidthConfiguration << powerTx << activeRbs);
 
@@ -283,7 +283,7 @@ LteSpectrumValueHelper::CreateTxPowerSpectralDensity (uint32_t earfcn, uint16_t
 
   double txPowerDensity = (powerTxW / (txBandwidthConfiguration * 180000));
 
-  for (std::vector <int>::iterator it = activeRbs.begin (); it != activeRbs.end (); it++)
+  for (std::vector <int>::const_iterator it = activeRbs.begin (); it != activeRbs.end (); it++)
     {
       int rbId = (*it);
       (*txPsd)[rbId] = txPowerDensity;
@@ -295,7 +295,7 @@ LteSpectrumValueHelper::CreateTxPowerSpectralDensity (uint32_t earfcn, uint16_t
 }
 
 Ptr<SpectrumValue>
-LteSpectrumValueHelper::CreateTxPowerSpectralDensity (uint32_t earfcn, uint16_t txBandwidthConfiguration, double powerTx, std::map<int, double> powerTxMap, std::vector <int> activeRbs)
+LteSpectrumValueHelper::CreateTxPowerSpectralDensity (uint32_t earfcn, uint16_t txBandwidthConfiguration, double powerTx, const std::map<int, double> &powerTxMap, const std::vector <int> &activeRbs)
 {
   NS_LOG_FUNCTION (earfcn << txBandwidthConfiguration << activeRbs);
 
@@ -306,11 +306,11 @@ LteSpectrumValueHelper::CreateTxPowerSpectralDensity (uint32_t earfcn, uint16_t
   double basicPowerTxW = std::pow (10., (powerTx - 30) / 10);
 
 
-  for (std::vector <int>::iterator it = activeRbs.begin (); it != activeRbs.end (); it++)
+  for (std::vector <int>::const_iterator it = activeRbs.begin (); it != activeRbs.end (); it++)
     {
       int rbId = (*it);
 
-      std::map<int, double>::iterator powerIt = powerTxMap.find (rbId);
+      std::map<int, double>::const_iterator powerIt = powerTxMap.find (rbId);
 
       double txPowerDensity;
 
@@ -333,7 +333,7 @@ LteSpectrumValueHelper::CreateTxPowerSpectralDensity (uint32_t earfcn, uint16_t
 }
 
 Ptr<SpectrumValue>
-LteSpectrumValueHelper::CreateUlTxPowerSpectralDensity (uint16_t earfcn, uint16_t txBandwidthConfiguration, double powerTx, std::vector <int> activeRbs)
+LteSpectrumValueHelper::CreateUlTxPowerSpectralDensity (uint16_t earfcn, uint16_t txBandwidthConfiguration, double powerTx, const std::vector <int> &activeRbs)
 {
   NS_LOG_FUNCTION (earfcn << txBandwidthConfiguration << powerTx << activeRbs);
 
@@ -345,7 +345,7 @@ LteSpectrumValueHelper::CreateUlTxPowerSpectralDensity (uint16_t earfcn, uint16_
 
   double txPowerDensity = (powerTxW / (activeRbs.size() * 180000));
 
-  for (std::vector <int>::iterator it = activeRbs.begin (); it != activeRbs.end (); it++)
+  for (std::vector <int>::const_iterator it = activeRbs.begin (); it != activeRbs.end (); it++)
     {
       int rbId = (*it);
       (*txPsd)[rbId] = txPowerDensity;
@@ -128,7 +128,7 @@ public:
   static Ptr<SpectrumValue> CreateTxPowerSpectralDensity (uint32_t earfcn,
                                                           uint16_t bandwidth,
                                                           double powerTx,
-                                                          std::vector <int> activeRbs);
+                                                          const std::vector <int> &activeRbs);
 
   /**
    * create a spectrum value representing the power spectral
@@ -149,8 +149,8 @@ public:
   static Ptr<SpectrumValue> CreateTxPowerSpectralDensity (uint32_t earfcn,
                                                           uint16_t bandwidth,
                                                           double powerTx,
-                                                          std::map<int, double> powerTxMap,
-                                                          std::vector <int> activeRbs);
+                                                          const std::map<int, double> &powerTxMap,
+                                                          const std::vector <int> &activeRbs);
 
   /**
    * create a spectrum value representing the uplink power spectral
@@ -169,7 +169,7 @@ public:
   static Ptr<SpectrumValue> CreateUlTxPowerSpectralDensity (uint16_t earfcn,
                                                             uint16_t bandwidth,
                                                             double powerTx,
-                                                            std::vector <int> activeRbs);
+                                                            const std::vector <int> &activeRbs);
 
   /**
    * create a SpectrumValue that models the power spectral density of AWGN
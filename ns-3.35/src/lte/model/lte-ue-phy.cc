@@ -26,6 +26,7 @@
 #include <ns3/object-factory.h>
 #include <ns3/log.h>
 #include <ns3/node.h>
+#include <algorithm>
 #include <cfloat>
 #include <cmath>
 #include <ns3/simulator.h>
@@ -295,6 +296,12 @@ LteUePhy::GetTypeId (void)
                    DoubleValue (-1000.0),
                    MakeDoubleAccessor (&LteUePhy::m_pssReceptionThreshold),
                    MakeDoubleChecker<double> ())
+    .AddAttribute ("RsrpUeMeasThreshold",
+                   "Detection threshold for PSS on RSRP [dBm]. The cells whose "
+                   "PSS is received below it are neither measured nor reported.",
+                   DoubleValue (-1000.0),
+                   MakeDoubleAccessor (&LteUePhy::m_pssDetectionThreshold),
+                   MakeDoubleChecker<double> ())
     .AddAttribute ("UeMeasurementsFilterPeriod",
                    "Time period for reporting UE measurements, i.e., the"
                    "length of layer-1 filtering.",
@@ -651,25 +658,26 @@ LteUePhy::GenerateCqiRsrpRsrq (const SpectrumValue& sinr)
       // measure instantaneous RSRQ now
       NS_ASSERT_MSG (m_rsInterferencePowerUpdated, " RS interference power info obsolete");
 
-      std::list <PssElement>::iterator itPss = m_pssList.begin ();
-      while (itPss != m_pssList.end ())
+      // the RSSI does not depend on the measured cell, so it is computed
+      // once for all the PSS received in this subframe
+      uint16_t rbNum = 0;
+      double rssiSum = 0.0;
+      Values::const_iterator itIntN = m_rsInterferencePower.ConstValuesBegin ();
+      Values::const_iterator itPj;
+      for (itPj = m_rsReceivedPower.ConstValuesBegin ();
+           itPj != m_rsReceivedPower.ConstValuesEnd ();
+           itIntN++, itPj++)
         {
-          uint16_t rbNum = 0;
-          double rssiSum = 0.0;
-
-          Values::const_iterator itIntN = m_rsInterferencePower.ConstValuesBegin ();
-          Values::const_iterator itPj = m_rsReceivedPower.ConstValuesBegin ();
-          for (itPj = m_rsReceivedPower.ConstValuesBegin ();
-               itPj != m_rsReceivedPower.ConstValuesEnd ();
-               itIntN++, itPj++)
-            {
-              rbNum++;
-              // convert PSD [W/Hz] to linear power [W] for the single RE
-              double interfPlusNoisePowerTxW = ((*itIntN) * 180000.0) / 12.0;
-              double signalPowerTxW = ((*itPj) * 180000.0) / 12.0;
-              rssiSum += (2 * (interfPlusNoisePowerTxW + signalPowerTxW));
-            }
+          rbNum++;
+          // convert PSD [W/Hz] to linear power [W] for the single RE
+          double interfPlusNoisePowerTxW = ((*itIntN) * 180000.0) / 12.0;
+          double signalPowerTxW = ((*itPj) * 180000.0) / 12.0;
+          rssiSum += (2 * (interfPlusNoisePowerTxW + signalPowerTxW));
+        }
 
+      std::vector <PssElement>::const_iterator itPss = m_pssList.begin ();
+      while (itPss != m_pssList.end ())
+        {
           NS_ASSERT (rbNum == (*itPss).nRB);
           double rsrq_dB = 10 * log10 ((*itPss).pssPsdSum / rssiSum);
 
@@ -678,12 +686,11 @@ LteUePhy::GenerateCqiRsrpRsrq (const SpectrumValue& sinr)
               NS_LOG_INFO (this << " PSS RNTI " << m_rnti << " cellId " << m_cellId
                                 << " has RSRQ " << rsrq_dB << " and RBnum " << rbNum);
               // store measurements
-              std::map <uint16_t, UeMeasurementsElement>::iterator itMeasMap;
-              itMeasMap = m_ueMeasurementsMap.find ((*itPss).cellId);
-              if (itMeasMap != m_ueMeasurementsMap.end ())
+              std::vector <UeMeasurementsElement>::iterator itMeas = FindUeMeasurements ((*itPss).cellId);
+              if (itMeas != m_ueMeasurements.end () && itMeas->cellId == (*itPss).cellId)
                 {
-                  (*itMeasMap).second.rsrqSum += rsrq_dB;
-                  (*itMeasMap).second.rsrqNum++;
+                  itMeas->rsrqSum += rsrq_dB;
+                  itMeas->rsrqNum++;
                 }
               else
                 {
@@ -944,38 +951,39 @@ LteUePhy::ReportUeMeasurements ()
 
   LteUeCphySapUser::UeMeasurementsParameters ret;
 
-  std::map <uint16_t, UeMeasurementsElement>::iterator it;
-  for (it = m_ueMeasurementsMap.begin (); it != m_ueMeasurementsMap.end (); it++)
+  ret.m_ueMeasurementsList.reserve (m_ueMeasurements.size ());
+  std::vector <UeMeasurementsElement>::const_iterator it;
+  for (it = m_ueMeasurements.begin (); it != m_ueMeasurements.end (); it++)
     {
-      double avg_rsrp = (*it).second.rsrpSum / (double)(*it).second.rsrpNum;
-      double avg_rsrq = (*it).second.rsrqSum / (double)(*it).second.rsrqNum;
+      double avg_rsrp = it->rsrpSum / (double)it->rsrpNum;
+      double avg_rsrq = it->rsrqSum / (double)it->rsrqNum;
       /*
        * In CELL_SEARCH state, this may result in avg_rsrq = 0/0 = -nan.
        * UE RRC must take this into account when receiving measurement reports.
        * TODO remove this shortcoming by calculating RSRQ during CELL_SEARCH
        */
-      NS_LOG_DEBUG (this << " CellId " << (*it).first
+      NS_LOG_DEBUG (this << " CellId " << it->cellId
                          << " RSRP " << avg_rsrp
-                         << " (nSamples " << (uint16_t)(*it).second.rsrpNum << ")"
+                         << " (nSamples " << (uint16_t)it->rsrpNum << ")"
                          << " RSRQ " << avg_rsrq
-                         << " (nSamples " << (uint16_t)(*it).second.rsrqNum << ")"
+                         << " (nSamples " << (uint16_t)it->rsrqNum << ")"
                          << " ComponentCarrierID " << (uint16_t)m_componentCarrierId);
 
       LteUeCphySapUser::UeMeasurementsElement newEl;
-      newEl.m_cellId = (*it).first;
+      newEl.m_cellId = it->cellId;
       newEl.m_rsrp = avg_rsrp;
       newEl.m_rsrq = avg_rsrq;
       ret.m_ueMeasurementsList.push_back (newEl);
       ret.m_componentCarrierId = m_componentCarrierId;
 
       // report to UE measurements trace
-      m_reportUeMeasurements (m_rnti, (*it).first, avg_rsrp, avg_rsrq, ((*it).first == m_cellId ? 1 : 0), m_componentCarrierId);
+      m_reportUeMeasurements (m_rnti, it->cellId, avg_rsrp, avg_rsrq, (it->cellId == m_cellId ? 1 : 0), m_componentCarrierId);
     }
 
   // report to RRC
   m_ueCphySapUser->ReportUeMeasurements (ret);
 
-  m_ueMeasurementsMap.clear ();
+  m_ueMeasurements.clear ();
   Simulator::Schedule (m_ueMeasurementsFilterPeriod, &LteUePhy::ReportUeMeasurements, this);
 }
 
@@ -1202,23 +1210,29 @@ LteUePhy::ReceivePss (uint16_t cellId, Ptr<SpectrumValue> p)
   NS_LOG_INFO (this << " PSS RNTI " << m_rnti << " cellId " << m_cellId
                     << " has RSRP " << rsrp_dBm << " and RBnum " << nRB);
   // note that m_pssReceptionThreshold does not apply here
+  if (rsrp_dBm < m_pssDetectionThreshold)
+    {
+      NS_LOG_LOGIC (this << " PSS of cellId " << cellId << " below the detection threshold");
+      return;
+    }
 
   // store measurements
-  std::map <uint16_t, UeMeasurementsElement>::iterator itMeasMap = m_ueMeasurementsMap.find (cellId);
-  if (itMeasMap == m_ueMeasurementsMap.end ())
+  std::vector <UeMeasurementsElement>::iterator itMeas = FindUeMeasurements (cellId);
+  if (itMeas == m_ueMeasurements.end () || itMeas->cellId != cellId)
     {
       // insert new entry
       UeMeasurementsElement newEl;
+      newEl.cellId = cellId;
       newEl.rsrpSum = rsrp_dBm;
       newEl.rsrpNum = 1;
       newEl.rsrqSum = 0;
       newEl.rsrqNum = 0;
-      m_ueMeasurementsMap.insert (std::pair <uint16_t, UeMeasurementsElement> (cellId, newEl));
+      m_ueMeasurements.insert (itMeas, newEl);
     }
   else
     {
-      (*itMeasMap).second.rsrpSum += rsrp_dBm;
-      (*itMeasMap).second.rsrpNum++;
+      itMeas->rsrpSum += rsrp_dBm;
+      itMeas->rsrpNum++;
     }
 
   /*
@@ -1235,6 +1249,15 @@ LteUePhy::ReceivePss (uint16_t cellId, Ptr<SpectrumValue> p)
 } // end of void LteUePhy::ReceivePss (uint16_t cellId, Ptr<SpectrumValue> p)
 
 
+std::vector <LteUePhy::UeMeasurementsElement>::iterator
+LteUePhy::FindUeMeasurements (uint16_t cellId)
+{
+  return std::lower_bound (m_ueMeasurements.begin (), m_ueMeasurements.end (), cellId,
+                           [] (const UeMeasurementsElement &el, uint16_t id)
+                           { return el.cellId < id; });
+}
+
+
 void
 LteUePhy::QueueSubChannelsForTransmission (std::vector <int> rbMap)
 {
@@ -729,7 +729,11 @@ private:
     double pssPsdSum; ///< PSS PSD sum
     uint16_t nRB; ///< number of RB
   };
-  std::list <PssElement> m_pssList; ///< PSS list
+  /**
+   * PSS received in the current subframe. Cleared at each subframe without
+   * releasing its storage.
+   */
+  std::vector <PssElement> m_pssList;
 
   /**
    * The `RsrqUeMeasThreshold` attribute. Receive threshold for PSS on RSRQ
@@ -737,9 +741,16 @@ private:
    */
   double m_pssReceptionThreshold;
 
+  /**
+   * The `RsrpUeMeasThreshold` attribute. Detection threshold for PSS on RSRP
+   * in dBm.
+   */
+  double m_pssDetectionThreshold;
+
   /// Summary results of measuring a specific cell. Used for layer-1 filtering.
   struct UeMeasurementsElement
   {
+    uint16_t cellId;  ///< Cell ID.
     double rsrpSum;   ///< Sum of RSRP sample values in linear unit.
     uint8_t rsrpNum;  ///< Number of RSRP samples.
     double rsrqSum;   ///< Sum of RSRQ sample values in linear unit.
@@ -747,10 +758,20 @@ private:
   };
 
   /**
-   * Store measurement results during the last layer-1 filtering period.
-   * Indexed by the cell ID where the measurements come from.
+   * Find the measurements of a cell.
+   *
+   * \param cellId the cell ID
+   * \return the first element of m_ueMeasurements whose cell ID is not lower
+   *         than cellId
+   */
+  std::vector <UeMeasurementsElement>::iterator FindUeMeasurements (uint16_t cellId);
+
+  /**
+   * Store measurement results during the last layer-1 filtering period,
+   * sorted by the cell ID where the measurements come from. Cleared at each
+   * period without releasing its storage.
    */
-  std::map <uint16_t, UeMeasurementsElement> m_ueMeasurementsMap;
+  std::vector <UeMeasurementsElement> m_ueMeasurements;
   /**
    * The `UeMeasurementsFilterPeriod` attribute. Time period for reporting UE
    * measurements, i.e., the length of layer-1 filtering (default 200 ms).
@@ -0,0 +1,347 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <vector>
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/config.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/string.h"
+#include "ns3/pointer.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/position-allocator.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/spectrum-channel.h"
+#include "ns3/spectrum-phy.h"
+#include "ns3/eps-bearer.h"
+#include "ns3/lte-helper.h"
+#include "ns3/lte-pathloss-matrix.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteTestPathlossMatrix");
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Test that LtePathlossMatrix stores the gains of the static pairs,
+ * and recomputes them after a course change or while a node is moving.
+ */
+class LtePathlossMatrixTestCase : public TestCase
+{
+public:
+  LtePathlossMatrixTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LtePathlossMatrixTestCase::LtePathlossMatrixTestCase ()
+  : TestCase ("LtePathlossMatrix gains and invalidation")
+{
+}
+
+void
+LtePathlossMatrixTestCase::DoRun (void)
+{
+  Ptr<LogDistancePropagationLossModel> model = CreateObject<LogDistancePropagationLossModel> ();
+  Ptr<LtePathlossMatrix> matrix = CreateObject<LtePathlossMatrix> ();
+  matrix->SetPropagationLossModel (model);
+
+  Ptr<MobilityModel> tx = CreateObject<ConstantPositionMobilityModel> ();
+  tx->SetPosition (Vector (0, 0, 30));
+  Ptr<MobilityModel> rx = CreateObject<ConstantPositionMobilityModel> ();
+  rx->SetPosition (Vector (100, 0, 1.5));
+  Ptr<ConstantVelocityMobilityModel> moving = CreateObject<ConstantVelocityMobilityModel> ();
+  moving->SetPosition (Vector (0, 200, 1.5));
+  Ptr<MobilityModel> other = CreateObject<ConstantPositionMobilityModel> ();
+  other->SetPosition (Vector (300, 0, 1.5));
+
+  matrix->AddTransmitter (tx);
+  matrix->AddTransmitter (tx);
+  matrix->AddReceiver (rx);
+  matrix->AddReceiver (moving);
+  matrix->Precompute ();
+  NS_TEST_ASSERT_MSG_EQ (matrix->GetNComputed (), 2, "wrong number of precomputed gains");
+
+  NS_TEST_ASSERT_MSG_EQ (matrix->CalcRxPower (10, tx, rx), model->CalcRxPower (10, tx, rx), "wrong gain");
+  NS_TEST_ASSERT_MSG_EQ (matrix->GetNComputed (), 2, "stored gain not used");
+
+  rx->SetPosition (Vector (200, 0, 1.5));
+  NS_TEST_ASSERT_MSG_EQ (matrix->CalcRxPower (10, tx, rx), model->CalcRxPower (10, tx, rx), "gain not updated");
+  NS_TEST_ASSERT_MSG_EQ (matrix->GetNComputed (), 3, "gain not recomputed after a course change");
+  matrix->CalcRxPower (10, tx, rx);
+  NS_TEST_ASSERT_MSG_EQ (matrix->GetNComputed (), 3, "updated gain not stored");
+
+  moving->SetVelocity (Vector (10, 0, 0));
+  matrix->CalcRxPower (10, tx, moving);
+  matrix->CalcRxPower (10, tx, moving);
+  NS_TEST_ASSERT_MSG_EQ (matrix->GetNComputed (), 5, "gain of a moving node stored");
+  moving->SetVelocity (Vector (0, 0, 0));
+  matrix->CalcRxPower (10, tx, moving);
+  matrix->CalcRxPower (10, tx, moving);
+  NS_TEST_ASSERT_MSG_EQ (matrix->GetNComputed (), 6, "gain of a stopped node not stored");
+
+  NS_TEST_ASSERT_MSG_EQ (matrix->CalcRxPower (10, tx, other), model->CalcRxPower (10, tx, other), "wrong gain");
+  NS_TEST_ASSERT_MSG_EQ (matrix->CalcRxPower (10, rx, tx), model->CalcRxPower (10, rx, tx), "wrong gain");
+  NS_TEST_ASSERT_MSG_EQ (matrix->GetNComputed (), 8, "gain of an unregistered pair not computed");
+
+  matrix->Dispose ();
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Test that the DL and UL SINR traces of an LTE simulation are the
+ * same with and without the pathloss matrix, with static, moving and
+ * relocated UEs.
+ */
+class LtePathlossMatrixSinrTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   *
+   * \param numThreads the number of threads computing the matrix
+   */
+  LtePathlossMatrixSinrTestCase (uint32_t numThreads);
+
+private:
+  virtual void DoRun (void);
+
+  /// A SINR reported by a PHY
+  struct SinrRecord
+  {
+    double time;     ///< time of the report, in s
+    uint16_t cellId; ///< cell ID
+    uint16_t rnti;   ///< RNTI
+    double sinr;     ///< SINR, in linear units
+  };
+
+  /**
+   * Run the test scenario
+   *
+   * \param usePathlossMatrix true to use the pathloss matrix
+   * \param [out] dl the DL SINRs reported by the UEs
+   * \param [out] ul the UL SINRs reported by the eNBs
+   * \param [out] evaluations the number of DL gains used by the channel
+   * \return the number of gains computed by the DL pathloss matrix, or 0
+   */
+  uint64_t RunScenario (bool usePathlossMatrix, std::vector<SinrRecord> *dl, std::vector<SinrRecord> *ul,
+                        uint64_t *evaluations);
+
+  /**
+   * Record a DL SINR
+   *
+   * \param records the records
+   * \param cellId the cell ID
+   * \param rnti the RNTI
+   * \param rsrp the RSRP
+   * \param sinr the SINR
+   * \param componentCarrierId the component carrier ID
+   */
+  static void DlSinr (std::vector<SinrRecord> *records, uint16_t cellId, uint16_t rnti,
+                      double rsrp, double sinr, uint8_t componentCarrierId);
+  /**
+   * Record an UL SINR
+   *
+   * \param records the records
+   * \param cellId the cell ID
+   * \param rnti the RNTI
+   * \param sinr the SINR
+   * \param componentCarrierId the component carrier ID
+   */
+  static void UlSinr (std::vector<SinrRecord> *records, uint16_t cellId, uint16_t rnti,
+                      double sinr, uint8_t componentCarrierId);
+  /**
+   * Count a gain used by the channel
+   *
+   * \param evaluations the number of gains
+   * \param txPhy the transmitter
+   * \param rxPhy the receiver
+   * \param lossDb the loss
+   */
+  static void PathLoss (uint64_t *evaluations, Ptr<const SpectrumPhy> txPhy, Ptr<const SpectrumPhy> rxPhy,
+                        double lossDb);
+
+  uint32_t m_numThreads; ///< the number of threads computing the matrix
+};
+
+LtePathlossMatrixSinrTestCase::LtePathlossMatrixSinrTestCase (uint32_t numThreads)
+  : TestCase ("SINR traces with and without the pathloss matrix, " + std::to_string (numThreads) + " thread(s)"),
+    m_numThreads (numThreads)
+{
+}
+
+void
+LtePathlossMatrixSinrTestCase::DlSinr (std::vector<SinrRecord> *records, uint16_t cellId, uint16_t rnti,
+                                       double rsrp, double sinr, uint8_t componentCarrierId)
+{
+  SinrRecord record = { Simulator::Now ().GetSeconds (), cellId, rnti, sinr };
+  records->push_back (record);
+}
+
+void
+LtePathlossMatrixSinrTestCase::UlSinr (std::vector<SinrRecord> *records, uint16_t cellId, uint16_t rnti,
+                                       double sinr, uint8_t componentCarrierId)
+{
+  SinrRecord record = { Simulator::Now ().GetSeconds (), cellId, rnti, sinr };
+  records->push_back (record);
+}
+
+void
+LtePathlossMatrixSinrTestCase::PathLoss (uint64_t *evaluations, Ptr<const SpectrumPhy> txPhy, Ptr<const SpectrumPhy> rxPhy,
+                                         double lossDb)
+{
+  (*evaluations)++;
+}
+
+uint64_t
+LtePathlossMatrixSinrTestCase::RunScenario (bool usePathlossMatrix, std::vector<SinrRecord> *dl, std::vector<SinrRecord> *ul,
+                                            uint64_t *evaluations)
+{
+  Config::SetDefault ("ns3::LtePathlossMatrix::NumThreads", UintegerValue (m_numThreads));
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  lteHelper->SetAttribute ("PathlossModel", StringValue ("ns3::LogDistancePropagationLossModel"));
+  lteHelper->SetAttribute ("UsePathlossMatrix", BooleanValue (usePathlossMatrix));
+
+  NodeContainer enbNodes;
+  enbNodes.Create (3);
+  NodeContainer ueNodes;
+  ueNodes.Create (5);
+
+  Ptr<ListPositionAllocator> enbPositions = CreateObject<ListPositionAllocator> ();
+  enbPositions->Add (Vector (0.0, 0.0, 30.0));
+  enbPositions->Add (Vector (500.0, 0.0, 30.0));
+  enbPositions->Add (Vector (250.0, 400.0, 30.0));
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator (enbPositions);
+  mobility.Install (enbNodes);
+
+  Ptr<ListPositionAllocator> uePositions = CreateObject<ListPositionAllocator> ();
+  uePositions->Add (Vector (50.0, 20.0, 1.5));
+  uePositions->Add (Vector (450.0, -30.0, 1.5));
+  uePositions->Add (Vector (260.0, 350.0, 1.5));
+  uePositions->Add (Vector (100.0, 100.0, 1.5));
+  uePositions->Add (Vector (300.0, 100.0, 1.5));
+  mobility.SetMobilityModel ("ns3::ConstantVelocityMobilityModel");
+  mobility.SetPositionAllocator (uePositions);
+  mobility.Install (ueNodes);
+  // UE 3 moves from the start, UE 4 is relocated during the simulation,
+  // the others are static
+  ueNodes.Get (3)->GetObject<ConstantVelocityMobilityModel> ()->SetVelocity (Vector (100.0, 0.0, 0.0));
+  Simulator::Schedule (Seconds (0.15), &MobilityModel::SetPosition,
+                       ueNodes.Get (4)->GetObject<MobilityModel> (), Vector (400.0, 300.0, 1.5));
+
+  NetDeviceContainer enbDevs = lteHelper->InstallEnbDevice (enbNodes);
+  NetDeviceContainer ueDevs = lteHelper->InstallUeDevice (ueNodes);
+  // both runs must draw the same random values
+  int64_t stream = 1;
+  stream += lteHelper->AssignStreams (enbDevs, stream);
+  lteHelper->AssignStreams (ueDevs, stream);
+  lteHelper->AttachToClosestEnb (ueDevs, enbDevs);
+  lteHelper->ActivateDataRadioBearer (ueDevs, EpsBearer (EpsBearer::NGBR_VIDEO_TCP_DEFAULT));
+
+  Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/ComponentCarrierMapUe/*/LteUePhy/ReportCurrentCellRsrpSinr",
+                                 MakeBoundCallback (&LtePathlossMatrixSinrTestCase::DlSinr, dl));
+  Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/ComponentCarrierMap/*/LteEnbPhy/ReportUeSinr",
+                                 MakeBoundCallback (&LtePathlossMatrixSinrTestCase::UlSinr, ul));
+  *evaluations = 0;
+  lteHelper->GetDownlinkSpectrumChannel ()->TraceConnectWithoutContext ("PathLoss",
+                                                                        MakeBoundCallback (&LtePathlossMatrixSinrTestCase::PathLoss, evaluations));
+
+  Simulator::Stop (Seconds (0.3));
+  Simulator::Run ();
+  uint64_t computed = 0;
+  Ptr<LtePathlossMatrix> matrix = DynamicCast<LtePathlossMatrix> (lteHelper->GetDownlinkSpectrumChannel ()->GetPropagationLossModel ());
+  if (matrix != 0)
+    {
+      computed = matrix->GetNComputed ();
+    }
+  Simulator::Destroy ();
+  Config::Reset ();
+  return computed;
+}
+
+void
+LtePathlossMatrixSinrTestCase::DoRun (void)
+{
+  std::vector<SinrRecord> dlReference;
+  std::vector<SinrRecord> ulReference;
+  uint64_t evaluations;
+  RunScenario (false, &dlReference, &ulReference, &evaluations);
+  std::vector<SinrRecord> dl;
+  std::vector<SinrRecord> ul;
+  uint64_t computed = RunScenario (true, &dl, &ul, &evaluations);
+
+  NS_TEST_ASSERT_MSG_GT (dlReference.size (), 0, "no DL SINR reported");
+  NS_TEST_ASSERT_MSG_GT (ulReference.size (), 0, "no UL SINR reported");
+  NS_TEST_ASSERT_MSG_EQ (dl.size (), dlReference.size (), "wrong number of DL SINRs");
+  NS_TEST_ASSERT_MSG_EQ (ul.size (), ulReference.size (), "wrong number of UL SINRs");
+  for (std::size_t i = 0; i < dl.size (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (dl[i].time, dlReference[i].time, "wrong DL SINR time");
+      NS_TEST_ASSERT_MSG_EQ (dl[i].cellId, dlReference[i].cellId, "wrong DL SINR cell");
+      NS_TEST_ASSERT_MSG_EQ (dl[i].rnti, dlReference[i].rnti, "wrong DL SINR RNTI");
+      NS_TEST_ASSERT_MSG_EQ (dl[i].sinr, dlReference[i].sinr, "wrong DL SINR");
+    }
+  for (std::size_t i = 0; i < ul.size (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (ul[i].time, ulReference[i].time, "wrong UL SINR time");
+      NS_TEST_ASSERT_MSG_EQ (ul[i].cellId, ulReference[i].cellId, "wrong UL SINR cell");
+      NS_TEST_ASSERT_MSG_EQ (ul[i].rnti, ulReference[i].rnti, "wrong UL SINR RNTI");
+      NS_TEST_ASSERT_MSG_EQ (ul[i].sinr, ulReference[i].sinr, "wrong UL SINR");
+    }
+  // the DL gains of the static UEs are computed once, those of the
+  // relocated UE twice, and those of the moving UE (1 out of 5) for each
+  // DL signal
+  NS_TEST_ASSERT_MSG_GT (computed, 3 * 5, "gains of the moving UE not recomputed");
+  NS_TEST_ASSERT_MSG_LT (computed, evaluations / 4, "stored gains not used");
+}
+
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Test suite for the LTE pathloss matrix.
+ */
+class LtePathlossMatrixTestSuite : public TestSuite
+{
+public:
+  LtePathlossMatrixTestSuite ();
+};
+
+static LtePathlossMatrixTestSuite g_ltePathlossMatrixTestSuite;
+
+LtePathlossMatrixTestSuite::LtePathlossMatrixTestSuite ()
+  : TestSuite ("lte-pathloss-matrix", SYSTEM)
+{
+  AddTestCase (new LtePathlossMatrixTestCase, TestCase::QUICK);
+  AddTestCase (new LtePathlossMatrixSinrTestCase (1), TestCase::QUICK);
+  AddTestCase (new LtePathlossMatrixSinrTestCase (2), TestCase::QUICK);
+}
@@ -0,0 +1,229 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <fstream>
+#include <vector>
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/double.h"
+#include "ns3/integer.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/string.h"
+#include "ns3/enum.h"
+#include "ns3/pointer.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/position-allocator.h"
+#include "ns3/lte-helper.h"
+#include "ns3/radio-environment-map-helper.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteTestRadioEnvironmentMap");
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Test that the analytical REM matches the REM measured by
+ * simulating the control frames of the eNBs, whatever the number of
+ * threads and the output format.
+ */
+class LteRadioEnvironmentMapTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   *
+   * \param name reference name
+   * \param antenna the type of the eNB antennas
+   * \param rbId the RB for which the REM is generated, or -1
+   */
+  LteRadioEnvironmentMapTestCase (std::string name, std::string antenna, int32_t rbId);
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Generate a REM of the test scenario
+   *
+   * \param filename the output file
+   * \param analytical true to compute the REM analytically
+   * \param numThreads the number of threads of the analytical REM
+   * \param format the format of the output file
+   */
+  void GenerateRem (std::string filename, bool analytical, uint32_t numThreads,
+                    RadioEnvironmentMapHelper::OutputFormat format);
+  /**
+   * Read a REM in the text format
+   *
+   * \param filename the REM file
+   * \return the SINR of the points
+   */
+  std::vector<double> ReadTextRem (std::string filename);
+  /**
+   * Read a REM in the binary format
+   *
+   * \param filename the REM file
+   * \return the SINR of the points
+   */
+  std::vector<double> ReadBinaryRem (std::string filename);
+
+  std::string m_antenna; ///< the type of the eNB antennas
+  int32_t m_rbId;        ///< the RB for which the REM is generated
+};
+
+LteRadioEnvironmentMapTestCase::LteRadioEnvironmentMapTestCase (std::string name, std::string antenna, int32_t rbId)
+  : TestCase (name),
+    m_antenna (antenna),
+    m_rbId (rbId)
+{
+}
+
+void
+LteRadioEnvironmentMapTestCase::GenerateRem (std::string filename, bool analytical, uint32_t numThreads,
+                                             RadioEnvironmentMapHelper::OutputFormat format)
+{
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  lteHelper->SetEnbAntennaModelType (m_antenna);
+
+  NodeContainer enbNodes;
+  enbNodes.Create (3);
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0.0, 0.0, 30.0));
+  positionAlloc->Add (Vector (600.0, 0.0, 30.0));
+  positionAlloc->Add (Vector (300.0, 500.0, 30.0));
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.Install (enbNodes);
+  for (uint32_t i = 0; i < enbNodes.GetN (); ++i)
+    {
+      if (m_antenna != "ns3::IsotropicAntennaModel")
+        {
+          lteHelper->SetEnbAntennaModelAttribute ("Orientation", DoubleValue (120.0 * i));
+        }
+      lteHelper->InstallEnbDevice (enbNodes.Get (i));
+    }
+
+  Ptr<RadioEnvironmentMapHelper> remHelper = CreateObject<RadioEnvironmentMapHelper> ();
+  remHelper->SetAttribute ("Channel", PointerValue (lteHelper->GetDownlinkSpectrumChannel ()));
+  remHelper->SetAttribute ("OutputFile", StringValue (filename));
+  remHelper->SetAttribute ("XMin", DoubleValue (-200.0));
+  remHelper->SetAttribute ("XMax", DoubleValue (800.0));
+  remHelper->SetAttribute ("XRes", UintegerValue (21));
+  remHelper->SetAttribute ("YMin", DoubleValue (-200.0));
+  remHelper->SetAttribute ("YMax", DoubleValue (700.0));
+  remHelper->SetAttribute ("YRes", UintegerValue (19));
+  remHelper->SetAttribute ("Z", DoubleValue (1.5));
+  remHelper->SetAttribute ("MaxPointsPerIteration", UintegerValue (100));
+  remHelper->SetAttribute ("RbId", IntegerValue (m_rbId));
+  remHelper->SetAttribute ("Analytical", BooleanValue (analytical));
+  remHelper->SetAttribute ("NumThreads", UintegerValue (numThreads));
+  remHelper->SetAttribute ("OutputFormat", EnumValue (format));
+  remHelper->Install ();
+
+  Simulator::Stop (Seconds (1));
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+std::vector<double>
+LteRadioEnvironmentMapTestCase::ReadTextRem (std::string filename)
+{
+  std::vector<double> sinr;
+  std::ifstream file (filename.c_str ());
+  double x, y, z, s;
+  while (file >> x >> y >> z >> s)
+    {
+      sinr.push_back (s);
+    }
+  return sinr;
+}
+
+std::vector<double>
+LteRadioEnvironmentMapTestCase::ReadBinaryRem (std::string filename)
+{
+  std::vector<double> sinr;
+  std::ifstream file (filename.c_str (), std::ios::in | std::ios::binary);
+  char magic[8];
+  uint32_t res[2];
+  double bounds[5];
+  file.read (magic, sizeof (magic));
+  file.read (reinterpret_cast<char *> (res), sizeof (res));
+  file.read (reinterpret_cast<char *> (bounds), sizeof (bounds));
+  NS_TEST_EXPECT_MSG_EQ (std::string (magic, sizeof (magic)), "NS3REM01", "wrong binary REM header");
+  NS_TEST_EXPECT_MSG_EQ (res[0], 21, "wrong x resolution");
+  NS_TEST_EXPECT_MSG_EQ (res[1], 19, "wrong y resolution");
+  NS_TEST_EXPECT_MSG_EQ (bounds[4], 1.5, "wrong z coordinate");
+  double s;
+  while (file.read (reinterpret_cast<char *> (&s), sizeof (s)))
+    {
+      sinr.push_back (s);
+    }
+  return sinr;
+}
+
+void
+LteRadioEnvironmentMapTestCase::DoRun (void)
+{
+  GenerateRem (CreateTempDirFilename ("rem-simulated.out"), false, 1, RadioEnvironmentMapHelper::TEXT);
+  GenerateRem (CreateTempDirFilename ("rem-analytical.out"), true, 1, RadioEnvironmentMapHelper::TEXT);
+  GenerateRem (CreateTempDirFilename ("rem-analytical.bin"), true, 3, RadioEnvironmentMapHelper::BINARY);
+
+  std::vector<double> simulated = ReadTextRem (CreateTempDirFilename ("rem-simulated.out"));
+  std::vector<double> analytical = ReadTextRem (CreateTempDirFilename ("rem-analytical.out"));
+  std::vector<double> binary = ReadBinaryRem (CreateTempDirFilename ("rem-analytical.bin"));
+
+  NS_TEST_ASSERT_MSG_EQ (simulated.size (), 21 * 19, "wrong number of simulated points");
+  NS_TEST_ASSERT_MSG_EQ (analytical.size (), simulated.size (), "wrong number of analytical points");
+  NS_TEST_ASSERT_MSG_EQ (binary.size (), simulated.size (), "wrong number of binary points");
+  for (std::size_t i = 0; i < simulated.size (); ++i)
+    {
+      // the text format has 6 significant digits
+      NS_TEST_ASSERT_MSG_EQ_TOL (analytical[i], simulated[i], simulated[i] * 1e-5,
+                                 "analytical SINR differs from simulated SINR at point " << i);
+      NS_TEST_ASSERT_MSG_EQ_TOL (binary[i], analytical[i], analytical[i] * 1e-5,
+                                 "binary SINR differs from text SINR at point " << i);
+    }
+}
+
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Test suite for the Radio Environment Maps.
+ */
+class LteRadioEnvironmentMapTestSuite : public TestSuite
+{
+public:
+  LteRadioEnvironmentMapTestSuite ();
+};
+
+static LteRadioEnvironmentMapTestSuite g_lteRadioEnvironmentMapTestSuite;
+
+LteRadioEnvironmentMapTestSuite::LteRadioEnvironmentMapTestSuite ()
+  : TestSuite ("lte-radio-environment-map", SYSTEM)
+{
+  AddTestCase (new LteRadioEnvironmentMapTestCase ("isotropic, all RBs", "ns3::IsotropicAntennaModel", -1), TestCase::QUICK);
+  AddTestCase (new LteRadioEnvironmentMapTestCase ("cosine, all RBs", "ns3::CosineAntennaModel", -1), TestCase::QUICK);
+  AddTestCase (new LteRadioEnvironmentMapTestCase ("cosine, RB 10", "ns3::CosineAntennaModel", 10), TestCase::QUICK);
+}
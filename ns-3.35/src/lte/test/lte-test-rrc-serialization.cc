@@ -0,0 +1,341 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <vector>
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/config.h"
+#include "ns3/double.h"
+#include "ns3/boolean.h"
+#include "ns3/nstime.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/position-allocator.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/point-to-point-epc-helper.h"
+#include "ns3/lte-helper.h"
+#include "ns3/lte-common.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteTestRrcSerialization");
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Test that a simulation with connection establishment, measurement
+ * reports and an X2 handover gives the same signaling PDUs and PHY
+ * transmissions whether the RRC messages are serialized or not.
+ */
+class LteRrcSerializationTestCase : public TestCase
+{
+public:
+  LteRrcSerializationTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /// A transport block sent by a PHY
+  struct TransmissionRecord
+  {
+    int64_t time;    ///< time of the transmission, in ms
+    uint16_t cellId; ///< cell ID
+    uint16_t rnti;   ///< RNTI
+    uint8_t mcs;     ///< MCS
+    uint16_t size;   ///< size of the transport block
+  };
+
+  /// A signaling PDU sent or received by the UE
+  struct PduRecord
+  {
+    int64_t time;  ///< time of the event, in ns
+    uint16_t rnti; ///< RNTI
+    uint8_t lcid;  ///< logical channel ID
+    uint32_t size; ///< size of the PDU
+  };
+
+  /// The traces of a run
+  struct Traces
+  {
+    std::vector<TransmissionRecord> dl; ///< the DL transmissions of the eNBs
+    std::vector<TransmissionRecord> ul; ///< the UL transmissions of the UE
+    std::vector<PduRecord> txPdus;      ///< the signaling PDUs sent by the UE
+    std::vector<PduRecord> rxPdus;      ///< the signaling PDUs received by the UE
+    uint32_t handovers;                 ///< the number of successful handovers
+  };
+
+  /**
+   * Run the test scenario
+   *
+   * \param serializeMessages the value of the `SerializeMessages` attributes
+   * \param [out] traces the traces of the run
+   */
+  void RunScenario (bool serializeMessages, Traces *traces);
+
+  /**
+   * Record a transmission
+   *
+   * \param records the records
+   * \param params the parameters of the transmission
+   */
+  static void PhyTransmission (std::vector<TransmissionRecord> *records, PhyTransmissionStatParameters params);
+  /**
+   * Record a PDU sent
+   *
+   * \param records the records
+   * \param rnti the RNTI
+   * \param lcid the logical channel ID
+   * \param size the size of the PDU
+   */
+  static void TxPdu (std::vector<PduRecord> *records, uint16_t rnti, uint8_t lcid, uint32_t size);
+  /**
+   * Record a PDU received
+   *
+   * \param records the records
+   * \param rnti the RNTI
+   * \param lcid the logical channel ID
+   * \param size the size of the PDU
+   * \param delay the delay of the PDU
+   */
+  static void RxPdu (std::vector<PduRecord> *records, uint16_t rnti, uint8_t lcid, uint32_t size, uint64_t delay);
+  /**
+   * Connect the traces of the SRB0 of the UE
+   *
+   * \param traces the traces of the run
+   */
+  static void ConnectSrb0 (Traces *traces);
+  /**
+   * Connect the traces of the SRB1 of the UE, which is created again by
+   * each handover
+   *
+   * \param traces the traces of the run
+   * \param imsi the IMSI
+   * \param cellId the cell ID
+   * \param rnti the RNTI
+   */
+  static void Srb1Created (Traces *traces, uint64_t imsi, uint16_t cellId, uint16_t rnti);
+  /**
+   * Count a successful handover
+   *
+   * \param traces the traces of the run
+   * \param imsi the IMSI
+   * \param cellId the target cell ID
+   * \param rnti the RNTI in the target cell
+   */
+  static void HandoverEndOk (Traces *traces, uint64_t imsi, uint16_t cellId, uint16_t rnti);
+
+  /**
+   * Check that two lists of transmissions are equal
+   *
+   * \param records the transmissions
+   * \param reference the expected transmissions
+   * \param direction the direction of the transmissions, for the messages
+   */
+  void CheckTransmissions (const std::vector<TransmissionRecord> &records,
+                           const std::vector<TransmissionRecord> &reference, std::string direction);
+  /**
+   * Check that two lists of PDUs are equal
+   *
+   * \param records the PDUs
+   * \param reference the expected PDUs
+   * \param direction the direction of the PDUs, for the messages
+   */
+  void CheckPdus (const std::vector<PduRecord> &records,
+                  const std::vector<PduRecord> &reference, std::string direction);
+};
+
+LteRrcSerializationTestCase::LteRrcSerializationTestCase ()
+  : TestCase ("Signaling PDUs and PHY transmissions with and without RRC message serialization")
+{
+}
+
+void
+LteRrcSerializationTestCase::PhyTransmission (std::vector<TransmissionRecord> *records, PhyTransmissionStatParameters params)
+{
+  TransmissionRecord record = { params.m_timestamp, params.m_cellId, params.m_rnti, params.m_mcs, params.m_size };
+  records->push_back (record);
+}
+
+void
+LteRrcSerializationTestCase::TxPdu (std::vector<PduRecord> *records, uint16_t rnti, uint8_t lcid, uint32_t size)
+{
+  PduRecord record = { Simulator::Now ().GetNanoSeconds (), rnti, lcid, size };
+  records->push_back (record);
+}
+
+void
+LteRrcSerializationTestCase::RxPdu (std::vector<PduRecord> *records, uint16_t rnti, uint8_t lcid, uint32_t size, uint64_t delay)
+{
+  PduRecord record = { Simulator::Now ().GetNanoSeconds (), rnti, lcid, size };
+  records->push_back (record);
+}
+
+void
+LteRrcSerializationTestCase::ConnectSrb0 (Traces *traces)
+{
+  Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/LteUeRrc/Srb0/LteRlc/TxPDU",
+                                 MakeBoundCallback (&LteRrcSerializationTestCase::TxPdu, &traces->txPdus));
+  Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/LteUeRrc/Srb0/LteRlc/RxPDU",
+                                 MakeBoundCallback (&LteRrcSerializationTestCase::RxPdu, &traces->rxPdus));
+}
+
+void
+LteRrcSerializationTestCase::Srb1Created (Traces *traces, uint64_t imsi, uint16_t cellId, uint16_t rnti)
+{
+  Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/LteUeRrc/Srb1/LtePdcp/TxPDU",
+                                 MakeBoundCallback (&LteRrcSerializationTestCase::TxPdu, &traces->txPdus));
+  Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/LteUeRrc/Srb1/LtePdcp/RxPDU",
+                                 MakeBoundCallback (&LteRrcSerializationTestCase::RxPdu, &traces->rxPdus));
+}
+
+void
+LteRrcSerializationTestCase::HandoverEndOk (Traces *traces, uint64_t imsi, uint16_t cellId, uint16_t rnti)
+{
+  traces->handovers++;
+}
+
+void
+LteRrcSerializationTestCase::RunScenario (bool serializeMessages, Traces *traces)
+{
+  Config::SetDefault ("ns3::LteUeRrcProtocolReal::SerializeMessages", BooleanValue (serializeMessages));
+  Config::SetDefault ("ns3::LteEnbRrcProtocolReal::SerializeMessages", BooleanValue (serializeMessages));
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  lteHelper->SetAttribute ("UseIdealRrc", BooleanValue (false));
+  Ptr<PointToPointEpcHelper> epcHelper = CreateObject<PointToPointEpcHelper> ();
+  lteHelper->SetEpcHelper (epcHelper);
+  lteHelper->SetHandoverAlgorithmType ("ns3::A3RsrpHandoverAlgorithm");
+
+  NodeContainer enbNodes;
+  enbNodes.Create (2);
+  NodeContainer ueNodes;
+  ueNodes.Create (1);
+
+  Ptr<ListPositionAllocator> enbPositions = CreateObject<ListPositionAllocator> ();
+  enbPositions->Add (Vector (0.0, 0.0, 0.0));
+  enbPositions->Add (Vector (400.0, 0.0, 0.0));
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator (enbPositions);
+  mobility.Install (enbNodes);
+  // the UE moves from the first eNB to the second one
+  mobility.SetMobilityModel ("ns3::ConstantVelocityMobilityModel");
+  mobility.Install (ueNodes);
+  ueNodes.Get (0)->GetObject<MobilityModel> ()->SetPosition (Vector (100.0, 20.0, 0.0));
+  ueNodes.Get (0)->GetObject<ConstantVelocityMobilityModel> ()->SetVelocity (Vector (100.0, 0.0, 0.0));
+
+  NetDeviceContainer enbDevs = lteHelper->InstallEnbDevice (enbNodes);
+  NetDeviceContainer ueDevs = lteHelper->InstallUeDevice (ueNodes);
+  // both runs must draw the same random values
+  int64_t stream = 1;
+  stream += lteHelper->AssignStreams (enbDevs, stream);
+  lteHelper->AssignStreams (ueDevs, stream);
+
+  InternetStackHelper internet;
+  internet.Install (ueNodes);
+  epcHelper->AssignUeIpv4Address (ueDevs);
+  lteHelper->AddX2Interface (enbNodes);
+  lteHelper->Attach (ueDevs.Get (0), enbDevs.Get (0));
+
+  Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/ComponentCarrierMap/*/LteEnbPhy/DlPhyTransmission",
+                                 MakeBoundCallback (&LteRrcSerializationTestCase::PhyTransmission, &traces->dl));
+  Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/ComponentCarrierMapUe/*/LteUePhy/UlPhyTransmission",
+                                 MakeBoundCallback (&LteRrcSerializationTestCase::PhyTransmission, &traces->ul));
+  traces->handovers = 0;
+  Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/LteUeRrc/HandoverEndOk",
+                                 MakeBoundCallback (&LteRrcSerializationTestCase::HandoverEndOk, traces));
+  Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/LteUeRrc/Srb1Created",
+                                 MakeBoundCallback (&LteRrcSerializationTestCase::Srb1Created, traces));
+  // the SRB0 of the UE is created when the UE RRC is initialized
+  Simulator::Schedule (MilliSeconds (1), &LteRrcSerializationTestCase::ConnectSrb0, traces);
+
+  Simulator::Stop (Seconds (3.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  Config::Reset ();
+}
+
+void
+LteRrcSerializationTestCase::CheckTransmissions (const std::vector<TransmissionRecord> &records,
+                                                 const std::vector<TransmissionRecord> &reference, std::string direction)
+{
+  NS_TEST_ASSERT_MSG_GT (reference.size (), 0, "no " << direction << " transmission");
+  NS_TEST_ASSERT_MSG_EQ (records.size (), reference.size (), "wrong number of " << direction << " transmissions");
+  for (std::size_t i = 0; i < records.size (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (records[i].time, reference[i].time, "wrong " << direction << " transmission time");
+      NS_TEST_ASSERT_MSG_EQ (records[i].cellId, reference[i].cellId, "wrong " << direction << " transmission cell");
+      NS_TEST_ASSERT_MSG_EQ (records[i].rnti, reference[i].rnti, "wrong " << direction << " transmission RNTI");
+      NS_TEST_ASSERT_MSG_EQ ((uint16_t) records[i].mcs, (uint16_t) reference[i].mcs, "wrong " << direction << " MCS");
+      NS_TEST_ASSERT_MSG_EQ (records[i].size, reference[i].size, "wrong " << direction << " transport block size");
+    }
+}
+
+void
+LteRrcSerializationTestCase::CheckPdus (const std::vector<PduRecord> &records,
+                                        const std::vector<PduRecord> &reference, std::string direction)
+{
+  NS_TEST_ASSERT_MSG_GT (reference.size (), 0, "no " << direction << " PDU");
+  NS_TEST_ASSERT_MSG_EQ (records.size (), reference.size (), "wrong number of " << direction << " PDUs");
+  for (std::size_t i = 0; i < records.size (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (records[i].time, reference[i].time, "wrong " << direction << " PDU time");
+      NS_TEST_ASSERT_MSG_EQ (records[i].rnti, reference[i].rnti, "wrong " << direction << " PDU RNTI");
+      NS_TEST_ASSERT_MSG_EQ ((uint16_t) records[i].lcid, (uint16_t) reference[i].lcid, "wrong " << direction << " PDU LCID");
+      NS_TEST_ASSERT_MSG_EQ (records[i].size, reference[i].size, "wrong " << direction << " PDU size");
+    }
+}
+
+void
+LteRrcSerializationTestCase::DoRun (void)
+{
+  Traces reference;
+  RunScenario (true, &reference);
+  Traces traces;
+  RunScenario (false, &traces);
+
+  NS_TEST_ASSERT_MSG_EQ (reference.handovers, 1, "handover not completed");
+  NS_TEST_ASSERT_MSG_EQ (traces.handovers, reference.handovers, "wrong number of handovers");
+  CheckPdus (traces.txPdus, reference.txPdus, "sent");
+  CheckPdus (traces.rxPdus, reference.rxPdus, "received");
+  CheckTransmissions (traces.dl, reference.dl, "DL");
+  CheckTransmissions (traces.ul, reference.ul, "UL");
+}
+
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Test suite for the RRC messages which are not serialized.
+ */
+class LteRrcSerializationTestSuite : public TestSuite
+{
+public:
+  LteRrcSerializationTestSuite ();
+};
+
+static LteRrcSerializationTestSuite g_lteRrcSerializationTestSuite;
+
+LteRrcSerializationTestSuite::LteRrcSerializationTestSuite ()
+  : TestSuite ("lte-rrc-serialization", SYSTEM)
+{
+  AddTestCase (new LteRrcSerializationTestCase, TestCase::QUICK);
+}
@@ -75,6 +75,22 @@ RecvMeasurementReportCallback (LteUeMeasurementsTestCase *testcase,
   testcase->RecvMeasurementReport (imsi, cellId, rnti, meas);
 }
 
+void
+ReportUeMeasurementsThresholdCallback (LteUeMeasurementsRsrpThresholdTestCase *testcase,
+                                       std::string path, uint16_t rnti, uint16_t cellId,
+                                       double rsrp, double rsrq, bool servingCell, uint8_t componentCarrierId)
+{
+  testcase->ReportUeMeasurements (rnti, cellId, rsrp, rsrq, servingCell);
+}
+
+void
+RecvMeasurementReportThresholdCallback (LteUeMeasurementsRsrpThresholdTestCase *testcase,
+                                        std::string path, uint64_t imsi, uint16_t cellId,
+                                        uint16_t rnti, LteRrcSap::MeasurementReport meas)
+{
+  testcase->RecvMeasurementReport (imsi, cellId, rnti, meas);
+}
+
 
 /*
  * Test Suite
@@ -102,6 +118,9 @@ LteUeMeasurementsTestSuite::LteUeMeasurementsTestSuite ()
   AddTestCase (new LteUeMeasurementsTestCase ("d1=200000, d2=10000",  200000.000000, 10000.000000, -139.760302, -113.739702, -29.502549, -3.481949), TestCase::EXTENSIVE);
   AddTestCase (new LteUeMeasurementsTestCase ("d1=500000, d2=10000",  500000.000000, 10000.000000, -147.719102, -113.739702, -37.453160, -3.473760), TestCase::EXTENSIVE);
   AddTestCase (new LteUeMeasurementsTestCase ("d1=1000000, d2=10000",  1000000.000000, 10000.000000, -153.739702, -113.739702, -43.472589, -3.472589), TestCase::EXTENSIVE);
+
+  AddTestCase (new LteUeMeasurementsRsrpThresholdTestCase ("RSRP threshold disabled", -1000.0, true), TestCase::QUICK);
+  AddTestCase (new LteUeMeasurementsRsrpThresholdTestCase ("RSRP threshold between the cells", -110.0, false), TestCase::QUICK);
 }
 
 static LteUeMeasurementsTestSuite lteUeMeasurementsTestSuite;
@@ -277,6 +296,123 @@ LteUeMeasurementsTestCase::RecvMeasurementReport (uint64_t imsi, uint16_t cellId
 }
 
 
+/*
+ * RSRP Threshold Test Case
+ */
+
+LteUeMeasurementsRsrpThresholdTestCase::LteUeMeasurementsRsrpThresholdTestCase (std::string name,
+                                                                                double threshold,
+                                                                                bool neighborReported)
+  : TestCase (name),
+    m_threshold (threshold),
+    m_neighborReported (neighborReported),
+    m_nServingPhyReports (0),
+    m_nNeighborPhyReports (0),
+    m_nRrcReports (0),
+    m_nNeighborRrcReports (0)
+{
+  NS_LOG_INFO ("Test UE Measurements with RSRP threshold " << threshold << " dBm");
+}
+
+LteUeMeasurementsRsrpThresholdTestCase::~LteUeMeasurementsRsrpThresholdTestCase ()
+{}
+
+void
+LteUeMeasurementsRsrpThresholdTestCase::DoRun (void)
+{
+  NS_LOG_INFO (this << " " << GetName ());
+
+  Config::SetDefault ("ns3::LteSpectrumPhy::CtrlErrorModelEnabled", BooleanValue (false));
+  Config::SetDefault ("ns3::LteSpectrumPhy::DataErrorModelEnabled", BooleanValue (false));
+  Config::SetDefault ("ns3::LteUePhy::EnableUplinkPowerControl", BooleanValue (false));
+  Config::SetDefault ("ns3::LteUePhy::RsrpUeMeasThreshold", DoubleValue (m_threshold));
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  lteHelper->SetAttribute ("PathlossModel", StringValue ("ns3::FriisSpectrumPropagationLossModel"));
+  lteHelper->SetAttribute ("UseIdealRrc", BooleanValue (false));
+
+  // the topology of LteUeMeasurementsTestCase, with d1 = 5000 m and d2 = 10000 m
+  double d1 = 5000.0;
+  double d2 = 10000.0;
+  NodeContainer enbNodes;
+  NodeContainer ueNodes;
+  enbNodes.Create (2);
+  ueNodes.Create (2);
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0.0, 0.0, 0.0)); // eNB1
+  positionAlloc->Add (Vector (d2, d1, 0.0));   // eNB2
+  positionAlloc->Add (Vector (0.0, d1, 0.0));  // UE1
+  positionAlloc->Add (Vector (d2, 0.0, 0.0));  // UE2
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.Install (NodeContainer (enbNodes, ueNodes));
+
+  lteHelper->SetSchedulerType ("ns3::RrFfMacScheduler");
+  NetDeviceContainer enbDevs = lteHelper->InstallEnbDevice (enbNodes);
+  NetDeviceContainer ueDevs = lteHelper->InstallUeDevice (ueNodes);
+  lteHelper->Attach (ueDevs.Get (0), enbDevs.Get (0));
+  lteHelper->Attach (ueDevs.Get (1), enbDevs.Get (1));
+  EpsBearer bearer (EpsBearer::GBR_CONV_VOICE);
+  lteHelper->ActivateDataRadioBearer (ueDevs, bearer);
+
+  Config::Connect ("/NodeList/*/DeviceList/0/ComponentCarrierMapUe/0/LteUePhy/ReportUeMeasurements",
+                   MakeBoundCallback (&ReportUeMeasurementsThresholdCallback, this));
+  // the eNodeBs request the neighbor cell measurements for ANR (event A4)
+  Config::Connect ("/NodeList/*/DeviceList/0/LteEnbRrc/RecvMeasurementReport",
+                   MakeBoundCallback (&RecvMeasurementReportThresholdCallback, this));
+
+  Simulator::Stop (Seconds (0.800));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  // restore the default value for the other test cases
+  Config::SetDefault ("ns3::LteUePhy::RsrpUeMeasThreshold", DoubleValue (-1000.0));
+
+  NS_TEST_ASSERT_MSG_GT (m_nServingPhyReports, 0, "The serving cell should be reported by the PHY");
+  if (m_neighborReported)
+    {
+      NS_TEST_ASSERT_MSG_GT (m_nRrcReports, 0, "The eNodeBs should receive measurement reports");
+      NS_TEST_ASSERT_MSG_GT (m_nNeighborPhyReports, 0, "The neighbor cell should be reported by the PHY");
+      NS_TEST_ASSERT_MSG_GT (m_nNeighborRrcReports, 0, "The neighbor cell should be in the measurement reports");
+    }
+  else
+    {
+      // the reports are triggered by the neighbor cell, so none is expected
+      NS_TEST_ASSERT_MSG_EQ (m_nRrcReports, 0, "The eNodeBs received measurement reports");
+      NS_TEST_ASSERT_MSG_EQ (m_nNeighborPhyReports, 0, "The neighbor cell is below the threshold but reported by the PHY");
+      NS_TEST_ASSERT_MSG_EQ (m_nNeighborRrcReports, 0, "The neighbor cell is below the threshold but in the measurement reports");
+    }
+}
+
+void
+LteUeMeasurementsRsrpThresholdTestCase::ReportUeMeasurements (uint16_t rnti, uint16_t cellId,
+                                                              double rsrp, double rsrq,
+                                                              bool servingCell)
+{
+  NS_LOG_DEBUG ("RNTI " << rnti << " cellId " << cellId << " RSRP " << rsrp << " serving " << servingCell);
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (rsrp, m_threshold, "Cell " << cellId << " reported below the threshold");
+  if (servingCell)
+    {
+      m_nServingPhyReports++;
+    }
+  else
+    {
+      m_nNeighborPhyReports++;
+    }
+}
+
+void
+LteUeMeasurementsRsrpThresholdTestCase::RecvMeasurementReport (uint64_t imsi, uint16_t cellId, uint16_t rnti,
+                                                               LteRrcSap::MeasurementReport meas)
+{
+  m_nRrcReports++;
+  if (meas.measResults.haveMeasResultNeighCells)
+    {
+      m_nNeighborRrcReports += meas.measResults.measResultListEutra.size ();
+    }
+}
+
+
 // ===== LTE-UE-MEASUREMENTS-PIECEWISE-1 TEST SUITE ======================== //
 
 /*
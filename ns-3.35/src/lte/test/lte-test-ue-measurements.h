@@ -116,6 +116,62 @@ private:
 
 
 
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Test that the cells whose RSRP is below the RsrpUeMeasThreshold
+ * attribute of LteUePhy are neither reported by the PHY nor sent to the
+ * RRC, in the scenario of LteUeMeasurementsTestCase with d1 = 5000 m and
+ * d2 = 10000 m: the serving cell is received at -107.7 dBm and the
+ * neighbor cell at -113.7 dBm.
+ */
+class LteUeMeasurementsRsrpThresholdTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   *
+   * \param name the reference name
+   * \param threshold the RsrpUeMeasThreshold of the UEs, in dBm
+   * \param neighborReported true if the neighbor cell should be reported
+   */
+  LteUeMeasurementsRsrpThresholdTestCase (std::string name, double threshold, bool neighborReported);
+  virtual ~LteUeMeasurementsRsrpThresholdTestCase ();
+
+  /**
+   * Report UE measurements function
+   * \param rnti the RNTI
+   * \param cellId the cell ID
+   * \param rsrp the RSRP
+   * \param rsrq the RSRQ
+   * \param servingCell the serving cell
+   */
+  void ReportUeMeasurements (uint16_t rnti, uint16_t cellId, double rsrp, double rsrq, bool servingCell);
+
+  /**
+   * Receive measurement report function
+   * \param imsi the IMSI
+   * \param cellId the cell ID
+   * \param rnti the RNTI
+   * \param meas LteRrcSap::MeasurementReport
+   */
+  void RecvMeasurementReport (uint64_t imsi, uint16_t cellId, uint16_t rnti, LteRrcSap::MeasurementReport meas);
+
+private:
+  virtual void DoRun (void);
+
+  double m_threshold;            ///< RsrpUeMeasThreshold of the UEs, in dBm
+  bool m_neighborReported;       ///< true if the neighbor cell should be reported
+  uint32_t m_nServingPhyReports; ///< number of serving cell measurements reported by the PHY
+  uint32_t m_nNeighborPhyReports; ///< number of neighbor cell measurements reported by the PHY
+  uint32_t m_nRrcReports;        ///< number of measurement reports received by the eNodeBs
+  uint32_t m_nNeighborRrcReports; ///< number of neighbor cell results in these reports
+
+};
+
+
+
 // ===== LTE-UE-MEASUREMENTS-PIECEWISE-1 TEST SUITE ======================== //
 
 
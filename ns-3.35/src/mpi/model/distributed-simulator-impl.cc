@@ -646,4 +646,10 @@ DistributedSimulatorImpl::GetEventCount (void) const
   return m_eventCount;
 }
 
+uint64_t
+DistributedSimulatorImpl::GetPendingEventCount (void) const
+{
+  return m_unscheduledEvents;
+}
+
 } // namespace ns3
@@ -576,6 +576,12 @@ NullMessageSimulatorImpl::GetEventCount (void) const
   return m_eventCount;
 }
 
+uint64_t
+NullMessageSimulatorImpl::GetPendingEventCount (void) const
+{
+  return m_unscheduledEvents;
+}
+
 Time NullMessageSimulatorImpl::CalculateGuaranteeTime (uint32_t nodeSysId)
 {
   Ptr<RemoteChannelBundle> bundle = RemoteChannelBundleManager::Find (nodeSysId);
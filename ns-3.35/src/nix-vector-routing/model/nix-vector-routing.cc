@@ -25,12 +25,20 @@
 
 #include <queue>
 #include <iomanip>
+#include <limits>
 
 #include "ns3/log.h"
 #include "ns3/abort.h"
 #include "ns3/names.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "ns3/global-value.h"
 #include "ns3/ipv4-list-routing.h"
 #include "ns3/loopback-net-device.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-thread.h"
+#endif
 
 #include "nix-vector-routing.h"
 
@@ -44,12 +52,41 @@ NS_OBJECT_TEMPLATE_CLASS_DEFINE (NixVectorRouting, Ipv6RoutingProtocol);
 template <typename T>
 bool NixVectorRouting<T>::g_isCacheDirty = false;
 
+template <typename T>
+bool NixVectorRouting<T>::g_isResetScheduled = false;
+
 template <typename T>
 typename NixVectorRouting<T>::IpAddressToNodeMap NixVectorRouting<T>::g_ipAddressToNodeMap;
 
 template <typename T>
 typename NixVectorRouting<T>::NetDeviceToIpInterfaceMap NixVectorRouting<T>::g_netdeviceToIpInterfaceMap;
 
+template <typename T>
+std::set<uint32_t> NixVectorRouting<T>::g_dirtyNodes;
+
+template <typename T>
+std::unordered_map<uint32_t, typename NixVectorRouting<T>::NixTree> NixVectorRouting<T>::g_treeCache;
+
+template <typename T>
+std::list<uint32_t> NixVectorRouting<T>::g_treeCacheLru;
+
+template <typename T>
+typename NixVectorRouting<T>::NixGraph NixVectorRouting<T>::g_graph;
+
+/**
+ * \ingroup nix-vector-routing
+ * \brief The maximum number of BFS trees shared by the nix-vector routing instances.
+ */
+static GlobalValue g_nixVectorTreeCacheSize = GlobalValue ("NixVectorTreeCacheSize",
+                                                           "The maximum number of BFS trees towards "
+                                                           "a destination shared by all the nix-vector "
+                                                           "routing instances. 0 means no limit.",
+                                                           UintegerValue (0),
+                                                           MakeUintegerChecker<uint32_t> ());
+
+/// Marks a node which is not reachable in a BFS tree
+static const uint32_t NIX_NO_NEXT_HOP = std::numeric_limits<uint32_t>::max ();
+
 template <typename T>
 TypeId 
 NixVectorRouting<T>::GetTypeId (void)
@@ -60,15 +97,29 @@ NixVectorRouting<T>::GetTypeId (void)
     .SetParent<T> ()
     .SetGroupName ("NixVectorRouting")
     .template AddConstructor<NixVectorRouting<T> > ()
+    .AddAttribute ("MaxCacheSize",
+                   "The maximum number of destinations in the nix-vector cache and in "
+                   "the route cache of a node. When a cache is full, the least recently "
+                   "used destination is evicted. 0 means no limit.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&NixVectorRouting<T>::m_maxCacheSize),
+                   MakeUintegerChecker<uint32_t> ())
   ;
   return tid;
 }
 
 template <typename T>
 NixVectorRouting<T>::NixVectorRouting ()
-  : m_totalNeighbors (0)
+  : m_maxCacheSize (0),
+    m_totalNeighbors (0)
 {
   NS_LOG_FUNCTION_NOARGS ();
+
+  if (!g_isResetScheduled)
+    {
+      Simulator::ScheduleDestroy (&NixVectorRouting<T>::ResetGlobalState);
+      g_isResetScheduled = true;
+    }
 }
 
 template <typename T>
@@ -158,6 +209,125 @@ NixVectorRouting<T>::FlushGlobalNixRoutingCache (void) const
   // IP address to node mapping is potentially invalid so clear it.
   // Will be repopulated in lazy evaluation when mapping is needed.
   g_ipAddressToNodeMap.clear ();
+
+  // the BFS trees and the graph are rebuilt when needed
+  g_treeCache.clear ();
+  g_treeCacheLru.clear ();
+  g_graph.valid = false;
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::InvalidateDirtyNodes (void) const
+{
+  NS_LOG_FUNCTION_NOARGS ();
+
+  // the trees with an edge between two dirty nodes may use the channel
+  // that went down
+  for (auto it = g_treeCache.begin (); it != g_treeCache.end (); )
+    {
+      bool valid = true;
+      for (std::set<uint32_t>::const_iterator node = g_dirtyNodes.begin (); node != g_dirtyNodes.end (); node++)
+        {
+          uint32_t nextHop = it->second.nextHop.at (*node);
+          if (nextHop != *node && g_dirtyNodes.count (nextHop))
+            {
+              valid = false;
+              break;
+            }
+        }
+      if (valid)
+        {
+          it++;
+        }
+      else
+        {
+          NS_LOG_LOGIC ("Invalidating the BFS tree towards node " << it->first);
+          g_treeCacheLru.erase (it->second.lruIterator);
+          it = g_treeCache.erase (it);
+        }
+    }
+  g_graph.valid = false;
+
+  // the neighbor indexes of the dirty nodes changed, so that the
+  // nix-vectors crossing them are not valid anymore
+  NodeList::Iterator listEnd = NodeList::End ();
+  for (NodeList::Iterator i = NodeList::Begin (); i != listEnd; i++)
+    {
+      Ptr<Node> node = *i;
+      Ptr<NixVectorRouting<T> > rp = node->GetObject<NixVectorRouting> ();
+      if (!rp)
+        {
+          continue;
+        }
+      if (g_dirtyNodes.count (node->GetId ()))
+        {
+          rp->FlushIpRouteCache ();
+          rp->m_totalNeighbors = 0;
+        }
+      for (typename NixMap_t::iterator it = rp->m_nixCache.begin (); it != rp->m_nixCache.end (); )
+        {
+          bool valid = true;
+          for (uint32_t j = 0; j < it->second.path.size (); j++)
+            {
+              if (g_dirtyNodes.count (it->second.path[j]))
+                {
+                  valid = false;
+                  break;
+                }
+            }
+          if (valid)
+            {
+              it++;
+              continue;
+            }
+          NS_LOG_LOGIC ("Invalidating the nix-vector towards " << it->first << " on node " << node->GetId ());
+          typename IpRouteMap_t::iterator route = rp->m_ipRouteCache.find (it->first);
+          if (route != rp->m_ipRouteCache.end ())
+            {
+              rp->m_ipRouteCacheLru.erase (route->second.lruIterator);
+              rp->m_ipRouteCache.erase (route);
+            }
+          rp->m_nixCacheLru.erase (it->second.lruIterator);
+          it = rp->m_nixCache.erase (it);
+        }
+    }
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::MarkInterfaceDirty (uint32_t interface)
+{
+  NS_LOG_FUNCTION (this << interface);
+
+  if (!m_node || !m_ip)
+    {
+      g_isCacheDirty = true;
+      return;
+    }
+  Ptr<NetDevice> device = m_ip->GetNetDevice (interface);
+  if (device->IsBridge () || NetDeviceIsBridged (device))
+    {
+      // the neighbors of all the bridged channels are affected
+      g_isCacheDirty = true;
+      return;
+    }
+  g_dirtyNodes.insert (m_node->GetId ());
+  Ptr<Channel> channel = device->GetChannel ();
+  if (channel == 0)
+    {
+      return;
+    }
+  for (std::size_t i = 0; i < channel->GetNDevices (); i++)
+    {
+      Ptr<NetDevice> remoteDevice = channel->GetDevice (i);
+      if (NetDeviceIsBridged (remoteDevice))
+        {
+          g_isCacheDirty = true;
+          return;
+        }
+      g_dirtyNodes.insert (remoteDevice->GetNode ()->GetId ());
+    }
 }
 
 template <typename T>
@@ -166,6 +336,7 @@ NixVectorRouting<T>::FlushNixCache (void) const
 {
   NS_LOG_FUNCTION_NOARGS ();
   m_nixCache.clear ();
+  m_nixCacheLru.clear ();
 }
 
 template <typename T>
@@ -174,15 +345,18 @@ NixVectorRouting<T>::FlushIpRouteCache (void) const
 {
   NS_LOG_FUNCTION_NOARGS ();
   m_ipRouteCache.clear ();
+  m_ipRouteCacheLru.clear ();
 }
 
 template <typename T>
 Ptr<NixVector>
-NixVectorRouting<T>::GetNixVector (Ptr<Node> source, IpAddress dest, Ptr<NetDevice> oif) const
+NixVectorRouting<T>::GetNixVector (Ptr<Node> source, IpAddress dest, Ptr<NetDevice> oif,
+                                   std::vector<uint32_t> &path) const
 {
   NS_LOG_FUNCTION (this << source << dest << oif);
 
   Ptr<NixVector> nixVector = Create<NixVector> ();
+  path.clear ();
 
   // not in cache, must build the nix vector
   // First, we have to figure out the nodes 
@@ -202,6 +376,18 @@ NixVectorRouting<T>::GetNixVector (Ptr<Node> source, IpAddress dest, Ptr<NetDevi
       NS_LOG_DEBUG ("Do not process packets to self");
       return 0;
     }
+  else if (!oif)
+    {
+      // use the BFS tree towards the destination,
+      // shared by all the sources
+      const std::vector<uint32_t> &nextHop = GetTree (destNode->GetId ());
+      if (BuildNixVectorFromTree (nextHop, source->GetId (), destNode->GetId (), nixVector, path))
+        {
+          return nixVector;
+        }
+      NS_LOG_ERROR ("No routing path exists");
+      return 0;
+    }
   else
     {
       // otherwise proceed as normal 
@@ -212,6 +398,11 @@ NixVectorRouting<T>::GetNixVector (Ptr<Node> source, IpAddress dest, Ptr<NetDevi
         {
           if (BuildNixVector (parentVector, source->GetId (), destNode->GetId (), nixVector))
             {
+              for (Ptr<Node> node = destNode; node != source; node = parentVector.at (node->GetId ()))
+                {
+                  path.push_back (node->GetId ());
+                }
+              path.push_back (source->GetId ());
               return nixVector;
             }
           else
@@ -242,7 +433,8 @@ NixVectorRouting<T>::GetNixVectorInCache (const IpAddress &address, bool &foundI
     {
       NS_LOG_LOGIC ("Found Nix-vector in cache.");
       foundInCache = true;
-      return iter->second;
+      m_nixCacheLru.splice (m_nixCacheLru.begin (), m_nixCacheLru, iter->second.lruIterator);
+      return iter->second.nixVector;
     }
 
   // not in cache
@@ -250,25 +442,77 @@ NixVectorRouting<T>::GetNixVectorInCache (const IpAddress &address, bool &foundI
   return 0;
 }
 
+template <typename T>
+void
+NixVectorRouting<T>::AddNixVectorInCache (const IpAddress &address, Ptr<NixVector> nixVector,
+                                          const std::vector<uint32_t> &path) const
+{
+  NS_LOG_FUNCTION (this << address << nixVector);
+
+  typename NixMap_t::iterator iter = m_nixCache.find (address);
+  if (iter != m_nixCache.end ())
+    {
+      m_nixCacheLru.erase (iter->second.lruIterator);
+      m_nixCache.erase (iter);
+    }
+  else if (m_maxCacheSize > 0 && m_nixCache.size () >= m_maxCacheSize)
+    {
+      NS_LOG_LOGIC ("Evicting Nix-vector towards " << m_nixCacheLru.back ());
+      m_nixCache.erase (m_nixCacheLru.back ());
+      m_nixCacheLru.pop_back ();
+    }
+  m_nixCacheLru.push_front (address);
+  NixMapItem &item = m_nixCache[address];
+  item.nixVector = nixVector;
+  item.path = path;
+  item.lruIterator = m_nixCacheLru.begin ();
+}
+
 template <typename T>
 Ptr<typename NixVectorRouting<T>::IpRoute>
-NixVectorRouting<T>::GetIpRouteInCache (IpAddress address)
+NixVectorRouting<T>::GetIpRouteInCache (IpAddress address, uint32_t nixIndex)
 {
-  NS_LOG_FUNCTION (this << address);
+  NS_LOG_FUNCTION (this << address << nixIndex);
 
   CheckCacheStateAndFlush ();
 
   typename IpRouteMap_t::iterator iter = m_ipRouteCache.find (address);
-  if (iter != m_ipRouteCache.end ())
+  if (iter != m_ipRouteCache.end () && iter->second.nixIndex == nixIndex)
     {
       NS_LOG_LOGIC ("Found IpRoute in cache.");
-      return iter->second;
+      m_ipRouteCacheLru.splice (m_ipRouteCacheLru.begin (), m_ipRouteCacheLru, iter->second.lruIterator);
+      return iter->second.route;
     }
 
-  // not in cache
+  // not in cache, or the packet goes through another neighbor
   return 0;
 }
 
+template <typename T>
+void
+NixVectorRouting<T>::AddIpRouteInCache (IpAddress address, Ptr<IpRoute> route, uint32_t nixIndex)
+{
+  NS_LOG_FUNCTION (this << address << route << nixIndex);
+
+  typename IpRouteMap_t::iterator iter = m_ipRouteCache.find (address);
+  if (iter != m_ipRouteCache.end ())
+    {
+      m_ipRouteCacheLru.erase (iter->second.lruIterator);
+      m_ipRouteCache.erase (iter);
+    }
+  else if (m_maxCacheSize > 0 && m_ipRouteCache.size () >= m_maxCacheSize)
+    {
+      NS_LOG_LOGIC ("Evicting IpRoute towards " << m_ipRouteCacheLru.back ());
+      m_ipRouteCache.erase (m_ipRouteCacheLru.back ());
+      m_ipRouteCacheLru.pop_back ();
+    }
+  m_ipRouteCacheLru.push_front (address);
+  IpRouteMapItem &item = m_ipRouteCache[address];
+  item.route = route;
+  item.nixIndex = nixIndex;
+  item.lruIterator = m_ipRouteCacheLru.begin ();
+}
+
 template <typename T>
 bool
 NixVectorRouting<T>::BuildNixVectorLocal (Ptr<NixVector> nixVector)
@@ -315,6 +559,46 @@ NixVectorRouting<T>::BuildNixVector (const std::vector< Ptr<Node> > & parentVect
     }
 
   Ptr<Node> parentNode = parentVector.at (dest);
+  AddNeighborToNixVector (parentNode, dest, nixVector);
+
+  // recurse through T vector, grabbing the path
+  // and building the nix vector
+  BuildNixVector (parentVector, source, (parentVector.at (dest))->GetId (), nixVector);
+  return true;
+}
+
+template <typename T>
+bool
+NixVectorRouting<T>::BuildNixVectorFromTree (const std::vector<uint32_t> & nextHop, uint32_t source, uint32_t dest,
+                                             Ptr<NixVector> nixVector, std::vector<uint32_t> &path) const
+{
+  NS_LOG_FUNCTION (this << source << dest << nixVector);
+
+  if (nextHop.at (source) == NIX_NO_NEXT_HOP)
+    {
+      return false;
+    }
+
+  path.push_back (source);
+  while (path.back () != dest)
+    {
+      path.push_back (nextHop.at (path.back ()));
+    }
+
+  // as done by BuildNixVector, the neighbor indexes are added
+  // from the last hop to the first one
+  for (std::size_t i = path.size () - 1; i > 0; i--)
+    {
+      AddNeighborToNixVector (NodeList::GetNode (path[i - 1]), path[i], nixVector);
+    }
+  return true;
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::AddNeighborToNixVector (Ptr<Node> parentNode, uint32_t dest, Ptr<NixVector> nixVector) const
+{
+  NS_LOG_FUNCTION (this << parentNode << dest << nixVector);
 
   uint32_t numberOfDevices = parentNode->GetNDevices ();
   uint32_t destId = 0;
@@ -365,11 +649,6 @@ NixVectorRouting<T>::BuildNixVector (const std::vector< Ptr<Node> > & parentVect
   NS_LOG_LOGIC ("Adding Nix: " << destId << " with " 
                                << nixVector->BitCount (totalNeighbors) << " bits, for node " << parentNode->GetId ());
   nixVector->AddNeighborIndex (destId, nixVector->BitCount (totalNeighbors));
-
-  // recurse through T vector, grabbing the path
-  // and building the nix vector
-  BuildNixVector (parentVector, source, (parentVector.at (dest))->GetId (), nixVector);
-  return true;
 }
 
 template <typename T>
@@ -734,10 +1013,11 @@ NixVectorRouting<T>::RouteOutput (Ptr<Packet> p, const IpHeader &header, Ptr<Net
       NS_LOG_LOGIC ("Nix-vector not in cache, build: ");
       // Build the nix-vector, given this node and the
       // dest IP address
-      nixVectorInCache = GetNixVector (m_node, destAddress, oif);
+      std::vector<uint32_t> path;
+      nixVectorInCache = GetNixVector (m_node, destAddress, oif, path);
 
       // cache it
-      m_nixCache.insert (typename NixMap_t::value_type (destAddress, nixVectorInCache));
+      AddNixVectorInCache (destAddress, nixVectorInCache, path);
     }
 
   // path exists
@@ -763,20 +1043,12 @@ NixVectorRouting<T>::RouteOutput (Ptr<Packet> p, const IpHeader &header, Ptr<Net
 
       // Search here in a cache for this node index
       // and look for a IpRoute
-      rtentry = GetIpRouteInCache (destAddress);
+      rtentry = GetIpRouteInCache (destAddress, nodeIndex);
 
-      if (!rtentry || !(rtentry->GetOutputDevice () == oif))
+      if (!rtentry || (oif && rtentry->GetOutputDevice () != oif))
         {
           // not in cache or a different specified output
           // device is to be used
-
-          // first, make sure we erase existing (incorrect)
-          // rtentry from the map
-          if (rtentry)
-            {
-              m_ipRouteCache.erase (destAddress);
-            }
-
           NS_LOG_LOGIC ("IpRoute not in cache, build: ");
           IpAddress gatewayIp;
           uint32_t index = FindNetDeviceForNixIndex (m_node, nodeIndex, gatewayIp);
@@ -813,8 +1085,8 @@ NixVectorRouting<T>::RouteOutput (Ptr<Packet> p, const IpHeader &header, Ptr<Net
 
           sockerr = Socket::ERROR_NOTERROR;
 
-          // add rtentry to cache
-          m_ipRouteCache.insert (typename IpRouteMap_t::value_type (destAddress, rtentry));
+          // add rtentry to cache, replacing the existing (incorrect) one
+          AddIpRouteInCache (destAddress, rtentry, nodeIndex);
         }
 
       NS_LOG_LOGIC ("Nix-vector contents: " << *nixVectorInCache << " : Remaining bits: " << nixVectorForPacket->GetRemainingBits ());
@@ -914,7 +1186,7 @@ NixVectorRouting<T>::RouteInput (Ptr<const Packet> p, const IpHeader &header, Pt
   uint32_t numberOfBits = nixVector->BitCount (m_totalNeighbors);
   uint32_t nodeIndex = nixVector->ExtractNeighborIndex (numberOfBits);
 
-  rtentry = GetIpRouteInCache (destAddress);
+  rtentry = GetIpRouteInCache (destAddress, nodeIndex);
   // not in cache
   if (!rtentry)
     {
@@ -933,7 +1205,7 @@ NixVectorRouting<T>::RouteInput (Ptr<const Packet> p, const IpHeader &header, Pt
       rtentry->SetOutputDevice (m_ip->GetNetDevice (interfaceIndex));
 
       // add rtentry to cache
-      m_ipRouteCache.insert (typename IpRouteMap_t::value_type (destAddress, rtentry));
+      AddIpRouteInCache (destAddress, rtentry, nodeIndex);
     }
 
   NS_LOG_LOGIC ("At Node " << m_node->GetId () << ", Extracting " << numberOfBits <<
@@ -985,9 +1257,9 @@ NixVectorRouting<T>::PrintRoutingTable (Ptr<OutputStreamWrapper> stream, Time::U
           std::ostringstream dest;
           dest << it->first;
           *os << std::setw (30) << dest.str ();
-          if (it->second)
+          if (it->second.nixVector)
             {
-              *os << *(it->second) << std::endl;
+              *os << *(it->second.nixVector) << std::endl;
             }
         }
     }
@@ -1000,21 +1272,22 @@ NixVectorRouting<T>::PrintRoutingTable (Ptr<OutputStreamWrapper> stream, Time::U
       *os << "OutputDevice" << std::endl;
       for (typename IpRouteMap_t::const_iterator it = m_ipRouteCache.begin (); it != m_ipRouteCache.end (); it++)
         {
+          Ptr<IpRoute> route = it->second.route;
           std::ostringstream dest, gw, src;
-          dest << it->second->GetDestination ();
+          dest << route->GetDestination ();
           *os << std::setw (30) << dest.str ();
-          gw << it->second->GetGateway ();
+          gw << route->GetGateway ();
           *os << std::setw (30) << gw.str ();
-          src << it->second->GetSource ();
+          src << route->GetSource ();
           *os << std::setw (30) << src.str ();
           *os << "  ";
-          if (Names::FindName (it->second->GetOutputDevice ()) != "")
+          if (Names::FindName (route->GetOutputDevice ()) != "")
             {
-              *os << Names::FindName (it->second->GetOutputDevice ());
+              *os << Names::FindName (route->GetOutputDevice ());
             }
           else
             {
-              *os << it->second->GetOutputDevice ()->GetIfIndex ();
+              *os << route->GetOutputDevice ()->GetIfIndex ();
             }
           *os << std::endl;
         }
@@ -1035,7 +1308,7 @@ template <typename T>
 void
 NixVectorRouting<T>::NotifyInterfaceDown (uint32_t i)
 {
-  g_isCacheDirty = true;
+  MarkInterfaceDirty (i);
 }
 template <typename T>
 void
@@ -1263,9 +1536,10 @@ NixVectorRouting<T>::PrintRoutingPath (Ptr<Node> source, IpAddress dest,
       NS_LOG_LOGIC ("Nix-vector not in cache, build: ");
       // Build the nix-vector, given the source node and the
       // dest IP address
-      nixVectorInCache = GetNixVector (source, dest, nullptr);
+      std::vector<uint32_t> path;
+      nixVectorInCache = GetNixVector (source, dest, nullptr, path);
       // cache it
-      m_nixCache.insert (typename NixMap_t::value_type (dest, nixVectorInCache));
+      AddNixVectorInCache (dest, nixVectorInCache, path);
     }
 
   if (nixVectorInCache || (!nixVectorInCache && source == destNode))
@@ -1361,6 +1635,244 @@ NixVectorRouting<T>::CheckCacheStateAndFlush (void) const
     {
       FlushGlobalNixRoutingCache ();
       g_isCacheDirty = false;
+      g_dirtyNodes.clear ();
+    }
+  else if (!g_dirtyNodes.empty ())
+    {
+      InvalidateDirtyNodes ();
+      g_dirtyNodes.clear ();
+    }
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::ResetGlobalState (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+
+  g_isCacheDirty = false;
+  g_isResetScheduled = false;
+  g_ipAddressToNodeMap.clear ();
+  g_netdeviceToIpInterfaceMap.clear ();
+  g_dirtyNodes.clear ();
+  g_treeCache.clear ();
+  g_treeCacheLru.clear ();
+  g_graph.offsets.clear ();
+  g_graph.senders.clear ();
+  g_graph.valid = false;
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::BuildGraph (void) const
+{
+  NS_LOG_FUNCTION_NOARGS ();
+
+  uint32_t numberOfNodes = NodeList::GetNNodes ();
+  // the (receiver, sender) pairs of nodes, found with the
+  // same conditions as the BFS from a source
+  std::vector<std::pair<uint32_t, uint32_t> > edges;
+  for (uint32_t n = 0; n < numberOfNodes; n++)
+    {
+      Ptr<Node> currNode = NodeList::GetNode (n);
+      Ptr<IpL3Protocol> ip = currNode->GetObject<IpL3Protocol> ();
+      for (uint32_t i = 0; i < currNode->GetNDevices (); i++)
+        {
+          Ptr<NetDevice> localNetDevice = currNode->GetDevice (i);
+          if (ip)
+            {
+              uint32_t interfaceIndex = (ip)->GetInterfaceForDevice (localNetDevice);
+              if (!(ip->IsUp (interfaceIndex)))
+                {
+                  continue;
+                }
+            }
+          if (!(localNetDevice->IsLinkUp ()))
+            {
+              continue;
+            }
+          Ptr<Channel> channel = localNetDevice->GetChannel ();
+          if (channel == 0)
+            {
+              continue;
+            }
+          NetDeviceContainer netDeviceContainer;
+          GetAdjacentNetDevices (localNetDevice, channel, netDeviceContainer);
+          for (NetDeviceContainer::Iterator iter = netDeviceContainer.Begin (); iter != netDeviceContainer.End (); iter++)
+            {
+              Ptr<IpInterface> remoteIpInterface = GetInterfaceByNetDevice (*iter);
+              if (remoteIpInterface == 0 || !(remoteIpInterface->IsUp ()))
+                {
+                  continue;
+                }
+              edges.push_back (std::make_pair ((*iter)->GetNode ()->GetId (), n));
+            }
+        }
+    }
+
+  // counting sort of the edges by receiver
+  g_graph.offsets.assign (numberOfNodes + 1, 0);
+  for (std::size_t e = 0; e < edges.size (); e++)
+    {
+      g_graph.offsets[edges[e].first + 1]++;
+    }
+  for (uint32_t n = 0; n < numberOfNodes; n++)
+    {
+      g_graph.offsets[n + 1] += g_graph.offsets[n];
+    }
+  g_graph.senders.resize (edges.size ());
+  std::vector<uint32_t> position (g_graph.offsets.begin (), g_graph.offsets.end () - 1);
+  for (std::size_t e = 0; e < edges.size (); e++)
+    {
+      g_graph.senders[position[edges[e].first]++] = edges[e].second;
+    }
+  g_graph.valid = true;
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::ComputeTree (uint32_t dest, std::vector<uint32_t> & nextHop)
+{
+  NS_LOG_FUNCTION (dest);
+
+  nextHop.assign (g_graph.offsets.size () - 1, NIX_NO_NEXT_HOP);
+  std::vector<uint32_t> queue;
+  queue.reserve (nextHop.size ());
+  queue.push_back (dest);
+  nextHop[dest] = dest;
+  for (std::size_t head = 0; head < queue.size (); head++)
+    {
+      uint32_t currNode = queue[head];
+      for (uint32_t i = g_graph.offsets[currNode]; i < g_graph.offsets[currNode + 1]; i++)
+        {
+          uint32_t sender = g_graph.senders[i];
+          if (nextHop[sender] == NIX_NO_NEXT_HOP)
+            {
+              nextHop[sender] = currNode;
+              queue.push_back (sender);
+            }
+        }
+    }
+}
+
+template <typename T>
+const std::vector<uint32_t> &
+NixVectorRouting<T>::GetTree (uint32_t dest) const
+{
+  NS_LOG_FUNCTION (this << dest);
+
+  auto it = g_treeCache.find (dest);
+  if (it != g_treeCache.end ())
+    {
+      NS_LOG_LOGIC ("Found the BFS tree towards node " << dest << " in cache.");
+      g_treeCacheLru.splice (g_treeCacheLru.begin (), g_treeCacheLru, it->second.lruIterator);
+      return it->second.nextHop;
+    }
+
+  if (!g_graph.valid)
+    {
+      BuildGraph ();
+    }
+  std::vector<uint32_t> nextHop;
+  ComputeTree (dest, nextHop);
+  return AddTreeInCache (dest, nextHop);
+}
+
+template <typename T>
+const std::vector<uint32_t> &
+NixVectorRouting<T>::AddTreeInCache (uint32_t dest, std::vector<uint32_t> &nextHop)
+{
+  NS_LOG_FUNCTION (dest);
+
+  UintegerValue maxTrees;
+  g_nixVectorTreeCacheSize.GetValue (maxTrees);
+  auto it = g_treeCache.find (dest);
+  if (it == g_treeCache.end ())
+    {
+      if (maxTrees.Get () > 0 && g_treeCache.size () >= maxTrees.Get ())
+        {
+          NS_LOG_LOGIC ("Evicting the BFS tree towards node " << g_treeCacheLru.back ());
+          g_treeCache.erase (g_treeCacheLru.back ());
+          g_treeCacheLru.pop_back ();
+        }
+      g_treeCacheLru.push_front (dest);
+      it = g_treeCache.emplace (dest, NixTree ()).first;
+      it->second.lruIterator = g_treeCacheLru.begin ();
+    }
+  it->second.nextHop.swap (nextHop);
+  return it->second.nextHop;
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::ComputeTrees (TreeJob *job)
+{
+  for (std::size_t i = job->first; i < job->destinations->size (); i += job->step)
+    {
+      ComputeTree (job->destinations->at (i), job->trees->at (i));
+    }
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::PrecomputeTrees (const std::vector<IpAddress> &destinations, uint32_t nThreads) const
+{
+  NS_LOG_FUNCTION (this << nThreads);
+
+  CheckCacheStateAndFlush ();
+
+  std::set<uint32_t> destNodes;
+  for (std::size_t i = 0; i < destinations.size (); i++)
+    {
+      Ptr<Node> destNode = GetNodeByIp (destinations[i]);
+      if (destNode && g_treeCache.find (destNode->GetId ()) == g_treeCache.end ())
+        {
+          destNodes.insert (destNode->GetId ());
+        }
+    }
+  if (destNodes.empty ())
+    {
+      return;
+    }
+  if (!g_graph.valid)
+    {
+      BuildGraph ();
+    }
+
+  // the threads only access g_graph and their own trees
+  std::vector<uint32_t> dests (destNodes.begin (), destNodes.end ());
+  std::vector<std::vector<uint32_t> > trees (dests.size ());
+  nThreads = std::max<uint32_t> (1, std::min<uint32_t> (nThreads, dests.size ()));
+  std::vector<TreeJob> jobs (nThreads);
+  for (uint32_t t = 0; t < nThreads; t++)
+    {
+      jobs[t].destinations = &dests;
+      jobs[t].trees = &trees;
+      jobs[t].first = t;
+      jobs[t].step = nThreads;
+    }
+#ifdef HAVE_PTHREAD_H
+  std::vector<Ptr<SystemThread> > threads;
+  for (uint32_t t = 1; t < nThreads; t++)
+    {
+      threads.push_back (Create<SystemThread> (MakeBoundCallback (&NixVectorRouting<T>::ComputeTrees, &jobs[t])));
+      threads.back ()->Start ();
+    }
+  ComputeTrees (&jobs[0]);
+  for (std::size_t t = 0; t < threads.size (); t++)
+    {
+      threads[t]->Join ();
+    }
+#else
+  for (uint32_t t = 0; t < nThreads; t++)
+    {
+      ComputeTrees (&jobs[t]);
+    }
+#endif
+
+  for (std::size_t i = 0; i < dests.size (); i++)
+    {
+      AddTreeInCache (dests[i], trees[i]);
     }
 }
 
@@ -1373,5 +1885,9 @@ template void NixVectorRouting<Ipv4RoutingProtocol>::PrintRoutingPath (Ptr<Node>
                                                                        Ptr<OutputStreamWrapper> stream, Time::Unit unit) const;
 template void NixVectorRouting<Ipv6RoutingProtocol>::PrintRoutingPath (Ptr<Node> source, IpAddress dest,
                                                                        Ptr<OutputStreamWrapper> stream, Time::Unit unit) const;
+template void NixVectorRouting<Ipv4RoutingProtocol>::PrecomputeTrees (const std::vector<IpAddress> &destinations,
+                                                                      uint32_t nThreads) const;
+template void NixVectorRouting<Ipv6RoutingProtocol>::PrecomputeTrees (const std::vector<IpAddress> &destinations,
+                                                                      uint32_t nThreads) const;
 
 } // namespace ns3
@@ -42,9 +42,13 @@
 #include "ns3/ipv4-l3-protocol.h"
 #include "ns3/ipv6-l3-protocol.h"
 
+#include <list>
 #include <map>
+#include <set>
 #include <unordered_map>
 
+class NixVectorRoutingCacheTest; // Forward declaration for unit test
+
 namespace ns3 {
 
 /**
@@ -93,6 +97,9 @@ class NixVectorRouting : public std::enable_if<std::is_same<Ipv4RoutingProtocol,
   /// Alias for Ipv4L3Protocol and Ipv4L3Protocol classes
   using IpL3Protocol = typename std::conditional<IsIpv4::value, Ipv4L3Protocol, Ipv6L3Protocol>::type;
 
+  /// allow the unit test to access the caches
+  friend class ::NixVectorRoutingCacheTest;
+
 public:
   NixVectorRouting ();
   ~NixVectorRouting ();
@@ -134,6 +141,23 @@ public:
    */
   void PrintRoutingPath (Ptr<Node> source, IpAddress dest, Ptr<OutputStreamWrapper> stream, Time::Unit unit) const;
 
+  /**
+   * @brief Compute in advance the BFS trees towards a set of destinations,
+   * e.g., the destinations of a known traffic matrix, so that the first
+   * packets sent to them do not trigger a BFS
+   *
+   * The trees are shared by all the nix-vector routing instances, and
+   * are subject to the limit set by the "NixVectorTreeCacheSize" global
+   * value.
+   *
+   * \param destinations the destination addresses
+   * \param nThreads the number of threads used to compute the trees
+   *
+   * \note IpAddress is alias for either Ipv4Address or Ipv6Address
+   *       depending on on whether the network is IPv4 or IPv6 respectively.
+   */
+  void PrecomputeTrees (const std::vector<IpAddress> &destinations, uint32_t nThreads = 1) const;
+
 
 private:
 
@@ -156,17 +180,35 @@ private:
    */
   void ResetTotalNeighbors (void);
 
+  /**
+   * Upon a run-time interface down, only the caches of the nix-vectors
+   * crossing the nodes attached to the channel of the interface and the
+   * BFS trees which may use the channel are invalidated
+   */
+  void InvalidateDirtyNodes (void) const;
+
+  /**
+   * Records the nodes whose neighbors changed because an interface
+   * of this node went down. If they cannot be determined, all the
+   * caches will be flushed.
+   * \param interface the interface index
+   */
+  void MarkInterfaceDirty (uint32_t interface);
+
   /**
    * Takes in the source node and dest IP and calls GetNodeByIp,
-   * BFS, accounting for any output interface specified, and finally
-   * BuildNixVector to return the built nix-vector
+   * then either uses the BFS tree towards the destination, or runs
+   * a BFS accounting for the output interface specified, to return
+   * the built nix-vector
    *
-   * \param source Source node
-   * \param dest Destination node address
-   * \param oif Preferred output interface
+   * \param [in] source Source node
+   * \param [in] dest Destination node address
+   * \param [in] oif Preferred output interface
+   * \param [out] path The IDs of the nodes on the path
    * \returns The NixVector to be used in routing.
    */
-  Ptr<NixVector> GetNixVector (Ptr<Node> source, IpAddress dest, Ptr<NetDevice> oif) const;
+  Ptr<NixVector> GetNixVector (Ptr<Node> source, IpAddress dest, Ptr<NetDevice> oif,
+                               std::vector<uint32_t> &path) const;
 
   /**
    * Checks the cache based on dest IP for the nix-vector
@@ -176,12 +218,33 @@ private:
    */
   Ptr<NixVector> GetNixVectorInCache (const IpAddress &address,  bool &foundInCache) const;
 
+  /**
+   * Stores a nix-vector in the cache, evicting the least recently used
+   * one if the cache is full
+   * \param address Destination address
+   * \param nixVector The nix-vector, null if there is no path
+   * \param path The IDs of the nodes on the path
+   */
+  void AddNixVectorInCache (const IpAddress &address, Ptr<NixVector> nixVector,
+                            const std::vector<uint32_t> &path) const;
+
   /**
    * Checks the cache based on dest IP for the IpRoute
    * \param address Address to check
-   * \returns The cached route.
+   * \param nixIndex Neighbor index the route has to go through
+   * \returns The cached route, or null if not found or built for
+   *          another neighbor index.
+   */
+  Ptr<IpRoute> GetIpRouteInCache (IpAddress address, uint32_t nixIndex);
+
+  /**
+   * Stores or replaces an IpRoute in the cache, evicting the least
+   * recently used one if the cache is full
+   * \param address Destination address
+   * \param route The route
+   * \param nixIndex Neighbor index the route goes through
    */
-  Ptr<IpRoute> GetIpRouteInCache (IpAddress address);
+  void AddIpRouteInCache (IpAddress address, Ptr<IpRoute> route, uint32_t nixIndex);
 
   /**
    * Given a net-device returns all the adjacent net-devices,
@@ -218,6 +281,27 @@ private:
    */
   bool BuildNixVector (const std::vector< Ptr<Node> > & parentVector, uint32_t source, uint32_t dest, Ptr<NixVector> nixVector) const;
 
+  /**
+   * Follows a BFS tree from the source to the destination and builds
+   * the nixvector
+   * \param [in] nextHop The BFS tree, giving the next node towards the destination
+   * \param [in] source Source Node index
+   * \param [in] dest Destination Node index
+   * \param [out] nixVector the NixVector to be used for routing
+   * \param [out] path The IDs of the nodes on the path
+   * \returns true on success, false otherwise.
+   */
+  bool BuildNixVectorFromTree (const std::vector<uint32_t> & nextHop, uint32_t source, uint32_t dest,
+                               Ptr<NixVector> nixVector, std::vector<uint32_t> &path) const;
+
+  /**
+   * Adds to the nixvector the index of a neighbor of a node
+   * \param [in] parentNode The node
+   * \param [in] dest The ID of the neighbor node
+   * \param [out] nixVector the NixVector to be used for routing
+   */
+  void AddNeighborToNixVector (Ptr<Node> parentNode, uint32_t dest, Ptr<NixVector> nixVector) const;
+
   /**
    * Special variation of BuildNixVector for when a node is sending to itself
    * \param [out] nixVector the NixVector to be used for routing
@@ -267,6 +351,50 @@ private:
             std::vector< Ptr<Node> > & parentVector,
             Ptr<NetDevice> oif) const;
 
+  /**
+   * Builds g_graph, the list of the nodes which can send to each node.
+   */
+  void BuildGraph (void) const;
+
+  /**
+   * \brief Breadth first search from a destination over g_graph.
+   * \param [in] dest Destination Node index
+   * \param [out] nextHop For each node, the next node towards the destination
+   */
+  static void ComputeTree (uint32_t dest, std::vector<uint32_t> & nextHop);
+
+  /**
+   * Gets the BFS tree towards a destination from the shared cache,
+   * computing it if needed
+   * \param dest Destination Node index
+   * \returns For each node, the next node towards the destination
+   */
+  const std::vector<uint32_t> & GetTree (uint32_t dest) const;
+
+  /**
+   * Stores a BFS tree in the shared cache, evicting the least recently
+   * used one if the cache is full
+   * \param dest Destination Node index
+   * \param nextHop The BFS tree, swapped into the cache
+   * \returns The cached BFS tree.
+   */
+  static const std::vector<uint32_t> & AddTreeInCache (uint32_t dest, std::vector<uint32_t> &nextHop);
+
+  /// Work assigned to a thread by PrecomputeTrees
+  struct TreeJob
+  {
+    const std::vector<uint32_t> *destinations;       //!< destinations of all the trees
+    std::vector<std::vector<uint32_t> > *trees;      //!< the computed trees
+    uint32_t first;                                  //!< first tree to compute
+    uint32_t step;                                   //!< distance between two trees to compute
+  };
+
+  /**
+   * Computes the trees assigned to a thread
+   * \param job The work assigned to the thread
+   */
+  static void ComputeTrees (TreeJob *job);
+
   /**
    * \sa Ipv4RoutingProtocol::DoInitialize
    * \sa Ipv6RoutingProtocol::DoInitialize
@@ -279,10 +407,39 @@ private:
    */
   void DoDispose (void);
 
+  /// Cached nix-vector
+  struct NixMapItem
+  {
+    Ptr<NixVector> nixVector;                             //!< the nix-vector, null if no path
+    std::vector<uint32_t> path;                           //!< IDs of the nodes on the path
+    typename std::list<IpAddress>::iterator lruIterator;  //!< position in m_nixCacheLru
+  };
+  /// Cached IpRoute
+  struct IpRouteMapItem
+  {
+    Ptr<IpRoute> route;                                   //!< the route
+    uint32_t nixIndex;                                    //!< the neighbor index of the route
+    typename std::list<IpAddress>::iterator lruIterator;  //!< position in m_ipRouteCacheLru
+  };
   /// Map of IpAddress to NixVector
-  typedef std::map<IpAddress, Ptr<NixVector> > NixMap_t;
+  typedef std::map<IpAddress, NixMapItem> NixMap_t;
   /// Map of IpAddress to IpRoute
-  typedef std::map<IpAddress, Ptr<IpRoute> > IpRouteMap_t;
+  typedef std::map<IpAddress, IpRouteMapItem> IpRouteMap_t;
+
+  /// BFS tree towards a destination, shared by all the nodes
+  struct NixTree
+  {
+    std::vector<uint32_t> nextHop;                        //!< next node towards the destination
+    std::list<uint32_t>::iterator lruIterator;            //!< position in g_treeCacheLru
+  };
+
+  /// Nodes which can send to each node, in compressed sparse row format
+  struct NixGraph
+  {
+    std::vector<uint32_t> offsets;                        //!< first sender of each node in senders
+    std::vector<uint32_t> senders;                        //!< the senders
+    bool valid {false};                                   //!< false if it has to be rebuilt
+  };
 
   /// Callback for IPv4 unicast packets to be forwarded
   typedef Callback<void, Ptr<IpRoute>, Ptr<const Packet>, const IpHeader &> UnicastForwardCallbackv4;
@@ -444,6 +601,12 @@ private:
    */
   void CheckCacheStateAndFlush (void) const;
 
+  /**
+   * Clears the state shared by all the nix-vector routing instances,
+   * which refers to the nodes of the simulation, upon Simulator::Destroy
+   */
+  static void ResetGlobalState (void);
+
   /**
    * Build map from IP Address to Node for faster lookup.
    */
@@ -455,12 +618,36 @@ private:
    */
   static bool g_isCacheDirty;
 
+  /** Whether ResetGlobalState is scheduled upon Simulator::Destroy */
+  static bool g_isResetScheduled;
+
   /** Cache stores nix-vectors based on destination ip */
   mutable NixMap_t m_nixCache;
 
   /** Cache stores IpRoutes based on destination ip */
   mutable IpRouteMap_t m_ipRouteCache;
 
+  /** Destinations of m_nixCache, from the most to the least recently used */
+  mutable std::list<IpAddress> m_nixCacheLru;
+
+  /** Destinations of m_ipRouteCache, from the most to the least recently used */
+  mutable std::list<IpAddress> m_ipRouteCacheLru;
+
+  /** Maximum number of entries in each cache, 0 for no limit */
+  uint32_t m_maxCacheSize;
+
+  /** IDs of the nodes whose neighbors changed since the last check */
+  static std::set<uint32_t> g_dirtyNodes;
+
+  /** BFS trees towards each destination node */
+  static std::unordered_map<uint32_t, NixTree> g_treeCache;
+
+  /** Destinations of g_treeCache, from the most to the least recently used */
+  static std::list<uint32_t> g_treeCacheLru;
+
+  /** Graph used to compute the BFS trees */
+  static NixGraph g_graph;
+
   Ptr<Ip> m_ip; //!< IP object
   Ptr<Node> m_node; //!< Node object
 
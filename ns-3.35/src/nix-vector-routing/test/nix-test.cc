@@ -34,6 +34,9 @@
 #include "ns3/udp-l4-protocol.h"
 #include "ns3/simple-net-device-helper.h"
 #include "ns3/nix-vector-helper.h"
+#include "ns3/nix-vector-routing.h"
+#include "ns3/config.h"
+#include "ns3/uinteger.h"
 
 using namespace ns3;
 /**
@@ -364,6 +367,373 @@ NixVectorRoutingTest::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \ingroup nix-vector-routing-test
+ * \ingroup tests
+ *
+ * Tests of the caches of the IPv4 nix-vector routing, over topologies
+ * of point-to-point links:
+ * - The least recently used nix-vectors, routes and BFS trees are
+ *   evicted from the bounded caches, and rebuilt identically when used again.
+ * - An interface going down only invalidates the nix-vectors crossing
+ *   the nodes attached to its channel.
+ * - The BFS trees computed in advance, by one or several threads, are the
+ *   same as the ones computed upon lookup.
+ * - The state shared by the routing instances does not survive
+ *   Simulator::Destroy, so that a second simulation reusing the
+ *   addresses on other nodes is routed correctly.
+ *
+ * \brief IPv4 Nix-Vector Routing caches Test
+ */
+class NixVectorRoutingCacheTest : public TestCase
+{
+public:
+  NixVectorRoutingCacheTest ();
+
+private:
+  virtual void DoRun (void);
+
+  /// A link between two nodes
+  typedef std::pair<uint32_t, uint32_t> Link;
+
+  /**
+   * \brief Create the nodes and the links of a topology,
+   * with IPv4 nix-vector routing.
+   * \param [in] nNodes The number of nodes.
+   * \param [in] links The links.
+   * \param [out] devices The devices of each link.
+   * \returns The nodes.
+   */
+  NodeContainer BuildTopology (uint32_t nNodes, const std::vector<Link> &links,
+                               std::vector<NetDeviceContainer> &devices);
+
+  /**
+   * \brief Get the nix-vector routing of a node.
+   * \param node The node.
+   * \returns The nix-vector routing.
+   */
+  Ptr<Ipv4NixVectorRouting> GetRouting (Ptr<Node> node);
+
+  /**
+   * \brief Get the address of the first interface of a node.
+   * \param node The node.
+   * \returns The address.
+   */
+  Ipv4Address GetAddress (Ptr<Node> node);
+
+  /**
+   * \brief Look up the route from a node to a destination address.
+   * \param source The source node.
+   * \param dest The destination address.
+   * \returns The route, null if there is none.
+   */
+  Ptr<Ipv4Route> Lookup (Ptr<Node> source, Ipv4Address dest);
+
+  /**
+   * \brief Get the nix-vector cached by a node towards an address.
+   * \param source The source node.
+   * \param dest The destination address.
+   * \returns The nix-vector printed, empty if it is not cached.
+   */
+  std::string GetCachedNixVector (Ptr<Node> source, Ipv4Address dest);
+
+  /// Test the LRU eviction of the caches
+  void RunLruTest (void);
+  /// Test the invalidation upon an interface down
+  void RunDirtyNodesTest (void);
+  /**
+   * \brief Test the BFS trees computed in advance
+   * \param nThreads The number of threads computing the trees
+   */
+  void RunPrecomputeTest (uint32_t nThreads);
+  /// Test the reset of the shared state upon Simulator::Destroy
+  void RunTwoSimulationsTest (void);
+};
+
+NixVectorRoutingCacheTest::NixVectorRoutingCacheTest ()
+  : TestCase ("nix-vector routing caches")
+{
+}
+
+NodeContainer
+NixVectorRoutingCacheTest::BuildTopology (uint32_t nNodes, const std::vector<Link> &links,
+                                          std::vector<NetDeviceContainer> &devices)
+{
+  NodeContainer nodes;
+  nodes.Create (nNodes);
+
+  Ipv4NixVectorHelper nixRouting;
+  InternetStackHelper stack;
+  stack.SetRoutingHelper (nixRouting);
+  stack.SetIpv6StackInstall (false);
+  stack.Install (nodes);
+
+  SimpleNetDeviceHelper devHelper;
+  devHelper.SetNetDevicePointToPointMode (true);
+  Ipv4AddressHelper address ("10.1.1.0", "255.255.255.0");
+  devices.clear ();
+  for (std::size_t i = 0; i < links.size (); i++)
+    {
+      devices.push_back (devHelper.Install (NodeContainer (nodes.Get (links[i].first),
+                                                           nodes.Get (links[i].second))));
+      address.Assign (devices.back ());
+      address.NewNetwork ();
+    }
+  return nodes;
+}
+
+Ptr<Ipv4NixVectorRouting>
+NixVectorRoutingCacheTest::GetRouting (Ptr<Node> node)
+{
+  return node->GetObject<Ipv4NixVectorRouting> ();
+}
+
+Ipv4Address
+NixVectorRoutingCacheTest::GetAddress (Ptr<Node> node)
+{
+  return node->GetObject<Ipv4> ()->GetAddress (1, 0).GetLocal ();
+}
+
+Ptr<Ipv4Route>
+NixVectorRoutingCacheTest::Lookup (Ptr<Node> source, Ipv4Address dest)
+{
+  Ipv4Header header;
+  header.SetDestination (dest);
+  Socket::SocketErrno sockerr;
+  return GetRouting (source)->RouteOutput (Create<Packet> (), header, 0, sockerr);
+}
+
+std::string
+NixVectorRoutingCacheTest::GetCachedNixVector (Ptr<Node> source, Ipv4Address dest)
+{
+  Ptr<Ipv4NixVectorRouting> rp = GetRouting (source);
+  auto it = rp->m_nixCache.find (dest);
+  if (it == rp->m_nixCache.end () || !it->second.nixVector)
+    {
+      return "";
+    }
+  std::ostringstream os;
+  os << *it->second.nixVector;
+  return os.str ();
+}
+
+void
+NixVectorRoutingCacheTest::RunLruTest (void)
+{
+  //  0 -- 1 -- 2 -- 3
+  //  |
+  //  4 -- 5
+  std::vector<NetDeviceContainer> devices;
+  NodeContainer nodes = BuildTopology (6, { {0, 1}, {1, 2}, {2, 3}, {0, 4}, {4, 5} }, devices);
+  Config::SetGlobal ("NixVectorTreeCacheSize", UintegerValue (2));
+  Ptr<Ipv4NixVectorRouting> rp = GetRouting (nodes.Get (0));
+  rp->SetAttribute ("MaxCacheSize", UintegerValue (2));
+  Ipv4Address a2 = GetAddress (nodes.Get (2));
+  Ipv4Address a3 = GetAddress (nodes.Get (3));
+  Ipv4Address a5 = GetAddress (nodes.Get (5));
+
+  Ptr<Ipv4Route> route3 = Lookup (nodes.Get (0), a3);
+  NS_TEST_ASSERT_MSG_NE (route3, 0, "No route towards node 3");
+  std::string nix3 = GetCachedNixVector (nodes.Get (0), a3);
+  Ptr<Ipv4Route> route5 = Lookup (nodes.Get (0), a5);
+  NS_TEST_ASSERT_MSG_NE (route5, 0, "No route towards node 5");
+  std::string nix5 = GetCachedNixVector (nodes.Get (0), a5);
+  // node 3 becomes the most recently used destination of the node,
+  // whereas the tree towards node 3 remains the least recently used
+  NS_TEST_EXPECT_MSG_EQ (Lookup (nodes.Get (0), a3), route3, "The cached route was not reused");
+
+  NS_TEST_ASSERT_MSG_NE (Lookup (nodes.Get (0), a2), 0, "No route towards node 2");
+  NS_TEST_EXPECT_MSG_EQ (rp->m_nixCache.size (), 2, "Wrong nix-vector cache size");
+  NS_TEST_EXPECT_MSG_EQ (rp->m_ipRouteCache.size (), 2, "Wrong route cache size");
+  NS_TEST_EXPECT_MSG_EQ (rp->m_nixCache.count (a5), 0, "The least recently used nix-vector was not evicted");
+  NS_TEST_EXPECT_MSG_EQ (rp->m_ipRouteCache.count (a5), 0, "The least recently used route was not evicted");
+  NS_TEST_EXPECT_MSG_EQ (rp->m_nixCache.count (a3), 1, "The most recently used nix-vector was evicted");
+  NS_TEST_EXPECT_MSG_EQ (Ipv4NixVectorRouting::g_treeCache.size (), 2, "Wrong tree cache size");
+  NS_TEST_EXPECT_MSG_EQ (Ipv4NixVectorRouting::g_treeCache.count (nodes.Get (3)->GetId ()), 0,
+                         "The least recently used tree was not evicted");
+  NS_TEST_EXPECT_MSG_EQ (Ipv4NixVectorRouting::g_treeCache.count (nodes.Get (5)->GetId ()), 1,
+                         "The most recently used tree was evicted");
+
+  // the evicted entries are rebuilt identically
+  route5 = Lookup (nodes.Get (0), a5);
+  NS_TEST_ASSERT_MSG_NE (route5, 0, "No route towards node 5 after eviction");
+  NS_TEST_EXPECT_MSG_EQ (GetCachedNixVector (nodes.Get (0), a5), nix5, "Different nix-vector after eviction");
+  NS_TEST_EXPECT_MSG_EQ (route5->GetGateway (), GetAddress (nodes.Get (4)), "Wrong gateway after eviction");
+  NS_TEST_EXPECT_MSG_EQ (rp->m_nixCache.count (a3), 0, "The least recently used nix-vector was not evicted");
+  route3 = Lookup (nodes.Get (0), a3);
+  NS_TEST_ASSERT_MSG_NE (route3, 0, "No route towards node 3 after eviction");
+  NS_TEST_EXPECT_MSG_EQ (GetCachedNixVector (nodes.Get (0), a3), nix3, "Different nix-vector after eviction");
+  NS_TEST_EXPECT_MSG_EQ (route3->GetGateway (), GetAddress (nodes.Get (1)), "Wrong gateway after eviction");
+  NS_TEST_EXPECT_MSG_EQ (Ipv4NixVectorRouting::g_treeCache.count (nodes.Get (2)->GetId ()), 0,
+                         "The least recently used tree was not evicted");
+
+  Simulator::Destroy ();
+}
+
+void
+NixVectorRoutingCacheTest::RunDirtyNodesTest (void)
+{
+  //  0 -- 1 -- 2 -- 3
+  //  |
+  //  4 -- 5
+  std::vector<NetDeviceContainer> devices;
+  NodeContainer nodes = BuildTopology (6, { {0, 1}, {1, 2}, {2, 3}, {0, 4}, {4, 5} }, devices);
+  Ipv4Address a3 = GetAddress (nodes.Get (3));
+  Ipv4Address a5 = GetAddress (nodes.Get (5));
+
+  NS_TEST_ASSERT_MSG_NE (Lookup (nodes.Get (0), a3), 0, "No route towards node 3");
+  NS_TEST_ASSERT_MSG_NE (Lookup (nodes.Get (0), a5), 0, "No route towards node 5");
+  NS_TEST_ASSERT_MSG_NE (Lookup (nodes.Get (1), a3), 0, "No route towards node 3");
+  NS_TEST_ASSERT_MSG_NE (Lookup (nodes.Get (4), a5), 0, "No route towards node 5");
+  std::string nix05 = GetCachedNixVector (nodes.Get (0), a5);
+
+  // the link between nodes 2 and 3 goes down
+  Ptr<Ipv4> ipv4 = nodes.Get (2)->GetObject<Ipv4> ();
+  ipv4->SetDown (ipv4->GetInterfaceForDevice (devices[2].Get (0)));
+  NS_TEST_EXPECT_MSG_EQ (Ipv4NixVectorRouting::g_isCacheDirty, false, "All the caches will be flushed");
+  NS_TEST_EXPECT_MSG_EQ (Ipv4NixVectorRouting::g_dirtyNodes.size (), 2, "Wrong number of dirty nodes");
+  NS_TEST_EXPECT_MSG_EQ (Ipv4NixVectorRouting::g_dirtyNodes.count (nodes.Get (2)->GetId ()), 1, "Node 2 is not dirty");
+  NS_TEST_EXPECT_MSG_EQ (Ipv4NixVectorRouting::g_dirtyNodes.count (nodes.Get (3)->GetId ()), 1, "Node 3 is not dirty");
+
+  // the invalidation is done upon the next lookup
+  NS_TEST_ASSERT_MSG_NE (Lookup (nodes.Get (0), a5), 0, "No route towards node 5");
+  NS_TEST_EXPECT_MSG_EQ (Ipv4NixVectorRouting::g_dirtyNodes.empty (), true, "The dirty nodes were not cleared");
+  Ptr<Ipv4NixVectorRouting> rp0 = GetRouting (nodes.Get (0));
+  Ptr<Ipv4NixVectorRouting> rp1 = GetRouting (nodes.Get (1));
+  Ptr<Ipv4NixVectorRouting> rp4 = GetRouting (nodes.Get (4));
+  NS_TEST_EXPECT_MSG_EQ (rp0->m_nixCache.count (a3), 0, "The nix-vector crossing the link was not invalidated");
+  NS_TEST_EXPECT_MSG_EQ (rp0->m_ipRouteCache.count (a3), 0, "The route crossing the link was not invalidated");
+  NS_TEST_EXPECT_MSG_EQ (rp1->m_nixCache.count (a3), 0, "The nix-vector crossing the link was not invalidated");
+  NS_TEST_EXPECT_MSG_EQ (rp0->m_ipRouteCache.count (a5), 1, "The route not crossing the link was invalidated");
+  NS_TEST_EXPECT_MSG_EQ (GetCachedNixVector (nodes.Get (0), a5), nix05, "The nix-vector not crossing the link changed");
+  NS_TEST_EXPECT_MSG_EQ (rp4->m_nixCache.count (a5), 1, "The nix-vector not crossing the link was invalidated");
+  NS_TEST_EXPECT_MSG_EQ (rp4->m_ipRouteCache.count (a5), 1, "The route not crossing the link was invalidated");
+  NS_TEST_EXPECT_MSG_EQ (Ipv4NixVectorRouting::g_treeCache.count (nodes.Get (3)->GetId ()), 0,
+                         "The tree using the link was not invalidated");
+
+  // node 3 is not reachable anymore
+  NS_TEST_EXPECT_MSG_EQ (Lookup (nodes.Get (0), a3), 0, "Route towards an unreachable node");
+
+  Simulator::Destroy ();
+}
+
+void
+NixVectorRoutingCacheTest::RunPrecomputeTest (uint32_t nThreads)
+{
+  // a 5 x 5 grid with a few diagonals, so that the nodes have several
+  // shortest paths towards most destinations
+  const uint32_t side = 5;
+  std::vector<Link> links;
+  for (uint32_t row = 0; row < side; row++)
+    {
+      for (uint32_t col = 0; col < side; col++)
+        {
+          uint32_t n = row * side + col;
+          if (col + 1 < side)
+            {
+              links.push_back (Link (n, n + 1));
+            }
+          if (row + 1 < side)
+            {
+              links.push_back (Link (n, n + side));
+            }
+          if (row + 1 < side && col + 1 < side && (row + col) % 3 == 0)
+            {
+              links.push_back (Link (n, n + side + 1));
+            }
+        }
+    }
+  std::vector<NetDeviceContainer> devices;
+  NodeContainer nodes = BuildTopology (side * side, links, devices);
+  std::vector<Ipv4Address> addresses;
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      addresses.push_back (GetAddress (nodes.Get (i)));
+    }
+
+  // trees and nix-vectors computed upon lookup
+  std::vector<std::string> nixVectors;
+  for (uint32_t s = 0; s < nodes.GetN (); s++)
+    {
+      for (uint32_t d = 0; d < nodes.GetN (); d++)
+        {
+          Lookup (nodes.Get (s), addresses[d]);
+          nixVectors.push_back (GetCachedNixVector (nodes.Get (s), addresses[d]));
+        }
+    }
+  std::map<uint32_t, std::vector<uint32_t> > trees;
+  for (auto it = Ipv4NixVectorRouting::g_treeCache.begin (); it != Ipv4NixVectorRouting::g_treeCache.end (); it++)
+    {
+      trees[it->first] = it->second.nextHop;
+    }
+  NS_TEST_ASSERT_MSG_EQ (trees.size (), nodes.GetN (), "Wrong number of trees");
+
+  // trees computed in advance
+  Ptr<Ipv4NixVectorRouting> rp = GetRouting (nodes.Get (0));
+  rp->FlushGlobalNixRoutingCache ();
+  NS_TEST_ASSERT_MSG_EQ (Ipv4NixVectorRouting::g_treeCache.empty (), true, "The trees were not flushed");
+  rp->PrecomputeTrees (addresses, nThreads);
+  NS_TEST_ASSERT_MSG_EQ (Ipv4NixVectorRouting::g_treeCache.size (), nodes.GetN (), "Wrong number of trees computed in advance");
+  for (auto it = trees.begin (); it != trees.end (); it++)
+    {
+      NS_TEST_EXPECT_MSG_EQ ((Ipv4NixVectorRouting::g_treeCache[it->first].nextHop == it->second), true,
+                             "Different tree towards node " << it->first << " with " << nThreads << " threads");
+    }
+  for (uint32_t s = 0; s < nodes.GetN (); s++)
+    {
+      for (uint32_t d = 0; d < nodes.GetN (); d++)
+        {
+          Lookup (nodes.Get (s), addresses[d]);
+          NS_TEST_EXPECT_MSG_EQ (GetCachedNixVector (nodes.Get (s), addresses[d]), nixVectors[s * nodes.GetN () + d],
+                                 "Different nix-vector from node " << s << " to node " << d
+                                 << " with " << nThreads << " threads");
+        }
+    }
+
+  Simulator::Destroy ();
+}
+
+void
+NixVectorRoutingCacheTest::RunTwoSimulationsTest (void)
+{
+  // 0 -- 1 -- 2, with 10.1.1.2 on node 1
+  std::vector<NetDeviceContainer> devices;
+  NodeContainer nodes = BuildTopology (3, { {0, 1}, {1, 2} }, devices);
+  Ptr<Ipv4Route> route = Lookup (nodes.Get (0), Ipv4Address ("10.1.1.2"));
+  NS_TEST_ASSERT_MSG_NE (route, 0, "No route towards 10.1.1.2");
+  NS_TEST_EXPECT_MSG_EQ (Ipv4NixVectorRouting::g_ipAddressToNodeMap.empty (), false, "The addresses were not mapped");
+  NS_TEST_EXPECT_MSG_EQ (Ipv4NixVectorRouting::g_treeCache.empty (), false, "No tree was cached");
+  Simulator::Destroy ();
+
+  NS_TEST_EXPECT_MSG_EQ (Ipv4NixVectorRouting::g_ipAddressToNodeMap.empty (), true, "The address map survived Simulator::Destroy");
+  NS_TEST_EXPECT_MSG_EQ (Ipv4NixVectorRouting::g_netdeviceToIpInterfaceMap.empty (), true, "The interface map survived Simulator::Destroy");
+  NS_TEST_EXPECT_MSG_EQ (Ipv4NixVectorRouting::g_treeCache.empty (), true, "The trees survived Simulator::Destroy");
+  NS_TEST_EXPECT_MSG_EQ (Ipv4NixVectorRouting::g_treeCacheLru.empty (), true, "The trees survived Simulator::Destroy");
+  NS_TEST_EXPECT_MSG_EQ (Ipv4NixVectorRouting::g_graph.valid, false, "The graph survived Simulator::Destroy");
+
+  // 0 -- 1 -- 2, with 10.1.1.2 on node 2
+  nodes = BuildTopology (3, { {1, 2}, {0, 1} }, devices);
+  route = Lookup (nodes.Get (0), Ipv4Address ("10.1.1.2"));
+  NS_TEST_ASSERT_MSG_NE (route, 0, "No route towards 10.1.1.2 in the second simulation");
+  NS_TEST_EXPECT_MSG_EQ (route->GetGateway (), Ipv4Address ("10.1.2.2"), "Wrong gateway in the second simulation");
+  Ptr<Ipv4NixVectorRouting> rp = GetRouting (nodes.Get (0));
+  std::vector<uint32_t> path = {0, 1, 2};
+  NS_TEST_EXPECT_MSG_EQ ((rp->m_nixCache[Ipv4Address ("10.1.1.2")].path == path), true,
+                         "Wrong path in the second simulation");
+  Simulator::Destroy ();
+}
+
+void
+NixVectorRoutingCacheTest::DoRun (void)
+{
+  RunLruTest ();
+  Config::SetGlobal ("NixVectorTreeCacheSize", UintegerValue (0));
+  RunDirtyNodesTest ();
+  RunPrecomputeTest (1);
+  RunPrecomputeTest (4);
+  RunTwoSimulationsTest ();
+}
+
 /**
  * \ingroup nix-vector-routing-test
  * \ingroup tests
@@ -376,6 +746,7 @@ public:
   NixVectorRoutingTestSuite () : TestSuite ("nix-vector-routing", UNIT)
   {
     AddTestCase (new NixVectorRoutingTest (), TestCase::QUICK);
+    AddTestCase (new NixVectorRoutingCacheTest (), TestCase::QUICK);
   }
 };
 
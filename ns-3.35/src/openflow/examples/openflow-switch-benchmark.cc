@@ -0,0 +1,186 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Switching throughput benchmark
+//
+//        n0     n1  ...  nN-1
+//        |      |         |
+//       -------------------
+//       |      Switch     |
+//       -------------------
+//
+// Each terminal sends a CBR/UDP flow to the next one through a single
+// switch.  The same scenario is simulated with a BridgeNetDevice, with an
+// OpenFlowSwitchNetDevice whose microflow cache is disabled, and with an
+// OpenFlowSwitchNetDevice using the microflow cache (LearningController in
+// both cases).  For each switch, the number of frames sent over the switch
+// ports and the switching rate, in frames per second of wall clock time,
+// are reported.
+//
+// ./waf --run "openflow-switch-benchmark --nTerminals=16 --duration=20"
+
+#include <iomanip>
+#include <iostream>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/csma-module.h"
+#include "ns3/bridge-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/openflow-module.h"
+#include "ns3/log.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("OpenFlowSwitchBenchmark");
+
+/// Number of frames sent over the switch ports in the current run
+static uint64_t g_switchedFrames = 0;
+
+/**
+ * Count a frame sent over a switch port
+ * \param packet the frame
+ */
+static void
+SwitchPortTx (Ptr<const Packet> packet)
+{
+  g_switchedFrames++;
+}
+
+/// Switch implementations compared by the benchmark
+enum SwitchType
+{
+  BRIDGE,           //!< BridgeNetDevice
+  OPENFLOW_NOCACHE, //!< OpenFlowSwitchNetDevice without microflow cache
+  OPENFLOW          //!< OpenFlowSwitchNetDevice with microflow cache
+};
+
+/**
+ * Simulate the star with a given switch
+ * \param type the switch implementation
+ * \param nTerminals the number of terminals
+ * \param duration the duration of the flows
+ * \param rate the rate of each flow
+ * \return the wall clock time of the run, in ms
+ */
+static int64_t
+RunSwitch (SwitchType type, uint32_t nTerminals, Time duration, DataRate rate)
+{
+  g_switchedFrames = 0;
+
+  NodeContainer terminals;
+  terminals.Create (nTerminals);
+  NodeContainer csmaSwitch;
+  csmaSwitch.Create (1);
+
+  CsmaHelper csma;
+  csma.SetChannelAttribute ("DataRate", DataRateValue (DataRate ("100Mbps")));
+  csma.SetChannelAttribute ("Delay", TimeValue (MicroSeconds (10)));
+
+  NetDeviceContainer terminalDevices;
+  NetDeviceContainer switchDevices;
+  for (uint32_t i = 0; i < nTerminals; i++)
+    {
+      NetDeviceContainer link = csma.Install (NodeContainer (terminals.Get (i), csmaSwitch));
+      terminalDevices.Add (link.Get (0));
+      switchDevices.Add (link.Get (1));
+      link.Get (1)->TraceConnectWithoutContext ("MacTx", MakeCallback (&SwitchPortTx));
+    }
+
+  Ptr<Node> switchNode = csmaSwitch.Get (0);
+  if (type == BRIDGE)
+    {
+      BridgeHelper bridge;
+      bridge.Install (switchNode, switchDevices);
+    }
+  else
+    {
+      OpenFlowSwitchHelper swtch;
+      swtch.SetDeviceAttribute ("MicroflowCacheSize", UintegerValue (type == OPENFLOW ? 4096 : 0));
+      Ptr<ofi::LearningController> controller = CreateObject<ofi::LearningController> ();
+      swtch.Install (switchNode, switchDevices, controller);
+    }
+
+  InternetStackHelper internet;
+  internet.Install (terminals);
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.0.0", "255.255.0.0");
+  Ipv4InterfaceContainer interfaces = ipv4.Assign (terminalDevices);
+
+  uint16_t port = 9;
+  PacketSinkHelper sink ("ns3::UdpSocketFactory",
+                         Address (InetSocketAddress (Ipv4Address::GetAny (), port)));
+  ApplicationContainer apps = sink.Install (terminals);
+  apps.Start (Seconds (0));
+  for (uint32_t i = 0; i < nTerminals; i++)
+    {
+      OnOffHelper onoff ("ns3::UdpSocketFactory",
+                         Address (InetSocketAddress (interfaces.GetAddress ((i + 1) % nTerminals), port)));
+      onoff.SetConstantRate (rate, 512);
+      apps = onoff.Install (terminals.Get (i));
+      apps.Start (Seconds (1) + MicroSeconds (i));
+      apps.Stop (Seconds (1) + duration);
+    }
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Stop (Seconds (2) + duration);
+  Simulator::Run ();
+  int64_t elapsed = clock.End ();
+  Simulator::Destroy ();
+  return elapsed;
+}
+
+/**
+ * Print the switching rate of a run
+ * \param name the name of the switch
+ * \param elapsed the wall clock time of the run, in ms
+ */
+static void
+PrintRate (std::string name, int64_t elapsed)
+{
+  std::cout << std::setw (20) << name << std::setw (12) << elapsed
+            << std::setw (16) << g_switchedFrames
+            << std::setw (16) << std::fixed << std::setprecision (0)
+            << g_switchedFrames * 1000.0 / std::max<int64_t> (elapsed, 1) << std::endl;
+}
+
+int
+main (int argc, char *argv[])
+{
+#ifdef NS3_OPENFLOW
+  uint32_t nTerminals = 8;
+  double duration = 10;
+  std::string rate = "2Mbps";
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("nTerminals", "Number of terminals attached to the switch", nTerminals);
+  cmd.AddValue ("duration", "Duration of the flows, in s", duration);
+  cmd.AddValue ("rate", "Rate of the flow sent by each terminal", rate);
+  cmd.Parse (argc, argv);
+
+  std::cout << "terminals: " << nTerminals << ", flow rate: " << rate << std::endl;
+  std::cout << std::setw (20) << "switch" << std::setw (12) << "time (ms)"
+            << std::setw (16) << "frames" << std::setw (16) << "frames/s" << std::endl;
+  PrintRate ("bridge", RunSwitch (BRIDGE, nTerminals, Seconds (duration), DataRate (rate)));
+  PrintRate ("openflow (no cache)", RunSwitch (OPENFLOW_NOCACHE, nTerminals, Seconds (duration), DataRate (rate)));
+  PrintRate ("openflow", RunSwitch (OPENFLOW, nTerminals, Seconds (duration), DataRate (rate)));
+#else
+  NS_LOG_INFO ("NS-3 OpenFlow is not enabled. Cannot run simulation.");
+#endif // NS3_OPENFLOW
+  return 0;
+}
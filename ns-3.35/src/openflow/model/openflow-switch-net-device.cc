@@ -20,6 +20,7 @@
 #include "openflow-switch-net-device.h"
 #include "ns3/udp-l4-protocol.h"
 #include "ns3/tcp-l4-protocol.h"
+#include "ns3/hash.h"
 
 namespace ns3 {
 
@@ -86,6 +87,11 @@ OpenFlowSwitchNetDevice::GetTypeId (void)
                    UintegerValue (OFP_DEFAULT_MISS_SEND_LEN), // 128 bytes
                    MakeUintegerAccessor (&OpenFlowSwitchNetDevice::m_missSendLen),
                    MakeUintegerChecker<uint16_t> ())
+    .AddAttribute ("MicroflowCacheSize",
+                   "Maximum number of exact keys remembered by the microflow cache in front of the flow table; 0 disables the cache.",
+                   UintegerValue (4096),
+                   MakeUintegerAccessor (&OpenFlowSwitchNetDevice::m_microflowCacheSize),
+                   MakeUintegerChecker<uint32_t> ())
   ;
   return tid;
 }
@@ -93,7 +99,8 @@ OpenFlowSwitchNetDevice::GetTypeId (void)
 OpenFlowSwitchNetDevice::OpenFlowSwitchNetDevice ()
   : m_node (0),
     m_ifIndex (0),
-    m_mtu (0xffff)
+    m_mtu (0xffff),
+    m_microflowCacheHits (0)
 {
   NS_LOG_FUNCTION_NOARGS ();
 
@@ -134,6 +141,7 @@ OpenFlowSwitchNetDevice::DoDispose ()
 
   m_controller = 0;
 
+  FlushMicroflowCache ();
   chain_destroy (m_chain);
   RBTreeDestroy (m_vportTable.table);
   m_channel = 0;
@@ -580,8 +588,9 @@ OpenFlowSwitchNetDevice::BufferFromPacket (Ptr<const Packet> constPacket, Addres
         }
     }
 
-  // Load any remaining packet data into buffer data
-  packet->CopyData ((uint8_t*)buffer->data, packet->GetSize ());
+  // The payload is not loaded into the buffer: only the headers are matched
+  // against the flow table and sent to the controller, and the packet that is
+  // forwarded is the ns-3 Packet kept in the SwitchPacketMetadata.
 
   if (buffer->l4)
     {
@@ -675,30 +684,38 @@ OpenFlowSwitchNetDevice::ReceiveFromDevice (Ptr<NetDevice> netdev, Ptr<const Pac
         }
 
       // If any flows have expired, delete them and notify the controller.
-      List deleted = LIST_INITIALIZER (&deleted);
-      sw_flow *f, *n;
-      chain_timeout (m_chain, &deleted);
-      LIST_FOR_EACH_SAFE (f, n, sw_flow, node, &deleted)
-      {
-        std::ostringstream str;
-        str << "Flow [";
-        for (int i = 0; i < 6; i++)
-          str << (i!=0 ? ":" : "") << std::hex << f->key.flow.dl_src[i]/16 << f->key.flow.dl_src[i]%16;
-        str << " -> ";
-        for (int i = 0; i < 6; i++)
-          str << (i!=0 ? ":" : "") << std::hex << f->key.flow.dl_dst[i]/16 << f->key.flow.dl_dst[i]%16;
-        str <<  "] expired.";
-	
-        NS_LOG_INFO (str.str ());
-        SendFlowExpired (f, (ofp_flow_expired_reason)f->reason);
-        list_remove (&f->node);
-        flow_free (f);
-      }
+      TimeoutFlows ();
 
       m_lastExecute = now;
     }
 }
 
+void
+OpenFlowSwitchNetDevice::TimeoutFlows (void)
+{
+  List deleted = LIST_INITIALIZER (&deleted);
+  sw_flow *f, *n;
+  chain_timeout (m_chain, &deleted);
+  LIST_FOR_EACH_SAFE (f, n, sw_flow, node, &deleted)
+  {
+    FlushMicroflowCache ();
+
+    std::ostringstream str;
+    str << "Flow [";
+    for (int i = 0; i < 6; i++)
+      str << (i!=0 ? ":" : "") << std::hex << f->key.flow.dl_src[i]/16 << f->key.flow.dl_src[i]%16;
+    str << " -> ";
+    for (int i = 0; i < 6; i++)
+      str << (i!=0 ? ":" : "") << std::hex << f->key.flow.dl_dst[i]/16 << f->key.flow.dl_dst[i]%16;
+    str <<  "] expired.";
+	
+    NS_LOG_INFO (str.str ());
+    SendFlowExpired (f, (ofp_flow_expired_reason)f->reason);
+    list_remove (&f->node);
+    flow_free (f);
+  }
+}
+
 int
 OpenFlowSwitchNetDevice::OutputAll (uint32_t packet_uid, int in_port, bool flood)
 {
@@ -738,7 +755,7 @@ OpenFlowSwitchNetDevice::OutputPacket (uint32_t packet_uid, int out_port)
       ofi::Port& p = m_ports[out_port];
       if (p.netdev != 0 && !(p.config & OFPPC_PORT_DOWN))
         {
-          ofi::SwitchPacketMetadata data = m_packetData.find (packet_uid)->second;
+          const ofi::SwitchPacketMetadata &data = m_packetData.find (packet_uid)->second;
           size_t bufsize = data.buffer->size;
           NS_LOG_INFO ("Sending packet " << data.packet->GetUid () << " over port " << out_port);
           if (p.netdev->SendFrom (data.packet->Copy (), data.src, data.dst, data.protocolNumber))
@@ -966,7 +983,7 @@ OpenFlowSwitchNetDevice::SendErrorMsg (uint16_t type, uint16_t code, const void
 void
 OpenFlowSwitchNetDevice::FlowTableLookup (sw_flow_key key, ofpbuf* buffer, uint32_t packet_uid, int port, bool send_to_controller)
 {
-  sw_flow *flow = chain_lookup (m_chain, &key);
+  sw_flow *flow = LookupFlow (&key);
   if (flow != 0)
     {
       NS_LOG_INFO ("Flow matched");
@@ -989,13 +1006,60 @@ OpenFlowSwitchNetDevice::FlowTableLookup (sw_flow_key key, ofpbuf* buffer, uint3
   ofpbuf_delete (buffer);
 }
 
+sw_flow*
+OpenFlowSwitchNetDevice::LookupFlow (sw_flow_key *key)
+{
+  if (m_microflowCacheSize == 0)
+    {
+      return chain_lookup (m_chain, key);
+    }
+
+  MicroflowCache_t::const_iterator it = m_microflowCache.find (key->flow);
+  if (it != m_microflowCache.end ())
+    {
+      m_microflowCacheHits++;
+      return it->second;
+    }
+
+  // Only matches are cached: a miss goes to the controller, which will
+  // usually add a flow and thereby flush the cache anyway.
+  sw_flow *flow = chain_lookup (m_chain, key);
+  if (flow != 0)
+    {
+      if (m_microflowCache.size () >= m_microflowCacheSize)
+        {
+          m_microflowCache.clear ();
+        }
+      m_microflowCache.insert (std::make_pair (key->flow, flow));
+    }
+  return flow;
+}
+
+void
+OpenFlowSwitchNetDevice::FlushMicroflowCache (void)
+{
+  m_microflowCache.clear ();
+}
+
+size_t
+OpenFlowSwitchNetDevice::FlowHash::operator() (const flow &f) const
+{
+  return Hash32 ((const char*)&f, sizeof f);
+}
+
+bool
+OpenFlowSwitchNetDevice::FlowEqual::operator() (const flow &a, const flow &b) const
+{
+  return memcmp (&a, &b, sizeof a) == 0;
+}
+
 void
 OpenFlowSwitchNetDevice::RunThroughFlowTable (uint32_t packet_uid, int port, bool send_to_controller)
 {
-  ofi::SwitchPacketMetadata data = m_packetData.find (packet_uid)->second;
-  ofpbuf* buffer = data.buffer;
+  ofpbuf* buffer = m_packetData.find (packet_uid)->second.buffer;
 
   sw_flow_key key;
+  memset (&key, 0, sizeof key); // The microflow cache compares whole keys.
   key.wildcards = 0; // Lookup cannot take wildcards.
   // Extract the matching key's flow data from the packet's headers; if the policy is to drop fragments and the message is a fragment, drop it.
   if (flow_extract (buffer, port != -1 ? port : OFPP_NONE, &key.flow) && (m_flags & OFPC_FRAG_MASK) == OFPC_FRAG_DROP)
@@ -1277,6 +1341,7 @@ OpenFlowSwitchNetDevice::AddFlow (const ofp_flow_mod *ofm)
 
   // Act.
   int error = chain_insert (m_chain, flow);
+  FlushMicroflowCache ();
   if (error)
     {
       if (error == -ENOBUFS)
@@ -1333,6 +1398,7 @@ OpenFlowSwitchNetDevice::ModFlow (const ofp_flow_mod *ofm)
   uint16_t priority = key.wildcards ? ntohs (ofm->priority) : -1;
   int strict = (ofm->command == htons (OFPFC_MODIFY_STRICT)) ? 1 : 0;
   chain_modify (m_chain, &key, priority, strict, ofm->actions, actions_len);
+  FlushMicroflowCache ();
 
   if (ntohl (ofm->buffer_id) != std::numeric_limits<uint32_t>::max ())
     {
@@ -1371,6 +1437,7 @@ OpenFlowSwitchNetDevice::ReceiveFlow (const void *msg)
     {
       sw_flow_key key;
       flow_extract_match (&key, &ofm->match);
+      FlushMicroflowCache ();
       return chain_delete (m_chain, &key, ofm->out_port, 0, 0) ? 0 : -ESRCH;
     }
   else if (command == OFPFC_DELETE_STRICT)
@@ -1379,6 +1446,7 @@ OpenFlowSwitchNetDevice::ReceiveFlow (const void *msg)
       uint16_t priority;
       flow_extract_match (&key, &ofm->match);
       priority = key.wildcards ? ntohs (ofm->priority) : -1;
+      FlushMicroflowCache ();
       return chain_delete (m_chain, &key, ofm->out_port, priority, 1) ? 0 : -ESRCH;
     }
   else
@@ -1568,6 +1636,12 @@ OpenFlowSwitchNetDevice::GetNSwitchPorts (void) const
   return m_ports.size ();
 }
 
+uint64_t
+OpenFlowSwitchNetDevice::GetMicroflowCacheHits (void) const
+{
+  return m_microflowCacheHits;
+}
+
 ofi::Port
 OpenFlowSwitchNetDevice::GetSwitchPort (uint32_t n) const
 {
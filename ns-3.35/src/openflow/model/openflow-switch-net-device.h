@@ -45,9 +45,12 @@
 
 #include <map>
 #include <set>
+#include <unordered_map>
 
 #include "openflow-interface.h"
 
+class OpenFlowMicroflowCacheTestCase; // Forward declaration for unit test
+
 namespace ns3 {
 
 /**
@@ -85,6 +88,9 @@ namespace ns3 {
  */
 class OpenFlowSwitchNetDevice : public NetDevice
 {
+  /// allow the unit test to access the microflow cache
+  friend class ::OpenFlowMicroflowCacheTestCase;
+
 public:
   /**
    * Register this type.
@@ -204,6 +210,11 @@ public:
    */
   uint32_t GetNSwitchPorts (void) const;
 
+  /**
+   * \return Number of flow table lookups answered by the microflow cache.
+   */
+  uint64_t GetMicroflowCacheHits (void) const;
+
   /**
    * \param p The Port to get the index of.
    * \return The index of the provided Port.
@@ -433,6 +444,28 @@ private:
    */
   void FlowTableLookup (sw_flow_key key, ofpbuf* buffer, uint32_t packet_uid, int port, bool send_to_controller);
 
+  /**
+   * Look up the flow matching an exact key, first in the microflow cache
+   * and then in the flow table. Flows found in the flow table are added
+   * to the cache.
+   *
+   * \param key Exact matching key, as extracted from the packet's headers.
+   * \return The matching flow, or 0 if no flow matches.
+   */
+  sw_flow* LookupFlow (sw_flow_key *key);
+
+  /**
+   * Empty the microflow cache. Called whenever a flow is added to,
+   * modified in or removed from the flow table.
+   */
+  void FlushMicroflowCache (void);
+
+  /**
+   * Delete the expired flows from the flow table and notify the
+   * controller. Called by the periodic execution.
+   */
+  void TimeoutFlows (void);
+
   /**
    * Update the port status field of the switch port.
    * A non-zero return value indicates some field has changed.
@@ -511,6 +544,31 @@ private:
 
   sw_chain *m_chain;             ///< Flow Table; forwarding rules.
   vport_table_t m_vportTable;    ///< Virtual Port Table
+
+  /// Hash of the exact matching fields of a flow key.
+  struct FlowHash
+  {
+    /**
+     * \param f The flow fields of a key.
+     * \return The hash of the fields.
+     */
+    size_t operator() (const flow &f) const;
+  };
+  /// Equality of the exact matching fields of two flow keys.
+  struct FlowEqual
+  {
+    /**
+     * \param a The flow fields of a key.
+     * \param b The flow fields of another key.
+     * \return true if all the fields are equal.
+     */
+    bool operator() (const flow &a, const flow &b) const;
+  };
+  /// Microflow cache: flow table entry matched by each exact key.
+  typedef std::unordered_map<flow, sw_flow*, FlowHash, FlowEqual> MicroflowCache_t;
+  MicroflowCache_t m_microflowCache;    ///< Exact-match cache in front of the flow table.
+  uint32_t m_microflowCacheSize;        ///< Maximum number of keys in the microflow cache.
+  uint64_t m_microflowCacheHits;        ///< Number of lookups answered by the microflow cache.
 };
 
 } // namespace ns3
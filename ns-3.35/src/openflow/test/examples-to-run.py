@@ -9,6 +9,7 @@
 # See test.py for more information.
 cpp_examples = [
     ("openflow-switch", "ENABLE_OPENFLOW == True", "True"),
+    ("openflow-switch-benchmark --nTerminals=4 --duration=1", "ENABLE_OPENFLOW == True", "False"),
 ]
 
 # A list of Python examples to run in order to ensure that they remain
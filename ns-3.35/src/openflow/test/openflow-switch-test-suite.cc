@@ -173,6 +173,153 @@ SwitchFlowTableTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (chain_lookup (m_chain, &key), 0, "Key provided shouldn't match the flow but it does.");
 }
 
+/**
+ * The microflow cache of the OpenFlowSwitchNetDevice must answer the
+ * repeated lookups of a key, and must never return a flow that was
+ * replaced, modified, deleted or expired since it was cached.
+ */
+class OpenFlowMicroflowCacheTestCase : public TestCase
+{
+public:
+  OpenFlowMicroflowCacheTestCase () : TestCase ("Switch microflow cache test case")
+  {
+  }
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Build an exact matching key of a UDP flow.
+   * \param tp_dst The destination port.
+   * \return The key.
+   */
+  sw_flow_key BuildKey (int tp_dst);
+
+  /**
+   * Send a flow modification to the switch, as a controller would.
+   * \param swtch The switch.
+   * \param key The key matched by the flow.
+   * \param command The OFPFC_ command.
+   * \param hard_timeout The hard timeout of the flow, in seconds.
+   * \return The error returned by the switch.
+   */
+  int SendFlowMod (Ptr<OpenFlowSwitchNetDevice> swtch, sw_flow_key key, uint16_t command, uint16_t hard_timeout);
+};
+
+sw_flow_key
+OpenFlowMicroflowCacheTestCase::BuildKey (int tp_dst)
+{
+  sw_flow_key key;
+  memset (&key, 0, sizeof key); // As the switch does before extracting a key.
+  key.wildcards = 0;
+
+  key.flow.in_port = htons (0);
+  key.flow.dl_vlan = htons (OFP_VLAN_NONE);
+  key.flow.dl_type = htons (ETH_TYPE_IP);
+  key.flow.nw_proto = htons (IP_TYPE_UDP);
+  key.flow.mpls_label1 = htonl (MPLS_INVALID_LABEL);
+  key.flow.mpls_label2 = htonl (MPLS_INVALID_LABEL);
+
+  Mac48Address ("00:00:00:00:00:01").CopyTo (key.flow.dl_src);
+  Mac48Address ("00:00:00:00:00:02").CopyTo (key.flow.dl_dst);
+  key.flow.nw_src = htonl (Ipv4Address ("192.168.1.1").Get ());
+  key.flow.nw_dst = htonl (Ipv4Address ("192.168.1.2").Get ());
+  key.flow.tp_src = htonl (5000);
+  key.flow.tp_dst = htonl (tp_dst);
+  return key;
+}
+
+int
+OpenFlowMicroflowCacheTestCase::SendFlowMod (Ptr<OpenFlowSwitchNetDevice> swtch, sw_flow_key key, uint16_t command, uint16_t hard_timeout)
+{
+  // The switch frees the message.
+  ofp_flow_mod* ofm = (ofp_flow_mod*)malloc (sizeof (ofp_flow_mod));
+  memset (ofm, 0, sizeof (ofp_flow_mod));
+  ofm->header.version = OFP_VERSION;
+  ofm->header.type = OFPT_FLOW_MOD;
+  ofm->header.length = htons (sizeof (ofp_flow_mod));
+  ofm->command = htons (command);
+  ofm->idle_timeout = htons (OFP_FLOW_PERMANENT);
+  ofm->hard_timeout = htons (hard_timeout);
+  ofm->buffer_id = htonl (-1);
+  ofm->out_port = htons (OFPP_NONE);
+  ofm->priority = OFP_DEFAULT_PRIORITY;
+
+  ofm->match.wildcards = key.wildcards;
+  ofm->match.in_port = key.flow.in_port;
+  memcpy (ofm->match.dl_src, key.flow.dl_src, sizeof ofm->match.dl_src);
+  memcpy (ofm->match.dl_dst, key.flow.dl_dst, sizeof ofm->match.dl_dst);
+  ofm->match.dl_vlan = key.flow.dl_vlan;
+  ofm->match.dl_type = key.flow.dl_type;
+  ofm->match.nw_proto = key.flow.nw_proto;
+  ofm->match.nw_src = key.flow.nw_src;
+  ofm->match.nw_dst = key.flow.nw_dst;
+  ofm->match.tp_src = key.flow.tp_src;
+  ofm->match.tp_dst = key.flow.tp_dst;
+  ofm->match.mpls_label1 = key.flow.mpls_label1;
+  ofm->match.mpls_label2 = key.flow.mpls_label2;
+
+  return swtch->ForwardControlInput (ofm, sizeof (ofp_flow_mod));
+}
+
+void
+OpenFlowMicroflowCacheTestCase::DoRun (void)
+{
+  time_init (); // OFSI requires this, otherwise we crash before we can do anything.
+
+  Ptr<OpenFlowSwitchNetDevice> swtch = CreateObject<OpenFlowSwitchNetDevice> ();
+  sw_flow_key key = BuildKey (80);
+  sw_flow_key otherKey = BuildKey (8080);
+  sw_flow_key anyKey = BuildKey (80);
+  anyKey.wildcards = htonl (OFPFW_ALL);
+
+  // Cache hit: a key is looked up in the flow table once.
+  NS_TEST_ASSERT_MSG_EQ (SendFlowMod (swtch, anyKey, OFPFC_ADD, OFP_FLOW_PERMANENT), 0, "Cannot add the wildcard flow.");
+  sw_flow *anyFlow = chain_lookup (swtch->m_chain, &key);
+  NS_TEST_ASSERT_MSG_NE (anyFlow, 0, "The wildcard flow does not match.");
+  NS_TEST_EXPECT_MSG_EQ (swtch->LookupFlow (&key), anyFlow, "Wrong flow on a cache miss.");
+  NS_TEST_EXPECT_MSG_EQ (swtch->GetMicroflowCacheHits (), 0, "A miss was counted as a hit.");
+  NS_TEST_EXPECT_MSG_EQ (swtch->LookupFlow (&key), anyFlow, "Wrong flow on a cache hit.");
+  NS_TEST_EXPECT_MSG_EQ (swtch->GetMicroflowCacheHits (), 1, "The cache did not answer a repeated lookup.");
+  NS_TEST_EXPECT_MSG_EQ (swtch->LookupFlow (&otherKey), anyFlow, "Wrong flow for another key.");
+  NS_TEST_EXPECT_MSG_EQ (swtch->m_microflowCache.size (), 2, "The keys were not cached.");
+
+  // Add: an exact flow takes precedence over the cached wildcard flow.
+  NS_TEST_ASSERT_MSG_EQ (SendFlowMod (swtch, key, OFPFC_ADD, OFP_FLOW_PERMANENT), 0, "Cannot add the exact flow.");
+  NS_TEST_EXPECT_MSG_EQ (swtch->m_microflowCache.empty (), true, "The cache was not flushed by an addition.");
+  sw_flow *exactFlow = swtch->LookupFlow (&key);
+  NS_TEST_ASSERT_MSG_NE (exactFlow, 0, "No flow matches after the addition.");
+  NS_TEST_EXPECT_MSG_NE (exactFlow, anyFlow, "The replaced wildcard flow was returned.");
+  NS_TEST_EXPECT_MSG_EQ (swtch->LookupFlow (&key), exactFlow, "Wrong flow on a cache hit.");
+
+  // Modify: the flow is looked up again in the flow table.
+  uint64_t hits = swtch->GetMicroflowCacheHits ();
+  NS_TEST_ASSERT_MSG_EQ (SendFlowMod (swtch, key, OFPFC_MODIFY_STRICT, OFP_FLOW_PERMANENT), 0, "Cannot modify the exact flow.");
+  NS_TEST_EXPECT_MSG_EQ (swtch->m_microflowCache.empty (), true, "The cache was not flushed by a modification.");
+  NS_TEST_EXPECT_MSG_EQ (swtch->LookupFlow (&key), chain_lookup (swtch->m_chain, &key), "Wrong flow after the modification.");
+  NS_TEST_EXPECT_MSG_EQ (swtch->GetMicroflowCacheHits (), hits, "A lookup after a modification was answered by the cache.");
+
+  // Delete: the wildcard flow matches again, then no flow at all.
+  NS_TEST_ASSERT_MSG_EQ (SendFlowMod (swtch, key, OFPFC_DELETE_STRICT, OFP_FLOW_PERMANENT), 0, "Cannot delete the exact flow.");
+  NS_TEST_EXPECT_MSG_EQ (swtch->m_microflowCache.empty (), true, "The cache was not flushed by a deletion.");
+  NS_TEST_EXPECT_MSG_EQ (swtch->LookupFlow (&key), anyFlow, "A deleted flow was returned.");
+  NS_TEST_ASSERT_MSG_EQ (SendFlowMod (swtch, anyKey, OFPFC_DELETE, OFP_FLOW_PERMANENT), 0, "Cannot delete the wildcard flow.");
+  NS_TEST_EXPECT_MSG_EQ (swtch->LookupFlow (&key), 0, "A deleted flow was returned.");
+  NS_TEST_EXPECT_MSG_EQ (swtch->m_microflowCache.empty (), true, "A miss was cached.");
+
+  // Timeout: an expired flow is not returned.
+  NS_TEST_ASSERT_MSG_EQ (SendFlowMod (swtch, key, OFPFC_ADD, 1), 0, "Cannot add the expiring flow.");
+  exactFlow = swtch->LookupFlow (&key);
+  NS_TEST_ASSERT_MSG_NE (exactFlow, 0, "The expiring flow does not match.");
+  NS_TEST_EXPECT_MSG_EQ (swtch->m_microflowCache.size (), 1, "The key was not cached.");
+  exactFlow->created -= 10; // Rather than waiting for the hard timeout.
+  swtch->TimeoutFlows ();
+  NS_TEST_EXPECT_MSG_EQ (swtch->m_microflowCache.empty (), true, "The cache was not flushed by a timeout.");
+  NS_TEST_EXPECT_MSG_EQ (swtch->LookupFlow (&key), 0, "An expired flow was returned.");
+
+  swtch->Dispose ();
+}
+
 class SwitchTestSuite : public TestSuite
 {
 public:
@@ -182,6 +329,7 @@ public:
 SwitchTestSuite::SwitchTestSuite () : TestSuite ("openflow", UNIT)
 {
   AddTestCase (new SwitchFlowTableTestCase, TestCase::QUICK);
+  AddTestCase (new OpenFlowMicroflowCacheTestCase, TestCase::QUICK);
 }
 
 // Do not forget to allocate an instance of this TestSuite
@@ -25,6 +25,8 @@
 #include "ns3/node.h"
 #include "ns3/simulator.h"
 #include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include <limits>
 
 namespace ns3 {
 
@@ -289,12 +291,20 @@ ThreeGppChannelConditionModel::GetTypeId (void)
                    TimeValue (MilliSeconds (0)),
                    MakeTimeAccessor (&ThreeGppChannelConditionModel::m_updatePeriod),
                    MakeTimeChecker ())
+    .AddAttribute ("MaxCachedLinks", "The maximum number of links whose channel condition is cached. "
+                   "When the limit is reached, the least recently used condition is evicted. "
+                   "If set to 0, the number of cached links is not limited.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&ThreeGppChannelConditionModel::SetMaxCachedLinks,
+                                         &ThreeGppChannelConditionModel::GetMaxCachedLinks),
+                   MakeUintegerChecker<uint32_t> ())
   ;
   return tid;
 }
 
 ThreeGppChannelConditionModel::ThreeGppChannelConditionModel ()
-  : ChannelConditionModel ()
+  : ChannelConditionModel (),
+    m_linkSalt (0)
 {
   m_uniformVar = CreateObject<UniformRandomVariable> ();
   m_uniformVar->SetAttribute ("Min", DoubleValue (0));
@@ -306,10 +316,29 @@ ThreeGppChannelConditionModel::~ThreeGppChannelConditionModel ()
 
 void ThreeGppChannelConditionModel::DoDispose ()
 {
-  m_channelConditionMap.clear ();
+  m_channelConditionCache.Clear ();
   m_updatePeriod = Seconds (0.0);
 }
 
+void
+ThreeGppChannelConditionModel::SetMaxCachedLinks (uint32_t maxLinks)
+{
+  NS_LOG_FUNCTION (this << maxLinks);
+  m_channelConditionCache.SetCapacity (maxLinks);
+}
+
+uint32_t
+ThreeGppChannelConditionModel::GetMaxCachedLinks (void) const
+{
+  return m_channelConditionCache.GetCapacity ();
+}
+
+LinkStateCacheStats
+ThreeGppChannelConditionModel::GetCacheStats (void) const
+{
+  return m_channelConditionCache.GetStats ();
+}
+
 Ptr<ChannelCondition>
 ThreeGppChannelConditionModel::GetChannelCondition (Ptr<const MobilityModel> a,
                                                     Ptr<const MobilityModel> b) const
@@ -322,15 +351,19 @@ ThreeGppChannelConditionModel::GetChannelCondition (Ptr<const MobilityModel> a,
   bool notFound = false; // indicates if the channel condition is not present in the map
   bool update = false; // indicates if the channel condition has to be updated
 
-  // look for the channel condition in m_channelConditionMap
-  auto mapItem = m_channelConditionMap.find (key);
-  if (mapItem != m_channelConditionMap.end ())
+  // look for the channel condition in m_channelConditionCache
+  Item *cacheItem = m_channelConditionCache.Find (key);
+  if (cacheItem != nullptr)
     {
       NS_LOG_DEBUG ("found the channel condition in the map");
-      cond = mapItem->second.m_condition;
-
-      // check if it has to be updated
-      if (!m_updatePeriod.IsZero () && Simulator::Now () - mapItem->second.m_generatedTime > m_updatePeriod)
+      cond = cacheItem->m_condition;
+
+      // check if it has to be updated. If the cache is bounded, the
+      // conditions are updated at the beginning of each update period, as
+      // the random value of an evicted condition only depends on the period
+      if (!m_updatePeriod.IsZero ()
+          && ((GetMaxCachedLinks () > 0) ? GetUpdateEpoch (Simulator::Now ()) != GetUpdateEpoch (cacheItem->m_generatedTime)
+                                         : Simulator::Now () - cacheItem->m_generatedTime > m_updatePeriod))
         {
           NS_LOG_DEBUG ("it has to be updated");
           update = true;
@@ -346,13 +379,12 @@ ThreeGppChannelConditionModel::GetChannelCondition (Ptr<const MobilityModel> a,
   // generate a new channel condition
   if (notFound || update)
     {
-      cond = ComputeChannelCondition (a, b);
-      // store the channel condition in m_channelConditionMap, used as cache.
-      // For this reason you see a const_cast.
-      Item mapItem;
-      mapItem.m_condition = cond;
-      mapItem.m_generatedTime = Simulator::Now ();
-      const_cast<ThreeGppChannelConditionModel*> (this)->m_channelConditionMap [key] = mapItem;
+      cond = ComputeChannelCondition (a, b, key);
+      // store the channel condition in m_channelConditionCache
+      Item newItem;
+      newItem.m_condition = cond;
+      newItem.m_generatedTime = Simulator::Now ();
+      m_channelConditionCache.Insert (key, newItem);
     }
 
   return cond;
@@ -360,17 +392,19 @@ ThreeGppChannelConditionModel::GetChannelCondition (Ptr<const MobilityModel> a,
 
 Ptr<ChannelCondition>
 ThreeGppChannelConditionModel::ComputeChannelCondition (Ptr<const MobilityModel> a,
-                                                        Ptr<const MobilityModel> b) const
+                                                        Ptr<const MobilityModel> b,
+                                                        uint32_t key) const
 {
-  NS_LOG_FUNCTION (this << a << b);
+  NS_LOG_FUNCTION (this << a << b << key);
   Ptr<ChannelCondition> cond = CreateObject<ChannelCondition> ();
 
   // compute the LOS probability
   double pLos = ComputePlos (a, b);
   double pNlos = ComputePnlos (a, b);
 
-  // draw a random value
-  double pRef = m_uniformVar->GetValue ();
+  // draw a random value. If the cache is bounded, the value is derived from
+  // the link, so that an evicted condition is regenerated consistently
+  double pRef = (GetMaxCachedLinks () > 0) ? GetLinkUniformValue (key) : m_uniformVar->GetValue ();
 
   NS_LOG_DEBUG ("pRef " << pRef << " pLos " << pLos << " pNlos " << pNlos);
 
@@ -403,10 +437,47 @@ ThreeGppChannelConditionModel::ComputePnlos (Ptr<const MobilityModel> a,
   return (1 - ComputePlos (a, b));
 }
 
+double
+ThreeGppChannelConditionModel::GetLinkUniformValue (uint32_t key) const
+{
+  NS_LOG_FUNCTION (this << key);
+  if (m_linkSalt == 0)
+    {
+      m_linkSalt = m_uniformVar->GetInteger (1, std::numeric_limits<uint32_t>::max ());
+    }
+  uint64_t epoch = GetUpdateEpoch (Simulator::Now ());
+
+  // mix the salt, the key and the update period with the SplitMix64 finalizer
+  auto mix = [] (uint64_t x)
+    {
+      x ^= x >> 30;
+      x *= 0xbf58476d1ce4e5b9ULL;
+      x ^= x >> 27;
+      x *= 0x94d049bb133111ebULL;
+      x ^= x >> 31;
+      return x;
+    };
+  uint64_t x = mix (mix ((m_linkSalt << 32) | key) ^ epoch);
+
+  // use the 53 most significant bits to obtain a value in [0, 1)
+  return (x >> 11) * (1.0 / 9007199254740992.0);
+}
+
+uint64_t
+ThreeGppChannelConditionModel::GetUpdateEpoch (Time t) const
+{
+  if (m_updatePeriod.IsZero ())
+    {
+      return 0;
+    }
+  return t.GetTimeStep () / m_updatePeriod.GetTimeStep ();
+}
+
 int64_t
 ThreeGppChannelConditionModel::AssignStreams (int64_t stream)
 {
   m_uniformVar->SetStream (stream);
+  m_linkSalt = 0;
   return 1;
 }
 
@@ -24,6 +24,7 @@
 #include "ns3/random-variable-stream.h"
 #include "ns3/vector.h"
 #include "ns3/nstime.h"
+#include "ns3/link-state-cache.h"
 #include <unordered_map>
 
 namespace ns3 {
@@ -470,6 +471,16 @@ public:
    * ComputeChannelCondition and stores it in a local cache, that will be updated 
    * following the "UpdatePeriod" parameter.
    *
+   * If the size of the cache is bounded (see the "MaxCachedLinks" attribute),
+   * the random value used to determine the condition of a link is derived
+   * from the link identifier and from the current update period, and the
+   * conditions are updated at the beginning of each update period (i.e., at
+   * multiples of "UpdatePeriod") rather than "UpdatePeriod" after they were
+   * generated. A condition evicted from the cache and regenerated during the
+   * same update period thus uses the same random value, and is the same as
+   * if it had not been evicted unless the LOS probability of the link has
+   * changed in the meantime (e.g., because the nodes moved).
+   *
    * \param a mobility model
    * \param b mobility model
    * \return the condition of the channel between a and b
@@ -487,6 +498,24 @@ public:
    */
   virtual int64_t AssignStreams (int64_t stream) override;
 
+  /**
+   * Set the maximum number of links whose condition is cached. When the
+   * limit is reached, the least recently used condition is evicted.
+   *
+   * \param maxLinks the maximum number of cached links, 0 for no limit
+   */
+  void SetMaxCachedLinks (uint32_t maxLinks);
+
+  /**
+   * \return the maximum number of cached links, 0 for no limit
+   */
+  uint32_t GetMaxCachedLinks (void) const;
+
+  /**
+   * \return the usage counters of the cache of channel conditions
+   */
+  LinkStateCacheStats GetCacheStats (void) const;
+
 protected:
   virtual void DoDispose () override;
   
@@ -518,9 +547,29 @@ private:
   *
   * \param a tx mobility model
   * \param b rx mobility model
+  * \param key the channel key
   * \return the channel condition
   */
-  Ptr<ChannelCondition> ComputeChannelCondition (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b) const;
+  Ptr<ChannelCondition> ComputeChannelCondition (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b, uint32_t key) const;
+
+  /**
+   * Returns a uniform random value in [0, 1) that only depends on the
+   * channel key, on the current update period and on the stream assigned
+   * to this model. Used when the cache of channel conditions is bounded.
+   *
+   * \param key the channel key
+   * \return the random value
+   */
+  double GetLinkUniformValue (uint32_t key) const;
+
+  /**
+   * Returns the index of the update period containing a given time, or 0
+   * if the channel conditions are never updated.
+   *
+   * \param t the time
+   * \return the index of the update period
+   */
+  uint64_t GetUpdateEpoch (Time t) const;
   
   /**
    * Compute the LOS probability.
@@ -549,7 +598,7 @@ private:
   static uint32_t GetKey (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b);
 
   /**
-   * Struct to store the channel condition in the m_channelConditionMap
+   * Struct to store the channel condition in the m_channelConditionCache
    */
   struct Item
   {
@@ -557,7 +606,8 @@ private:
     Time m_generatedTime; //!< the time when the condition was generated
   };
 
-  std::unordered_map<uint32_t, Item> m_channelConditionMap; //!< map to store the channel conditions
+  mutable LinkStateCache<Item> m_channelConditionCache; //!< cache of the channel conditions
+  mutable uint64_t m_linkSalt; //!< seed of the per-link random values, 0 if not drawn yet
   Time m_updatePeriod; //!< the update period for the channel condition
 };
 
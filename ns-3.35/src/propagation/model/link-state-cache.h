@@ -0,0 +1,187 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef LINK_STATE_CACHE_H
+#define LINK_STATE_CACHE_H
+
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace ns3
+{
+
+/**
+ * \ingroup propagation
+ * \brief Counters describing the usage of a LinkStateCache
+ */
+struct LinkStateCacheStats
+{
+  uint64_t m_hits {0};        //!< number of lookups that found the link state
+  uint64_t m_misses {0};      //!< number of lookups that did not find the link state
+  uint64_t m_evictions {0};   //!< number of link states evicted to respect the capacity
+  std::size_t m_size {0};     //!< number of link states currently stored
+  std::size_t m_memory {0};   //!< estimate of the memory used by the cache, in bytes
+};
+
+/**
+ * \ingroup propagation
+ * \brief Cache of per-link state (e.g., channel condition, shadowing or
+ * channel matrix) keyed by a reciprocal link identifier.
+ *
+ * If a capacity is set, the least recently used link state is evicted
+ * when a new link state has to be stored in a full cache. A capacity of
+ * zero means that the cache is unbounded, in which case the recency
+ * order is not maintained.
+ *
+ * The memory estimate accounts for the container nodes, the buckets of
+ * the index and the stored values, not for the memory referenced by the
+ * stored values (e.g., the content of a channel matrix).
+ */
+template<class T>
+class LinkStateCache
+{
+public:
+  LinkStateCache ()
+    : m_capacity (0)
+  {}
+
+  /**
+   * Set the maximum number of link states stored in the cache, evicting
+   * the least recently used ones if needed
+   * \param capacity the maximum number of link states, zero for no limit
+   */
+  void SetCapacity (std::size_t capacity)
+  {
+    m_capacity = capacity;
+    EvictIfNeeded ();
+  }
+
+  /**
+   * \return the maximum number of link states stored in the cache, zero for no limit
+   */
+  std::size_t GetCapacity (void) const
+  {
+    return m_capacity;
+  }
+
+  /**
+   * Look up the state of a link and mark it as the most recently used
+   * \param key the link identifier
+   * \return a pointer to the link state, or nullptr if it is not stored
+   */
+  T* Find (uint32_t key)
+  {
+    auto it = m_index.find (key);
+    if (it == m_index.end ())
+      {
+        m_stats.m_misses++;
+        return nullptr;
+      }
+    m_stats.m_hits++;
+    if (m_capacity > 0)
+      {
+        m_lru.splice (m_lru.begin (), m_lru, it->second);
+      }
+    return &it->second->second;
+  }
+
+  /**
+   * Store or replace the state of a link, marking it as the most recently
+   * used. If the cache is full, the least recently used link state is evicted.
+   * \param key the link identifier
+   * \param value the link state
+   * \return a reference to the stored link state
+   */
+  T& Insert (uint32_t key, const T& value)
+  {
+    auto it = m_index.find (key);
+    if (it != m_index.end ())
+      {
+        it->second->second = value;
+        if (m_capacity > 0)
+          {
+            m_lru.splice (m_lru.begin (), m_lru, it->second);
+          }
+        return it->second->second;
+      }
+    m_lru.emplace_front (key, value);
+    m_index.emplace (key, m_lru.begin ());
+    EvictIfNeeded ();
+    return m_lru.front ().second;
+  }
+
+  /**
+   * Remove all the link states. The counters are not reset.
+   */
+  void Clear (void)
+  {
+    m_index.clear ();
+    m_lru.clear ();
+  }
+
+  /**
+   * \return the number of link states stored in the cache
+   */
+  std::size_t GetSize (void) const
+  {
+    return m_index.size ();
+  }
+
+  /**
+   * \return the usage counters of the cache
+   */
+  LinkStateCacheStats GetStats (void) const
+  {
+    LinkStateCacheStats stats = m_stats;
+    stats.m_size = m_index.size ();
+    // a list node holds two pointers, an index node holds the next pointer,
+    // the cached hash code and its value
+    stats.m_memory = sizeof (*this)
+      + m_lru.size () * (2 * sizeof (void*) + sizeof (typename List::value_type))
+      + m_index.size () * (2 * sizeof (void*) + sizeof (typename Index::value_type))
+      + m_index.bucket_count () * sizeof (void*);
+    return stats;
+  }
+
+private:
+  /// List of link states, from the most to the least recently used
+  typedef std::list<std::pair<uint32_t, T> > List;
+  /// Index of the link states
+  typedef std::unordered_map<uint32_t, typename List::iterator> Index;
+
+  /**
+   * Evict the least recently used link states until the capacity is respected
+   */
+  void EvictIfNeeded (void)
+  {
+    while (m_capacity > 0 && m_index.size () > m_capacity)
+      {
+        m_index.erase (m_lru.back ().first);
+        m_lru.pop_back ();
+        m_stats.m_evictions++;
+      }
+  }
+
+  std::size_t m_capacity;       //!< maximum number of link states, zero for no limit
+  List m_lru;                   //!< link states, from the most to the least recently used
+  Index m_index;                //!< index of the link states
+  LinkStateCacheStats m_stats;  //!< usage counters
+};
+
+} // namespace ns3
+
+#endif // LINK_STATE_CACHE_H
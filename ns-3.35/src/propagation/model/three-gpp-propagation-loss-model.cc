@@ -24,6 +24,7 @@
 #include "ns3/double.h"
 #include "ns3/boolean.h"
 #include "ns3/pointer.h"
+#include "ns3/uinteger.h"
 #include <cmath>
 #include "ns3/node.h"
 #include "ns3/simulator.h"
@@ -58,6 +59,13 @@ ThreeGppPropagationLossModel::GetTypeId (void)
                    MakePointerAccessor (&ThreeGppPropagationLossModel::SetChannelConditionModel,
                                         &ThreeGppPropagationLossModel::GetChannelConditionModel),
                    MakePointerChecker<ChannelConditionModel> ())
+    .AddAttribute ("MaxCachedLinks", "The maximum number of links whose shadowing value is cached. "
+                   "When the limit is reached, the least recently used value is evicted. "
+                   "If set to 0, the number of cached links is not limited.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&ThreeGppPropagationLossModel::SetMaxCachedLinks,
+                                         &ThreeGppPropagationLossModel::GetMaxCachedLinks),
+                   MakeUintegerChecker<uint32_t> ())
   ;
   return tid;
 }
@@ -83,7 +91,26 @@ ThreeGppPropagationLossModel::DoDispose ()
 {
   m_channelConditionModel->Dispose ();
   m_channelConditionModel = nullptr;
-  m_shadowingMap.clear ();
+  m_shadowingCache.Clear ();
+}
+
+void
+ThreeGppPropagationLossModel::SetMaxCachedLinks (uint32_t maxLinks)
+{
+  NS_LOG_FUNCTION (this << maxLinks);
+  m_shadowingCache.SetCapacity (maxLinks);
+}
+
+uint32_t
+ThreeGppPropagationLossModel::GetMaxCachedLinks (void) const
+{
+  return m_shadowingCache.GetCapacity ();
+}
+
+LinkStateCacheStats
+ThreeGppPropagationLossModel::GetCacheStats (void) const
+{
+  return m_shadowingCache.GetStats ();
 }
 
 void
@@ -195,21 +222,19 @@ ThreeGppPropagationLossModel::GetShadowing (Ptr<MobilityModel> a, Ptr<MobilityMo
   bool notFound = false; // indicates if the shadowing value has not been computed yet
   bool newCondition = false; // indicates if the channel condition has changed
   Vector newDistance; // the distance vector, that is not a distance but a difference
-  auto it = m_shadowingMap.end (); // the shadowing map iterator
-  if (m_shadowingMap.find (key) != m_shadowingMap.end ())
+  ShadowingMapItem *item = m_shadowingCache.Find (key); // the cached shadowing value
+  if (item != nullptr)
     {
       // found the shadowing value in the map
-      it = m_shadowingMap.find (key);
       newDistance = GetVectorDifference (a, b);
-      newCondition = (it->second.m_condition != cond); // true if the condition changed
+      newCondition = (item->m_condition != cond); // true if the condition changed
     }
   else
     {
       notFound = true;
 
-      // add a new entry in the map and update the iterator
-      ShadowingMapItem newItem;
-      it = m_shadowingMap.insert (it, std::make_pair (key, newItem));
+      // add a new entry in the map and update the pointer
+      item = &m_shadowingCache.Insert (key, ShadowingMapItem ());
     }
 
   if (notFound || newCondition)
@@ -220,15 +245,15 @@ ThreeGppPropagationLossModel::GetShadowing (Ptr<MobilityModel> a, Ptr<MobilityMo
   else
     {
       // compute a new correlated shadowing loss
-      Vector2D displacement (newDistance.x - it->second.m_distance.x, newDistance.y - it->second.m_distance.y);
+      Vector2D displacement (newDistance.x - item->m_distance.x, newDistance.y - item->m_distance.y);
       double R = exp (-1 * displacement.GetLength () / GetShadowingCorrelationDistance (cond));
-      shadowingValue =  R * it->second.m_shadowing + sqrt (1 - R * R) * m_normRandomVariable->GetValue () * GetShadowingStd (a, b, cond);
+      shadowingValue =  R * item->m_shadowing + sqrt (1 - R * R) * m_normRandomVariable->GetValue () * GetShadowingStd (a, b, cond);
     }
 
   // update the entry in the map
-  it->second.m_shadowing = shadowingValue;
-  it->second.m_distance = newDistance; // Save the (0,0,0) vector in case it's the first time we are calculating this value
-  it->second.m_condition = cond;
+  item->m_shadowing = shadowingValue;
+  item->m_distance = newDistance; // Save the (0,0,0) vector in case it's the first time we are calculating this value
+  item->m_condition = cond;
 
   return shadowingValue;
 }
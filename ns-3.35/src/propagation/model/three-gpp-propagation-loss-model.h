@@ -22,6 +22,7 @@
 
 #include "ns3/propagation-loss-model.h"
 #include "ns3/channel-condition-model.h"
+#include "ns3/link-state-cache.h"
 
 namespace ns3 {
 
@@ -72,6 +73,27 @@ public:
    */
   double GetFrequency (void) const;
 
+  /**
+   * \brief Set the maximum number of links whose shadowing is cached. When
+   *        the limit is reached, the least recently used value is evicted
+   *        and, if the link is used again, a new independent realization
+   *        is generated, as done when the channel condition changes.
+   * \param maxLinks the maximum number of cached links, 0 for no limit
+   */
+  void SetMaxCachedLinks (uint32_t maxLinks);
+
+  /**
+   * \brief Return the maximum number of links whose shadowing is cached
+   * \return the maximum number of cached links, 0 for no limit
+   */
+  uint32_t GetMaxCachedLinks (void) const;
+
+  /**
+   * \brief Return the usage counters of the cache of shadowing values
+   * \return the usage counters
+   */
+  LinkStateCacheStats GetCacheStats (void) const;
+
   /**
    * \brief Copy constructor
    *
@@ -168,7 +190,7 @@ private:
   virtual std::pair<double, double> GetUtAndBsHeights (double za, double zb) const;
 
   /**
-   * \brief Retrieves the shadowing value by looking at m_shadowingMap.
+   * \brief Retrieves the shadowing value by looking at m_shadowingCache.
    *        If not found or if the channel condition changed it generates a new
    *        independent realization and stores it in the map, otherwise it correlates
    *        the new value with the previous one using the autocorrelation function
@@ -237,7 +259,7 @@ protected:
   bool m_shadowingEnabled; //!< enable/disable shadowing
   Ptr<NormalRandomVariable> m_normRandomVariable; //!< normal random variable
 
-  /** Define a struct for the m_shadowingMap entries */
+  /** Define a struct for the m_shadowingCache entries */
   struct ShadowingMapItem
   {
     double m_shadowing; //!< the shadowing loss in dB
@@ -245,7 +267,7 @@ protected:
     Vector m_distance; //!< the vector AB
   };
 
-  mutable std::unordered_map<uint32_t, ShadowingMapItem> m_shadowingMap; //!< map to store the shadowing values
+  mutable LinkStateCache<ShadowingMapItem> m_shadowingCache; //!< cache of the shadowing values
 };
 
 /**
@@ -26,6 +26,8 @@
 #include "ns3/constant-position-mobility-model.h"
 #include "ns3/simulator.h"
 #include "ns3/node-container.h"
+#include "ns3/uinteger.h"
+#include "ns3/random-variable-stream.h"
 
 using namespace ns3;
 
@@ -262,6 +264,165 @@ ThreeGppChannelConditionModelTestCase::DoRun (void)
     }
 }
 
+/**
+ * Test case for the bounded cache of the 3GPP channel condition models.
+ * It checks the LRU eviction, the cache counters and that conditions
+ * evicted from the cache are regenerated consistently, while still
+ * following the LOS probability given by 3GPP TR 38.901.
+ */
+class ThreeGppChannelConditionCacheTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   */
+  ThreeGppChannelConditionCacheTestCase ();
+
+private:
+  /**
+   * Builds the simulation scenario and perform the tests
+   */
+  virtual void DoRun (void);
+
+  /**
+   * Evaluates the channel condition between two nodes and increments
+   * m_numLos if it is LOS
+   * \param a the mobility model of the first node
+   * \param b the mobility model of the second node
+   */
+  void EvaluateChannelCondition (Ptr<MobilityModel> a, Ptr<MobilityModel> b);
+
+  /**
+   * Checks that the channel condition between two nodes given by a model
+   * whose cache evicts it is the same as the one given by a model which
+   * keeps it
+   * \param evicting the model with a small cache
+   * \param keeping the model with a cache large enough for all the links
+   * \param a the mobility model of the first node
+   * \param b the mobility model of the second node
+   */
+  void CompareChannelCondition (Ptr<ThreeGppChannelConditionModel> evicting, Ptr<ThreeGppChannelConditionModel> keeping,
+                                Ptr<MobilityModel> a, Ptr<MobilityModel> b);
+
+  Ptr<ThreeGppChannelConditionModel> m_condModel; //!< the channel condition model
+  uint64_t m_numLos; //!< the number of LOS occurrences
+};
+
+ThreeGppChannelConditionCacheTestCase::ThreeGppChannelConditionCacheTestCase ()
+  : TestCase ("Test case for the bounded cache of ThreeGppChannelConditionModel"),
+    m_numLos (0)
+{
+}
+
+void
+ThreeGppChannelConditionCacheTestCase::EvaluateChannelCondition (Ptr<MobilityModel> a, Ptr<MobilityModel> b)
+{
+  if (m_condModel->GetChannelCondition (a, b)->IsLos ())
+    {
+      m_numLos++;
+    }
+}
+
+void
+ThreeGppChannelConditionCacheTestCase::CompareChannelCondition (Ptr<ThreeGppChannelConditionModel> evicting,
+                                                                Ptr<ThreeGppChannelConditionModel> keeping,
+                                                                Ptr<MobilityModel> a, Ptr<MobilityModel> b)
+{
+  NS_TEST_ASSERT_MSG_EQ (evicting->GetChannelCondition (a, b)->GetLosCondition (),
+                         keeping->GetChannelCondition (a, b)->GetLosCondition (),
+                         "Evicted channel condition regenerated differently at " << Simulator::Now ().As (Time::MS));
+}
+
+void
+ThreeGppChannelConditionCacheTestCase::DoRun (void)
+{
+  LinkStateCache<int> cache;
+  cache.SetCapacity (2);
+  cache.Insert (1, 10);
+  cache.Insert (2, 20);
+  NS_TEST_ASSERT_MSG_EQ (*cache.Find (1), 10, "Unexpected cached value");
+  cache.Insert (3, 30); // evicts 2, the least recently used
+  NS_TEST_ASSERT_MSG_EQ ((cache.Find (2) == nullptr), true, "Link 2 should have been evicted");
+  NS_TEST_ASSERT_MSG_EQ (*cache.Find (3), 30, "Unexpected cached value");
+  LinkStateCacheStats stats = cache.GetStats ();
+  NS_TEST_ASSERT_MSG_EQ (stats.m_hits, 2, "Unexpected number of hits");
+  NS_TEST_ASSERT_MSG_EQ (stats.m_misses, 1, "Unexpected number of misses");
+  NS_TEST_ASSERT_MSG_EQ (stats.m_evictions, 1, "Unexpected number of evictions");
+  NS_TEST_ASSERT_MSG_EQ (stats.m_size, 2, "Unexpected cache size");
+
+  // a base station and 40 users at 50 m, whose links are evaluated twice
+  // by a channel condition model caching only 10 links
+  NodeContainer nodes;
+  nodes.Create (41);
+  std::vector<Ptr<MobilityModel> > mobility;
+  for (uint32_t i = 0; i < nodes.GetN (); ++i)
+    {
+      Ptr<MobilityModel> m = CreateObject<ConstantPositionMobilityModel> ();
+      double angle = 2 * M_PI * i / (nodes.GetN () - 1);
+      m->SetPosition (i == 0 ? Vector (0, 0, 25.0) : Vector (50 * cos (angle), 50 * sin (angle), 1.5));
+      nodes.Get (i)->AggregateObject (m);
+      mobility.push_back (m);
+    }
+
+  m_condModel = CreateObject<ThreeGppUmaChannelConditionModel> ();
+  m_condModel->SetAttribute ("MaxCachedLinks", UintegerValue (10));
+  std::vector<ChannelCondition::LosConditionValue> first;
+  for (uint32_t i = 1; i < nodes.GetN (); ++i)
+    {
+      first.push_back (m_condModel->GetChannelCondition (mobility[0], mobility[i])->GetLosCondition ());
+    }
+  for (uint32_t i = 1; i < nodes.GetN (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_condModel->GetChannelCondition (mobility[0], mobility[i])->GetLosCondition (),
+                             first[i - 1], "Evicted channel condition was not regenerated consistently");
+    }
+  stats = m_condModel->GetCacheStats ();
+  NS_TEST_ASSERT_MSG_EQ (stats.m_size, 10, "Unexpected number of cached links");
+  NS_TEST_ASSERT_MSG_EQ (stats.m_misses, 80, "Unexpected number of misses");
+  NS_TEST_ASSERT_MSG_EQ (stats.m_evictions, 70, "Unexpected number of evictions");
+
+  // with updates, a condition evicted and regenerated is the same as the
+  // one kept by a model caching all the links, whenever it is evicted
+  Ptr<ThreeGppChannelConditionModel> evicting = CreateObject<ThreeGppUmaChannelConditionModel> ();
+  Ptr<ThreeGppChannelConditionModel> keeping = CreateObject<ThreeGppUmaChannelConditionModel> ();
+  Ptr<ThreeGppChannelConditionModel> models[2] = {evicting, keeping};
+  for (uint32_t i = 0; i < 2; ++i)
+    {
+      models[i]->SetAttribute ("MaxCachedLinks", UintegerValue (i == 0 ? 2 : 1000));
+      models[i]->SetAttribute ("UpdatePeriod", TimeValue (MilliSeconds (100)));
+      models[i]->AssignStreams (1);
+    }
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  rng->SetStream (2);
+  for (uint32_t j = 0; j < 2000; j++)
+    {
+      Time t = MicroSeconds (rng->GetInteger (0, 2000000));
+      uint32_t i = rng->GetInteger (1, 10);
+      Simulator::Schedule (t, &ThreeGppChannelConditionCacheTestCase::CompareChannelCondition, this,
+                           evicting, keeping, mobility[0], mobility[i]);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+  NS_TEST_ASSERT_MSG_GT (evicting->GetCacheStats ().m_evictions, 100, "Too few evictions to test the regeneration");
+
+  // the conditions regenerated at each update period follow the LOS probability
+  m_condModel = CreateObject<ThreeGppUmaChannelConditionModel> ();
+  m_condModel->SetAttribute ("MaxCachedLinks", UintegerValue (1));
+  m_condModel->SetAttribute ("UpdatePeriod", TimeValue (MilliSeconds (9)));
+  uint32_t numberOfReps = 10000;
+  m_numLos = 0;
+  for (uint32_t j = 0; j < numberOfReps; j++)
+    {
+      Simulator::Schedule (MilliSeconds (10 * j), &ThreeGppChannelConditionCacheTestCase::EvaluateChannelCondition, this, mobility[0], mobility[1]);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  double pLos = (18.0 / 50.0 + exp (-50.0 / 63.0) * (1.0 - 18.0 / 50.0));
+  NS_TEST_EXPECT_MSG_EQ_TOL (double (m_numLos) / numberOfReps, pLos, 0.02, "Got unexpected LOS probability");
+  m_condModel = nullptr;
+}
+
 /**
  * Test suite for the channel condition models
  */
@@ -275,6 +436,7 @@ ChannelConditionModelsTestSuite::ChannelConditionModelsTestSuite ()
   : TestSuite ("propagation-channel-condition-model", UNIT)
 {
   AddTestCase (new ThreeGppChannelConditionModelTestCase, TestCase::QUICK);
+  AddTestCase (new ThreeGppChannelConditionCacheTestCase, TestCase::QUICK);
 }
 
 static ChannelConditionModelsTestSuite ChannelConditionModelsTestSuite;
@@ -0,0 +1,218 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+// This example measures the throughput of the 6LoWPAN IPHC codec, in
+// packets per second of wall clock time.
+//
+// - "header" serializes and deserializes IPHC and UDP NHC headers.
+// - "stateless" and "stateful" send IPv6/UDP packets through a
+//   SixLowPanNetDevice, whose compressed frames are delivered to a second
+//   SixLowPanNetDevice by a SimpleChannel.  The addresses are either
+//   link-local ones (stateless compression) or global ones matching a
+//   compression context (stateful compression).
+//
+// ./waf --run "example-sixlowpan-codec-benchmark --nPackets=200000"
+
+#include <iomanip>
+#include <iostream>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/sixlowpan-module.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("ExampleSixlowpanCodecBenchmark");
+
+/// Number of packets received by the decompressing device
+static uint32_t g_rxPackets = 0;
+
+/**
+ * Count a decompressed packet
+ * \param device the receiving device
+ * \param packet the packet
+ * \param protocol the protocol number
+ * \param source the address of the sender
+ * \returns true
+ */
+static bool
+ReceivePacket (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &source)
+{
+  g_rxPackets++;
+  return true;
+}
+
+/**
+ * Send an IPv6/UDP packet
+ * \param device the compressing device
+ * \param dst the destination MAC address
+ * \param src the source IPv6 address
+ * \param dstAddr the destination IPv6 address
+ * \param remaining number of packets still to be sent
+ */
+static void
+SendPacket (Ptr<NetDevice> device, Address dst, Ipv6Address src, Ipv6Address dstAddr, uint32_t remaining)
+{
+  Ptr<Packet> packet = Create<Packet> (20);
+  UdpHeader udpHeader;
+  udpHeader.SetSourcePort (0xf0b1);
+  udpHeader.SetDestinationPort (5683);
+  packet->AddHeader (udpHeader);
+  Ipv6Header ipHeader;
+  ipHeader.SetSource (src);
+  ipHeader.SetDestination (dstAddr);
+  ipHeader.SetHopLimit (64);
+  ipHeader.SetNextHeader (UdpL4Protocol::PROT_NUMBER);
+  ipHeader.SetPayloadLength (packet->GetSize ());
+  packet->AddHeader (ipHeader);
+  device->Send (packet, dst, Ipv6L3Protocol::PROT_NUMBER);
+
+  if (remaining > 1)
+    {
+      Simulator::Schedule (MicroSeconds (1), &SendPacket, device, dst, src, dstAddr, remaining - 1);
+    }
+}
+
+/**
+ * Serialize and deserialize IPHC and UDP NHC headers
+ * \param nPackets the number of headers
+ * \return the wall clock time, in ms
+ */
+static int64_t
+RunHeaders (uint32_t nPackets)
+{
+  SixLowPanIphc iphc;
+  iphc.SetTf (SixLowPanIphc::TF_ELIDED);
+  iphc.SetNh (true);
+  iphc.SetHlim (SixLowPanIphc::HLIM_COMPR_64);
+  iphc.SetSac (true);
+  iphc.SetSam (SixLowPanIphc::HC_COMPR_16);
+  uint8_t srcInline[2] = { 0x00, 0x01 };
+  iphc.SetSrcInlinePart (srcInline, 2);
+  iphc.SetM (false);
+  iphc.SetDac (true);
+  iphc.SetDam (SixLowPanIphc::HC_COMPR_64);
+  uint8_t dstInline[8] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02 };
+  iphc.SetDstInlinePart (dstInline, 8);
+
+  SixLowPanUdpNhcExtension udpNhc;
+  udpNhc.SetPorts (SixLowPanUdpNhcExtension::PORTS_LAST_SRC_ALL_DST);
+  udpNhc.SetC (true);
+  udpNhc.SetSrcPort (0xb1);
+  udpNhc.SetDstPort (5683);
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t n = 0; n < nPackets; n++)
+    {
+      Ptr<Packet> packet = Create<Packet> (20);
+      packet->AddHeader (udpNhc);
+      packet->AddHeader (iphc);
+      SixLowPanIphc iphcRx;
+      SixLowPanUdpNhcExtension udpNhcRx;
+      packet->RemoveHeader (iphcRx);
+      packet->RemoveHeader (udpNhcRx);
+    }
+  return clock.End ();
+}
+
+/**
+ * Compress and decompress packets between two SixLowPanNetDevices
+ * \param nPackets the number of packets
+ * \param stateful true to use addresses matching a compression context
+ * \return the wall clock time, in ms
+ */
+static int64_t
+RunDevices (uint32_t nPackets, bool stateful)
+{
+  g_rxPackets = 0;
+
+  NodeContainer nodes;
+  nodes.Create (2);
+  SimpleNetDeviceHelper simple;
+  NetDeviceContainer simpleDevices = simple.Install (nodes);
+  for (uint32_t i = 0; i < simpleDevices.GetN (); i++)
+    {
+      simpleDevices.Get (i)->SetAddress (Mac48Address::Allocate ());
+    }
+
+  SixLowPanHelper sixlowpan;
+  NetDeviceContainer devices = sixlowpan.Install (simpleDevices);
+  devices.Get (1)->SetReceiveCallback (MakeCallback (&ReceivePacket));
+
+  Ipv6Prefix prefix ("2001:db8::", 64);
+  sixlowpan.AddContext (devices, 0, prefix, Seconds (3600));
+
+  Ipv6Address src;
+  Ipv6Address dst;
+  if (stateful)
+    {
+      src = Ipv6Address::MakeAutoconfiguredAddress (devices.Get (0)->GetAddress (), prefix);
+      dst = Ipv6Address::MakeAutoconfiguredAddress (devices.Get (1)->GetAddress (), prefix);
+    }
+  else
+    {
+      src = Ipv6Address::MakeAutoconfiguredLinkLocalAddress (devices.Get (0)->GetAddress ());
+      dst = Ipv6Address::MakeAutoconfiguredLinkLocalAddress (devices.Get (1)->GetAddress ());
+    }
+  Simulator::Schedule (Seconds (0), &SendPacket, devices.Get (0), devices.Get (1)->GetAddress (),
+                       src, dst, nPackets);
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Run ();
+  int64_t elapsed = clock.End ();
+  Simulator::Destroy ();
+
+  if (g_rxPackets != nPackets)
+    {
+      std::cout << "ERROR: " << nPackets - g_rxPackets << " packets lost" << std::endl;
+    }
+  return elapsed;
+}
+
+/**
+ * Print the throughput of a run
+ * \param name the name of the run
+ * \param nPackets the number of packets
+ * \param elapsed the wall clock time, in ms
+ */
+static void
+PrintThroughput (std::string name, uint32_t nPackets, int64_t elapsed)
+{
+  std::cout << std::setw (12) << name << std::setw (12) << elapsed
+            << std::setw (16) << std::fixed << std::setprecision (0)
+            << nPackets * 1000.0 / std::max<int64_t> (elapsed, 1) << std::endl;
+}
+
+int main (int argc, char** argv)
+{
+  uint32_t nPackets = 100000;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("nPackets", "Number of packets of each run", nPackets);
+  cmd.Parse (argc, argv);
+
+  std::cout << "packets: " << nPackets << std::endl;
+  std::cout << std::setw (12) << "run" << std::setw (12) << "time (ms)"
+            << std::setw (16) << "packets/s" << std::endl;
+  PrintThroughput ("header", nPackets, RunHeaders (nPackets));
+  PrintThroughput ("stateless", nPackets, RunDevices (nPackets, false));
+  PrintThroughput ("stateful", nPackets, RunDevices (nPackets, true));
+
+  return 0;
+}
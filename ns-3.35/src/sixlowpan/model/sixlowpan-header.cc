@@ -864,6 +864,41 @@ void SixLowPanIphc::Print (std::ostream & os) const
   os << " DAM (" << GetDam () << ")";
 }
 
+/**
+ * Number of bytes of the Traffic Class and Flow Label carried inline,
+ * indexed by the TF field.
+ */
+static const uint8_t g_iphcTfSize[4] = { 4, 3, 1, 0 };
+
+/**
+ * Hop Limit of the compressed HLIM values, indexed by the HLIM field
+ * (the inline value is read from the header).
+ */
+static const uint8_t g_iphcHopLimit[4] = { 0, 1, 64, 255 };
+
+/**
+ * Number of bytes of the source address carried inline, indexed by the
+ * SAC and SAM fields.
+ */
+static const uint8_t g_iphcSrcSize[2][4] = {
+  { 16, 8, 2, 0 },  // stateless
+  { 0, 8, 2, 0 }    // stateful, SAM 00 is the unspecified address
+};
+
+/**
+ * Number of bytes of the destination address carried inline, indexed by
+ * the M, DAC and DAM fields.  Reserved encodings carry no bytes.
+ */
+static const uint8_t g_iphcDstSize[2][2][4] = {
+  { { 16, 8, 2, 0 },    // unicast, stateless
+    { 0, 8, 2, 0 } },   // unicast, stateful
+  { { 16, 6, 4, 1 },    // multicast, stateless
+    { 6, 0, 0, 0 } }    // multicast, stateful
+};
+
+/// Maximum size of an IPHC header: base, CID, TF, NH, HLIM and both addresses
+static const uint32_t g_iphcMaxSize = 2 + 1 + 4 + 1 + 1 + 16 + 16;
+
 uint32_t SixLowPanIphc::GetSerializedSize () const
 {
   uint32_t serializedSize = 2;
@@ -872,20 +907,7 @@ uint32_t SixLowPanIphc::GetSerializedSize () const
     {
       serializedSize++;
     }
-  switch ( GetTf () )
-    {
-    case TF_FULL:
-      serializedSize += 4;
-      break;
-    case TF_DSCP_ELIDED:
-      serializedSize += 3;
-      break;
-    case TF_FL_ELIDED:
-      serializedSize++;
-      break;
-    default:
-      break;
-    }
+  serializedSize += g_iphcTfSize[GetTf ()];
   if ( GetNh () == false )
     {
       serializedSize++;
@@ -894,121 +916,41 @@ uint32_t SixLowPanIphc::GetSerializedSize () const
     {
       serializedSize++;
     }
-  switch (GetSam () )
-    {
-    case HC_INLINE:
-      if ( GetSac () == false )
-        {
-          serializedSize += 16;
-        }
-      break;
-    case HC_COMPR_64:
-      serializedSize += 8;
-      break;
-    case HC_COMPR_16:
-      serializedSize += 2;
-      break;
-    case HC_COMPR_0:
-    default:
-      break;
-    }
-  if ( GetM () == false)
-    {
-      switch (GetDam () )
-        {
-        case HC_INLINE:
-          if ( GetDac () == false )
-            {
-              serializedSize += 16;
-            }
-          break;
-        case HC_COMPR_64:
-          serializedSize += 8;
-          break;
-        case HC_COMPR_16:
-          serializedSize += 2;
-          break;
-        case HC_COMPR_0:
-        default:
-          break;
-        }
-    }
-  else
-    {
-      switch (GetDam () )
-        {
-        case HC_INLINE:
-          if ( GetDac () == false )
-            {
-              serializedSize += 16;
-            }
-          else
-            {
-              serializedSize += 6;
-            }
-          break;
-        case HC_COMPR_64:
-          if ( GetDac () == false )
-            {
-              serializedSize += 6;
-            }
-          break;
-        case HC_COMPR_16:
-          if ( GetDac () == false )
-            {
-              serializedSize += 4;
-            }
-          break;
-        case HC_COMPR_0:
-        default:
-          if ( GetDac () == false )
-            {
-              serializedSize++;
-            }
-          break;
-        }
-    }
-
-
+  serializedSize += g_iphcSrcSize[GetSac ()][GetSam ()];
+  serializedSize += g_iphcDstSize[GetM ()][GetDac ()][GetDam ()];
 
   return serializedSize;
 }
 
 void SixLowPanIphc::Serialize (Buffer::Iterator start) const
 {
-  Buffer::Iterator i = start;
+  // The header is built in a contiguous buffer and written at once.
+  uint8_t buffer[g_iphcMaxSize];
+  uint8_t *p = buffer;
 
-  i.WriteHtonU16 (m_baseFormat);
+  *p++ = m_baseFormat >> 8;
+  *p++ = m_baseFormat & 0xff;
 
   if ( GetCid () )
     {
-      i.WriteU8 (m_srcdstContextId);
+      *p++ = m_srcdstContextId;
     }
   // Traffic Class and Flow Label
   switch ( GetTf () )
     {
-      uint8_t temp;
     case TF_FULL:
-      temp = (m_ecn << 6) | m_dscp;
-      i.WriteU8 (temp);
-      temp = m_flowLabel >> 16;
-      i.WriteU8 (temp);
-      temp = (m_flowLabel >> 8) & 0xff;
-      i.WriteU8 (temp);
-      temp = m_flowLabel & 0xff;
-      i.WriteU8 (temp);
+      *p++ = (m_ecn << 6) | m_dscp;
+      *p++ = m_flowLabel >> 16;
+      *p++ = (m_flowLabel >> 8) & 0xff;
+      *p++ = m_flowLabel & 0xff;
       break;
     case TF_DSCP_ELIDED:
-      temp = (m_ecn << 6) | (m_flowLabel >> 16 );
-      i.WriteU8 (temp);
-      temp = (m_flowLabel >> 8) & 0xff;
-      i.WriteU8 (temp);
-      temp = m_flowLabel & 0xff;
-      i.WriteU8 (temp);
+      *p++ = (m_ecn << 6) | (m_flowLabel >> 16 );
+      *p++ = (m_flowLabel >> 8) & 0xff;
+      *p++ = m_flowLabel & 0xff;
       break;
     case TF_FL_ELIDED:
-      temp = (m_ecn << 6) | m_dscp;
-      i.WriteU8 (temp);
+      *p++ = (m_ecn << 6) | m_dscp;
       break;
     default:
       break;
@@ -1016,73 +958,23 @@ void SixLowPanIphc::Serialize (Buffer::Iterator start) const
   // Next Header
   if ( GetNh () == false )
     {
-      i.WriteU8 (m_nextHeader);
+      *p++ = m_nextHeader;
     }
   // Hop Limit
   if ( GetHlim () == HLIM_INLINE )
     {
-      i.WriteU8 (m_hopLimit);
+      *p++ = m_hopLimit;
     }
   // Source Address
-  switch (GetSam () )
-    {
-    case HC_INLINE:
-      if ( GetSac () == false )
-        {
-          i.Write (m_srcInlinePart, 16);
-        }
-      break;
-    case HC_COMPR_64:
-      i.Write (m_srcInlinePart, 8);
-      break;
-    case HC_COMPR_16:
-      i.Write (m_srcInlinePart, 2);
-      break;
-    case HC_COMPR_0:
-    default:
-      break;
-    }
+  uint8_t size = g_iphcSrcSize[GetSac ()][GetSam ()];
+  memcpy (p, m_srcInlinePart, size);
+  p += size;
   // Destination Address
-  if ( GetM () == false)
-    {
-      // unicast
-      switch (GetDam () )
-        {
-        case HC_INLINE:
-          i.Write (m_dstInlinePart, 16);
-          break;
-        case HC_COMPR_64:
-          i.Write (m_dstInlinePart, 8);
-          break;
-        case HC_COMPR_16:
-          i.Write (m_dstInlinePart, 2);
-          break;
-        case HC_COMPR_0:
-        default:
-          break;
-        }
-    }
-  else
-    {
-      // multicast
-      switch (GetDam () )
-        {
-        case HC_INLINE:
-          i.Write (m_dstInlinePart, 16);
-          break;
-        case HC_COMPR_64:
-          i.Write (m_dstInlinePart, 6);
-          break;
-        case HC_COMPR_16:
-          i.Write (m_dstInlinePart, 4);
-          break;
-        case HC_COMPR_0:
-          i.Write (m_dstInlinePart, 1);
-          break;
-       default:
-          break;
-        }
-    }
+  size = g_iphcDstSize[GetM ()][GetDac ()][GetDam ()];
+  memcpy (p, m_dstInlinePart, size);
+  p += size;
+
+  start.Write (buffer, p - buffer);
 }
 
 uint32_t SixLowPanIphc::Deserialize (Buffer::Iterator start)
@@ -1091,9 +983,15 @@ uint32_t SixLowPanIphc::Deserialize (Buffer::Iterator start)
 
   m_baseFormat = i.ReadNtohU16 ();
 
+  // The base format gives the size of the whole header, which is read at once.
+  uint32_t serializedSize = GetSerializedSize ();
+  uint8_t buffer[g_iphcMaxSize];
+  i.Read (buffer, serializedSize - 2);
+  const uint8_t *p = buffer;
+
   if ( GetCid () )
     {
-      m_srcdstContextId = i.ReadU8 ();
+      m_srcdstContextId = *p++;
     }
   else
     {
@@ -1102,31 +1000,21 @@ uint32_t SixLowPanIphc::Deserialize (Buffer::Iterator start)
   // Traffic Class and Flow Label
   switch ( GetTf () )
     {
-      uint8_t temp;
     case TF_FULL:
-      temp = i.ReadU8 ();
-      m_ecn = temp >> 6;
-      m_dscp = temp & 0x3F;
-      temp = i.ReadU8 ();
-      m_flowLabel = temp;
-      temp = i.ReadU8 ();
-      m_flowLabel = (m_flowLabel << 8) | temp;
-      temp = i.ReadU8 ();
-      m_flowLabel = (m_flowLabel << 8) | temp;
+      m_ecn = p[0] >> 6;
+      m_dscp = p[0] & 0x3F;
+      m_flowLabel = (p[1] << 16) | (p[2] << 8) | p[3];
+      p += 4;
       break;
     case TF_DSCP_ELIDED:
-      temp = i.ReadU8 ();
-      m_ecn = temp >> 6;
-      m_flowLabel = temp & 0x3F;
-      temp = i.ReadU8 ();
-      m_flowLabel = (m_flowLabel << 8) | temp;
-      temp = i.ReadU8 ();
-      m_flowLabel = (m_flowLabel << 8) | temp;
+      m_ecn = p[0] >> 6;
+      m_flowLabel = ((p[0] & 0x3F) << 16) | (p[1] << 8) | p[2];
+      p += 3;
       break;
     case TF_FL_ELIDED:
-      temp = i.ReadU8 ();
-      m_ecn = temp >> 6;
-      m_dscp = temp & 0x3F;
+      m_ecn = p[0] >> 6;
+      m_dscp = p[0] & 0x3F;
+      p++;
       break;
     default:
       break;
@@ -1134,91 +1022,29 @@ uint32_t SixLowPanIphc::Deserialize (Buffer::Iterator start)
   // Next Header
   if ( GetNh () == false )
     {
-      m_nextHeader = i.ReadU8 ();
+      m_nextHeader = *p++;
     }
   // Hop Limit
-  switch ( GetHlim () )
+  if ( GetHlim () == HLIM_INLINE )
     {
-    case HLIM_INLINE:
-      m_hopLimit = i.ReadU8 ();
-      break;
-    case HLIM_COMPR_1:
-      m_hopLimit = 1;
-      break;
-    case HLIM_COMPR_64:
-      m_hopLimit = 64;
-      break;
-    case HLIM_COMPR_255:
-    default:
-      m_hopLimit = 255;
-      break;
-
+      m_hopLimit = *p++;
     }
-  // Source Address
-  memset (m_srcInlinePart, 0x00, sizeof (m_srcInlinePart));
-  switch (GetSam () )
+  else
     {
-    case HC_INLINE:
-      if ( GetSac () == false )
-        {
-          i.Read (m_srcInlinePart, 16);
-        }
-      break;
-    case HC_COMPR_64:
-      i.Read (m_srcInlinePart, 8);
-      break;
-    case HC_COMPR_16:
-      i.Read (m_srcInlinePart, 2);
-      break;
-    case HC_COMPR_0:
-    default:
-      break;
+      m_hopLimit = g_iphcHopLimit[GetHlim ()];
     }
+  // Source Address
+  memset (m_srcInlinePart, 0x00, sizeof (m_srcInlinePart));
+  uint8_t size = g_iphcSrcSize[GetSac ()][GetSam ()];
+  memcpy (m_srcInlinePart, p, size);
+  p += size;
 
   // Destination Address
   memset (m_dstInlinePart, 0x00, sizeof (m_dstInlinePart));
-  if ( GetM () == false)
-    {
-      // unicast
-      switch (GetDam () )
-        {
-        case HC_INLINE:
-          i.Read (m_dstInlinePart, 16);
-          break;
-        case HC_COMPR_64:
-          i.Read (m_dstInlinePart, 8);
-          break;
-        case HC_COMPR_16:
-          i.Read (m_dstInlinePart, 2);
-          break;
-        case HC_COMPR_0:
-        default:
-          break;
-        }
-    }
-  else
-    {
-      // multicast
-      switch (GetDam () )
-        {
-        case HC_INLINE:
-          i.Read (m_dstInlinePart, 16);
-          break;
-        case HC_COMPR_64:
-          i.Read (m_dstInlinePart, 6);
-          break;
-        case HC_COMPR_16:
-          i.Read (m_dstInlinePart, 4);
-          break;
-        case HC_COMPR_0:
-          i.Read (m_dstInlinePart, 1);
-          break;
-        default:
-          break;
-        }
-    }
+  size = g_iphcDstSize[GetM ()][GetDac ()][GetDam ()];
+  memcpy (m_dstInlinePart, p, size);
 
-  return GetSerializedSize ();
+  return serializedSize;
 }
 
 void SixLowPanIphc::SetTf (TrafficClassFlowLabel_e tfField)
@@ -1588,6 +1414,14 @@ void SixLowPanUdpNhcExtension::Print (std::ostream & os) const
   os << "Compression kind: " << +m_baseFormat;
 }
 
+/**
+ * Number of bytes of the ports carried inline, indexed by the P field.
+ */
+static const uint8_t g_udpNhcPortsSize[4] = { 4, 3, 3, 1 };
+
+/// Maximum size of an UDP NHC header: base, ports and checksum
+static const uint32_t g_udpNhcMaxSize = 1 + 4 + 2;
+
 uint32_t SixLowPanUdpNhcExtension::GetSerializedSize () const
 {
   uint32_t serializedSize = 1;
@@ -1595,98 +1429,95 @@ uint32_t SixLowPanUdpNhcExtension::GetSerializedSize () const
     {
       serializedSize += 2;
     }
-  switch (GetPorts ())
-    {
-    case PORTS_INLINE:
-      serializedSize += 4;
-      break;
-    case PORTS_ALL_SRC_LAST_DST:
-    case PORTS_LAST_SRC_ALL_DST:
-      serializedSize += 3;
-      break;
-    case PORTS_LAST_SRC_LAST_DST:
-      serializedSize += 1;
-      break;
-    default:
-      break;
-    }
+  serializedSize += g_udpNhcPortsSize[GetPorts ()];
   return serializedSize;
 }
 
 void SixLowPanUdpNhcExtension::Serialize (Buffer::Iterator start) const
 {
-  Buffer::Iterator i = start;
-  i.WriteU8 (m_baseFormat);
-  uint8_t temp;
+  // The header is built in a contiguous buffer and written at once.
+  uint8_t buffer[g_udpNhcMaxSize];
+  uint8_t *p = buffer;
+  *p++ = m_baseFormat;
 
   // Ports
   switch ( GetPorts () )
     {
     case PORTS_INLINE:
-      i.WriteHtonU16 (m_srcPort);
-      i.WriteHtonU16 (m_dstPort);
+      *p++ = m_srcPort >> 8;
+      *p++ = m_srcPort & 0xff;
+      *p++ = m_dstPort >> 8;
+      *p++ = m_dstPort & 0xff;
       break;
     case PORTS_ALL_SRC_LAST_DST:
-      i.WriteHtonU16 (m_srcPort);
-      i.WriteU8 (m_dstPort & 0xff);
+      *p++ = m_srcPort >> 8;
+      *p++ = m_srcPort & 0xff;
+      *p++ = m_dstPort & 0xff;
       break;
     case PORTS_LAST_SRC_ALL_DST:
-      i.WriteU8 (m_srcPort & 0xff);
-      i.WriteHtonU16 (m_dstPort);
+      *p++ = m_srcPort & 0xff;
+      *p++ = m_dstPort >> 8;
+      *p++ = m_dstPort & 0xff;
       break;
     case PORTS_LAST_SRC_LAST_DST:
-      temp = ((m_srcPort & 0xf) << 4) | (m_dstPort & 0xf);
-      i.WriteU8 (temp);
+      *p++ = ((m_srcPort & 0xf) << 4) | (m_dstPort & 0xf);
       break;
     default:
       break;
     }
 
-  // Checksum
+  // Checksum, least significant byte first as Buffer::Iterator::WriteU16
   if ( !GetC () )
     {
-      i.WriteU16 (m_checksum);
+      *p++ = m_checksum & 0xff;
+      *p++ = m_checksum >> 8;
     }
 
+  start.Write (buffer, p - buffer);
 }
 
 uint32_t SixLowPanUdpNhcExtension::Deserialize (Buffer::Iterator start)
 {
   Buffer::Iterator i = start;
   m_baseFormat = i.ReadU8 ();
-  uint8_t temp;
+
+  // The base format gives the size of the whole header, which is read at once.
+  uint32_t serializedSize = GetSerializedSize ();
+  uint8_t buffer[g_udpNhcMaxSize];
+  i.Read (buffer, serializedSize - 1);
+  const uint8_t *p = buffer;
 
   // Ports
   switch ( GetPorts () )
     {
     case PORTS_INLINE:
-      m_srcPort = i.ReadNtohU16 ();
-      m_dstPort = i.ReadNtohU16 ();
+      m_srcPort = (p[0] << 8) | p[1];
+      m_dstPort = (p[2] << 8) | p[3];
       break;
     case PORTS_ALL_SRC_LAST_DST:
-      m_srcPort = i.ReadNtohU16 ();
-      m_dstPort = i.ReadU8 ();
+      m_srcPort = (p[0] << 8) | p[1];
+      m_dstPort = p[2];
       break;
     case PORTS_LAST_SRC_ALL_DST:
-      m_srcPort = i.ReadU8 ();
-      m_dstPort = i.ReadNtohU16 ();
+      m_srcPort = p[0];
+      m_dstPort = (p[1] << 8) | p[2];
       break;
     case PORTS_LAST_SRC_LAST_DST:
-      temp = i.ReadU8 ();
-      m_srcPort = temp >> 4;
-      m_dstPort = temp & 0xf;
+      m_srcPort = p[0] >> 4;
+      m_dstPort = p[0] & 0xf;
       break;
     default:
       break;
     }
+  p += g_udpNhcPortsSize[GetPorts ()];
 
   // Checksum
   if ( !GetC () )
     {
-      m_checksum = i.ReadU16 ();
+      m_checksum = p[0] | (p[1] << 8);
     }
 
-  return GetSerializedSize ();
+  return serializedSize;
 }
 
 SixLowPanDispatch::NhcDispatch_e
@@ -37,6 +37,7 @@
 #include "ns3/udp-l4-protocol.h"
 #include "ns3/string.h"
 #include "ns3/pointer.h"
+#include "ns3/hash.h"
 #include "sixlowpan-net-device.h"
 #include "sixlowpan-header.h"
 
@@ -44,6 +45,15 @@ NS_LOG_COMPONENT_DEFINE ("SixLowPanNetDevice");
 
 namespace ns3 {
 
+/// Link-local prefix (fe80::/64), as compared by the IPHC compression.
+static const uint8_t g_iphcLinkLocalPrefix[8] = { 0xfe, 0x80, 0, 0, 0, 0, 0, 0 };
+
+/// First six bytes of an interface identifier derived from a short address (0000:00ff:fe00:XXXX).
+static const uint8_t g_iphcShortIid[6] = { 0x00, 0x00, 0x00, 0xff, 0xfe, 0x00 };
+
+/// First 15 bytes of the multicast addresses compressed in one byte (ff02::00XX).
+static const uint8_t g_iphcMulticastPrefix[15] = { 0xff, 0x02, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+
 NS_OBJECT_ENSURE_REGISTERED (SixLowPanNetDevice);
 
 TypeId SixLowPanNetDevice::GetTypeId (void)
@@ -241,18 +251,20 @@ void SixLowPanNetDevice::ReceiveFromDevice (Ptr<NetDevice> incomingPort,
           return;
         }
 
-      if (find (m_seenPkts[meshHdr.GetOriginator ()].begin (),
-                m_seenPkts[meshHdr.GetOriginator ()].end (),
-                bc0Hdr.GetSequenceNumber ()) != m_seenPkts[meshHdr.GetOriginator ()].end ())
+      SeenSequenceWindow &seenWindow = m_seenPkts[meshHdr.GetOriginator ()];
+      uint8_t sequenceNumber = bc0Hdr.GetSequenceNumber ();
+      if (seenWindow.seen.test (sequenceNumber))
         {
           NS_LOG_LOGIC ("We have already seen this, no further processing.");
           return;
         }
 
-      m_seenPkts[meshHdr.GetOriginator ()].push_back (bc0Hdr.GetSequenceNumber ());
-      if (m_seenPkts[meshHdr.GetOriginator ()].size () > m_meshCacheLength)
+      seenWindow.seen.set (sequenceNumber);
+      seenWindow.order.push_back (sequenceNumber);
+      if (seenWindow.order.size () > m_meshCacheLength)
         {
-          m_seenPkts[meshHdr.GetOriginator ()].pop_front ();
+          seenWindow.seen.reset (seenWindow.order.front ());
+          seenWindow.order.pop_front ();
         }
 
       NS_ABORT_MSG_IF (!Mac16Address::IsMatchingType (meshHdr.GetFinalDst ()), "SixLowPan mesh-under flooding can not currently handle extended address final destinations: " << meshHdr.GetFinalDst ());
@@ -1040,10 +1052,11 @@ SixLowPanNetDevice::CompressLowPanIphc (Ptr<Packet> packet, Address const &src,
       iphcHeader.SetDac (false);
 
 
-      Ipv6Address checker = Ipv6Address ("fe80:0000:0000:0000:0000:00ff:fe00:1");
-      uint8_t unicastAddrCheckerBuf[16];
-      checker.GetBytes (unicastAddrCheckerBuf);
-      uint8_t addressBuf[16];
+      // The addresses are compressed from their bytes.
+      uint8_t srcBuf[16];
+      uint8_t dstBuf[16];
+      ipHeader.GetSource ().GetBytes (srcBuf);
+      ipHeader.GetDestination ().GetBytes (dstBuf);
 
       // This is just to limit the scope of some variables.
       if (true)
@@ -1059,7 +1072,7 @@ SixLowPanNetDevice::CompressLowPanIphc (Ptr<Packet> packet, Address const &src,
               iphcHeader.SetSac (true);
             }
           // Check if the address can be compressed with stateful compression
-          else if ( FindUnicastCompressionContext (srcAddr, srcContextId) )
+          else if ( FindUnicastCompressionContext (srcBuf, srcContextId) )
             {
               // We can do stateful compression.
               NS_LOG_LOGIC ("Checking stateful source compression: " << srcAddr );
@@ -1073,20 +1086,17 @@ SixLowPanNetDevice::CompressLowPanIphc (Ptr<Packet> packet, Address const &src,
                 }
 
               // Note that a context might include parts of the EUI-64 (i.e., be as long as 128 bits).
-
-              if (Ipv6Address::MakeAutoconfiguredAddress (src, m_contextTable[srcContextId].contextPrefix) == srcAddr)
+              const ContextEntry &context = m_contextTable.find (srcContextId)->second;
+              if (Ipv6Address::MakeAutoconfiguredAddress (src, context.contextPrefix) == srcAddr)
                 {
                   iphcHeader.SetSam (SixLowPanIphc::HC_COMPR_0);
                 }
               else
                 {
-                  Ipv6Address cleanedAddr = CleanPrefix (srcAddr, m_contextTable[srcContextId].contextPrefix);
                   uint8_t serializedCleanedAddress[16];
-                  cleanedAddr.Serialize (serializedCleanedAddress);
+                  CleanPrefix (srcBuf, context, serializedCleanedAddress);
 
-                  if ( serializedCleanedAddress[8] == 0x00 && serializedCleanedAddress[9] == 0x00 &&
-                      serializedCleanedAddress[10] == 0x00 && serializedCleanedAddress[11] == 0xff &&
-                      serializedCleanedAddress[12] == 0xfe && serializedCleanedAddress[13] == 0x00 )
+                  if (memcmp (serializedCleanedAddress + 8, g_iphcShortIid, 6) == 0)
                     {
                       iphcHeader.SetSam (SixLowPanIphc::HC_COMPR_16);
                       iphcHeader.SetSrcInlinePart (serializedCleanedAddress+14, 2);
@@ -1104,35 +1114,31 @@ SixLowPanNetDevice::CompressLowPanIphc (Ptr<Packet> packet, Address const &src,
               // We must do stateless compression.
               NS_LOG_LOGIC ("Checking stateless source compression: " << srcAddr );
 
-              srcAddr.GetBytes (addressBuf);
-
-              uint8_t serializedSrcAddress[16];
-              srcAddr.Serialize (serializedSrcAddress);
-
               if ( srcAddr == Ipv6Address::MakeAutoconfiguredLinkLocalAddress (src) )
                 {
                   iphcHeader.SetSam (SixLowPanIphc::HC_COMPR_0);
                 }
-              else if (memcmp (addressBuf, unicastAddrCheckerBuf, 14) == 0)
+              else if (memcmp (srcBuf, g_iphcLinkLocalPrefix, 8) == 0
+                       && memcmp (srcBuf + 8, g_iphcShortIid, 6) == 0)
                 {
-                  iphcHeader.SetSrcInlinePart (serializedSrcAddress+14, 2);
+                  iphcHeader.SetSrcInlinePart (srcBuf+14, 2);
                   iphcHeader.SetSam (SixLowPanIphc::HC_COMPR_16);
                 }
-              else if ( srcAddr.IsLinkLocal () )
+              else if (memcmp (srcBuf, g_iphcLinkLocalPrefix, 8) == 0)
                 {
-                  iphcHeader.SetSrcInlinePart (serializedSrcAddress+8, 8);
+                  iphcHeader.SetSrcInlinePart (srcBuf+8, 8);
                   iphcHeader.SetSam (SixLowPanIphc::HC_COMPR_64);
                 }
               else
                 {
-                  iphcHeader.SetSrcInlinePart (serializedSrcAddress, 16);
+                  iphcHeader.SetSrcInlinePart (srcBuf, 16);
                   iphcHeader.SetSam (SixLowPanIphc::HC_INLINE);
                 }
             }
         }
 
       // Set the M field
-      if (ipHeader.GetDestination ().IsMulticast ())
+      if (dstBuf[0] == 0xff)
         {
           iphcHeader.SetM (true);
         }
@@ -1145,19 +1151,15 @@ SixLowPanNetDevice::CompressLowPanIphc (Ptr<Packet> packet, Address const &src,
       if (true)
         {
           Ipv6Address dstAddr = ipHeader.GetDestination ();
-          dstAddr.GetBytes (addressBuf);
 
           NS_LOG_LOGIC ("Checking destination compression: " << dstAddr );
 
-          uint8_t serializedDstAddress[16];
-          dstAddr.Serialize (serializedDstAddress);
-
           if ( !iphcHeader.GetM () )
             {
               // Unicast address
 
               uint8_t dstContextId;
-              if ( FindUnicastCompressionContext (dstAddr, dstContextId) )
+              if ( FindUnicastCompressionContext (dstBuf, dstContextId) )
                 {
                   // We can do stateful compression.
                   NS_LOG_LOGIC ("Checking stateful destination compression: " << dstAddr );
@@ -1171,20 +1173,17 @@ SixLowPanNetDevice::CompressLowPanIphc (Ptr<Packet> packet, Address const &src,
                     }
 
                   // Note that a context might include parts of the EUI-64 (i.e., be as long as 128 bits).
-                  if (Ipv6Address::MakeAutoconfiguredAddress (dst, m_contextTable[dstContextId].contextPrefix) == dstAddr)
+                  const ContextEntry &context = m_contextTable.find (dstContextId)->second;
+                  if (Ipv6Address::MakeAutoconfiguredAddress (dst, context.contextPrefix) == dstAddr)
                     {
                       iphcHeader.SetDam (SixLowPanIphc::HC_COMPR_0);
                     }
                   else
                     {
-                      Ipv6Address cleanedAddr = CleanPrefix (dstAddr, m_contextTable[dstContextId].contextPrefix);
-
                       uint8_t serializedCleanedAddress[16];
-                      cleanedAddr.Serialize (serializedCleanedAddress);
+                      CleanPrefix (dstBuf, context, serializedCleanedAddress);
 
-                      if ( serializedCleanedAddress[8] == 0x00 && serializedCleanedAddress[9] == 0x00 &&
-                          serializedCleanedAddress[10] == 0x00 && serializedCleanedAddress[11] == 0xff &&
-                          serializedCleanedAddress[12] == 0xfe && serializedCleanedAddress[13] == 0x00 )
+                      if (memcmp (serializedCleanedAddress + 8, g_iphcShortIid, 6) == 0)
                         {
                           iphcHeader.SetDam (SixLowPanIphc::HC_COMPR_16);
                           iphcHeader.SetDstInlinePart (serializedCleanedAddress+14, 2);
@@ -1204,19 +1203,20 @@ SixLowPanNetDevice::CompressLowPanIphc (Ptr<Packet> packet, Address const &src,
                     {
                       iphcHeader.SetDam (SixLowPanIphc::HC_COMPR_0);
                     }
-                  else if (memcmp (addressBuf, unicastAddrCheckerBuf, 14) == 0)
+                  else if (memcmp (dstBuf, g_iphcLinkLocalPrefix, 8) == 0
+                           && memcmp (dstBuf + 8, g_iphcShortIid, 6) == 0)
                     {
-                      iphcHeader.SetDstInlinePart (serializedDstAddress+14, 2);
+                      iphcHeader.SetDstInlinePart (dstBuf+14, 2);
                       iphcHeader.SetDam (SixLowPanIphc::HC_COMPR_16);
                     }
-                  else if ( dstAddr.IsLinkLocal () )
+                  else if (memcmp (dstBuf, g_iphcLinkLocalPrefix, 8) == 0)
                     {
-                      iphcHeader.SetDstInlinePart (serializedDstAddress+8, 8);
+                      iphcHeader.SetDstInlinePart (dstBuf+8, 8);
                       iphcHeader.SetDam (SixLowPanIphc::HC_COMPR_64);
                     }
                   else
                     {
-                      iphcHeader.SetDstInlinePart (serializedDstAddress, 16);
+                      iphcHeader.SetDstInlinePart (dstBuf, 16);
                       iphcHeader.SetDam (SixLowPanIphc::HC_INLINE);
                     }
                 }
@@ -1226,18 +1226,18 @@ SixLowPanNetDevice::CompressLowPanIphc (Ptr<Packet> packet, Address const &src,
               // Multicast address
 
               uint8_t dstContextId;
-              if ( FindMulticastCompressionContext (dstAddr, dstContextId) )
+              if ( FindMulticastCompressionContext (dstBuf, dstContextId) )
                 {
                   // Stateful compression (only one possible case)
 
                   // ffXX:XXLL:PPPP:PPPP:PPPP:PPPP:XXXX:XXXX
                   uint8_t dstInlinePart[6] = {};
-                  dstInlinePart[0] = serializedDstAddress[1];
-                  dstInlinePart[1] = serializedDstAddress[2];
-                  dstInlinePart[2] = serializedDstAddress[12];
-                  dstInlinePart[3] = serializedDstAddress[13];
-                  dstInlinePart[4] = serializedDstAddress[14];
-                  dstInlinePart[5] = serializedDstAddress[15];
+                  dstInlinePart[0] = dstBuf[1];
+                  dstInlinePart[1] = dstBuf[2];
+                  dstInlinePart[2] = dstBuf[12];
+                  dstInlinePart[3] = dstBuf[13];
+                  dstInlinePart[4] = dstBuf[14];
+                  dstInlinePart[5] = dstBuf[15];
 
                   iphcHeader.SetDac (true);
                   if (dstContextId != 0)
@@ -1253,41 +1253,35 @@ SixLowPanNetDevice::CompressLowPanIphc (Ptr<Packet> packet, Address const &src,
                 {
                   // Stateless compression
 
-                  uint8_t multicastAddrCheckerBuf[16];
-                  Ipv6Address multicastCheckAddress = Ipv6Address ("ff02::1");
-                  multicastCheckAddress.GetBytes (multicastAddrCheckerBuf);
-
                   // The address takes the form ff02::00XX.
-                  if ( memcmp (addressBuf, multicastAddrCheckerBuf, 15) == 0 )
+                  if ( memcmp (dstBuf, g_iphcMulticastPrefix, 15) == 0 )
                     {
-                      iphcHeader.SetDstInlinePart (serializedDstAddress+15, 1);
+                      iphcHeader.SetDstInlinePart (dstBuf+15, 1);
                       iphcHeader.SetDam (SixLowPanIphc::HC_COMPR_0);
                     }
                   // The address takes the form ffXX::00XX:XXXX.
                   //                            ffXX:0000:0000:0000:0000:0000:00XX:XXXX.
-                  else if ( (addressBuf[0] == multicastAddrCheckerBuf[0])
-                      && (memcmp (addressBuf + 2, multicastAddrCheckerBuf + 2, 11) == 0) )
+                  else if ( memcmp (dstBuf + 2, g_iphcMulticastPrefix + 2, 11) == 0 )
                     {
                       uint8_t dstInlinePart[4] = {};
-                      memcpy (dstInlinePart, serializedDstAddress+1, 1);
-                      memcpy (dstInlinePart+1, serializedDstAddress+13, 3);
+                      memcpy (dstInlinePart, dstBuf+1, 1);
+                      memcpy (dstInlinePart+1, dstBuf+13, 3);
                       iphcHeader.SetDstInlinePart (dstInlinePart, 4);
                       iphcHeader.SetDam (SixLowPanIphc::HC_COMPR_16);
                     }
                   // The address takes the form ffXX::00XX:XXXX:XXXX.
                   //                            ffXX:0000:0000:0000:0000:00XX:XXXX:XXXX.
-                  else if ( (addressBuf[0] == multicastAddrCheckerBuf[0])
-                      && (memcmp (addressBuf + 2, multicastAddrCheckerBuf + 2, 9) == 0) )
+                  else if ( memcmp (dstBuf + 2, g_iphcMulticastPrefix + 2, 9) == 0 )
                     {
                       uint8_t dstInlinePart[6] = {};
-                      memcpy (dstInlinePart, serializedDstAddress+1, 1);
-                      memcpy (dstInlinePart+1, serializedDstAddress+11, 5);
+                      memcpy (dstInlinePart, dstBuf+1, 1);
+                      memcpy (dstInlinePart+1, dstBuf+11, 5);
                       iphcHeader.SetDstInlinePart (dstInlinePart, 6);
                       iphcHeader.SetDam (SixLowPanIphc::HC_COMPR_64);
                     }
                   else
                     {
-                      iphcHeader.SetDstInlinePart (serializedDstAddress, 16);
+                      iphcHeader.SetDstInlinePart (dstBuf, 16);
                       iphcHeader.SetDam (SixLowPanIphc::HC_INLINE);
                     }
                 }
@@ -1353,20 +1347,18 @@ SixLowPanNetDevice::DecompressLowPanIphc (Ptr<Packet> packet, Address const &src
       else
         {
           uint8_t contextId = encoding.GetSrcContextId ();
-          if (m_contextTable.find (contextId) == m_contextTable.end ())
+          std::map<uint8_t, ContextEntry>::const_iterator contextIt = m_contextTable.find (contextId);
+          if (contextIt == m_contextTable.end ())
             {
               NS_LOG_LOGIC ("Unknown Source compression context (" << +contextId << "), dropping packet");
               return true;
             }
-          if (m_contextTable[contextId].validLifetime < Simulator::Now ())
+          if (contextIt->second.validLifetime < Simulator::Now ())
             {
               NS_LOG_LOGIC ("Expired Source compression context (" << +contextId << "), dropping packet");
               return true;
            }
 
-          uint8_t contexPrefix[16];
-          m_contextTable[contextId].contextPrefix.GetBytes(contexPrefix);
-          uint8_t contextLength = m_contextTable[contextId].contextPrefix.GetPrefixLength ();
 
           uint8_t srcAddress[16] = { };
           if ( encoding.GetSam () == SixLowPanIphc::HC_COMPR_64 )
@@ -1384,20 +1376,7 @@ SixLowPanNetDevice::DecompressLowPanIphc (Ptr<Packet> packet, Address const &src
               Ipv6Address::MakeAutoconfiguredLinkLocalAddress (src).GetBytes (srcAddress);
             }
 
-          uint8_t bytesToCopy = contextLength / 8;
-          uint8_t bitsToCopy = contextLength % 8;
-
-          // Do not combine the prefix - we want to override the bytes.
-          for (uint8_t i=0; i<bytesToCopy; i++)
-            {
-              srcAddress[i] = contexPrefix[i];
-            }
-          if (bitsToCopy)
-            {
-              uint8_t addressBitMask = (1<<(8-bitsToCopy))-1;
-              uint8_t prefixBitMask = ~addressBitMask;
-              srcAddress[bytesToCopy] = (contexPrefix[bytesToCopy] & prefixBitMask) | (srcAddress[bytesToCopy] & addressBitMask);
-            }
+          ApplyPrefix (srcAddress, contextIt->second);
           ipHeader.SetSource ( Ipv6Address::Deserialize (srcAddress) );
         }
     }
@@ -1447,20 +1426,18 @@ SixLowPanNetDevice::DecompressLowPanIphc (Ptr<Packet> packet, Address const &src
         }
 
       uint8_t contextId = encoding.GetDstContextId ();
-      if (m_contextTable.find (contextId) == m_contextTable.end ())
+      std::map<uint8_t, ContextEntry>::const_iterator contextIt = m_contextTable.find (contextId);
+      if (contextIt == m_contextTable.end ())
         {
           NS_LOG_LOGIC ("Unknown Destination compression context (" << +contextId << "), dropping packet");
           return true;
         }
-      if (m_contextTable[contextId].validLifetime < Simulator::Now ())
+      if (contextIt->second.validLifetime < Simulator::Now ())
         {
           NS_LOG_LOGIC ("Expired Destination compression context (" << +contextId << "), dropping packet");
           return true;
        }
 
-      uint8_t contexPrefix[16];
-      m_contextTable[contextId].contextPrefix.GetBytes(contexPrefix);
-      uint8_t contextLength = m_contextTable[contextId].contextPrefix.GetPrefixLength ();
 
       if (encoding.GetM () == false)
         {
@@ -1481,20 +1458,7 @@ SixLowPanNetDevice::DecompressLowPanIphc (Ptr<Packet> packet, Address const &src
               Ipv6Address::MakeAutoconfiguredLinkLocalAddress (dst).GetBytes (dstAddress);
             }
 
-          uint8_t bytesToCopy = m_contextTable[contextId].contextPrefix.GetPrefixLength () / 8;
-          uint8_t bitsToCopy = contextLength % 8;
-
-          // Do not combine the prefix - we want to override the bytes.
-          for (uint8_t i=0; i<bytesToCopy; i++)
-            {
-              dstAddress[i] = contexPrefix[i];
-            }
-          if (bitsToCopy)
-            {
-              uint8_t addressBitMask = (1<<(8-bitsToCopy))-1;
-              uint8_t prefixBitMask = ~addressBitMask;
-              dstAddress[bytesToCopy] = (contexPrefix[bytesToCopy] & prefixBitMask) | (dstAddress[bytesToCopy] & addressBitMask);
-            }
+          ApplyPrefix (dstAddress, contextIt->second);
           ipHeader.SetDestination ( Ipv6Address::Deserialize (dstAddress) );
         }
       else
@@ -1504,8 +1468,8 @@ SixLowPanNetDevice::DecompressLowPanIphc (Ptr<Packet> packet, Address const &src
           uint8_t dstAddress[16] = { };
           dstAddress[0] = 0xff;
           memcpy (dstAddress +1, encoding.GetDstInlinePart (), 2);
-          dstAddress[3] = contextLength;
-          memcpy (dstAddress +4, contexPrefix, 8);
+          dstAddress[3] = contextIt->second.contextPrefix.GetPrefixLength ();
+          memcpy (dstAddress +4, contextIt->second.prefixBytes, 8);
           memcpy (dstAddress +12, encoding.GetDstInlinePart ()+2, 4);
           ipHeader.SetDestination ( Ipv6Address::Deserialize (dstAddress) );
         }
@@ -1589,7 +1553,7 @@ SixLowPanNetDevice::DecompressLowPanIphc (Ptr<Packet> packet, Address const &src
       traf |= encoding.GetEcn ();
       traf = ( traf << 6 ) | encoding.GetDscp ();
       ipHeader.SetTrafficClass (traf);
-      ipHeader.SetFlowLabel ( encoding.GetFlowLabel () & 0xfff ); //Add 4-bit pad
+      ipHeader.SetFlowLabel ( encoding.GetFlowLabel () & 0xfffff ); // Remove the 4-bit pad
       break;
     case SixLowPanIphc::TF_DSCP_ELIDED:
       traf |= encoding.GetEcn ();
@@ -2196,30 +2160,21 @@ SixLowPanNetDevice::DecompressLowPanUdpNhc (Ptr<Packet> packet, Ipv6Address sadd
   // Set the value of the ports
   switch ( encoding.GetPorts () )
     {
-      uint16_t temp;
     case SixLowPanUdpNhcExtension::PORTS_INLINE:
       udpHeader.SetSourcePort (encoding.GetSrcPort ());
       udpHeader.SetDestinationPort (encoding.GetDstPort ());
       break;
     case SixLowPanUdpNhcExtension::PORTS_ALL_SRC_LAST_DST:
       udpHeader.SetSourcePort (encoding.GetSrcPort ());
-      temp = 0xf0;
-      temp |= (temp << 8) | encoding.GetDstPort ();
-      udpHeader.SetDestinationPort (temp);
+      udpHeader.SetDestinationPort (0xf000 | encoding.GetDstPort ());
       break;
     case SixLowPanUdpNhcExtension::PORTS_LAST_SRC_ALL_DST:
-      temp = 0xf0;
-      temp |= (temp << 8) | encoding.GetSrcPort ();
-      udpHeader.SetSourcePort (temp);
+      udpHeader.SetSourcePort (0xf000 | encoding.GetSrcPort ());
       udpHeader.SetDestinationPort (encoding.GetDstPort ());
       break;
     case SixLowPanUdpNhcExtension::PORTS_LAST_SRC_LAST_DST:
-      temp = 0xf0b;
-      temp |= (temp << 4) | encoding.GetSrcPort ();
-      udpHeader.SetSourcePort (temp);
-      temp = 0xf0b;
-      temp |= (temp << 4) | encoding.GetDstPort ();
-      udpHeader.SetDestinationPort (temp);
+      udpHeader.SetSourcePort (0xf0b0 | encoding.GetSrcPort ());
+      udpHeader.SetDestinationPort (0xf0b0 | encoding.GetDstPort ());
       break;
     }
 
@@ -2403,18 +2358,18 @@ bool SixLowPanNetDevice::ProcessFragment (Ptr<Packet>& packet, Address const &sr
       if ( m_fragmentReassemblyListSize && (m_fragments.size () >= m_fragmentReassemblyListSize) )
         {
           FragmentsTimeoutsListI_t iter = m_timeoutEventList.begin ();
-          FragmentKey_t oldestKey = std::get<1> (*iter);
+          MapFragmentsI_t oldest = m_fragments.find (std::get<1> (*iter));
 
-          std::list< Ptr<Packet> > storedFragments = m_fragments[oldestKey]->GetFraments ();
+          std::list< Ptr<Packet> > storedFragments = oldest->second->GetFraments ();
           for (std::list< Ptr<Packet> >::iterator fragIter = storedFragments.begin ();
                fragIter != storedFragments.end (); fragIter++)
             {
               m_dropTrace (DROP_FRAGMENT_BUFFER_FULL, *fragIter, m_node->GetObject<SixLowPanNetDevice> (), GetIfIndex ());
             }
 
-          m_timeoutEventList.erase (m_fragments[oldestKey]->GetTimeoutIter ());
-          m_fragments[oldestKey] = 0;
-          m_fragments.erase (oldestKey);
+          m_timeoutEventList.erase (oldest->second->GetTimeoutIter ());
+          oldest->second = 0;
+          m_fragments.erase (oldest);
 
         }
       fragments = Create<Fragments> ();
@@ -2450,7 +2405,14 @@ bool SixLowPanNetDevice::ProcessFragment (Ptr<Packet>& packet, Address const &sr
       NS_LOG_LOGIC ("Rebuilt packet. Size " << packet->GetSize () << " - " << *packet);
       m_timeoutEventList.erase (fragments->GetTimeoutIter ());
       fragments = 0;
-      m_fragments.erase (key);
+      if (it == m_fragments.end ())
+        {
+          m_fragments.erase (key);
+        }
+      else
+        {
+          m_fragments.erase (it);
+        }
       return true;
     }
 
@@ -2461,6 +2423,7 @@ SixLowPanNetDevice::Fragments::Fragments ()
 {
   NS_LOG_FUNCTION (this);
   m_packetSize = 0;
+  m_receivedBytes = 0;
 }
 
 SixLowPanNetDevice::Fragments::~Fragments ()
@@ -2491,6 +2454,7 @@ void SixLowPanNetDevice::Fragments::AddFragment (Ptr<Packet> fragment, uint16_t
   if (!duplicate)
     {
       m_fragments.insert (it, std::make_pair (fragment, fragmentOffset));
+      m_receivedBytes += fragment->GetSize ();
     }
 }
 
@@ -2505,6 +2469,13 @@ bool SixLowPanNetDevice::Fragments::IsEntire () const
 {
   NS_LOG_FUNCTION (this);
 
+  // fragments can only overlap, so the packet can not be entire until
+  // their sizes add up to the packet size
+  if (m_receivedBytes < m_packetSize)
+    {
+      return false;
+    }
+
   bool ret = m_fragments.size () > 0;
   uint16_t lastEndOffset = 0;
 
@@ -2539,10 +2510,12 @@ Ptr<Packet> SixLowPanNetDevice::Fragments::GetPacket () const
 
   std::list<std::pair<Ptr<Packet>, uint16_t> >::const_iterator it = m_fragments.begin ();
 
-  Ptr<Packet> p = Create<Packet> ();
+  // start from a copy-on-write copy of the first fragment rather than
+  // appending it to an empty packet, which would copy its bytes
+  Ptr<Packet> p = m_firstFragment->Copy ();
+  p->RemoveAllPacketTags ();
   uint16_t lastEndOffset = 0;
 
-  p->AddAtEnd (m_firstFragment);
   it = m_fragments.begin ();
   lastEndOffset = it->first->GetSize ();
 
@@ -2580,6 +2553,27 @@ std::list< Ptr<Packet> > SixLowPanNetDevice::Fragments::GetFraments () const
   return fragments;
 }
 
+std::size_t
+SixLowPanNetDevice::FragmentKeyHash::operator() (const FragmentKey_t &key) const
+{
+  uint8_t buf[2 * (Address::MAX_SIZE + 2) + 4];
+  uint32_t size = key.first.first.CopyAllTo (buf, Address::MAX_SIZE + 2);
+  size += key.first.second.CopyAllTo (buf + size, Address::MAX_SIZE + 2);
+  buf[size++] = key.second.first >> 8;
+  buf[size++] = key.second.first & 0xff;
+  buf[size++] = key.second.second >> 8;
+  buf[size++] = key.second.second & 0xff;
+  return Hash32 (reinterpret_cast<char *> (buf), size);
+}
+
+std::size_t
+SixLowPanNetDevice::AddressHash::operator() (const Address &address) const
+{
+  uint8_t buf[Address::MAX_SIZE + 2];
+  uint32_t size = address.CopyAllTo (buf, Address::MAX_SIZE + 2);
+  return Hash32 (reinterpret_cast<char *> (buf), size);
+}
+
 void
 SixLowPanNetDevice::Fragments::SetTimeoutIter (FragmentsTimeoutsListI_t iter)
 {
@@ -2607,7 +2601,7 @@ void SixLowPanNetDevice::HandleFragmentsTimeout (FragmentKey_t key, uint32_t iif
   // clear the buffers
   it->second = 0;
 
-  m_fragments.erase (key);
+  m_fragments.erase (it);
 }
 
 Address SixLowPanNetDevice::Get16MacFrom48Mac (Address addr)
@@ -2675,9 +2669,28 @@ void SixLowPanNetDevice::AddContext (uint8_t contextId, Ipv6Prefix contextPrefix
       return;
     }
 
-  m_contextTable[contextId].contextPrefix = contextPrefix;
-  m_contextTable[contextId].compressionAllowed = compressionAllowed;
-  m_contextTable[contextId].validLifetime = Simulator::Now () + validLifetime;
+  ContextEntry &context = m_contextTable[contextId];
+  context.contextPrefix = contextPrefix;
+  context.compressionAllowed = compressionAllowed;
+  context.validLifetime = Simulator::Now () + validLifetime;
+
+  // The prefix is matched against the addresses byte by byte.
+  uint8_t prefixLength = contextPrefix.GetPrefixLength ();
+  contextPrefix.GetBytes (context.prefixBytes);
+  for (uint8_t i = 0; i < 16; i++)
+    {
+      if (prefixLength >= 8)
+        {
+          context.prefixMask[i] = 0xff;
+          prefixLength -= 8;
+        }
+      else
+        {
+          context.prefixMask[i] = ~(0xff >> prefixLength);
+          prefixLength = 0;
+        }
+      context.prefixBytes[i] &= context.prefixMask[i];
+    }
 
   return;
 }
@@ -2765,23 +2778,30 @@ void SixLowPanNetDevice::RemoveContext (uint8_t contextId)
   return;
 }
 
-bool SixLowPanNetDevice::FindUnicastCompressionContext (Ipv6Address address, uint8_t& contextId)
+bool SixLowPanNetDevice::FindUnicastCompressionContext (const uint8_t address[16], uint8_t& contextId)
 {
-  NS_LOG_FUNCTION (this << address);
+  NS_LOG_FUNCTION (this << Ipv6Address::Deserialize (address));
 
+  Time now = Simulator::Now ();
   for (const auto& iter: m_contextTable)
     {
-      ContextEntry context = iter.second;
+      const ContextEntry &context = iter.second;
 
-      if ( (context.compressionAllowed == true) && (context.validLifetime > Simulator::Now ()) )
+      if ( (context.compressionAllowed == true) && (context.validLifetime > now) )
         {
-
-          if (address.HasPrefix (context.contextPrefix))
+          // The prefix must match, and the bits of the first 64 not covered
+          // by the prefix must be null, as they are not sent.
+          bool match = true;
+          for (uint8_t i = 0; i < 16 && match; i++)
             {
+              uint8_t mask = (i < 8) ? 0xff : context.prefixMask[i];
+              match = ((address[i] & mask) == context.prefixBytes[i]);
+            }
+          if (match)
+            {
+              contextId = iter.first;
               NS_LOG_LOGIC ("Fount context " << +contextId << " " <<
                             Ipv6Address::GetOnes ().CombinePrefix (context.contextPrefix) << context.contextPrefix << " matching");
-
-              contextId = iter.first;
               return true;
             }
         }
@@ -2789,72 +2809,51 @@ bool SixLowPanNetDevice::FindUnicastCompressionContext (Ipv6Address address, uin
   return false;
 }
 
-bool SixLowPanNetDevice::FindMulticastCompressionContext (Ipv6Address address, uint8_t& contextId)
+bool SixLowPanNetDevice::FindMulticastCompressionContext (const uint8_t address[16], uint8_t& contextId)
 {
-  NS_LOG_FUNCTION (this << address);
+  NS_LOG_FUNCTION (this << Ipv6Address::Deserialize (address));
 
   // The only allowed context-based compressed multicast address is in the form
   // ffXX:XXLL:PPPP:PPPP:PPPP:PPPP:XXXX:XXXX
 
+  Time now = Simulator::Now ();
   for (const auto& iter: m_contextTable)
     {
-      ContextEntry context = iter.second;
+      const ContextEntry &context = iter.second;
 
-      if ( (context.compressionAllowed == true) && (context.validLifetime > Simulator::Now ()) )
+      if ( (context.compressionAllowed == true) && (context.validLifetime > now) )
         {
           uint8_t contextLength = context.contextPrefix.GetPrefixLength ();
 
-          if (contextLength <= 64) // only 64-bit prefixes or less are allowed.
+          // only 64-bit prefixes or less are allowed.
+          if (contextLength <= 64 && address[3] == contextLength
+              && memcmp (address + 4, context.prefixBytes, 8) == 0)
             {
-              uint8_t contextBytes[16];
-              uint8_t addressBytes[16];
-
-              context.contextPrefix.GetBytes (contextBytes);
-              address.GetBytes (addressBytes);
-
-              if (addressBytes[3] == contextLength &&
-                  addressBytes[4] == contextBytes[0] &&
-                  addressBytes[5] == contextBytes[1] &&
-                  addressBytes[6] == contextBytes[2] &&
-                  addressBytes[7] == contextBytes[3] &&
-                  addressBytes[8] == contextBytes[4] &&
-                  addressBytes[9] == contextBytes[5] &&
-                  addressBytes[10] == contextBytes[6] &&
-                  addressBytes[11] == contextBytes[7])
-                {
-                  NS_LOG_LOGIC ("Fount context " << +contextId << " " <<
-                                Ipv6Address::GetOnes ().CombinePrefix (context.contextPrefix) << context.contextPrefix << " matching");
-
-                  contextId = iter.first;
-                  return true;
-                }
+              contextId = iter.first;
+              NS_LOG_LOGIC ("Fount context " << +contextId << " " <<
+                            Ipv6Address::GetOnes ().CombinePrefix (context.contextPrefix) << context.contextPrefix << " matching");
+              return true;
             }
         }
     }
   return false;
 }
 
-Ipv6Address SixLowPanNetDevice::CleanPrefix (Ipv6Address address, Ipv6Prefix prefix)
+void SixLowPanNetDevice::CleanPrefix (const uint8_t address[16], const ContextEntry &context, uint8_t cleaned[16])
 {
-  uint8_t addressBytes[16];
-  address.GetBytes (addressBytes);
-  uint8_t prefixLength = prefix.GetPrefixLength ();
-
-  uint8_t bytesToClean = prefixLength / 8;
-  uint8_t bitsToClean = prefixLength % 8;
-  for (uint8_t i=0; i<bytesToClean; i++)
+  for (uint8_t i = 0; i < 16; i++)
     {
-      addressBytes[i] = 0;
+      cleaned[i] = address[i] & ~context.prefixMask[i];
     }
-  if (bitsToClean)
+}
+
+void SixLowPanNetDevice::ApplyPrefix (uint8_t address[16], const ContextEntry &context)
+{
+  // Do not combine the prefix - we want to override the bits.
+  for (uint8_t i = 0; i < 16; i++)
     {
-      uint8_t cleanupMask = (1<<bitsToClean)-1;
-      addressBytes[bytesToClean] &= cleanupMask;
+      address[i] = context.prefixBytes[i] | (address[i] & ~context.prefixMask[i]);
     }
-
-  Ipv6Address cleanedAddress = Ipv6Address::Deserialize (addressBytes);
-
-  return cleanedAddress;
 }
 
 }
@@ -25,6 +25,9 @@
 #include <stdint.h>
 #include <string>
 #include <map>
+#include <unordered_map>
+#include <bitset>
+#include <deque>
 #include <tuple>
 #include "ns3/traced-callback.h"
 #include "ns3/nstime.h"
@@ -410,6 +413,32 @@ private:
    */
   typedef std::pair< std::pair<Address, Address>, std::pair<uint16_t, uint16_t> > FragmentKey_t;
 
+  /**
+   * \brief Hash function for the fragment identifiers.
+   */
+  struct FragmentKeyHash
+  {
+    /**
+     * \brief Hash a fragment identifier.
+     * \param [in] key The fragment identifier.
+     * \return The hash.
+     */
+    std::size_t operator() (const FragmentKey_t &key) const;
+  };
+
+  /**
+   * \brief Hash function for the mesh-under originator addresses.
+   */
+  struct AddressHash
+  {
+    /**
+     * \brief Hash an address.
+     * \param [in] address The address.
+     * \return The hash.
+     */
+    std::size_t operator() (const Address &address) const;
+  };
+
   /// Container for fragment timeouts.
   typedef std::list< std::tuple <Time, FragmentKey_t, uint32_t > > FragmentsTimeoutsList_t;
   /// Container Iterator for fragment timeouts.
@@ -504,6 +533,12 @@ private:
      */
     uint32_t m_packetSize;
 
+    /**
+     * \brief The sum of the sizes of the current fragments (bytes).
+     * The packet can not be entire before this reaches m_packetSize.
+     */
+    uint32_t m_receivedBytes;
+
     /**
      * \brief The current fragments.
      */
@@ -563,11 +598,11 @@ private:
   /**
    * Container for fragment key -> fragments.
    */
-  typedef std::map< FragmentKey_t, Ptr<Fragments> > MapFragments_t;
+  typedef std::unordered_map< FragmentKey_t, Ptr<Fragments>, FragmentKeyHash > MapFragments_t;
   /**
    * Container Iterator for fragment key -> fragments.
    */
-  typedef std::map< FragmentKey_t, Ptr<Fragments> >::iterator MapFragmentsI_t;
+  typedef std::unordered_map< FragmentKey_t, Ptr<Fragments>, FragmentKeyHash >::iterator MapFragmentsI_t;
 
   MapFragments_t       m_fragments; //!< Fragments hold to be rebuilt.
   Time                 m_fragmentExpirationTimeout; //!< Time limit for fragment rebuilding.
@@ -585,7 +620,17 @@ private:
   uint8_t m_meshUnderHopsLeft;    //!< Start value for mesh-under hops left.
   uint16_t m_meshCacheLength;     //!< length of the cache for each source.
   Ptr<RandomVariableStream> m_meshUnderJitter; //!< Random variable for the mesh-under packet retransmission.
-  std::map <Address /* OriginatorAdddress */, std::list <uint8_t  /* SequenceNumber */> > m_seenPkts; //!< Seen packets, memorized by OriginatorAdddress, SequenceNumber.
+
+  /**
+   * \brief The BC0 sequence numbers recently seen from an originator.
+   */
+  struct SeenSequenceWindow
+  {
+    std::bitset<256> seen;          //!< Sequence numbers in the window.
+    std::deque<uint8_t> order;      //!< Sequence numbers in the window, oldest first.
+  };
+
+  std::unordered_map <Address /* OriginatorAdddress */, SeenSequenceWindow, AddressHash> m_seenPkts; //!< Seen packets, memorized by OriginatorAdddress, SequenceNumber.
 
   Ptr<Node> m_node; //!< Smart pointer to the Node.
   Ptr<NetDevice> m_netDevice; //!< Smart pointer to the underlying NetDevice.
@@ -612,6 +657,8 @@ private:
     Ipv6Prefix contextPrefix;    //!< context prefix to be used in compression/decompression
     bool compressionAllowed;     //!< compression and decompression allowed (true), decompression only (false)
     Time validLifetime;          //!< validity period
+    uint8_t prefixBytes[16];     //!< context prefix bytes, masked by the prefix length
+    uint8_t prefixMask[16];      //!< mask of the context prefix length
   };
 
   std::map<uint8_t, ContextEntry> m_contextTable; //!< Table of the contexts used in compression/decompression
@@ -619,20 +666,24 @@ private:
   /**
    * \brief Finds if the given unicast address matches a context for compression
    *
-   * \param[in] address the address to check
+   * The address matches if its prefix is the context one, and if the bits
+   * between the context prefix and the interface identifier are null, as they
+   * are not carried by the compressed address.
+   *
+   * \param[in] address the address bytes to check
    * \param[out] contextId the context found
    * \return true if a valid context has been found
    */
-  bool FindUnicastCompressionContext (Ipv6Address address, uint8_t& contextId);
+  bool FindUnicastCompressionContext (const uint8_t address[16], uint8_t& contextId);
 
   /**
    * \brief Finds if the given multicast address matches a context for compression
    *
-   * \param[in] address the address to check
+   * \param[in] address the address bytes to check
    * \param[out] contextId the context found
    * \return true if a valid context has been found
    */
-  bool FindMulticastCompressionContext (Ipv6Address address, uint8_t& contextId);
+  bool FindMulticastCompressionContext (const uint8_t address[16], uint8_t& contextId);
 
   /**
    * \brief Clean an address from its prefix.
@@ -640,11 +691,21 @@ private:
    * This function is used to find the relevant bits to be sent in stateful IPHC compression.
    * Only the pefix length is used - the address prefix is assumed to be matching the prefix.
    *
-   * \param address the address to be cleaned
-   * \param prefix the prefix to remove
-   * \return An address with the prefix zeroed.
+   * \param[in] address the address bytes to be cleaned
+   * \param[in] context the context whose prefix is removed
+   * \param[out] cleaned the address bytes with the prefix zeroed
+   */
+  void CleanPrefix (const uint8_t address[16], const ContextEntry &context, uint8_t cleaned[16]);
+
+  /**
+   * \brief Rebuild an address from a context prefix.
+   *
+   * The bits covered by the context prefix are overridden by the prefix ones.
+   *
+   * \param[in,out] address the address bytes
+   * \param[in] context the context whose prefix is used
    */
-  Ipv6Address CleanPrefix (Ipv6Address address, Ipv6Prefix prefix);
+  void ApplyPrefix (uint8_t address[16], const ContextEntry &context);
 };
 
 } // namespace ns3
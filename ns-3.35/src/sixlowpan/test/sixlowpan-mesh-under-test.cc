@@ -0,0 +1,186 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/node.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/mac16-address.h"
+#include "ns3/mac48-address.h"
+
+#include "ns3/sixlowpan-net-device.h"
+#include "ns3/sixlowpan-header.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup sixlowpan-test
+ * \ingroup tests
+ *
+ * \brief 6LoWPAN mesh-under duplicate detection Test
+ *
+ * Mesh-under packets, with the BC0 sequence numbers of a few originators,
+ * are received by a 6LoWPAN device: a sequence number already seen among
+ * the last MeshCacheLength ones of its originator, either the last one
+ * (duplicate) or an older one (stale), is dropped, whereas any other one is
+ * delivered.
+ */
+class SixlowpanMeshUnderTest : public TestCase
+{
+public:
+  SixlowpanMeshUnderTest ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Deliver mesh-under packets and check which ones are passed to
+   * the upper layer.
+   */
+  void ReceiveMeshPackets (void);
+
+  /**
+   * \brief Deliver a mesh-under packet to the 6LoWPAN device.
+   * \param originator The originator of the packet.
+   * \param sequenceNumber The BC0 sequence number.
+   * \return True if the packet has been passed to the upper layer.
+   */
+  bool ReceiveMeshPacket (Mac16Address originator, uint8_t sequenceNumber);
+
+  /**
+   * \brief Receive a packet from the 6LoWPAN device.
+   * \param device The device.
+   * \param packet The packet.
+   * \param protocol The protocol number.
+   * \param from The source address.
+   * \return True.
+   */
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from);
+
+  Ptr<SimpleNetDevice> m_device;  //!< The lower-layer device.
+  uint32_t m_received;            //!< Number of packets passed to the upper layer.
+};
+
+SixlowpanMeshUnderTest::SixlowpanMeshUnderTest ()
+  : TestCase ("Sixlowpan mesh-under duplicate detection"),
+    m_received (0)
+{
+}
+
+bool
+SixlowpanMeshUnderTest::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from)
+{
+  m_received++;
+  return true;
+}
+
+bool
+SixlowpanMeshUnderTest::ReceiveMeshPacket (Mac16Address originator, uint8_t sequenceNumber)
+{
+  Ptr<Packet> packet = Create<Packet> (10);
+  SixLowPanIpv6 ipv6Hdr;
+  packet->AddHeader (ipv6Hdr);
+  SixLowPanBc0 bc0Hdr;
+  bc0Hdr.SetSequenceNumber (sequenceNumber);
+  packet->AddHeader (bc0Hdr);
+  // addressed to this device, so that the packet is not forwarded
+  SixLowPanMesh meshHdr;
+  meshHdr.SetHopsLeft (5);
+  meshHdr.SetOriginator (originator);
+  meshHdr.SetFinalDst (Mac16Address ("00:02"));
+  packet->AddHeader (meshHdr);
+
+  uint32_t received = m_received;
+  m_device->Receive (packet, 0x86DD, Mac48Address::ConvertFrom (m_device->GetAddress ()),
+                     Mac48Address ("00:00:00:00:00:01"));
+  return m_received > received;
+}
+
+void
+SixlowpanMeshUnderTest::DoRun (void)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  m_device = CreateObject<SimpleNetDevice> ();
+  m_device->SetAddress (Mac48Address ("00:00:00:00:00:02"));
+  node->AddDevice (m_device);
+
+  Ptr<SixLowPanNetDevice> sixlowpan = CreateObject<SixLowPanNetDevice> ();
+  sixlowpan->SetAttribute ("UseMeshUnder", BooleanValue (true));
+  sixlowpan->SetAttribute ("MeshCacheLength", UintegerValue (3));
+  node->AddDevice (sixlowpan);
+  sixlowpan->SetNetDevice (m_device);
+  sixlowpan->SetReceiveCallback (MakeCallback (&SixlowpanMeshUnderTest::Receive, this));
+
+  Simulator::ScheduleWithContext (node->GetId (), Seconds (0),
+                                  &SixlowpanMeshUnderTest::ReceiveMeshPackets, this);
+  Simulator::Run ();
+
+  m_device = 0;
+  Simulator::Destroy ();
+}
+
+void
+SixlowpanMeshUnderTest::ReceiveMeshPackets (void)
+{
+  Mac16Address first ("00:01");
+  Mac16Address second ("00:03");
+
+  NS_TEST_EXPECT_MSG_EQ (ReceiveMeshPacket (first, 1), true, "New sequence number dropped");
+  NS_TEST_EXPECT_MSG_EQ (ReceiveMeshPacket (first, 1), false, "Duplicate sequence number delivered");
+  NS_TEST_EXPECT_MSG_EQ (ReceiveMeshPacket (first, 2), true, "New sequence number dropped");
+  NS_TEST_EXPECT_MSG_EQ (ReceiveMeshPacket (first, 3), true, "New sequence number dropped");
+  NS_TEST_EXPECT_MSG_EQ (ReceiveMeshPacket (first, 1), false, "Stale sequence number delivered");
+  NS_TEST_EXPECT_MSG_EQ (ReceiveMeshPacket (first, 2), false, "Stale sequence number delivered");
+
+  // a sequence number skipping some others is new, and pushes 1 out of the cache
+  NS_TEST_EXPECT_MSG_EQ (ReceiveMeshPacket (first, 5), true, "New sequence number dropped");
+  NS_TEST_EXPECT_MSG_EQ (ReceiveMeshPacket (first, 4), true, "New older sequence number dropped");
+  NS_TEST_EXPECT_MSG_EQ (ReceiveMeshPacket (first, 3), false, "Stale sequence number delivered");
+  NS_TEST_EXPECT_MSG_EQ (ReceiveMeshPacket (first, 1), true, "Sequence number out of the cache dropped");
+
+  // the sequence numbers are memorized for each originator
+  NS_TEST_EXPECT_MSG_EQ (ReceiveMeshPacket (second, 5), true, "Sequence number of another originator dropped");
+  NS_TEST_EXPECT_MSG_EQ (ReceiveMeshPacket (second, 5), false, "Duplicate sequence number delivered");
+
+  // the sequence numbers wrap around
+  NS_TEST_EXPECT_MSG_EQ (ReceiveMeshPacket (second, 255), true, "New sequence number dropped");
+  NS_TEST_EXPECT_MSG_EQ (ReceiveMeshPacket (second, 0), true, "Wrapped sequence number dropped");
+  NS_TEST_EXPECT_MSG_EQ (ReceiveMeshPacket (second, 255), false, "Stale sequence number delivered");
+
+  NS_TEST_EXPECT_MSG_EQ (m_received, 9, "Wrong number of packets delivered");
+}
+
+/**
+ * \ingroup sixlowpan-test
+ * \ingroup tests
+ *
+ * \brief 6LoWPAN mesh-under TestSuite
+ */
+class SixlowpanMeshUnderTestSuite : public TestSuite
+{
+public:
+  SixlowpanMeshUnderTestSuite ();
+};
+
+SixlowpanMeshUnderTestSuite::SixlowpanMeshUnderTestSuite ()
+  : TestSuite ("sixlowpan-mesh-under", UNIT)
+{
+  AddTestCase (new SixlowpanMeshUnderTest (), TestCase::QUICK);
+}
+
+static SixlowpanMeshUnderTestSuite g_sixlowpanMeshUnderTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,139 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * This program measures the time and the number of heap allocations
+ * needed to create the transmit power spectral densities of Wi-Fi PPDUs
+ * and LTE subframes, as done by the PHYs for every transmission:
+ *
+ * - "he 20/80/160": WifiSpectrumValueHelper::CreateHeOfdmTxPowerSpectralDensity
+ * - "he-mu 80": WifiSpectrumValueHelper::CreateHeMuOfdmTxPowerSpectralDensity
+ * - "ht 40": WifiSpectrumValueHelper::CreateHtOfdmTxPowerSpectralDensity
+ * - "ofdm 20": WifiSpectrumValueHelper::CreateOfdmTxPowerSpectralDensity
+ * - "lte dl 100": LteSpectrumValueHelper::CreateTxPowerSpectralDensity
+ * - "lte ul 100": LteSpectrumValueHelper::CreateUlTxPowerSpectralDensity
+ *
+ * ./waf --run "spectrum-psd-benchmark --n=10000"
+ */
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+
+#include "ns3/core-module.h"
+#include "ns3/wifi-spectrum-value-helper.h"
+#include "ns3/lte-spectrum-value-helper.h"
+
+using namespace ns3;
+
+/// Number of heap allocations
+static uint64_t g_allocations = 0;
+
+/**
+ * Count the heap allocations
+ * \param size the size of the allocation
+ * \return the allocated memory
+ */
+void *
+operator new (std::size_t size)
+{
+  g_allocations++;
+  void *p = std::malloc (size);
+  if (p == 0)
+    {
+      throw std::bad_alloc ();
+    }
+  return p;
+}
+
+/**
+ * Free the memory allocated by operator new
+ * \param p the memory
+ */
+void
+operator delete (void *p) noexcept
+{
+  std::free (p);
+}
+
+/**
+ * Run a benchmark
+ * \param name the name of the benchmark
+ * \param n the number of PSDs to create
+ * \param create the function creating a PSD for a transmit power
+ * \param band a band where the PSD is not null, used to check the PSDs
+ */
+template <typename F>
+static void
+Run (std::string name, uint32_t n, F create, uint32_t band)
+{
+  // the first PSD also creates the spectrum model, so it is not counted
+  create (0.1);
+  uint64_t allocations = g_allocations;
+  SystemWallClockMs clock;
+  clock.Start ();
+  double sum = 0;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      // vary the transmit power, as power control does
+      Ptr<SpectrumValue> psd = create (0.01 + (i % 100) * 0.001);
+      sum += (*psd)[band];
+    }
+  int64_t elapsed = clock.End ();
+  std::cout << std::setw (12) << name
+            << std::setw (16) << std::fixed << std::setprecision (3) << elapsed * 1000.0 / n
+            << std::setw (16) << std::setprecision (1) << (g_allocations - allocations) / static_cast<double> (n)
+            << (sum > 0 ? "" : "  ERROR: empty PSD") << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 10000;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("n", "Number of PSDs per benchmark", n);
+  cmd.Parse (argc, argv);
+
+  std::cout << "PSDs per benchmark: " << n << std::endl;
+  std::cout << std::setw (12) << "psd" << std::setw (16) << "time (us)" << std::setw (16) << "allocations" << std::endl;
+
+  Run ("he 20", n, [] (double txPowerW)
+       { return WifiSpectrumValueHelper::CreateHeOfdmTxPowerSpectralDensity (5180, 20, txPowerW, 20); }, 100);
+  Run ("he 80", n, [] (double txPowerW)
+       { return WifiSpectrumValueHelper::CreateHeOfdmTxPowerSpectralDensity (5210, 80, txPowerW, 80); }, 1100);
+  Run ("he 160", n, [] (double txPowerW)
+       { return WifiSpectrumValueHelper::CreateHeOfdmTxPowerSpectralDensity (5250, 160, txPowerW, 160); }, 2100);
+  Run ("he-mu 80", n, [] (double txPowerW)
+       { return WifiSpectrumValueHelper::CreateHeMuOfdmTxPowerSpectralDensity (5210, 80, txPowerW, 80,
+                                                                               std::make_pair (500, 541)); }, 520);
+  Run ("ht 40", n, [] (double txPowerW)
+       { return WifiSpectrumValueHelper::CreateHtOfdmTxPowerSpectralDensity (5190, 40, txPowerW, 40); }, 200);
+  Run ("ofdm 20", n, [] (double txPowerW)
+       { return WifiSpectrumValueHelper::CreateOfdmTxPowerSpectralDensity (5180, 20, txPowerW, 20); }, 100);
+
+  std::vector<int> rbs;
+  for (int i = 0; i < 100; i++)
+    {
+      rbs.push_back (i);
+    }
+  Run ("lte dl 100", n, [&rbs] (double txPowerW)
+       { return LteSpectrumValueHelper::CreateTxPowerSpectralDensity (100, 100, 30 + 10 * std::log10 (txPowerW), rbs); }, 50);
+  Run ("lte ul 100", n, [&rbs] (double txPowerW)
+       { return LteSpectrumValueHelper::CreateUlTxPowerSpectralDensity (18100, 100, 30 + 10 * std::log10 (txPowerW), rbs); }, 50);
+
+  return 0;
+}
@@ -22,6 +22,7 @@
 #include <ns3/object-factory.h>
 #include <ns3/log.h>
 #include <ns3/double.h>
+#include <ns3/boolean.h>
 #include <ns3/simulator.h>
 #include <ns3/trace-source-accessor.h>
 #include <ns3/antenna-model.h>
@@ -41,7 +42,10 @@ SpectrumAnalyzer::SpectrumAnalyzer ()
     m_spectrumModel (0),
     m_sumPowerSpectralDensity (0),
     m_resolution (MilliSeconds (50)),
-    m_active (false)
+    m_active (false),
+    m_lazyReports (false),
+    m_reportChangeThreshold (0),
+    m_recordSpectrogram (false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -63,6 +67,9 @@ SpectrumAnalyzer::DoDispose ()
   m_spectrumModel = 0;
   m_sumPowerSpectralDensity = 0;
   m_energySpectralDensity = 0;
+  m_lastReport = 0;
+  m_activeSignals.clear ();
+  m_reportEvent.Cancel ();
   SpectrumPhy::DoDispose ();
 }
 
@@ -87,11 +94,40 @@ SpectrumAnalyzer::GetTypeId (void)
                    DoubleValue (1.38e-23 * 300),
                    MakeDoubleAccessor (&SpectrumAnalyzer::m_noisePowerSpectralDensity),
                    MakeDoubleChecker<double> ())
+    .AddAttribute ("LazyReports",
+                   "If true, no periodic event is scheduled: the elapsed "
+                   "averaging intervals are reported only when a new signal "
+                   "is received, when the analyzer is sampled or when it is "
+                   "stopped. Reports are then fired late, hence the "
+                   "TimedAveragePowerSpectralDensityReport trace source "
+                   "should be used to know the interval they refer to.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&SpectrumAnalyzer::m_lazyReports),
+                   MakeBooleanChecker ())
+    .AddAttribute ("ReportChangeThreshold",
+                   "A report is emitted only if the norm of its difference "
+                   "with the last emitted report, relative to the norm of the "
+                   "latter, exceeds this threshold. Zero emits every report.",
+                   DoubleValue (0),
+                   MakeDoubleAccessor (&SpectrumAnalyzer::m_reportChangeThreshold),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("RecordSpectrogram",
+                   "If true, the emitted reports are stored so that they can "
+                   "be exported with WriteSpectrogram.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&SpectrumAnalyzer::m_recordSpectrogram),
+                   MakeBooleanChecker ())
     .AddTraceSource ("AveragePowerSpectralDensityReport",
                      "Trace fired whenever a new value for the average "
                      "Power Spectral Density is calculated",
                      MakeTraceSourceAccessor (&SpectrumAnalyzer::m_averagePowerSpectralDensityReportTrace),
                      "ns3::SpectrumValue::TracedCallback")
+    .AddTraceSource ("TimedAveragePowerSpectralDensityReport",
+                     "Trace fired whenever a new value for the average "
+                     "Power Spectral Density is calculated, along with "
+                     "the end time of the averaging interval",
+                     MakeTraceSourceAccessor (&SpectrumAnalyzer::m_timedReportTrace),
+                     "ns3::SpectrumAnalyzer::TimedReportTracedCallback")
   ;
   return tid;
 }
@@ -161,40 +197,61 @@ void
 SpectrumAnalyzer::StartRx (Ptr<SpectrumSignalParameters> params)
 {
   NS_LOG_FUNCTION ( this << params);
-  AddSignal (params->psd);
-  Simulator::Schedule (params->duration, &SpectrumAnalyzer::SubtractSignal, this, params->psd);
+  if (m_active && m_lazyReports)
+    {
+      CloseElapsedIntervals ();
+    }
+  AddSignal (params->psd, params->duration);
 }
 
 
 void
-SpectrumAnalyzer::AddSignal  (Ptr<const SpectrumValue> psd)
+SpectrumAnalyzer::AddSignal  (Ptr<const SpectrumValue> psd, Time duration)
 {
-  NS_LOG_FUNCTION (this << *psd);
+  NS_LOG_FUNCTION (this << *psd << duration);
   UpdateEnergyReceivedSoFar ();
   (*m_sumPowerSpectralDensity) += (*psd);
+  m_activeSignals.insert (std::make_pair (Now () + duration, psd));
 }
 
 void
-SpectrumAnalyzer::SubtractSignal  (Ptr<const SpectrumValue> psd)
+SpectrumAnalyzer::IntegrateUntil (Time time)
 {
-  NS_LOG_FUNCTION (this << *psd);
-  UpdateEnergyReceivedSoFar ();
-  (*m_sumPowerSpectralDensity) -= (*psd);
+  NS_LOG_FUNCTION (this << time);
+  NS_ASSERT (time >= m_lastChangeTime);
+  while (!m_activeSignals.empty () && m_activeSignals.begin ()->first <= time)
+    {
+      auto it = m_activeSignals.begin ();
+      (*m_energySpectralDensity) += (*m_sumPowerSpectralDensity) * ((it->first - m_lastChangeTime).GetSeconds ());
+      (*m_sumPowerSpectralDensity) -= (*it->second);
+      m_lastChangeTime = it->first;
+      m_activeSignals.erase (it);
+    }
+  if (m_lastChangeTime < time)
+    {
+      (*m_energySpectralDensity) += (*m_sumPowerSpectralDensity) * ((time - m_lastChangeTime).GetSeconds ());
+      m_lastChangeTime = time;
+    }
 }
 
 void
 SpectrumAnalyzer::UpdateEnergyReceivedSoFar  ()
 {
   NS_LOG_FUNCTION (this);
-  if (m_lastChangeTime < Now ())
-    {
-      (*m_energySpectralDensity) += (*m_sumPowerSpectralDensity) * ((Now () - m_lastChangeTime).GetSeconds ());
-      m_lastChangeTime = Now ();
-    }
-  else
+  IntegrateUntil (Now ());
+}
+
+void
+SpectrumAnalyzer::CloseElapsedIntervals ()
+{
+  NS_LOG_FUNCTION (this);
+  while (m_nextReportTime <= Now ())
     {
-      NS_ASSERT (m_lastChangeTime == Now ());
+      IntegrateUntil (m_nextReportTime);
+      EmitReport (m_nextReportTime);
+      m_nextReportTime += m_resolution;
     }
+  UpdateEnergyReceivedSoFar ();
 }
 
 void
@@ -203,19 +260,103 @@ SpectrumAnalyzer::GenerateReport ()
   NS_LOG_FUNCTION (this);
 
   UpdateEnergyReceivedSoFar ();
+  EmitReport (Now ());
+  m_nextReportTime = Now () + m_resolution;
+
+  if (m_active)
+    {
+      m_reportEvent = Simulator::Schedule (m_resolution, &SpectrumAnalyzer::GenerateReport, this);
+    }
+}
+
+void
+SpectrumAnalyzer::EmitReport (Time intervalEnd)
+{
+  NS_LOG_FUNCTION (this << intervalEnd);
+
   Ptr<SpectrumValue> avgPowerSpectralDensity = Create<SpectrumValue> (m_sumPowerSpectralDensity->GetSpectrumModel ());
   (*avgPowerSpectralDensity) = (*m_energySpectralDensity) / m_resolution.GetSeconds ();
   (*avgPowerSpectralDensity) += m_noisePowerSpectralDensity;
   (*m_energySpectralDensity) = 0;
 
+  if (m_reportChangeThreshold > 0 && m_lastReport)
+    {
+      double lastNorm = Norm (*m_lastReport);
+      double change = Norm ((*avgPowerSpectralDensity) - (*m_lastReport));
+      if (change <= m_reportChangeThreshold * lastNorm)
+        {
+          NS_LOG_INFO ("report suppressed, relative change " << change / lastNorm);
+          return;
+        }
+    }
+  m_lastReport = avgPowerSpectralDensity;
+
+  if (m_recordSpectrogram)
+    {
+      m_spectrogramTimes.push_back (intervalEnd.GetNanoSeconds ());
+      for (Values::const_iterator vi = avgPowerSpectralDensity->ConstValuesBegin ();
+           vi != avgPowerSpectralDensity->ConstValuesEnd (); ++vi)
+        {
+          m_spectrogramValues.push_back (static_cast<float> (*vi));
+        }
+    }
+
   NS_LOG_INFO ("generating report");
   m_averagePowerSpectralDensityReportTrace (avgPowerSpectralDensity);
+  m_timedReportTrace (intervalEnd, avgPowerSpectralDensity);
+}
 
-  *avgPowerSpectralDensity = 0;
+Ptr<SpectrumValue>
+SpectrumAnalyzer::Sample ()
+{
+  NS_LOG_FUNCTION (this);
+  if (m_active && m_lazyReports)
+    {
+      CloseElapsedIntervals ();
+    }
+  else
+    {
+      UpdateEnergyReceivedSoFar ();
+    }
+  Ptr<SpectrumValue> avgPowerSpectralDensity = Create<SpectrumValue> (m_spectrumModel);
+  Time elapsed = m_resolution - (m_nextReportTime - Now ());
+  if (m_active && elapsed.IsStrictlyPositive ())
+    {
+      (*avgPowerSpectralDensity) = (*m_energySpectralDensity) / elapsed.GetSeconds ();
+    }
+  else
+    {
+      (*avgPowerSpectralDensity) = (*m_sumPowerSpectralDensity);
+    }
+  (*avgPowerSpectralDensity) += m_noisePowerSpectralDensity;
+  return avgPowerSpectralDensity;
+}
 
-  if (m_active)
+void
+SpectrumAnalyzer::WriteSpectrogram (std::string filename) const
+{
+  NS_LOG_FUNCTION (this << filename);
+  NS_ASSERT (m_spectrumModel);
+  std::ofstream os (filename.c_str (), std::ios::out | std::ios::binary);
+  if (!os.good ())
     {
-      Simulator::Schedule (m_resolution, &SpectrumAnalyzer::GenerateReport, this);
+      NS_FATAL_ERROR ("Can't open file " << filename);
+    }
+  const uint32_t version = 1;
+  uint32_t numBands = m_spectrumModel->GetNumBands ();
+  uint32_t numReports = m_spectrogramTimes.size ();
+  os.write ("SPGM", 4);
+  os.write (reinterpret_cast<const char *> (&version), sizeof (version));
+  os.write (reinterpret_cast<const char *> (&numBands), sizeof (numBands));
+  os.write (reinterpret_cast<const char *> (&numReports), sizeof (numReports));
+  for (Bands::const_iterator bi = m_spectrumModel->Begin (); bi != m_spectrumModel->End (); ++bi)
+    {
+      os.write (reinterpret_cast<const char *> (&bi->fc), sizeof (bi->fc));
+    }
+  for (uint32_t i = 0; i < numReports; ++i)
+    {
+      os.write (reinterpret_cast<const char *> (&m_spectrogramTimes[i]), sizeof (int64_t));
+      os.write (reinterpret_cast<const char *> (&m_spectrogramValues[i * numBands]), numBands * sizeof (float));
     }
 }
 
@@ -243,7 +384,11 @@ SpectrumAnalyzer::Start ()
     {
       NS_LOG_LOGIC ("activating");
       m_active = true;
-      Simulator::Schedule (m_resolution, &SpectrumAnalyzer::GenerateReport, this);
+      m_nextReportTime = Now () + m_resolution;
+      if (!m_lazyReports)
+        {
+          m_reportEvent = Simulator::Schedule (m_resolution, &SpectrumAnalyzer::GenerateReport, this);
+        }
     }
 }
 
@@ -251,6 +396,11 @@ SpectrumAnalyzer::Start ()
 void
 SpectrumAnalyzer::Stop ()
 {
+  NS_LOG_FUNCTION (this);
+  if (m_active && m_lazyReports)
+    {
+      CloseElapsedIntervals ();
+    }
   m_active = false;
 }
 
@@ -29,8 +29,11 @@
 #include <ns3/net-device.h>
 #include <ns3/spectrum-phy.h>
 #include <ns3/spectrum-channel.h>
+#include <ns3/event-id.h>
 #include <string>
 #include <fstream>
+#include <map>
+#include <vector>
 
 namespace ns3 {
 
@@ -44,6 +47,20 @@ namespace ns3 {
  *
  * This PHY model supports a single antenna model instance which is
  * used for reception (this PHY model never transmits). 
+ *
+ * The received power is integrated incrementally: the PSD of a signal
+ * is added to the running sum when its reception starts, and it is
+ * subtracted lazily, the next time the analyzer is updated, once the
+ * signal is over. No event is scheduled per received signal.
+ *
+ * By default a report is generated every Resolution interval. When the
+ * LazyReports attribute is set, no periodic event is scheduled at all;
+ * the elapsed Resolution intervals are closed (and reported) only when
+ * a new signal arrives, when Sample () is called or when the analyzer
+ * is stopped. The ReportChangeThreshold attribute can be used to
+ * suppress reports that do not differ significantly from the last
+ * emitted one, and RecordSpectrogram keeps the emitted reports in
+ * memory so that they can be exported with WriteSpectrogram ().
  */
 class SpectrumAnalyzer : public SpectrumPhy
 {
@@ -95,6 +112,39 @@ public:
    */
   virtual void Stop ();
 
+  /**
+   * Close the Resolution intervals elapsed so far and return the
+   * average power spectral density measured since the beginning of the
+   * current interval.
+   *
+   * \return the average power spectral density (W/Hz), including noise
+   */
+  Ptr<SpectrumValue> Sample ();
+
+  /**
+   * Write the recorded spectrogram (see the RecordSpectrogram attribute)
+   * to a binary file. The file is made of a header (the four characters
+   * "SPGM", the uint32_t format version, the uint32_t number of bands and
+   * the uint32_t number of reports), followed by the center frequency of
+   * each band in Hz (double), followed by the reports. Each report
+   * consists of the end time of its interval in nanoseconds (int64_t)
+   * and of the average power spectral density of each band in W/Hz
+   * (float). All values are written in host byte order.
+   *
+   * \param filename the name of the output file
+   */
+  void WriteSpectrogram (std::string filename) const;
+
+  /**
+   * TracedCallback signature for reports carrying the end time of the
+   * interval they refer to.
+   *
+   * \param [in] time the end of the averaging interval
+   * \param [in] psd the average power spectral density
+   */
+  typedef void (* TimedReportTracedCallback)
+    (Time time, Ptr<const SpectrumValue> psd);
+
 
 protected:
   void DoDispose ();
@@ -108,22 +158,38 @@ private:
   /**
    * Generates a report of the data collected so far.
    *
-   * This function is called periodically.
+   * This function is called periodically, unless LazyReports is set.
    */
   virtual void GenerateReport ();
 
   /**
    * Adds a signal to the data collected.
+   * \param psd the PSD of the signal
+   * \param duration the duration of the signal
    */
-  void AddSignal (Ptr<const SpectrumValue> psd);
+  void AddSignal (Ptr<const SpectrumValue> psd, Time duration);
   /**
-   * Removes a signal to the data collected.
+   * Integrates the received energy up to the given time, removing the
+   * signals whose reception ended in the meantime.
+   * \param time the time up to which the energy is integrated
    */
-  void SubtractSignal  (Ptr<const SpectrumValue> psd);
+  void IntegrateUntil (Time time);
   /**
    * Updates the data about the received Energy
    */
   void UpdateEnergyReceivedSoFar ();
+  /**
+   * Generates the reports of all the Resolution intervals elapsed so far
+   * and integrates the received energy up to now.
+   */
+  void CloseElapsedIntervals ();
+  /**
+   * Computes the average PSD of the interval ending at the given time,
+   * resets the accumulated energy and emits the report if it differs
+   * enough from the last emitted one.
+   * \param intervalEnd the end of the averaging interval
+   */
+  void EmitReport (Time intervalEnd);
 
   Ptr<SpectrumModel> m_spectrumModel;             //!< Spectrum model
   Ptr<SpectrumValue> m_sumPowerSpectralDensity;   //!< Sum of the received PSD
@@ -131,10 +197,23 @@ private:
   double m_noisePowerSpectralDensity;             //!< Noise power spectral density
   Time m_resolution;                              //!< Time resolution
   Time m_lastChangeTime;                          //!< When the last update happened
+  Time m_nextReportTime;                          //!< End of the current averaging interval
   bool m_active;                                  //!< True if the analyzer is active
+  bool m_lazyReports;                             //!< True if reports are generated only on demand
+  double m_reportChangeThreshold;                 //!< Minimum relative change for a report to be emitted
+  bool m_recordSpectrogram;                       //!< True if emitted reports are recorded
+  EventId m_reportEvent;                          //!< Periodic report event
+
+  /// Signals being received, sorted by end time
+  std::multimap<Time, Ptr<const SpectrumValue> > m_activeSignals;
+  Ptr<SpectrumValue> m_lastReport;                //!< Last emitted report
+  std::vector<int64_t> m_spectrogramTimes;        //!< End times (ns) of the recorded reports
+  std::vector<float> m_spectrogramValues;         //!< Values of the recorded reports
 
   /// TracedCallback - average power spectral density report.
   TracedCallback<Ptr<const SpectrumValue> > m_averagePowerSpectralDensityReportTrace;
+  /// TracedCallback - average power spectral density report with the interval end time.
+  TracedCallback<Time, Ptr<const SpectrumValue> > m_timedReportTrace;
 
 };
 
@@ -38,13 +38,40 @@ SpectrumConverter::SpectrumConverter (Ptr<const SpectrumModel> fromSpectrumModel
   NS_LOG_FUNCTION (this);
   m_fromSpectrumModel = fromSpectrumModel;
   m_toSpectrumModel = toSpectrumModel;
+  m_conversionMatrix = ComputeConversionMatrix (fromSpectrumModel, toSpectrumModel);
+}
+
+
+Ptr<SpectrumConverter::ConversionMatrix>
+SpectrumConverter::ComputeConversionMatrix (Ptr<const SpectrumModel> fromSpectrumModel, Ptr<const SpectrumModel> toSpectrumModel)
+{
+  NS_LOG_FUNCTION (fromSpectrumModel->GetUid () << toSpectrumModel->GetUid ());
+  Ptr<ConversionMatrix> matrix = Create<ConversionMatrix> ();
+  matrix->m_rowPtr.reserve (toSpectrumModel->GetNumBands ());
+
+  Bands::const_iterator fromBegin = fromSpectrumModel->Begin ();
+  Bands::const_iterator fromEnd = fromSpectrumModel->End ();
+  bool sorted = std::is_sorted (fromBegin, fromEnd,
+                                [] (const BandInfo& a, const BandInfo& b) { return a.fl < b.fl; })
+    && std::is_sorted (fromBegin, fromEnd,
+                       [] (const BandInfo& a, const BandInfo& b) { return a.fh < b.fh; });
 
-  size_t rowPtr = 0;
   for (Bands::const_iterator toit = toSpectrumModel->Begin (); toit != toSpectrumModel->End (); ++toit)
     {
-      size_t colInd = 0;
-      for (Bands::const_iterator fromit = fromSpectrumModel->Begin (); fromit != fromSpectrumModel->End (); ++fromit)
+      Bands::const_iterator fromit = fromBegin;
+      if (sorted)
+        {
+          // skip the bands ending before the beginning of the "to" band
+          fromit = std::upper_bound (fromBegin, fromEnd, toit->fl,
+                                     [] (double f, const BandInfo& b) { return f < b.fh; });
+        }
+      for (; fromit != fromEnd; ++fromit)
         {
+          if (sorted && fromit->fl >= toit->fh)
+            {
+              // no other band overlaps with the "to" band
+              break;
+            }
           double c = GetCoefficient (*fromit, *toit);
           NS_LOG_LOGIC ("(" << fromit->fl << ","  << fromit->fh << ")"
                             << " --> " <<
@@ -52,21 +79,18 @@ SpectrumConverter::SpectrumConverter (Ptr<const SpectrumModel> fromSpectrumModel
                             << " = " << c);
           if (c > 0)
             {
-              m_conversionMatrix.push_back (c);
-              m_conversionColInd.push_back (colInd);
-              rowPtr++;
+              matrix->m_values.push_back (c);
+              matrix->m_colInd.push_back (fromit - fromBegin);
             }
-          colInd++;
         }
-      m_conversionRowPtr.push_back (rowPtr);
+      matrix->m_rowPtr.push_back (matrix->m_values.size ());
     }
-
+  return matrix;
 }
 
 
-double SpectrumConverter::GetCoefficient (const BandInfo& from, const BandInfo& to) const
+double SpectrumConverter::GetCoefficient (const BandInfo& from, const BandInfo& to)
 {
-  NS_LOG_FUNCTION (this);
   double coeff = std::min (from.fh, to.fh) - std::max (from.fl, to.fl);
   coeff = std::max (0.0, coeff);
   coeff = std::min (1.0, coeff / (to.fh - to.fl));
@@ -82,23 +106,24 @@ SpectrumConverter::Convert (Ptr<const SpectrumValue> fvvf) const
 
   Ptr<SpectrumValue> tvvf = Create<SpectrumValue> (m_toSpectrumModel);
 
+  const double *from = &(*fvvf->ConstValuesBegin ());
+  const double *coeff = m_conversionMatrix->m_values.data ();
+  const size_t *colInd = m_conversionMatrix->m_colInd.data ();
   Values::iterator tvit = tvvf->ValuesBegin ();
   size_t i = 0; // Index of conversion coefficient
 
-  for (std::vector<size_t>::const_iterator convIt = m_conversionRowPtr.begin ();
-       convIt != m_conversionRowPtr.end ();
+  for (std::vector<size_t>::const_iterator convIt = m_conversionMatrix->m_rowPtr.begin ();
+       convIt != m_conversionMatrix->m_rowPtr.end ();
        ++convIt)
     {
       double sum = 0;
-      while (i < *convIt)
+      for (const size_t rowEnd = *convIt; i < rowEnd; ++i)
         {
-          sum += (*fvvf)[m_conversionColInd.at (i)] * m_conversionMatrix.at (i);
-          i++;
+          sum += from[colInd[i]] * coeff[i];
         }
       *tvit = sum;
       ++tvit;
     }
-
   return tvvf;
 }
 
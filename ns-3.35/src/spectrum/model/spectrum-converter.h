@@ -22,6 +22,7 @@
 #define SPECTRUM_CONVERTER_H
 
 #include <ns3/spectrum-value.h>
+#include <vector>
 
 
 namespace ns3 {
@@ -38,6 +39,9 @@ namespace ns3 {
  * and devices using a finer representation (e.g., one frequency for
  * each OFDM subcarrier).
  *
+ * The conversion coefficients are stored as a sparse matrix in
+ * Compressed Row Storage format, which is shared by the copies of a
+ * converter.
  */
 class SpectrumConverter : public SimpleRefCount<SpectrumConverter>
 {
@@ -76,11 +80,33 @@ private:
    * @return the fraction of the value of the "from" BandInfos that is
    * mapped to the "to" BandInfo
    */
-  double GetCoefficient (const BandInfo& from, const BandInfo& to) const;
+  static double GetCoefficient (const BandInfo& from, const BandInfo& to);
 
-  std::vector<double> m_conversionMatrix; //!< matrix of conversion coefficients stored in Compressed Row Storage format
-  std::vector<size_t> m_conversionRowPtr; //!< offset of rows in m_conversionMatrix
-  std::vector<size_t> m_conversionColInd; //!< column of each non-zero element in m_conversionMatrix
+  /**
+   * Matrix of conversion coefficients stored in Compressed Row Storage format
+   */
+  struct ConversionMatrix : public SimpleRefCount<ConversionMatrix>
+  {
+    std::vector<double> m_values; //!< non-zero conversion coefficients
+    std::vector<size_t> m_rowPtr; //!< end offset of each row in m_values
+    std::vector<size_t> m_colInd; //!< column of each element of m_values
+  };
+
+  /**
+   * Compute the conversion matrix between two SpectrumModel instances.
+   * When the bands of the SpectrumModel to convert from are sorted, only
+   * the overlapping bands are visited for each band of the SpectrumModel
+   * to convert to.
+   *
+   * @param fromSpectrumModel the SpectrumModel to convert from
+   * @param toSpectrumModel the SpectrumModel to convert to
+   *
+   * @return the conversion matrix
+   */
+  static Ptr<ConversionMatrix> ComputeConversionMatrix (Ptr<const SpectrumModel> fromSpectrumModel,
+                                                        Ptr<const SpectrumModel> toSpectrumModel);
+
+  Ptr<const ConversionMatrix> m_conversionMatrix; //!< matrix of conversion coefficients
 
   Ptr<const SpectrumModel> m_fromSpectrumModel;  //!<  the SpectrumModel this SpectrumConverter instance can convert from
   Ptr<const SpectrumModel> m_toSpectrumModel;    //!<  the SpectrumModel this SpectrumConverter instance can convert to
@@ -27,6 +27,7 @@
 #include "ns3/double.h"
 #include "ns3/string.h"
 #include "ns3/integer.h"
+#include "ns3/uinteger.h"
 #include <algorithm>
 #include <random>
 #include "ns3/log.h"
@@ -180,7 +181,7 @@ void
 ThreeGppChannelModel::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
-  m_channelMap.clear ();
+  m_channelCache.Clear ();
   if (m_channelConditionModel)
     {
       m_channelConditionModel->Dispose ();
@@ -240,6 +241,14 @@ ThreeGppChannelModel::GetTypeId (void)
                    DoubleValue (1),
                    MakeDoubleAccessor (&ThreeGppChannelModel::m_blockerSpeed),
                    MakeDoubleChecker<double> ())
+    .AddAttribute ("MaxCachedLinks",
+                   "The maximum number of links whose channel matrix is cached. "
+                   "When the limit is reached, the least recently used matrix is evicted. "
+                   "If set to 0, the number of cached links is not limited.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&ThreeGppChannelModel::SetMaxCachedLinks,
+                                         &ThreeGppChannelModel::GetMaxCachedLinks),
+                   MakeUintegerChecker<uint32_t> ())
   ;
   return tid;
 }
@@ -258,6 +267,25 @@ ThreeGppChannelModel::GetChannelConditionModel () const
   return m_channelConditionModel;
 }
 
+void
+ThreeGppChannelModel::SetMaxCachedLinks (uint32_t maxLinks)
+{
+  NS_LOG_FUNCTION (this << maxLinks);
+  m_channelCache.SetCapacity (maxLinks);
+}
+
+uint32_t
+ThreeGppChannelModel::GetMaxCachedLinks (void) const
+{
+  return m_channelCache.GetCapacity ();
+}
+
+LinkStateCacheStats
+ThreeGppChannelModel::GetCacheStats (void) const
+{
+  return m_channelCache.GetStats ();
+}
+
 void
 ThreeGppChannelModel::SetFrequency (double f)
 {
@@ -992,11 +1020,12 @@ ThreeGppChannelModel::GetChannel (Ptr<const MobilityModel> aMob,
   bool update = false;
   bool notFound = false;
   Ptr<ThreeGppChannelMatrix> channelMatrix;
-  if (m_channelMap.find (channelId) != m_channelMap.end ())
+  Ptr<ThreeGppChannelMatrix> *cachedMatrix = m_channelCache.Find (channelId);
+  if (cachedMatrix != nullptr)
     {
       // channel matrix present in the map
       NS_LOG_DEBUG ("channel matrix present in the map");
-      channelMatrix = m_channelMap[channelId];
+      channelMatrix = *cachedMatrix;
 
       // check if it has to be updated
       update = ChannelMatrixNeedsUpdate (channelMatrix, condition);
@@ -1034,7 +1063,7 @@ ThreeGppChannelModel::GetChannel (Ptr<const MobilityModel> aMob,
       channelMatrix->m_nodeIds = std::make_pair (aMob->GetObject<Node> ()->GetId (), bMob->GetObject<Node> ()->GetId ());
 
       // store or replace the channel matrix in the channel map
-      m_channelMap[channelId] = channelMatrix;
+      m_channelCache.Insert (channelId, channelMatrix);
     }
 
   return channelMatrix;
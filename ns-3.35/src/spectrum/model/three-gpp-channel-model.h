@@ -30,6 +30,7 @@
 #include <ns3/boolean.h>
 #include <unordered_map>
 #include <ns3/channel-condition-model.h>
+#include <ns3/link-state-cache.h>
 #include <ns3/matrix-based-channel-model.h>
 
 namespace ns3 {
@@ -104,10 +105,10 @@ public:
   std::string GetScenario (void) const;
 
   /**
-   * Looks for the channel matrix associated to the aMob and bMob pair in m_channelMap.
+   * Looks for the channel matrix associated to the aMob and bMob pair in m_channelCache.
    * If found, it checks if it has to be updated. If not found or if it has to
    * be updated, it generates a new uncorrelated channel matrix using the
-   * method GetNewChannel and updates m_channelMap.
+   * method GetNewChannel and updates m_channelCache.
    *
    * \param aMob mobility model of the a device
    * \param bMob mobility model of the b device
@@ -127,6 +128,28 @@ public:
    * \return the number of stream indices assigned by this model
    */
   int64_t AssignStreams (int64_t stream);
+
+  /**
+   * Set the maximum number of links whose channel matrix is cached. When
+   * the limit is reached, the least recently used matrix is evicted and,
+   * if the link is used again, a new channel matrix is generated for the
+   * current channel condition.
+   *
+   * \param maxLinks the maximum number of cached links, 0 for no limit
+   */
+  void SetMaxCachedLinks (uint32_t maxLinks);
+
+  /**
+   * Returns the maximum number of links whose channel matrix is cached
+   * \return the maximum number of cached links, 0 for no limit
+   */
+  uint32_t GetMaxCachedLinks (void) const;
+
+  /**
+   * Returns the usage counters of the cache of channel matrices
+   * \return the usage counters
+   */
+  LinkStateCacheStats GetCacheStats (void) const;
   
 private:
   /**
@@ -255,7 +278,7 @@ private:
    */
   bool ChannelMatrixNeedsUpdate (Ptr<const ThreeGppChannelMatrix> channelMatrix, Ptr<const ChannelCondition> channelCondition) const;
 
-  std::unordered_map<uint32_t, Ptr<ThreeGppChannelMatrix> > m_channelMap; //!< map containing the channel realizations
+  LinkStateCache<Ptr<ThreeGppChannelMatrix> > m_channelCache; //!< cache containing the channel realizations
   Time m_updatePeriod; //!< the channel update period
   double m_frequency; //!< the operating frequency
   std::string m_scenario; //!< the 3GPP scenario
@@ -58,6 +58,7 @@ WaveformGenerator::DoDispose (void)
   m_channel = 0;
   m_netDevice = 0;
   m_mobility = 0;
+  m_txParams = 0;
   if (m_nextWave.IsRunning ())
     {
       m_nextWave.Cancel ();
@@ -152,6 +153,7 @@ WaveformGenerator::SetTxPowerSpectralDensity (Ptr<SpectrumValue> txPsd)
 {
   NS_LOG_FUNCTION (this << *txPsd);
   m_txPowerSpectralDensity = txPsd;
+  m_txParams = 0;
 }
 
 Ptr<AntennaModel>
@@ -165,12 +167,14 @@ WaveformGenerator::SetAntenna (Ptr<AntennaModel> a)
 {
   NS_LOG_FUNCTION (this << a);
   m_antenna = a;
+  m_txParams = 0;
 }
 
 void
 WaveformGenerator::SetPeriod (Time period)
 {
   m_period = period;
+  m_txParams = 0;
 }
 
 Time
@@ -185,6 +189,7 @@ void
 WaveformGenerator::SetDutyCycle (double dutyCycle)
 {
   m_dutyCycle = dutyCycle;
+  m_txParams = 0;
 }
 
 double WaveformGenerator::GetDutyCycle () const
@@ -199,15 +204,20 @@ WaveformGenerator::GenerateWaveform ()
 {
   NS_LOG_FUNCTION (this);
 
-  Ptr<SpectrumSignalParameters> txParams = Create<SpectrumSignalParameters> ();
-  txParams->duration = Time (m_period.GetTimeStep () * m_dutyCycle);
-  txParams->psd = m_txPowerSpectralDensity;
-  txParams->txPhy = GetObject<SpectrumPhy> ();
-  txParams->txAntenna = m_antenna;
+  if (!m_txParams)
+    {
+      // the channels copy the parameters before handing them to the
+      // receivers, hence the same instance can be sent at every period
+      m_txParams = Create<SpectrumSignalParameters> ();
+      m_txParams->duration = Time (m_period.GetTimeStep () * m_dutyCycle);
+      m_txParams->psd = m_txPowerSpectralDensity;
+      m_txParams->txPhy = GetObject<SpectrumPhy> ();
+      m_txParams->txAntenna = m_antenna;
+    }
 
   NS_LOG_LOGIC ("generating waveform : " << *m_txPowerSpectralDensity);
   m_phyTxStartTrace (0);
-  m_channel->StartTx (txParams);
+  m_channel->StartTx (m_txParams);
 
   NS_LOG_LOGIC ("scheduling next waveform");
   m_nextWave = Simulator::Schedule (m_period, &WaveformGenerator::GenerateWaveform, this);
@@ -148,6 +148,7 @@ private:
   double m_dutyCycle; //!< Duty Cycle (should be in [0,1])
   Time m_startTime;   //!< Start time
   EventId m_nextWave; //!< Next waveform generation event
+  Ptr<SpectrumSignalParameters> m_txParams; //!< Parameters sent at every period, rebuilt upon configuration changes
 
   TracedCallback<Ptr<const Packet> > m_phyTxStartTrace; //!< TracedCallback: Tx start
   TracedCallback<Ptr<const Packet> > m_phyTxEndTrace;   //!< TracedCallback: Tx end
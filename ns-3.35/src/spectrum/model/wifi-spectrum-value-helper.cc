@@ -24,10 +24,12 @@
 
 #include <map>
 #include <cmath>
+#include <tuple>
 #include "wifi-spectrum-value-helper.h"
 #include "ns3/log.h"
 #include "ns3/fatal-error.h"
 #include "ns3/assert.h"
+#include "ns3/simulator.h"
 
 namespace ns3 {
 
@@ -131,9 +133,189 @@ WifiSpectrumValueHelper::GetSpectrumModel (uint32_t centerFrequency, uint16_t ch
   return ret;
 }
 
-// Power allocated to 71 center subbands out of 135 total subbands in the band
+/// Wifi power spectral density identifier
+struct WifiSpectrumPsdId
+{
+  /// The function creating the power spectral density
+  enum Type
+  {
+    DSSS,
+    OFDM,
+    HT_OFDM,
+    HE_OFDM,
+    HE_MU_OFDM,
+    RF_FILTER
+  };
+  /**
+   * Constructor
+   * \param t the function creating the power spectral density
+   * \param f the center frequency (in MHz)
+   * \param w the channel width (in MHz)
+   * \param g the guard band width (in MHz)
+   * \param p the transmit power (in W), or 1 for RF filters
+   */
+  WifiSpectrumPsdId (Type t, uint32_t f, uint16_t w, uint16_t g, double p);
+  Type m_type;                  ///< function creating the power spectral density
+  uint32_t m_centerFrequency;   ///< center frequency (in MHz)
+  uint16_t m_channelWidth;      ///< channel width (in MHz)
+  uint16_t m_guardBandwidth;    ///< guard band width (in MHz)
+  uint32_t m_bandBandwidth;     ///< width of each band (in Hz), for RF filters
+  double m_minInnerBandDbr;     ///< minimum relative power in the inner band (in dBr)
+  double m_minOuterBandDbr;     ///< minimum relative power in the outer band (in dBr)
+  double m_lowestPointDbr;      ///< relative power of the outermost subcarriers (in dBr)
+  WifiSpectrumBand m_band;      ///< RU or filtered band
+  double m_txPowerW;            ///< transmit power (in W)
+};
+
+WifiSpectrumPsdId::WifiSpectrumPsdId (Type t, uint32_t f, uint16_t w, uint16_t g, double p)
+  : m_type (t),
+    m_centerFrequency (f),
+    m_channelWidth (w),
+    m_guardBandwidth (g),
+    m_bandBandwidth (0),
+    m_minInnerBandDbr (0),
+    m_minOuterBandDbr (0),
+    m_lowestPointDbr (0),
+    m_band (0, 0),
+    m_txPowerW (p)
+{
+}
+
+/**
+ * Less than operator
+ * \param a the first identifier to compare
+ * \param b the second identifier to compare
+ * \returns true if the first identifier is less than the second identifier
+ */
+bool
+operator < (const WifiSpectrumPsdId& a, const WifiSpectrumPsdId& b)
+{
+  return std::tie (a.m_type, a.m_centerFrequency, a.m_channelWidth, a.m_guardBandwidth, a.m_bandBandwidth,
+                   a.m_minInnerBandDbr, a.m_minOuterBandDbr, a.m_lowestPointDbr, a.m_band, a.m_txPowerW)
+         < std::tie (b.m_type, b.m_centerFrequency, b.m_channelWidth, b.m_guardBandwidth, b.m_bandBandwidth,
+                     b.m_minInnerBandDbr, b.m_minOuterBandDbr, b.m_lowestPointDbr, b.m_band, b.m_txPowerW);
+}
+
+/// power spectral densities created during the current simulation
+static std::map<WifiSpectrumPsdId, Ptr<const SpectrumValue> > g_wifiSpectrumPsdMap;
+
+/// maximum number of power spectral densities kept in g_wifiSpectrumPsdMap
+static const std::size_t g_wifiSpectrumPsdMapMaxSize = 1024;
+
+/**
+ * Clear the power spectral densities of the simulation, on Simulator::Destroy
+ */
+static void
+ClearWifiSpectrumPsdMap (void)
+{
+  g_wifiSpectrumPsdMap.clear ();
+}
+
+/**
+ * Create a power spectral density from a copy of the one created with the
+ * same parameters, creating it on first use.  The cached power spectral
+ * densities are cleared by Simulator::Destroy, or when the map is full.
+ *
+ * \param id the power spectral density identifier
+ * \param create the function creating the power spectral density
+ * \return a pointer to a newly allocated SpectrumValue
+ */
+template <typename F>
+static Ptr<SpectrumValue>
+CreateFromCache (const WifiSpectrumPsdId &id, F create)
+{
+  std::map<WifiSpectrumPsdId, Ptr<const SpectrumValue> >::iterator it = g_wifiSpectrumPsdMap.find (id);
+  if (it == g_wifiSpectrumPsdMap.end ())
+    {
+      if (g_wifiSpectrumPsdMap.empty ())
+        {
+          Simulator::ScheduleDestroy (&ClearWifiSpectrumPsdMap);
+        }
+      else if (g_wifiSpectrumPsdMap.size () >= g_wifiSpectrumPsdMapMaxSize)
+        {
+          // e.g., continuous transmit power control; start over
+          g_wifiSpectrumPsdMap.clear ();
+        }
+      it = g_wifiSpectrumPsdMap.insert (std::make_pair (id, create ())).first;
+    }
+  return it->second->Copy ();
+}
+
 Ptr<SpectrumValue>
 WifiSpectrumValueHelper::CreateDsssTxPowerSpectralDensity (uint32_t centerFrequency, double txPowerW, uint16_t guardBandwidth)
+{
+  NS_LOG_FUNCTION (centerFrequency << txPowerW << +guardBandwidth);
+  WifiSpectrumPsdId id (WifiSpectrumPsdId::DSSS, centerFrequency, 22, guardBandwidth, txPowerW);
+  return CreateFromCache (id, [=] ()
+                          { return DoCreateDsssTxPowerSpectralDensity (centerFrequency, txPowerW, guardBandwidth); });
+}
+
+Ptr<SpectrumValue>
+WifiSpectrumValueHelper::CreateOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth,
+                                                           double minInnerBandDbr, double minOuterBandDbr, double lowestPointDbr)
+{
+  NS_LOG_FUNCTION (centerFrequency << channelWidth << txPowerW << guardBandwidth << minInnerBandDbr << minOuterBandDbr << lowestPointDbr);
+  WifiSpectrumPsdId id (WifiSpectrumPsdId::OFDM, centerFrequency, channelWidth, guardBandwidth, txPowerW);
+  id.m_minInnerBandDbr = minInnerBandDbr;
+  id.m_minOuterBandDbr = minOuterBandDbr;
+  id.m_lowestPointDbr = lowestPointDbr;
+  return CreateFromCache (id, [=] ()
+                          { return DoCreateOfdmTxPowerSpectralDensity (centerFrequency, channelWidth, txPowerW, guardBandwidth,
+                                                                       minInnerBandDbr, minOuterBandDbr, lowestPointDbr); });
+}
+
+Ptr<SpectrumValue>
+WifiSpectrumValueHelper::CreateHtOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth,
+                                                             double minInnerBandDbr, double minOuterBandDbr, double lowestPointDbr)
+{
+  NS_LOG_FUNCTION (centerFrequency << channelWidth << txPowerW << guardBandwidth << minInnerBandDbr << minOuterBandDbr << lowestPointDbr);
+  WifiSpectrumPsdId id (WifiSpectrumPsdId::HT_OFDM, centerFrequency, channelWidth, guardBandwidth, txPowerW);
+  id.m_minInnerBandDbr = minInnerBandDbr;
+  id.m_minOuterBandDbr = minOuterBandDbr;
+  id.m_lowestPointDbr = lowestPointDbr;
+  return CreateFromCache (id, [=] ()
+                          { return DoCreateHtOfdmTxPowerSpectralDensity (centerFrequency, channelWidth, txPowerW, guardBandwidth,
+                                                                         minInnerBandDbr, minOuterBandDbr, lowestPointDbr); });
+}
+
+Ptr<SpectrumValue>
+WifiSpectrumValueHelper::CreateHeOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth,
+                                                             double minInnerBandDbr, double minOuterBandDbr, double lowestPointDbr)
+{
+  NS_LOG_FUNCTION (centerFrequency << channelWidth << txPowerW << guardBandwidth << minInnerBandDbr << minOuterBandDbr << lowestPointDbr);
+  WifiSpectrumPsdId id (WifiSpectrumPsdId::HE_OFDM, centerFrequency, channelWidth, guardBandwidth, txPowerW);
+  id.m_minInnerBandDbr = minInnerBandDbr;
+  id.m_minOuterBandDbr = minOuterBandDbr;
+  id.m_lowestPointDbr = lowestPointDbr;
+  return CreateFromCache (id, [=] ()
+                          { return DoCreateHeOfdmTxPowerSpectralDensity (centerFrequency, channelWidth, txPowerW, guardBandwidth,
+                                                                         minInnerBandDbr, minOuterBandDbr, lowestPointDbr); });
+}
+
+Ptr<SpectrumValue>
+WifiSpectrumValueHelper::CreateHeMuOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth, WifiSpectrumBand ru)
+{
+  NS_LOG_FUNCTION (centerFrequency << channelWidth << txPowerW << guardBandwidth << ru.first << ru.second);
+  WifiSpectrumPsdId id (WifiSpectrumPsdId::HE_MU_OFDM, centerFrequency, channelWidth, guardBandwidth, txPowerW);
+  id.m_band = ru;
+  return CreateFromCache (id, [=] ()
+                          { return DoCreateHeMuOfdmTxPowerSpectralDensity (centerFrequency, channelWidth, txPowerW, guardBandwidth, ru); });
+}
+
+Ptr<SpectrumValue>
+WifiSpectrumValueHelper::CreateRfFilter (uint32_t centerFrequency, uint16_t totalChannelWidth, uint32_t bandBandwidth, uint16_t guardBandwidth, WifiSpectrumBand band)
+{
+  NS_LOG_FUNCTION (centerFrequency << totalChannelWidth << bandBandwidth << guardBandwidth << band.first << band.second);
+  WifiSpectrumPsdId id (WifiSpectrumPsdId::RF_FILTER, centerFrequency, totalChannelWidth, guardBandwidth, 1);
+  id.m_bandBandwidth = bandBandwidth;
+  id.m_band = band;
+  return CreateFromCache (id, [=] ()
+                          { return DoCreateRfFilter (centerFrequency, totalChannelWidth, bandBandwidth, guardBandwidth, band); });
+}
+
+// Power allocated to 71 center subbands out of 135 total subbands in the band
+Ptr<SpectrumValue>
+WifiSpectrumValueHelper::DoCreateDsssTxPowerSpectralDensity (uint32_t centerFrequency, double txPowerW, uint16_t guardBandwidth)
 {
   NS_LOG_FUNCTION (centerFrequency << txPowerW << +guardBandwidth);
   uint16_t channelWidth = 22;  // DSSS channels are 22 MHz wide
@@ -157,7 +339,7 @@ WifiSpectrumValueHelper::CreateDsssTxPowerSpectralDensity (uint32_t centerFreque
 }
 
 Ptr<SpectrumValue>
-WifiSpectrumValueHelper::CreateOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth,
+WifiSpectrumValueHelper::DoCreateOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth,
                                                            double minInnerBandDbr, double minOuterBandDbr, double lowestPointDbr)
 {
   NS_LOG_FUNCTION (centerFrequency << channelWidth << txPowerW << guardBandwidth << minInnerBandDbr << minOuterBandDbr << lowestPointDbr);
@@ -212,7 +394,7 @@ WifiSpectrumValueHelper::CreateOfdmTxPowerSpectralDensity (uint32_t centerFreque
 }
 
 Ptr<SpectrumValue>
-WifiSpectrumValueHelper::CreateHtOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth,
+WifiSpectrumValueHelper::DoCreateHtOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth,
                                                              double minInnerBandDbr, double minOuterBandDbr, double lowestPointDbr)
 {
   NS_LOG_FUNCTION (centerFrequency << channelWidth << txPowerW << guardBandwidth << minInnerBandDbr << minOuterBandDbr << lowestPointDbr);
@@ -326,7 +508,7 @@ WifiSpectrumValueHelper::CreateHtOfdmTxPowerSpectralDensity (uint32_t centerFreq
 }
 
 Ptr<SpectrumValue>
-WifiSpectrumValueHelper::CreateHeOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth,
+WifiSpectrumValueHelper::DoCreateHeOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth,
                                                              double minInnerBandDbr, double minOuterBandDbr, double lowestPointDbr)
 {
   NS_LOG_FUNCTION (centerFrequency << channelWidth << txPowerW << guardBandwidth << minInnerBandDbr << minOuterBandDbr << lowestPointDbr);
@@ -422,7 +604,7 @@ WifiSpectrumValueHelper::CreateHeOfdmTxPowerSpectralDensity (uint32_t centerFreq
 }
 
 Ptr<SpectrumValue>
-WifiSpectrumValueHelper::CreateHeMuOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth, WifiSpectrumBand ru)
+WifiSpectrumValueHelper::DoCreateHeMuOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth, WifiSpectrumBand ru)
 {
   NS_LOG_FUNCTION (centerFrequency << channelWidth << txPowerW << guardBandwidth << ru.first << ru.second);
   uint32_t bandBandwidth = 78125;
@@ -474,7 +656,7 @@ WifiSpectrumValueHelper::CreateNoisePowerSpectralDensity (double noiseFigureDb,
 }
 
 Ptr<SpectrumValue>
-WifiSpectrumValueHelper::CreateRfFilter (uint32_t centerFrequency, uint16_t totalChannelWidth, uint32_t bandBandwidth, uint16_t guardBandwidth, WifiSpectrumBand band)
+WifiSpectrumValueHelper::DoCreateRfFilter (uint32_t centerFrequency, uint16_t totalChannelWidth, uint32_t bandBandwidth, uint16_t guardBandwidth, WifiSpectrumBand band)
 {
   uint32_t startIndex = band.first;
   uint32_t stopIndex = band.second;
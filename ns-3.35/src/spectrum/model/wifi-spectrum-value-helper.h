@@ -26,6 +26,8 @@
 
 #include <ns3/spectrum-value.h>
 
+class WifiSpectrumPsdCacheTestCase; // Forward declaration for unit test
+
 namespace ns3 {
 
 /**
@@ -39,6 +41,12 @@ typedef std::pair<uint32_t, uint32_t> WifiSpectrumBand;
  *  This class defines all functions to create a spectrum model for
  *  Wi-Fi based on a a spectral model aligned with an OFDM subcarrier
  *  spacing of 312.5 KHz (model also reused for DSSS modulations)
+ *
+ *  The transmit power spectral densities and the RF filters are built
+ *  once per set of parameters (including the transmit power) during a
+ *  simulation, and each call returns a copy of the cached one.  The cache
+ *  is cleared by Simulator::Destroy; like the rest of the simulation, it
+ *  must only be used from the simulation thread.
  */
 class WifiSpectrumValueHelper
 {
@@ -249,6 +257,83 @@ public:
    * \return band power in W
    */
   static double GetBandPowerW (Ptr<SpectrumValue> psd, const WifiSpectrumBand &band);
+
+private:
+  friend class ::WifiSpectrumPsdCacheTestCase;
+
+  /**
+   * Build the power spectral density returned by CreateDsssTxPowerSpectralDensity
+   *
+   * \param centerFrequency center frequency (MHz)
+   * \param txPowerW  transmit power (W) to allocate
+   * \param guardBandwidth width of the guard band (MHz)
+   * \returns a pointer to a newly allocated SpectrumValue representing the DSSS Transmit Power Spectral Density in W/Hz
+   */
+  static Ptr<SpectrumValue> DoCreateDsssTxPowerSpectralDensity (uint32_t centerFrequency, double txPowerW, uint16_t guardBandwidth);
+  /**
+   * Build the power spectral density returned by CreateOfdmTxPowerSpectralDensity
+   *
+   * \param centerFrequency center frequency (MHz)
+   * \param channelWidth channel width (MHz)
+   * \param txPowerW  transmit power (W) to allocate
+   * \param guardBandwidth width of the guard band (MHz)
+   * \param minInnerBandDbr the minimum relative power in the inner band (in dBr)
+   * \param minOuterbandDbr the minimum relative power in the outer band (in dBr)
+   * \param lowestPointDbr maximum relative power of the outermost subcarriers of the guard band (in dBr)
+   * \return a pointer to a newly allocated SpectrumValue representing the OFDM Transmit Power Spectral Density in W/Hz for each Band
+   */
+  static Ptr<SpectrumValue> DoCreateOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth,
+                                                                double minInnerBandDbr, double minOuterbandDbr, double lowestPointDbr);
+  /**
+   * Build the power spectral density returned by CreateHtOfdmTxPowerSpectralDensity
+   *
+   * \param centerFrequency center frequency (MHz)
+   * \param channelWidth channel width (MHz)
+   * \param txPowerW  transmit power (W) to allocate
+   * \param guardBandwidth width of the guard band (MHz)
+   * \param minInnerBandDbr the minimum relative power in the inner band (in dBr)
+   * \param minOuterbandDbr the minimum relative power in the outer band (in dBr)
+   * \param lowestPointDbr maximum relative power of the outermost subcarriers of the guard band (in dBr)
+   * \return a pointer to a newly allocated SpectrumValue representing the HT OFDM Transmit Power Spectral Density in W/Hz for each Band
+   */
+  static Ptr<SpectrumValue> DoCreateHtOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth,
+                                                                  double minInnerBandDbr, double minOuterbandDbr, double lowestPointDbr);
+  /**
+   * Build the power spectral density returned by CreateHeOfdmTxPowerSpectralDensity
+   *
+   * \param centerFrequency center frequency (MHz)
+   * \param channelWidth channel width (MHz)
+   * \param txPowerW  transmit power (W) to allocate
+   * \param guardBandwidth width of the guard band (MHz)
+   * \param minInnerBandDbr the minimum relative power in the inner band (in dBr)
+   * \param minOuterbandDbr the minimum relative power in the outer band (in dBr)
+   * \param lowestPointDbr maximum relative power of the outermost subcarriers of the guard band (in dBr)
+   * \return a pointer to a newly allocated SpectrumValue representing the HE OFDM Transmit Power Spectral Density in W/Hz for each Band
+   */
+  static Ptr<SpectrumValue> DoCreateHeOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth,
+                                                                  double minInnerBandDbr, double minOuterbandDbr, double lowestPointDbr);
+  /**
+   * Build the power spectral density returned by CreateHeMuOfdmTxPowerSpectralDensity
+   *
+   * \param centerFrequency center frequency (MHz)
+   * \param channelWidth channel width (MHz)
+   * \param txPowerW  transmit power (W) to allocate
+   * \param guardBandwidth width of the guard band (MHz)
+   * \param ru the RU band used by the STA
+   * \return a pointer to a newly allocated SpectrumValue representing the HE OFDM Transmit Power Spectral Density on the RU used by the STA in W/Hz for each Band
+   */
+  static Ptr<SpectrumValue> DoCreateHeMuOfdmTxPowerSpectralDensity (uint32_t centerFrequency, uint16_t channelWidth, double txPowerW, uint16_t guardBandwidth, WifiSpectrumBand ru);
+  /**
+   * Build the spectral density returned by CreateRfFilter
+   *
+   * \param centerFrequency the center frequency (MHz)
+   * \param totalChannelWidth the total channel width (MHz)
+   * \param bandBandwidth the width of each band (MHz)
+   * \param guardBandwidth the width of the guard band (MHz)
+   * \param band the pair of start and stop indexes that defines the band to be filtered
+   * \return a pointer to a SpectrumValue representing the RF filter
+   */
+  static Ptr<SpectrumValue> DoCreateRfFilter (uint32_t centerFrequency, uint16_t totalChannelWidth, uint32_t bandBandwidth, uint16_t guardBandwidth, WifiSpectrumBand band);
 };
 
 /**
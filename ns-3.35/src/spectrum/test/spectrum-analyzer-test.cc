@@ -0,0 +1,251 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/core-module.h>
+#include <ns3/test.h>
+#include <ns3/spectrum-module.h>
+#include <ns3/mobility-module.h>
+#include <fstream>
+#include <map>
+
+
+NS_LOG_COMPONENT_DEFINE ("SpectrumAnalyzerTest");
+
+using namespace ns3;
+
+
+/**
+ * \ingroup spectrum-test
+ *
+ * Set up a waveform generator and a spectrum analyzer on the same channel
+ * and collect the timed reports of the analyzer.
+ */
+class SpectrumAnalyzerTestBase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param name the test case name
+   */
+  SpectrumAnalyzerTestBase (std::string name);
+
+protected:
+  /**
+   * Run a simulation in which the analyzer starts at 0 ms, the waveform
+   * generator starts at 1 ms and the analyzer is stopped at 101 ms.
+   * \param period the period of the waveform generator
+   * \param dutyCycle the duty cycle of the waveform generator
+   * \param lazy the value of the LazyReports attribute of the analyzer
+   * \param threshold the value of the ReportChangeThreshold attribute
+   * \param spectrogram the file where the spectrogram is written, if not empty
+   * \return the reports sorted by the end time of their interval
+   */
+  std::map<Time, Ptr<const SpectrumValue> > RunScenario (Time period, double dutyCycle,
+                                                          bool lazy, double threshold,
+                                                          std::string spectrogram = "");
+
+private:
+  /**
+   * Timed report callback
+   * \param time the end of the averaging interval
+   * \param psd the average power spectral density
+   */
+  void Report (Time time, Ptr<const SpectrumValue> psd);
+
+  std::map<Time, Ptr<const SpectrumValue> > m_reports; //!< received reports
+};
+
+SpectrumAnalyzerTestBase::SpectrumAnalyzerTestBase (std::string name)
+  : TestCase (name)
+{
+}
+
+void
+SpectrumAnalyzerTestBase::Report (Time time, Ptr<const SpectrumValue> psd)
+{
+  m_reports[time] = psd->Copy ();
+}
+
+std::map<Time, Ptr<const SpectrumValue> >
+SpectrumAnalyzerTestBase::RunScenario (Time period, double dutyCycle, bool lazy, double threshold,
+                                       std::string spectrogram)
+{
+  m_reports.clear ();
+
+  Ptr<SpectrumValue> txPsd = MicrowaveOvenSpectrumValueHelper::CreatePowerSpectralDensityMwo1 ();
+
+  SpectrumChannelHelper channelHelper = SpectrumChannelHelper::Default ();
+  channelHelper.SetChannel ("ns3::SingleModelSpectrumChannel");
+  Ptr<SpectrumChannel> channel = channelHelper.Create ();
+
+  NodeContainer nodes;
+  nodes.Create (2);
+  MobilityHelper mobility;
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0.0, 0.0, 0.0));
+  positionAlloc->Add (Vector (5.0, 0.0, 0.0));
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+
+  WaveformGeneratorHelper waveformGeneratorHelper;
+  waveformGeneratorHelper.SetTxPowerSpectralDensity (txPsd);
+  waveformGeneratorHelper.SetChannel (channel);
+  waveformGeneratorHelper.SetPhyAttribute ("Period", TimeValue (period));
+  waveformGeneratorHelper.SetPhyAttribute ("DutyCycle", DoubleValue (dutyCycle));
+  NetDeviceContainer waveformGeneratorDevices = waveformGeneratorHelper.Install (nodes.Get (0));
+  Ptr<WaveformGenerator> wave = waveformGeneratorDevices.Get (0)->GetObject<NonCommunicatingNetDevice> ()->GetPhy ()->GetObject<WaveformGenerator> ();
+
+  SpectrumAnalyzerHelper spectrumAnalyzerHelper;
+  spectrumAnalyzerHelper.SetChannel (channel);
+  spectrumAnalyzerHelper.SetRxSpectrumModel (ConstCast<SpectrumModel> (txPsd->GetSpectrumModel ()));
+  spectrumAnalyzerHelper.SetPhyAttribute ("Resolution", TimeValue (MilliSeconds (2)));
+  spectrumAnalyzerHelper.SetPhyAttribute ("LazyReports", BooleanValue (lazy));
+  spectrumAnalyzerHelper.SetPhyAttribute ("ReportChangeThreshold", DoubleValue (threshold));
+  spectrumAnalyzerHelper.SetPhyAttribute ("RecordSpectrogram", BooleanValue (!spectrogram.empty ()));
+  NetDeviceContainer spectrumAnalyzerDevices = spectrumAnalyzerHelper.Install (nodes.Get (1));
+  Ptr<SpectrumAnalyzer> analyzer = spectrumAnalyzerDevices.Get (0)->GetObject<NonCommunicatingNetDevice> ()->GetPhy ()->GetObject<SpectrumAnalyzer> ();
+
+  analyzer->TraceConnectWithoutContext ("TimedAveragePowerSpectralDensityReport",
+                                        MakeCallback (&SpectrumAnalyzerTestBase::Report, this));
+
+  analyzer->Start ();
+  Simulator::Schedule (MilliSeconds (1), &WaveformGenerator::Start, wave);
+  Simulator::Schedule (MilliSeconds (101), &SpectrumAnalyzer::Stop, analyzer);
+  Simulator::Stop (MilliSeconds (110));
+  Simulator::Run ();
+
+  if (!spectrogram.empty ())
+    {
+      analyzer->WriteSpectrogram (spectrogram);
+    }
+
+  Simulator::Destroy ();
+  return m_reports;
+}
+
+
+/**
+ * \ingroup spectrum-test
+ *
+ * Check that the reports generated on demand by a lazy analyzer are
+ * the same as the periodic ones.
+ */
+class SpectrumAnalyzerLazyReportsTestCase : public SpectrumAnalyzerTestBase
+{
+public:
+  SpectrumAnalyzerLazyReportsTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+SpectrumAnalyzerLazyReportsTestCase::SpectrumAnalyzerLazyReportsTestCase ()
+  : SpectrumAnalyzerTestBase ("Check that lazy reports match periodic reports")
+{
+}
+
+void
+SpectrumAnalyzerLazyReportsTestCase::DoRun (void)
+{
+  // the period of the generator is not aligned with the analyzer resolution
+  std::map<Time, Ptr<const SpectrumValue> > periodic = RunScenario (MicroSeconds (2700), 0.3, false, 0);
+  std::map<Time, Ptr<const SpectrumValue> > lazy = RunScenario (MicroSeconds (2700), 0.3, true, 0);
+
+  // the periodic analyzer generates one more report after being stopped
+  NS_TEST_ASSERT_MSG_EQ (lazy.size (), 50, "Unexpected number of lazy reports");
+  NS_TEST_ASSERT_MSG_EQ (periodic.size (), 51, "Unexpected number of periodic reports");
+  for (std::map<Time, Ptr<const SpectrumValue> >::const_iterator it = lazy.begin (); it != lazy.end (); ++it)
+    {
+      std::map<Time, Ptr<const SpectrumValue> >::const_iterator periodicIt = periodic.find (it->first);
+      NS_TEST_ASSERT_MSG_EQ ((periodicIt != periodic.end ()), true, "No periodic report at " << it->first);
+      double norm = Norm (*periodicIt->second);
+      NS_TEST_ASSERT_MSG_EQ_TOL (Norm (*it->second - *periodicIt->second) / norm, 0, 1e-9,
+                                 "Lazy report differs from periodic report at " << it->first);
+    }
+}
+
+
+/**
+ * \ingroup spectrum-test
+ *
+ * Check that reports are suppressed when they do not differ from the
+ * last emitted one, and that the spectrogram contains the emitted reports.
+ */
+class SpectrumAnalyzerChangeThresholdTestCase : public SpectrumAnalyzerTestBase
+{
+public:
+  SpectrumAnalyzerChangeThresholdTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+SpectrumAnalyzerChangeThresholdTestCase::SpectrumAnalyzerChangeThresholdTestCase ()
+  : SpectrumAnalyzerTestBase ("Check report change threshold and spectrogram export")
+{
+}
+
+void
+SpectrumAnalyzerChangeThresholdTestCase::DoRun (void)
+{
+  // every averaging interval contains exactly one millisecond of signal
+  std::string filename = CreateTempDirFilename ("spectrogram.bin");
+  std::map<Time, Ptr<const SpectrumValue> > all = RunScenario (MilliSeconds (2), 0.5, true, 0, filename);
+  NS_TEST_ASSERT_MSG_EQ (all.size (), 50, "Unexpected number of reports without threshold");
+
+  uint32_t numBands = all.begin ()->second->GetSpectrumModel ()->GetNumBands ();
+  std::ifstream is (filename.c_str (), std::ios::in | std::ios::binary);
+  NS_TEST_ASSERT_MSG_EQ (is.good (), true, "Can't open " << filename);
+  char magic[4];
+  uint32_t header[3];
+  is.read (magic, 4);
+  is.read (reinterpret_cast<char *> (header), sizeof (header));
+  NS_TEST_ASSERT_MSG_EQ (std::string (magic, 4), "SPGM", "Wrong spectrogram magic");
+  NS_TEST_ASSERT_MSG_EQ (header[0], 1, "Wrong spectrogram version");
+  NS_TEST_ASSERT_MSG_EQ (header[1], numBands, "Wrong number of bands");
+  NS_TEST_ASSERT_MSG_EQ (header[2], 50, "Wrong number of reports");
+  is.seekg (0, std::ios::end);
+  std::streamoff expectedSize = 16 + numBands * sizeof (double) + 50 * (sizeof (int64_t) + numBands * sizeof (float));
+  NS_TEST_ASSERT_MSG_EQ (is.tellg (), expectedSize, "Wrong spectrogram file size");
+
+  std::map<Time, Ptr<const SpectrumValue> > changed = RunScenario (MilliSeconds (2), 0.5, true, 0.01);
+  NS_TEST_ASSERT_MSG_EQ (changed.size (), 1, "Identical reports should have been suppressed");
+  NS_TEST_ASSERT_MSG_EQ (changed.begin ()->first, MilliSeconds (2), "Unexpected time of the first report");
+}
+
+
+/**
+ * \ingroup spectrum-test
+ *
+ * Spectrum analyzer test suite
+ */
+class SpectrumAnalyzerTestSuite : public TestSuite
+{
+public:
+  SpectrumAnalyzerTestSuite ();
+};
+
+SpectrumAnalyzerTestSuite::SpectrumAnalyzerTestSuite ()
+  : TestSuite ("spectrum-analyzer", SYSTEM)
+{
+  NS_LOG_INFO ("creating SpectrumAnalyzerTestSuite");
+
+  AddTestCase (new SpectrumAnalyzerLazyReportsTestCase, TestCase::QUICK);
+  AddTestCase (new SpectrumAnalyzerChangeThresholdTestCase, TestCase::QUICK);
+}
+
+static SpectrumAnalyzerTestSuite g_spectrumAnalyzerTestSuite; ///< the test suite
@@ -328,7 +328,62 @@ SpectrumConverterTestSuite::SpectrumConverterTestSuite ()
 //   NS_LOG_LOGIC(*res);
   AddTestCase (new SpectrumValueTestCase (t21b, *res, ""), TestCase::QUICK);
 
+  // models with non-aligned bands (OFDM subcarriers vs resource blocks),
+  // including one whose bands are not sorted, checked against a dense
+  // computation of the conversion coefficients
+  Bands subcarriers;
+  for (int i = 0; i < 64; ++i)
+    {
+      BandInfo bi;
+      bi.fl = 2400e6 + i * 312.5e3;
+      bi.fh = bi.fl + 312.5e3;
+      bi.fc = (bi.fl + bi.fh) / 2;
+      subcarriers.push_back (bi);
+    }
+  Bands resourceBlocks;
+  for (int i = 0; i < 100; ++i)
+    {
+      BandInfo bi;
+      bi.fl = 2395e6 + i * 180e3;
+      bi.fh = bi.fl + 180e3;
+      bi.fc = (bi.fl + bi.fh) / 2;
+      resourceBlocks.push_back (bi);
+    }
+  Bands reversedResourceBlocks (resourceBlocks.rbegin (), resourceBlocks.rend ());
+  std::vector<Ptr<SpectrumModel> > models;
+  models.push_back (Create<SpectrumModel> (subcarriers));
+  models.push_back (Create<SpectrumModel> (resourceBlocks));
+  models.push_back (Create<SpectrumModel> (reversedResourceBlocks));
 
+  for (std::size_t from = 0; from < models.size (); ++from)
+    {
+      for (std::size_t to = 0; to < models.size (); ++to)
+        {
+          if (from == to)
+            {
+              continue;
+            }
+          Ptr<SpectrumValue> v = Create<SpectrumValue> (models[from]);
+          for (std::size_t i = 0; i < v->GetValuesN (); ++i)
+            {
+              (*v)[i] = 1 + i % 7;
+            }
+          SpectrumValue expected (models[to]);
+          std::size_t j = 0;
+          for (Bands::const_iterator toit = models[to]->Begin (); toit != models[to]->End (); ++toit, ++j)
+            {
+              std::size_t i = 0;
+              for (Bands::const_iterator fromit = models[from]->Begin (); fromit != models[from]->End (); ++fromit, ++i)
+                {
+                  double overlap = std::max (0.0, std::min (fromit->fh, toit->fh) - std::max (fromit->fl, toit->fl));
+                  expected[j] += (*v)[i] * std::min (1.0, overlap / (toit->fh - toit->fl));
+                }
+            }
+          SpectrumConverter c (models[from], models[to]);
+          Ptr<SpectrumValue> converted = c.Convert (v);
+          AddTestCase (new SpectrumValueTestCase (expected, *converted, ""), TestCase::QUICK);
+        }
+    }
 }
 
 
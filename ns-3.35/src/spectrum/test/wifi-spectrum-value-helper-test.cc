@@ -0,0 +1,149 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <functional>
+#include <ns3/test.h>
+#include <ns3/simulator.h>
+#include <ns3/wifi-spectrum-value-helper.h>
+
+using namespace ns3;
+
+/**
+ * \ingroup spectrum-test
+ * \ingroup tests
+ *
+ * \brief The power spectral densities returned by WifiSpectrumValueHelper,
+ * whether just created or copied from its cache, must be exactly equal to
+ * the ones built from scratch, for every transmit power
+ */
+class WifiSpectrumPsdCacheTestCase : public TestCase
+{
+public:
+  WifiSpectrumPsdCacheTestCase ();
+  virtual ~WifiSpectrumPsdCacheTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /// Function creating a power spectral density for a transmit power (W)
+  typedef std::function<Ptr<SpectrumValue> (double)> CreatePsd;
+
+  /**
+   * Compare the power spectral densities returned by the helper with the
+   * ones built from scratch, for several transmit powers
+   * \param name the name of the power spectral density
+   * \param create the function of the helper, which uses the cache
+   * \param build the function building the power spectral density
+   */
+  void Check (std::string name, CreatePsd create, CreatePsd build);
+};
+
+WifiSpectrumPsdCacheTestCase::WifiSpectrumPsdCacheTestCase ()
+  : TestCase ("Cached Wi-Fi power spectral densities")
+{
+}
+
+WifiSpectrumPsdCacheTestCase::~WifiSpectrumPsdCacheTestCase ()
+{
+}
+
+void
+WifiSpectrumPsdCacheTestCase::Check (std::string name, CreatePsd create, CreatePsd build)
+{
+  // powers which are not exactly representable, each one twice, so that
+  // both the creation and the copy of the cached value are checked
+  const double powers[] = { 0.01, 0.0316, 0.1, 0.0316, 0.01, 0.1, 0.2 };
+  for (double txPowerW : powers)
+    {
+      Ptr<SpectrumValue> psd = create (txPowerW);
+      Ptr<SpectrumValue> expected = build (txPowerW);
+      NS_TEST_ASSERT_MSG_EQ (psd->GetSpectrumModelUid (), expected->GetSpectrumModelUid (),
+                             name << ": different spectrum model");
+      for (std::size_t i = 0; i < expected->GetValuesN (); ++i)
+        {
+          NS_TEST_ASSERT_MSG_EQ ((*psd)[i], (*expected)[i],
+                                 name << ": different value at " << txPowerW << " W, band " << i);
+        }
+    }
+
+  // the values returned are copies, which callers may modify
+  *create (powers[0]) *= 2;
+  Ptr<SpectrumValue> psd = create (powers[0]);
+  Ptr<SpectrumValue> expected = build (powers[0]);
+  for (std::size_t i = 0; i < expected->GetValuesN (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ ((*psd)[i], (*expected)[i], name << ": cached value modified through a copy");
+    }
+}
+
+void
+WifiSpectrumPsdCacheTestCase::DoRun (void)
+{
+  typedef WifiSpectrumValueHelper H;
+  for (uint16_t width : { 5, 10, 20 })
+    {
+      Check ("OFDM " + std::to_string (width) + " MHz",
+             [=] (double p) { return H::CreateOfdmTxPowerSpectralDensity (5180, width, p, width); },
+             [=] (double p) { return H::DoCreateOfdmTxPowerSpectralDensity (5180, width, p, width, -20, -28, -40); });
+    }
+  // HT and VHT share the same transmit spectrum mask
+  for (uint16_t width : { 20, 40, 80, 160 })
+    {
+      uint32_t frequency = 5170 + width / 2;
+      Check ("HT/VHT " + std::to_string (width) + " MHz",
+             [=] (double p) { return H::CreateHtOfdmTxPowerSpectralDensity (frequency, width, p, width); },
+             [=] (double p) { return H::DoCreateHtOfdmTxPowerSpectralDensity (frequency, width, p, width, -20, -28, -40); });
+      Check ("HE " + std::to_string (width) + " MHz",
+             [=] (double p) { return H::CreateHeOfdmTxPowerSpectralDensity (frequency, width, p, width); },
+             [=] (double p) { return H::DoCreateHeOfdmTxPowerSpectralDensity (frequency, width, p, width, -20, -28, -40); });
+    }
+  Check ("HE MU 80 MHz",
+         [] (double p) { return H::CreateHeMuOfdmTxPowerSpectralDensity (5210, 80, p, 80, std::make_pair (500, 541)); },
+         [] (double p) { return H::DoCreateHeMuOfdmTxPowerSpectralDensity (5210, 80, p, 80, std::make_pair (500, 541)); });
+  Check ("DSSS",
+         [] (double p) { return H::CreateDsssTxPowerSpectralDensity (2412, p, 10); },
+         [] (double p) { return H::DoCreateDsssTxPowerSpectralDensity (2412, p, 10); });
+  Check ("RF filter",
+         [] (double) { return H::CreateRfFilter (5210, 80, 78125, 80, std::make_pair (100, 200)); },
+         [] (double) { return H::DoCreateRfFilter (5210, 80, 78125, 80, std::make_pair (100, 200)); });
+
+  // the cache is cleared with the simulation
+  Simulator::Destroy ();
+  Check ("HE 20 MHz, after Simulator::Destroy",
+         [] (double p) { return H::CreateHeOfdmTxPowerSpectralDensity (5180, 20, p, 20); },
+         [] (double p) { return H::DoCreateHeOfdmTxPowerSpectralDensity (5180, 20, p, 20, -20, -28, -40); });
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup spectrum-test
+ * \ingroup tests
+ *
+ * \brief Wi-Fi power spectral density cache test suite
+ */
+class WifiSpectrumPsdCacheTestSuite : public TestSuite
+{
+public:
+  WifiSpectrumPsdCacheTestSuite ();
+};
+
+WifiSpectrumPsdCacheTestSuite::WifiSpectrumPsdCacheTestSuite ()
+  : TestSuite ("wifi-spectrum-psd-cache", UNIT)
+{
+  AddTestCase (new WifiSpectrumPsdCacheTestCase, TestCase::QUICK);
+}
+
+static WifiSpectrumPsdCacheTestSuite g_wifiSpectrumPsdCacheTestSuite; ///< the test suite
@@ -0,0 +1,159 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * This program measures the time needed to import a topology file and to
+ * build the corresponding point-to-point network:
+ *
+ * - "reader": TopologyReader, then one PointToPointHelper::Install and one
+ *   Ipv4AddressHelper::Assign per TopologyReader::Link, as in
+ *   topology-example-sim.cc;
+ * - "csr (text)": TopologyCsr parsing the text file, then TopologyCsrHelper;
+ * - "csr (cache)": TopologyCsr loading the binary cache written by the
+ *   previous run, then TopologyCsrHelper.
+ *
+ * ./waf --run "topology-import-benchmark --format=Inet --input=src/topology-read/examples/Inet_toposample.txt"
+ */
+
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/topology-read-module.h"
+
+/**
+ * \file
+ * \ingroup topology
+ * Compare the import time of TopologyReader and TopologyCsr.
+ */
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("TopologyImportBenchmark");
+
+/**
+ * Print the times of a run
+ * \param name the name of the run
+ * \param readTime the time spent reading the file, in ms
+ * \param buildTime the time spent building the network, in ms
+ * \param nNodes the number of nodes
+ * \param nLinks the number of links
+ */
+static void
+PrintTimes (std::string name, int64_t readTime, int64_t buildTime, uint32_t nNodes, uint32_t nLinks)
+{
+  std::cout << std::setw (14) << name << std::setw (12) << readTime << std::setw (12) << buildTime
+            << std::setw (10) << nNodes << std::setw (10) << nLinks << std::endl;
+}
+
+/**
+ * Import the topology with a TopologyReader
+ * \param input the topology file
+ * \param format the topology file format
+ */
+static void
+RunReader (std::string input, std::string format)
+{
+  SystemWallClockMs clock;
+  clock.Start ();
+  TopologyReaderHelper topoHelp;
+  topoHelp.SetFileName (input);
+  topoHelp.SetFileType (format);
+  Ptr<TopologyReader> inFile = topoHelp.GetTopologyReader ();
+  NodeContainer nodes = inFile->Read ();
+  int64_t readTime = clock.End ();
+
+  clock.Start ();
+  InternetStackHelper stack;
+  stack.Install (nodes);
+  PointToPointHelper p2p;
+  Ipv4AddressHelper address;
+  address.SetBase ("10.0.0.0", "255.255.255.252");
+  for (TopologyReader::ConstLinksIterator iter = inFile->LinksBegin (); iter != inFile->LinksEnd (); iter++)
+    {
+      NetDeviceContainer devices = p2p.Install (iter->GetFromNode (), iter->GetToNode ());
+      address.Assign (devices);
+      address.NewNetwork ();
+    }
+  int64_t buildTime = clock.End ();
+
+  PrintTimes ("reader", readTime, buildTime, nodes.GetN (), inFile->LinksSize ());
+  Simulator::Destroy ();
+  Ipv4AddressGenerator::Reset ();
+}
+
+/**
+ * Import the topology with a TopologyCsr
+ * \param name the name of the run
+ * \param input the topology file
+ * \param format the topology file format
+ * \param cache the binary cache file
+ */
+static void
+RunCsr (std::string name, std::string input, std::string format, std::string cache)
+{
+  SystemWallClockMs clock;
+  clock.Start ();
+  TopologyCsrHelper topoHelp;
+  topoHelp.SetFileName (input);
+  topoHelp.SetFileType (format);
+  topoHelp.SetCacheFileName (cache);
+  Ptr<TopologyCsr> topology = topoHelp.Read ();
+  NodeContainer nodes = topoHelp.CreateNodes (topology);
+  int64_t readTime = clock.End ();
+
+  clock.Start ();
+  InternetStackHelper stack;
+  stack.Install (nodes);
+  PointToPointHelper p2p;
+  NetDeviceContainer devices = topoHelp.InstallLinks (topology, nodes, p2p);
+  topoHelp.AssignAddresses (topology, devices, "10.0.0.0", "255.0.0.0");
+  int64_t buildTime = clock.End ();
+
+  PrintTimes (name, readTime, buildTime, topology->GetNNodes (), topology->GetNLinks ());
+  Simulator::Destroy ();
+  Ipv4AddressGenerator::Reset ();
+}
+
+int
+main (int argc, char *argv[])
+{
+  std::string format ("Inet");
+  std::string input ("src/topology-read/examples/Inet_toposample.txt");
+  std::string cache ("topology-import-benchmark.bin");
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("format", "Format to use for data input [Orbis|Inet|Rocketfuel|CaidaAsRel].", format);
+  cmd.AddValue ("input", "Name of the input file.", input);
+  cmd.AddValue ("cache", "Name of the binary cache file (rewritten by the run).", cache);
+  cmd.Parse (argc, argv);
+
+  std::cout << "input: " << input << std::endl;
+  std::cout << std::setw (14) << "import" << std::setw (12) << "read (ms)" << std::setw (12) << "build (ms)"
+            << std::setw (10) << "nodes" << std::setw (10) << "links" << std::endl;
+
+  if (format != "CaidaAsRel")
+    {
+      RunReader (input, format);
+    }
+  std::remove (cache.c_str ());
+  RunCsr ("csr (text)", input, format, cache);
+  RunCsr ("csr (cache)", input, format, cache);
+
+  return 0;
+}
@@ -0,0 +1,159 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/ipv4.h"
+#include "ns3/ipv4-address-generator.h"
+#include "ns3/loopback-net-device.h"
+#include "ns3/net-device-queue-interface.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/traffic-control-helper.h"
+#include "ns3/traffic-control-layer.h"
+#include "topology-csr-helper.h"
+
+/**
+ * \file
+ * \ingroup topology
+ * ns3::TopologyCsrHelper implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TopologyCsrHelper");
+
+TopologyCsrHelper::TopologyCsrHelper ()
+{
+}
+
+void
+TopologyCsrHelper::SetFileName (const std::string fileName)
+{
+  m_fileName = fileName;
+}
+
+void
+TopologyCsrHelper::SetFileType (const std::string fileType)
+{
+  m_fileType = fileType;
+}
+
+void
+TopologyCsrHelper::SetCacheFileName (const std::string cacheFileName)
+{
+  m_cacheFileName = cacheFileName;
+}
+
+Ptr<TopologyCsr>
+TopologyCsrHelper::Read (void) const
+{
+  NS_ASSERT_MSG (!m_fileType.empty (), "Missing File Type");
+  NS_ASSERT_MSG (!m_fileName.empty (), "Missing File Name");
+
+  Ptr<TopologyCsr> topology = CreateObject<TopologyCsr> ();
+  if (!topology->Read (m_fileName, m_fileType, m_cacheFileName))
+    {
+      return 0;
+    }
+  return topology;
+}
+
+NodeContainer
+TopologyCsrHelper::CreateNodes (Ptr<const TopologyCsr> topology) const
+{
+  NS_LOG_FUNCTION (this << topology);
+  NodeContainer nodes;
+  nodes.Create (topology->GetNNodes ());
+  return nodes;
+}
+
+NetDeviceContainer
+TopologyCsrHelper::InstallLinks (Ptr<const TopologyCsr> topology, const NodeContainer &nodes,
+                                 PointToPointHelper &p2p) const
+{
+  NS_LOG_FUNCTION (this << topology);
+  NS_ASSERT_MSG (nodes.GetN () == topology->GetNNodes (), "One node per topology node is needed");
+
+  NetDeviceContainer devices;
+  uint32_t nLinks = topology->GetNLinks ();
+  for (uint32_t i = 0; i < nLinks; i++)
+    {
+      devices.Add (p2p.Install (nodes.Get (topology->GetLinkFrom (i)),
+                                nodes.Get (topology->GetLinkTo (i))));
+    }
+  return devices;
+}
+
+Ipv4InterfaceContainer
+TopologyCsrHelper::AssignAddresses (Ptr<const TopologyCsr> topology,
+                                    const NetDeviceContainer &devices,
+                                    Ipv4Address network, Ipv4Mask mask) const
+{
+  NS_LOG_FUNCTION (this << topology << network << mask);
+  uint32_t nLinks = topology->GetNLinks ();
+  NS_ASSERT_MSG (devices.GetN () == 2 * nLinks, "Two devices per topology link are needed");
+  NS_ABORT_MSG_UNLESS (uint64_t (~mask.Get ()) + 1 >= 4 * uint64_t (nLinks),
+                       "The block " << network << mask << " cannot hold " << nLinks << " /30 subnets");
+
+  Ipv4Mask subnetMask ("255.255.255.252");
+  uint32_t base = network.CombineMask (mask).Get ();
+  Ipv4InterfaceContainer interfaces;
+  for (uint32_t i = 0; i < nLinks; i++)
+    {
+      uint32_t subnet = base + 4 * i;
+      // the whole subnet is registered, so that consecutive subnets make a
+      // single block in the generator and each registration is O(1)
+      Ipv4AddressGenerator::AddAllocated (Ipv4Address (subnet));
+      for (uint32_t j = 0; j < 2; j++)
+        {
+          Ipv4Address address (subnet + 1 + j);
+          Ipv4AddressGenerator::AddAllocated (address);
+
+          Ptr<NetDevice> device = devices.Get (2 * i + j);
+          Ptr<Node> node = device->GetNode ();
+          Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+          NS_ASSERT_MSG (ipv4, "TopologyCsrHelper::AssignAddresses(): NetDevice is associated"
+                         " with a node without IPv4 stack installed -> fail "
+                         "(maybe need to use InternetStackHelper?)");
+
+          int32_t interface = ipv4->GetInterfaceForDevice (device);
+          if (interface == -1)
+            {
+              interface = ipv4->AddInterface (device);
+            }
+          ipv4->AddAddress (interface, Ipv4InterfaceAddress (address, subnetMask));
+          ipv4->SetMetric (interface, 1);
+          ipv4->SetUp (interface);
+          interfaces.Add (ipv4, interface);
+
+          // same default traffic control configuration as Ipv4AddressHelper::Assign
+          Ptr<TrafficControlLayer> tc = node->GetObject<TrafficControlLayer> ();
+          if (tc && DynamicCast<LoopbackNetDevice> (device) == 0 && tc->GetRootQueueDiscOnDevice (device) == 0)
+            {
+              Ptr<NetDeviceQueueInterface> ndqi = device->GetObject<NetDeviceQueueInterface> ();
+              if (ndqi)
+                {
+                  TrafficControlHelper tcHelper = TrafficControlHelper::Default (ndqi->GetNTxQueues ());
+                  tcHelper.Install (device);
+                }
+            }
+        }
+      Ipv4AddressGenerator::AddAllocated (Ipv4Address (subnet + 3));
+    }
+  return interfaces;
+}
+
+} // namespace ns3
@@ -0,0 +1,148 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TOPOLOGY_CSR_HELPER_H
+#define TOPOLOGY_CSR_HELPER_H
+
+#include <string>
+#include "ns3/topology-csr.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv4-interface-container.h"
+
+/**
+ * \file
+ * \ingroup topology
+ * ns3::TopologyCsrHelper declaration.
+ */
+
+namespace ns3 {
+
+class PointToPointHelper;
+
+/**
+ * \ingroup topology
+ *
+ * \brief Helper class to read a TopologyCsr and build the simulated
+ * topology in bulk.
+ *
+ * The nodes, point-to-point links and addresses are created directly from
+ * the link arrays of the TopologyCsr, without going through a
+ * TopologyReader::Link list:
+ *
+ * \code
+ *   TopologyCsrHelper helper;
+ *   helper.SetFileName ("as-rel.txt");
+ *   helper.SetFileType ("CaidaAsRel");
+ *   helper.SetCacheFileName ("as-rel.bin");
+ *   Ptr<TopologyCsr> topology = helper.Read ();
+ *   NodeContainer nodes = helper.CreateNodes (topology);
+ *   InternetStackHelper stack;
+ *   stack.Install (nodes);
+ *   NetDeviceContainer devices = helper.InstallLinks (topology, nodes, p2p);
+ *   helper.AssignAddresses (topology, devices, "10.0.0.0", "255.0.0.0");
+ * \endcode
+ */
+class TopologyCsrHelper
+{
+public:
+  TopologyCsrHelper ();
+
+  /**
+   * \brief Sets the input file name.
+   * \param [in] fileName The input file name.
+   */
+  void SetFileName (const std::string fileName);
+
+  /**
+   * \brief Sets the input file type. Supported file types are "Orbis",
+   * "Inet", "Rocketfuel" (weights files) and "CaidaAsRel".
+   * \param [in] fileType The input file type.
+   */
+  void SetFileType (const std::string fileType);
+
+  /**
+   * \brief Sets the name of the binary cache of the input file.
+   *
+   * If set, the topology is loaded from this file when it is up to date,
+   * and the file is written otherwise (see TopologyCsr::Read).
+   *
+   * \param [in] cacheFileName The binary cache file name.
+   */
+  void SetCacheFileName (const std::string cacheFileName);
+
+  /**
+   * \brief Reads the input file.
+   * \return The topology (or null if there was an error).
+   */
+  Ptr<TopologyCsr> Read (void) const;
+
+  /**
+   * \brief Creates one node per topology node.
+   *
+   * The i-th node of the container is the topology node with id i.
+   *
+   * \param [in] topology The topology.
+   * \return The nodes.
+   */
+  NodeContainer CreateNodes (Ptr<const TopologyCsr> topology) const;
+
+  /**
+   * \brief Creates one point-to-point link per topology link.
+   *
+   * The devices of link i are the devices 2i ("from" node) and 2i+1
+   * ("to" node) of the returned container.
+   *
+   * \param [in] topology The topology.
+   * \param [in] nodes The nodes created by CreateNodes ().
+   * \param [in] p2p The helper creating the links.
+   * \return The devices.
+   */
+  NetDeviceContainer InstallLinks (Ptr<const TopologyCsr> topology, const NodeContainer &nodes,
+                                   PointToPointHelper &p2p) const;
+
+  /**
+   * \brief Assigns a /30 subnet to each topology link.
+   *
+   * Link i gets the subnet network + 4i, its "from" device the first host
+   * address of the subnet and its "to" device the second one.  The
+   * addresses are computed, rather than allocated one network at a time by
+   * an Ipv4AddressHelper, but they are still registered in the
+   * Ipv4AddressGenerator to detect collisions.  As Ipv4AddressHelper::Assign
+   * does, the interfaces are set up and the default traffic control
+   * configuration is installed on the devices.
+   *
+   * \param [in] topology The topology.
+   * \param [in] devices The devices created by InstallLinks ().
+   * \param [in] network The first address of the block of subnets.
+   * \param [in] mask The mask of the block of subnets, which must hold
+   *                  4 * GetNLinks () addresses.
+   * \return The interfaces, in the order of the devices.
+   */
+  Ipv4InterfaceContainer AssignAddresses (Ptr<const TopologyCsr> topology,
+                                          const NetDeviceContainer &devices,
+                                          Ipv4Address network, Ipv4Mask mask) const;
+
+private:
+  std::string m_fileName;       //!< Name of the input file.
+  std::string m_fileType;       //!< Type of the input file (e.g., "Inet", "Orbis", etc.).
+  std::string m_cacheFileName;  //!< Name of the binary cache file.
+};
+
+} // namespace ns3
+
+#endif /* TOPOLOGY_CSR_HELPER_H */
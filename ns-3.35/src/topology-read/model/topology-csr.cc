@@ -0,0 +1,657 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <fstream>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_set>
+#include <sys/stat.h>
+#include "ns3/log.h"
+#include "topology-csr.h"
+
+/**
+ * \file
+ * \ingroup topology
+ * ns3::TopologyCsr implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TopologyCsr");
+
+NS_OBJECT_ENSURE_REGISTERED (TopologyCsr);
+
+/// Magic string at the beginning of a binary topology file
+static const char TOPOLOGY_CSR_MAGIC[8] = { 'n', 's', '3', 'T', 'C', 'S', 'R', '\0' };
+/// Version of the binary topology file format
+static const uint32_t TOPOLOGY_CSR_VERSION = 1;
+/// Value written in native byte order to detect a foreign binary file
+static const uint32_t TOPOLOGY_CSR_BYTE_ORDER = 0x01020304;
+
+/**
+ * \brief Gets the size and modification time of a file.
+ * \param [in] fileName The name of the file.
+ * \param [out] size The size of the file.
+ * \param [out] time The modification time of the file.
+ * \return True if the file exists.
+ */
+static bool
+StatFile (const std::string &fileName, uint64_t &size, int64_t &time)
+{
+  struct stat st;
+  if (stat (fileName.c_str (), &st) != 0)
+    {
+      return false;
+    }
+  size = st.st_size;
+  time = st.st_mtime;
+  return true;
+}
+
+/**
+ * \brief Extracts the next field of a line.
+ *
+ * If the separator is a blank, fields are separated by any number of
+ * spaces and tabs.  Otherwise, fields are separated by exactly one
+ * separator.
+ *
+ * \param [in] line The line.
+ * \param [in,out] pos The position in the line, moved past the field.
+ * \param [in] sep The field separator.
+ * \param [out] field The field.
+ * \return True if a non-empty field was found.
+ */
+static bool
+NextField (const std::string &line, std::string::size_type &pos, char sep, std::string &field)
+{
+  std::string::size_type end = line.size ();
+  if (sep == ' ')
+    {
+      while (pos < end && (line[pos] == ' ' || line[pos] == '\t' || line[pos] == '\r'))
+        {
+          pos++;
+        }
+      std::string::size_type start = pos;
+      while (pos < end && line[pos] != ' ' && line[pos] != '\t' && line[pos] != '\r')
+        {
+          pos++;
+        }
+      field.assign (line, start, pos - start);
+    }
+  else
+    {
+      if (pos > end)
+        {
+          field.clear ();
+          return false;
+        }
+      std::string::size_type start = pos;
+      while (pos < end && line[pos] != sep && line[pos] != '\r')
+        {
+          pos++;
+        }
+      field.assign (line, start, pos - start);
+      pos++;
+    }
+  return !field.empty ();
+}
+
+/**
+ * \brief Writes an array to a binary stream.
+ * \param [in] os The output stream.
+ * \param [in] v The array.
+ */
+template <typename T>
+static void
+WriteArray (std::ostream &os, const std::vector<T> &v)
+{
+  if (!v.empty ())
+    {
+      os.write (reinterpret_cast<const char *> (&v[0]), v.size () * sizeof (T));
+    }
+}
+
+/**
+ * \brief Reads an array from a binary stream.
+ * \param [in] is The input stream.
+ * \param [out] v The array.
+ * \param [in] n The number of elements of the array.
+ */
+template <typename T>
+static void
+ReadArray (std::istream &is, std::vector<T> &v, uint32_t n)
+{
+  v.resize (n);
+  if (n > 0)
+    {
+      is.read (reinterpret_cast<char *> (&v[0]), n * sizeof (T));
+    }
+}
+
+TypeId
+TopologyCsr::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TopologyCsr")
+    .SetParent<Object> ()
+    .SetGroupName ("TopologyReader")
+    .AddConstructor<TopologyCsr> ()
+  ;
+  return tid;
+}
+
+TopologyCsr::TopologyCsr ()
+  : m_sourceSize (0),
+    m_sourceTime (0),
+    m_fromCache (false)
+{
+  NS_LOG_FUNCTION (this);
+  Clear ();
+}
+
+TopologyCsr::~TopologyCsr ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+TopologyCsr::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_fileType.clear ();
+  m_sourceSize = 0;
+  m_sourceTime = 0;
+  m_fromCache = false;
+  m_nameOffsets.assign (1, 0);
+  m_names.clear ();
+  m_from.clear ();
+  m_to.clear ();
+  m_weights.clear ();
+  m_offsets.assign (1, 0);
+  m_neighbors.clear ();
+  m_neighborLinks.clear ();
+  m_nodeIds.clear ();
+}
+
+bool
+TopologyCsr::ReadText (const std::string &fileName, const std::string &fileType)
+{
+  NS_LOG_FUNCTION (this << fileName << fileType);
+  Clear ();
+
+  std::ifstream topgen (fileName.c_str ());
+  if (!topgen.is_open ())
+    {
+      NS_LOG_WARN ("Couldn't open the file " << fileName);
+      return false;
+    }
+
+  bool ok = false;
+  if (fileType == "Inet")
+    {
+      ok = ReadInet (topgen);
+    }
+  else if (fileType == "Orbis")
+    {
+      ok = ReadOrbis (topgen);
+    }
+  else if (fileType == "Rocketfuel")
+    {
+      ok = ReadRocketfuel (topgen);
+    }
+  else if (fileType == "CaidaAsRel")
+    {
+      ok = ReadCaidaAsRel (topgen);
+    }
+  else
+    {
+      NS_LOG_WARN ("Unsupported file type " << fileType);
+    }
+  topgen.close ();
+
+  // the name lookup is only needed while parsing
+  std::unordered_map<std::string, uint32_t> ().swap (m_nodeIds);
+  if (!ok)
+    {
+      Clear ();
+      return false;
+    }
+
+  m_fileType = fileType;
+  StatFile (fileName, m_sourceSize, m_sourceTime);
+  BuildAdjacency ();
+  NS_LOG_INFO (fileType << " topology read with " << GetNNodes () << " nodes and "
+                        << GetNLinks () << " links");
+  return true;
+}
+
+uint32_t
+TopologyCsr::AddLink (const std::string &from, const std::string &to)
+{
+  uint32_t ids[2];
+  const std::string *names[2] = { &from, &to };
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      std::unordered_map<std::string, uint32_t>::const_iterator it = m_nodeIds.find (*names[i]);
+      if (it != m_nodeIds.end ())
+        {
+          ids[i] = it->second;
+        }
+      else
+        {
+          ids[i] = m_nameOffsets.size () - 1;
+          m_nodeIds.emplace (*names[i], ids[i]);
+          m_names.append (*names[i]);
+          m_nameOffsets.push_back (m_names.size ());
+        }
+    }
+  m_from.push_back (ids[0]);
+  m_to.push_back (ids[1]);
+  return m_from.size () - 1;
+}
+
+bool
+TopologyCsr::ReadInet (std::istream &is)
+{
+  std::string line;
+  std::string field;
+  std::string from;
+  std::string to;
+  std::string::size_type pos = 0;
+
+  std::getline (is, line);
+  if (!NextField (line, pos, ' ', field))
+    {
+      NS_LOG_WARN ("Missing Inet header");
+      return false;
+    }
+  uint32_t totnode = std::strtoul (field.c_str (), 0, 10);
+  NextField (line, pos, ' ', field);
+  uint32_t totlink = std::strtoul (field.c_str (), 0, 10);
+  NS_LOG_INFO ("Inet topology should have " << totnode << " nodes and " << totlink << " links");
+
+  m_nodeIds.reserve (totnode);
+  m_nameOffsets.reserve (totnode + 1);
+  m_from.reserve (totlink);
+  m_to.reserve (totlink);
+  m_weights.reserve (totlink);
+
+  for (uint32_t i = 0; i < totnode && std::getline (is, line); i++)
+    {
+    }
+
+  for (uint32_t i = 0; i < totlink && std::getline (is, line); i++)
+    {
+      pos = 0;
+      if (NextField (line, pos, ' ', from) && NextField (line, pos, ' ', to))
+        {
+          AddLink (from, to);
+          m_weights.push_back (NextField (line, pos, ' ', field) ? std::strtod (field.c_str (), 0) : 1);
+        }
+    }
+  return true;
+}
+
+bool
+TopologyCsr::ReadOrbis (std::istream &is)
+{
+  std::string line;
+  std::string from;
+  std::string to;
+
+  while (std::getline (is, line))
+    {
+      std::string::size_type pos = 0;
+      if (NextField (line, pos, ' ', from) && NextField (line, pos, ' ', to))
+        {
+          AddLink (from, to);
+        }
+    }
+  return true;
+}
+
+bool
+TopologyCsr::ReadRocketfuel (std::istream &is)
+{
+  std::string line;
+  std::string from;
+  std::string to;
+  std::string weight;
+  // links already added, as ((from << 32) | to)
+  std::unordered_set<uint64_t> links;
+
+  bool first = true;
+  while (std::getline (is, line))
+    {
+      std::string::size_type pos = 0;
+      if (!NextField (line, pos, ' ', from))
+        {
+          continue;
+        }
+      if (!NextField (line, pos, ' ', to) || !NextField (line, pos, ' ', weight)
+          || weight.find_first_not_of ("0123456789.") != std::string::npos)
+        {
+          if (first)
+            {
+              NS_LOG_WARN ("Not a Rocketfuel weights file (maps files are only supported by RocketfuelTopologyReader)");
+              return false;
+            }
+          NS_LOG_WARN ("match failed (weights file): " << line);
+          break;
+        }
+      first = false;
+
+      // a link listed in both directions is only added once
+      uint32_t nLinks = m_from.size ();
+      uint32_t link = AddLink (from, to);
+      uint64_t fromId = m_from[link];
+      uint64_t toId = m_to[link];
+      if (links.count ((toId << 32) | fromId))
+        {
+          m_from.resize (nLinks);
+          m_to.resize (nLinks);
+          continue;
+        }
+      links.insert ((fromId << 32) | toId);
+      m_weights.push_back (std::strtod (weight.c_str (), 0));
+    }
+  return !first;
+}
+
+bool
+TopologyCsr::ReadCaidaAsRel (std::istream &is)
+{
+  std::string line;
+  std::string from;
+  std::string to;
+  std::string rel;
+
+  while (std::getline (is, line))
+    {
+      if (line.empty () || line[0] == '#')
+        {
+          continue;
+        }
+      std::string::size_type pos = 0;
+      if (NextField (line, pos, '|', from) && NextField (line, pos, '|', to)
+          && NextField (line, pos, '|', rel))
+        {
+          AddLink (from, to);
+          m_weights.push_back (std::strtod (rel.c_str (), 0));
+        }
+    }
+  return true;
+}
+
+void
+TopologyCsr::BuildAdjacency (void)
+{
+  NS_LOG_FUNCTION (this);
+  uint32_t nNodes = GetNNodes ();
+  uint32_t nLinks = GetNLinks ();
+
+  // count the links of each node, then turn the counts into offsets
+  m_offsets.assign (nNodes + 1, 0);
+  for (uint32_t i = 0; i < nLinks; i++)
+    {
+      m_offsets[m_from[i] + 1]++;
+      m_offsets[m_to[i] + 1]++;
+    }
+  for (uint32_t n = 0; n < nNodes; n++)
+    {
+      m_offsets[n + 1] += m_offsets[n];
+    }
+
+  m_neighbors.resize (2 * nLinks);
+  m_neighborLinks.resize (2 * nLinks);
+  std::vector<uint32_t> next (m_offsets.begin (), m_offsets.end () - 1);
+  for (uint32_t i = 0; i < nLinks; i++)
+    {
+      uint32_t entry = next[m_from[i]]++;
+      m_neighbors[entry] = m_to[i];
+      m_neighborLinks[entry] = i;
+      entry = next[m_to[i]]++;
+      m_neighbors[entry] = m_from[i];
+      m_neighborLinks[entry] = i;
+    }
+}
+
+bool
+TopologyCsr::Save (const std::string &fileName) const
+{
+  NS_LOG_FUNCTION (this << fileName);
+  std::ofstream os (fileName.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!os.is_open ())
+    {
+      NS_LOG_WARN ("Couldn't open the file " << fileName);
+      return false;
+    }
+
+  uint32_t typeSize = m_fileType.size ();
+  uint32_t nNodes = GetNNodes ();
+  uint32_t nLinks = GetNLinks ();
+  uint32_t namesSize = m_names.size ();
+  uint32_t hasWeights = HasWeights ();
+
+  os.write (TOPOLOGY_CSR_MAGIC, sizeof (TOPOLOGY_CSR_MAGIC));
+  os.write (reinterpret_cast<const char *> (&TOPOLOGY_CSR_VERSION), sizeof (uint32_t));
+  os.write (reinterpret_cast<const char *> (&TOPOLOGY_CSR_BYTE_ORDER), sizeof (uint32_t));
+  os.write (reinterpret_cast<const char *> (&m_sourceSize), sizeof (uint64_t));
+  os.write (reinterpret_cast<const char *> (&m_sourceTime), sizeof (int64_t));
+  os.write (reinterpret_cast<const char *> (&typeSize), sizeof (uint32_t));
+  os.write (reinterpret_cast<const char *> (&nNodes), sizeof (uint32_t));
+  os.write (reinterpret_cast<const char *> (&nLinks), sizeof (uint32_t));
+  os.write (reinterpret_cast<const char *> (&namesSize), sizeof (uint32_t));
+  os.write (reinterpret_cast<const char *> (&hasWeights), sizeof (uint32_t));
+  os.write (m_fileType.data (), typeSize);
+  os.write (m_names.data (), namesSize);
+  WriteArray (os, m_nameOffsets);
+  WriteArray (os, m_from);
+  WriteArray (os, m_to);
+  WriteArray (os, m_weights);
+  WriteArray (os, m_offsets);
+  WriteArray (os, m_neighbors);
+  WriteArray (os, m_neighborLinks);
+  os.close ();
+
+  if (os.fail ())
+    {
+      NS_LOG_WARN ("Couldn't write the file " << fileName);
+      return false;
+    }
+  return true;
+}
+
+bool
+TopologyCsr::Load (const std::string &fileName)
+{
+  NS_LOG_FUNCTION (this << fileName);
+  Clear ();
+
+  std::ifstream is (fileName.c_str (), std::ios::in | std::ios::binary);
+  if (!is.is_open ())
+    {
+      NS_LOG_INFO ("Couldn't open the file " << fileName);
+      return false;
+    }
+
+  char magic[sizeof (TOPOLOGY_CSR_MAGIC)];
+  uint32_t version = 0;
+  uint32_t byteOrder = 0;
+  is.read (magic, sizeof (magic));
+  is.read (reinterpret_cast<char *> (&version), sizeof (uint32_t));
+  is.read (reinterpret_cast<char *> (&byteOrder), sizeof (uint32_t));
+  if (!is || std::memcmp (magic, TOPOLOGY_CSR_MAGIC, sizeof (magic)) != 0
+      || version != TOPOLOGY_CSR_VERSION || byteOrder != TOPOLOGY_CSR_BYTE_ORDER)
+    {
+      NS_LOG_WARN ("Not a binary topology file: " << fileName);
+      return false;
+    }
+
+  uint32_t typeSize = 0;
+  uint32_t nNodes = 0;
+  uint32_t nLinks = 0;
+  uint32_t namesSize = 0;
+  uint32_t hasWeights = 0;
+  is.read (reinterpret_cast<char *> (&m_sourceSize), sizeof (uint64_t));
+  is.read (reinterpret_cast<char *> (&m_sourceTime), sizeof (int64_t));
+  is.read (reinterpret_cast<char *> (&typeSize), sizeof (uint32_t));
+  is.read (reinterpret_cast<char *> (&nNodes), sizeof (uint32_t));
+  is.read (reinterpret_cast<char *> (&nLinks), sizeof (uint32_t));
+  is.read (reinterpret_cast<char *> (&namesSize), sizeof (uint32_t));
+  is.read (reinterpret_cast<char *> (&hasWeights), sizeof (uint32_t));
+  if (!is)
+    {
+      NS_LOG_WARN ("Truncated binary topology file: " << fileName);
+      Clear ();
+      return false;
+    }
+  m_fileType.resize (typeSize);
+  m_names.resize (namesSize);
+  if (typeSize > 0)
+    {
+      is.read (&m_fileType[0], typeSize);
+    }
+  if (namesSize > 0)
+    {
+      is.read (&m_names[0], namesSize);
+    }
+  ReadArray (is, m_nameOffsets, nNodes + 1);
+  ReadArray (is, m_from, nLinks);
+  ReadArray (is, m_to, nLinks);
+  ReadArray (is, m_weights, hasWeights ? nLinks : 0);
+  ReadArray (is, m_offsets, nNodes + 1);
+  ReadArray (is, m_neighbors, 2 * nLinks);
+  ReadArray (is, m_neighborLinks, 2 * nLinks);
+
+  if (!is || m_nameOffsets.back () != namesSize || m_offsets.back () != 2 * nLinks)
+    {
+      NS_LOG_WARN ("Truncated binary topology file: " << fileName);
+      Clear ();
+      return false;
+    }
+  NS_LOG_INFO (m_fileType << " topology loaded with " << nNodes << " nodes and "
+                          << nLinks << " links");
+  return true;
+}
+
+bool
+TopologyCsr::Read (const std::string &fileName, const std::string &fileType,
+                   const std::string &cacheFileName)
+{
+  NS_LOG_FUNCTION (this << fileName << fileType << cacheFileName);
+  if (cacheFileName.empty ())
+    {
+      return ReadText (fileName, fileType);
+    }
+
+  uint64_t size;
+  int64_t time;
+  if (!StatFile (fileName, size, time))
+    {
+      NS_LOG_WARN ("Couldn't open the file " << fileName);
+      Clear ();
+      return false;
+    }
+  if (Load (cacheFileName) && m_fileType == fileType
+      && m_sourceSize == size && m_sourceTime == time)
+    {
+      m_fromCache = true;
+      return true;
+    }
+
+  NS_LOG_INFO ("Binary topology file " << cacheFileName << " missing or stale");
+  if (!ReadText (fileName, fileType))
+    {
+      return false;
+    }
+  Save (cacheFileName);
+  return true;
+}
+
+bool
+TopologyCsr::IsFromCache (void) const
+{
+  return m_fromCache;
+}
+
+uint32_t
+TopologyCsr::GetNNodes (void) const
+{
+  return m_nameOffsets.size () - 1;
+}
+
+uint32_t
+TopologyCsr::GetNLinks (void) const
+{
+  return m_from.size ();
+}
+
+uint32_t
+TopologyCsr::GetLinkFrom (uint32_t link) const
+{
+  NS_ASSERT (link < m_from.size ());
+  return m_from[link];
+}
+
+uint32_t
+TopologyCsr::GetLinkTo (uint32_t link) const
+{
+  NS_ASSERT (link < m_to.size ());
+  return m_to[link];
+}
+
+bool
+TopologyCsr::HasWeights (void) const
+{
+  return !m_weights.empty ();
+}
+
+double
+TopologyCsr::GetLinkWeight (uint32_t link) const
+{
+  NS_ASSERT (link < m_from.size ());
+  return m_weights.empty () ? 1 : m_weights[link];
+}
+
+std::string
+TopologyCsr::GetNodeName (uint32_t node) const
+{
+  NS_ASSERT (node < GetNNodes ());
+  return m_names.substr (m_nameOffsets[node], m_nameOffsets[node + 1] - m_nameOffsets[node]);
+}
+
+uint32_t
+TopologyCsr::GetDegree (uint32_t node) const
+{
+  NS_ASSERT (node < GetNNodes ());
+  return m_offsets[node + 1] - m_offsets[node];
+}
+
+uint32_t
+TopologyCsr::GetNeighbor (uint32_t node, uint32_t i) const
+{
+  NS_ASSERT (i < GetDegree (node));
+  return m_neighbors[m_offsets[node] + i];
+}
+
+uint32_t
+TopologyCsr::GetNeighborLink (uint32_t node, uint32_t i) const
+{
+  NS_ASSERT (i < GetDegree (node));
+  return m_neighborLinks[m_offsets[node] + i];
+}
+
+} // namespace ns3
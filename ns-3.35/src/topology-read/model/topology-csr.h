@@ -0,0 +1,253 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TOPOLOGY_CSR_H
+#define TOPOLOGY_CSR_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <stdint.h>
+#include "ns3/object.h"
+
+/**
+ * \file
+ * \ingroup topology
+ * ns3::TopologyCsr declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup topology
+ *
+ * \brief Compact, node-less representation of a topology file.
+ *
+ * Unlike the TopologyReader subclasses, which create a Node for every
+ * topology node and keep every link as a TopologyReader::Link with a
+ * string-keyed attribute map, this class only stores integer node ids:
+ *
+ * - the links, as arrays of "from" and "to" node ids, plus an optional
+ *   array of weights;
+ * - the undirected adjacency of the nodes, in Compressed Sparse Row (CSR)
+ *   form: the neighbors of node \c n are stored in the
+ *   [GetDegree (n)] entries following the offset of \c n;
+ * - the names of the nodes, in a single character buffer.
+ *
+ * Node ids are assigned in order of first appearance in the link list, i.e.,
+ * in the order the TopologyReader subclasses add nodes to the NodeContainer
+ * they return, and the links are kept in file order.
+ *
+ * The text files are parsed line by line, without building any intermediate
+ * link list.  The supported file types are:
+ *
+ * - "Inet": Inet 3.0 files (the link weight is the third column);
+ * - "Orbis": Orbis 0.7 files;
+ * - "Rocketfuel": Rocketfuel weights files (a link listed in both
+ *   directions is kept once, as in RocketfuelTopologyReader);
+ * - "CaidaAsRel": CAIDA AS relationship files ("as1|as2|rel[|source]"
+ *   lines, comments starting with '#'; the weight is the relationship).
+ *
+ * The topology can be saved in a binary form, which is loaded much faster
+ * than the text file can be parsed.  Read () keeps such a binary cache up to
+ * date with the text file.
+ *
+ * TopologyCsrHelper creates the nodes, point-to-point links and addresses
+ * of a TopologyCsr.
+ */
+class TopologyCsr : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  TopologyCsr ();
+  virtual ~TopologyCsr ();
+
+  /**
+   * \brief Parses a topology text file.
+   *
+   * Any topology previously held is discarded.
+   *
+   * \param [in] fileName The name of the text file.
+   * \param [in] fileType The type of the file ("Inet", "Orbis", "Rocketfuel"
+   *                      or "CaidaAsRel").
+   * \return True if the file was parsed, false otherwise.
+   */
+  bool ReadText (const std::string &fileName, const std::string &fileType);
+
+  /**
+   * \brief Saves the topology in binary form.
+   * \param [in] fileName The name of the binary file.
+   * \return True if the file was written, false otherwise.
+   */
+  bool Save (const std::string &fileName) const;
+
+  /**
+   * \brief Loads a topology saved by Save ().
+   *
+   * Any topology previously held is discarded.
+   *
+   * \param [in] fileName The name of the binary file.
+   * \return True if the file was loaded, false otherwise.
+   */
+  bool Load (const std::string &fileName);
+
+  /**
+   * \brief Reads a topology text file through a binary cache.
+   *
+   * If the cache file was saved from the same text file (same type, size
+   * and modification time), it is loaded.  Otherwise, the text file is
+   * parsed and the cache file is (re)written.  If the cache file name is
+   * empty, this is equivalent to ReadText ().
+   *
+   * \param [in] fileName The name of the text file.
+   * \param [in] fileType The type of the text file.
+   * \param [in] cacheFileName The name of the binary cache file.
+   * \return True if the topology was read, false otherwise.
+   */
+  bool Read (const std::string &fileName, const std::string &fileType,
+             const std::string &cacheFileName);
+
+  /**
+   * \brief Returns true if the last Read () loaded the binary cache.
+   * \return True if the topology was loaded from the binary cache.
+   */
+  bool IsFromCache (void) const;
+
+  /**
+   * \brief Discards the topology.
+   */
+  void Clear (void);
+
+  /**
+   * \brief Returns the number of nodes.
+   * \return The number of nodes.
+   */
+  uint32_t GetNNodes (void) const;
+  /**
+   * \brief Returns the number of links.
+   * \return The number of links.
+   */
+  uint32_t GetNLinks (void) const;
+  /**
+   * \brief Returns the node a link is originating from.
+   * \param [in] link The link index.
+   * \return The id of the "from" node.
+   */
+  uint32_t GetLinkFrom (uint32_t link) const;
+  /**
+   * \brief Returns the node a link is directed to.
+   * \param [in] link The link index.
+   * \return The id of the "to" node.
+   */
+  uint32_t GetLinkTo (uint32_t link) const;
+  /**
+   * \brief Returns true if the links have a weight.
+   * \return True if the file type carries link weights.
+   */
+  bool HasWeights (void) const;
+  /**
+   * \brief Returns the weight of a link.
+   * \param [in] link The link index.
+   * \return The weight of the link, or 1 if the links have no weight.
+   */
+  double GetLinkWeight (uint32_t link) const;
+  /**
+   * \brief Returns the name of a node in the topology file.
+   * \param [in] node The node id.
+   * \return The name of the node.
+   */
+  std::string GetNodeName (uint32_t node) const;
+  /**
+   * \brief Returns the number of links of a node.
+   * \param [in] node The node id.
+   * \return The degree of the node.
+   */
+  uint32_t GetDegree (uint32_t node) const;
+  /**
+   * \brief Returns a neighbor of a node.
+   * \param [in] node The node id.
+   * \param [in] i The neighbor index, lower than GetDegree (node).
+   * \return The id of the neighbor.
+   */
+  uint32_t GetNeighbor (uint32_t node, uint32_t i) const;
+  /**
+   * \brief Returns the link connecting a node to one of its neighbors.
+   * \param [in] node The node id.
+   * \param [in] i The neighbor index, lower than GetDegree (node).
+   * \return The index of the link.
+   */
+  uint32_t GetNeighborLink (uint32_t node, uint32_t i) const;
+
+private:
+  /**
+   * \brief Parses an Inet file.
+   * \param [in] is The input stream.
+   * \return True if the file was parsed.
+   */
+  bool ReadInet (std::istream &is);
+  /**
+   * \brief Parses an Orbis file.
+   * \param [in] is The input stream.
+   * \return True if the file was parsed.
+   */
+  bool ReadOrbis (std::istream &is);
+  /**
+   * \brief Parses a Rocketfuel weights file.
+   * \param [in] is The input stream.
+   * \return True if the file was parsed.
+   */
+  bool ReadRocketfuel (std::istream &is);
+  /**
+   * \brief Parses a CAIDA AS relationship file.
+   * \param [in] is The input stream.
+   * \return True if the file was parsed.
+   */
+  bool ReadCaidaAsRel (std::istream &is);
+  /**
+   * \brief Adds a link between two named nodes, adding the nodes if needed.
+   * \param [in] from The name of the "from" node.
+   * \param [in] to The name of the "to" node.
+   * \return The index of the link.
+   */
+  uint32_t AddLink (const std::string &from, const std::string &to);
+  /**
+   * \brief Builds the CSR adjacency from the link arrays.
+   */
+  void BuildAdjacency (void);
+
+  std::string m_fileType;               //!< Type of the file the topology was read from.
+  uint64_t m_sourceSize;                //!< Size of the file the topology was read from.
+  int64_t m_sourceTime;                 //!< Modification time of the file the topology was read from.
+  bool m_fromCache;                     //!< True if the topology was loaded from a binary cache.
+  std::vector<uint32_t> m_nameOffsets;  //!< Offset of each node name in m_names, plus the end.
+  std::string m_names;                  //!< Names of the nodes, concatenated.
+  std::vector<uint32_t> m_from;         //!< "From" node of each link.
+  std::vector<uint32_t> m_to;           //!< "To" node of each link.
+  std::vector<double> m_weights;        //!< Weight of each link (empty if none).
+  std::vector<uint32_t> m_offsets;      //!< First adjacency entry of each node, plus the end.
+  std::vector<uint32_t> m_neighbors;    //!< Neighbor of each adjacency entry.
+  std::vector<uint32_t> m_neighborLinks; //!< Link of each adjacency entry.
+  std::unordered_map<std::string, uint32_t> m_nodeIds; //!< Node ids, by name (only used while parsing).
+};
+
+} // namespace ns3
+
+#endif /* TOPOLOGY_CSR_H */
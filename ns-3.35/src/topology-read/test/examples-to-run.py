@@ -10,6 +10,7 @@
 cpp_examples = [
     ("Inet_small_toposample.txt", "True", "True"),
     ("RocketFuel_toposample_1239_weights.txt", "True", "True"),
+    ("topology-import-benchmark", "True", "False"),
 ]
 
 # A list of Python examples to run in order to ensure that they remain
@@ -0,0 +1,264 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstdio>
+#include <fstream>
+#include "ns3/test.h"
+#include "ns3/topology-csr.h"
+#include "ns3/topology-csr-helper.h"
+#include "ns3/topology-reader-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/channel.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-generator.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/simulator.h"
+
+using namespace ns3;
+
+/**
+ * \file
+ * \ingroup topology-test
+ * ns3::TopologyCsr test suite.
+ */
+
+/**
+ * \ingroup topology-test
+ * \ingroup tests
+ *
+ * \brief Check that a TopologyCsr holds the same links as a TopologyReader.
+ */
+class TopologyCsrReadTest : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param fileName the topology file
+   * \param fileType the topology file type
+   * \param nNodes the expected number of nodes
+   * \param nLinks the expected number of links
+   */
+  TopologyCsrReadTest (std::string fileName, std::string fileType, uint32_t nNodes, uint32_t nLinks);
+private:
+  virtual void DoRun (void);
+
+  std::string m_fileName; //!< the topology file
+  std::string m_fileType; //!< the topology file type
+  uint32_t m_nNodes;      //!< the expected number of nodes
+  uint32_t m_nLinks;      //!< the expected number of links
+};
+
+TopologyCsrReadTest::TopologyCsrReadTest (std::string fileName, std::string fileType,
+                                          uint32_t nNodes, uint32_t nLinks)
+  : TestCase ("TopologyCsr " + fileType + " file"),
+    m_fileName (fileName),
+    m_fileType (fileType),
+    m_nNodes (nNodes),
+    m_nLinks (nLinks)
+{
+}
+
+void
+TopologyCsrReadTest::DoRun (void)
+{
+  Ptr<TopologyCsr> topology = CreateObject<TopologyCsr> ();
+  NS_TEST_ASSERT_MSG_EQ (topology->ReadText (m_fileName, m_fileType), true, "Problems reading the topology file");
+  NS_TEST_EXPECT_MSG_EQ (topology->GetNNodes (), m_nNodes, "nodes");
+  NS_TEST_ASSERT_MSG_EQ (topology->GetNLinks (), m_nLinks, "links");
+
+  TopologyReaderHelper readerHelper;
+  readerHelper.SetFileName (m_fileName);
+  readerHelper.SetFileType (m_fileType);
+  Ptr<TopologyReader> reader = readerHelper.GetTopologyReader ();
+  NodeContainer nodes = reader->Read ();
+  NS_TEST_EXPECT_MSG_EQ (topology->GetNNodes (), nodes.GetN (), "nodes differ from the TopologyReader");
+  NS_TEST_ASSERT_MSG_EQ (topology->GetNLinks (), (uint32_t) reader->LinksSize (), "links differ from the TopologyReader");
+
+  uint32_t i = 0;
+  for (TopologyReader::ConstLinksIterator link = reader->LinksBegin (); link != reader->LinksEnd (); link++, i++)
+    {
+      uint32_t from = topology->GetLinkFrom (i);
+      uint32_t to = topology->GetLinkTo (i);
+      NS_TEST_EXPECT_MSG_EQ (topology->GetNodeName (from), link->GetFromNodeName (), "link " << i);
+      NS_TEST_EXPECT_MSG_EQ (topology->GetNodeName (to), link->GetToNodeName (), "link " << i);
+      // the node ids follow the order of the TopologyReader nodes
+      NS_TEST_EXPECT_MSG_EQ (nodes.Get (from), link->GetFromNode (), "link " << i);
+      NS_TEST_EXPECT_MSG_EQ (nodes.Get (to), link->GetToNode (), "link " << i);
+    }
+
+  uint32_t entries = 0;
+  for (uint32_t n = 0; n < topology->GetNNodes (); n++)
+    {
+      for (uint32_t j = 0; j < topology->GetDegree (n); j++, entries++)
+        {
+          uint32_t link = topology->GetNeighborLink (n, j);
+          uint32_t neighbor = topology->GetNeighbor (n, j);
+          bool match = (topology->GetLinkFrom (link) == n && topology->GetLinkTo (link) == neighbor)
+            || (topology->GetLinkTo (link) == n && topology->GetLinkFrom (link) == neighbor);
+          NS_TEST_EXPECT_MSG_EQ (match, true, "adjacency of node " << n);
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (entries, 2 * topology->GetNLinks (), "adjacency entries");
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup topology-test
+ * \ingroup tests
+ *
+ * \brief Check the binary cache of a TopologyCsr.
+ */
+class TopologyCsrCacheTest : public TestCase
+{
+public:
+  TopologyCsrCacheTest ();
+private:
+  virtual void DoRun (void);
+};
+
+TopologyCsrCacheTest::TopologyCsrCacheTest ()
+  : TestCase ("TopologyCsr binary cache")
+{
+}
+
+void
+TopologyCsrCacheTest::DoRun (void)
+{
+  std::string fileName = CreateTempDirFilename ("as-rel.txt");
+  std::string cacheFileName = CreateTempDirFilename ("as-rel.bin");
+  std::ofstream os (fileName.c_str ());
+  os << "# source:topology|BGP" << std::endl
+     << "1|11537|0|bgp" << std::endl
+     << "1|2914|-1|bgp" << std::endl
+     << "2914|64512|-1|mlp" << std::endl
+     << "11537|64512|0" << std::endl;
+  os.close ();
+  std::remove (cacheFileName.c_str ());
+
+  Ptr<TopologyCsr> text = CreateObject<TopologyCsr> ();
+  NS_TEST_ASSERT_MSG_EQ (text->Read (fileName, "CaidaAsRel", cacheFileName), true, "Problems reading the topology file");
+  NS_TEST_EXPECT_MSG_EQ (text->IsFromCache (), false, "the cache did not exist");
+  NS_TEST_EXPECT_MSG_EQ (text->GetNNodes (), 4, "nodes");
+  NS_TEST_ASSERT_MSG_EQ (text->GetNLinks (), 4, "links");
+  NS_TEST_EXPECT_MSG_EQ (text->GetNodeName (2), "2914", "node name");
+  NS_TEST_EXPECT_MSG_EQ (text->GetLinkWeight (1), -1, "relationship");
+  NS_TEST_EXPECT_MSG_EQ (text->GetDegree (0), 2, "degree");
+
+  Ptr<TopologyCsr> cached = CreateObject<TopologyCsr> ();
+  NS_TEST_ASSERT_MSG_EQ (cached->Read (fileName, "CaidaAsRel", cacheFileName), true, "Problems reading the cache file");
+  NS_TEST_EXPECT_MSG_EQ (cached->IsFromCache (), true, "the cache is up to date");
+  NS_TEST_ASSERT_MSG_EQ (cached->GetNNodes (), text->GetNNodes (), "nodes");
+  NS_TEST_ASSERT_MSG_EQ (cached->GetNLinks (), text->GetNLinks (), "links");
+  for (uint32_t n = 0; n < text->GetNNodes (); n++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (cached->GetNodeName (n), text->GetNodeName (n), "node " << n);
+      NS_TEST_ASSERT_MSG_EQ (cached->GetDegree (n), text->GetDegree (n), "node " << n);
+      for (uint32_t j = 0; j < text->GetDegree (n); j++)
+        {
+          NS_TEST_EXPECT_MSG_EQ (cached->GetNeighbor (n, j), text->GetNeighbor (n, j), "node " << n);
+        }
+    }
+  for (uint32_t i = 0; i < text->GetNLinks (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (cached->GetLinkFrom (i), text->GetLinkFrom (i), "link " << i);
+      NS_TEST_EXPECT_MSG_EQ (cached->GetLinkTo (i), text->GetLinkTo (i), "link " << i);
+      NS_TEST_EXPECT_MSG_EQ (cached->GetLinkWeight (i), text->GetLinkWeight (i), "link " << i);
+    }
+
+  // a cache saved from another file type is not used
+  NS_TEST_ASSERT_MSG_EQ (cached->Read (fileName, "Orbis", cacheFileName), true, "Problems reading the topology file");
+  NS_TEST_EXPECT_MSG_EQ (cached->IsFromCache (), false, "the cache is stale");
+
+  NS_TEST_EXPECT_MSG_EQ (cached->Load (fileName), false, "not a binary file");
+  std::remove (fileName.c_str ());
+  std::remove (cacheFileName.c_str ());
+}
+
+/**
+ * \ingroup topology-test
+ * \ingroup tests
+ *
+ * \brief Check the nodes, links and addresses created by TopologyCsrHelper.
+ */
+class TopologyCsrHelperTest : public TestCase
+{
+public:
+  TopologyCsrHelperTest ();
+private:
+  virtual void DoRun (void);
+};
+
+TopologyCsrHelperTest::TopologyCsrHelperTest ()
+  : TestCase ("TopologyCsrHelper")
+{
+}
+
+void
+TopologyCsrHelperTest::DoRun (void)
+{
+  TopologyCsrHelper helper;
+  helper.SetFileName ("./src/topology-read/examples/Inet_small_toposample.txt");
+  helper.SetFileType ("Inet");
+  Ptr<TopologyCsr> topology = helper.Read ();
+  NS_TEST_ASSERT_MSG_NE (topology, 0, "Problems reading the topology file");
+
+  NodeContainer nodes = helper.CreateNodes (topology);
+  NS_TEST_ASSERT_MSG_EQ (nodes.GetN (), topology->GetNNodes (), "nodes");
+  InternetStackHelper stack;
+  stack.Install (nodes);
+
+  PointToPointHelper p2p;
+  NetDeviceContainer devices = helper.InstallLinks (topology, nodes, p2p);
+  NS_TEST_ASSERT_MSG_EQ (devices.GetN (), 2 * topology->GetNLinks (), "devices");
+  Ipv4InterfaceContainer interfaces = helper.AssignAddresses (topology, devices, "10.1.0.0", "255.255.0.0");
+  NS_TEST_ASSERT_MSG_EQ (interfaces.GetN (), devices.GetN (), "interfaces");
+
+  for (uint32_t i = 0; i < topology->GetNLinks (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (devices.Get (2 * i)->GetNode (), nodes.Get (topology->GetLinkFrom (i)), "link " << i);
+      NS_TEST_EXPECT_MSG_EQ (devices.Get (2 * i + 1)->GetNode (), nodes.Get (topology->GetLinkTo (i)), "link " << i);
+      NS_TEST_EXPECT_MSG_EQ (devices.Get (2 * i)->GetChannel (), devices.Get (2 * i + 1)->GetChannel (), "link " << i);
+      NS_TEST_EXPECT_MSG_EQ (interfaces.GetAddress (2 * i), Ipv4Address (0x0a010001 + 4 * i), "link " << i);
+      NS_TEST_EXPECT_MSG_EQ (interfaces.GetAddress (2 * i + 1), Ipv4Address (0x0a010002 + 4 * i), "link " << i);
+    }
+
+  Simulator::Destroy ();
+  Ipv4AddressGenerator::Reset ();
+}
+
+/**
+ * \ingroup topology-test
+ * \ingroup tests
+ *
+ * \brief TopologyCsr TestSuite
+ */
+class TopologyCsrTestSuite : public TestSuite
+{
+public:
+  TopologyCsrTestSuite ();
+};
+
+TopologyCsrTestSuite::TopologyCsrTestSuite ()
+  : TestSuite ("topology-csr", UNIT)
+{
+  AddTestCase (new TopologyCsrReadTest ("./src/topology-read/examples/Inet_toposample.txt", "Inet", 3037, 4788), TestCase::QUICK);
+  AddTestCase (new TopologyCsrReadTest ("./src/topology-read/examples/Orbis_toposample.txt", "Orbis", 1423, 2769), TestCase::QUICK);
+  AddTestCase (new TopologyCsrReadTest ("./src/topology-read/examples/RocketFuel_toposample_1239_weights.txt", "Rocketfuel", 315, 972), TestCase::QUICK);
+  AddTestCase (new TopologyCsrCacheTest (), TestCase::QUICK);
+  AddTestCase (new TopologyCsrHelperTest (), TestCase::QUICK);
+}
+
+static TopologyCsrTestSuite g_topologyCsrTestSuite; //!< Static variable for test initialization
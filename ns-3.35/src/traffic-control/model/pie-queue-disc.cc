@@ -132,6 +132,15 @@ TypeId PieQueueDisc::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&PieQueueDisc::m_useL4s),
                    MakeBooleanChecker ())
+    .AddAttribute ("UseLazyUpdate",
+                   "True to run the periodic updates of the drop probability when the "
+                   "queue disc is next used, instead of scheduling an event for each "
+                   "of them. The drop probability is the same, except that the updates "
+                   "due at the time of an enqueue or dequeue are run before it. It must "
+                   "not be changed after the queue disc is created.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&PieQueueDisc::m_useLazyUpdate),
+                   MakeBooleanChecker ())
   ;
 
   return tid;
@@ -142,7 +151,7 @@ PieQueueDisc::PieQueueDisc ()
 {
   NS_LOG_FUNCTION (this);
   m_uv = CreateObject<UniformRandomVariable> ();
-  m_rtrsEvent = Simulator::Schedule (m_sUpdate, &PieQueueDisc::CalculateP, this);
+  m_rtrsEvent = Simulator::Schedule (m_sUpdate, &PieQueueDisc::PeriodicUpdate, this);
 }
 
 PieQueueDisc::~PieQueueDisc ()
@@ -162,6 +171,7 @@ PieQueueDisc::DoDispose (void)
 Time
 PieQueueDisc::GetQueueDelay (void)
 {
+  CatchUp ();
   return m_qDelay;
 }
 
@@ -178,6 +188,8 @@ PieQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
 {
   NS_LOG_FUNCTION (this << item);
 
+  CatchUp ();
+
   QueueSize nQueued = GetCurrentSize ();
   // If L4S is enabled, then check if the packet is ECT1, and if it is then set isEct true
   bool isEct1 = false;
@@ -263,6 +275,7 @@ PieQueueDisc::InitializeParams (void)
   m_dqStart = Seconds (0);
   m_burstState = NO_BURST;
   m_qDelayOld = Seconds (0);
+  m_burstReset = 0;
   m_accuProb = 0.0;
   m_active = false;
 }
@@ -464,7 +477,58 @@ void PieQueueDisc::CalculateP ()
     }
 
   m_qDelayOld = qDelay;
-  m_rtrsEvent = Simulator::Schedule (m_tUpdate, &PieQueueDisc::CalculateP, this);
+}
+
+void
+PieQueueDisc::PeriodicUpdate (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_useLazyUpdate)
+    {
+      m_nextUpdate = Now ();
+      CatchUp ();
+      return;
+    }
+  CalculateP ();
+  m_rtrsEvent = Simulator::Schedule (m_tUpdate, &PieQueueDisc::PeriodicUpdate, this);
+}
+
+void
+PieQueueDisc::CatchUp (void)
+{
+  if (!m_useLazyUpdate || m_rtrsEvent.IsRunning ())
+    {
+      // the first update has not been run yet
+      return;
+    }
+  Time now = Now ();
+  while (m_nextUpdate <= now)
+    {
+      double dropProb = m_dropProb;
+      Time qDelay = m_qDelay;
+      Time qDelayOld = m_qDelayOld;
+      Time burstAllowance = m_burstAllowance;
+      BurstStateT burstState = m_burstState;
+      uint32_t burstReset = m_burstReset;
+      double avgDqRate = m_avgDqRate;
+      uint64_t dqCount = m_dqCount;
+
+      CalculateP ();
+      m_nextUpdate += m_tUpdate;
+
+      if (m_dropProb == dropProb && m_qDelay == qDelay && m_qDelayOld == qDelayOld
+          && m_burstAllowance == burstAllowance && m_burstState == burstState
+          && m_burstReset == burstReset && m_avgDqRate == avgDqRate && m_dqCount == dqCount)
+        {
+          // the queue does not change until now: the next updates would
+          // leave the state unchanged too
+          if (m_nextUpdate <= now)
+            {
+              m_nextUpdate += m_tUpdate * ((now - m_nextUpdate).GetTimeStep () / m_tUpdate.GetTimeStep () + 1);
+            }
+          break;
+        }
+    }
 }
 
 Ptr<QueueDiscItem>
@@ -472,6 +536,8 @@ PieQueueDisc::DoDequeue ()
 {
   NS_LOG_FUNCTION (this);
 
+  CatchUp ();
+
   if (GetInternalQueue (0)->IsEmpty ())
     {
       NS_LOG_LOGIC ("Queue empty");
@@ -132,6 +132,25 @@ private:
    */
   void CalculateP ();
 
+  /**
+   * \brief Run the periodic update of the drop probability
+   *
+   * Without lazy update, the update is rescheduled every Tupdate. With lazy
+   * update, only the first update is run from this event, and the following
+   * ones are run by CatchUp ().
+   */
+  void PeriodicUpdate (void);
+
+  /**
+   * \brief Run the periodic updates due up to now, with lazy update
+   *
+   * Called before the queue disc state read by CalculateP () changes, so
+   * that each update sees the same state as if it had run on time. If an
+   * update leaves the state unchanged, all the following ones would too,
+   * and they are skipped.
+   */
+  void CatchUp (void);
+
 
   static const uint64_t DQCOUNT_INVALID = std::numeric_limits<uint64_t>::max();  //!< Invalid dqCount value
 
@@ -152,6 +171,7 @@ private:
   Time m_activeThreshold;                       //!< Threshold for activating PIE (disabled by default)
   Time m_ceThreshold;                           //!< Threshold above which to CE mark
   bool m_useL4s;                                //!< True if L4S is used (ECT1 packets are marked at CE threshold)
+  bool m_useLazyUpdate;                         //!< True to update the drop probability when the queue disc is used, instead of periodic events
 
   // ** Variables maintained by PIE
   double m_dropProb;                            //!< Variable used in calculation of drop probability
@@ -165,6 +185,7 @@ private:
   Time m_dqStart;                               //!< Start timestamp of current measurement cycle
   uint64_t m_dqCount;                           //!< Number of bytes departed since current measurement cycle starts
   EventId m_rtrsEvent;                          //!< Event used to decide the decision of interval of drop probability calculation
+  Time m_nextUpdate;                            //!< Time of the next update of the drop probability, with lazy update
   Ptr<UniformRandomVariable> m_uv;              //!< Rng stream
   double m_accuProb;                            //!< Accumulated drop probability
   bool m_active;                                //!< Indicates whether PIE is in active state or not
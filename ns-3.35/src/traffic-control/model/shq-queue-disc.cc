@@ -87,6 +87,15 @@ TypeId ShqQueueDisc::GetTypeId (void)
                    BooleanValue (true),
                    MakeBooleanAccessor (&ShqQueueDisc::m_useEcn),
                    MakeBooleanChecker ())
+    .AddAttribute ("UseLazyUpdate",
+                   "True to run the periodic updates of the mark probability when the "
+                   "queue disc is next used, instead of scheduling an event for each "
+                   "of them. The mark probability is the same, except that the updates "
+                   "due at the time of an enqueue or dequeue are run before it. It must "
+                   "not be changed after the queue disc is created.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&ShqQueueDisc::m_useLazyUpdate),
+                   MakeBooleanChecker ())
   ;
 
   return tid;
@@ -97,7 +106,7 @@ ShqQueueDisc::ShqQueueDisc ()
 {
   NS_LOG_FUNCTION (this);
   m_uv = CreateObject<UniformRandomVariable> ();
-  m_rtrsEvent = Simulator::Schedule (m_sUpdate, &ShqQueueDisc::CalculateProb, this);
+  m_rtrsEvent = Simulator::Schedule (m_sUpdate, &ShqQueueDisc::PeriodicUpdate, this);
 }
 
 ShqQueueDisc::~ShqQueueDisc ()
@@ -125,6 +134,8 @@ ShqQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
 {
   NS_LOG_FUNCTION (this << item);
 
+  CatchUp ();
+
   QueueSize nQueued = GetCurrentSize ();
 
   if (nQueued + item > GetMaxSize ())
@@ -205,8 +216,51 @@ void ShqQueueDisc::CalculateProb ()
   // Update values
   m_markProb = p;
   m_countBytes = 0;
-  
-  m_rtrsEvent = Simulator::Schedule (m_tInterval, &ShqQueueDisc::CalculateProb, this);
+}
+
+void
+ShqQueueDisc::PeriodicUpdate (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_useLazyUpdate)
+    {
+      m_nextUpdate = Now ();
+      CatchUp ();
+      return;
+    }
+  CalculateProb ();
+  m_rtrsEvent = Simulator::Schedule (m_tInterval, &ShqQueueDisc::PeriodicUpdate, this);
+}
+
+void
+ShqQueueDisc::CatchUp (void)
+{
+  if (!m_useLazyUpdate || m_rtrsEvent.IsRunning ())
+    {
+      // the first update has not been run yet
+      return;
+    }
+  Time now = Now ();
+  while (m_nextUpdate <= now)
+    {
+      uint32_t countBytes = m_countBytes;
+      double qAvg = m_qAvg;
+      double markProb = m_markProb;
+
+      CalculateProb ();
+      m_nextUpdate += m_tInterval;
+
+      if (m_countBytes == countBytes && m_qAvg == qAvg && m_markProb == markProb)
+        {
+          // the queue does not change until now: the next updates would
+          // leave the state unchanged too
+          if (m_nextUpdate <= now)
+            {
+              m_nextUpdate += m_tInterval * ((now - m_nextUpdate).GetTimeStep () / m_tInterval.GetTimeStep () + 1);
+            }
+          break;
+        }
+    }
 }
 
 Ptr<QueueDiscItem>
@@ -214,6 +268,8 @@ ShqQueueDisc::DoDequeue ()
 {
   NS_LOG_FUNCTION (this);
 
+  CatchUp ();
+
   if (GetInternalQueue (0)->IsEmpty ())
     {
       NS_LOG_LOGIC ("Queue empty");
@@ -110,6 +110,25 @@ private:
    */
   void CalculateProb (void);
 
+  /**
+   * \brief Run the periodic update of the mark probability
+   *
+   * Without lazy update, the update is rescheduled every Tinterval. With
+   * lazy update, only the first update is run from this event, and the
+   * following ones are run by CatchUp ().
+   */
+  void PeriodicUpdate (void);
+
+  /**
+   * \brief Run the periodic updates due up to now, with lazy update
+   *
+   * Called before the queue disc state read by CalculateProb () changes,
+   * so that each update sees the same state as if it had run on time. If
+   * an update leaves the state unchanged, all the following ones would
+   * too, and they are skipped.
+   */
+  void CatchUp (void);
+
 
   // ** Variables supplied by user
   Time		m_sUpdate;		//!< Start time of the update timer
@@ -119,6 +138,7 @@ private:
   double	m_alpha;		//!< Parameter to shq controller
   DataRate	m_linkBandwidth;	//!< Link bandwidth
   bool		m_useEcn;		//!< Enable ECN Marking functionality
+  bool		m_useLazyUpdate;	//!< True to update the mark probability when the queue disc is used, instead of periodic events
 
   // ** Variables maintained by ShQ
   uint32_t	m_countBytes;		//!< Number of bytes since last prob calculation
@@ -128,6 +148,7 @@ private:
   Time		m_qDelay;		//!< Current value of queue delay
   uint32_t	m_maxBytes;		//!< Number of bytes that can be enqueued during m_tInterval
   EventId	m_rtrsEvent;		//!< Event used to decide the decision of interval of mark probability calculation
+  Time		m_nextUpdate;		//!< Time of the next update of the mark probability, with lazy update
   Ptr<UniformRandomVariable> m_uv;	//!< Rng stream
 };
 
@@ -29,6 +29,8 @@
 #include "ns3/double.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/random-variable-stream.h"
 
 using namespace ns3;
 
@@ -175,6 +177,23 @@ private:
    * \param testAttributes attributes for testing
    */
   void CheckMaxAccuProb (Ptr<PieQueueDisc> queue, Ptr<PieQueueDiscTestItem> testAttributes);
+  /**
+   * \brief Run the same random enqueues and dequeues on a queue disc with
+   * lazy update and on a queue disc without, and check that their drop
+   * probabilities stay the same
+   * \param mode the test mode
+   * \param useDqRateEstimator true to use the dequeue rate estimator
+   */
+  void RunLazyUpdateTest (QueueSizeUnit mode, bool useDqRateEstimator);
+  /**
+   * \brief Enqueue or dequeue a packet in both queue discs, compare them
+   * and schedule the next operation
+   * \param queue the queue disc without lazy update
+   * \param lazyQueue the queue disc with lazy update
+   * \param rng the random variable drawing the operations
+   * \param end the time of the last operation
+   */
+  void LazyUpdateOperate (Ptr<PieQueueDisc> queue, Ptr<PieQueueDisc> lazyQueue, Ptr<UniformRandomVariable> rng, Time end);
 };
 
 PieQueueDiscTestCase::PieQueueDiscTestCase ()
@@ -703,11 +722,80 @@ PieQueueDiscTestCase::DequeueWithDelay (Ptr<PieQueueDisc> queue, double delay, u
     }
 }
 
+void
+PieQueueDiscTestCase::LazyUpdateOperate (Ptr<PieQueueDisc> queue, Ptr<PieQueueDisc> lazyQueue, Ptr<UniformRandomVariable> rng, Time end)
+{
+  Address dest;
+  // the queue builds up during the even seconds and drains during the odd ones
+  double enqueueProb = (static_cast<int64_t> (Simulator::Now ().GetSeconds ()) % 2 == 0) ? 0.65 : 0.3;
+  if (rng->GetValue () < enqueueProb)
+    {
+      queue->Enqueue (Create<PieQueueDiscTestItem> (Create<Packet> (1000), dest, false));
+      lazyQueue->Enqueue (Create<PieQueueDiscTestItem> (Create<Packet> (1000), dest, false));
+    }
+  else
+    {
+      queue->Dequeue ();
+      lazyQueue->Dequeue ();
+    }
+  NS_TEST_ASSERT_MSG_EQ (lazyQueue->m_dropProb, queue->m_dropProb, "Different drop probability at " << Simulator::Now ().As (Time::S));
+  NS_TEST_ASSERT_MSG_EQ (lazyQueue->m_qDelayOld, queue->m_qDelayOld, "Different old queue delay at " << Simulator::Now ().As (Time::S));
+  NS_TEST_ASSERT_MSG_EQ (lazyQueue->m_burstAllowance, queue->m_burstAllowance, "Different burst allowance at " << Simulator::Now ().As (Time::S));
+  NS_TEST_ASSERT_MSG_EQ (lazyQueue->m_burstState, queue->m_burstState, "Different burst state at " << Simulator::Now ().As (Time::S));
+  NS_TEST_ASSERT_MSG_EQ (lazyQueue->m_avgDqRate, queue->m_avgDqRate, "Different dequeue rate at " << Simulator::Now ().As (Time::S));
+
+  if (Simulator::Now () < end)
+    {
+      // operations every 0.1 to 2 ms, with a few idle periods of up to 2 s,
+      // which hardly ever coincide with the periodic updates
+      Time delay = (rng->GetValue () < 0.005) ? NanoSeconds (rng->GetInteger (100000000, 2000000000))
+                                              : NanoSeconds (rng->GetInteger (100000, 2000000));
+      Simulator::Schedule (delay, &PieQueueDiscTestCase::LazyUpdateOperate, this, queue, lazyQueue, rng, end);
+    }
+}
+
+void
+PieQueueDiscTestCase::RunLazyUpdateTest (QueueSizeUnit mode, bool useDqRateEstimator)
+{
+  uint32_t qSize = (mode == QueueSizeUnit::PACKETS) ? 200 : 200 * 1000;
+  Ptr<PieQueueDisc> queue = CreateObject<PieQueueDisc> ();
+  Ptr<PieQueueDisc> lazyQueue = CreateObject<PieQueueDisc> ();
+  Ptr<PieQueueDisc> queues[2] = {queue, lazyQueue};
+  for (uint32_t i = 0; i < 2; ++i)
+    {
+      queues[i]->SetAttributeFailSafe ("MaxSize", QueueSizeValue (QueueSize (mode, qSize)));
+      queues[i]->SetAttributeFailSafe ("UseDequeueRateEstimator", BooleanValue (useDqRateEstimator));
+      queues[i]->SetAttributeFailSafe ("UseLazyUpdate", BooleanValue (i == 1));
+      queues[i]->AssignStreams (1);
+      queues[i]->Initialize ();
+    }
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  rng->SetStream (2);
+
+  Time start = Simulator::Now ();
+  Simulator::Schedule (MicroSeconds (1), &PieQueueDiscTestCase::LazyUpdateOperate, this, queue, lazyQueue, rng, start + Seconds (20));
+  Simulator::Stop (Seconds (25));
+  Simulator::Run ();
+
+  QueueDisc::Stats st = queue->GetStats ();
+  QueueDisc::Stats lazySt = lazyQueue->GetStats ();
+  NS_TEST_EXPECT_MSG_GT (st.GetNDroppedPackets (PieQueueDisc::UNFORCED_DROP), 0, "There should be some unforced drops");
+  NS_TEST_EXPECT_MSG_EQ (lazySt.GetNDroppedPackets (PieQueueDisc::UNFORCED_DROP), st.GetNDroppedPackets (PieQueueDisc::UNFORCED_DROP),
+                         "Different number of unforced drops");
+  NS_TEST_EXPECT_MSG_EQ (lazySt.GetNDroppedPackets (PieQueueDisc::FORCED_DROP), st.GetNDroppedPackets (PieQueueDisc::FORCED_DROP),
+                         "Different number of forced drops");
+  queue->Dispose ();
+  lazyQueue->Dispose ();
+}
+
 void
 PieQueueDiscTestCase::DoRun (void)
 {
   RunPieTest (QueueSizeUnit::PACKETS);
   RunPieTest (QueueSizeUnit::BYTES);
+  RunLazyUpdateTest (QueueSizeUnit::PACKETS, false);
+  RunLazyUpdateTest (QueueSizeUnit::BYTES, false);
+  RunLazyUpdateTest (QueueSizeUnit::PACKETS, true);
   Simulator::Destroy ();
 }
 
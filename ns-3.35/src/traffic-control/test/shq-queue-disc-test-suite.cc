@@ -0,0 +1,208 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/shq-queue-disc.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/data-rate.h"
+#include "ns3/random-variable-stream.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief ShQ Queue Disc Test Item
+ */
+class ShqQueueDiscTestItem : public QueueDiscItem
+{
+public:
+  /**
+   * Constructor
+   *
+   * \param p the packet
+   * \param addr the address
+   * \param ecnCapable ECN capable flag
+   */
+  ShqQueueDiscTestItem (Ptr<Packet> p, const Address & addr, bool ecnCapable);
+  virtual ~ShqQueueDiscTestItem ();
+  virtual void AddHeader (void);
+  virtual bool Mark (void);
+
+private:
+  ShqQueueDiscTestItem ();
+  /**
+   * \brief Copy constructor
+   * Disable default implementation to avoid misuse
+   */
+  ShqQueueDiscTestItem (const ShqQueueDiscTestItem &);
+  /**
+   * \brief Assignment operator
+   * \return this object
+   * Disable default implementation to avoid misuse
+   */
+  ShqQueueDiscTestItem &operator = (const ShqQueueDiscTestItem &);
+  bool m_ecnCapablePacket; //!< ECN capable packet?
+};
+
+ShqQueueDiscTestItem::ShqQueueDiscTestItem (Ptr<Packet> p, const Address & addr, bool ecnCapable)
+  : QueueDiscItem (p, addr, 0), m_ecnCapablePacket (ecnCapable)
+{
+}
+
+ShqQueueDiscTestItem::~ShqQueueDiscTestItem ()
+{
+}
+
+void
+ShqQueueDiscTestItem::AddHeader (void)
+{
+}
+
+bool
+ShqQueueDiscTestItem::Mark (void)
+{
+  return m_ecnCapablePacket;
+}
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief ShQ Queue Disc Test Case: random enqueues and dequeues, with idle
+ * periods, are run on a queue disc with lazy update and on a queue disc
+ * without, whose mark probabilities and marks must stay the same
+ */
+class ShqQueueDiscTestCase : public TestCase
+{
+public:
+  ShqQueueDiscTestCase ();
+  virtual void DoRun (void);
+private:
+  /**
+   * \brief Run the lazy update test
+   * \param useEcn true to mark packets, false to drop them
+   */
+  void RunLazyUpdateTest (bool useEcn);
+  /**
+   * \brief Enqueue or dequeue a packet in both queue discs, compare them
+   * and schedule the next operation
+   * \param queue the queue disc without lazy update
+   * \param lazyQueue the queue disc with lazy update
+   * \param rng the random variable drawing the operations
+   * \param end the time of the last operation
+   */
+  void LazyUpdateOperate (Ptr<ShqQueueDisc> queue, Ptr<ShqQueueDisc> lazyQueue, Ptr<UniformRandomVariable> rng, Time end);
+};
+
+ShqQueueDiscTestCase::ShqQueueDiscTestCase ()
+  : TestCase ("Sanity check on the lazy update of the shq queue disc")
+{
+}
+
+void
+ShqQueueDiscTestCase::LazyUpdateOperate (Ptr<ShqQueueDisc> queue, Ptr<ShqQueueDisc> lazyQueue, Ptr<UniformRandomVariable> rng, Time end)
+{
+  Address dest;
+  // the queue builds up during the even seconds and drains during the odd ones
+  double enqueueProb = (static_cast<int64_t> (Simulator::Now ().GetSeconds ()) % 2 == 0) ? 0.65 : 0.3;
+  if (rng->GetValue () < enqueueProb)
+    {
+      queue->Enqueue (Create<ShqQueueDiscTestItem> (Create<Packet> (1000), dest, true));
+      lazyQueue->Enqueue (Create<ShqQueueDiscTestItem> (Create<Packet> (1000), dest, true));
+    }
+  else
+    {
+      queue->Dequeue ();
+      lazyQueue->Dequeue ();
+    }
+  NS_TEST_ASSERT_MSG_EQ (lazyQueue->m_markProb, queue->m_markProb, "Different mark probability at " << Simulator::Now ().As (Time::S));
+  NS_TEST_ASSERT_MSG_EQ (lazyQueue->m_qAvg, queue->m_qAvg, "Different average queue length at " << Simulator::Now ().As (Time::S));
+  NS_TEST_ASSERT_MSG_EQ (lazyQueue->m_countBytes, queue->m_countBytes, "Different byte count at " << Simulator::Now ().As (Time::S));
+
+  if (Simulator::Now () < end)
+    {
+      // operations every 0.1 to 2 ms, with a few idle periods of up to 2 s,
+      // which hardly ever coincide with the periodic updates
+      Time delay = (rng->GetValue () < 0.005) ? NanoSeconds (rng->GetInteger (100000000, 2000000000))
+                                              : NanoSeconds (rng->GetInteger (100000, 2000000));
+      Simulator::Schedule (delay, &ShqQueueDiscTestCase::LazyUpdateOperate, this, queue, lazyQueue, rng, end);
+    }
+}
+
+void
+ShqQueueDiscTestCase::RunLazyUpdateTest (bool useEcn)
+{
+  Ptr<ShqQueueDisc> queue = CreateObject<ShqQueueDisc> ();
+  Ptr<ShqQueueDisc> lazyQueue = CreateObject<ShqQueueDisc> ();
+  Ptr<ShqQueueDisc> queues[2] = {queue, lazyQueue};
+  for (uint32_t i = 0; i < 2; ++i)
+    {
+      // a bandwidth low enough for the mark probability to range from 0 to 1
+      queues[i]->SetAttributeFailSafe ("LinkBandwidth", DataRateValue (DataRate ("10Mbps")));
+      queues[i]->SetAttributeFailSafe ("UseEcn", BooleanValue (useEcn));
+      queues[i]->SetAttributeFailSafe ("UseLazyUpdate", BooleanValue (i == 1));
+      queues[i]->m_uv->SetStream (1);
+      queues[i]->Initialize ();
+    }
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  rng->SetStream (2);
+
+  Time start = Simulator::Now ();
+  Simulator::Schedule (MicroSeconds (1), &ShqQueueDiscTestCase::LazyUpdateOperate, this, queue, lazyQueue, rng, start + Seconds (20));
+  Simulator::Stop (Seconds (25));
+  Simulator::Run ();
+
+  QueueDisc::Stats st = queue->GetStats ();
+  QueueDisc::Stats lazySt = lazyQueue->GetStats ();
+  const char* reason = useEcn ? ShqQueueDisc::UNFORCED_MARK : ShqQueueDisc::UNFORCED_DROP;
+  uint32_t unforced = useEcn ? st.GetNMarkedPackets (reason) : st.GetNDroppedPackets (reason);
+  uint32_t lazyUnforced = useEcn ? lazySt.GetNMarkedPackets (reason) : lazySt.GetNDroppedPackets (reason);
+  NS_TEST_EXPECT_MSG_GT (unforced, 0, "There should be some " << reason);
+  NS_TEST_EXPECT_MSG_EQ (lazyUnforced, unforced, "Different number of " << reason);
+  NS_TEST_EXPECT_MSG_EQ (lazySt.GetNDroppedPackets (ShqQueueDisc::FORCED_DROP), st.GetNDroppedPackets (ShqQueueDisc::FORCED_DROP),
+                         "Different number of forced drops");
+  queue->Dispose ();
+  lazyQueue->Dispose ();
+}
+
+void
+ShqQueueDiscTestCase::DoRun (void)
+{
+  RunLazyUpdateTest (true);
+  RunLazyUpdateTest (false);
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief ShQ Queue Disc Test Suite
+ */
+static class ShqQueueDiscTestSuite : public TestSuite
+{
+public:
+  ShqQueueDiscTestSuite ()
+    : TestSuite ("shq-queue-disc", UNIT)
+  {
+    AddTestCase (new ShqQueueDiscTestCase (), TestCase::QUICK);
+  }
+} g_shqQueueTestSuite; ///< the test suite
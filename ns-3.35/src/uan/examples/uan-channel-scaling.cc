@@ -0,0 +1,177 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/uan-helper.h"
+#include "ns3/uan-channel.h"
+#include "ns3/uan-net-device.h"
+#include "ns3/uan-prop-model-thorp.h"
+
+#include <iomanip>
+#include <iostream>
+
+using namespace ns3;
+
+/**
+ *
+ * This example measures how the UanChannel scales with the number of
+ * nodes of a static sensor field.  Every node broadcasts packets at random
+ * times, and the same scenario is simulated with the default channel, with
+ * the link cache of the channel enabled, and with both the link cache and
+ * an interaction range.  The wall clock time and the number of packets
+ * received are reported for each configuration.
+ *
+ * ./waf --run "uan-channel-scaling --nNodes=2000 --side=20000 --range=3000"
+ *
+ */
+
+NS_LOG_COMPONENT_DEFINE ("UanChannelScaling");
+
+/// Number of packets received in the current run
+static uint64_t g_rxPackets = 0;
+
+/**
+ * Count a received packet
+ * \param dev the receiving device
+ * \param pkt the packet
+ * \param mode the protocol number
+ * \param sender the address of the sender
+ * \returns true
+ */
+static bool
+RxPacket (Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t mode, const Address &sender)
+{
+  g_rxPackets++;
+  return true;
+}
+
+/**
+ * Broadcast a packet from a device
+ * \param dev the sending device
+ * \param size the packet size, in bytes
+ */
+static void
+SendPacket (Ptr<NetDevice> dev, uint32_t size)
+{
+  dev->Send (Create<Packet> (size), dev->GetBroadcast (), 0);
+}
+
+/**
+ * Simulate the sensor field with a given channel configuration
+ * \param nNodes the number of nodes
+ * \param side the side of the square field, in m
+ * \param nPackets the number of packets sent by each node
+ * \param duration the simulated time
+ * \param linkCacheSize the LinkCacheSize attribute of the channel
+ * \param range the InteractionRange attribute of the channel
+ * \return the wall clock time of the run, in ms
+ */
+static int64_t
+RunField (uint32_t nNodes, double side, uint32_t nPackets, Time duration,
+          uint32_t linkCacheSize, double range)
+{
+  // same field and traffic in every run, whatever the streams used before
+  g_rxPackets = 0;
+
+  NodeContainer nodes;
+  nodes.Create (nNodes);
+
+  Ptr<UniformRandomVariable> coordinate = CreateObject<UniformRandomVariable> ();
+  coordinate->SetStream (1);
+  Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator> ();
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      positions->Add (Vector (coordinate->GetValue (0, side),
+                              coordinate->GetValue (0, side),
+                              coordinate->GetValue (0, 100)));
+    }
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator (positions);
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+
+  Ptr<UanChannel> channel = CreateObject<UanChannel> ();
+  channel->SetPropagationModel (CreateObject<UanPropModelThorp> ());
+  channel->SetAttribute ("LinkCacheSize", UintegerValue (linkCacheSize));
+  channel->SetAttribute ("InteractionRange", DoubleValue (range));
+
+  UanHelper uan;
+  NetDeviceContainer devices = uan.Install (nodes, channel);
+  uan.AssignStreams (devices, 3);
+
+  Ptr<UniformRandomVariable> txTime = CreateObject<UniformRandomVariable> ();
+  txTime->SetStream (2);
+  for (uint32_t i = 0; i < devices.GetN (); i++)
+    {
+      devices.Get (i)->SetReceiveCallback (MakeCallback (&RxPacket));
+      for (uint32_t p = 0; p < nPackets; p++)
+        {
+          Simulator::Schedule (Seconds (txTime->GetValue (0, duration.GetSeconds ())),
+                               &SendPacket, devices.Get (i), 20);
+        }
+    }
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Stop (duration + Seconds (30));
+  Simulator::Run ();
+  int64_t elapsed = clock.End ();
+  Simulator::Destroy ();
+  return elapsed;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t nNodes = 200;
+  double side = 10000;
+  uint32_t nPackets = 2;
+  double duration = 600;
+  uint32_t linkCacheSize = 1000000;
+  double range = 3000;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("nNodes", "Number of nodes", nNodes);
+  cmd.AddValue ("side", "Side of the square field, in m", side);
+  cmd.AddValue ("nPackets", "Number of packets sent by each node", nPackets);
+  cmd.AddValue ("duration", "Interval over which the packets are sent, in s", duration);
+  cmd.AddValue ("linkCacheSize", "Number of links cached by the channel", linkCacheSize);
+  cmd.AddValue ("range", "Interaction range of the channel, in m", range);
+  cmd.Parse (argc, argv);
+
+  std::cout << "nodes: " << nNodes << ", field: " << side << " m x " << side << " m"
+            << ", packets per node: " << nPackets << std::endl;
+  std::cout << std::setw (24) << "configuration" << std::setw (12) << "time (ms)"
+            << std::setw (16) << "rx packets" << std::endl;
+
+  int64_t elapsed = RunField (nNodes, side, nPackets, Seconds (duration), 0, 0);
+  std::cout << std::setw (24) << "default" << std::setw (12) << elapsed
+            << std::setw (16) << g_rxPackets << std::endl;
+
+  elapsed = RunField (nNodes, side, nPackets, Seconds (duration), linkCacheSize, 0);
+  std::cout << std::setw (24) << "link cache" << std::setw (12) << elapsed
+            << std::setw (16) << g_rxPackets << std::endl;
+
+  elapsed = RunField (nNodes, side, nPackets, Seconds (duration), linkCacheSize, range);
+  std::cout << std::setw (24) << "link cache + range" << std::setw (12) << elapsed
+            << std::setw (16) << g_rxPackets << std::endl;
+
+  return 0;
+}
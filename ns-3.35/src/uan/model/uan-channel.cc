@@ -27,6 +27,8 @@
 #include "ns3/log.h"
 #include "ns3/pointer.h"
 #include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/double.h"
 #include "uan-channel.h"
 #include "uan-phy.h"
 #include "uan-prop-model.h"
@@ -59,6 +61,22 @@ UanChannel::GetTypeId ()
                    StringValue ("ns3::UanNoiseModelDefault"),
                    MakePointerAccessor (&UanChannel::m_noise),
                    MakePointerChecker<UanNoiseModel> ())
+    .AddAttribute ("LinkCacheSize",
+                   "Maximum number of links whose delay, path loss and PDP are "
+                   "cached while both ends stay at the same position.  The "
+                   "least recently used links are evicted first.  0 disables "
+                   "the cache, which is needed if the propagation model is "
+                   "not deterministic.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&UanChannel::m_linkCacheSize),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("InteractionRange",
+                   "Distance, in m, beyond which nodes are considered inaudible "
+                   "and are not delivered the transmitted packets.  0 delivers "
+                   "the packets to all the nodes.",
+                   DoubleValue (0),
+                   MakeDoubleAccessor (&UanChannel::m_interactionRange),
+                   MakeDoubleChecker<double> (0))
   ;
 
   return tid;
@@ -67,7 +85,9 @@ UanChannel::GetTypeId ()
 UanChannel::UanChannel ()
   : Channel (),
     m_prop (0),
-    m_cleared (false)
+    m_cleared (false),
+    m_linkCacheSize (0),
+    m_interactionRange (0)
 {
 }
 
@@ -98,6 +118,9 @@ UanChannel::Clear ()
         }
     }
   m_devList.clear ();
+  m_transducerIndex.clear ();
+  m_mobility.clear ();
+  FlushLinkCache ();
   if (m_prop)
     {
       m_prop->Clear ();
@@ -122,6 +145,14 @@ UanChannel::SetPropagationModel (Ptr<UanPropModel> prop)
 {
   NS_LOG_DEBUG ("Set Prop Model " << this);
   m_prop = prop;
+  FlushLinkCache ();
+}
+
+void
+UanChannel::FlushLinkCache (void)
+{
+  m_linkCache.clear ();
+  m_linkCacheLru.clear ();
 }
 
 std::size_t
@@ -140,44 +171,114 @@ void
 UanChannel::AddDevice (Ptr<UanNetDevice> dev, Ptr<UanTransducer> trans)
 {
   NS_LOG_DEBUG ("Adding dev/trans pair number " << m_devList.size ());
+  m_transducerIndex[trans] = m_devList.size ();
   m_devList.push_back (std::make_pair (dev, trans));
+  m_mobility.push_back (0);
 }
 
-void
-UanChannel::TxPacket (Ptr<UanTransducer> src, Ptr<Packet> packet,
-                      double txPowerDb, UanTxMode txMode)
+Ptr<MobilityModel>
+UanChannel::GetMobility (uint32_t i)
 {
-  Ptr<MobilityModel> senderMobility = 0;
-
-  NS_LOG_DEBUG ("Channel scheduling");
-  for (UanDeviceList::const_iterator i = m_devList.begin (); i
-       != m_devList.end (); i++)
+  if (!m_mobility[i])
     {
+      m_mobility[i] = m_devList[i].first->GetNode ()->GetObject<MobilityModel> ();
+    }
+  return m_mobility[i];
+}
 
-      if (src == i->second)
+const UanChannel::LinkState &
+UanChannel::GetLinkState (uint32_t src, uint32_t dst,
+                          const Vector &srcPos, const Vector &dstPos,
+                          const UanTxMode &txMode)
+{
+  uint64_t key = (static_cast<uint64_t> (src) << 32) | dst;
+  std::unordered_map<uint64_t, LinkState>::iterator it = m_linkCache.find (key);
+  if (it != m_linkCache.end ())
+    {
+      m_linkCacheLru.splice (m_linkCacheLru.begin (), m_linkCacheLru, it->second.lruIterator);
+      LinkState &link = it->second;
+      if (link.modeUid == txMode.GetUid ()
+          && link.srcPos.x == srcPos.x && link.srcPos.y == srcPos.y && link.srcPos.z == srcPos.z
+          && link.dstPos.x == dstPos.x && link.dstPos.y == dstPos.y && link.dstPos.z == dstPos.z)
         {
-          senderMobility = i->first->GetNode ()->GetObject<MobilityModel> ();
-          break;
+          return link;
         }
     }
+  else
+    {
+      if (m_linkCache.size () >= m_linkCacheSize)
+        {
+          m_linkCache.erase (m_linkCacheLru.back ());
+          m_linkCacheLru.pop_back ();
+        }
+      m_linkCacheLru.push_front (key);
+      it = m_linkCache.emplace (key, LinkState ()).first;
+      it->second.lruIterator = m_linkCacheLru.begin ();
+    }
+
+  Ptr<MobilityModel> senderMobility = GetMobility (src);
+  Ptr<MobilityModel> rcvrMobility = GetMobility (dst);
+  LinkState &link = it->second;
+  link.srcPos = srcPos;
+  link.dstPos = dstPos;
+  link.modeUid = txMode.GetUid ();
+  link.delay = m_prop->GetDelay (senderMobility, rcvrMobility, txMode);
+  link.pdp = m_prop->GetPdp (senderMobility, rcvrMobility, txMode);
+  link.pathLossDb = m_prop->GetPathLossDb (senderMobility, rcvrMobility, txMode);
+  return link;
+}
+
+void
+UanChannel::TxPacket (Ptr<UanTransducer> src, Ptr<Packet> packet,
+                      double txPowerDb, UanTxMode txMode)
+{
+  NS_LOG_DEBUG ("Channel scheduling");
+  std::map<Ptr<UanTransducer>, uint32_t>::const_iterator srcIt = m_transducerIndex.find (src);
+  NS_ASSERT (srcIt != m_transducerIndex.end ());
+  uint32_t srcIndex = srcIt->second;
+  Ptr<MobilityModel> senderMobility = GetMobility (srcIndex);
   NS_ASSERT (senderMobility != 0);
+  Vector srcPos = senderMobility->GetPosition ();
+  double interactionRangeSq = m_interactionRange * m_interactionRange;
   uint32_t j = 0;
   UanDeviceList::const_iterator i = m_devList.begin ();
   for (; i != m_devList.end (); i++)
     {
       if (src != i->second)
         {
+          Ptr<MobilityModel> rcvrMobility = GetMobility (j);
+          Vector dstPos = rcvrMobility->GetPosition ();
+          if (m_interactionRange > 0
+              && CalculateDistanceSquared (srcPos, dstPos) > interactionRangeSq)
+            {
+              NS_LOG_DEBUG ("Skipping inaudible " << i->first->GetMac ()->GetAddress ());
+              j++;
+              continue;
+            }
+
           NS_LOG_DEBUG ("Scheduling " << i->first->GetMac ()->GetAddress ());
-          Ptr<MobilityModel> rcvrMobility = i->first->GetNode ()->GetObject<MobilityModel> ();
-          Time delay = m_prop->GetDelay (senderMobility, rcvrMobility, txMode);
-          UanPdp pdp = m_prop->GetPdp (senderMobility, rcvrMobility, txMode);
-          double rxPowerDb = txPowerDb - m_prop->GetPathLossDb (senderMobility,
-                                                                rcvrMobility,
-                                                                txMode);
+          Time delay;
+          UanPdp pdp;
+          double rxPowerDb;
+          if (m_linkCacheSize > 0)
+            {
+              const LinkState &link = GetLinkState (srcIndex, j, srcPos, dstPos, txMode);
+              delay = link.delay;
+              pdp = link.pdp;
+              rxPowerDb = txPowerDb - link.pathLossDb;
+            }
+          else
+            {
+              delay = m_prop->GetDelay (senderMobility, rcvrMobility, txMode);
+              pdp = m_prop->GetPdp (senderMobility, rcvrMobility, txMode);
+              rxPowerDb = txPowerDb - m_prop->GetPathLossDb (senderMobility,
+                                                             rcvrMobility,
+                                                             txMode);
+            }
 
           NS_LOG_DEBUG ("txPowerDb=" << txPowerDb << "dB, rxPowerDb="
                                      << rxPowerDb << "dB, distance="
-                                     << senderMobility->GetDistanceFrom (rcvrMobility)
+                                     << CalculateDistance (srcPos, dstPos)
                                      << "m, delay=" << delay);
 
           uint32_t dstNodeId = i->first->GetNode ()->GetId ();
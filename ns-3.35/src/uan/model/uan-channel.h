@@ -26,8 +26,11 @@
 #include "ns3/packet.h"
 #include "ns3/uan-prop-model.h"
 #include "ns3/uan-noise-model.h"
+#include "ns3/mobility-model.h"
 
 #include <list>
+#include <map>
+#include <unordered_map>
 #include <vector>
 
 namespace ns3 {
@@ -111,12 +114,65 @@ public:
    * Clear all pointer references. */
   void Clear (void);
 
+  /**
+   * Clear the cached propagation state of all links, e.g. after a
+   * change of the propagation model parameters.
+   */
+  void FlushLinkCache (void);
+
 protected:
+  /**
+   * Propagation state of a link, valid as long as both ends
+   * stay at the same position and the same mode is used.
+   */
+  struct LinkState
+  {
+    Vector srcPos;      //!< Position of the sender.
+    Vector dstPos;      //!< Position of the receiver.
+    uint32_t modeUid;   //!< UID of the transmission mode.
+    Time delay;         //!< Propagation delay.
+    UanPdp pdp;         //!< Power delay profile.
+    double pathLossDb;  //!< Path loss, in dB.
+    std::list<uint64_t>::iterator lruIterator; //!< Position in the LRU list.
+  };
+
   UanDeviceList m_devList;     //!< The list of devices on this channel.
   Ptr<UanPropModel> m_prop;    //!< The propagation model.
   Ptr<UanNoiseModel> m_noise;  //!< The noise model.
   /** Has Clear ever been called on the channel. */
   bool m_cleared;
+  /** Index in m_devList of each transducer. */
+  std::map<Ptr<UanTransducer>, uint32_t> m_transducerIndex;
+  /** Mobility model of each device, looked up on first use. */
+  std::vector<Ptr<MobilityModel> > m_mobility;
+  /** Cached state of the links, indexed by sender and receiver. */
+  std::unordered_map<uint64_t, LinkState> m_linkCache;
+  std::list<uint64_t> m_linkCacheLru;  //!< Links, most recently used first.
+  uint32_t m_linkCacheSize;    //!< Maximum number of cached links.
+  double m_interactionRange;   //!< Distance beyond which nodes are not reached.
+
+  /**
+   * Get the mobility model of a device.
+   *
+   * \param i Device number.
+   * \return The mobility model of the node of the device.
+   */
+  Ptr<MobilityModel> GetMobility (uint32_t i);
+
+  /**
+   * Get the propagation state of a link, from the cache if the ends
+   * of the link have not moved since it was computed.
+   *
+   * \param src Device number of the sender.
+   * \param dst Device number of the receiver.
+   * \param srcPos Position of the sender.
+   * \param dstPos Position of the receiver.
+   * \param txMode Mode of the transmitted packet.
+   * \return The propagation state of the link.
+   */
+  const LinkState & GetLinkState (uint32_t src, uint32_t dst,
+                                  const Vector &srcPos, const Vector &dstPos,
+                                  const UanTxMode &txMode);
 
   /**
    * Send a packet up to the receiving UanTransducer.
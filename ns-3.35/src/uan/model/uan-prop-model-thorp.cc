@@ -29,6 +29,8 @@ NS_LOG_COMPONENT_DEFINE ("UanPropModelThorp");
 NS_OBJECT_ENSURE_REGISTERED (UanPropModelThorp);
 
 UanPropModelThorp::UanPropModelThorp ()
+  : m_lastFreqKhz (-1),
+    m_lastAttenDbKm (0)
 {
 }
 
@@ -83,6 +85,11 @@ UanPropModelThorp::GetAttenDbKyd (double freqKhz)
 double
 UanPropModelThorp::GetAttenDbKm (double freqKhz)
 {
+  // all the receivers of a packet see the same center frequency
+  if (freqKhz == m_lastFreqKhz)
+    {
+      return m_lastAttenDbKm;
+    }
 
   double fsq = freqKhz * freqKhz;
   double atten;
@@ -97,6 +104,8 @@ UanPropModelThorp::GetAttenDbKm (double freqKhz)
       atten = 0.002 + 0.11 * (freqKhz / (1 + freqKhz)) + 0.011 * freqKhz;
     }
 
+  m_lastFreqKhz = freqKhz;
+  m_lastAttenDbKm = atten;
   return atten;
 }
 
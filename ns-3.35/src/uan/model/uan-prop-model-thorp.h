@@ -66,6 +66,8 @@ private:
   double GetAttenDbKm (double freqKhz);
 
   double m_SpreadCoef;  //!< Spreading coefficient used in calculation of Thorp's approximation.
+  double m_lastFreqKhz;     //!< Center frequency of the last attenuation computed, in kHz.
+  double m_lastAttenDbKm;   //!< Last attenuation computed, in dB/km.
 
 };  // class UanPropModelThorp
 
@@ -10,6 +10,7 @@
 cpp_examples = [
     ("uan-rc-example", "True", "True"),
     ("uan-cw-example", "True", "True"),
+    ("uan-channel-scaling --nNodes=50 --nPackets=1", "True", "False"),
 ]
 
 # A list of Python examples to run in order to ensure that they remain
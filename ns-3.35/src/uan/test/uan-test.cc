@@ -31,6 +31,8 @@
 #include "ns3/object-factory.h"
 #include "ns3/pointer.h"
 #include "ns3/callback.h"
+#include "ns3/uinteger.h"
+#include "ns3/double.h"
 
 using namespace ns3;
 
@@ -68,9 +70,12 @@ private:
    * \param prop the propagation model
    * \param mode1 the send mode for device 1
    * \param mode2 the send mode for device 2
+   * \param linkCacheSize the number of links cached by the channel
+   * \param interactionRange the interaction range of the channel
    * \returns number of bytes received
    */
-  uint32_t DoOnePhyTest (Time t1, Time t2, uint32_t r1, uint32_t r2, Ptr<UanPropModel> prop, uint16_t mode1 = 0, uint16_t mode2 = 0);
+  uint32_t DoOnePhyTest (Time t1, Time t2, uint32_t r1, uint32_t r2, Ptr<UanPropModel> prop, uint16_t mode1 = 0, uint16_t mode2 = 0,
+                         uint32_t linkCacheSize = 0, double interactionRange = 0);
   /**
    * Receive packet function
    * \param dev the device
@@ -147,11 +152,15 @@ UanTest::DoOnePhyTest (Time txTime1,
                        uint32_t r2,
                        Ptr<UanPropModel> prop,
                        uint16_t mode1,
-                       uint16_t mode2)
+                       uint16_t mode2,
+                       uint32_t linkCacheSize,
+                       double interactionRange)
 {
 
   Ptr<UanChannel> channel = CreateObject<UanChannel> ();
   channel->SetAttribute ("PropagationModel", PointerValue (prop));
+  channel->SetAttribute ("LinkCacheSize", UintegerValue (linkCacheSize));
+  channel->SetAttribute ("InteractionRange", DoubleValue (interactionRange));
 
   Ptr<UanNetDevice> dev0 = CreateNode (Vector (r1,50,50), channel);
   Ptr<UanNetDevice> dev1 = CreateNode (Vector (0,50,50), channel);
@@ -195,6 +204,16 @@ UanTest::DoPhyTests ()
   NS_TEST_ASSERT_MSG_EQ_RETURNS_BOOL (DoOnePhyTest (Seconds (1.0), Seconds (2.99), 50, 50, prop),
                                       0, "Expected collision resulting in loss of both packets");
 
+  // Same results with the links cached by the channel
+  NS_TEST_ASSERT_MSG_EQ_RETURNS_BOOL (DoOnePhyTest (Seconds (1.0), Seconds (3.001), 50, 50, prop, 0, 0, 1),
+                                      34, "Should have received 34 bytes from 2 disjoint packets with link cache");
+  NS_TEST_ASSERT_MSG_EQ_RETURNS_BOOL (DoOnePhyTest (Seconds (1.0), Seconds (2.99), 50, 50, prop, 0, 0, 16),
+                                      0, "Expected collision resulting in loss of both packets with link cache");
+
+  // The interferer is out of the interaction range (No collision, get 1 packet)
+  NS_TEST_ASSERT_MSG_EQ_RETURNS_BOOL (DoOnePhyTest (Seconds (1.0), Seconds (2.9), 50, 100, prop, 0, 0, 0, 60),
+                                      17, "Expected the interferer beyond the interaction range to be inaudible");
+
 
   // Phy Gen / FH-FSK SINR check
 
@@ -0,0 +1,195 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/**
+ * This example measures how the accounting of the WAVE BSM receptions
+ * expected within each safety range scales with the number of vehicles.
+ *
+ * The vehicles move at random constant velocities in a square area, whose
+ * side grows with the square root of the number of vehicles to keep the
+ * density constant.  Every BSM interval, each vehicle counts the vehicles
+ * within each range, first by measuring the distance to every other
+ * vehicle (as done by BsmApplication without a neighbor index), and then
+ * with a BsmNeighborIndex refreshed once for the interval.  The wall clock
+ * time of both methods is reported, and the counts are checked to match.
+ *
+ * ./waf --run "wave-bsm-scaling --nNodes=5000 --density=100"
+ */
+
+#include <iostream>
+#include <iomanip>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/bsm-neighbor-index.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("WaveBsmScaling");
+
+/// Results of the benchmark
+struct BenchmarkResults
+{
+  int64_t bruteForceMs {0}; ///< wall clock time of the per-packet accounting
+  int64_t indexMs {0}; ///< wall clock time of the neighbor index
+  uint64_t expectedRx {0}; ///< total expected receptions, all ranges
+  uint64_t mismatches {0}; ///< number of counts that differ
+};
+
+/**
+ * Count the expected receptions of every node with both methods
+ * \param interfaces the nodes
+ * \param rangesSq the ranges, in m ^ 2
+ * \param index the neighbor index
+ * \param results the results to update
+ */
+static void
+CountExpectedReceptions (Ipv4InterfaceContainer *interfaces, std::vector<double> rangesSq,
+                         Ptr<BsmNeighborIndex> index, BenchmarkResults *results)
+{
+  uint32_t nNodes = interfaces->GetN ();
+  std::vector<uint32_t> counts (nNodes * rangesSq.size (), 0);
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t tx = 0; tx < nNodes; tx++)
+    {
+      Ptr<Node> txNode = interfaces->Get (tx).first->GetObject<Node> ();
+      for (uint32_t rx = 0; rx < nNodes; rx++)
+        {
+          if (rx == tx)
+            {
+              continue;
+            }
+          Ptr<Node> rxNode = interfaces->Get (rx).first->GetObject<Node> ();
+          double distSq = MobilityHelper::GetDistanceSquaredBetween (txNode, rxNode);
+          if (distSq > 0.0)
+            {
+              for (uint32_t r = 0; r < rangesSq.size (); r++)
+                {
+                  if (distSq <= rangesSq[r])
+                    {
+                      counts[tx * rangesSq.size () + r]++;
+                    }
+                }
+            }
+        }
+    }
+  results->bruteForceMs += clock.End ();
+
+  clock.Start ();
+  index->Refresh ();
+  std::vector<uint32_t> indexCounts (counts.size (), 0);
+  for (uint32_t tx = 0; tx < nNodes; tx++)
+    {
+      for (uint32_t r = 0; r < rangesSq.size (); r++)
+        {
+          indexCounts[tx * rangesSq.size () + r] = index->GetExpectedRxCount (tx, r + 1);
+        }
+    }
+  results->indexMs += clock.End ();
+
+  for (std::size_t i = 0; i < counts.size (); i++)
+    {
+      results->expectedRx += counts[i];
+      if (counts[i] != indexCounts[i])
+        {
+          results->mismatches++;
+        }
+    }
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t nNodes = 1000;
+  double density = 100; // vehicles per km ^ 2
+  uint32_t nIntervals = 10;
+  double interval = 0.1; // s
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("nNodes", "Number of vehicles", nNodes);
+  cmd.AddValue ("density", "Number of vehicles per square km", density);
+  cmd.AddValue ("nIntervals", "Number of BSM intervals", nIntervals);
+  cmd.AddValue ("interval", "BSM interval, in s", interval);
+  cmd.Parse (argc, argv);
+
+  double side = std::sqrt (nNodes / density) * 1000.0;
+  std::ostringstream coordinate;
+  coordinate << "ns3::UniformRandomVariable[Min=0.0|Max=" << side << "]";
+
+  NodeContainer nodes;
+  nodes.Create (nNodes);
+
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator ("ns3::RandomRectanglePositionAllocator",
+                                 "X", StringValue (coordinate.str ()),
+                                 "Y", StringValue (coordinate.str ()));
+  mobility.SetMobilityModel ("ns3::ConstantVelocityMobilityModel");
+  mobility.Install (nodes);
+  Ptr<UniformRandomVariable> speed = CreateObject<UniformRandomVariable> ();
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      nodes.Get (i)->GetObject<ConstantVelocityMobilityModel> ()->SetVelocity (
+        Vector (speed->GetValue (-30, 30), speed->GetValue (-30, 30), 0));
+    }
+
+  SimpleNetDeviceHelper simple;
+  NetDeviceContainer devices = simple.Install (nodes);
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.0.0.0", "255.0.0.0");
+  Ipv4InterfaceContainer interfaces = ipv4.Assign (devices);
+
+  // same ranges as WaveBsmHelper
+  std::vector<double> ranges = { 50, 100, 200, 300, 400, 500, 600, 800, 1000, 1500 };
+  std::vector<double> rangesSq;
+  for (std::size_t r = 0; r < ranges.size (); r++)
+    {
+      rangesSq.push_back (ranges[r] * ranges[r]);
+    }
+  std::vector<int> nodesMoving (nNodes, 1);
+
+  Ptr<BsmNeighborIndex> index = CreateObject<BsmNeighborIndex> ();
+  index->Setup (&interfaces, &nodesMoving, rangesSq);
+
+  BenchmarkResults results;
+  for (uint32_t i = 0; i < nIntervals; i++)
+    {
+      Simulator::Schedule (Seconds (i * interval), &CountExpectedReceptions,
+                           &interfaces, rangesSq, index, &results);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  std::cout << "vehicles: " << nNodes << ", area: " << side << " m x " << side << " m"
+            << ", intervals: " << nIntervals << std::endl;
+  std::cout << "expected receptions: " << results.expectedRx << std::endl;
+  std::cout << std::setw (16) << "per-packet (ms)" << std::setw (16) << "index (ms)"
+            << std::setw (12) << "speedup" << std::endl;
+  std::cout << std::setw (16) << results.bruteForceMs << std::setw (16) << results.indexMs
+            << std::setw (12) << std::fixed << std::setprecision (1)
+            << (results.bruteForceMs / std::max<double> (1, results.indexMs)) << std::endl;
+  if (results.mismatches > 0)
+    {
+      std::cout << "ERROR: " << results.mismatches << " counts differ" << std::endl;
+      return 1;
+    }
+  return 0;
+}
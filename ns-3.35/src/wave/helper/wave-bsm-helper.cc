@@ -44,6 +44,7 @@ WaveBsmHelper::WaveBsmHelper ()
   m_txSafetyRangesSq[9] = 1500.0 * 1500.0;
 
   m_factory.SetTypeId ("ns3::BsmApplication");
+  m_neighborIndexFactory.SetTypeId ("ns3::BsmNeighborIndex");
 }
 
 void
@@ -52,6 +53,12 @@ WaveBsmHelper::SetAttribute (std::string name, const AttributeValue &value)
   m_factory.Set (name, value);
 }
 
+void
+WaveBsmHelper::SetNeighborIndexAttribute (std::string name, const AttributeValue &value)
+{
+  m_neighborIndexFactory.Set (name, value);
+}
+
 ApplicationContainer
 WaveBsmHelper::Install (Ptr<Node> node) const
 {
@@ -108,6 +115,11 @@ WaveBsmHelper::Install (Ipv4InterfaceContainer & i,
   bsmApps.Start (Seconds (0));
   bsmApps.Stop (totalTime);
 
+  // the expected receptions of all the apps are
+  // accounted for by a single neighbor index
+  Ptr<BsmNeighborIndex> neighborIndex = m_neighborIndexFactory.Create<BsmNeighborIndex> ();
+  neighborIndex->Setup (&i, &nodesMoving, m_txSafetyRangesSq);
+
   // for each app, setup the app parameters
   ApplicationContainer::Iterator aci;
   int nodeId = 0;
@@ -125,6 +137,7 @@ WaveBsmHelper::Install (Ipv4InterfaceContainer & i,
                      &nodesMoving,
                      chAccessMode,
                      txMaxDelay);
+      bsmApp->SetNeighborIndex (neighborIndex);
       nodeId++;
     }
 }
@@ -57,6 +57,15 @@ public:
    */
   void SetAttribute (std::string name, const AttributeValue &value);
 
+  /**
+   * Helper function used to set the attributes of the BsmNeighborIndex
+   * shared by the applications installed with the same call to Install().
+   *
+   * \param name the name of the neighbor index attribute to set
+   * \param value the value of the neighbor index attribute to set
+   */
+  void SetNeighborIndexAttribute (std::string name, const AttributeValue &value);
+
   /**
    * Install an ns3::BsmApplication on each node of the input container
    * configured with all the attributes set with SetAttribute.
@@ -136,6 +145,7 @@ private:
   Ptr<Application> InstallPriv (Ptr<Node> node) const;
 
   ObjectFactory m_factory; //!< Object factory.
+  ObjectFactory m_neighborIndexFactory; //!< Neighbor index factory.
   WaveBsmStats m_waveBsmStats; ///< wave BSM stats
   /// tx safety range squared, for optimization
   std::vector <double> m_txSafetyRangesSq;
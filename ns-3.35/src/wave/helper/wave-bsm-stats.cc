@@ -65,10 +65,10 @@ WaveBsmStats::GetTxPktCount ()
 }
 
 void
-WaveBsmStats::IncExpectedRxPktCount (int index)
+WaveBsmStats::IncExpectedRxPktCount (int index, int count)
 {
-  m_wavePktExpectedReceiveCounts[index - 1]++;
-  m_waveTotalPktExpectedReceiveCounts[index - 1]++;
+  m_wavePktExpectedReceiveCounts[index - 1] += count;
+  m_waveTotalPktExpectedReceiveCounts[index - 1] += count;
 }
 
 void
@@ -105,8 +105,9 @@ public:
    * though they may not be physically received (due to collisions
    * or receiver power thresholds).
    * \param index index for statistics
+   * \param count the number of expected packets to add
    */
-  void IncExpectedRxPktCount (int index);
+  void IncExpectedRxPktCount (int index, int count = 1);
 
   /**
    * \brief Increments the count of actual packets received
@@ -49,6 +49,7 @@ BsmApplication::GetTypeId (void)
 
 BsmApplication::BsmApplication ()
   : m_waveBsmStats (0),
+    m_neighborIndex (0),
     m_txSafetyRangesSq (),
     m_TotalSimTime (Seconds (10)),
     m_wavePacketSize (200),
@@ -76,6 +77,7 @@ BsmApplication::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
 
+  m_neighborIndex = 0;
   // chain up
   Application::DoDispose ();
 }
@@ -252,36 +254,53 @@ BsmApplication::GenerateWaveTraffic (Ptr<Socket> socket, uint32_t pktSize,
               NS_LOG_UNCOND ("Sending WAVE pkt # " << wavePktsSent );
             }
 
-          // find other nodes within range that would be
-          // expected to receive this broadbast
-          int nRxNodes = m_adhocTxInterfaces->GetN ();
-          for (int i = 0; i < nRxNodes; i++)
+          if (m_neighborIndex)
             {
-              Ptr<Node> rxNode = GetNode (i);
-              int rxNodeId = rxNode->GetId ();
-
-              if (rxNodeId != txNodeId)
+              // expected receivers are counted once per
+              // refresh interval, for all the nodes
+              int rangeCount = m_neighborIndex->GetNRanges ();
+              for (int index = 1; index <= rangeCount; index++)
                 {
-                  Ptr<MobilityModel> rxPosition = rxNode->GetObject<MobilityModel> ();
-                  NS_ASSERT (rxPosition != 0);
-                  // confirm that the receiving node
-                  // has also started moving in the scenario
-                  // if it has not started moving, then
-                  // it is not a candidate to receive a packet
-                  int receiverMoving = m_nodesMoving->at (rxNodeId);
-                  if (receiverMoving == 1)
+                  uint32_t count = m_neighborIndex->GetExpectedRxCount (txNodeId, index);
+                  if (count > 0)
                     {
-                      double distSq = MobilityHelper::GetDistanceSquaredBetween (txNode, rxNode);
-                      if (distSq > 0.0)
+                      m_waveBsmStats->IncExpectedRxPktCount (index, count);
+                    }
+                }
+            }
+          else
+            {
+              // find other nodes within range that would be
+              // expected to receive this broadbast
+              int nRxNodes = m_adhocTxInterfaces->GetN ();
+              for (int i = 0; i < nRxNodes; i++)
+                {
+                  Ptr<Node> rxNode = GetNode (i);
+                  int rxNodeId = rxNode->GetId ();
+
+                  if (rxNodeId != txNodeId)
+                    {
+                      Ptr<MobilityModel> rxPosition = rxNode->GetObject<MobilityModel> ();
+                      NS_ASSERT (rxPosition != 0);
+                      // confirm that the receiving node
+                      // has also started moving in the scenario
+                      // if it has not started moving, then
+                      // it is not a candidate to receive a packet
+                      int receiverMoving = m_nodesMoving->at (rxNodeId);
+                      if (receiverMoving == 1)
                         {
-                          // dest node within range?
-                          int rangeCount = m_txSafetyRangesSq.size ();
-                          for (int index = 1; index <= rangeCount; index++)
+                          double distSq = MobilityHelper::GetDistanceSquaredBetween (txNode, rxNode);
+                          if (distSq > 0.0)
                             {
-                              if (distSq <= m_txSafetyRangesSq[index - 1])
+                              // dest node within range?
+                              int rangeCount = m_txSafetyRangesSq.size ();
+                              for (int index = 1; index <= rangeCount; index++)
                                 {
-                                  // we should expect dest node to receive broadcast pkt
-                                  m_waveBsmStats->IncExpectedRxPktCount (index);
+                                  if (distSq <= m_txSafetyRangesSq[index - 1])
+                                    {
+                                      // we should expect dest node to receive broadcast pkt
+                                      m_waveBsmStats->IncExpectedRxPktCount (index);
+                                    }
                                 }
                             }
                         }
@@ -383,6 +402,14 @@ BsmApplication::AssignStreams (int64_t streamIndex)
   return 1;
 }
 
+void
+BsmApplication::SetNeighborIndex (Ptr<BsmNeighborIndex> neighborIndex)
+{
+  NS_LOG_FUNCTION (this << neighborIndex);
+
+  m_neighborIndex = neighborIndex;
+}
+
 Ptr<Node>
 BsmApplication::GetNode (int id)
 {
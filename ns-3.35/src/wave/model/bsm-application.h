@@ -24,6 +24,7 @@
 
 #include "ns3/application.h"
 #include "ns3/wave-bsm-stats.h"
+#include "ns3/bsm-neighbor-index.h"
 #include "ns3/random-variable-stream.h"
 #include "ns3/internet-stack-helper.h"
 
@@ -93,6 +94,14 @@ public:
   */
   int64_t AssignStreams (int64_t streamIndex);
 
+  /**
+   * \brief Set the neighbor index shared by the BSM applications, used to
+   * account for the expected receptions of each BSM sent.  If not set, the
+   * distance to every other node is computed for every BSM sent.
+   * \param neighborIndex the neighbor index
+   */
+  void SetNeighborIndex (Ptr<BsmNeighborIndex> neighborIndex);
+
   /**
   * (Arbitrary) port number that is used to create a socket for transmitting WAVE BSMs.
   */
@@ -148,6 +157,7 @@ private:
   Ptr<NetDevice> GetNetDevice (int id);
 
   Ptr<WaveBsmStats> m_waveBsmStats; ///< BSM stats
+  Ptr<BsmNeighborIndex> m_neighborIndex; ///< shared neighbor index
   /// tx safety range squared, for optimization
   std::vector <double> m_txSafetyRangesSq;
   Time m_TotalSimTime; ///< total sim time
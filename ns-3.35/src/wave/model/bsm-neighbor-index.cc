@@ -0,0 +1,213 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include "ns3/bsm-neighbor-index.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/node.h"
+#include "ns3/ipv4.h"
+
+NS_LOG_COMPONENT_DEFINE ("BsmNeighborIndex");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (BsmNeighborIndex);
+
+TypeId
+BsmNeighborIndex::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::BsmNeighborIndex")
+    .SetParent<Object> ()
+    .SetGroupName ("Wave")
+    .AddConstructor<BsmNeighborIndex> ()
+    .AddAttribute ("RefreshInterval",
+                   "Maximum age of the node positions used to compute the "
+                   "expected BSM receptions. If null, the index is rebuilt "
+                   "whenever the simulation time has advanced.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&BsmNeighborIndex::m_refreshInterval),
+                   MakeTimeChecker ())
+    ;
+  return tid;
+}
+
+BsmNeighborIndex::BsmNeighborIndex ()
+  : m_interfaces (0),
+    m_nodesMoving (0),
+    m_cellSize (0),
+    m_valid (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+BsmNeighborIndex::~BsmNeighborIndex ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+BsmNeighborIndex::Setup (Ipv4InterfaceContainer * interfaces,
+                         std::vector<int> * nodesMoving,
+                         const std::vector <double> & rangesSq)
+{
+  NS_LOG_FUNCTION (this);
+
+  m_interfaces = interfaces;
+  m_nodesMoving = nodesMoving;
+  m_rangesSq = rangesSq;
+  m_cellSize = 0;
+  for (std::size_t index = 0; index < m_rangesSq.size (); index++)
+    {
+      m_cellSize = std::max (m_cellSize, std::sqrt (m_rangesSq[index]));
+    }
+  m_mobility.clear ();
+  m_valid = false;
+}
+
+int
+BsmNeighborIndex::GetNRanges (void) const
+{
+  return m_rangesSq.size ();
+}
+
+uint32_t
+BsmNeighborIndex::GetExpectedRxCount (uint32_t nodeId, int index)
+{
+  NS_LOG_FUNCTION (this << nodeId << index);
+  NS_ASSERT (index >= 1 && index <= GetNRanges ());
+
+  Time age = Simulator::Now () - m_lastRefresh;
+  if (!m_valid || age > m_refreshInterval || (m_refreshInterval.IsZero () && !age.IsZero ()))
+    {
+      Refresh ();
+    }
+  NS_ASSERT (nodeId < m_positions.size ());
+  return m_counts[nodeId * m_rangesSq.size () + index - 1];
+}
+
+uint64_t
+BsmNeighborIndex::GetCellKey (const Vector & position) const
+{
+  // cells are addressed by their (x, y) coordinates, each folded into
+  // 32 bits; the z coordinate is only used by the distance itself
+  int64_t x = static_cast<int64_t> (std::floor (position.x / m_cellSize));
+  int64_t y = static_cast<int64_t> (std::floor (position.y / m_cellSize));
+  return (static_cast<uint64_t> (static_cast<uint32_t> (x)) << 32) | static_cast<uint32_t> (y);
+}
+
+void
+BsmNeighborIndex::CountPair (uint32_t a, uint32_t b)
+{
+  double distSq = CalculateDistanceSquared (m_positions[a], m_positions[b]);
+  if (distSq <= 0.0)
+    {
+      return;
+    }
+  std::size_t rangeCount = m_rangesSq.size ();
+  for (std::size_t index = 0; index < rangeCount; index++)
+    {
+      if (distSq <= m_rangesSq[index])
+        {
+          // only moving nodes are candidates to receive a packet
+          if (m_moving[b] == 1)
+            {
+              m_counts[a * rangeCount + index]++;
+            }
+          if (m_moving[a] == 1)
+            {
+              m_counts[b * rangeCount + index]++;
+            }
+        }
+    }
+}
+
+void
+BsmNeighborIndex::Refresh (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_interfaces != 0 && m_nodesMoving != 0);
+
+  uint32_t nNodes = m_interfaces->GetN ();
+  if (m_mobility.size () != nNodes)
+    {
+      m_mobility.resize (nNodes);
+      for (uint32_t i = 0; i < nNodes; i++)
+        {
+          Ptr<Node> node = m_interfaces->Get (i).first->GetObject<Node> ();
+          m_mobility[i] = node->GetObject<MobilityModel> ();
+          NS_ASSERT (m_mobility[i] != 0);
+        }
+    }
+
+  m_positions.resize (nNodes);
+  m_moving.resize (nNodes);
+  m_counts.assign (nNodes * m_rangesSq.size (), 0);
+  m_lastRefresh = Simulator::Now ();
+  m_valid = true;
+  if (m_cellSize <= 0)
+    {
+      return;
+    }
+
+  std::unordered_map<uint64_t, std::vector<uint32_t> > cells;
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      m_positions[i] = m_mobility[i]->GetPosition ();
+      m_moving[i] = m_nodesMoving->at (m_mobility[i]->GetObject<Node> ()->GetId ());
+      cells[GetCellKey (m_positions[i])].push_back (i);
+    }
+
+  // each pair of nodes in the same or adjacent cells is visited once:
+  // within a cell, and then towards half of the eight neighbor cells
+  static const int64_t offsets[4][2] = { { 1, -1 }, { 1, 0 }, { 1, 1 }, { 0, 1 } };
+  for (auto it = cells.begin (); it != cells.end (); ++it)
+    {
+      const std::vector<uint32_t> & cell = it->second;
+      for (std::size_t i = 0; i < cell.size (); i++)
+        {
+          for (std::size_t j = i + 1; j < cell.size (); j++)
+            {
+              CountPair (cell[i], cell[j]);
+            }
+        }
+
+      uint32_t x = static_cast<uint32_t> (it->first >> 32);
+      uint32_t y = static_cast<uint32_t> (it->first);
+      for (int k = 0; k < 4; k++)
+        {
+          uint64_t key = (static_cast<uint64_t> (static_cast<uint32_t> (x + offsets[k][0])) << 32)
+            | static_cast<uint32_t> (y + offsets[k][1]);
+          auto neighbor = cells.find (key);
+          if (neighbor == cells.end ())
+            {
+              continue;
+            }
+          for (std::size_t i = 0; i < cell.size (); i++)
+            {
+              for (std::size_t j = 0; j < neighbor->second.size (); j++)
+                {
+                  CountPair (cell[i], neighbor->second[j]);
+                }
+            }
+        }
+    }
+}
+
+} // namespace ns3
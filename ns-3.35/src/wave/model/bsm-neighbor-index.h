@@ -0,0 +1,121 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef BSM_NEIGHBOR_INDEX_H
+#define BSM_NEIGHBOR_INDEX_H
+
+#include <vector>
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+#include "ns3/mobility-model.h"
+#include "ns3/ipv4-interface-container.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup wave
+ * \brief Grid-based index of the nodes transmitting WAVE BSMs, used to
+ * account for the receptions expected within each safety range.
+ *
+ * Instead of measuring the distance to every other node for every BSM
+ * sent, the positions of all the nodes are sampled once per refresh
+ * interval and bucketed into square cells as large as the widest safety
+ * range.  For each node, the number of moving nodes within each range is
+ * then computed in a single pass over the pairs of nodes lying in
+ * adjacent cells, and reused by all the BSMs sent until the next refresh.
+ *
+ * By default (null RefreshInterval), the index is rebuilt whenever the
+ * simulation time has advanced, which gives the same counts as a
+ * per-packet computation.  A positive RefreshInterval reuses positions
+ * at most that old, trading accuracy for speed.
+ */
+class BsmNeighborIndex : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  BsmNeighborIndex ();
+  virtual ~BsmNeighborIndex ();
+
+  /**
+   * \brief Setup the nodes and the ranges of the index
+   * \param interfaces IPv4 interface container; the index of a node is its
+   * position in the container
+   * \param nodesMoving whether or not node(s) are moving
+   * \param rangesSq the expected transmission ranges, in m ^ 2
+   */
+  void Setup (Ipv4InterfaceContainer * interfaces,
+              std::vector<int> * nodesMoving,
+              const std::vector <double> & rangesSq);
+
+  /**
+   * \brief Get the number of moving nodes, other than the sender, within
+   * the given range of a sender.  The index is refreshed first, if stale.
+   * \param nodeId the index of the sending node in the interface container
+   * \param index the (1-based) index of the range, as in WaveBsmStats
+   * \return the number of BSM receptions expected within range(index)
+   */
+  uint32_t GetExpectedRxCount (uint32_t nodeId, int index);
+
+  /**
+   * \return the number of ranges of the index
+   */
+  int GetNRanges (void) const;
+
+  /**
+   * \brief Sample the positions of the nodes and recompute the expected
+   * receptions of all the nodes, regardless of the refresh interval.
+   */
+  void Refresh (void);
+
+private:
+  /**
+   * \brief Compute the key of the cell containing a position
+   * \param position the position
+   * \return the key of the cell
+   */
+  uint64_t GetCellKey (const Vector & position) const;
+
+  /**
+   * \brief Count the receptions expected between two nodes
+   * \param a the index of the first node
+   * \param b the index of the second node
+   */
+  void CountPair (uint32_t a, uint32_t b);
+
+  Ipv4InterfaceContainer * m_interfaces; ///< nodes of the index
+  std::vector<int> * m_nodesMoving; ///< nodes moving
+  std::vector <double> m_rangesSq; ///< ranges squared, in m ^ 2
+  double m_cellSize; ///< side of the cells, in m
+  Time m_refreshInterval; ///< maximum age of the positions
+  Time m_lastRefresh; ///< time of the last refresh
+  bool m_valid; ///< whether the index has been built
+  std::vector<Ptr<MobilityModel> > m_mobility; ///< mobility model of each node
+  std::vector<Vector> m_positions; ///< sampled position of each node
+  std::vector<int> m_moving; ///< sampled moving indicator of each node
+  /// expected receptions, indexed by node * number of ranges + range
+  std::vector<uint32_t> m_counts;
+};
+
+} // namespace ns3
+
+#endif /* BSM_NEIGHBOR_INDEX_H */
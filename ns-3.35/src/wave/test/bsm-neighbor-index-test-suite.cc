@@ -0,0 +1,200 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <vector>
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/node-container.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4.h"
+#include "ns3/ipv4-interface-container.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/nstime.h"
+#include "ns3/bsm-neighbor-index.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup wave-test
+ * \ingroup tests
+ *
+ * \brief BsmNeighborIndex test: the expected receptions of each node
+ * are compared with a brute-force count over all the other nodes, at
+ * several times while the nodes move.
+ */
+class BsmNeighborIndexTestCase : public TestCase
+{
+public:
+  BsmNeighborIndexTestCase ();
+  virtual ~BsmNeighborIndexTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Compare an index with a brute-force count
+   * \param index the index
+   * \param lastCounts the counts of the previous check of the index
+   * \param refreshes whether the index is expected to match the current
+   * positions of the nodes
+   */
+  void Check (Ptr<BsmNeighborIndex> index, std::vector<uint32_t> * lastCounts, bool refreshes);
+
+  /**
+   * \brief Count, in O(n), the moving nodes within a range of a node
+   * \param nodeId the index of the node
+   * \param rangeSq the range, in m ^ 2
+   * \return the number of expected receptions
+   */
+  uint32_t BruteForceCount (uint32_t nodeId, double rangeSq) const;
+
+  NodeContainer m_nodes; ///< the nodes
+  Ipv4InterfaceContainer m_interfaces; ///< one interface per node
+  std::vector<int> m_nodesMoving; ///< moving indicator, by node ID
+  std::vector<double> m_rangesSq; ///< the ranges, in m ^ 2
+  std::vector<uint32_t> m_lastCounts; ///< counts of the previous check
+  std::vector<uint32_t> m_lastStaleCounts; ///< counts of the previous check, with a refresh interval
+};
+
+BsmNeighborIndexTestCase::BsmNeighborIndexTestCase ()
+  : TestCase ("BsmNeighborIndex matches a brute-force count")
+{
+}
+
+BsmNeighborIndexTestCase::~BsmNeighborIndexTestCase ()
+{
+}
+
+uint32_t
+BsmNeighborIndexTestCase::BruteForceCount (uint32_t nodeId, double rangeSq) const
+{
+  Ptr<MobilityModel> txMobility = m_nodes.Get (nodeId)->GetObject<MobilityModel> ();
+  uint32_t count = 0;
+  for (uint32_t i = 0; i < m_nodes.GetN (); i++)
+    {
+      Ptr<Node> rxNode = m_nodes.Get (i);
+      if (i == nodeId || m_nodesMoving[rxNode->GetId ()] != 1)
+        {
+          continue;
+        }
+      double distSq = CalculateDistanceSquared (txMobility->GetPosition (),
+                                                rxNode->GetObject<MobilityModel> ()->GetPosition ());
+      if (distSq > 0.0 && distSq <= rangeSq)
+        {
+          count++;
+        }
+    }
+  return count;
+}
+
+void
+BsmNeighborIndexTestCase::Check (Ptr<BsmNeighborIndex> index, std::vector<uint32_t> * lastCounts, bool refreshes)
+{
+  std::vector<uint32_t> counts;
+  bool changed = false;
+  for (uint32_t i = 0; i < m_nodes.GetN (); i++)
+    {
+      for (int range = 1; range <= index->GetNRanges (); range++)
+        {
+          uint32_t count = index->GetExpectedRxCount (i, range);
+          if (refreshes)
+            {
+              NS_TEST_EXPECT_MSG_EQ (count, BruteForceCount (i, m_rangesSq[range - 1]),
+                                     "Wrong count for node " << i << " range " << range
+                                     << " at " << Simulator::Now ().GetSeconds () << " s");
+            }
+          counts.push_back (count);
+        }
+    }
+  if (!lastCounts->empty ())
+    {
+      changed = (counts != *lastCounts);
+      NS_TEST_EXPECT_MSG_EQ (changed, refreshes, "The index was not refreshed as expected");
+    }
+  *lastCounts = counts;
+}
+
+void
+BsmNeighborIndexTestCase::DoRun (void)
+{
+  const uint32_t nNodes = 200;
+  m_nodes.Create (nNodes);
+  InternetStackHelper internet;
+  internet.Install (m_nodes);
+
+  // nodes spread over a square straddling the origin, so that cells of
+  // negative coordinates are used too, and moving in random directions
+  Ptr<UniformRandomVariable> uniform = CreateObject<UniformRandomVariable> ();
+  uniform->SetStream (1);
+  m_nodesMoving.assign (nNodes, 0);
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      Ptr<Node> node = m_nodes.Get (i);
+      Ptr<ConstantVelocityMobilityModel> mobility = CreateObject<ConstantVelocityMobilityModel> ();
+      mobility->SetPosition (Vector (uniform->GetValue (-1000, 1000), uniform->GetValue (-1000, 1000), 0));
+      mobility->SetVelocity (Vector (uniform->GetValue (-30, 30), uniform->GetValue (-30, 30), 0));
+      node->AggregateObject (mobility);
+      m_interfaces.Add (node->GetObject<Ipv4> (), 0);
+      m_nodesMoving[node->GetId ()] = (uniform->GetValue () < 0.8) ? 1 : 0;
+    }
+  // two co-located nodes, which do not count as neighbors of each other
+  m_nodes.Get (1)->GetObject<MobilityModel> ()->SetPosition (m_nodes.Get (0)->GetObject<MobilityModel> ()->GetPosition ());
+  DynamicCast<ConstantVelocityMobilityModel> (m_nodes.Get (1)->GetObject<MobilityModel> ())
+  ->SetVelocity (DynamicCast<ConstantVelocityMobilityModel> (m_nodes.Get (0)->GetObject<MobilityModel> ())->GetVelocity ());
+
+  for (double range = 50; range <= 250; range += 50)
+    {
+      m_rangesSq.push_back (range * range);
+    }
+
+  // the default RefreshInterval tracks the positions at every time step,
+  // whereas a positive one reuses the positions within the interval
+  Ptr<BsmNeighborIndex> index = CreateObject<BsmNeighborIndex> ();
+  index->Setup (&m_interfaces, &m_nodesMoving, m_rangesSq);
+  Ptr<BsmNeighborIndex> staleIndex = CreateObject<BsmNeighborIndex> ();
+  staleIndex->SetAttribute ("RefreshInterval", TimeValue (Seconds (10)));
+  staleIndex->Setup (&m_interfaces, &m_nodesMoving, m_rangesSq);
+  for (double t = 0; t <= 5; t += 1)
+    {
+      Simulator::Schedule (Seconds (t), &BsmNeighborIndexTestCase::Check, this,
+                           index, &m_lastCounts, true);
+      Simulator::Schedule (Seconds (t), &BsmNeighborIndexTestCase::Check, this,
+                           staleIndex, &m_lastStaleCounts, t == 0);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup wave-test
+ * \ingroup tests
+ *
+ * \brief BsmNeighborIndex Test Suite
+ */
+class BsmNeighborIndexTestSuite : public TestSuite
+{
+public:
+  BsmNeighborIndexTestSuite ();
+};
+
+BsmNeighborIndexTestSuite::BsmNeighborIndexTestSuite ()
+  : TestSuite ("wave-bsm-neighbor-index", UNIT)
+{
+  AddTestCase (new BsmNeighborIndexTestCase, TestCase::QUICK);
+}
+
+static BsmNeighborIndexTestSuite bsmNeighborIndexTestSuite; ///< the test suite
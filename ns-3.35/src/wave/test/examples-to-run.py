@@ -13,6 +13,7 @@ cpp_examples = [
     ("vanet-routing-compare --totaltime=2 --80211Mode=1", "True", "True"),
     ("vanet-routing-compare --totaltime=2 --80211Mode=2", "True", "True"),
     ("vanet-routing-compare --totaltime=2 --80211Mode=3", "True", "True"),
+    ("wave-bsm-scaling --nNodes=200 --nIntervals=2", "True", "True"),
 ]
 
 # A list of Python examples to run in order to ensure that they remain
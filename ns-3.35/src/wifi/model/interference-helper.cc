@@ -564,6 +564,60 @@ InterferenceHelper::CalculatePayloadSnrPer (Ptr<Event> event, uint16_t channelWi
   return PhyEntity::SnrPer (snr, per);
 }
 
+std::vector<double>
+InterferenceHelper::CalculateAbstractedPayloadPsrs (Ptr<Event> event, uint16_t channelWidth, WifiSpectrumBand band,
+                                                    uint16_t staId, const std::vector<uint32_t>& mpduSizes) const
+{
+  NS_LOG_FUNCTION (this << channelWidth << band.first << band.second << staId << mpduSizes.size ());
+  NiChangesPerBand nis;
+  CalculateNoiseInterferenceW (event, &nis, band);
+  const NiChanges& ni = nis.find (band)->second;
+
+  const WifiTxVector& txVector = event->GetTxVector ();
+  Time phyPayloadStart = event->GetStartTime () + WifiPhy::CalculatePhyPreambleAndHeaderDuration (txVector);
+  double noiseInterferenceW = m_firstPowerPerBand.find (band)->second;
+  double powerW = event->GetRxPowerW (band);
+  std::vector<std::pair<double, Time> > chunks; //SNIR and duration of each payload chunk
+  auto j = ni.begin ();
+  Time previous = j->first;
+  while (++j != ni.end ())
+    {
+      Time current = j->first;
+      if (current > phyPayloadStart)
+        {
+          double snr = CalculateSnr (powerW, noiseInterferenceW, channelWidth, txVector.GetNss (staId));
+          chunks.push_back (std::make_pair (snr, current - Max (previous, phyPayloadStart)));
+        }
+      noiseInterferenceW = j->second.GetPower () - powerW;
+      previous = current;
+    }
+
+  double psduSize = 0;
+  for (uint32_t size : mpduSizes)
+    {
+      psduSize += size;
+    }
+  std::map<uint32_t, double> psrPerSize;
+  std::vector<double> psrs;
+  psrs.reserve (mpduSizes.size ());
+  for (uint32_t size : mpduSizes)
+    {
+      auto it = psrPerSize.find (size);
+      if (it == psrPerSize.end ())
+        {
+          double psr = 1.0;
+          for (const auto & chunk : chunks)
+            {
+              psr *= CalculatePayloadChunkSuccessRate (chunk.first, chunk.second * (size / psduSize), txVector, staId);
+            }
+          NS_LOG_DEBUG ("MPDU size=" << size << ", chunks=" << chunks.size () << ", psr=" << psr);
+          it = psrPerSize.insert ({size, psr}).first;
+        }
+      psrs.push_back (it->second);
+    }
+  return psrs;
+}
+
 double
 InterferenceHelper::CalculateSnr (Ptr<Event> event, uint16_t channelWidth, uint8_t nss, WifiSpectrumBand band) const
 {
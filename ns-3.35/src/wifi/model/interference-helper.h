@@ -220,6 +220,22 @@ public:
    */
   struct PhyEntity::SnrPer CalculatePayloadSnrPer (Ptr<Event> event, uint16_t channelWidth, WifiSpectrumBand band,
                                                             uint16_t staId, std::pair<Time, Time> relativeMpduStartStop) const;
+  /**
+   * Calculate the SNIR of each chunk of the PHY payload once and derive from it
+   * the success rate of every MPDU of the PSDU, considering that each chunk is
+   * spread over the MPDUs in proportion to their size (PHY abstraction).
+   * MPDUs of the same size share the same success rate, which is computed once.
+   *
+   * \param event the event corresponding to the first time the corresponding PPDU arrives
+   * \param channelWidth the channel width used to transmit the PSDU (in MHz)
+   * \param band identify the band used by the PSDU
+   * \param staId the station ID of the PSDU (only used for MU)
+   * \param mpduSizes the size of each MPDU (A-MPDU subframe) of the PSDU
+   *
+   * \return the success rate of each MPDU
+   */
+  std::vector<double> CalculateAbstractedPayloadPsrs (Ptr<Event> event, uint16_t channelWidth, WifiSpectrumBand band,
+                                                      uint16_t staId, const std::vector<uint32_t>& mpduSizes) const;
   /**
    * Calculate the SNIR for the event (starting from now until the event end).
    *
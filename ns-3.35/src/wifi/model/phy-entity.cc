@@ -289,35 +289,68 @@ PhyEntity::EndReceiveField (WifiPpduField field, Ptr<Event> event)
     }
   else
     {
-      Ptr<const WifiPpdu> ppdu = event->GetPpdu ();
-      switch (status.actionIfFailure)
+      HandleRxFieldFailure (status, event, GetRemainingDurationAfterField (event->GetPpdu (), field));
+    }
+}
+
+void
+PhyEntity::EndReceivePhyHeader (Ptr<Event> event)
+{
+  NS_LOG_FUNCTION (this << *event);
+  NS_ASSERT (m_wifiPhy); //no sense if no owner WifiPhy instance
+  NS_ASSERT (m_wifiPhy->m_endPhyRxEvent.IsExpired ());
+  WifiPreamble preamble = event->GetTxVector ().GetPreambleType ();
+  for (WifiPpduField field = WIFI_PPDU_FIELD_PREAMBLE; field != WIFI_PPDU_FIELD_DATA;
+       field = GetNextField (field, preamble))
+    {
+      if (field != WIFI_PPDU_FIELD_PREAMBLE)
         {
-          case ABORT:
-            //Abort reception, but consider medium as busy
-            AbortCurrentReception (status.reason);
-            if (event->GetEndTime () > (Simulator::Now () + m_state->GetDelayUntilIdle ()))
-              {
-                m_wifiPhy->SwitchMaybeToCcaBusy (GetMeasurementChannelWidth (ppdu));
-              }
-            break;
-          case DROP:
-            //Notify drop, keep in CCA busy, and perform same processing as IGNORE case
-            if (status.reason == FILTERED)
-              {
-                //PHY-RXSTART is immediately followed by PHY-RXEND (Filtered)
-                m_wifiPhy->m_phyRxPayloadBeginTrace (txVector, NanoSeconds (0)); //this callback (equivalent to PHY-RXSTART primitive) is also triggered for filtered PPDUs
-              }
-            m_wifiPhy->NotifyRxDrop (GetAddressedPsduInPpdu (ppdu), status.reason);
-            m_state->SwitchMaybeToCcaBusy (GetRemainingDurationAfterField (ppdu, field)); //keep in CCA busy state till the end
-          //no break
-          case IGNORE:
-            //Keep in Rx state and reset at end
-            m_endRxPayloadEvents.push_back (Simulator::Schedule (GetRemainingDurationAfterField (ppdu, field),
-                                                                 &PhyEntity::ResetReceive, this, event));
-            break;
-          default:
-            NS_FATAL_ERROR ("Unknown action in case of failure");
+          bool supported = DoStartReceiveField (field, event);
+          NS_ABORT_MSG_IF (!supported, "Unknown field " << field << " for this PHY entity");
         }
+      PhyFieldRxStatus status = DoEndReceiveField (field, event);
+      if (!status.isSuccess)
+        {
+          //the whole PHY header has been received, only the payload remains
+          HandleRxFieldFailure (status, event, event->GetEndTime () - Simulator::Now ());
+          return;
+        }
+    }
+  StartReceivePayload (event);
+}
+
+void
+PhyEntity::HandleRxFieldFailure (PhyFieldRxStatus status, Ptr<Event> event, Time remainingDuration)
+{
+  NS_LOG_FUNCTION (this << status << *event << remainingDuration);
+  Ptr<const WifiPpdu> ppdu = event->GetPpdu ();
+  switch (status.actionIfFailure)
+    {
+      case ABORT:
+        //Abort reception, but consider medium as busy
+        AbortCurrentReception (status.reason);
+        if (event->GetEndTime () > (Simulator::Now () + m_state->GetDelayUntilIdle ()))
+          {
+            m_wifiPhy->SwitchMaybeToCcaBusy (GetMeasurementChannelWidth (ppdu));
+          }
+        break;
+      case DROP:
+        //Notify drop, keep in CCA busy, and perform same processing as IGNORE case
+        if (status.reason == FILTERED)
+          {
+            //PHY-RXSTART is immediately followed by PHY-RXEND (Filtered)
+            m_wifiPhy->m_phyRxPayloadBeginTrace (event->GetTxVector (), NanoSeconds (0)); //this callback (equivalent to PHY-RXSTART primitive) is also triggered for filtered PPDUs
+          }
+        m_wifiPhy->NotifyRxDrop (GetAddressedPsduInPpdu (ppdu), status.reason);
+        m_state->SwitchMaybeToCcaBusy (remainingDuration); //keep in CCA busy state till the end
+      //no break
+      case IGNORE:
+        //Keep in Rx state and reset at end
+        m_endRxPayloadEvents.push_back (Simulator::Schedule (remainingDuration,
+                                                             &PhyEntity::ResetReceive, this, event));
+        break;
+      default:
+        NS_FATAL_ERROR ("Unknown action in case of failure");
     }
 }
 
@@ -545,7 +578,10 @@ PhyEntity::DoStartReceivePayload (Ptr<Event> event)
   uint16_t staId = GetStaId (ppdu);
   m_signalNoiseMap.insert ({std::make_pair (ppdu->GetUid (), staId), SignalNoiseDbm ()});
   m_statusPerMpduMap.insert ({std::make_pair (ppdu->GetUid (), staId), std::vector<bool> ()});
-  ScheduleEndOfMpdus (event);
+  if (!IsAbstracted (event))
+    {
+      ScheduleEndOfMpdus (event);
+    }
   m_endRxPayloadEvents.push_back (Simulator::Schedule (ppdu->GetTxDuration () - CalculatePhyPreambleAndHeaderDuration (event->GetTxVector ()),
                                                        &PhyEntity::EndReceivePayload, this, event));
 }
@@ -627,6 +663,65 @@ PhyEntity::EndOfMpdu (Ptr<Event> event, Ptr<const WifiPsdu> psdu, size_t mpduInd
     }
 }
 
+void
+PhyEntity::EndOfAbstractedMpdus (Ptr<Event> event)
+{
+  NS_LOG_FUNCTION (this << *event);
+  Ptr<const WifiPpdu> ppdu = event->GetPpdu ();
+  Ptr<const WifiPsdu> psdu = GetAddressedPsduInPpdu (ppdu);
+  const WifiTxVector& txVector = event->GetTxVector ();
+  uint16_t staId = GetStaId (ppdu);
+  size_t nMpdus = psdu->GetNMpdus ();
+  bool isNormalMpdu = (nMpdus == 1) && !psdu->IsSingle ();
+  std::vector<uint32_t> mpduSizes;
+  mpduSizes.reserve (nMpdus);
+  for (size_t i = 0; i < nMpdus; ++i)
+    {
+      mpduSizes.push_back (isNormalMpdu ? psdu->GetSize () : psdu->GetAmpduSubframeSize (i));
+    }
+
+  //The SNIR changes over the payload are only integrated once for the whole PSDU
+  const auto & channelWidthAndBand = GetChannelWidthAndBand (txVector, staId);
+  std::vector<double> psrs = m_wifiPhy->m_interference.CalculateAbstractedPayloadPsrs (event, channelWidthAndBand.first, channelWidthAndBand.second,
+                                                                                       staId, mpduSizes);
+  double snr = m_wifiPhy->m_interference.CalculateSnr (event, channelWidthAndBand.first, txVector.GetNss (staId), channelWidthAndBand.second);
+
+  SignalNoiseDbm signalNoise;
+  signalNoise.signal = WToDbm (event->GetRxPowerW (channelWidthAndBand.second));
+  signalNoise.noise = WToDbm (event->GetRxPowerW (channelWidthAndBand.second) / snr);
+  auto signalNoiseIt = m_signalNoiseMap.find (std::make_pair (ppdu->GetUid (), staId));
+  NS_ASSERT (signalNoiseIt != m_signalNoiseMap.end ());
+  signalNoiseIt->second = signalNoise;
+
+  RxSignalInfo rxSignalInfo;
+  rxSignalInfo.snr = snr;
+  rxSignalInfo.rssi = signalNoise.signal;
+
+  auto statusPerMpduIt = m_statusPerMpduMap.find (std::make_pair (ppdu->GetUid (), staId));
+  NS_ASSERT (statusPerMpduIt != m_statusPerMpduMap.end ());
+  size_t i = 0;
+  for (auto mpdu = psdu->begin (); mpdu != psdu->end (); ++mpdu, ++i)
+    {
+      Ptr<WifiPsdu> mpduPsdu = Create<WifiPsdu> (*mpdu, false);
+      bool success = GetRandomValue () > (1 - psrs.at (i))
+                     && !(m_wifiPhy->m_postReceptionErrorModel && m_wifiPhy->m_postReceptionErrorModel->IsCorrupt (mpduPsdu->GetPacket ()->Copy ()));
+      NS_LOG_DEBUG ("MPDU #" << i << ": SNR(dB)=" << RatioToDb (snr) << ", PER=" << 1 - psrs.at (i) << ", correct reception: " << success);
+      statusPerMpduIt->second.push_back (success);
+      if (success && nMpdus > 1)
+        {
+          //only done for correct MPDU that is part of an A-MPDU
+          m_state->ContinueRxNextMpdu (mpduPsdu, rxSignalInfo, txVector);
+        }
+    }
+}
+
+bool
+PhyEntity::IsAbstracted (Ptr<const Event> event) const
+{
+  //MU PPDUs rely on the per-field events to synchronize the reception of the OFDMA payloads
+  return m_wifiPhy->m_abstraction && !event->GetTxVector ().IsMu ();
+}
+
 void
 PhyEntity::EndReceivePayload (Ptr<Event> event)
 {
@@ -635,6 +730,10 @@ PhyEntity::EndReceivePayload (Ptr<Event> event)
   Time psduDuration = ppdu->GetTxDuration () - CalculatePhyPreambleAndHeaderDuration (txVector);
   NS_LOG_FUNCTION (this << *event << psduDuration);
   NS_ASSERT (event->GetEndTime () == Simulator::Now ());
+  if (IsAbstracted (event))
+    {
+      EndOfAbstractedMpdus (event);
+    }
   uint16_t staId = GetStaId (ppdu);
   const auto & channelWidthAndBand = GetChannelWidthAndBand (event->GetTxVector (), staId);
   double snr = m_wifiPhy->m_interference.CalculateSnr (event, channelWidthAndBand.first, txVector.GetNss (staId), channelWidthAndBand.second);
@@ -873,6 +972,15 @@ PhyEntity::EndPreambleDetectionPeriod (Ptr<Event> event)
       m_wifiPhy->NotifyRxBegin (GetAddressedPsduInPpdu (m_wifiPhy->m_currentEvent->GetPpdu ()), m_wifiPhy->m_currentEvent->GetRxPowerWPerBand ());
       m_wifiPhy->m_timeLastPreambleDetected = Simulator::Now ();
 
+      if (IsAbstracted (event))
+        {
+          //Process the whole PHY header at once when the payload starts
+          Time durationTillEnd = CalculatePhyPreambleAndHeaderDuration (event->GetTxVector ()) - m_wifiPhy->GetPreambleDetectionDuration ();
+          m_state->SwitchMaybeToCcaBusy (durationTillEnd);
+          m_wifiPhy->m_endPhyRxEvent = Simulator::Schedule (durationTillEnd, &PhyEntity::EndReceivePhyHeader, this, event);
+          return;
+        }
+
       //Continue receiving preamble
       Time durationTillEnd = GetDuration (WIFI_PPDU_FIELD_PREAMBLE, event->GetTxVector ()) - m_wifiPhy->GetPreambleDetectionDuration ();
       m_state->SwitchMaybeToCcaBusy (durationTillEnd); //will be prolonged by next field
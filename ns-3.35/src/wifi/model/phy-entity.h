@@ -385,6 +385,18 @@ public:
    * \param event the event holding incoming PPDU's information
    */
   void EndReceiveField (WifiPpduField field, Ptr<Event> event);
+  /**
+   * End receiving all the fields of the PHY header at once (PHY abstraction).
+   *
+   * This method calls DoStartReceiveField and DoEndReceiveField for every
+   * field preceding the data field, in the same order as the detailed
+   * reception would do. In case of success, the reception of the payload
+   * is started. In case of failure, the indications in the returned
+   * \see PhyFieldRxStatus are performed.
+   *
+   * \param event the event holding incoming PPDU's information
+   */
+  void EndReceivePhyHeader (Ptr<Event> event);
 
   /**
    * The last symbol of the PPDU has arrived.
@@ -641,6 +653,34 @@ protected:
    */
   void ScheduleEndOfMpdus (Ptr<Event> event);
 
+  /**
+   * Compute the reception status of all the MPDUs of the PSDU under reception
+   * from a single PER evaluation over the whole payload (PHY abstraction).
+   * The success rate of each MPDU is derived from the success rate of the
+   * payload in proportion to its size. Correctly received MPDUs that are part
+   * of an A-MPDU are forwarded as if the end of each MPDU had been scheduled.
+   *
+   * \param event the event holding incoming PPDU's information
+   */
+  void EndOfAbstractedMpdus (Ptr<Event> event);
+
+  /**
+   * \param event the event holding incoming PPDU's information
+   * \return true if the PPDU is processed through the PHY abstraction,
+   *         false if it is processed field by field and MPDU by MPDU
+   */
+  bool IsAbstracted (Ptr<const Event> event) const;
+
+  /**
+   * Perform the actions indicated by the status of a PPDU field whose
+   * reception failed.
+   *
+   * \param status the status of the reception of the PPDU field
+   * \param event the event holding incoming PPDU's information
+   * \param remainingDuration the remaining duration of the PPDU
+   */
+  void HandleRxFieldFailure (PhyFieldRxStatus status, Ptr<Event> event, Time remainingDuration);
+
   /**
    * Perform amendment-specific actions at the end of the reception of
    * the payload.
@@ -471,6 +471,15 @@ WifiPhy::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&WifiPhy::m_postReceptionErrorModel),
                    MakePointerChecker<ErrorModel> ())
+    .AddAttribute ("Abstraction",
+                   "If true, enable the PHY abstraction mode: the PHY header fields "
+                   "of SU PPDUs are processed in a single event at the start of the "
+                   "payload, and the PER of the PSDU is computed once per PPDU and "
+                   "shared among its MPDUs instead of scheduling one event per MPDU. "
+                   "MU PPDUs are always processed in detail.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&WifiPhy::m_abstraction),
+                   MakeBooleanChecker ())
     .AddAttribute ("Sifs",
                    "The duration of the Short Interframe Space. "
                    "NOTE that the default value is overwritten by the value defined "
@@ -580,6 +589,7 @@ WifiPhy::WifiPhy ()
     m_txSpatialStreams (0),
     m_rxSpatialStreams (0),
     m_wifiRadioEnergyModel (0),
+    m_abstraction (false),
     m_timeLastPreambleDetected (Seconds (0))
 {
   NS_LOG_FUNCTION (this);
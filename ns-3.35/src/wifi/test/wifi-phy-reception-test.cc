@@ -47,6 +47,8 @@
 #include "ns3/wifi-psdu.h"
 #include "ns3/he-ppdu.h"
 #include "ns3/he-phy.h"
+#include "ns3/boolean.h"
+#include "ns3/string.h"
 
 using namespace ns3;
 
@@ -2550,6 +2552,152 @@ TestUnsupportedModulationReception::CheckResults (void)
   NS_TEST_EXPECT_MSG_EQ (m_dropped, 0, "Dropped some packets unexpectedly");
 }
 
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief PHY abstraction test
+ *
+ * An AP sends A-MPDUs to a STA that is located such that a fraction of the
+ * MPDUs are lost. The throughput obtained when the PHY abstraction is enabled
+ * on both devices is compared to the one obtained with the detailed PHY.
+ */
+class TestPhyAbstraction : public TestCase
+{
+public:
+  TestPhyAbstraction ();
+  virtual ~TestPhyAbstraction ();
+
+private:
+  void DoRun (void) override;
+
+  /**
+   * Run the scenario.
+   * \param abstraction whether the PHY abstraction is enabled
+   * \param distance the distance between the AP and the STA (m)
+   * \return the number of bytes received by the STA
+   */
+  uint64_t RunScenario (bool abstraction, double distance);
+  /**
+   * Callback invoked when the packet socket server receives a packet
+   * \param packet the received packet
+   * \param from the address of the sender
+   */
+  void Received (Ptr<const Packet> packet, const Address &from);
+
+  uint64_t m_rxBytes; ///< number of bytes received by the STA
+};
+
+TestPhyAbstraction::TestPhyAbstraction ()
+  : TestCase ("Check that the PHY abstraction provides the same throughput as the detailed PHY"),
+    m_rxBytes (0)
+{
+}
+
+TestPhyAbstraction::~TestPhyAbstraction ()
+{
+}
+
+void
+TestPhyAbstraction::Received (Ptr<const Packet> packet, const Address &from)
+{
+  m_rxBytes += packet->GetSize ();
+}
+
+uint64_t
+TestPhyAbstraction::RunScenario (bool abstraction, double distance)
+{
+  m_rxBytes = 0;
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+  int64_t streamNumber = 100;
+
+  NodeContainer wifiApNode;
+  wifiApNode.Create (1);
+  NodeContainer wifiStaNode;
+  wifiStaNode.Create (1);
+
+  Ptr<MultiModelSpectrumChannel> spectrumChannel = CreateObject<MultiModelSpectrumChannel> ();
+  Ptr<FriisPropagationLossModel> lossModel = CreateObject<FriisPropagationLossModel> ();
+  spectrumChannel->AddPropagationLossModel (lossModel);
+  Ptr<ConstantSpeedPropagationDelayModel> delayModel = CreateObject<ConstantSpeedPropagationDelayModel> ();
+  spectrumChannel->SetPropagationDelayModel (delayModel);
+
+  SpectrumWifiPhyHelper phy;
+  phy.SetChannel (spectrumChannel);
+  phy.Set ("Abstraction", BooleanValue (abstraction));
+
+  WifiHelper wifi;
+  wifi.SetStandard (WIFI_STANDARD_80211ax_5GHZ);
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue ("HeMcs7"),
+                                "ControlMode", StringValue ("HeMcs0"));
+
+  WifiMacHelper mac;
+  Ssid ssid = Ssid ("abstraction-ssid");
+  mac.SetType ("ns3::StaWifiMac", "Ssid", SsidValue (ssid));
+  NetDeviceContainer staDevice = wifi.Install (phy, mac, wifiStaNode);
+  mac.SetType ("ns3::ApWifiMac", "Ssid", SsidValue (ssid),
+               "EnableBeaconJitter", BooleanValue (false));
+  NetDeviceContainer apDevice = wifi.Install (phy, mac, wifiApNode);
+
+  wifi.AssignStreams (apDevice, streamNumber);
+  wifi.AssignStreams (staDevice, streamNumber + 100);
+
+  MobilityHelper mobility;
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0.0, 0.0, 0.0));
+  positionAlloc->Add (Vector (distance, 0.0, 0.0));
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (wifiApNode);
+  mobility.Install (wifiStaNode);
+
+  PacketSocketHelper packetSocket;
+  packetSocket.Install (wifiApNode);
+  packetSocket.Install (wifiStaNode);
+
+  PacketSocketAddress socket;
+  socket.SetSingleDevice (apDevice.Get (0)->GetIfIndex ());
+  socket.SetPhysicalAddress (staDevice.Get (0)->GetAddress ());
+  socket.SetProtocol (1);
+
+  Ptr<PacketSocketClient> client = CreateObject<PacketSocketClient> ();
+  client->SetAttribute ("PacketSize", UintegerValue (1000));
+  client->SetAttribute ("MaxPackets", UintegerValue (0));
+  client->SetAttribute ("Interval", TimeValue (MicroSeconds (10)));
+  client->SetRemote (socket);
+  wifiApNode.Get (0)->AddApplication (client);
+  client->SetStartTime (Seconds (0.5));
+  client->SetStopTime (Seconds (0.7));
+
+  Ptr<PacketSocketServer> server = CreateObject<PacketSocketServer> ();
+  server->SetLocal (socket);
+  server->TraceConnectWithoutContext ("Rx", MakeCallback (&TestPhyAbstraction::Received, this));
+  wifiStaNode.Get (0)->AddApplication (server);
+  server->SetStartTime (Seconds (0.0));
+  server->SetStopTime (Seconds (0.7));
+
+  Simulator::Stop (Seconds (0.7));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  return m_rxBytes;
+}
+
+void
+TestPhyAbstraction::DoRun (void)
+{
+  for (double distance : {5.0, 85.0})
+    {
+      uint64_t detailed = RunScenario (false, distance);
+      uint64_t abstracted = RunScenario (true, distance);
+      NS_TEST_ASSERT_MSG_GT (detailed, 0, "No traffic received with the detailed PHY");
+      NS_TEST_EXPECT_MSG_EQ_TOL (static_cast<double> (abstracted), static_cast<double> (detailed), 0.05 * detailed,
+                                 "Throughput with PHY abstraction differs from the detailed PHY at " << distance << "m");
+    }
+}
+
 /**
  * \ingroup wifi-test
  * \ingroup tests
@@ -2571,6 +2719,7 @@ WifiPhyReceptionTestSuite::WifiPhyReceptionTestSuite ()
   AddTestCase (new TestPhyHeadersReception, TestCase::QUICK);
   AddTestCase (new TestAmpduReception, TestCase::QUICK);
   AddTestCase (new TestUnsupportedModulationReception (), TestCase::QUICK);
+  AddTestCase (new TestPhyAbstraction (), TestCase::QUICK);
 }
 
 static WifiPhyReceptionTestSuite wifiPhyReceptionTestSuite; ///< the test suite
@@ -0,0 +1,108 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Measure the startup time of an ns-3 process linked with all the enabled
+ * modules.  The program runs itself repeatedly, in child mode, and reports
+ * the mean wall clock time of a child process:
+ *
+ * - "exit": the child returns from main () immediately, so the time is
+ *   the time needed to load the libraries and to run their static
+ *   constructors;
+ * - "lookup": the child looks up a few TypeIds by name, as a typical
+ *   simulation script does through the helpers;
+ * - "all": the child registers every TypeId, as the attribute system does
+ *   when iterating over all the registered types.
+ *
+ * ./waf --run "bench-startup --runs=20"
+ */
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include "ns3/core-module.h"
+
+using namespace ns3;
+
+/**
+ * Run the child process work
+ * \param mode the child mode
+ */
+static void
+RunChild (std::string mode)
+{
+  if (mode == "lookup")
+    {
+      TypeId::LookupByName ("ns3::Node");
+      TypeId::LookupByName ("ns3::UdpSocketFactory");
+      TypeId::LookupByName ("ns3::ConstantPositionMobilityModel");
+    }
+  else if (mode == "all")
+    {
+      TypeId::GetRegisteredN ();
+    }
+}
+
+/**
+ * Run the child processes
+ * \param me the path of this program
+ * \param mode the child mode
+ * \param runs the number of child processes
+ * \return the mean wall clock time of a child process, in ms
+ */
+static double
+RunChildren (std::string me, std::string mode, uint32_t runs)
+{
+  std::ostringstream cmd;
+  cmd << me << " --child=" << mode;
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t i = 0; i < runs; i++)
+    {
+      int status = std::system (cmd.str ().c_str ());
+      NS_ABORT_MSG_IF (status != 0, "Child process failed: " << cmd.str ());
+    }
+  return clock.End () / static_cast<double> (runs);
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t runs = 10;
+  std::string child = "";
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("runs", "Number of child processes per mode", runs);
+  cmd.AddValue ("child", "Run as a child process, in the given mode [exit|lookup|all]", child);
+  cmd.Parse (argc, argv);
+
+  if (child != "")
+    {
+      RunChild (child);
+      return 0;
+    }
+
+  std::cout << "runs: " << runs << std::endl;
+  std::cout << std::setw (10) << "mode" << std::setw (16) << "startup (ms)" << std::endl;
+  const char *modes[] = { "exit", "lookup", "all" };
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      std::cout << std::setw (10) << modes[i] << std::setw (16) << std::fixed << std::setprecision (1)
+                << RunChildren (argv[0], modes[i], runs) << std::endl;
+    }
+  return 0;
+}
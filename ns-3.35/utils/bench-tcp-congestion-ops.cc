@@ -0,0 +1,474 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program measures the cost per ACK of a TcpCongestionOps, by
+// replaying an ACK trace through one congestion control instance (and
+// one TcpSocketState) per flow, without any socket, packet or node.
+//
+// The trace is either read from a file, with one ACK per line:
+//
+//   <time (s)> <flow> <segments acked> <RTT (s)> <loss (0/1)> <CE (0/1)>
+//
+// or generated: all the flows receive an ACK every ackInterval, like the
+// flows of an incast, with a random RTT, and random losses and CE marks.
+// The ACKs received at the same time are processed by a single simulator
+// event (--batch=1, the default) or by one event each (--batch=0).
+//
+// The trace is replayed twice: once with the calls to the congestion
+// control, and once without them, to subtract the cost of the replay.
+//
+// Sample usage:
+//
+//   ./waf --run "bench-tcp-congestion-ops --type=ns3::TcpCubic --flows=10000"
+//   ./waf --run "bench-tcp-congestion-ops --type=ns3::TcpDctcp --ceProbability=0.05"
+//   ./waf --run "bench-tcp-congestion-ops --type=ns3::TcpBbr --trace=acks.txt"
+
+#include "ns3/core-module.h"
+#include "ns3/tcp-congestion-ops.h"
+#include "ns3/tcp-socket-state.h"
+#include "ns3/tcp-rate-ops.h"
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+/**
+ * An ACK of the trace
+ */
+struct AckRecord
+{
+  int64_t m_time;       //!< Reception time (in time steps)
+  uint32_t m_flow;      //!< Index of the flow
+  uint32_t m_segments;  //!< Number of segments acknowledged
+  int64_t m_rtt;        //!< RTT sample (in time steps)
+  bool m_loss;          //!< True if the ACK signals a loss
+  bool m_ce;            //!< True if the ACK echoes a CE mark
+};
+
+/**
+ * Order the ACKs by time, then by flow
+ * \param a first ACK
+ * \param b second ACK
+ * \return true if a comes before b
+ */
+static bool
+AckRecordLess (const AckRecord &a, const AckRecord &b)
+{
+  return a.m_time < b.m_time || (a.m_time == b.m_time && a.m_flow < b.m_flow);
+}
+
+/**
+ * The state of a replayed flow, as a TcpSocketBase would keep it for
+ * its congestion control
+ */
+struct ReplayFlow
+{
+  Ptr<TcpSocketState> m_tcb;              //!< Congestion state
+  Ptr<TcpCongestionOps> m_cong;           //!< Congestion control
+  TcpRateOps::TcpRateConnection m_rate;   //!< Rate information
+  TcpRateOps::TcpRateSample m_rateSample; //!< Last rate sample
+  SequenceNumber32 m_recover;             //!< End of the current recovery
+};
+
+/**
+ * Replays an ACK trace through the congestion control of each flow
+ */
+class CongestionOpsReplay
+{
+public:
+  /**
+   * \param trace the ACKs, ordered by time
+   * \param nFlows number of flows
+   * \param factory the factory of the congestion control
+   * \param segmentSize the segment size
+   */
+  CongestionOpsReplay (const std::vector<AckRecord> &trace, uint32_t nFlows,
+                       const ObjectFactory &factory, uint32_t segmentSize);
+
+  /**
+   * Replay the trace
+   * \param batch true to process the ACKs of the same time in a single event
+   * \param callCong false to skip the calls to the congestion control
+   * \return the run time (in ms)
+   */
+  int64_t Run (bool batch, bool callCong);
+
+  /**
+   * \return the mean congestion window at the end of the replay (in segments)
+   */
+  double GetMeanCwnd (void) const;
+
+private:
+  /**
+   * Process the ACKs [begin, end) of the trace
+   * \param begin the first ACK
+   * \param end the ACK after the last one
+   */
+  void ProcessAcks (uint32_t begin, uint32_t end);
+
+  /**
+   * Process an ACK, like TcpSocketBase::ReceivedAck does
+   * \param ack the ACK
+   */
+  void ProcessAck (const AckRecord &ack);
+
+  const std::vector<AckRecord> &m_trace;  //!< The ACK trace
+  uint32_t m_nFlows;                      //!< Number of flows
+  ObjectFactory m_factory;                //!< Factory of the congestion control
+  uint32_t m_segmentSize;                 //!< Segment size
+  bool m_callCong;                        //!< True to call the congestion control
+  std::vector<ReplayFlow> m_flows;        //!< The flows
+};
+
+CongestionOpsReplay::CongestionOpsReplay (const std::vector<AckRecord> &trace, uint32_t nFlows,
+                                          const ObjectFactory &factory, uint32_t segmentSize)
+  : m_trace (trace),
+    m_nFlows (nFlows),
+    m_factory (factory),
+    m_segmentSize (segmentSize),
+    m_callCong (true)
+{
+}
+
+int64_t
+CongestionOpsReplay::Run (bool batch, bool callCong)
+{
+  m_callCong = callCong;
+  m_flows.clear ();
+  m_flows.resize (m_nFlows);
+  for (uint32_t i = 0; i < m_nFlows; ++i)
+    {
+      m_flows[i].m_tcb = CreateObject<TcpSocketState> ();
+    }
+  // the RTT measured by the handshake is the one of the first ACK
+  for (uint32_t i = m_trace.size (); i-- > 0; )
+    {
+      m_flows[m_trace[i].m_flow].m_tcb->m_lastRtt = TimeStep (m_trace[i].m_rtt);
+    }
+  for (uint32_t i = 0; i < m_nFlows; ++i)
+    {
+      ReplayFlow &flow = m_flows[i];
+      flow.m_tcb->m_minRtt = flow.m_tcb->m_lastRtt;
+      flow.m_tcb->m_segmentSize = m_segmentSize;
+      flow.m_tcb->m_initialCWnd = 10;
+      flow.m_tcb->m_initialSsThresh = std::numeric_limits<uint32_t>::max ();
+      flow.m_tcb->m_cWnd = 10 * m_segmentSize;
+      flow.m_tcb->m_ssThresh = flow.m_tcb->m_initialSsThresh;
+      flow.m_tcb->m_bytesInFlight = flow.m_tcb->m_cWnd;
+      flow.m_tcb->m_highTxMark = SequenceNumber32 (flow.m_tcb->m_cWnd);
+      flow.m_cong = m_factory.Create<TcpCongestionOps> ();
+      flow.m_cong->Init (flow.m_tcb);
+      flow.m_cong->CongestionStateSet (flow.m_tcb, TcpSocketState::CA_OPEN);
+      if (flow.m_tcb->m_useEcn == TcpSocketState::On)
+        {
+          flow.m_tcb->m_ecnState = TcpSocketState::ECN_IDLE;
+        }
+    }
+
+  uint32_t begin = 0;
+  while (begin < m_trace.size ())
+    {
+      uint32_t end = begin + 1;
+      if (batch)
+        {
+          while (end < m_trace.size () && m_trace[end].m_time == m_trace[begin].m_time)
+            {
+              end++;
+            }
+        }
+      Simulator::Schedule (TimeStep (m_trace[begin].m_time), &CongestionOpsReplay::ProcessAcks,
+                           this, begin, end);
+      begin = end;
+    }
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Run ();
+  int64_t elapsed = clock.End ();
+  Simulator::Destroy ();
+  return elapsed;
+}
+
+double
+CongestionOpsReplay::GetMeanCwnd (void) const
+{
+  double sum = 0;
+  for (uint32_t i = 0; i < m_flows.size (); ++i)
+    {
+      sum += m_flows[i].m_tcb->GetCwndInSegments ();
+    }
+  return m_flows.empty () ? 0 : sum / m_flows.size ();
+}
+
+void
+CongestionOpsReplay::ProcessAcks (uint32_t begin, uint32_t end)
+{
+  for (uint32_t i = begin; i < end; ++i)
+    {
+      ProcessAck (m_trace[i]);
+    }
+}
+
+void
+CongestionOpsReplay::ProcessAck (const AckRecord &ack)
+{
+  ReplayFlow &flow = m_flows[ack.m_flow];
+  Ptr<TcpSocketState> tcb = flow.m_tcb;
+  Ptr<TcpCongestionOps> cong = flow.m_cong;
+  uint32_t bytesAcked = ack.m_segments * m_segmentSize;
+  uint32_t priorInFlight = tcb->m_bytesInFlight;
+  Time rtt = TimeStep (ack.m_rtt);
+
+  tcb->m_lastRtt = rtt;
+  tcb->m_minRtt = std::min (rtt, tcb->m_minRtt);
+  tcb->m_lastAckedSeq += bytesAcked;
+  tcb->m_lastAckedSackedBytes = bytesAcked;
+  flow.m_rate.m_delivered += bytesAcked;
+  flow.m_rate.m_deliveredTime = Simulator::Now ();
+
+  // ECN echo, handled before the ACK itself like in TcpSocketBase
+  if (tcb->m_congState == TcpSocketState::CA_CWR && tcb->m_lastAckedSeq > flow.m_recover)
+    {
+      tcb->m_congState = TcpSocketState::CA_OPEN;
+      if (m_callCong && !cong->HasCongControl ())
+        {
+          tcb->m_cWnd = tcb->m_ssThresh.Get ();
+          cong->CwndEvent (tcb, TcpSocketState::CA_EVENT_COMPLETE_CWR);
+        }
+    }
+  if (ack.m_ce && tcb->m_ecnState != TcpSocketState::ECN_DISABLED)
+    {
+      tcb->m_ecnState = TcpSocketState::ECN_ECE_RCVD;
+      if (tcb->m_congState != TcpSocketState::CA_CWR)
+        {
+          tcb->m_congState = TcpSocketState::CA_CWR;
+          flow.m_recover = tcb->m_highTxMark;
+          if (m_callCong)
+            {
+              tcb->m_ssThresh = cong->GetSsThresh (tcb, priorInFlight);
+              if (!cong->HasCongControl ())
+                {
+                  tcb->m_cWnd = tcb->m_ssThresh.Get ();
+                }
+            }
+        }
+    }
+  else if (tcb->m_ecnState == TcpSocketState::ECN_ECE_RCVD)
+    {
+      tcb->m_ecnState = TcpSocketState::ECN_IDLE;
+    }
+
+  if (ack.m_loss && tcb->m_congState == TcpSocketState::CA_OPEN)
+    {
+      // fast retransmit: the recovery ends when the current window is ACKed
+      tcb->m_congState = TcpSocketState::CA_RECOVERY;
+      flow.m_recover = tcb->m_highTxMark;
+      if (m_callCong)
+        {
+          cong->CongestionStateSet (tcb, TcpSocketState::CA_RECOVERY);
+          tcb->m_ssThresh = cong->GetSsThresh (tcb, priorInFlight);
+          if (!cong->HasCongControl ())
+            {
+              tcb->m_cWnd = tcb->m_ssThresh.Get ();
+            }
+        }
+    }
+  else if (tcb->m_congState == TcpSocketState::CA_RECOVERY)
+    {
+      if (tcb->m_lastAckedSeq >= flow.m_recover)
+        {
+          tcb->m_congState = TcpSocketState::CA_OPEN;
+          if (m_callCong)
+            {
+              cong->PktsAcked (tcb, ack.m_segments, rtt);
+              cong->CwndEvent (tcb, TcpSocketState::CA_EVENT_COMPLETE_CWR);
+              cong->CongestionStateSet (tcb, TcpSocketState::CA_OPEN);
+              if (!cong->HasCongControl ())
+                {
+                  tcb->m_cWnd = tcb->m_ssThresh.Get ();
+                }
+            }
+        }
+    }
+  else if (m_callCong)
+    {
+      cong->PktsAcked (tcb, ack.m_segments, rtt);
+      if (tcb->m_congState == TcpSocketState::CA_OPEN && !cong->HasCongControl ())
+        {
+          cong->IncreaseWindow (tcb, ack.m_segments);
+        }
+    }
+
+  if (cong->HasCongControl ())
+    {
+      // a rate sample covering the last window, delivered in one RTT
+      TcpRateOps::TcpRateSample &rs = flow.m_rateSample;
+      rs.m_delivered = priorInFlight;
+      rs.m_interval = rtt;
+      rs.m_deliveryRate = DataRate (priorInFlight * 8.0 / rtt.GetSeconds ());
+      rs.m_priorDelivered = static_cast<uint32_t> (flow.m_rate.m_delivered - priorInFlight);
+      rs.m_ackedSacked = bytesAcked;
+      rs.m_priorInFlight = priorInFlight;
+      rs.m_bytesLoss = ack.m_loss ? m_segmentSize : 0;
+      flow.m_rate.m_txItemDelivered = rs.m_priorDelivered;
+      if (m_callCong)
+        {
+          cong->CongControl (tcb, flow.m_rate, rs);
+        }
+    }
+
+  // the sender always fills the congestion window
+  tcb->m_bytesInFlight = tcb->m_cWnd.Get ();
+  tcb->m_highTxMark = tcb->m_lastAckedSeq + tcb->m_cWnd.Get ();
+}
+
+/**
+ * Read an ACK trace
+ * \param fileName the name of the trace file
+ * \param trace the ACKs
+ * \return the number of flows
+ */
+static uint32_t
+ReadTrace (const std::string &fileName, std::vector<AckRecord> &trace)
+{
+  std::ifstream is (fileName.c_str ());
+  if (!is.is_open ())
+    {
+      std::cerr << "Cannot open " << fileName << std::endl;
+      exit (1);
+    }
+  uint32_t nFlows = 0;
+  double time, rtt;
+  AckRecord ack;
+  while (is >> time >> ack.m_flow >> ack.m_segments >> rtt >> ack.m_loss >> ack.m_ce)
+    {
+      ack.m_time = Seconds (time).GetTimeStep ();
+      ack.m_rtt = Seconds (rtt).GetTimeStep ();
+      nFlows = std::max (nFlows, ack.m_flow + 1);
+      trace.push_back (ack);
+    }
+  std::stable_sort (trace.begin (), trace.end (), &AckRecordLess);
+  return nFlows;
+}
+
+/**
+ * Write an ACK trace, in the format read by ReadTrace ()
+ * \param fileName the name of the trace file
+ * \param trace the ACKs
+ */
+static void
+WriteTrace (const std::string &fileName, const std::vector<AckRecord> &trace)
+{
+  std::ofstream os (fileName.c_str ());
+  os.precision (9);
+  for (uint32_t i = 0; i < trace.size (); ++i)
+    {
+      const AckRecord &ack = trace[i];
+      os << TimeStep (ack.m_time).GetSeconds () << " " << ack.m_flow << " "
+         << ack.m_segments << " " << TimeStep (ack.m_rtt).GetSeconds () << " "
+         << ack.m_loss << " " << ack.m_ce << std::endl;
+    }
+}
+
+int
+main (int argc, char *argv[])
+{
+  std::string type = "ns3::TcpCubic";
+  std::string traceFile = "";
+  std::string writeTrace = "";
+  uint32_t nFlows = 1000;
+  uint32_t nAcks = 1000;
+  Time ackInterval = MicroSeconds (12);
+  Time baseRtt = MicroSeconds (100);
+  Time rttJitter = MicroSeconds (20);
+  double lossProbability = 0.001;
+  double ceProbability = 0;
+  double delAckProbability = 0.5;
+  uint32_t segmentSize = 1448;
+  bool batch = true;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("type", "TypeId of the congestion control", type);
+  cmd.AddValue ("trace", "ACK trace to replay, instead of a generated one", traceFile);
+  cmd.AddValue ("writeTrace", "File to write the generated ACK trace to", writeTrace);
+  cmd.AddValue ("flows", "Number of flows of the generated trace", nFlows);
+  cmd.AddValue ("acks", "Number of ACKs per flow of the generated trace", nAcks);
+  cmd.AddValue ("ackInterval", "Time between the ACKs of a flow in the generated trace", ackInterval);
+  cmd.AddValue ("baseRtt", "Minimum RTT of the generated trace", baseRtt);
+  cmd.AddValue ("rttJitter", "Maximum RTT increase of the generated trace", rttJitter);
+  cmd.AddValue ("lossProbability", "Probability that an ACK of the generated trace signals a loss", lossProbability);
+  cmd.AddValue ("ceProbability", "Probability that an ACK of the generated trace echoes a CE mark", ceProbability);
+  cmd.AddValue ("delAckProbability", "Probability that an ACK of the generated trace acknowledges two segments", delAckProbability);
+  cmd.AddValue ("segmentSize", "Segment size", segmentSize);
+  cmd.AddValue ("batch", "Process the ACKs of the same time in a single event", batch);
+  cmd.Parse (argc, argv);
+
+  ObjectFactory factory;
+  factory.SetTypeId (type);
+
+  std::vector<AckRecord> trace;
+  if (traceFile != "")
+    {
+      nFlows = ReadTrace (traceFile, trace);
+    }
+  else
+    {
+      Ptr<UniformRandomVariable> uv = CreateObject<UniformRandomVariable> ();
+      trace.reserve (static_cast<size_t> (nFlows) * nAcks);
+      for (uint32_t k = 1; k <= nAcks; ++k)
+        {
+          for (uint32_t i = 0; i < nFlows; ++i)
+            {
+              AckRecord ack;
+              ack.m_time = (ackInterval * k).GetTimeStep ();
+              ack.m_flow = i;
+              ack.m_segments = uv->GetValue () < delAckProbability ? 2 : 1;
+              ack.m_rtt = (baseRtt + rttJitter * uv->GetValue ()).GetTimeStep ();
+              ack.m_loss = uv->GetValue () < lossProbability;
+              ack.m_ce = uv->GetValue () < ceProbability;
+              trace.push_back (ack);
+            }
+        }
+      Simulator::Destroy ();
+      if (writeTrace != "")
+        {
+          WriteTrace (writeTrace, trace);
+        }
+    }
+  if (trace.empty ())
+    {
+      std::cerr << "Empty ACK trace" << std::endl;
+      return 1;
+    }
+
+  CongestionOpsReplay replay (trace, nFlows, factory, segmentSize);
+  int64_t replayMs = replay.Run (batch, false);
+  int64_t totalMs = replay.Run (batch, true);
+
+  double nsPerAck = 1e6 / trace.size ();
+  std::cout << type << ": " << nFlows << " flows, " << trace.size () << " ACKs, "
+            << (batch ? "batched" : "one event per ACK") << std::endl;
+  std::cout << "mean final cwnd (segments): " << replay.GetMeanCwnd () << std::endl;
+  std::cout << "replay only (ns/ACK): " << replayMs * nsPerAck << std::endl;
+  std::cout << "with congestion control (ns/ACK): " << totalMs * nsPerAck << std::endl;
+  std::cout << "congestion control (ns/ACK): " << (totalMs - replayMs) * nsPerAck << std::endl;
+  return 0;
+}